@@ -80,16 +80,61 @@ typedef struct {
 
 } sx126x_spi_trx_t;
 
+/** -------------------------------------------------------------------------- *
+ * The spi transactions of one radio operation (e.g. the setup of a tx) are
+ * issued as a batch, the port may keep the spi bus for the whole batch
+ * instead of acquiring it for every transaction.
+ * --------------------------------------------------------------------------- *
+ */
+typedef enum {
+    __sx126x_port_op_config,    // radio (re)configuration
+    __sx126x_port_op_tx,        // tx setup and start
+    __sx126x_port_op_rx,        // rx setup and start
+    __sx126x_port_op_cad,       // cad setup and start
+    __sx126x_port_op_irq,       // irq status read and clear
+    __sx126x_port_op_count
+} sx126x_port_op_t;
+
+/** -------------------------------------------------------------------------- *
+ * The port reports how a busy wait was released, the stack accounts the wait
+ * times distribution.
+ * --------------------------------------------------------------------------- *
+ */
+typedef enum {
+    __sx126x_port_busy_free,    // the chip was found free at the first check
+    __sx126x_port_busy_event,   // released by the busy release notification
+    __sx126x_port_busy_polled,  // polled until free
+    __sx126x_port_busy_kinds
+} sx126x_port_busy_wait_t;
+
+// -- upper bounds in usec of the wait times histogram, the last bucket has
+//    the longer waits
+#define __sx126x_port_busy_bounds_us    { 10, 50, 100, 200, 500, 1000, 5000 }
+#define __sx126x_port_busy_buckets      (8)
+
+typedef struct {
+    uint32_t    waits[__sx126x_port_busy_kinds];
+    uint32_t    hist[__sx126x_port_busy_buckets];
+    uint32_t    max_us;
+    uint64_t    sum_us;
+} sx126x_port_busy_stats_t;
+
 typedef int sx126x_port_spi_trx_t ( sx126x_spi_trx_t * p_trx );
-typedef void sx126x_port_wait_on_busy_signal_t ( void );
+typedef sx126x_port_busy_wait_t sx126x_port_wait_on_busy_signal_t ( void );
 typedef void sx126x_port_send_reset_pulse_t ( void );
 typedef bool sx126x_port_int_pin_state_t ( void );
+typedef void sx126x_port_spi_batch_begin_t ( sx126x_port_op_t op );
+typedef void sx126x_port_spi_batch_end_t ( void );
 
 typedef struct {
     sx126x_port_spi_trx_t *             p_spi_trx;
     sx126x_port_wait_on_busy_signal_t * p_wait_on_busy_signal;
     sx126x_port_send_reset_pulse_t *    p_send_reset_pulse;
     sx126x_port_int_pin_state_t *       p_get_int_pin_state;
+
+    // -- optional, NULL if the port does not batch the transactions
+    sx126x_port_spi_batch_begin_t *     p_spi_batch_begin;
+    sx126x_port_spi_batch_end_t *       p_spi_batch_end;
 } sx126x_port_t;
 
 /**
@@ -106,6 +151,18 @@ void sx126x_port_init( sx126x_port_t * p_port_params );
  */
 void sx126x_port_irq( uint32_t timestamp );
 
+/**
+ * @brief   to bracket the spi transactions of one radio operation, the
+ *          brackets may be nested, only the outer ones reach the port
+ */
+void sx126x_port_batch_begin( sx126x_port_op_t op );
+void sx126x_port_batch_end( void );
+
+/**
+ * @brief   to read the busy waits accounting
+ */
+void sx126x_port_get_busy_stats( sx126x_port_busy_stats_t * p_stats );
+
 /* --- end of file ---------------------------------------------------------- */
 #ifdef __cplusplus
 }
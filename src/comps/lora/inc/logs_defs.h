@@ -53,12 +53,19 @@ __log_component_def(lora,       stub_main,      purple,     1, 0)
 __log_component_def(lora,       stub_nvm,       purple,     1, 0)
 __log_component_def(lora,       stub_system,    purple,     1, 0)
 __log_component_def(lora,       stub_timers,    purple,     1, 0)
+__log_component_def(lora,       stub_spi_trace, purple,     1, 0)
+__log_component_def(lora,       stub_frag_store, purple,    1, 0)
 
 // -- lora_raw  group
 __log_component_def(lora,       raw_api,        default,    1, 1)
 __log_component_def(lora,       raw_process,    default,    1, 1)
 __log_component_def(lora,       raw_sm,         default,    1, 1)
 __log_component_def(lora,       raw_radio_if,   default,    1, 1)
+__log_component_def(lora,       raw_xfer,       default,    1, 1)
+__log_component_def(lora,       raw_airtime,    default,    1, 1)
+__log_component_def(lora,       raw_adapt,      default,    1, 1)
+__log_component_def(lora,       raw_hop,        default,    1, 1)
+__log_component_def(lora,       raw_latency,    default,    1, 1)
 
 // -- lora_wan  group
 __log_component_def(lora,       wan_comision,   default,    1, 1)
@@ -76,9 +83,13 @@ __log_component_def(lora,       wan_nvm,        default,    1, 1)
 __log_component_def(lora,       wan_api,        default,    1, 1)
 __log_component_def(lora,       wan_sm,         default,    1, 1)
 __log_component_def(lora,       wan_port,       default,    1, 1)
+__log_component_def(lora,       wan_mc_group,   default,    1, 1)
+__log_component_def(lora,       wan_link,       default,    1, 1)
 
 // -- lora_utils  group
 __log_component_def(lora,       util_nvm,       blue,       1, 1)
+__log_component_def(lora,       util_nvm_journal, blue,     1, 1)
+__log_component_def(lora,       util_frag_store, blue,      1, 1)
 __log_component_def(lora,       util_sync_obj,  blue,       1, 1)
 __log_component_def(lora,       util_evt_hndle, blue,       1, 1)
 
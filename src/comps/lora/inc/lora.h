@@ -54,6 +54,8 @@ typedef enum {
     __LORA_POWERED_OFF,
     __LORA_LCT_MODE_ENABLED,    /**< when un-accepted command during LCT mode
                                  *   is received */
+    __LORA_DUTY_CYCLE_EXCEEDED, /**< LoRa-RAW tx rejected because the airtime
+                                 *   budget of the sub-band is exhausted */
 } lora_error_t;
 
 /**
@@ -72,7 +74,9 @@ typedef enum {
  *          the lora stack.
  *          some control signal are generic to be used with any mode such as:
  *           \a __LORA_IOCTL_SET_CALLBACK, \a __LORA_IOCTL_SET_PARAM,
- *           \a __LORA_IOCTL_GET_PARAM, \a __LORA_IOCTL_VERIFY_PARAM
+ *           \a __LORA_IOCTL_GET_PARAM, \a __LORA_IOCTL_VERIFY_PARAM,
+ *           \a __LORA_IOCTL_SPI_TRACE_SET, \a __LORA_IOCTL_SPI_TRACE_READ,
+ *           \a __LORA_IOCTL_SPI_TRACE_PRINT
  *          and some are mode specific.
  *          LoRa-WAN specific control signals are:
  *           \a __LORA_IOCTL_SET_COMMISSION,
@@ -81,6 +85,12 @@ typedef enum {
  *           \a __LORA_IOCTL_DUTY_CYCLE_START, \a __LORA_IOCTL_DUTY_CYCLE_STOP,
  *           \a __LORA_IOCTL_PORT_OPEN, \a __LORA_IOCTL_PORT_CLOSE,
  *           \a __LORA_IOCTL_PORT_GET_IND_PARAM, \a __LORA_IOCTL_IS_PENDING_TX,
+ *           \a __LORA_IOCTL_PORT_AGGREGATION, \a __LORA_IOCTL_PORT_SCHED,
+ *           \a __LORA_IOCTL_NVM_FLUSH,
+ *           \a __LORA_IOCTL_MCAST_SETUP, \a __LORA_IOCTL_MCAST_DELETE,
+ *           \a __LORA_IOCTL_MCAST_STATUS,
+ *           \a __LORA_IOCTL_LINK_STATS, \a __LORA_IOCTL_LINK_READ,
+ *           \a __LORA_IOCTL_LINK_RESET,
  *           \a __LORA_IOCTL_ENABLE_RX_LISTENING,
  *           \a __LORA_IOCTL_DISABLE_RX_LISTENING
  *          LoRa-RAW specific control signals are:
@@ -88,7 +98,16 @@ typedef enum {
  *           \a __LORA_IOCTL_TX_CONT_WAVE_STOP,
  *           \a __LORA_IOCTL_RX_CONT_START, \a __LORA_IOCTL_RX_CONT_STOP,
  *           \a __LORA_IOCTL_RECONFIG_RADIO,
- *           \a __LORA_IOCTL_RESET_RADIO_PARAMS
+ *           \a __LORA_IOCTL_RESET_RADIO_PARAMS,
+ *           \a __LORA_IOCTL_TX_BURST_START, \a __LORA_IOCTL_TX_BURST_STOP,
+ *           \a __LORA_IOCTL_RX_RING_SET, \a __LORA_IOCTL_RX_RING_READ,
+ *           \a __LORA_IOCTL_RX_RING_STATUS,
+ *           \a __LORA_IOCTL_CAD_SCAN, \a __LORA_IOCTL_LBT_STATS,
+ *           \a __LORA_IOCTL_XFER_SEND, \a __LORA_IOCTL_XFER_RECV,
+ *           \a __LORA_IOCTL_AIRTIME_STATUS,
+ *           \a __LORA_IOCTL_ADAPT_CONFIG, \a __LORA_IOCTL_ADAPT_SEND,
+ *           \a __LORA_IOCTL_ADAPT_RECV, \a __LORA_IOCTL_ADAPT_STATUS,
+ *           \a __LORA_IOCTL_HOP_CONFIG, \a __LORA_IOCTL_HOP_STATUS
  */
 typedef enum {
     /* applicable for all lora modes */
@@ -98,6 +117,11 @@ typedef enum {
     __LORA_IOCTL_GET_PARAM,         /**< to get special mode parameter */
     __LORA_IOCTL_VERIFY_PARAM,      /**< to verify validity of a  special mode
                                          parameter */
+    __LORA_IOCTL_SPI_TRACE_SET,     /**< to start/stop the radio spi trace by
+                \struct lora_spi_trace_cfg_t */
+    __LORA_IOCTL_SPI_TRACE_READ,    /**< to move the oldest spi trace records
+                into \struct lora_spi_trace_read_t in the binary trace format */
+    __LORA_IOCTL_SPI_TRACE_PRINT,   /**< to display the spi trace records */
 
     /* applicable for lora raw mode only */
 
@@ -108,6 +132,45 @@ typedef enum {
     __LORA_IOCTL_RX_CONT_STOP,      /**< to order exit of rx continuous mode */
     __LORA_IOCTL_RECONFIG_RADIO,    /**< to apply the configured radio params */
     __LORA_IOCTL_RESET_RADIO_PARAMS,/**< to reset radio params to defaults */
+    __LORA_IOCTL_TX_BURST_START,    /**< to enter the back-to-back tx mode, the
+                following lora_tx() calls are queued and return immediately */
+    __LORA_IOCTL_TX_BURST_STOP,     /**< to exit the back-to-back tx mode after
+                sending all the queued messages */
+    __LORA_IOCTL_RX_RING_SET,       /**< to enable/disable the rx ring with the
+                configurations of \struct lora_raw_rx_ring_cfg_t */
+    __LORA_IOCTL_RX_RING_READ,      /**< to pop the oldest frame of the rx ring
+                into \struct lora_raw_rx_ring_frame_t, it returns __LORA_ERROR
+                if the ring is empty */
+    __LORA_IOCTL_RX_RING_STATUS,    /**< to get the rx ring status into
+                \struct lora_raw_rx_ring_status_t */
+    __LORA_IOCTL_CAD_SCAN,          /**< to scan a list of channels for
+                activity as described by \struct lora_raw_cad_scan_t, it
+                returns __LORA_ERROR if the radio is busy */
+    __LORA_IOCTL_LBT_STATS,         /**< to get the listen-before-talk
+                statistics into \struct lora_raw_lbt_stats_t */
+    __LORA_IOCTL_XFER_SEND,         /**< to send an object reliably as
+                described by \struct lora_raw_xfer_t, it blocks until the
+                whole object is acknowledged or returns __LORA_ERROR */
+    __LORA_IOCTL_XFER_RECV,         /**< to receive an object sent by
+                __LORA_IOCTL_XFER_SEND, it blocks until the object is
+                received or returns __LORA_ERROR on the idle timeout */
+    __LORA_IOCTL_AIRTIME_STATUS,    /**< to get the airtime budget of the
+                current sub-band into \struct lora_raw_airtime_status_t */
+    __LORA_IOCTL_ADAPT_CONFIG,      /**< to configure the link adaptation by
+                \struct lora_raw_adapt_cfg_t */
+    __LORA_IOCTL_ADAPT_SEND,        /**< to send a message to a peer at the
+                adapted rate \struct lora_raw_adapt_msg_t, it blocks until the
+                message is acknowledged or the retries are over */
+    __LORA_IOCTL_ADAPT_RECV,        /**< to receive a message from any peer
+                \struct lora_raw_adapt_msg_t, it blocks until a message is
+                received or the timeout is over */
+    __LORA_IOCTL_ADAPT_STATUS,      /**< to get the link status of a peer into
+                \struct lora_raw_adapt_status_t */
+    __LORA_IOCTL_HOP_CONFIG,        /**< to enable or disable the frequency
+                hopping by \struct lora_raw_hop_cfg_t, it returns
+                __LORA_ERROR on an invalid channel plan */
+    __LORA_IOCTL_HOP_STATUS,        /**< to get the frequency hopping status
+                into \struct lora_raw_hop_status_t */
 
     /* applicable for lora wan mode only */
 
@@ -132,6 +195,27 @@ typedef enum {
                 user should fetch all pending indications until the indication
                 parameter event is __LORA_EVENT_NONE which means no more
                 pending indications */
+    __LORA_IOCTL_PORT_AGGREGATION,  /**< to enable or disable the uplink
+                aggregation of an opened port by \struct lora_wan_port_aggr_t,
+                it returns __LORA_ERROR if the port is not opened */
+    __LORA_IOCTL_PORT_SCHED,        /**< to set the uplink scheduling priority
+                and weight of an opened port by \struct lora_wan_port_sched_t,
+                it returns __LORA_ERROR if the port is not opened */
+    __LORA_IOCTL_NVM_FLUSH,         /**< to commit the mac context changes that
+                are still pending in the nvm write-behind period, it shall be
+                used before powering down the device, no argument */
+    __LORA_IOCTL_MCAST_SETUP,       /**< to set up a multicast group and its
+                reception session by \struct lora_wan_mcast_setup_t */
+    __LORA_IOCTL_MCAST_DELETE,      /**< to delete a multicast group, the
+                argument is a pointer to the uint8_t group id */
+    __LORA_IOCTL_MCAST_STATUS,      /**< to get the setup and the counters of
+                a multicast group into \struct lora_wan_mcast_status_t */
+    __LORA_IOCTL_LINK_STATS,        /**< to get the uplinks link quality
+                statistics into \struct lora_wan_link_stats_t */
+    __LORA_IOCTL_LINK_READ,         /**< to copy the link records kept in the
+                link ring as described by \struct lora_wan_link_read_t */
+    __LORA_IOCTL_LINK_RESET,        /**< to drop the link records and clear the
+                link statistics, no argument */
     __LORA_IOCTL_IS_PENDING_TX,     /**< to check if there is pending tx req */
     __LORA_IOCTL_ENABLE_RX_LISTENING,/**< to enable listening to the network for
                 downlink frames by sending empty message to trigger class-A
@@ -157,6 +241,7 @@ typedef enum {
     __LORA_EVENT_RX_DONE,       /**< rx done successfully */
     __LORA_EVENT_RX_TIMEOUT,    /**< rx timeout */
     __LORA_EVENT_RX_FAIL,       /**< rx timeout */
+    __LORA_EVENT_RX_BATCH,      /**< the rx ring has a batch of frames ready */
 
     __LORA_EVENT_INDICATION,    /**< special for lora-wan indications */
     __LORA_EVENT_NONE,  /**< indicate the end of pending indication events */
@@ -193,6 +278,26 @@ typedef enum {
     __LORA_REGION_RU864
 } lora_region_t;
 
+/**
+ * radio spi trace configurations
+ */
+typedef struct {
+    bool        enable; /**< start or stop recording the spi transactions */
+    bool        clear;  /**< drop the records in the trace ring */
+} lora_spi_trace_cfg_t;
+
+/**
+ * radio spi trace read request, the records are written in the binary format
+ * described in sx126x_trace.h
+ */
+typedef struct {
+    uint8_t*    buf;        /**< buffer at which the trace is written */
+    uint32_t    size;       /**< the buffer size */
+    uint32_t    len;        /**< the written length */
+    uint32_t    count;      /**< the written records count */
+    uint32_t    dropped;    /**< the records overwritten before being read */
+} lora_spi_trace_read_t;
+
 /** -------------------------------------------------------------------------- *
  * LoRa WAN Specific APIs
  * --------------------------------------------------------------------------- *
@@ -257,6 +362,11 @@ typedef enum {
     __LORA_WAN_PARAM_CAL_RXWIN_EXTENSION,
                             /**< rx-window time-extension calibration param */
     __LORA_WAN_PARAM_CAL_ENABLE,/**< rx-window calibration param enable */
+    __LORA_WAN_PARAM_CAL_AUTO,  /**< rx-window auto-calibration enable, it
+                                     adapts the time-shift and extension */
+    __LORA_WAN_PARAM_CAL_AUTO_TARGET,
+                            /**< rx-window auto-calibration downlinks success
+                                 rate target in percent */
 } lora_wan_param_type_t;
 
 /**
@@ -273,6 +383,8 @@ typedef struct {
         bool        cal_enable;         /**< fine tune calibration enable */
         int32_t     cal_time_shift;     /**< calibration time-shift */
         int32_t     cal_time_extension; /**< calibration time-extension */
+        bool        cal_auto;           /**< auto-calibration enable */
+        uint8_t     cal_auto_target;    /**< auto-calibration target 1..100 */
     } param;
 } lora_wan_param_t;
 
@@ -339,8 +451,29 @@ typedef enum {
         for the current modulation parameters */
     __LORA_RAW_PARAM_RX_TIMEOUT,    /**< the rx window time in non continuous
                                          reception mode */
+    __LORA_RAW_PARAM_LBT,           /**< to enable/disable listen-before-talk,
+        a channel activity detection (CAD) is done before every transmission
+        and the transmission is postponed while the channel is busy */
+    __LORA_RAW_PARAM_LBT_ATTEMPTS,  /**< the maximum CAD attempts of a message
+        before dropping it with a tx-fail event */
+    __LORA_RAW_PARAM_LBT_BACKOFF,   /**< the maximum random backoff time in
+        msec between the CAD attempts */
+    __LORA_RAW_PARAM_DUTY_POLICY,   /**< the action taken on a message that
+        exceeds the regional duty-cycle budget, \enum lora_raw_duty_policy_t */
 } lora_raw_param_type_t;
 
+/**
+ * LoRaRAW duty-cycle enforcement policies
+ */
+typedef enum {
+    __LORA_RAW_DUTY_WARN,       /**< the message is sent and a warning is
+                                     logged when the budget is exceeded */
+    __LORA_RAW_DUTY_REJECT,     /**< the message is rejected with the error
+                                     __LORA_DUTY_CYCLE_EXCEEDED */
+    __LORA_RAW_DUTY_QUEUE,      /**< the caller is blocked until the budget
+                                     allows the message */
+} lora_raw_duty_policy_t;
+
 /**
  * LoRaRAW parameter descriptor
  */
@@ -366,9 +499,259 @@ typedef struct {
         uint8_t     symb_timeout; /*< symbols timeout */
         uint32_t    tx_timeout; /**< tx default window time */
         uint32_t    rx_timeout; /**< rx default window time */
+        bool        lbt;        /**< listen-before-talk enable */
+        uint8_t     lbt_attempts; /**< max CAD attempts per message */
+        uint16_t    lbt_backoff;/**< max random backoff in msec */
+        uint8_t     duty_policy;/**< duty-cycle enforcement policy */
     } param;
 } lora_raw_param_t;
 
+/**
+ * LoRaRAW multi-channel activity scan
+ */
+#define __LORA_RAW_CAD_SCAN_MAX_CHANNELS    (32)
+typedef struct {
+    const uint32_t* freqs;  /**< the frequencies of the channels in Hz */
+    uint8_t*    busy;       /**< output: per channel, the number of CADs that
+                                 detected activity, it has \a count entries */
+    uint8_t     count;      /**< number of the channels, up to
+                                 __LORA_RAW_CAD_SCAN_MAX_CHANNELS */
+    uint8_t     rounds;     /**< number of CADs per channel, the channel
+                                 occupancy is busy[i] / rounds */
+    uint32_t    duration;   /**< output: the scan duration in msec */
+} lora_raw_cad_scan_t;
+
+/**
+ * LoRaRAW listen-before-talk statistics
+ */
+typedef struct {
+    uint32_t    packets;        /**< messages sent on a clear channel */
+    uint32_t    failed;         /**< messages dropped after all the attempts */
+    uint32_t    cad_count;      /**< performed CADs */
+    uint32_t    busy_count;     /**< CADs that found the channel busy, each
+                                     one is a transmission that would have
+                                     collided (collisions avoided) */
+    uint8_t     last_attempts;  /**< CAD attempts of the last message */
+    uint8_t     max_attempts;   /**< maximum CAD attempts of a message */
+} lora_raw_lbt_stats_t;
+
+/**
+ * LoRaRAW airtime budget of the sub-band of the current frequency, the budget
+ * is the duty-cycle of the sub-band over a sliding window of one hour
+ */
+typedef struct {
+    uint8_t     len;        /**< input: a message length to evaluate, zero for
+                                 the maximum payload length */
+    uint32_t    toa;        /**< time on air in msec of a message of \a len */
+    uint32_t    wait;       /**< msec until the message of \a len is permitted,
+                                 zero if it is permitted now, UINT32_MAX if it
+                                 exceeds the whole budget */
+    uint32_t    remaining;  /**< remaining airtime in msec in the window */
+    uint32_t    used;       /**< used airtime in msec in the window */
+    uint32_t    limit;      /**< airtime budget in msec per window */
+    uint16_t    duty;       /**< sub-band duty-cycle in 0.01 % units */
+    uint32_t    band_low;   /**< sub-band lower edge in Hz */
+    uint32_t    band_high;  /**< sub-band upper edge in Hz */
+    uint32_t    total;      /**< total airtime in msec of all the sub-bands */
+    uint32_t    frames;     /**< admitted messages */
+    uint32_t    exceeded;   /**< messages sent over the budget (warn policy) */
+    uint32_t    rejected;   /**< messages rejected (reject policy) */
+    uint32_t    queued;     /**< messages delayed (queue policy) */
+} lora_raw_airtime_status_t;
+
+/**
+ * LoRaRAW reliable transfer (xfer) streaming i/o callback. It reads (sender)
+ * or writes (receiver) \a len bytes at the byte \a offset of the transferred
+ * object, it returns false on an i/o error which aborts the transfer.
+ */
+typedef bool lora_raw_xfer_io_t(void* ctx, uint32_t offset,
+    uint8_t* buf, uint8_t len);
+
+/**
+ * LoRaRAW reliable transfer statistics
+ */
+typedef struct {
+    uint32_t    duration;       /**< transfer duration in msec */
+    uint32_t    goodput;        /**< object bytes per second */
+    uint32_t    data_frames;    /**< data frames sent or received */
+    uint32_t    retransmissions;/**< data frames sent again (sender) */
+    uint32_t    parity_frames;  /**< xor parity frames sent or received */
+    uint32_t    recovered;      /**< data frames rebuilt from parity */
+    uint32_t    acks;           /**< acknowledgements sent or received */
+    uint32_t    polls;          /**< unanswered acknowledgement requests */
+    uint8_t     chunk;          /**< the last used data chunk size */
+} lora_raw_xfer_stats_t;
+
+/**
+ * LoRaRAW reliable transfer description
+ */
+#define __LORA_RAW_XFER_MAX_WINDOW  (64)
+typedef struct {
+    lora_raw_xfer_io_t* io; /**< read (send) or write (recv) callback */
+    void*       ctx;        /**< the i/o callback context */
+    uint32_t    size;       /**< the object size, an output for the receiver */
+    uint8_t     window;     /**< data frames per acknowledgement round, up to
+                                 __LORA_RAW_XFER_MAX_WINDOW (sender only) */
+    uint8_t     fec;        /**< data frames protected by one xor parity
+                                 frame, zero disables the parity (sender) */
+    uint8_t     retries;    /**< acknowledgement requests without an answer
+                                 before giving up (sender only) */
+    uint32_t    timeout;    /**< acknowledgement wait (sender) or idle time
+                                 without frames (receiver) in msec */
+    lora_raw_xfer_stats_t stats; /**< output: the transfer statistics */
+} lora_raw_xfer_t;
+
+/**
+ * LoRaRAW link adaptation configurations. The rate steps start at the
+ * configured spreading factor and bandwidth (the base rate), then they
+ * decrease the spreading factor down to SF7 and widen the bandwidth up to
+ * \a max_bw. The tx power is reduced in 2 dB steps at the fastest rate only.
+ */
+#define __LORA_RAW_ADAPT_MAX_PEERS  (8)
+typedef struct {
+    uint8_t     addr;       /**< the address of this node on the links */
+    uint8_t     margin;     /**< snr margin in dB kept above the demodulation
+                                 limit of the selected spreading factor */
+    uint8_t     max_bw;     /**< the widest bandwidth of the rate steps,
+                                 \enum lora_bw_t */
+    uint8_t     max_power_cut; /**< maximum tx power reduction in dB */
+    uint8_t     retries;    /**< message transmissions without an ack before
+                                 falling back to the base rate (sender) */
+    uint32_t    timeout;    /**< ack wait in msec (sender), zero for the
+                                 double time-on-air of the base rate */
+    uint32_t    idle;       /**< msec without an exchange with a peer after
+                                 which its link restarts at the base rate */
+} lora_raw_adapt_cfg_t;
+
+/**
+ * LoRaRAW link adaptation message
+ */
+typedef struct {
+    uint8_t     peer;       /**< destination address (send), or the source
+                                 address as an output (recv) */
+    uint8_t*    buf;        /**< the message data */
+    uint8_t     len;        /**< message length (send), the buffer size as an
+                                 input and the message length as an output
+                                 (recv) */
+    uint32_t    timeout;    /**< msec to wait for a message (recv only) */
+    int8_t      rssi;       /**< output: the message rssi (recv only) */
+    int8_t      snr;        /**< output: the message snr (recv only) */
+} lora_raw_adapt_msg_t;
+
+/**
+ * LoRaRAW link adaptation status of a peer
+ */
+typedef struct {
+    uint8_t     peer;       /**< input: the peer address */
+    bool        known;      /**< the peer has exchanged messages */
+    uint8_t     steps;      /**< number of the rate steps */
+    uint8_t     tx_step;    /**< rate step of the messages to the peer, as
+                                 answered by the peer, zero is the base rate */
+    uint8_t     tx_sf;      /**< spreading factor of \a tx_step */
+    uint8_t     tx_bw;      /**< bandwidth of \a tx_step */
+    uint8_t     tx_power_cut; /**< tx power reduction in dB to the peer */
+    uint8_t     rx_step;    /**< rate step of the messages from the peer, as
+                                 decided by this node */
+    uint8_t     rx_sf;      /**< spreading factor of \a rx_step */
+    uint8_t     rx_bw;      /**< bandwidth of \a rx_step */
+    uint8_t     rx_power_cut; /**< tx power reduction in dB of the peer */
+    int8_t      tx_snr;     /**< snr of the last message to the peer as
+                                 reported in its ack */
+    int8_t      tx_rssi;    /**< rssi of the last message to the peer as
+                                 reported in its ack */
+    int8_t      rx_snr;     /**< snr of the last message from the peer */
+    int8_t      rx_rssi;    /**< rssi of the last message from the peer */
+    int8_t      snr_min;    /**< lowest snr of the recent messages from the
+                                 peer normalized to the base rate at full
+                                 power, it drives the rx step decisions */
+    uint32_t    sent;       /**< transmitted messages including the retries */
+    uint32_t    acked;      /**< acknowledged messages */
+    uint32_t    retries;    /**< repeated transmissions */
+    uint32_t    received;   /**< received messages including the duplicates */
+    uint32_t    duplicates; /**< messages received again after a lost ack */
+    uint32_t    ups;        /**< switches to a faster step or a lower power */
+    uint32_t    downs;      /**< switches to a slower step or a higher power */
+    uint32_t    fallbacks;  /**< restarts at the base rate after losses or an
+                                 idle link */
+} lora_raw_adapt_status_t;
+
+/**
+ * LoRaRAW frequency hopping configurations. The time is divided into slots of
+ * \a dwell msec, every slot carries at most one message on the channel of the
+ * slot in the pseudo-random hop sequence generated from \a seed. The nodes of
+ * a link shall use the same channels, seed and dwell time.
+ */
+#define __LORA_RAW_HOP_MAX_CHANNELS (16)
+typedef struct {
+    bool        enable;     /**< enables or disables the hopping */
+    uint8_t     count;      /**< channels count, zero for the region default
+                                 channel plan, it is an output too */
+    uint32_t    freqs[__LORA_RAW_HOP_MAX_CHANNELS]; /**< channels frequencies
+                                 in Hz, they are an output for the region
+                                 default channel plan */
+    uint16_t    seed;       /**< hop sequence seed, the links sharing the
+                                 band shall use different seeds */
+    uint32_t    dwell;      /**< slot duration in msec, zero for the
+                                 time-on-air of the payload length plus a
+                                 guard time */
+    uint32_t    sync_timeout; /**< msec without any message after which the
+                                 receiver waits on the first channel of the
+                                 sequence for a new synchronization */
+} lora_raw_hop_cfg_t;
+
+/**
+ * LoRaRAW frequency hopping status
+ */
+typedef struct {
+    bool        enabled;    /**< the hopping is enabled */
+    bool        synced;     /**< the slots timing follows the peer */
+    uint8_t     count;      /**< channels count */
+    uint8_t     channel;    /**< channel index of the present slot */
+    uint32_t    freq;       /**< frequency of the present slot in Hz */
+    uint32_t    dwell;      /**< slot duration in msec */
+    uint32_t    tx_frames;  /**< messages sent with the hopping */
+    uint32_t    rx_frames;  /**< messages received with the hopping */
+    uint32_t    tx_delays;  /**< messages delayed to the next slot start */
+    uint32_t    hops;       /**< receiver channel changes */
+    uint32_t    syncs;      /**< synchronizations from the parked state */
+    uint32_t    adjusts;    /**< slots timing corrections */
+} lora_raw_hop_status_t;
+
+/**
+ * LoRaRAW rx ring configurations
+ */
+typedef struct {
+    bool        enable; /**< store the received frames in the rx ring instead
+                             of delivering them through the rx-done event */
+    uint8_t     batch;  /**< raise __LORA_EVENT_RX_BATCH once this number of
+                             frames is ready in the ring, zero for no events */
+} lora_raw_rx_ring_cfg_t;
+
+/**
+ * LoRaRAW rx ring frame
+ */
+typedef struct {
+    uint8_t     buf[255];   /**< the received data */
+    uint8_t     len;        /**< length of the received data */
+    int8_t      rssi;       /**< received signal strength indicator */
+    int8_t      snr;        /**< signal to noise ratio */
+    uint32_t    timestamp;  /**< reception time in msec */
+    uint32_t    overruns;   /**< frames dropped on a full ring just before
+                                 this frame was stored */
+} lora_raw_rx_ring_frame_t;
+
+/**
+ * LoRaRAW rx ring status
+ */
+typedef struct {
+    bool        enabled;    /**< the rx ring is enabled */
+    uint8_t     batch;      /**< the configured batch size */
+    uint32_t    count;      /**< frames ready in the ring */
+    uint32_t    slots;      /**< the ring capacity */
+    uint32_t    stored;     /**< total stored frames */
+    uint32_t    overruns;   /**< total dropped frames due to a full ring */
+} lora_raw_rx_ring_status_t;
+
 /**
  * LoRaRAW tx continuous wave parameters
  */
@@ -392,6 +775,146 @@ typedef struct {
     uint32_t        msg_app_id; /**< special message id (LoRaWAN mode only) */
 } lora_tx_params_t;
 
+/**
+ * LoRaWAN port uplink aggregation setting. When enabled, the queued messages
+ * of the port are coalesced into one uplink frame up to the current maximum
+ * payload size. Every message is written in the frame as a length byte
+ * followed by the message bytes, the network application shall split the
+ * frame payload accordingly. Each message still gets its own indication.
+ */
+typedef struct {
+    uint8_t     port;       /**< an opened lora-wan port */
+    bool        enable;     /**< coalesce the queued messages of this port */
+} lora_wan_port_aggr_t;
+
+/**
+ * LoRaWAN port uplink scheduling setting. The queued messages of the ports of
+ * the highest priority are sent first. Among them, the message of the earliest
+ * timeout is sent first, and the messages without timeout are shared between
+ * these ports according to their weights.
+ */
+typedef struct {
+    uint8_t     port;       /**< an opened lora-wan port */
+    uint8_t     priority;   /**< the higher is served first, default 0 */
+    uint8_t     weight;     /**< share among the same priority ports,
+                                 default 1 */
+} lora_wan_port_sched_t;
+
+/**
+ * LoRaWAN multicast group setup. The group downlinks are received in the
+ * class B ping slots or in the class C continuous reception of the session.
+ * A class C session switches the device temporarily to class C and back when
+ * it ends, a class B session requires the device to be in class B already.
+ * The received messages are indicated on their ports as the unicast ones with
+ * the group id in the indication parameters.
+ */
+#define __LORA_WAN_MCAST_GROUPS     (4)
+typedef struct {
+    uint8_t     group;          /**< group id, 0 .. __LORA_WAN_MCAST_GROUPS-1 */
+    uint32_t    addr;           /**< multicast group device address */
+    uint8_t*    nwk_s_key;      /**< McNwkSKey, 16 bytes */
+    uint8_t*    app_s_key;      /**< McAppSKey, 16 bytes */
+    uint32_t    f_cnt_min;      /**< the first accepted downlink counter */
+    uint32_t    f_cnt_max;      /**< the last accepted downlink counter */
+    lora_wan_class_t class;     /**< __LORA_WAN_CLASS_B or __LORA_WAN_CLASS_C */
+    uint32_t    frequency;      /**< reception frequency in Hz */
+    int8_t      data_rate;      /**< reception data-rate */
+    uint8_t     periodicity;    /**< class B ping slots periodicity, 0 .. 7 */
+    uint32_t    session_start;  /**< session start from now in seconds */
+    uint32_t    session_time;   /**< session duration in seconds, 0 keeps
+                                     the session until the group deletion */
+} lora_wan_mcast_setup_t;
+
+/**
+ * LoRaWAN multicast group status, the counters account only the downlinks
+ * accepted by the stack, the groups set up remotely are counted as well
+ */
+typedef struct {
+    uint8_t     group;          /**< the requested group id */
+    bool        is_setup;       /**< set up by __LORA_IOCTL_MCAST_SETUP */
+    bool        is_session;     /**< its reception session is running */
+    uint32_t    addr;
+    lora_wan_class_t class;
+    uint32_t    frequency;
+    int8_t      data_rate;
+    uint32_t    rx_frames;      /**< received downlinks */
+    uint32_t    rx_bytes;       /**< received application bytes */
+    uint32_t    last_f_cnt;     /**< downlink counter of the last one */
+    int8_t      last_rssi;
+    int8_t      last_snr;
+} lora_wan_mcast_status_t;
+
+/**
+ * LoRaWAN link quality record of one uplink transaction, from its first
+ * transmission until it is acknowledged, sent, failed or timed out. The link
+ * ring keeps the latest ones, the size is set by the configuration
+ * CONFIG_LORA_WAN_LINK_RING_SLOTS
+ */
+typedef enum {
+    __LORA_WAN_LINK_SENT,       /**< unconfirmed uplink sent */
+    __LORA_WAN_LINK_ACKED,      /**< confirmed uplink acknowledged */
+    __LORA_WAN_LINK_NOT_ACKED,  /**< no ack received after all the retries */
+    __LORA_WAN_LINK_FAILED,     /**< the mac could not transmit the uplink */
+    __LORA_WAN_LINK_TIMEOUT,    /**< the message timed out while sending */
+} lora_wan_link_result_t;
+
+typedef struct {
+    uint32_t    seq;            /**< transaction sequence number */
+    uint32_t    timestamp;      /**< msec timestamp of the transaction end */
+    uint32_t    ul_counter;     /**< uplink counter of the last transmission */
+    uint32_t    airtime;        /**< usec time on air of all transmissions */
+    uint8_t     port;
+    int8_t      data_rate;      /**< data-rate of the last transmission */
+    int8_t      tx_power;       /**< tx power of the last transmission */
+    uint8_t     retries;        /**< transmissions after the first one */
+    uint8_t     result;         /**< \enum lora_wan_link_result_t */
+    bool        has_dl;         /**< a downlink was received in the rx windows
+                                     of the transaction */
+    bool        has_margin;     /**< the downlink snr margin is known */
+    int8_t      dl_rssi;        /**< downlink rssi in dBm */
+    int8_t      dl_snr;         /**< downlink snr in dB */
+    int8_t      dl_snr_margin;  /**< downlink snr above the demodulation floor
+                                     of its spreading factor in dB */
+} lora_wan_link_record_t;
+
+/**
+ * link records read request, the records kept in the ring from the sequence
+ * number \a since are copied oldest first
+ */
+typedef struct {
+    lora_wan_link_record_t* p_records;  /**< array receiving the records */
+    uint16_t    max;            /**< the array size */
+    uint16_t    count;          /**< the copied records count */
+    uint32_t    since;          /**< the first requested sequence number */
+    uint32_t    next;           /**< the sequence number of the next record,
+                                     to be used as \a since of the next read */
+    uint32_t    dropped;        /**< requested records already overwritten */
+} lora_wan_link_read_t;
+
+/**
+ * link statistics per uplink data-rate since the last reset, the packet error
+ * rate is measured on the confirmed transmissions as 1 - acked / confirmed
+ */
+#define __LORA_WAN_LINK_DR_COUNT    (16)
+typedef struct {
+    uint32_t    transactions;   /**< ended on this data-rate */
+    uint32_t    transmissions;  /**< all the transmissions with the retries */
+    uint32_t    confirmed;      /**< confirmed transmissions */
+    uint32_t    acked;          /**< acknowledged confirmed transmissions */
+    uint32_t    airtime;        /**< msec time on air */
+} lora_wan_link_dr_stats_t;
+
+typedef struct {
+    uint32_t    transactions;   /**< all the recorded transactions */
+    uint32_t    failures;       /**< not acked, failed and timed out ones */
+    uint32_t    downlinks;      /**< transactions with a downlink */
+    int16_t     snr_margin_avg; /**< moving average of the downlinks snr
+                                     margin in 1/16 dB */
+    int16_t     rssi_avg;       /**< moving average of the downlinks rssi in
+                                     1/16 dBm */
+    lora_wan_link_dr_stats_t dr[__LORA_WAN_LINK_DR_COUNT];
+} lora_wan_link_stats_t;
+
 /**
  * rx message parameters description
  */
@@ -435,6 +958,8 @@ typedef struct {
             int8_t   rssi;      /**< received signal strength indicator */
             int8_t   snr;       /**< signal to noise ratio */
             int8_t   data_rate; /**< the rx data-rate of this message */
+            int8_t   mcast_group; /**< the multicast group of this message,
+                                       -1 for a unicast message */
         } rx;
     };
 } lora_wan_ind_params_t;
@@ -56,6 +56,7 @@ typedef void  lora_port_timer_set_period_t(void* handle, uint32_t msec);
 
 // -- system time handling ports types
 typedef uint32_t lora_port_get_timestamp_ms_t(void);
+typedef uint32_t lora_port_get_timestamp_us_t(void);
 typedef void     lora_port_delay_ms_t(uint32_t msec);
 
 // -- critical section accessors ports types
@@ -67,11 +68,25 @@ typedef void lora_port_mutex_unlock_t(void* handle);
 typedef void* lora_port_sem_new_t(void);
 typedef void lora_port_sem_wait_t(void* handle);
 typedef void lora_port_sem_signal_t(void* handle);
+typedef bool lora_port_sem_wait_timeout_t(void* handle, uint32_t msec);
 
 // -- crc32 port type
 typedef uint32_t lora_port_crc32_calc_t(
     uint32_t initial_crc, uint8_t * buf, uint32_t len);
 
+// -- fragmented data block store ports types, a flash partition area that
+// -- receives the data blocks of the fragmentation package (FUOTA). The open
+// -- gives the area size and its erase sector size, the close hands over a
+// -- complete block to be validated (ota image) or drops it
+typedef int lora_port_frag_store_open_t(uint32_t* p_size,
+    uint32_t* p_sector_size);
+typedef int lora_port_frag_store_erase_t(uint32_t offset, uint32_t size);
+typedef int lora_port_frag_store_write_t(
+    uint32_t offset, uint8_t* buf, uint32_t size);
+typedef int lora_port_frag_store_read_t(
+    uint32_t offset, uint8_t* buf, uint32_t size);
+typedef int lora_port_frag_store_close_t(bool is_complete, uint32_t size);
+
 typedef struct {
     // -- non-volatile memory (nvm)
     lora_port_nvm_check_t * nvm_check;
@@ -100,9 +115,18 @@ typedef struct {
     lora_port_sem_new_t* sem_new;
     lora_port_sem_wait_t* sem_wait;
     lora_port_sem_signal_t* sem_signal;
+    lora_port_sem_wait_timeout_t* sem_wait_timeout; /* ( optional ) */
 
     // -- optional utilities ( optional )
     lora_port_crc32_calc_t * crc32_calc;
+    lora_port_get_timestamp_us_t * get_timestamp_usec; /* latency stats */
+
+    // -- fragmented data block store ( optional )
+    lora_port_frag_store_open_t  * frag_store_open;
+    lora_port_frag_store_erase_t * frag_store_erase;
+    lora_port_frag_store_write_t * frag_store_write;
+    lora_port_frag_store_read_t  * frag_store_read;
+    lora_port_frag_store_close_t * frag_store_close;
 
 } lora_port_params_t;
 
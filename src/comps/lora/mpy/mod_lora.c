@@ -30,6 +30,8 @@
  * --------------------------------------------------------------------------- *
  */
 #include <math.h>
+#include <string.h>
+
 #define __log_subsystem  lora
 #define __log_component  mpy_lora
 #include "log_lib.h"
@@ -66,6 +68,10 @@ __mp_mod_class_const(lora, _cr,         CODING_4_6,     __LORA_CR_4_6);
 __mp_mod_class_const(lora, _cr,         CODING_4_7,     __LORA_CR_4_7);
 __mp_mod_class_const(lora, _cr,         CODING_4_8,     __LORA_CR_4_8);
 
+__mp_mod_class_const(lora, _duty,       DUTY_WARN,      __LORA_RAW_DUTY_WARN);
+__mp_mod_class_const(lora, _duty,       DUTY_REJECT,    __LORA_RAW_DUTY_REJECT);
+__mp_mod_class_const(lora, _duty,       DUTY_QUEUE,     __LORA_RAW_DUTY_QUEUE);
+
 __mp_mod_class_const(lora, _region,     REGION_AS923,   __LORA_REGION_AS923);
 __mp_mod_class_const(lora, _region,     REGION_AU915,   __LORA_REGION_AU915);
 __mp_mod_class_const(lora, _region,     REGION_CN470,   __LORA_REGION_CN470);
@@ -200,6 +206,12 @@ __mp_mod_fun_0(lora, is_tx_pending)(void)
         return MP_ROM_FALSE;
 }
 
+__mp_mod_fun_0(lora, nvm_flush)(void)
+{
+    lora_ioctl(__LORA_IOCTL_NVM_FLUSH, NULL);
+    return mp_const_none;
+}
+
 __mp_mod_fun_kw(lora, send, 1)(
         size_t n_args, const mp_obj_t *pos_args, mp_map_t* kw_args)
 {
@@ -267,18 +279,27 @@ __mp_mod_fun_kw(lora, send, 1)(
         .msg_app_id = __arg_id_int
     };
 
-    if( __arg_sync_bool )
+    /* in raw mode, the duty-cycle queue policy may block the caller */
+    bool release_gil = __arg_sync_bool || mode == __LORA_MODE_RAW;
+
+    if( release_gil )
     {
         MP_THREAD_GIL_EXIT();
     }
 
-    lora_tx( & tx_params );
+    lora_error_t ret = lora_tx( & tx_params );
 
-    if( __arg_sync_bool )
+    if( release_gil )
     {
         MP_THREAD_GIL_ENTER();
     }
 
+    if( ret == __LORA_DUTY_CYCLE_EXCEEDED )
+    {
+        mp_raise_msg(&mp_type_OSError,
+            MP_ERROR_TEXT("duty-cycle budget exceeded"));
+    }
+
     return mp_const_none;
 
     #undef __arg_buf_obj
@@ -624,17 +645,23 @@ __mp_mod_fun_kw(lora, rxwin_calibrate, 0)(
     #define __arg_cal_enable_idx            1
     #define __arg_cal_time_shift_idx        2
     #define __arg_cal_time_extension_idx    3
+    #define __arg_cal_auto_idx              4
+    #define __arg_cal_auto_target_idx       5
 
     #define __arg_sys_rx_err_type            int
     #define __arg_cal_enable_type            bool
     #define __arg_cal_time_shift_type        int
     #define __arg_cal_time_extension_type    int
+    #define __arg_cal_auto_type              bool
+    #define __arg_cal_auto_target_type       int
 
     static mp_arg_t allowed_args[] = {
         { MP_QSTR_sys_rx_err,  MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = 0}},
         { MP_QSTR_enable, MP_ARG_KW_ONLY | MP_ARG_INT, {.u_bool = 0}},
         { MP_QSTR_time_shift, MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = 0}},
         { MP_QSTR_time_extension, MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = 0}},
+        { MP_QSTR_auto, MP_ARG_KW_ONLY | MP_ARG_BOOL, {.u_bool = 0}},
+        { MP_QSTR_target, MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = 0}},
     };
 
     #define __arg_defval(_arg, _type)   \
@@ -659,6 +686,12 @@ __mp_mod_fun_kw(lora, rxwin_calibrate, 0)(
     __ioctl_get(__LORA_WAN_PARAM_CAL_RXWIN_EXTENSION, int, cal_time_extension);
     __arg_defval(cal_time_extension, int) = cal_time_extension;
 
+    __ioctl_get(__LORA_WAN_PARAM_CAL_AUTO, bool, cal_auto);
+    __arg_defval(cal_auto, bool) = cal_auto;
+
+    __ioctl_get(__LORA_WAN_PARAM_CAL_AUTO_TARGET, int, cal_auto_target);
+    __arg_defval(cal_auto_target, int) = cal_auto_target;
+
     if(kw_args->used == 0)
     {
         static const qstr lw_rxwin_cal_params_dict_keys[] = {
@@ -666,13 +699,15 @@ __mp_mod_fun_kw(lora, rxwin_calibrate, 0)(
             [__arg_cal_enable_idx]          = MP_QSTR_enable,
             [__arg_cal_time_shift_idx]      = MP_QSTR_time_shift,
             [__arg_cal_time_extension_idx]  = MP_QSTR_time_extension,
+            [__arg_cal_auto_idx]            = MP_QSTR_auto,
+            [__arg_cal_auto_target_idx]     = MP_QSTR_target,
         };
         static mp_obj_tuple_t lw_rxwin_cal_params_dict_obj = {
             .base = {&mp_type_attrtuple},
             .len = sizeof(lw_rxwin_cal_params_dict_keys)
                     / sizeof(lw_rxwin_cal_params_dict_keys[0]),
             .items = { 
-                0, 0, 0, 0,
+                0, 0, 0, 0, 0, 0,
                 MP_ROM_PTR((void *)lw_rxwin_cal_params_dict_keys)
             }
         };
@@ -681,6 +716,8 @@ __mp_mod_fun_kw(lora, rxwin_calibrate, 0)(
         p_items[__arg_cal_enable_idx] = MP_ROM_INT(cal_enable);
         p_items[__arg_cal_time_shift_idx] = MP_ROM_INT(cal_time_shift);
         p_items[__arg_cal_time_extension_idx] = MP_ROM_INT(cal_time_extension);
+        p_items[__arg_cal_auto_idx] = MP_ROM_INT(cal_auto);
+        p_items[__arg_cal_auto_target_idx] = MP_ROM_INT(cal_auto_target);
 
         return MP_OBJ_FROM_PTR(&lw_rxwin_cal_params_dict_obj);
     }
@@ -704,6 +741,8 @@ __mp_mod_fun_kw(lora, rxwin_calibrate, 0)(
         int, cal_time_shift);
     __ioctl_set_if_neq(__LORA_WAN_PARAM_CAL_RXWIN_EXTENSION,
         int,cal_time_extension);
+    __ioctl_set_if_neq(__LORA_WAN_PARAM_CAL_AUTO_TARGET, int, cal_auto_target);
+    __ioctl_set_if_neq(__LORA_WAN_PARAM_CAL_AUTO, bool, cal_auto);
 
     return mp_const_none;
 
@@ -716,11 +755,15 @@ __mp_mod_fun_kw(lora, rxwin_calibrate, 0)(
     #undef __arg_cal_enable_idx
     #undef __arg_cal_time_shift_idx
     #undef __arg_cal_time_extension_idx
+    #undef __arg_cal_auto_idx
+    #undef __arg_cal_auto_target_idx
 
     #undef __arg_sys_rx_err_type
     #undef __arg_cal_enable_type
     #undef __arg_cal_time_shift_type
     #undef __arg_cal_time_extension_type
+    #undef __arg_cal_auto_type
+    #undef __arg_cal_auto_target_type
 }
 
 __mp_mod_fun_0(lora, rxwin_toggle_verbosity)(void) {
@@ -745,6 +788,707 @@ __mp_mod_fun_0( lora, recv_cont_stop )(void)
     return mp_const_none;
 }
 
+__mp_mod_fun_kw(lora, recv_ring, 0)(
+    size_t n_args, const mp_obj_t *pos_args, mp_map_t* kw_args)
+{
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_enable, MP_ARG_KW_ONLY | MP_ARG_BOOL, {.u_bool = true}},
+        { MP_QSTR_batch,  MP_ARG_KW_ONLY | MP_ARG_INT,  {.u_int = 0}},
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args),
+        allowed_args, args);
+    #define __arg_enable_bool   args[0].u_bool
+    #define __arg_batch_int     args[1].u_int
+
+    if(__arg_batch_int < 0 || __arg_batch_int > 0xFF) {
+        mp_raise_ValueError(MP_ERROR_TEXT("invalid batch size"));
+    }
+
+    lora_raw_rx_ring_cfg_t cfg = {
+        .enable = __arg_enable_bool,
+        .batch = __arg_batch_int
+    };
+    lora_ioctl(__LORA_IOCTL_RX_RING_SET, &cfg);
+
+    return mp_const_none;
+
+    #undef __arg_enable_bool
+    #undef __arg_batch_int
+}
+
+__mp_mod_fun_0( lora, recv_ring_read )(void)
+{
+    static lora_raw_rx_ring_frame_t frame;
+
+    if( lora_ioctl(__LORA_IOCTL_RX_RING_READ, &frame) != __LORA_OK )
+        return mp_const_none;
+
+    mp_obj_t dict_obj = mp_obj_new_dict(5);
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_data),
+        mp_obj_new_bytearray(frame.len, frame.buf));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_RSSI),
+        MP_OBJ_NEW_SMALL_INT(frame.rssi));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_SNR),
+        MP_OBJ_NEW_SMALL_INT(frame.snr));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_timestamp),
+        mp_obj_new_int_from_uint(frame.timestamp));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_overruns),
+        mp_obj_new_int_from_uint(frame.overruns));
+    return dict_obj;
+}
+
+__mp_mod_fun_0( lora, recv_ring_status )(void)
+{
+    lora_raw_rx_ring_status_t status;
+    lora_ioctl(__LORA_IOCTL_RX_RING_STATUS, &status);
+
+    mp_obj_t dict_obj = mp_obj_new_dict(6);
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_enabled),
+        status.enabled ? mp_const_true : mp_const_false);
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_batch),
+        MP_OBJ_NEW_SMALL_INT(status.batch));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_count),
+        MP_OBJ_NEW_SMALL_INT(status.count));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_slots),
+        MP_OBJ_NEW_SMALL_INT(status.slots));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_stored),
+        mp_obj_new_int_from_uint(status.stored));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_overruns),
+        mp_obj_new_int_from_uint(status.overruns));
+    return dict_obj;
+}
+
+__mp_mod_fun_kw(lora, cad_scan, 1)(
+    size_t n_args, const mp_obj_t *pos_args, mp_map_t* kw_args)
+{
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_freqs,  MP_ARG_REQUIRED | MP_ARG_OBJ, {.u_obj = MP_OBJ_NULL}},
+        { MP_QSTR_rounds, MP_ARG_KW_ONLY | MP_ARG_INT,  {.u_int = 1}},
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args),
+        allowed_args, args);
+    #define __arg_freqs_obj     args[0].u_obj
+    #define __arg_rounds_int    args[1].u_int
+
+    size_t count;
+    mp_obj_t* items;
+    mp_obj_get_array(__arg_freqs_obj, &count, &items);
+
+    if(count == 0 || count > __LORA_RAW_CAD_SCAN_MAX_CHANNELS) {
+        mp_raise_TypeError(MP_ERROR_TEXT("invalid channels count"));
+    }
+    if(__arg_rounds_int < 1 || __arg_rounds_int > 0xFF) {
+        mp_raise_TypeError(MP_ERROR_TEXT("invalid rounds count"));
+    }
+
+    uint32_t freqs[__LORA_RAW_CAD_SCAN_MAX_CHANNELS];
+    uint8_t  busy[__LORA_RAW_CAD_SCAN_MAX_CHANNELS];
+    for(size_t i = 0; i < count; ++i)
+        freqs[i] = mp_obj_get_int(items[i]);
+
+    lora_raw_cad_scan_t scan = {
+        .freqs = freqs,
+        .busy = busy,
+        .count = count,
+        .rounds = __arg_rounds_int
+    };
+
+    /* it blocks until all the channels are scanned */
+    MP_THREAD_GIL_EXIT();
+    int ret = lora_ioctl(__LORA_IOCTL_CAD_SCAN, &scan);
+    MP_THREAD_GIL_ENTER();
+
+    if( ret != __LORA_OK )
+        return mp_const_none;
+
+    /* the occupancy of every channel, the ratio of the busy cad results */
+    mp_obj_t list_obj = mp_obj_new_list(count, NULL);
+    for(size_t i = 0; i < count; ++i)
+        mp_obj_list_store(list_obj, MP_OBJ_NEW_SMALL_INT(i),
+            mp_obj_new_float((float)busy[i] / scan.rounds));
+    return list_obj;
+
+    #undef __arg_freqs_obj
+    #undef __arg_rounds_int
+}
+
+__mp_mod_fun_0( lora, lbt_stats )(void)
+{
+    lora_raw_lbt_stats_t stats;
+    lora_ioctl(__LORA_IOCTL_LBT_STATS, &stats);
+
+    mp_obj_t dict_obj = mp_obj_new_dict(6);
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_packets),
+        mp_obj_new_int_from_uint(stats.packets));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_failed),
+        mp_obj_new_int_from_uint(stats.failed));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_cad_count),
+        mp_obj_new_int_from_uint(stats.cad_count));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_busy_count),
+        mp_obj_new_int_from_uint(stats.busy_count));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_last_attempts),
+        MP_OBJ_NEW_SMALL_INT(stats.last_attempts));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_max_attempts),
+        MP_OBJ_NEW_SMALL_INT(stats.max_attempts));
+    return dict_obj;
+}
+
+/**
+ * the reliable transfer object is either a buffer (bytes for the sender or a
+ * pre-sized bytearray for the receiver) or a stream object with seek() and
+ * readinto()/write() methods such as an opened file. The stream methods are
+ * called from the xfer context while the GIL is released, hence the GIL is
+ * re-acquired around each call.
+ */
+typedef struct {
+    mp_obj_t            obj;
+    mp_buffer_info_t    bufinfo;
+    bool                is_buffer;
+    bool                is_send;
+} mpy_lora_xfer_ctx_t;
+
+static bool mpy_lora_xfer_io(void* ctx, uint32_t offset,
+    uint8_t* buf, uint8_t len)
+{
+    mpy_lora_xfer_ctx_t* p_ctx = ctx;
+    bool ret = false;
+
+    if( p_ctx->is_buffer )
+    {
+        if( offset + len > p_ctx->bufinfo.len )
+            return false;
+        if( p_ctx->is_send )
+            memcpy(buf, (uint8_t*)p_ctx->bufinfo.buf + offset, len);
+        else
+            memcpy((uint8_t*)p_ctx->bufinfo.buf + offset, buf, len);
+        return true;
+    }
+
+    MP_THREAD_GIL_ENTER();
+    nlr_buf_t nlr;
+    if( nlr_push(&nlr) == 0 )
+    {
+        mp_obj_t dest[3];
+        mp_load_method(p_ctx->obj, MP_QSTR_seek, dest);
+        dest[2] = mp_obj_new_int_from_uint(offset);
+        mp_call_method_n_kw(1, 0, dest);
+
+        mp_obj_t data = p_ctx->is_send
+            ? mp_obj_new_bytearray_by_ref(len, buf)
+            : mp_obj_new_bytes(buf, len);
+        mp_load_method(p_ctx->obj,
+            p_ctx->is_send ? MP_QSTR_readinto : MP_QSTR_write, dest);
+        dest[2] = data;
+        mp_obj_t res = mp_call_method_n_kw(1, 0, dest);
+        ret = res != mp_const_none && mp_obj_get_int(res) == len;
+        nlr_pop();
+    }
+    MP_THREAD_GIL_EXIT();
+
+    return ret;
+}
+
+static void mpy_lora_xfer_ctx_init(mpy_lora_xfer_ctx_t* p_ctx, mp_obj_t obj,
+    bool is_send)
+{
+    p_ctx->obj = obj;
+    p_ctx->is_send = is_send;
+    p_ctx->is_buffer = mp_get_buffer(obj, &p_ctx->bufinfo,
+        is_send ? MP_BUFFER_READ : MP_BUFFER_WRITE);
+}
+
+static mp_obj_t mpy_lora_xfer_stats_dict(lora_raw_xfer_t* p_xfer)
+{
+    lora_raw_xfer_stats_t* p_stats = &p_xfer->stats;
+
+    mp_obj_t dict_obj = mp_obj_new_dict(10);
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_size),
+        mp_obj_new_int_from_uint(p_xfer->size));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_duration),
+        mp_obj_new_int_from_uint(p_stats->duration));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_goodput),
+        mp_obj_new_int_from_uint(p_stats->goodput));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_data_frames),
+        mp_obj_new_int_from_uint(p_stats->data_frames));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_retransmissions),
+        mp_obj_new_int_from_uint(p_stats->retransmissions));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_parity_frames),
+        mp_obj_new_int_from_uint(p_stats->parity_frames));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_recovered),
+        mp_obj_new_int_from_uint(p_stats->recovered));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_acks),
+        mp_obj_new_int_from_uint(p_stats->acks));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_polls),
+        mp_obj_new_int_from_uint(p_stats->polls));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_chunk),
+        MP_OBJ_NEW_SMALL_INT(p_stats->chunk));
+    return dict_obj;
+}
+
+__mp_mod_fun_kw(lora, transfer_send, 1)(
+    size_t n_args, const mp_obj_t *pos_args, mp_map_t* kw_args)
+{
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_obj,     MP_ARG_REQUIRED | MP_ARG_OBJ, {.u_obj = MP_OBJ_NULL}},
+        { MP_QSTR_window,  MP_ARG_KW_ONLY | MP_ARG_INT,  {.u_int = 32}},
+        { MP_QSTR_fec,     MP_ARG_KW_ONLY | MP_ARG_INT,  {.u_int = 0}},
+        { MP_QSTR_timeout, MP_ARG_KW_ONLY | MP_ARG_INT,  {.u_int = 3000}},
+        { MP_QSTR_retries, MP_ARG_KW_ONLY | MP_ARG_INT,  {.u_int = 5}},
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args),
+        allowed_args, args);
+    #define __arg_obj           args[0].u_obj
+    #define __arg_window_int    args[1].u_int
+    #define __arg_fec_int       args[2].u_int
+    #define __arg_timeout_int   args[3].u_int
+    #define __arg_retries_int   args[4].u_int
+
+    if(__arg_window_int < 1 || __arg_window_int > __LORA_RAW_XFER_MAX_WINDOW) {
+        mp_raise_TypeError(MP_ERROR_TEXT("invalid window size"));
+    }
+    if(__arg_fec_int < 0 || __arg_fec_int > __arg_window_int) {
+        mp_raise_TypeError(MP_ERROR_TEXT("invalid fec group size"));
+    }
+    if(__arg_timeout_int < 1 || __arg_retries_int < 1 ||
+        __arg_retries_int > 0xFF) {
+        mp_raise_TypeError(MP_ERROR_TEXT("invalid timeout or retries"));
+    }
+
+    mpy_lora_xfer_ctx_t ctx;
+    mpy_lora_xfer_ctx_init(&ctx, __arg_obj, true);
+
+    lora_raw_xfer_t xfer = {
+        .io = mpy_lora_xfer_io,
+        .ctx = &ctx,
+        .window = __arg_window_int,
+        .fec = __arg_fec_int,
+        .retries = __arg_retries_int,
+        .timeout = __arg_timeout_int
+    };
+
+    if( ctx.is_buffer ) {
+        xfer.size = ctx.bufinfo.len;
+    } else {
+        /* the stream size is its end position */
+        mp_obj_t dest[4];
+        mp_load_method(__arg_obj, MP_QSTR_seek, dest);
+        dest[2] = MP_OBJ_NEW_SMALL_INT(0);
+        dest[3] = MP_OBJ_NEW_SMALL_INT(2);
+        xfer.size = mp_obj_get_int(mp_call_method_n_kw(2, 0, dest));
+    }
+
+    /* it blocks until the whole object is acknowledged */
+    MP_THREAD_GIL_EXIT();
+    int ret = lora_ioctl(__LORA_IOCTL_XFER_SEND, &xfer);
+    MP_THREAD_GIL_ENTER();
+
+    if( ret != __LORA_OK )
+        return mp_const_none;
+
+    return mpy_lora_xfer_stats_dict(&xfer);
+
+    #undef __arg_obj
+    #undef __arg_window_int
+    #undef __arg_fec_int
+    #undef __arg_timeout_int
+    #undef __arg_retries_int
+}
+
+__mp_mod_fun_kw(lora, transfer_recv, 1)(
+    size_t n_args, const mp_obj_t *pos_args, mp_map_t* kw_args)
+{
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_obj,     MP_ARG_REQUIRED | MP_ARG_OBJ, {.u_obj = MP_OBJ_NULL}},
+        { MP_QSTR_timeout, MP_ARG_KW_ONLY | MP_ARG_INT,  {.u_int = 10000}},
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args),
+        allowed_args, args);
+    #define __arg_obj           args[0].u_obj
+    #define __arg_timeout_int   args[1].u_int
+
+    if(__arg_timeout_int < 1) {
+        mp_raise_TypeError(MP_ERROR_TEXT("invalid timeout"));
+    }
+
+    mpy_lora_xfer_ctx_t ctx;
+    mpy_lora_xfer_ctx_init(&ctx, __arg_obj, false);
+
+    lora_raw_xfer_t xfer = {
+        .io = mpy_lora_xfer_io,
+        .ctx = &ctx,
+        .timeout = __arg_timeout_int
+    };
+
+    /* it blocks until the object is received or the link goes idle */
+    MP_THREAD_GIL_EXIT();
+    int ret = lora_ioctl(__LORA_IOCTL_XFER_RECV, &xfer);
+    MP_THREAD_GIL_ENTER();
+
+    if( ret != __LORA_OK )
+        return mp_const_none;
+
+    return mpy_lora_xfer_stats_dict(&xfer);
+
+    #undef __arg_obj
+    #undef __arg_timeout_int
+}
+
+__mp_mod_fun_kw(lora, airtime, 0)(
+    size_t n_args, const mp_obj_t *pos_args, mp_map_t* kw_args)
+{
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_len,    MP_ARG_KW_ONLY | MP_ARG_INT,  {.u_int = 0}},
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args),
+        allowed_args, args);
+    #define __arg_len_int       args[0].u_int
+
+    if(__arg_len_int < 0 || __arg_len_int > 0xFF) {
+        mp_raise_TypeError(MP_ERROR_TEXT("invalid message length"));
+    }
+
+    lora_raw_airtime_status_t status = { .len = __arg_len_int };
+    lora_ioctl(__LORA_IOCTL_AIRTIME_STATUS, &status);
+
+    mp_obj_t dict_obj = mp_obj_new_dict(12);
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_toa),
+        mp_obj_new_int_from_uint(status.toa));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_wait),
+        status.wait == UINT32_MAX ? mp_const_none :
+        mp_obj_new_int_from_uint(status.wait));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_remaining),
+        mp_obj_new_int_from_uint(status.remaining));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_used),
+        mp_obj_new_int_from_uint(status.used));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_limit),
+        mp_obj_new_int_from_uint(status.limit));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_duty),
+        mp_obj_new_float(status.duty / 100.0f));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_band),
+        mp_obj_new_tuple(2, (mp_obj_t[]){
+            mp_obj_new_int_from_uint(status.band_low),
+            mp_obj_new_int_from_uint(status.band_high)}));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_total),
+        mp_obj_new_int_from_uint(status.total));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_frames),
+        mp_obj_new_int_from_uint(status.frames));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_exceeded),
+        mp_obj_new_int_from_uint(status.exceeded));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_rejected),
+        mp_obj_new_int_from_uint(status.rejected));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_queued),
+        mp_obj_new_int_from_uint(status.queued));
+    return dict_obj;
+
+    #undef __arg_len_int
+}
+
+__mp_mod_fun_kw(lora, adapt_config, 0)(
+    size_t n_args, const mp_obj_t *pos_args, mp_map_t* kw_args)
+{
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_addr,     MP_ARG_KW_ONLY | MP_ARG_INT,  {.u_int = 1}},
+        { MP_QSTR_margin,   MP_ARG_KW_ONLY | MP_ARG_INT,  {.u_int = 5}},
+        { MP_QSTR_max_bw,   MP_ARG_KW_ONLY | MP_ARG_INT,
+                                            {.u_int = __LORA_BW_250_KHZ}},
+        { MP_QSTR_max_power_cut, MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = 10}},
+        { MP_QSTR_retries,  MP_ARG_KW_ONLY | MP_ARG_INT,  {.u_int = 3}},
+        { MP_QSTR_timeout,  MP_ARG_KW_ONLY | MP_ARG_INT,  {.u_int = 0}},
+        { MP_QSTR_idle,     MP_ARG_KW_ONLY | MP_ARG_INT,  {.u_int = 10000}},
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args),
+        allowed_args, args);
+    #define __arg_addr_int      args[0].u_int
+    #define __arg_margin_int    args[1].u_int
+    #define __arg_max_bw_int    args[2].u_int
+    #define __arg_power_cut_int args[3].u_int
+    #define __arg_retries_int   args[4].u_int
+    #define __arg_timeout_int   args[5].u_int
+    #define __arg_idle_int      args[6].u_int
+
+    if(__arg_addr_int < 0 || __arg_addr_int > 0xFF) {
+        mp_raise_TypeError(MP_ERROR_TEXT("invalid address"));
+    }
+    if(__arg_margin_int < 0 || __arg_margin_int > 30 ||
+       __arg_power_cut_int < 0 || __arg_power_cut_int > 30) {
+        mp_raise_TypeError(MP_ERROR_TEXT("invalid margin or power cut"));
+    }
+    if(__arg_max_bw_int < __LORA_BW_125_KHZ ||
+       __arg_max_bw_int > __LORA_BW_500_KHZ) {
+        mp_raise_TypeError(MP_ERROR_TEXT("invalid bandwidth"));
+    }
+    if(__arg_retries_int < 1 || __arg_retries_int > 0xFF ||
+       __arg_timeout_int < 0 || __arg_idle_int < 1) {
+        mp_raise_TypeError(MP_ERROR_TEXT("invalid retries or timeouts"));
+    }
+
+    lora_raw_adapt_cfg_t cfg = {
+        .addr = __arg_addr_int,
+        .margin = __arg_margin_int,
+        .max_bw = __arg_max_bw_int,
+        .max_power_cut = __arg_power_cut_int,
+        .retries = __arg_retries_int,
+        .timeout = __arg_timeout_int,
+        .idle = __arg_idle_int
+    };
+    lora_ioctl(__LORA_IOCTL_ADAPT_CONFIG, &cfg);
+
+    return mp_const_none;
+
+    #undef __arg_addr_int
+    #undef __arg_margin_int
+    #undef __arg_max_bw_int
+    #undef __arg_power_cut_int
+    #undef __arg_retries_int
+    #undef __arg_timeout_int
+    #undef __arg_idle_int
+}
+
+__mp_mod_fun_kw(lora, adapt_send, 2)(
+    size_t n_args, const mp_obj_t *pos_args, mp_map_t* kw_args)
+{
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_peer,     MP_ARG_REQUIRED | MP_ARG_INT, {.u_int = 0}},
+        { MP_QSTR_buf,      MP_ARG_REQUIRED | MP_ARG_OBJ, {.u_obj = MP_OBJ_NULL}},
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args),
+        allowed_args, args);
+    #define __arg_peer_int      args[0].u_int
+    #define __arg_buf_obj       args[1].u_obj
+
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(__arg_buf_obj, &bufinfo, MP_BUFFER_READ);
+
+    if(__arg_peer_int < 0 || __arg_peer_int > 0xFF) {
+        mp_raise_TypeError(MP_ERROR_TEXT("invalid peer address"));
+    }
+    if(bufinfo.len == 0 || bufinfo.len > 0xFF) {
+        mp_raise_TypeError(MP_ERROR_TEXT("invalid message length"));
+    }
+
+    lora_raw_adapt_msg_t msg = {
+        .peer = __arg_peer_int,
+        .buf = bufinfo.buf,
+        .len = bufinfo.len
+    };
+
+    /* it blocks until the message is acknowledged or the retries are over */
+    MP_THREAD_GIL_EXIT();
+    int ret = lora_ioctl(__LORA_IOCTL_ADAPT_SEND, &msg);
+    MP_THREAD_GIL_ENTER();
+
+    return ret == __LORA_OK ? mp_const_true : mp_const_false;
+
+    #undef __arg_peer_int
+    #undef __arg_buf_obj
+}
+
+__mp_mod_fun_kw(lora, adapt_recv, 0)(
+    size_t n_args, const mp_obj_t *pos_args, mp_map_t* kw_args)
+{
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_timeout,  MP_ARG_KW_ONLY | MP_ARG_INT,  {.u_int = 10000}},
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args),
+        allowed_args, args);
+    #define __arg_timeout_int   args[0].u_int
+
+    static uint8_t buf[255];
+
+    if(__arg_timeout_int < 1) {
+        mp_raise_TypeError(MP_ERROR_TEXT("invalid timeout"));
+    }
+
+    lora_raw_adapt_msg_t msg = {
+        .buf = buf,
+        .len = sizeof(buf),
+        .timeout = __arg_timeout_int
+    };
+
+    /* it blocks until a message is received or the timeout is over */
+    MP_THREAD_GIL_EXIT();
+    int ret = lora_ioctl(__LORA_IOCTL_ADAPT_RECV, &msg);
+    MP_THREAD_GIL_ENTER();
+
+    if( ret != __LORA_OK )
+        return mp_const_none;
+
+    mp_obj_t dict_obj = mp_obj_new_dict(4);
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_peer),
+        MP_OBJ_NEW_SMALL_INT(msg.peer));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_data),
+        mp_obj_new_bytearray(msg.len, buf));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_RSSI),
+        MP_OBJ_NEW_SMALL_INT(msg.rssi));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_SNR),
+        MP_OBJ_NEW_SMALL_INT(msg.snr));
+    return dict_obj;
+
+    #undef __arg_timeout_int
+}
+
+__mp_mod_fun_1(lora, adapt_status)(mp_obj_t obj)
+{
+    lora_raw_adapt_status_t status = { .peer = mp_obj_get_int(obj) };
+    lora_ioctl(__LORA_IOCTL_ADAPT_STATUS, &status);
+
+    if( ! status.known )
+        return mp_const_none;
+
+    mp_obj_t dict_obj = mp_obj_new_dict(22);
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_steps),
+        MP_OBJ_NEW_SMALL_INT(status.steps));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_tx_step),
+        MP_OBJ_NEW_SMALL_INT(status.tx_step));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_tx_sf),
+        MP_OBJ_NEW_SMALL_INT(status.tx_sf));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_tx_bw),
+        MP_OBJ_NEW_SMALL_INT(status.tx_bw));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_tx_power_cut),
+        MP_OBJ_NEW_SMALL_INT(status.tx_power_cut));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_rx_step),
+        MP_OBJ_NEW_SMALL_INT(status.rx_step));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_rx_sf),
+        MP_OBJ_NEW_SMALL_INT(status.rx_sf));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_rx_bw),
+        MP_OBJ_NEW_SMALL_INT(status.rx_bw));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_rx_power_cut),
+        MP_OBJ_NEW_SMALL_INT(status.rx_power_cut));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_tx_snr),
+        MP_OBJ_NEW_SMALL_INT(status.tx_snr));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_tx_rssi),
+        MP_OBJ_NEW_SMALL_INT(status.tx_rssi));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_rx_snr),
+        MP_OBJ_NEW_SMALL_INT(status.rx_snr));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_rx_rssi),
+        MP_OBJ_NEW_SMALL_INT(status.rx_rssi));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_snr_min),
+        MP_OBJ_NEW_SMALL_INT(status.snr_min));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_sent),
+        mp_obj_new_int_from_uint(status.sent));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_acked),
+        mp_obj_new_int_from_uint(status.acked));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_retries),
+        mp_obj_new_int_from_uint(status.retries));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_received),
+        mp_obj_new_int_from_uint(status.received));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_duplicates),
+        mp_obj_new_int_from_uint(status.duplicates));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_ups),
+        mp_obj_new_int_from_uint(status.ups));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_downs),
+        mp_obj_new_int_from_uint(status.downs));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_fallbacks),
+        mp_obj_new_int_from_uint(status.fallbacks));
+    return dict_obj;
+}
+
+__mp_mod_fun_kw(lora, hop, 0)(
+    size_t n_args, const mp_obj_t *pos_args, mp_map_t* kw_args)
+{
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_enable,   MP_ARG_BOOL,                  {.u_bool = true}},
+        { MP_QSTR_freqs,    MP_ARG_KW_ONLY | MP_ARG_OBJ,  {.u_obj = mp_const_none}},
+        { MP_QSTR_seed,     MP_ARG_KW_ONLY | MP_ARG_INT,  {.u_int = 0}},
+        { MP_QSTR_dwell,    MP_ARG_KW_ONLY | MP_ARG_INT,  {.u_int = 0}},
+        { MP_QSTR_sync_timeout, MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = 60000}},
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args),
+        allowed_args, args);
+    #define __arg_enable_bool   args[0].u_bool
+    #define __arg_freqs_obj     args[1].u_obj
+    #define __arg_seed_int      args[2].u_int
+    #define __arg_dwell_int     args[3].u_int
+    #define __arg_sync_int      args[4].u_int
+
+    lora_raw_hop_cfg_t cfg = {
+        .enable = __arg_enable_bool,
+        .count = 0,
+        .seed = __arg_seed_int,
+        .dwell = __arg_dwell_int,
+        .sync_timeout = __arg_sync_int
+    };
+
+    if(__arg_seed_int < 0 || __arg_seed_int > 0xFFFF) {
+        mp_raise_TypeError(MP_ERROR_TEXT("invalid seed"));
+    }
+    if(__arg_dwell_int < 0 || __arg_sync_int < 1) {
+        mp_raise_TypeError(MP_ERROR_TEXT("invalid dwell or sync timeout"));
+    }
+
+    /* without channels, the region default channel plan is used */
+    if(__arg_freqs_obj != mp_const_none) {
+        size_t count;
+        mp_obj_t* items;
+        mp_obj_get_array(__arg_freqs_obj, &count, &items);
+        if(count < 2 || count > __LORA_RAW_HOP_MAX_CHANNELS) {
+            mp_raise_TypeError(MP_ERROR_TEXT("invalid channels count"));
+        }
+        for(size_t i = 0; i < count; ++i)
+            cfg.freqs[i] = mp_obj_get_int(items[i]);
+        cfg.count = count;
+    }
+
+    if( lora_ioctl(__LORA_IOCTL_HOP_CONFIG, &cfg) != __LORA_OK ) {
+        mp_raise_TypeError(MP_ERROR_TEXT("invalid hopping channels"));
+    }
+
+    if( ! cfg.enable )
+        return mp_const_none;
+
+    mp_obj_t list_obj = mp_obj_new_list(cfg.count, NULL);
+    for(size_t i = 0; i < cfg.count; ++i)
+        mp_obj_list_store(list_obj, MP_OBJ_NEW_SMALL_INT(i),
+            mp_obj_new_int_from_uint(cfg.freqs[i]));
+    return list_obj;
+
+    #undef __arg_enable_bool
+    #undef __arg_freqs_obj
+    #undef __arg_seed_int
+    #undef __arg_dwell_int
+    #undef __arg_sync_int
+}
+
+__mp_mod_fun_0(lora, hop_status)(void)
+{
+    lora_raw_hop_status_t status;
+    lora_ioctl(__LORA_IOCTL_HOP_STATUS, &status);
+
+    mp_obj_t dict_obj = mp_obj_new_dict(12);
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_enabled),
+        status.enabled ? mp_const_true : mp_const_false);
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_synced),
+        status.synced ? mp_const_true : mp_const_false);
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_channel),
+        MP_OBJ_NEW_SMALL_INT(status.channel));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_freq),
+        mp_obj_new_int_from_uint(status.freq));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_dwell),
+        mp_obj_new_int_from_uint(status.dwell));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_tx_frames),
+        mp_obj_new_int_from_uint(status.tx_frames));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_rx_frames),
+        mp_obj_new_int_from_uint(status.rx_frames));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_tx_delays),
+        mp_obj_new_int_from_uint(status.tx_delays));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_hops),
+        mp_obj_new_int_from_uint(status.hops));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_syncs),
+        mp_obj_new_int_from_uint(status.syncs));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_adjusts),
+        mp_obj_new_int_from_uint(status.adjusts));
+    return dict_obj;
+}
+
 __mp_mod_fun_kw(lora, radio_params, 0)(
     size_t n_args, const mp_obj_t *pos_args, mp_map_t* kw_args)
 {
@@ -779,6 +1523,10 @@ __mp_mod_fun_kw(lora, radio_params, 0)(
     #define __idx_tx_timeout    14
     #define __idx_rx_timeout    15
     #define __idx_payload       16
+    #define __idx_lbt           17
+    #define __idx_lbt_attempts  18
+    #define __idx_lbt_backoff   19
+    #define __idx_duty_policy   20
 
     static mp_arg_t allowed[] = {
         #define __init(_idx, _kw, _type)    \
@@ -800,6 +1548,10 @@ __mp_mod_fun_kw(lora, radio_params, 0)(
             __init(__idx_tx_timeout,    tx_timeout,     INT  ),
             __init(__idx_rx_timeout,    rx_timeout,     INT  ),
             __init(__idx_payload,       payload,        INT  ),
+            __init(__idx_lbt,           lbt,            BOOL ),
+            __init(__idx_lbt_attempts,  lbt_attempts,   INT  ),
+            __init(__idx_lbt_backoff,   lbt_backoff,    INT  ),
+            __init(__idx_duty_policy,   duty_policy,    INT  ),
         #undef __init
     };
 
@@ -822,6 +1574,10 @@ __mp_mod_fun_kw(lora, radio_params, 0)(
     #define __def_tx_timeout_int    allowed[__idx_tx_timeout  ].defval.u_int
     #define __def_rx_timeout_int    allowed[__idx_rx_timeout  ].defval.u_int
     #define __def_payload_int       allowed[__idx_payload     ].defval.u_int
+    #define __def_lbt_bool          allowed[__idx_lbt         ].defval.u_bool
+    #define __def_lbt_attempts_int  allowed[__idx_lbt_attempts].defval.u_int
+    #define __def_lbt_backoff_int   allowed[__idx_lbt_backoff ].defval.u_int
+    #define __def_duty_policy_int   allowed[__idx_duty_policy ].defval.u_int
 
     mp_arg_val_t args[MP_ARRAY_SIZE(allowed)];
     #define __arg_reset_all_bool    args[__idx_reset_all   ].u_bool
@@ -841,6 +1597,10 @@ __mp_mod_fun_kw(lora, radio_params, 0)(
     #define __arg_tx_timeout_int    args[__idx_tx_timeout  ].u_int
     #define __arg_rx_timeout_int    args[__idx_rx_timeout  ].u_int
     #define __arg_payload_int       args[__idx_payload     ].u_int
+    #define __arg_lbt_bool          args[__idx_lbt         ].u_bool
+    #define __arg_lbt_attempts_int  args[__idx_lbt_attempts].u_int
+    #define __arg_lbt_backoff_int   args[__idx_lbt_backoff ].u_int
+    #define __arg_duty_policy_int   args[__idx_duty_policy ].u_int
 
 
     // -- parse the argument for the first time to pick-up the new region if any
@@ -883,6 +1643,10 @@ __mp_mod_fun_kw(lora, radio_params, 0)(
     __load_default_value(tx_timeout,    TX_TIMEOUT,     int   );
     __load_default_value(rx_timeout,    RX_TIMEOUT,     int   );
     __load_default_value(payload,       PAYLOAD,        int   );
+    __load_default_value(lbt,           LBT,            bool  );
+    __load_default_value(lbt_attempts,  LBT_ATTEMPTS,   int   );
+    __load_default_value(lbt_backoff,   LBT_BACKOFF,    int   );
+    __load_default_value(duty_policy,   DUTY_POLICY,    int   );
 
     // -- second time argument parsing
     mp_arg_parse_all(n_args, pos_args, kw_args,
@@ -969,6 +1733,10 @@ __mp_mod_fun_kw(lora, radio_params, 0)(
     __verify_param(tx_timeout,   TX_TIMEOUT,    int);
     __verify_param(rx_timeout,   RX_TIMEOUT,    int);
     __verify_param(payload,      PAYLOAD,       int);
+    __verify_param(lbt,          LBT,           bool);
+    __verify_param(lbt_attempts, LBT_ATTEMPTS,  int);
+    __verify_param(lbt_backoff,  LBT_BACKOFF,   int);
+    __verify_param(duty_policy,  DUTY_POLICY,   int);
 
     if( ! verified )
     {
@@ -1009,6 +1777,10 @@ __mp_mod_fun_kw(lora, radio_params, 0)(
     __update_param(tx_timeout,   TX_TIMEOUT,    int);
     __update_param(rx_timeout,   RX_TIMEOUT,    int);
     __update_param(payload,      PAYLOAD,       int);
+    __update_param(lbt,          LBT,           bool);
+    __update_param(lbt_attempts, LBT_ATTEMPTS,  int);
+    __update_param(lbt_backoff,  LBT_BACKOFF,   int);
+    __update_param(duty_policy,  DUTY_POLICY,   int);
 
     if(change_detected)
     {
@@ -1032,6 +1804,10 @@ __mp_mod_fun_kw(lora, radio_params, 0)(
     #undef __idx_tx_timeout
     #undef __idx_rx_timeout
     #undef __idx_payload
+    #undef __idx_lbt
+    #undef __idx_lbt_attempts
+    #undef __idx_lbt_backoff
+    #undef __idx_duty_policy
 
     #undef __def_reset_all_bool
     #undef __def_region_int
@@ -1049,6 +1825,10 @@ __mp_mod_fun_kw(lora, radio_params, 0)(
     #undef __def_tx_timeout_int
     #undef __def_rx_timeout_int
     #undef __def_payload_int
+    #undef __def_lbt_bool
+    #undef __def_lbt_attempts_int
+    #undef __def_lbt_backoff_int
+    #undef __def_duty_policy_int
 
     #undef __arg_reset_all_bool
     #undef __arg_region_int
@@ -1067,6 +1847,10 @@ __mp_mod_fun_kw(lora, radio_params, 0)(
     #undef __arg_tx_timeout_int
     #undef __arg_rx_timeout_int
     #undef __arg_payload_int
+    #undef __arg_lbt_bool
+    #undef __arg_lbt_attempts_int
+    #undef __arg_lbt_backoff_int
+    #undef __arg_duty_policy_int
 
     return mp_const_none;
 }
@@ -1109,6 +1893,19 @@ __mp_mod_fun_0(lora, tx_continuous_wave_stop)(void){
     return mp_const_none;
 }
 
+__mp_mod_fun_0(lora, tx_burst_start)(void){
+    lora_ioctl(__LORA_IOCTL_TX_BURST_START, NULL);
+    return mp_const_none;
+}
+
+__mp_mod_fun_0(lora, tx_burst_stop)(void){
+    /* it blocks until all the queued messages are sent */
+    MP_THREAD_GIL_EXIT();
+    lora_ioctl(__LORA_IOCTL_TX_BURST_STOP, NULL);
+    MP_THREAD_GIL_ENTER();
+    return mp_const_none;
+}
+
 __mp_mod_fun_0(lora, raw_state_machine)(void)
 {
     void lora_raw_sm_print(void);
@@ -1184,6 +1981,317 @@ __mp_mod_fun_1(lora, port_close)(mp_obj_t obj)
     return mp_const_none;
 }
 
+__mp_mod_fun_kw(lora, port_aggregation, 1)(
+    size_t n_args, const mp_obj_t *pos_args, mp_map_t* kw_args)
+{
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_port,     MP_ARG_REQUIRED | MP_ARG_INT, {.u_int  = 0}},
+        { MP_QSTR_enable,   MP_ARG_BOOL,                  {.u_bool = true}},
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args),
+        allowed_args, args);
+    #define __arg_port_int      args[0].u_int
+    #define __arg_enable_bool   args[1].u_bool
+
+    lora_wan_port_aggr_t aggr = {
+        .port = __arg_port_int,
+        .enable = __arg_enable_bool
+    };
+    if( lora_ioctl(__LORA_IOCTL_PORT_AGGREGATION, &aggr) != __LORA_OK ) {
+        __log_output("error: port %d is not opened", __arg_port_int);
+    }
+    return mp_const_none;
+
+    #undef __arg_port_int
+    #undef __arg_enable_bool
+}
+
+__mp_mod_fun_kw(lora, port_sched, 1)(
+    size_t n_args, const mp_obj_t *pos_args, mp_map_t* kw_args)
+{
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_port,     MP_ARG_REQUIRED | MP_ARG_INT, {.u_int  = 0}},
+        { MP_QSTR_priority, MP_ARG_KW_ONLY | MP_ARG_INT,  {.u_int  = 0}},
+        { MP_QSTR_weight,   MP_ARG_KW_ONLY | MP_ARG_INT,  {.u_int  = 1}},
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args),
+        allowed_args, args);
+    #define __arg_port_int      args[0].u_int
+    #define __arg_priority_int  args[1].u_int
+    #define __arg_weight_int    args[2].u_int
+
+    if( __arg_priority_int < 0 || __arg_priority_int > 0xFF ||
+        __arg_weight_int < 1 || __arg_weight_int > 0xFF ) {
+        __log_output("error: priority shall be 0..255 and weight 1..255");
+        return mp_const_none;
+    }
+
+    lora_wan_port_sched_t sched = {
+        .port = __arg_port_int,
+        .priority = __arg_priority_int,
+        .weight = __arg_weight_int
+    };
+    if( lora_ioctl(__LORA_IOCTL_PORT_SCHED, &sched) != __LORA_OK ) {
+        __log_output("error: port %d is not opened", __arg_port_int);
+    }
+    return mp_const_none;
+
+    #undef __arg_port_int
+    #undef __arg_priority_int
+    #undef __arg_weight_int
+}
+
+__mp_mod_fun_kw(lora, mcast_setup, 0)(
+    size_t n_args, const mp_obj_t *pos_args, mp_map_t* kw_args)
+{
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_group, MP_ARG_KW_ONLY|MP_ARG_REQUIRED|MP_ARG_INT,
+            {.u_int = 0}},
+        { MP_QSTR_DevAddr, MP_ARG_KW_ONLY|MP_ARG_REQUIRED|MP_ARG_INT,
+            {.u_int = 0}},
+        { MP_QSTR_NwkSKey, MP_ARG_KW_ONLY|MP_ARG_REQUIRED|MP_ARG_OBJ,
+            {.u_obj = mp_const_none}},
+        { MP_QSTR_AppSKey, MP_ARG_KW_ONLY|MP_ARG_REQUIRED|MP_ARG_OBJ,
+            {.u_obj = mp_const_none}},
+        { MP_QSTR_lwclass,  MP_ARG_KW_ONLY|MP_ARG_INT,
+            {.u_int = __LORA_WAN_CLASS_C}},
+        { MP_QSTR_frequency, MP_ARG_KW_ONLY|MP_ARG_REQUIRED|MP_ARG_INT,
+            {.u_int = 0}},
+        { MP_QSTR_DR,       MP_ARG_KW_ONLY|MP_ARG_REQUIRED|MP_ARG_INT,
+            {.u_int = 0}},
+        { MP_QSTR_periodicity, MP_ARG_KW_ONLY|MP_ARG_INT, {.u_int = 0}},
+        { MP_QSTR_fcnt_min, MP_ARG_KW_ONLY|MP_ARG_INT, {.u_int = 0}},
+        { MP_QSTR_fcnt_max, MP_ARG_KW_ONLY|MP_ARG_OBJ,
+            {.u_obj = mp_const_none}},
+        { MP_QSTR_start,    MP_ARG_KW_ONLY|MP_ARG_INT, {.u_int = 0}},
+        { MP_QSTR_duration, MP_ARG_KW_ONLY|MP_ARG_INT, {.u_int = 0}},
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args),
+        allowed_args, args);
+    #define __arg_group_int         args[0].u_int
+    #define __arg_dev_addr_int      args[1].u_int
+    #define __arg_nwk_s_key_obj     args[2].u_obj
+    #define __arg_app_s_key_obj     args[3].u_obj
+    #define __arg_class_int         args[4].u_int
+    #define __arg_frequency_int     args[5].u_int
+    #define __arg_dr_int            args[6].u_int
+    #define __arg_periodicity_int   args[7].u_int
+    #define __arg_fcnt_min_int      args[8].u_int
+    #define __arg_fcnt_max_obj      args[9].u_obj
+    #define __arg_start_int         args[10].u_int
+    #define __arg_duration_int      args[11].u_int
+
+    mp_buffer_info_t nwk_s_key;
+    mp_buffer_info_t app_s_key;
+    mp_get_buffer_raise(__arg_nwk_s_key_obj, &nwk_s_key, MP_BUFFER_READ);
+    mp_get_buffer_raise(__arg_app_s_key_obj, &app_s_key, MP_BUFFER_READ);
+    if( nwk_s_key.len != 16 || app_s_key.len != 16 ) {
+        mp_raise_ValueError(MP_ERROR_TEXT("mcast: keys shall be 16 bytes"));
+    }
+    if( __arg_class_int != __LORA_WAN_CLASS_B &&
+        __arg_class_int != __LORA_WAN_CLASS_C ) {
+        mp_raise_ValueError(MP_ERROR_TEXT("mcast: class shall be B or C"));
+    }
+
+    lora_wan_mcast_setup_t setup = {
+        .group = __arg_group_int,
+        .addr = __arg_dev_addr_int,
+        .nwk_s_key = nwk_s_key.buf,
+        .app_s_key = app_s_key.buf,
+        .f_cnt_min = __arg_fcnt_min_int,
+        .f_cnt_max = __arg_fcnt_max_obj == mp_const_none ? 0xFFFFFFFF :
+            mp_obj_get_int_truncated(__arg_fcnt_max_obj),
+        .class = __arg_class_int,
+        .frequency = __arg_frequency_int,
+        .data_rate = __arg_dr_int,
+        .periodicity = __arg_periodicity_int,
+        .session_start = __arg_start_int,
+        .session_time = __arg_duration_int
+    };
+    if( lora_ioctl(__LORA_IOCTL_MCAST_SETUP, &setup) != __LORA_OK ) {
+        __log_output("error: multicast group %d setup failed",
+            __arg_group_int);
+        return mp_const_false;
+    }
+    return mp_const_true;
+
+    #undef __arg_group_int
+    #undef __arg_dev_addr_int
+    #undef __arg_nwk_s_key_obj
+    #undef __arg_app_s_key_obj
+    #undef __arg_class_int
+    #undef __arg_frequency_int
+    #undef __arg_dr_int
+    #undef __arg_periodicity_int
+    #undef __arg_fcnt_min_int
+    #undef __arg_fcnt_max_obj
+    #undef __arg_start_int
+    #undef __arg_duration_int
+}
+
+__mp_mod_fun_1(lora, mcast_delete)(mp_obj_t obj)
+{
+    uint8_t group = mp_obj_get_int(obj);
+    if( lora_ioctl(__LORA_IOCTL_MCAST_DELETE, &group) != __LORA_OK ) {
+        __log_output("error: multicast group %d is not set up", group);
+    }
+    return mp_const_none;
+}
+
+__mp_mod_fun_1(lora, mcast_status)(mp_obj_t obj)
+{
+    lora_wan_mcast_status_t status = { .group = mp_obj_get_int(obj) };
+    if( lora_ioctl(__LORA_IOCTL_MCAST_STATUS, &status) != __LORA_OK )
+        return mp_const_none;
+
+    mp_obj_t dict_obj = mp_obj_new_dict(12);
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_group),
+        mp_obj_new_int(status.group));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_is_setup),
+        mp_obj_new_bool(status.is_setup));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_is_session),
+        mp_obj_new_bool(status.is_session));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_DevAddr),
+        mp_obj_new_int_from_uint(status.addr));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_lwclass),
+        mp_obj_new_int(status.class));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_frequency),
+        mp_obj_new_int_from_uint(status.frequency));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_DR),
+        mp_obj_new_int(status.data_rate));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_frames),
+        mp_obj_new_int_from_uint(status.rx_frames));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_bytes),
+        mp_obj_new_int_from_uint(status.rx_bytes));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_fcnt),
+        mp_obj_new_int_from_uint(status.last_f_cnt));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_RSSI),
+        mp_obj_new_int(status.last_rssi));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_SNR),
+        mp_obj_new_int(status.last_snr));
+    return dict_obj;
+}
+
+/**
+ * the uplinks link quality statistics with the link records kept in the ring
+ * from the sequence number 'since', the returned 'next' is the 'since' of the
+ * following call, so the records are collected without duplicates
+ */
+__mp_mod_fun_kw(lora, link_stats, 0)(
+    size_t n_args, const mp_obj_t *pos_args, mp_map_t* kw_args)
+{
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_since,    MP_ARG_KW_ONLY | MP_ARG_INT,  {.u_int = 0}},
+        { MP_QSTR_reset,    MP_ARG_KW_ONLY | MP_ARG_BOOL, {.u_bool = false}},
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args),
+        allowed_args, args);
+    #define __arg_since_int     args[0].u_int
+    #define __arg_reset_bool    args[1].u_bool
+
+    static const qstr link_record_fields[] = {
+        MP_QSTR_seq, MP_QSTR_timestamp, MP_QSTR_port, MP_QSTR_DR,
+        MP_QSTR_tx_power, MP_QSTR_retries, MP_QSTR_result, MP_QSTR_fcnt,
+        MP_QSTR_airtime, MP_QSTR_RSSI, MP_QSTR_SNR, MP_QSTR_margin
+    };
+
+    lora_wan_link_stats_t stats = { 0 };
+    lora_ioctl(__LORA_IOCTL_LINK_STATS, &stats);
+
+    mp_obj_t dict_obj = mp_obj_new_dict(10);
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_transactions),
+        mp_obj_new_int_from_uint(stats.transactions));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_failures),
+        mp_obj_new_int_from_uint(stats.failures));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_downlinks),
+        mp_obj_new_int_from_uint(stats.downlinks));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_margin),
+        mp_obj_new_float((float)stats.snr_margin_avg / 16));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_RSSI),
+        mp_obj_new_float((float)stats.rssi_avg / 16));
+
+    /* the packet error rate of every used data-rate */
+    mp_obj_t dr_obj = mp_obj_new_dict(0);
+    for(int i = 0; i < __LORA_WAN_LINK_DR_COUNT; ++i)
+    {
+        lora_wan_link_dr_stats_t* p_dr = &stats.dr[i];
+        if( ! p_dr->transmissions )
+            continue;
+        mp_obj_t item_obj = mp_obj_new_dict(6);
+        mp_obj_dict_store(item_obj, MP_OBJ_NEW_QSTR(MP_QSTR_transactions),
+            mp_obj_new_int_from_uint(p_dr->transactions));
+        mp_obj_dict_store(item_obj, MP_OBJ_NEW_QSTR(MP_QSTR_transmissions),
+            mp_obj_new_int_from_uint(p_dr->transmissions));
+        mp_obj_dict_store(item_obj, MP_OBJ_NEW_QSTR(MP_QSTR_confirmed),
+            mp_obj_new_int_from_uint(p_dr->confirmed));
+        mp_obj_dict_store(item_obj, MP_OBJ_NEW_QSTR(MP_QSTR_acked),
+            mp_obj_new_int_from_uint(p_dr->acked));
+        mp_obj_dict_store(item_obj, MP_OBJ_NEW_QSTR(MP_QSTR_PER),
+            p_dr->confirmed ? mp_obj_new_float(1.0f -
+                (float)p_dr->acked / p_dr->confirmed) : mp_const_none);
+        mp_obj_dict_store(item_obj, MP_OBJ_NEW_QSTR(MP_QSTR_airtime),
+            mp_obj_new_int_from_uint(p_dr->airtime));
+        mp_obj_dict_store(dr_obj, MP_OBJ_NEW_SMALL_INT(i), item_obj);
+    }
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_DR), dr_obj);
+
+    /* the records are read in small chunks to keep the stack usage low */
+    lora_wan_link_record_t records[8];
+    lora_wan_link_read_t read = {
+        .p_records = records,
+        .max = MP_ARRAY_SIZE(records),
+        .since = __arg_since_int
+    };
+    mp_obj_t list_obj = mp_obj_new_list(0, NULL);
+    uint32_t dropped = 0;
+    do {
+        lora_ioctl(__LORA_IOCTL_LINK_READ, &read);
+        dropped += read.dropped;
+        for(int i = 0; i < read.count; ++i)
+        {
+            lora_wan_link_record_t* p_rec = &records[i];
+            mp_obj_t items[] = {
+                mp_obj_new_int_from_uint(p_rec->seq),
+                mp_obj_new_int_from_uint(p_rec->timestamp),
+                MP_OBJ_NEW_SMALL_INT(p_rec->port),
+                MP_OBJ_NEW_SMALL_INT(p_rec->data_rate),
+                MP_OBJ_NEW_SMALL_INT(p_rec->tx_power),
+                MP_OBJ_NEW_SMALL_INT(p_rec->retries),
+                MP_OBJ_NEW_SMALL_INT(p_rec->result),
+                mp_obj_new_int_from_uint(p_rec->ul_counter),
+                mp_obj_new_int_from_uint(p_rec->airtime),
+                p_rec->has_dl ? MP_OBJ_NEW_SMALL_INT(p_rec->dl_rssi)
+                    : mp_const_none,
+                p_rec->has_dl ? MP_OBJ_NEW_SMALL_INT(p_rec->dl_snr)
+                    : mp_const_none,
+                p_rec->has_margin ? MP_OBJ_NEW_SMALL_INT(p_rec->dl_snr_margin)
+                    : mp_const_none,
+            };
+            mp_obj_list_append(list_obj, mp_obj_new_attrtuple(
+                link_record_fields, MP_ARRAY_SIZE(items), items));
+        }
+        read.since = read.next;
+    } while( read.count == read.max );
+
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_records), list_obj);
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_next),
+        mp_obj_new_int_from_uint(read.next));
+    mp_obj_dict_store(dict_obj, MP_OBJ_NEW_QSTR(MP_QSTR_dropped),
+        mp_obj_new_int_from_uint(dropped));
+
+    if( __arg_reset_bool )
+        lora_ioctl(__LORA_IOCTL_LINK_RESET, NULL);
+
+    return dict_obj;
+
+    #undef __arg_since_int
+    #undef __arg_reset_bool
+}
+
 __mp_mod_fun_var_between(lora, list_region_params, 0, 1)(
     size_t __arg_n, const mp_obj_t * __arg_v
 ) {
@@ -1214,6 +2322,64 @@ __mp_mod_fun_0(lora, dr_stats)(void)
     return mp_const_none;
 }
 
+__mp_mod_fun_kw(lora, spi_trace, 0)(
+    size_t n_args, const mp_obj_t *pos_args, mp_map_t* kw_args)
+{
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_enable,   MP_ARG_BOOL,                  {.u_bool = true}},
+        { MP_QSTR_clear,    MP_ARG_KW_ONLY | MP_ARG_BOOL, {.u_bool = true}},
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args),
+        allowed_args, args);
+    #define __arg_enable_bool   args[0].u_bool
+    #define __arg_clear_bool    args[1].u_bool
+
+    lora_spi_trace_cfg_t cfg = {
+        .enable = __arg_enable_bool,
+        .clear = __arg_clear_bool
+    };
+    lora_ioctl(__LORA_IOCTL_SPI_TRACE_SET, &cfg);
+    return mp_const_none;
+
+    #undef __arg_enable_bool
+    #undef __arg_clear_bool
+}
+
+__mp_mod_fun_kw(lora, spi_trace_dump, 0)(
+    size_t n_args, const mp_obj_t *pos_args, mp_map_t* kw_args)
+{
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_decode,   MP_ARG_KW_ONLY | MP_ARG_BOOL, {.u_bool = false}},
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args),
+        allowed_args, args);
+    #define __arg_decode_bool   args[0].u_bool
+
+    if( __arg_decode_bool )
+    {
+        lora_ioctl(__LORA_IOCTL_SPI_TRACE_PRINT, NULL);
+        return mp_const_none;
+    }
+
+    /* the records are moved out of the ring, the bytes object is sized for
+     * the whole ring at once: 8 bytes header and 16 bytes per record */
+    vstr_t vstr;
+    vstr_init_len(&vstr, 8 + 16 * CONFIG_LORA_SPI_TRACE_RECORDS);
+    lora_spi_trace_read_t read = {
+        .buf = (uint8_t*)vstr.buf,
+        .size = vstr.len
+    };
+    lora_ioctl(__LORA_IOCTL_SPI_TRACE_READ, &read);
+    if( read.dropped )
+        __log_output("spi trace: %u records were dropped\n", read.dropped);
+    vstr.len = read.len;
+    return mp_obj_new_bytes_from_vstr(&vstr);
+
+    #undef __arg_decode_bool
+}
+
 __mp_mod_fun_ifdef(lora, certification_mode, CONFIG_LORA_LCT_CONTROL_API)
 __mp_mod_fun_var_between(lora, certification_mode, 0, 1)(
     size_t __arg_n, const mp_obj_t * __arg_v)
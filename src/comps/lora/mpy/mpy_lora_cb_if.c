@@ -53,6 +53,7 @@ __mp_mod_class_const(lora, _event, EVENT_TX_CONFIRM,__MPY_LORA_CB_ON_TX_CONFIRM)
 __mp_mod_class_const(lora, _event, EVENT_RX_DONE,   __MPY_LORA_CB_ON_RX_DONE)
 __mp_mod_class_const(lora, _event, EVENT_RX_TIMEOUT,__MPY_LORA_CB_ON_RX_TIMEOUT)
 __mp_mod_class_const(lora, _event, EVENT_RX_FAIL,   __MPY_LORA_CB_ON_RX_FAIL)
+__mp_mod_class_const(lora, _event, EVENT_RX_BATCH,  __MPY_LORA_CB_ON_RX_BATCH)
 __mp_mod_class_const(lora, _event, EVENT_ANY,       0xFF)
 
 /** -------------------------------------------------------------------------- *
@@ -316,7 +317,7 @@ static mp_obj_t prepare_callback_arg_tuple(
     {
         if( cb_evt == __MPY_LORA_CB_ON_RX_DONE )
         {
-            tuple_obj = mp_obj_new_dict(7);
+            tuple_obj = mp_obj_new_dict(8);
             lora_wan_ind_params_t* ind_info = evt_data;
             mp_obj_dict_store(tuple_obj, MP_OBJ_NEW_QSTR(MP_QSTR_event),
                 MP_OBJ_NEW_SMALL_INT(cb_evt));
@@ -332,6 +333,8 @@ static mp_obj_t prepare_callback_arg_tuple(
                 MP_OBJ_NEW_SMALL_INT(ind_info->rx.data_rate));
             mp_obj_dict_store(tuple_obj, MP_OBJ_NEW_QSTR(MP_QSTR_dl_frame_counter),
                 MP_OBJ_NEW_SMALL_INT(ind_info->rx.dl_frame_counter));
+            mp_obj_dict_store(tuple_obj, MP_OBJ_NEW_QSTR(MP_QSTR_mcast_group),
+                MP_OBJ_NEW_SMALL_INT(ind_info->rx.mcast_group));
         }
         else if (evt_data != NULL)
         {
@@ -361,7 +364,8 @@ static mpy_lora_callback_type_t get_event_callback_type(lora_event_t event)
         { __LORA_EVENT_TX_CONFIRM  ,__MPY_LORA_CB_ON_TX_CONFIRM },
         { __LORA_EVENT_RX_DONE     ,__MPY_LORA_CB_ON_RX_DONE },
         { __LORA_EVENT_RX_TIMEOUT  ,__MPY_LORA_CB_ON_RX_TIMEOUT },
-        { __LORA_EVENT_RX_FAIL     ,__MPY_LORA_CB_ON_RX_FAIL }
+        { __LORA_EVENT_RX_FAIL     ,__MPY_LORA_CB_ON_RX_FAIL },
+        { __LORA_EVENT_RX_BATCH    ,__MPY_LORA_CB_ON_RX_BATCH }
     };
 
     int i;
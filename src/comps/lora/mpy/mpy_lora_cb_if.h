@@ -61,11 +61,12 @@ typedef enum {
     __MPY_LORA_CB_ON_RX_DONE        = (1u << 4),
     __MPY_LORA_CB_ON_RX_TIMEOUT     = (1u << 5),
     __MPY_LORA_CB_ON_RX_FAIL        = (1u << 6),
+    __MPY_LORA_CB_ON_RX_BATCH       = (1u << 7),
 
     __MPY_LORA_CB_ON_ANY            = 0xFFFF
 } mpy_lora_callback_type_t;
 
-#define __mpy_lora_max_callback_events_count    (7)
+#define __mpy_lora_max_callback_events_count    (8)
 
 /** -------------------------------------------------------------------------- *
  * APIs
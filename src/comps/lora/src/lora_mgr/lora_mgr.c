@@ -46,6 +46,8 @@
 #include "lora_wan_port.h"
 #include "lora_port.h"
 #include "stub_system.h"
+#include "sx126x_trace.h"
+#include "state_machine.h"
 
 /** -------------------------------------------------------------------------- *
  * manager nvm data handling
@@ -94,6 +96,7 @@ const char* lora_get_event_str(lora_event_t event)
         case __LORA_EVENT_RX_DONE:      return "RX_DONE";
         case __LORA_EVENT_RX_TIMEOUT:   return "RX_TIMEOUT";
         case __LORA_EVENT_RX_FAIL:      return "RX_FAIL";
+        case __LORA_EVENT_RX_BATCH:     return "RX_BATCH";
         case __LORA_EVENT_INDICATION:   return "INDICATION";
         case __LORA_EVENT_NONE:         return "NONE";
     }
@@ -136,6 +139,10 @@ lora_error_t lora_ctor(void)
     lora_event_handler_init();
     sync_obj_init();
 
+    #ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+    state_machine_prof_set_timestamp_getter(lora_stub_get_timestamp_ms);
+    #endif
+
     lora_mgr_handle_nvm();
 
     __current_mode()->mode_ctor();
@@ -229,6 +236,27 @@ lora_error_t lora_stats(void)
 lora_error_t lora_ioctl(uint32_t ioctl, void* arg)
 {
     __log_info("lora-mgr -> ioctl()");
+
+    /* the radio spi trace is below the modes, it serves all of them */
+    if(ioctl == __LORA_IOCTL_SPI_TRACE_SET)
+    {
+        lora_spi_trace_cfg_t* p_cfg = arg;
+        sx126x_trace_set(p_cfg->enable, p_cfg->clear);
+        return __LORA_OK;
+    }
+    else if(ioctl == __LORA_IOCTL_SPI_TRACE_READ)
+    {
+        lora_spi_trace_read_t* p_read = arg;
+        p_read->len = sx126x_trace_read(p_read->buf, p_read->size,
+            &p_read->count, &p_read->dropped);
+        return p_read->len ? __LORA_OK : __LORA_ERROR;
+    }
+    else if(ioctl == __LORA_IOCTL_SPI_TRACE_PRINT)
+    {
+        sx126x_trace_print();
+        return __LORA_OK;
+    }
+
     if(is_lora_on)
         return __current_mode()->mode_ioctl(ioctl, arg);
     else
@@ -319,6 +347,11 @@ static void lora_callback_stub(lora_event_t event, void* event_data)
                     ind_param.rx.dl_frame_counter,
                     ind_param.rx.rssi, ind_param.rx.snr,
                     ind_param.rx.data_rate, ind_param.len);
+                if(ind_param.rx.mcast_group >= 0)
+                {
+                    __log_output(" multicast group: "__green__"%d"__default__
+                        "\n", ind_param.rx.mcast_group);
+                }
                 __log_output_field(" rx data ", 82, '-', __center__, true);
                 __log_output_dump(ind_param.buf, ind_param.len, 20,
                     __log_dump_flag_hide_address|__log_dump_flag_hide_offset|
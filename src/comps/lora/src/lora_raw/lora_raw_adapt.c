@@ -0,0 +1,763 @@
+/** -------------------------------------------------------------------------- *
+ * Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @author  Ahmed Sabry (SG Wireless)
+ *
+ * @brief   lora-raw mode link adaptation (adapt) sub-component.
+ *          Every message to a peer carries a small header and is answered by
+ *          an ack. The receiver keeps the snr history of every peer and
+ *          answers in the ack the rate step and the tx power cut the peer
+ *          shall use for its next message, then it listens at that step.
+ *
+ *          The rate steps start at the configured spreading factor and
+ *          bandwidth (the base rate), every next step is about 2.5 dB (one
+ *          spreading factor) or 3 dB (double bandwidth) less sensitive. The
+ *          receiver selects the fastest step that keeps the configured snr
+ *          margin above the demodulation limit for the lowest snr of the
+ *          history, and at the fastest step it cuts the tx power with the
+ *          remaining margin. It steps down at once on a weak frame and steps
+ *          up only on a settled history.
+ *
+ *          Both nodes fall back to the base rate when the link is lost: the
+ *          sender after `retries` transmissions without an ack, the receiver
+ *          after `idle` msec without a message of the peer. The sender keeps
+ *          trying at the base rate until the receiver has fallen back too.
+ *
+ *          frames layout:
+ *            data : [0] type, [1] src, [2] dst, [3] seq, [4] step,
+ *                   [5] power cut in dB, [6] attempt, [7..] message
+ *            ack  : [0] type, [1] src, [2] dst, [3] seq, [4] next step,
+ *                   [5] next power cut in dB, [6] snr, [7] rssi
+ * --------------------------------------------------------------------------- *
+ */
+
+/** -------------------------------------------------------------------------- *
+ * includes
+ * --------------------------------------------------------------------------- *
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#define __log_subsystem  lora
+#define __log_component  raw_adapt
+#include "log_lib.h"
+
+#include "lora.h"
+#include "stub_system.h"
+#include "lora_raw_process.h"
+#include "lora_raw_radio_if.h"
+#include "lora_raw_adapt.h"
+#include "lora_raw_airtime.h"
+
+/** -------------------------------------------------------------------------- *
+ * definitions
+ * --------------------------------------------------------------------------- *
+ */
+enum {
+    __ADAPT_FRAME_DATA = 0xB1,
+    __ADAPT_FRAME_ACK,
+};
+
+#define __adapt_data_hdr_size   (7)
+#define __adapt_ack_size        (8)
+
+#define __adapt_max_steps       (8)
+#define __adapt_history         (8)     /* snr samples per peer */
+#define __adapt_min_history     (4)     /* samples before stepping up */
+#define __adapt_power_step      (2)     /* dB */
+#define __adapt_bw_db10         (30)    /* 0.1 dB, sensitivity loss of a
+                                         * doubled bandwidth */
+
+/* demodulation snr limit in 0.1 dB (-7.5 dB at SF7 .. -20 dB at SF12) */
+#define __adapt_snr_limit(sf)   (-25 * ((int16_t)(sf) - 4))
+
+#define __adapt_default_addr        (1)
+#define __adapt_default_margin      (5)
+#define __adapt_default_max_bw      __LORA_BW_250_KHZ
+#define __adapt_default_power_cut   (10)
+#define __adapt_default_retries     (3)
+#define __adapt_default_idle        (10000)
+
+typedef struct {
+    uint8_t     sf;
+    uint8_t     bw;
+} adapt_rate_t;
+
+typedef struct {
+    bool        used;
+    uint8_t     addr;
+    uint8_t     tx_step;        /* towards the peer, answered by the peer */
+    uint8_t     tx_power_cut;
+    uint8_t     tx_seq;
+    uint32_t    tx_ts;          /* last ack of the peer */
+    uint8_t     rx_step;        /* from the peer, decided here */
+    uint8_t     rx_power_cut;
+    uint8_t     rx_seq;
+    bool        rx_seq_valid;
+    uint32_t    rx_ts;          /* last message of the peer */
+    int16_t     history[__adapt_history]; /* normalized snr in 0.1 dB */
+    uint8_t     history_count;
+    uint8_t     history_next;
+    lora_raw_adapt_status_t stats;
+} adapt_peer_t;
+
+static struct {
+    lora_raw_adapt_cfg_t cfg;
+    adapt_rate_t    ladder[__adapt_max_steps];
+    uint8_t         steps;
+    adapt_peer_t    peers[__LORA_RAW_ADAPT_MAX_PEERS];
+    adapt_peer_t*   p_listen;   /* the peer the receiver listens to */
+    struct {
+        bool        valid;
+        uint8_t     step;
+        uint8_t     power_cut;
+    } applied;
+    uint8_t         frame[255];
+} s_adapt;
+
+/** -------------------------------------------------------------------------- *
+ * rate steps
+ * --------------------------------------------------------------------------- *
+ */
+static uint32_t get_param(lora_raw_param_type_t type)
+{
+    lora_raw_param_t param = {.type = type};
+    lora_raw_radio_get_param( & param );
+
+    switch(type) {
+        case __LORA_RAW_PARAM_SF:           return param.param.sf;
+        case __LORA_RAW_PARAM_BW:           return param.param.bw;
+        case __LORA_RAW_PARAM_PAYLOAD:      return param.param.payload;
+        default:                            return 0;
+    }
+}
+
+static void ladder_push(uint8_t sf, uint8_t bw)
+{
+    if( s_adapt.steps < __adapt_max_steps )
+    {
+        s_adapt.ladder[s_adapt.steps].sf = sf;
+        s_adapt.ladder[s_adapt.steps].bw = bw;
+        ++ s_adapt.steps;
+    }
+}
+
+/* the steps follow the configured params, they are rebuilt on every call */
+static void ladder_build(void)
+{
+    uint8_t sf = get_param(__LORA_RAW_PARAM_SF);
+    uint8_t bw = get_param(__LORA_RAW_PARAM_BW);
+
+    s_adapt.steps = 0;
+    ladder_push(sf, bw);
+    while( sf > __LORA_SF_7 )
+        ladder_push(-- sf, bw);
+    while( bw < s_adapt.cfg.max_bw )
+        ladder_push(sf, ++ bw);
+}
+
+static uint8_t step_clamp(uint8_t step)
+{
+    return step < s_adapt.steps ? step : s_adapt.steps - 1;
+}
+
+static void rate_apply(uint8_t step, uint8_t power_cut)
+{
+    lora_raw_process_event_payload_t msg = {
+        .type = __PROCESS_MSG_PAYLOAD_RADIO_RATE,
+        .radio_rate = { .sf = 0 }
+    };
+
+    if( s_adapt.applied.valid && s_adapt.applied.step == step &&
+        s_adapt.applied.power_cut == power_cut )
+        return;
+
+    /* the base rate at full power is the configured one */
+    if( step || power_cut )
+    {
+        msg.radio_rate.sf = s_adapt.ladder[step].sf;
+        msg.radio_rate.bw = s_adapt.ladder[step].bw;
+        msg.radio_rate.power_cut = power_cut;
+    }
+    __log_info("rate -> step %d (SF%d, bw:%d), power cut %d dB", step,
+        s_adapt.ladder[step].sf, s_adapt.ladder[step].bw, power_cut);
+    lora_raw_process_event(__LORA_RAW_PROCESS_RADIO_RATE, &msg, true);
+
+    s_adapt.applied.valid = true;
+    s_adapt.applied.step = step;
+    s_adapt.applied.power_cut = power_cut;
+}
+
+static void rate_restore(void)
+{
+    rate_apply(0, 0);
+    s_adapt.applied.valid = false;
+}
+
+/** -------------------------------------------------------------------------- *
+ * peers
+ * --------------------------------------------------------------------------- *
+ */
+static adapt_peer_t* peer_find(uint8_t addr)
+{
+    for(int i = 0; i < __LORA_RAW_ADAPT_MAX_PEERS; ++i)
+        if( s_adapt.peers[i].used && s_adapt.peers[i].addr == addr )
+            return &s_adapt.peers[i];
+    return NULL;
+}
+
+/* a new peer takes a free entry or the least recently active one */
+static adapt_peer_t* peer_get(uint8_t addr)
+{
+    adapt_peer_t* p = peer_find(addr);
+    uint32_t now = lora_stub_get_timestamp_ms();
+    uint32_t oldest = 0;
+
+    if( p )
+        return p;
+
+    for(int i = 0; i < __LORA_RAW_ADAPT_MAX_PEERS; ++i)
+    {
+        adapt_peer_t* q = &s_adapt.peers[i];
+        uint32_t age;
+        if( ! q->used )
+        {
+            p = q;
+            break;
+        }
+        age = now - ( q->tx_ts > q->rx_ts ? q->tx_ts : q->rx_ts );
+        if( q != s_adapt.p_listen && age >= oldest )
+        {
+            oldest = age;
+            p = q;
+        }
+    }
+
+    memset(p, 0, sizeof(*p));
+    p->used = true;
+    p->addr = addr;
+    p->tx_ts = p->rx_ts = now;
+    return p;
+}
+
+static void peer_history_push(adapt_peer_t* p, int16_t snr)
+{
+    p->history[p->history_next] = snr;
+    p->history_next = ( p->history_next + 1 ) % __adapt_history;
+    if( p->history_count < __adapt_history )
+        ++ p->history_count;
+}
+
+static int16_t peer_snr_min(adapt_peer_t* p)
+{
+    int16_t snr_min = INT16_MAX;
+    for(int i = 0; i < p->history_count; ++i)
+        if( p->history[i] < snr_min )
+            snr_min = p->history[i];
+    return snr_min;
+}
+
+/* snr margin in 0.1 dB of a step over its limit for a normalized snr */
+static int16_t step_excess(uint8_t step, int16_t snr)
+{
+    return snr
+        - __adapt_bw_db10 * ( s_adapt.ladder[step].bw - s_adapt.ladder[0].bw )
+        - __adapt_snr_limit( s_adapt.ladder[step].sf )
+        - 10 * s_adapt.cfg.margin;
+}
+
+/* higher is faster, a power cut counts within the same step */
+#define __adapt_rank(step, cut)     ( (step) * 256 + (cut) )
+
+static void peer_decide(adapt_peer_t* p, uint8_t attempt)
+{
+    int16_t snr = peer_snr_min(p);
+    int16_t excess;
+    uint8_t step = 0;
+    uint8_t cut = 0;
+    int rank, now_rank = __adapt_rank(p->rx_step, p->rx_power_cut);
+
+    for(uint8_t s = 1; s < s_adapt.steps; ++s)
+        if( step_excess(s, snr) >= 0 )
+            step = s;
+
+    excess = step_excess(step, snr);
+    if( step == s_adapt.steps - 1 && excess > 0 )
+    {
+        cut = excess / 10;
+        if( cut > s_adapt.cfg.max_power_cut )
+            cut = s_adapt.cfg.max_power_cut;
+        cut -= cut % __adapt_power_step;
+    }
+    rank = __adapt_rank(step, cut);
+
+    /* stepping up waits for a settled history without repeated messages */
+    if( rank > now_rank && ( p->history_count < __adapt_min_history ||
+        attempt ) )
+    {
+        step = p->rx_step;
+        cut = p->rx_power_cut;
+        rank = now_rank;
+    }
+
+    /* a message sent several times backs off by one step */
+    if( attempt >= 2 && rank >= now_rank )
+    {
+        if( p->rx_power_cut )
+        {
+            step = p->rx_step;
+            cut = 0;
+        }
+        else if( p->rx_step )
+        {
+            step = p->rx_step - 1;
+            cut = 0;
+        }
+        rank = __adapt_rank(step, cut);
+    }
+
+    if( rank > now_rank )
+        ++ p->stats.ups;
+    else if( rank < now_rank )
+        ++ p->stats.downs;
+
+    if( rank != now_rank )
+        __log_info("peer %d -> step %d, power cut %d dB (snr min %d.%d dB)",
+            p->addr, step, cut, snr / 10, ( snr < 0 ? -snr : snr ) % 10);
+
+    p->rx_step = step;
+    p->rx_power_cut = cut;
+}
+
+/** -------------------------------------------------------------------------- *
+ * radio access through the raw process
+ * --------------------------------------------------------------------------- *
+ */
+static void adapt_send_frame(uint8_t* buf, uint8_t len)
+{
+    /* a frame rejected by the duty-cycle budget is recovered as a lost one */
+    if( ! lora_raw_airtime_admit(len) )
+        return;
+
+    lora_raw_process_event_payload_t tx_msg = {
+        .type = __PROCESS_MSG_PAYLOAD_TX_REQ,
+        .tx_payload = { .buf = buf, .len = len, .timeout = 0 }
+    };
+    lora_raw_process_event(__LORA_RAW_PROCESS_TX_REQUEST, &tx_msg, true);
+}
+
+static uint8_t adapt_recv_frame(uint8_t* buf, uint32_t timeout)
+{
+    uint8_t len = 0;
+    lora_raw_process_event_payload_t rx_msg = {
+        .type = __PROCESS_MSG_PAYLOAD_RX_REQ,
+        .rx_payload = {
+            .buf = buf,
+            .buf_len = 255,
+            .p_len = &len,
+            .timeout = timeout
+        }
+    };
+    lora_raw_process_event(__LORA_RAW_PROCESS_RX_REQUEST, &rx_msg, true);
+    return len;
+}
+
+/** -------------------------------------------------------------------------- *
+ * sender side
+ * --------------------------------------------------------------------------- *
+ */
+static bool tx_wait_ack(adapt_peer_t* p, uint8_t seq, uint32_t timeout)
+{
+    uint8_t* f = s_adapt.frame;
+    uint32_t start_ts = lora_stub_get_timestamp_ms();
+    uint32_t elapsed;
+
+    while( ( elapsed = lora_stub_get_timestamp_ms() - start_ts ) < timeout )
+    {
+        uint8_t len = adapt_recv_frame(f, timeout - elapsed);
+        if( len == 0 )
+            break;
+        if( len == __adapt_ack_size && f[0] == __ADAPT_FRAME_ACK &&
+            f[1] == p->addr && f[2] == s_adapt.cfg.addr && f[3] == seq )
+        {
+            int rank = __adapt_rank(f[4], f[5]);
+            int now_rank = __adapt_rank(p->tx_step, p->tx_power_cut);
+
+            if( rank > now_rank )
+                ++ p->stats.ups;
+            else if( rank < now_rank )
+                ++ p->stats.downs;
+
+            p->tx_step = step_clamp(f[4]);
+            p->tx_power_cut = f[5] <= s_adapt.cfg.max_power_cut ? f[5] : 0;
+            p->stats.tx_snr = (int8_t)f[6];
+            p->stats.tx_rssi = (int8_t)f[7];
+            return true;
+        }
+    }
+    return false;
+}
+
+bool lora_raw_adapt_send(lora_raw_adapt_msg_t* p_msg)
+{
+    uint8_t* f = s_adapt.frame;
+    uint8_t payload = get_param(__LORA_RAW_PARAM_PAYLOAD);
+    uint32_t timeout = s_adapt.cfg.timeout;
+    uint32_t fallback_ts = 0;
+    uint8_t attempt = 0;
+    uint8_t base_attempts = 0;
+    bool acked = false;
+    adapt_peer_t* p;
+    uint8_t seq;
+
+    if( p_msg->buf == NULL || p_msg->len == 0 ||
+        payload <= __adapt_data_hdr_size ||
+        p_msg->len > payload - __adapt_data_hdr_size )
+        return false;
+
+    if( timeout == 0 )
+        timeout = lora_raw_radio_get_time_on_air() + 200;
+
+    ladder_build();
+    p = peer_get(p_msg->peer);
+    p->tx_step = step_clamp(p->tx_step);
+    seq = p->tx_seq ++;
+
+    /* the peer has fallen back to the base rate on an idle link */
+    if( ( p->tx_step || p->tx_power_cut ) &&
+        lora_stub_get_timestamp_ms() - p->tx_ts >= s_adapt.cfg.idle )
+    {
+        __log_info("peer %d -> idle link, base rate", p->addr);
+        p->tx_step = p->tx_power_cut = 0;
+        ++ p->stats.fallbacks;
+    }
+
+    while( true )
+    {
+        rate_apply(p->tx_step, p->tx_power_cut);
+
+        f[0] = __ADAPT_FRAME_DATA;
+        f[1] = s_adapt.cfg.addr;
+        f[2] = p->addr;
+        f[3] = seq;
+        f[4] = p->tx_step;
+        f[5] = p->tx_power_cut;
+        f[6] = attempt;
+        memcpy(&f[__adapt_data_hdr_size], p_msg->buf, p_msg->len);
+
+        ++ p->stats.sent;
+        if( attempt )
+            ++ p->stats.retries;
+        adapt_send_frame(f, __adapt_data_hdr_size + p_msg->len);
+
+        if( tx_wait_ack(p, seq, timeout) )
+        {
+            ++ p->stats.acked;
+            p->tx_ts = lora_stub_get_timestamp_ms();
+            acked = true;
+            break;
+        }
+
+        if( attempt < UINT8_MAX )
+            ++ attempt;
+        __log_info("peer %d -> no ack (attempt %d)", p->addr, attempt);
+
+        if( p->tx_step || p->tx_power_cut )
+        {
+            if( attempt >= s_adapt.cfg.retries )
+            {
+                __log_info("peer %d -> link lost, base rate", p->addr);
+                p->tx_step = p->tx_power_cut = 0;
+                ++ p->stats.fallbacks;
+                ++ p->stats.downs;
+                fallback_ts = lora_stub_get_timestamp_ms();
+            }
+        }
+        /* after a fallback, the base rate is tried until the receiver is
+         * idle long enough to fall back too */
+        else if( ++ base_attempts >= s_adapt.cfg.retries &&
+            ( fallback_ts == 0 || lora_stub_get_timestamp_ms() - fallback_ts
+                >= s_adapt.cfg.idle + timeout ) )
+        {
+            break;
+        }
+    }
+
+    rate_restore();
+    return acked;
+}
+
+/** -------------------------------------------------------------------------- *
+ * receiver side
+ * --------------------------------------------------------------------------- *
+ */
+/* applies the listen rate, it returns the msec left before the listened peer
+ * falls back to the base rate on an idle link */
+static uint32_t rx_listen(void)
+{
+    adapt_peer_t* p = s_adapt.p_listen;
+    uint32_t idle_left = UINT32_MAX;
+    uint32_t idle;
+
+    if( p && ( p->rx_step || p->rx_power_cut ) )
+    {
+        /* an idle peer restarts at the base rate as its sender does */
+        idle = lora_stub_get_timestamp_ms() - p->rx_ts;
+        if( idle >= s_adapt.cfg.idle )
+        {
+            __log_info("peer %d -> idle link, base rate", p->addr);
+            p->rx_step = p->rx_power_cut = 0;
+            ++ p->stats.fallbacks;
+        }
+        else
+        {
+            idle_left = s_adapt.cfg.idle - idle;
+        }
+    }
+
+    /* the receiver transmits its acks at full power */
+    rate_apply(p ? step_clamp(p->rx_step) : 0, 0);
+    return idle_left;
+}
+
+static bool rx_handle_frame(lora_raw_rx_ring_frame_t* p_frame,
+    lora_raw_adapt_msg_t* p_msg)
+{
+    uint8_t* buf = p_frame->buf;
+    uint8_t ack[__adapt_ack_size];
+    adapt_peer_t* p;
+    bool duplicate;
+    uint8_t len;
+
+    if( p_frame->len <= __adapt_data_hdr_size ||
+        buf[0] != __ADAPT_FRAME_DATA || buf[2] != s_adapt.cfg.addr )
+        return false;
+
+    p = peer_get(buf[1]);
+    p->rx_ts = lora_stub_get_timestamp_ms();
+    ++ p->stats.received;
+    p->stats.rx_snr = p_frame->snr;
+    p->stats.rx_rssi = p_frame->rssi;
+
+    /* the snr is normalized to the base rate at full power */
+    peer_history_push(p, 10 * p_frame->snr + buf[5] * 10 +
+        __adapt_bw_db10 * ( s_adapt.ladder[step_clamp(buf[4])].bw -
+            s_adapt.ladder[0].bw ));
+
+    duplicate = p->rx_seq_valid && p->rx_seq == buf[3];
+    if( duplicate )
+        ++ p->stats.duplicates;
+
+    peer_decide(p, buf[6]);
+
+    /* the ack goes at the rate of the message, then the receiver listens
+     * at the answered step */
+    ack[0] = __ADAPT_FRAME_ACK;
+    ack[1] = s_adapt.cfg.addr;
+    ack[2] = p->addr;
+    ack[3] = buf[3];
+    ack[4] = p->rx_step;
+    ack[5] = p->rx_power_cut;
+    ack[6] = (uint8_t)p_frame->snr;
+    ack[7] = (uint8_t)p_frame->rssi;
+    adapt_send_frame(ack, sizeof(ack));
+
+    s_adapt.p_listen = p;
+    rx_listen();
+
+    if( duplicate )
+        return false;
+
+    p->rx_seq = buf[3];
+    p->rx_seq_valid = true;
+
+    len = p_frame->len - __adapt_data_hdr_size;
+    if( len > p_msg->len )
+        len = p_msg->len;
+    memcpy(p_msg->buf, &buf[__adapt_data_hdr_size], len);
+    p_msg->len = len;
+    p_msg->peer = p->addr;
+    p_msg->rssi = p_frame->rssi;
+    p_msg->snr = p_frame->snr;
+    return true;
+}
+
+bool lora_raw_adapt_recv(lora_raw_adapt_msg_t* p_msg)
+{
+    static lora_raw_rx_ring_frame_t frame;
+    lora_raw_rx_ring_status_t ring_status;
+    lora_raw_rx_ring_cfg_t ring_cfg = { .enable = true, .batch = 0 };
+    uint32_t start_ts = lora_stub_get_timestamp_ms();
+    uint32_t elapsed;
+    uint32_t wait;
+    bool received = false;
+
+    if( p_msg->buf == NULL || p_msg->len == 0 )
+        return false;
+
+    ladder_build();
+    rx_listen();
+
+    /* the frames are collected by the rx ring, so no frame is missed while
+     * an ack is being sent */
+    lora_raw_process_rx_ring_status(&ring_status);
+    lora_raw_process_rx_ring_set(&ring_cfg);
+    lora_raw_process_event(__LORA_RAW_PROCESS_RX_CONT_START, NULL, false);
+
+    while( ( elapsed = lora_stub_get_timestamp_ms() - start_ts ) <
+           p_msg->timeout )
+    {
+        /* wakes up on the idle fallback of the peer to listen at its rate */
+        wait = rx_listen();
+        if( wait > p_msg->timeout - elapsed )
+            wait = p_msg->timeout - elapsed;
+        if( ! lora_raw_process_rx_ring_wait(&frame, wait) )
+            continue;
+
+        if( rx_handle_frame(&frame, p_msg) )
+        {
+            received = true;
+            break;
+        }
+    }
+
+    lora_raw_process_event(__LORA_RAW_PROCESS_RX_CONT_STOP, NULL, true);
+    ring_cfg.enable = ring_status.enabled;
+    ring_cfg.batch = ring_status.batch;
+    lora_raw_process_rx_ring_set(&ring_cfg);
+    rate_restore();
+
+    if( ! received )
+        p_msg->len = 0;
+    return received;
+}
+
+/** -------------------------------------------------------------------------- *
+ * configurations and status
+ * --------------------------------------------------------------------------- *
+ */
+void lora_raw_adapt_ctor(void)
+{
+    s_adapt.cfg = (lora_raw_adapt_cfg_t) {
+        .addr = __adapt_default_addr,
+        .margin = __adapt_default_margin,
+        .max_bw = __adapt_default_max_bw,
+        .max_power_cut = __adapt_default_power_cut,
+        .retries = __adapt_default_retries,
+        .timeout = 0,
+        .idle = __adapt_default_idle,
+    };
+}
+
+void lora_raw_adapt_config(lora_raw_adapt_cfg_t* p_cfg)
+{
+    s_adapt.cfg = *p_cfg;
+    if( s_adapt.cfg.max_bw > __LORA_BW_500_KHZ )
+        s_adapt.cfg.max_bw = __LORA_BW_500_KHZ;
+    if( s_adapt.cfg.retries == 0 )
+        s_adapt.cfg.retries = 1;
+
+    memset(s_adapt.peers, 0, sizeof(s_adapt.peers));
+    s_adapt.p_listen = NULL;
+    s_adapt.applied.valid = false;
+}
+
+void lora_raw_adapt_status(lora_raw_adapt_status_t* p_status)
+{
+    uint8_t addr = p_status->peer;
+    adapt_peer_t* p = peer_find(addr);
+
+    ladder_build();
+    if( p == NULL )
+    {
+        memset(p_status, 0, sizeof(*p_status));
+        p_status->peer = addr;
+        p_status->steps = s_adapt.steps;
+        p_status->tx_sf = p_status->rx_sf = s_adapt.ladder[0].sf;
+        p_status->tx_bw = p_status->rx_bw = s_adapt.ladder[0].bw;
+        return;
+    }
+
+    *p_status = p->stats;
+    p_status->peer = p->addr;
+    p_status->known = true;
+    p_status->steps = s_adapt.steps;
+    p_status->tx_step = step_clamp(p->tx_step);
+    p_status->tx_sf = s_adapt.ladder[p_status->tx_step].sf;
+    p_status->tx_bw = s_adapt.ladder[p_status->tx_step].bw;
+    p_status->tx_power_cut = p->tx_power_cut;
+    p_status->rx_step = step_clamp(p->rx_step);
+    p_status->rx_sf = s_adapt.ladder[p_status->rx_step].sf;
+    p_status->rx_bw = s_adapt.ladder[p_status->rx_step].bw;
+    p_status->rx_power_cut = p->rx_power_cut;
+    p_status->snr_min = p->history_count ? peer_snr_min(p) / 10 : 0;
+}
+
+void lora_raw_adapt_stats(void)
+{
+    #define __temp(item, val_fmt, args...) \
+        log_list_item("%-15s: " val_fmt __default__, item, args)
+    static const char* bws[] = { "125", "250", "500" };
+    lora_raw_adapt_status_t status;
+    bool any = false;
+
+    for(int i = 0; i < __LORA_RAW_ADAPT_MAX_PEERS; ++i)
+        any |= s_adapt.peers[i].used;
+    if( ! any )
+        return;
+
+    log_list_start(4);
+
+    log_list_indent();
+    log_list_item(__blue__"link adaptation");
+    log_list_indent();
+        __temp("addr", __yellow__"%d", s_adapt.cfg.addr);
+        __temp("margin", __yellow__"%d"__default__" dB", s_adapt.cfg.margin);
+    for(int i = 0; i < __LORA_RAW_ADAPT_MAX_PEERS; ++i)
+    {
+        if( ! s_adapt.peers[i].used )
+            continue;
+        status.peer = s_adapt.peers[i].addr;
+        lora_raw_adapt_status(&status);
+        log_list_outdent();
+        log_list_item(__blue__"peer %d", status.peer);
+        log_list_indent();
+        __temp("tx_rate", "SF"__yellow__"%d"__default__" / %s KHz / -%d dB",
+            status.tx_sf, bws[status.tx_bw], status.tx_power_cut);
+        __temp("rx_rate", "SF"__yellow__"%d"__default__" / %s KHz / -%d dB",
+            status.rx_sf, bws[status.rx_bw], status.rx_power_cut);
+        __temp("tx_snr", __yellow__"%d"__default__" dB", status.tx_snr);
+        __temp("rx_snr", __yellow__"%d"__default__" dB (min %d dB)",
+            status.rx_snr, status.snr_min);
+        __temp("sent", __yellow__"%d"__default__" (%d acked, %d retries)",
+            status.sent, status.acked, status.retries);
+        __temp("received", __yellow__"%d"__default__" (%d duplicates)",
+            status.received, status.duplicates);
+        __temp("steps", __yellow__"%d"__default__" up, %d down, "
+            "%d fallbacks", status.ups, status.downs, status.fallbacks);
+    }
+    log_list_end();
+
+    #undef __temp
+}
+
+/* --- end of file ---------------------------------------------------------- */
@@ -0,0 +1,84 @@
+/** -------------------------------------------------------------------------- *
+ * Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @author  Ahmed Sabry (SG Wireless)
+ *
+ * @brief   lora-raw mode link adaptation (adapt) sub-component interface.
+ *          It exchanges acknowledged messages with the peers and negotiates
+ *          per peer the fastest rate step the link supports.
+ * --------------------------------------------------------------------------- *
+ */
+#ifndef __LORA_RAW_ADAPT_H__
+#define __LORA_RAW_ADAPT_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** -------------------------------------------------------------------------- *
+ * includes
+ * --------------------------------------------------------------------------- *
+ */
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "lora.h"
+
+/** -------------------------------------------------------------------------- *
+ * APIs
+ * --------------------------------------------------------------------------- *
+ */
+
+void lora_raw_adapt_ctor(void);
+
+/**
+ * @brief   sets the link adaptation configurations, the peers links restart
+ *          at the base rate
+ */
+void lora_raw_adapt_config(lora_raw_adapt_cfg_t* p_cfg);
+
+/**
+ * @brief   sends a message to a peer at its adapted rate, the caller is
+ *          blocked until the message is acknowledged
+ * @return  false on invalid parameters or if no ack is received
+ */
+bool lora_raw_adapt_send(lora_raw_adapt_msg_t* p_msg);
+
+/**
+ * @brief   receives a message addressed to this node, acknowledges it and
+ *          answers the rate step the sender shall use next, the caller is
+ *          blocked until a message is received
+ * @return  false if no message is received within the timeout
+ */
+bool lora_raw_adapt_recv(lora_raw_adapt_msg_t* p_msg);
+
+void lora_raw_adapt_status(lora_raw_adapt_status_t* p_status);
+
+/**
+ * @brief   displays the links of the known peers
+ */
+void lora_raw_adapt_stats(void);
+
+/* --- end of file ---------------------------------------------------------- */
+#ifdef __cplusplus
+}
+#endif
+#endif /* __LORA_RAW_ADAPT_H__ */
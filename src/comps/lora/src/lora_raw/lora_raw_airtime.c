@@ -0,0 +1,471 @@
+/** -------------------------------------------------------------------------- *
+ * Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @author  Ahmed Sabry (SG Wireless)
+ *
+ * @brief   lora-raw mode airtime accounting sub-component.
+ *
+ *          Every admitted message is charged with its time on air to the
+ *          regional sub-band of the current frequency. The airtime of a
+ *          sub-band is kept over a sliding window of one hour made of one
+ *          minute buckets, and the budget of the window is the sub-band
+ *          duty-cycle. A message is charged when it is admitted, before it
+ *          reaches the radio, so the accounting never under-estimates the
+ *          used airtime even if the message is dropped later.
+ *
+ *          The time on air is read from a table of all the message lengths
+ *          built for the current modulation parameters, it is rebuilt only
+ *          when one of them changes.
+ * --------------------------------------------------------------------------- *
+ */
+
+/** -------------------------------------------------------------------------- *
+ * includes
+ * --------------------------------------------------------------------------- *
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#define __log_subsystem  lora
+#define __log_component  raw_airtime
+#include "log_lib.h"
+
+#include "lora.h"
+#include "stub_system.h"
+#include "lora_raw_radio_if.h"
+#include "lora_raw_airtime.h"
+
+/** -------------------------------------------------------------------------- *
+ * regional sub-bands
+ * --------------------------------------------------------------------------- *
+ */
+typedef struct {
+    uint32_t    low;    /* Hz */
+    uint32_t    high;   /* Hz */
+    uint16_t    duty;   /* 0.01 % units */
+} airtime_band_t;
+
+#define __duty_0_1_pct      (10)
+#define __duty_1_pct        (100)
+#define __duty_10_pct       (1000)
+#define __duty_unlimited    (10000)
+
+/* the last entry of every region catches the frequencies outside its listed
+ * sub-bands */
+static const airtime_band_t s_bands_eu868[] = {
+    { 863000000, 865000000, __duty_0_1_pct   },
+    { 865000000, 868000000, __duty_1_pct     },
+    { 868000000, 868600000, __duty_1_pct     },
+    { 868700000, 869200000, __duty_0_1_pct   },
+    { 869400000, 869650000, __duty_10_pct    },
+    { 869700000, 870000000, __duty_1_pct     },
+    { 0,         UINT32_MAX, __duty_0_1_pct  },
+};
+static const airtime_band_t s_bands_eu433[] = {
+    { 0,         UINT32_MAX, __duty_1_pct    },
+};
+static const airtime_band_t s_bands_cn779[] = {
+    { 0,         UINT32_MAX, __duty_1_pct    },
+};
+static const airtime_band_t s_bands_ru864[] = {
+    { 0,         UINT32_MAX, __duty_1_pct    },
+};
+/* the other regions limit the dwell time rather than the duty-cycle */
+static const airtime_band_t s_bands_unlimited[] = {
+    { 0,         UINT32_MAX, __duty_unlimited },
+};
+
+#define __bands(_t)     _t, sizeof(_t) / sizeof(_t[0])
+#define __airtime_max_bands     (7)
+
+/** -------------------------------------------------------------------------- *
+ * airtime accounting state
+ * --------------------------------------------------------------------------- *
+ */
+#define __airtime_buckets       (60)
+#define __airtime_bucket_ms     (60000u)
+#define __airtime_window_ms     (__airtime_buckets * __airtime_bucket_ms)
+
+static struct {
+    void*                   mutex;
+
+    lora_region_t           region;
+    bool                    region_valid;
+    const airtime_band_t*   p_bands;
+    uint8_t                 bands_count;
+
+    /* per sub-band airtime in msec of every bucket of the window */
+    uint16_t                usage[__airtime_max_bands][__airtime_buckets];
+    uint32_t                bucket;     /* absolute index of the newest one */
+
+    /* time on air table of the current modulation parameters */
+    struct {
+        uint8_t             sf;
+        uint8_t             bw;
+        uint8_t             cr;
+        uint8_t             preamble;
+        bool                crc_on;
+    } key;
+    bool                    table_valid;
+    uint16_t                toa[256];
+
+    /* totals since the boot */
+    uint32_t                total;
+    uint32_t                frames;
+    uint32_t                exceeded;
+    uint32_t                rejected;
+    uint32_t                queued;
+} s_airtime;
+
+#define __airtime_lock()    lora_stub_mutex_lock(s_airtime.mutex)
+#define __airtime_unlock()  lora_stub_mutex_unlock(s_airtime.mutex)
+
+static uint32_t get_param(lora_raw_param_type_t type)
+{
+    lora_raw_param_t param = {.type = type};
+    lora_raw_radio_get_param( & param );
+
+    switch(type) {
+        case __LORA_RAW_PARAM_REGION:       return param.region;
+        case __LORA_RAW_PARAM_FREQ:         return param.param.freq;
+        case __LORA_RAW_PARAM_CR:           return param.param.cr;
+        case __LORA_RAW_PARAM_PREAMBLE:     return param.param.preamble;
+        case __LORA_RAW_PARAM_CRC_ON:       return param.param.crc_on;
+        case __LORA_RAW_PARAM_PAYLOAD:      return param.param.payload;
+        case __LORA_RAW_PARAM_DUTY_POLICY:  return param.param.duty_policy;
+        default:                            return 0;
+    }
+}
+
+/** -------------------------------------------------------------------------- *
+ * time on air table
+ * --------------------------------------------------------------------------- *
+ */
+
+/* LoRa time on air in usec with the explicit header (Semtech AN1200.13) */
+static uint32_t toa_calc_us(uint8_t sf, uint8_t bw, uint8_t cr,
+    uint8_t preamble, bool crc_on, uint8_t len)
+{
+    uint32_t sym_us = (1u << sf) * (bw == __LORA_BW_125_KHZ ? 8 :
+                                    bw == __LORA_BW_250_KHZ ? 4 : 2);
+    /* low data rate optimization for symbols of 16.38 msec and longer */
+    uint8_t de = sym_us >= 16384 ? 1 : 0;
+    int32_t num = 8 * len - 4 * sf + 28 + (crc_on ? 16 : 0);
+    int32_t den = 4 * (sf - 2 * de);
+    uint32_t payload_syms = 8;
+
+    if( num > 0 )
+        payload_syms += ((num + den - 1) / den) * (cr + 4);
+
+    /* in quarter symbols, the preamble is followed by 4.25 symbols */
+    return sym_us * (4u * preamble + 17 + 4 * payload_syms) / 4;
+}
+
+static void toa_table_refresh(void)
+{
+    uint8_t sf, bw;
+    uint8_t cr = get_param(__LORA_RAW_PARAM_CR);
+    uint8_t preamble = get_param(__LORA_RAW_PARAM_PREAMBLE);
+    bool crc_on = get_param(__LORA_RAW_PARAM_CRC_ON);
+
+    /* the link adaptation may run at another rate than the configured one */
+    lora_raw_radio_get_rate(&sf, &bw);
+
+    if( s_airtime.table_valid && s_airtime.key.sf == sf &&
+        s_airtime.key.bw == bw && s_airtime.key.cr == cr &&
+        s_airtime.key.preamble == preamble && s_airtime.key.crc_on == crc_on )
+        return;
+
+    for(uint32_t len = 0; len < 256; ++len)
+        s_airtime.toa[len] =
+            (toa_calc_us(sf, bw, cr, preamble, crc_on, len) + 999) / 1000;
+
+    s_airtime.key.sf = sf;
+    s_airtime.key.bw = bw;
+    s_airtime.key.cr = cr;
+    s_airtime.key.preamble = preamble;
+    s_airtime.key.crc_on = crc_on;
+    s_airtime.table_valid = true;
+
+    __log_info("toa table -> sf:%d bw:%d cr:4/%d preamble:%d, "
+        "1 byte: %d msec, 255 bytes: %d msec", sf, bw, cr + 4, preamble,
+        s_airtime.toa[1], s_airtime.toa[255]);
+}
+
+/** -------------------------------------------------------------------------- *
+ * sliding window
+ * --------------------------------------------------------------------------- *
+ */
+static void window_refresh(void)
+{
+    lora_region_t region = get_param(__LORA_RAW_PARAM_REGION);
+    uint32_t now = lora_stub_get_timestamp_ms() / __airtime_bucket_ms;
+    uint32_t steps = now - s_airtime.bucket;
+
+    if( ! s_airtime.region_valid || s_airtime.region != region )
+    {
+        /* the sub-bands differ between the regions */
+        switch(region) {
+            case __LORA_REGION_EU868:
+                s_airtime.p_bands = s_bands_eu868;
+                s_airtime.bands_count = sizeof(s_bands_eu868) /
+                    sizeof(s_bands_eu868[0]);
+                break;
+            case __LORA_REGION_EU433:
+                s_airtime.p_bands = s_bands_eu433;
+                s_airtime.bands_count = 1;
+                break;
+            case __LORA_REGION_CN779:
+                s_airtime.p_bands = s_bands_cn779;
+                s_airtime.bands_count = 1;
+                break;
+            case __LORA_REGION_RU864:
+                s_airtime.p_bands = s_bands_ru864;
+                s_airtime.bands_count = 1;
+                break;
+            default:
+                s_airtime.p_bands = s_bands_unlimited;
+                s_airtime.bands_count = 1;
+                break;
+        }
+        s_airtime.region = region;
+        s_airtime.region_valid = true;
+        steps = __airtime_buckets;
+    }
+
+    /* the buckets that left the window are cleared, a timestamp wrap-around
+     * clears the whole window */
+    if( steps >= __airtime_buckets )
+    {
+        memset(s_airtime.usage, 0, sizeof(s_airtime.usage));
+    }
+    else
+    {
+        for(uint32_t i = 1; i <= steps; ++i)
+            for(uint8_t b = 0; b < s_airtime.bands_count; ++b)
+                s_airtime.usage[b][(s_airtime.bucket + i) %
+                    __airtime_buckets] = 0;
+    }
+    s_airtime.bucket = now;
+}
+
+static uint8_t band_lookup(uint32_t freq)
+{
+    uint8_t b;
+    for(b = 0; b < s_airtime.bands_count - 1; ++b)
+        if( freq >= s_airtime.p_bands[b].low &&
+            freq < s_airtime.p_bands[b].high )
+            break;
+    return b;
+}
+
+static uint32_t band_limit(uint8_t b)
+{
+    return (uint64_t)__airtime_window_ms * s_airtime.p_bands[b].duty /
+        __duty_unlimited;
+}
+
+static uint32_t band_used(uint8_t b)
+{
+    uint32_t used = 0;
+    for(uint8_t i = 0; i < __airtime_buckets; ++i)
+        used += s_airtime.usage[b][i];
+    return used;
+}
+
+/* msec until a message of toa msec fits in the budget of the sub-band */
+static uint32_t band_wait(uint8_t b, uint32_t toa)
+{
+    uint32_t limit = band_limit(b);
+    uint32_t used = band_used(b);
+    uint32_t now = lora_stub_get_timestamp_ms();
+
+    if( toa > limit )
+        return UINT32_MAX;
+    if( used + toa <= limit )
+        return 0;
+
+    /* the buckets leave the window from the oldest one, every bucket leaves
+     * it one window after its start */
+    for(uint32_t i = 1; i <= __airtime_buckets; ++i)
+    {
+        uint32_t bucket = s_airtime.bucket + i;
+        used -= s_airtime.usage[b][bucket % __airtime_buckets];
+        if( used + toa <= limit )
+            return bucket * __airtime_bucket_ms - now;
+    }
+    return UINT32_MAX;
+}
+
+static void band_charge(uint8_t b, uint32_t toa)
+{
+    uint16_t* p_bucket =
+        &s_airtime.usage[b][s_airtime.bucket % __airtime_buckets];
+
+    *p_bucket = *p_bucket + toa > UINT16_MAX ? UINT16_MAX : *p_bucket + toa;
+    s_airtime.total += toa;
+    ++ s_airtime.frames;
+}
+
+/** -------------------------------------------------------------------------- *
+ * APIs implementations
+ * --------------------------------------------------------------------------- *
+ */
+void lora_raw_airtime_ctor(void)
+{
+    if(s_airtime.mutex == NULL)
+        s_airtime.mutex = lora_stub_mutex_new();
+}
+
+uint32_t lora_raw_airtime_toa(uint8_t len)
+{
+    uint32_t toa;
+
+    __airtime_lock();
+    toa_table_refresh();
+    toa = s_airtime.toa[len];
+    __airtime_unlock();
+
+    return toa;
+}
+
+bool lora_raw_airtime_admit(uint8_t len)
+{
+    uint32_t freq = get_param(__LORA_RAW_PARAM_FREQ);
+    uint8_t policy = get_param(__LORA_RAW_PARAM_DUTY_POLICY);
+    bool queued = false;
+
+    for( ;; )
+    {
+        uint32_t toa, wait;
+        uint8_t b;
+
+        __airtime_lock();
+        toa_table_refresh();
+        window_refresh();
+        b = band_lookup(freq);
+        toa = s_airtime.toa[len];
+        wait = band_wait(b, toa);
+
+        if( wait == 0 || policy == __LORA_RAW_DUTY_WARN )
+        {
+            if( wait )
+            {
+                ++ s_airtime.exceeded;
+                __log_warn("duty-cycle budget exceeded, %d msec over, "
+                    "permitted in %d sec", toa, wait / 1000);
+            }
+            band_charge(b, toa);
+            __airtime_unlock();
+            return true;
+        }
+
+        if( policy == __LORA_RAW_DUTY_REJECT || wait == UINT32_MAX )
+        {
+            ++ s_airtime.rejected;
+            __airtime_unlock();
+            __log_warn("duty-cycle budget exceeded, message rejected");
+            return false;
+        }
+
+        if( ! queued )
+        {
+            ++ s_airtime.queued;
+            queued = true;
+        }
+        __airtime_unlock();
+
+        /* another caller may take the freed budget, hence the re-check */
+        __log_info("duty-cycle budget exceeded, message delayed %d msec",
+            wait);
+        lora_stub_delay_msec(wait);
+    }
+}
+
+void lora_raw_airtime_status(lora_raw_airtime_status_t* p_status)
+{
+    uint8_t len = p_status->len ? p_status->len :
+        get_param(__LORA_RAW_PARAM_PAYLOAD);
+    uint8_t b;
+
+    __airtime_lock();
+    toa_table_refresh();
+    window_refresh();
+    b = band_lookup(get_param(__LORA_RAW_PARAM_FREQ));
+
+    p_status->toa = s_airtime.toa[len];
+    p_status->wait = band_wait(b, p_status->toa);
+    p_status->used = band_used(b);
+    p_status->limit = band_limit(b);
+    p_status->remaining = p_status->limit > p_status->used ?
+        p_status->limit - p_status->used : 0;
+    p_status->duty = s_airtime.p_bands[b].duty;
+    p_status->band_low = s_airtime.p_bands[b].low;
+    p_status->band_high = s_airtime.p_bands[b].high;
+    p_status->total = s_airtime.total;
+    p_status->frames = s_airtime.frames;
+    p_status->exceeded = s_airtime.exceeded;
+    p_status->rejected = s_airtime.rejected;
+    p_status->queued = s_airtime.queued;
+    __airtime_unlock();
+}
+
+void lora_raw_airtime_stats(void)
+{
+    #define __temp(item, val_fmt, args...) \
+        log_list_item("%-15s: " val_fmt __default__, item, args)
+
+    static const char* policies[] = {
+        [__LORA_RAW_DUTY_WARN] = "warn",
+        [__LORA_RAW_DUTY_REJECT] = "reject",
+        [__LORA_RAW_DUTY_QUEUE] = "queue",
+    };
+    uint8_t policy = get_param(__LORA_RAW_PARAM_DUTY_POLICY);
+    lora_raw_airtime_status_t status = { .len = 0 };
+
+    lora_raw_airtime_status(&status);
+
+    log_list_start(4);
+
+    log_list_indent();
+    log_list_item(__blue__"airtime");
+    log_list_indent();
+        __temp("policy", __yellow__"%s",
+            policy <= __LORA_RAW_DUTY_QUEUE ? policies[policy] : "?");
+        __temp("duty", __yellow__"%.2f"__default__" %%",
+            status.duty / 100.0f);
+        __temp("used", __yellow__"%d"__default__" / %d msec per hour",
+            status.used, status.limit);
+        __temp("max_msg_toa", __yellow__"%d"__default__" msec", status.toa);
+        __temp("max_msg_wait", __yellow__"%d"__default__" msec",
+            status.wait == UINT32_MAX ? -1 : (int)status.wait);
+        __temp("total", __yellow__"%d"__default__" msec", status.total);
+        __temp("frames", __yellow__"%d", status.frames);
+        __temp("exceeded", __yellow__"%d", status.exceeded);
+        __temp("rejected", __yellow__"%d", status.rejected);
+        __temp("queued", __yellow__"%d", status.queued);
+    log_list_end();
+
+    #undef __temp
+}
+
+/* --- end of file ---------------------------------------------------------- */
@@ -0,0 +1,76 @@
+/** -------------------------------------------------------------------------- *
+ * Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @author  Ahmed Sabry (SG Wireless)
+ *
+ * @brief   lora-raw mode airtime accounting sub-component interface. It keeps
+ *          the airtime of the transmitted messages per regional sub-band
+ *          and enforces the sub-band duty-cycle budget.
+ * --------------------------------------------------------------------------- *
+ */
+#ifndef __LORA_RAW_AIRTIME_H__
+#define __LORA_RAW_AIRTIME_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** -------------------------------------------------------------------------- *
+ * includes
+ * --------------------------------------------------------------------------- *
+ */
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "lora.h"
+
+/** -------------------------------------------------------------------------- *
+ * APIs
+ * --------------------------------------------------------------------------- *
+ */
+
+void lora_raw_airtime_ctor(void);
+
+/**
+ * @brief   time on air in msec of a message of \a len bytes with the current
+ *          modulation parameters, it is read from a table built once per
+ *          modulation parameters change
+ */
+uint32_t lora_raw_airtime_toa(uint8_t len);
+
+/**
+ * @brief   admits a message of \a len bytes on the current frequency and
+ *          charges its airtime to the sub-band budget. It applies the duty
+ *          policy if the budget is exceeded, with the queue policy the caller
+ *          is blocked until the message is permitted.
+ * @return  false if the message is rejected
+ */
+bool lora_raw_airtime_admit(uint8_t len);
+
+void lora_raw_airtime_status(lora_raw_airtime_status_t* p_status);
+
+void lora_raw_airtime_stats(void);
+
+/* --- end of file ---------------------------------------------------------- */
+#ifdef __cplusplus
+}
+#endif
+#endif /* __LORA_RAW_AIRTIME_H__ */
@@ -0,0 +1,457 @@
+/** -------------------------------------------------------------------------- *
+ * Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @author  Ahmed Sabry (SG Wireless)
+ *
+ * @brief   lora-raw mode frequency hopping (hop) sub-component.
+ *
+ *          The time is divided into slots of the dwell time, and every slot
+ *          is assigned the next channel of a pseudo-random permutation of the
+ *          channel plan generated from the link seed. A message always starts
+ *          at a slot start, on the channel of its slot, so the channel is
+ *          known from the time only and the payload carries no hopping data.
+ *          A lost message does not break the sequence of the next ones.
+ *
+ *          The sender keeps its own slots timing, the receiver aligns its
+ *          timing to the start of every received message and hops a little
+ *          before the slot end to catch the next preamble. A node that has
+ *          not exchanged any message for the sync timeout parks on the first
+ *          channel of the sequence, and the first message of a parked sender
+ *          is sent there too, which synchronizes both.
+ * --------------------------------------------------------------------------- *
+ */
+
+/** -------------------------------------------------------------------------- *
+ * includes
+ * --------------------------------------------------------------------------- *
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#define __log_subsystem  lora
+#define __log_component  raw_hop
+#include "log_lib.h"
+
+#include "lora.h"
+#include "stub_system.h"
+#include "lora_raw_radio_if.h"
+#include "lora_raw_airtime.h"
+#include "lora_raw_hop.h"
+
+/** -------------------------------------------------------------------------- *
+ * hopping state
+ * --------------------------------------------------------------------------- *
+ */
+
+/* a message starts within the first half of the guard time of its slot, and
+ * the receiver moves to the next channel half of the guard time early */
+#define __hop_guard_ms              (20)
+#define __hop_default_sync_timeout  (60000)
+
+static struct {
+    void*       mutex;
+    volatile bool enabled;
+
+    uint8_t     count;
+    uint32_t    freqs[__LORA_RAW_HOP_MAX_CHANNELS];
+    uint8_t     seq[__LORA_RAW_HOP_MAX_CHANNELS];
+    uint32_t    dwell;
+    uint32_t    sync_timeout;
+
+    /* slots timing, slot_ts is the start of the absolute slot number */
+    bool        synced;
+    uint32_t    slot;
+    uint32_t    slot_ts;
+    uint32_t    sync_ts;
+
+    /* the slot the receiver listens to, or parked on the first channel */
+    uint32_t    rx_slot;
+    bool        rx_parked;
+    uint32_t    rx_freq;
+
+    uint32_t    tx_frames;
+    uint32_t    rx_frames;
+    uint32_t    tx_delays;
+    uint32_t    hops;
+    uint32_t    syncs;
+    uint32_t    adjusts;
+} s_hop;
+
+#define __hop_lock()    lora_stub_mutex_lock(s_hop.mutex)
+#define __hop_unlock()  lora_stub_mutex_unlock(s_hop.mutex)
+
+#define __slot_freq(_slot)  s_hop.freqs[ s_hop.seq[ (_slot) % s_hop.count ] ]
+
+/** -------------------------------------------------------------------------- *
+ * helpers
+ * --------------------------------------------------------------------------- *
+ */
+static uint32_t get_param(lora_raw_param_type_t type)
+{
+    lora_raw_param_t param = {.type = type};
+    lora_raw_radio_get_param( & param );
+
+    switch(type) {
+        case __LORA_RAW_PARAM_REGION:       return param.region;
+        case __LORA_RAW_PARAM_PAYLOAD:      return param.param.payload;
+        default:                            return 0;
+    }
+}
+
+/* Fisher-Yates shuffle driven by a xorshift generator, so every node derives
+ * the same sequence from the same seed */
+static void sequence_build(uint16_t seed)
+{
+    uint32_t x = ((uint32_t)seed << 16 | seed) ^ 0x9E3779B9u;
+    uint8_t i;
+
+    if( x == 0 )
+        x = 1;
+    for(i = 0; i < s_hop.count; ++i)
+        s_hop.seq[i] = i;
+
+    for(i = s_hop.count - 1; i > 0; --i)
+    {
+        uint8_t j, tmp;
+
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        j = x % (i + 1);
+        tmp = s_hop.seq[i];
+        s_hop.seq[i] = s_hop.seq[j];
+        s_hop.seq[j] = tmp;
+    }
+}
+
+/* moves the slots timing forward to the slot of 'now' */
+static void slot_advance(uint32_t now)
+{
+    int32_t diff = (int32_t)(now - s_hop.slot_ts);
+
+    if( diff >= (int32_t)s_hop.dwell )
+    {
+        uint32_t n = (uint32_t)diff / s_hop.dwell;
+        s_hop.slot += n;
+        s_hop.slot_ts += n * s_hop.dwell;
+    }
+}
+
+static void sync_check(uint32_t now)
+{
+    if( s_hop.synced && now - s_hop.sync_ts > s_hop.sync_timeout )
+    {
+        __log_info("no messages for %d msec, parked on the first channel",
+            s_hop.sync_timeout);
+        s_hop.synced = false;
+    }
+}
+
+/** -------------------------------------------------------------------------- *
+ * APIs implementations
+ * --------------------------------------------------------------------------- *
+ */
+void lora_raw_hop_ctor(void)
+{
+    if(s_hop.mutex == NULL)
+        s_hop.mutex = lora_stub_mutex_new();
+}
+
+bool lora_raw_hop_config(lora_raw_hop_cfg_t* p_cfg)
+{
+    lora_region_t region = get_param(__LORA_RAW_PARAM_REGION);
+    uint32_t dwell;
+    uint8_t i;
+
+    if( ! p_cfg->enable )
+    {
+        __hop_lock();
+        s_hop.enabled = false;
+        __hop_unlock();
+        __log_info("hopping disabled");
+        return true;
+    }
+
+    if( p_cfg->count == 0 )
+        p_cfg->count = lora_raw_radio_get_region_channels(region,
+            p_cfg->freqs, __LORA_RAW_HOP_MAX_CHANNELS);
+
+    if( p_cfg->count < 2 || p_cfg->count > __LORA_RAW_HOP_MAX_CHANNELS )
+    {
+        __log_error("invalid hopping channels count: %d", p_cfg->count);
+        return false;
+    }
+
+    for(i = 0; i < p_cfg->count; ++i)
+    {
+        lora_raw_param_t param = {
+            .type = __LORA_RAW_PARAM_FREQ,
+            .region = region,
+            .param.freq = p_cfg->freqs[i]
+        };
+        if( lora_raw_radio_verify_param(&param) != __LORA_OK )
+        {
+            __log_error("invalid hopping channel: %d Hz", p_cfg->freqs[i]);
+            return false;
+        }
+    }
+
+    dwell = p_cfg->dwell ? p_cfg->dwell :
+        lora_raw_airtime_toa(get_param(__LORA_RAW_PARAM_PAYLOAD)) +
+        __hop_guard_ms;
+    if( dwell < 2 * __hop_guard_ms )
+        dwell = 2 * __hop_guard_ms;
+    p_cfg->dwell = dwell;
+
+    __hop_lock();
+    s_hop.count = p_cfg->count;
+    memcpy(s_hop.freqs, p_cfg->freqs, p_cfg->count * sizeof(uint32_t));
+    sequence_build(p_cfg->seed);
+    s_hop.dwell = dwell;
+    s_hop.sync_timeout = p_cfg->sync_timeout ? p_cfg->sync_timeout :
+        __hop_default_sync_timeout;
+    s_hop.synced = false;
+    s_hop.slot = 0;
+    s_hop.slot_ts = lora_stub_get_timestamp_ms();
+    s_hop.rx_freq = 0;
+    s_hop.enabled = true;
+    __hop_unlock();
+
+    __log_info("hopping enabled, %d channels, seed: %d, dwell: %d msec",
+        p_cfg->count, p_cfg->seed, dwell);
+
+    return true;
+}
+
+bool lora_raw_hop_is_enabled(void)
+{
+    return s_hop.enabled;
+}
+
+void lora_raw_hop_tx_align(void)
+{
+    bool delayed = false;
+
+    for( ;; )
+    {
+        uint32_t now, offset;
+
+        __hop_lock();
+        now = lora_stub_get_timestamp_ms();
+        sync_check(now);
+
+        /* a node without a timing starts its own one with this message */
+        if( ! s_hop.enabled || ! s_hop.synced )
+        {
+            __hop_unlock();
+            return;
+        }
+
+        slot_advance(now);
+        offset = now - s_hop.slot_ts;
+        if( offset <= __hop_guard_ms / 2 )
+        {
+            __hop_unlock();
+            return;
+        }
+
+        if( ! delayed )
+        {
+            ++ s_hop.tx_delays;
+            delayed = true;
+        }
+        __hop_unlock();
+
+        /* the delay may wake up early, hence the re-check */
+        lora_stub_delay_msec(s_hop.dwell - offset);
+    }
+}
+
+uint32_t lora_raw_hop_tx_channel(void)
+{
+    uint32_t now;
+    uint32_t freq;
+
+    __hop_lock();
+    now = lora_stub_get_timestamp_ms();
+    sync_check(now);
+
+    if( ! s_hop.synced )
+    {
+        /* the first message goes on the channel the parked nodes listen to */
+        s_hop.slot = 0;
+        s_hop.slot_ts = now;
+        s_hop.synced = true;
+    }
+    slot_advance(now);
+
+    s_hop.sync_ts = now;
+    ++ s_hop.tx_frames;
+    freq = __slot_freq(s_hop.slot);
+    __hop_unlock();
+
+    __log_debug("tx slot %d -> %d Hz", s_hop.slot, freq);
+
+    return freq;
+}
+
+uint32_t lora_raw_hop_rx_channel(uint32_t* p_hop_in)
+{
+    uint32_t now;
+    uint32_t freq;
+    uint32_t hop_at;
+
+    __hop_lock();
+    now = lora_stub_get_timestamp_ms();
+    sync_check(now);
+
+    if( ! s_hop.synced )
+    {
+        s_hop.rx_parked = true;
+        freq = __slot_freq(0);
+        *p_hop_in = 0;
+    }
+    else
+    {
+        slot_advance(now);
+        s_hop.rx_parked = false;
+        s_hop.rx_slot = s_hop.slot;
+        hop_at = s_hop.slot_ts + s_hop.dwell - __hop_guard_ms / 2;
+        if( (int32_t)(now - hop_at) >= 0 )
+        {
+            ++ s_hop.rx_slot;
+            hop_at += s_hop.dwell;
+        }
+        freq = __slot_freq(s_hop.rx_slot);
+        *p_hop_in = hop_at - now;
+    }
+
+    if( freq != s_hop.rx_freq )
+    {
+        ++ s_hop.hops;
+        s_hop.rx_freq = freq;
+    }
+    __hop_unlock();
+
+    return freq;
+}
+
+void lora_raw_hop_rx_sync(uint32_t rx_done_ts, uint8_t len)
+{
+    uint32_t start = rx_done_ts - lora_raw_airtime_toa(len);
+
+    __hop_lock();
+    if( s_hop.rx_parked )
+    {
+        s_hop.slot = 0;
+        s_hop.slot_ts = start;
+        s_hop.synced = true;
+        ++ s_hop.syncs;
+        __log_info("synchronized on the first channel");
+    }
+    else
+    {
+        uint32_t expected = s_hop.slot_ts +
+            (int32_t)(s_hop.rx_slot - s_hop.slot) * (int32_t)s_hop.dwell;
+        int32_t offset = (int32_t)(start - expected);
+
+        if( offset < -(__hop_guard_ms / 2) || offset > __hop_guard_ms )
+        {
+            s_hop.slot = s_hop.rx_slot;
+            s_hop.slot_ts = start;
+            ++ s_hop.adjusts;
+            __log_debug("slots timing adjusted by %d msec", offset);
+        }
+    }
+    s_hop.sync_ts = lora_stub_get_timestamp_ms();
+    ++ s_hop.rx_frames;
+    __hop_unlock();
+}
+
+void lora_raw_hop_status(lora_raw_hop_status_t* p_status)
+{
+    uint32_t now;
+    uint8_t i;
+
+    __hop_lock();
+    now = lora_stub_get_timestamp_ms();
+    p_status->enabled = s_hop.enabled;
+    p_status->count = s_hop.count;
+    p_status->dwell = s_hop.dwell;
+    p_status->channel = 0;
+    p_status->freq = 0;
+    if( s_hop.count )
+    {
+        sync_check(now);
+        slot_advance(now);
+        i = s_hop.seq[ s_hop.synced ? s_hop.slot % s_hop.count : 0 ];
+        p_status->channel = i;
+        p_status->freq = s_hop.freqs[i];
+    }
+    p_status->synced = s_hop.synced;
+    p_status->tx_frames = s_hop.tx_frames;
+    p_status->rx_frames = s_hop.rx_frames;
+    p_status->tx_delays = s_hop.tx_delays;
+    p_status->hops = s_hop.hops;
+    p_status->syncs = s_hop.syncs;
+    p_status->adjusts = s_hop.adjusts;
+    __hop_unlock();
+}
+
+void lora_raw_hop_stats(void)
+{
+    #define __temp(item, val_fmt, args...) \
+        log_list_item("%-15s: " val_fmt __default__, item, args)
+
+    lora_raw_hop_status_t status;
+    uint8_t i;
+
+    lora_raw_hop_status(&status);
+
+    log_list_start(4);
+
+    log_list_indent();
+    log_list_item(__blue__"hopping");
+    log_list_indent();
+        __temp("enabled", __yellow__"%s", status.enabled ? "yes" : "no");
+        __temp("synced", __yellow__"%s", status.synced ? "yes" : "no");
+        __temp("dwell", __yellow__"%d"__default__" msec", status.dwell);
+        __temp("channel", __yellow__"%d"__default__" -> %d Hz",
+            status.channel, status.freq);
+        __temp("tx_frames", __yellow__"%d", status.tx_frames);
+        __temp("rx_frames", __yellow__"%d", status.rx_frames);
+        __temp("tx_delays", __yellow__"%d", status.tx_delays);
+        __temp("hops", __yellow__"%d", status.hops);
+        __temp("syncs", __yellow__"%d", status.syncs);
+        __temp("adjusts", __yellow__"%d", status.adjusts);
+        log_list_item("sequence");
+        log_list_indent();
+        for(i = 0; i < status.count; ++i)
+            __temp("", __yellow__"%d"__default__" -> %d Hz",
+                s_hop.seq[i], s_hop.freqs[s_hop.seq[i]]);
+        log_list_outdent();
+    log_list_end();
+
+    #undef __temp
+}
+
+/* --- end of file ---------------------------------------------------------- */
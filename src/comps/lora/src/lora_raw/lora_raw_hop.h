@@ -0,0 +1,99 @@
+/** -------------------------------------------------------------------------- *
+ * Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @author  Ahmed Sabry (SG Wireless)
+ *
+ * @brief   lora-raw mode frequency hopping (hop) sub-component interface.
+ *          It keeps the hop slots timing and tells the raw process which
+ *          channel to use for every transmission and reception.
+ * --------------------------------------------------------------------------- *
+ */
+#ifndef __LORA_RAW_HOP_H__
+#define __LORA_RAW_HOP_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** -------------------------------------------------------------------------- *
+ * includes
+ * --------------------------------------------------------------------------- *
+ */
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "lora.h"
+
+/** -------------------------------------------------------------------------- *
+ * APIs
+ * --------------------------------------------------------------------------- *
+ */
+
+void lora_raw_hop_ctor(void);
+
+/**
+ * @brief   enables the hopping over the given or the region default channels
+ *          or disables it, the used channels are written back to \a p_cfg
+ * @return  false on an invalid channel plan
+ */
+bool lora_raw_hop_config(lora_raw_hop_cfg_t* p_cfg);
+
+bool lora_raw_hop_is_enabled(void);
+
+/**
+ * @brief   blocks the caller until the next slot start, unless the present
+ *          slot has just started or the node is not synchronized
+ */
+void lora_raw_hop_tx_align(void);
+
+/**
+ * @brief   the channel of a message sent now, the sender keeps the slots
+ *          timing it transmits with
+ */
+uint32_t lora_raw_hop_tx_channel(void);
+
+/**
+ * @brief   the channel to listen to now
+ * @param   p_hop_in   msec until the next channel, zero while waiting for the
+ *                     synchronization on the first channel of the sequence
+ */
+uint32_t lora_raw_hop_rx_channel(uint32_t* p_hop_in);
+
+/**
+ * @brief   aligns the slots timing to a message received on the channel
+ *          returned by the last lora_raw_hop_rx_channel()
+ * @param   rx_done_ts  the rx-done irq timestamp in msec
+ * @param   len         the message length
+ */
+void lora_raw_hop_rx_sync(uint32_t rx_done_ts, uint8_t len);
+
+void lora_raw_hop_status(lora_raw_hop_status_t* p_status);
+
+/**
+ * @brief   displays the channel plan and the hopping counters
+ */
+void lora_raw_hop_stats(void);
+
+/* --- end of file ---------------------------------------------------------- */
+#ifdef __cplusplus
+}
+#endif
+#endif /* __LORA_RAW_HOP_H__ */
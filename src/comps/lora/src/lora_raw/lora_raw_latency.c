@@ -0,0 +1,292 @@
+/** -------------------------------------------------------------------------- *
+ * Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @author  Ahmed Sabry (SG Wireless)
+ *
+ * @brief   lora-raw mode latency statistics sub-component.
+ *
+ *          The radio handles one message at a time, so one trace per direction
+ *          is filled with the usec timestamps of its points, and the complete
+ *          traces are accounted as the durations between the consecutive
+ *          points (the stages). Every stage keeps its minimum, mean and
+ *          maximum since the boot, and a window of the latest durations from
+ *          which the percentiles are computed on display.
+ * --------------------------------------------------------------------------- *
+ */
+
+/** -------------------------------------------------------------------------- *
+ * includes
+ * --------------------------------------------------------------------------- *
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#define __log_subsystem  lora
+#define __log_component  raw_latency
+#include "log_lib.h"
+
+#include "stub_system.h"
+#include "lora_raw_latency.h"
+
+/** -------------------------------------------------------------------------- *
+ * stages statistics
+ * --------------------------------------------------------------------------- *
+ */
+#ifdef CONFIG_LORA_RAW_LATENCY_WINDOW
+    #define __lat_window    CONFIG_LORA_RAW_LATENCY_WINDOW
+#else
+    #define __lat_window    (64u)
+#endif
+
+/* a trace is dropped if a stage looks longer than this, it is a missed point
+ * rather than a real duration */
+#define __lat_max_stage_us  (60u * 1000u * 1000u)
+
+typedef struct {
+    uint32_t    count;
+    uint32_t    min;
+    uint32_t    max;
+    uint64_t    sum;
+    uint32_t    window[__lat_window];
+} lat_stage_t;
+
+typedef struct {
+    uint32_t    ts[__LORA_RAW_LAT_TX_POINTS];
+    uint32_t    marked;     /* bit mask of the stamped points */
+} lat_trace_t;
+
+/* the stage ending at every point, the first point starts the trace */
+static const char* s_tx_stages[__LORA_RAW_LAT_TX_POINTS] = {
+    [__LORA_RAW_LAT_TX_QUEUE]       = "api->queue",
+    [__LORA_RAW_LAT_TX_DISPATCH]    = "queue->proc",
+    [__LORA_RAW_LAT_TX_SM]          = "proc->sm",
+    [__LORA_RAW_LAT_TX_RADIO]       = "sm->radio",
+    [__LORA_RAW_LAT_TX_SENT]        = "radio-write",
+    [__LORA_RAW_LAT_TX_IRQ]         = "on-air",
+    [__LORA_RAW_LAT_TX_CALLBACK]    = "irq->cb",
+};
+static const char* s_rx_stages[__LORA_RAW_LAT_RX_POINTS] = {
+    [__LORA_RAW_LAT_RX_IRQ_DISPATCH]    = "irq->proc",
+    [__LORA_RAW_LAT_RX_QUEUE]           = "radio-read",
+    [__LORA_RAW_LAT_RX_DISPATCH]        = "queue->proc",
+    [__LORA_RAW_LAT_RX_SM]              = "proc->sm",
+    [__LORA_RAW_LAT_RX_CALLBACK]        = "sm->cb",
+};
+
+static struct {
+    void*           mutex;
+
+    lat_trace_t     tx;
+    lat_trace_t     rx;
+    uint32_t        irq_dispatch_ts;
+
+    /* the last stage of every table is the total */
+    lat_stage_t     tx_stages[__LORA_RAW_LAT_TX_POINTS];
+    lat_stage_t     rx_stages[__LORA_RAW_LAT_RX_POINTS];
+    uint32_t        tx_dropped;
+    uint32_t        rx_dropped;
+} s_lat;
+
+#define __lat_lock()    lora_stub_mutex_lock(s_lat.mutex)
+#define __lat_unlock()  lora_stub_mutex_unlock(s_lat.mutex)
+
+extern uint32_t sx126x_port_get_irq_timestamp_us(void);
+
+/** -------------------------------------------------------------------------- *
+ * helpers
+ * --------------------------------------------------------------------------- *
+ */
+static void stage_add(lat_stage_t* p_stage, uint32_t us)
+{
+    if( p_stage->count == 0 || us < p_stage->min )
+        p_stage->min = us;
+    if( us > p_stage->max )
+        p_stage->max = us;
+    p_stage->sum += us;
+    p_stage->window[p_stage->count % __lat_window] = us;
+    ++ p_stage->count;
+}
+
+/* the stages of a complete trace are accounted together, so all the tables
+ * count the same messages */
+static bool trace_account(lat_trace_t* p_trace, lat_stage_t* p_stages,
+    uint8_t points)
+{
+    uint32_t us[__LORA_RAW_LAT_TX_POINTS];
+    uint8_t i;
+
+    if( p_trace->marked != (1u << points) - 1 )
+        return false;
+
+    for(i = 1; i < points; ++i)
+    {
+        us[i] = p_trace->ts[i] - p_trace->ts[i - 1];
+        if( us[i] > __lat_max_stage_us )
+            return false;
+    }
+
+    for(i = 1; i < points; ++i)
+        stage_add(&p_stages[i], us[i]);
+    stage_add(&p_stages[0], p_trace->ts[points - 1] - p_trace->ts[0]);
+    return true;
+}
+
+static uint32_t window_percentile(uint32_t* sorted, uint32_t n, uint8_t pct)
+{
+    return sorted[(n - 1) * pct / 100];
+}
+
+static void stages_display(const char* title, const char** names,
+    lat_stage_t* p_stages, uint8_t points, uint32_t dropped)
+{
+    static uint32_t sorted[__lat_window];
+    uint8_t i;
+
+    log_list_indent();
+    log_list_item(__blue__"%s"__default__" (usec, %u messages, %u dropped)",
+        title, p_stages[0].count, dropped);
+    log_list_indent();
+    log_list_item("%-12s %8s %8s %8s %8s %8s %8s", "stage",
+        "min", "mean", "p50", "p90", "p99", "max");
+
+    for(i = 1; i <= points; ++i)
+    {
+        /* the total comes last */
+        lat_stage_t* p_stage = &p_stages[i < points ? i : 0];
+        uint32_t n, j, k;
+
+        __lat_lock();
+        n = p_stage->count < __lat_window ? p_stage->count : __lat_window;
+        memcpy(sorted, p_stage->window, n * sizeof(uint32_t));
+        __lat_unlock();
+
+        if( n == 0 )
+            continue;
+
+        for(j = 1; j < n; ++j)
+        {
+            uint32_t v = sorted[j];
+            for(k = j; k > 0 && sorted[k - 1] > v; --k)
+                sorted[k] = sorted[k - 1];
+            sorted[k] = v;
+        }
+
+        log_list_item(__yellow__"%-12s"__default__" %8u %8u %8u %8u %8u %8u",
+            i < points ? names[i] : "total", p_stage->min,
+            (uint32_t)(p_stage->sum / p_stage->count),
+            window_percentile(sorted, n, 50), window_percentile(sorted, n, 90),
+            window_percentile(sorted, n, 99), p_stage->max);
+    }
+    log_list_outdent();
+    log_list_outdent();
+}
+
+/** -------------------------------------------------------------------------- *
+ * APIs implementations
+ * --------------------------------------------------------------------------- *
+ */
+void lora_raw_latency_ctor(void)
+{
+    if(s_lat.mutex == NULL)
+        s_lat.mutex = lora_stub_mutex_new();
+}
+
+void lora_raw_latency_tx_start(uint32_t api_ts, uint32_t queue_ts)
+{
+    s_lat.tx.ts[__LORA_RAW_LAT_TX_API] = api_ts ? api_ts : queue_ts;
+    s_lat.tx.ts[__LORA_RAW_LAT_TX_QUEUE] = queue_ts;
+    s_lat.tx.ts[__LORA_RAW_LAT_TX_DISPATCH] = lora_stub_get_timestamp_us();
+    s_lat.tx.marked = (1u << __LORA_RAW_LAT_TX_API) |
+        (1u << __LORA_RAW_LAT_TX_QUEUE) | (1u << __LORA_RAW_LAT_TX_DISPATCH);
+}
+
+void lora_raw_latency_tx_mark(lora_raw_latency_tx_point_t point)
+{
+    /* the points out of a trace are left, like the burst frames ones */
+    if( s_lat.tx.marked == 0 )
+        return;
+    s_lat.tx.ts[point] = point == __LORA_RAW_LAT_TX_IRQ ?
+        sx126x_port_get_irq_timestamp_us() : lora_stub_get_timestamp_us();
+    s_lat.tx.marked |= 1u << point;
+}
+
+void lora_raw_latency_tx_end(void)
+{
+    if( s_lat.tx.marked == 0 )
+        return;
+    lora_raw_latency_tx_mark(__LORA_RAW_LAT_TX_CALLBACK);
+
+    __lat_lock();
+    if( ! trace_account(&s_lat.tx, s_lat.tx_stages, __LORA_RAW_LAT_TX_POINTS) )
+        ++ s_lat.tx_dropped;
+    __lat_unlock();
+    s_lat.tx.marked = 0;
+}
+
+void lora_raw_latency_irq_dispatch(void)
+{
+    s_lat.irq_dispatch_ts = lora_stub_get_timestamp_us();
+}
+
+void lora_raw_latency_rx_start(uint32_t queue_ts)
+{
+    s_lat.rx.ts[__LORA_RAW_LAT_RX_IRQ] = sx126x_port_get_irq_timestamp_us();
+    s_lat.rx.ts[__LORA_RAW_LAT_RX_IRQ_DISPATCH] = s_lat.irq_dispatch_ts;
+    s_lat.rx.ts[__LORA_RAW_LAT_RX_QUEUE] = queue_ts;
+    s_lat.rx.ts[__LORA_RAW_LAT_RX_DISPATCH] = lora_stub_get_timestamp_us();
+    s_lat.rx.marked = (1u << __LORA_RAW_LAT_RX_IRQ) |
+        (1u << __LORA_RAW_LAT_RX_IRQ_DISPATCH) |
+        (1u << __LORA_RAW_LAT_RX_QUEUE) | (1u << __LORA_RAW_LAT_RX_DISPATCH);
+}
+
+void lora_raw_latency_rx_mark(lora_raw_latency_rx_point_t point)
+{
+    if( s_lat.rx.marked == 0 )
+        return;
+    s_lat.rx.ts[point] = lora_stub_get_timestamp_us();
+    s_lat.rx.marked |= 1u << point;
+}
+
+void lora_raw_latency_rx_end(void)
+{
+    if( s_lat.rx.marked == 0 )
+        return;
+    lora_raw_latency_rx_mark(__LORA_RAW_LAT_RX_CALLBACK);
+
+    __lat_lock();
+    if( ! trace_account(&s_lat.rx, s_lat.rx_stages, __LORA_RAW_LAT_RX_POINTS) )
+        ++ s_lat.rx_dropped;
+    __lat_unlock();
+    s_lat.rx.marked = 0;
+}
+
+void lora_raw_latency_stats(void)
+{
+    log_list_start(4);
+    stages_display("tx latency", s_tx_stages, s_lat.tx_stages,
+        __LORA_RAW_LAT_TX_POINTS, s_lat.tx_dropped);
+    stages_display("rx latency", s_rx_stages, s_lat.rx_stages,
+        __LORA_RAW_LAT_RX_POINTS, s_lat.rx_dropped);
+    log_list_end();
+}
+
+/* --- end of file ---------------------------------------------------------- */
@@ -0,0 +1,116 @@
+/** -------------------------------------------------------------------------- *
+ * Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @author  Ahmed Sabry (SG Wireless)
+ *
+ * @brief   lora-raw mode latency statistics sub-component interface. It takes
+ *          the timestamps of the stages a message goes through between the
+ *          application and the radio, in both directions.
+ * --------------------------------------------------------------------------- *
+ */
+#ifndef __LORA_RAW_LATENCY_H__
+#define __LORA_RAW_LATENCY_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** -------------------------------------------------------------------------- *
+ * includes
+ * --------------------------------------------------------------------------- *
+ */
+#include <stdint.h>
+#include <stdbool.h>
+
+/** -------------------------------------------------------------------------- *
+ * types
+ * --------------------------------------------------------------------------- *
+ */
+typedef enum {
+    __LORA_RAW_LAT_TX_API,      /* lora_raw_tx() is called */
+    __LORA_RAW_LAT_TX_QUEUE,    /* the order is queued to the process */
+    __LORA_RAW_LAT_TX_DISPATCH, /* the process takes the order */
+    __LORA_RAW_LAT_TX_SM,       /* the state machine starts the tx */
+    __LORA_RAW_LAT_TX_RADIO,    /* the message is handed to the radio */
+    __LORA_RAW_LAT_TX_SENT,     /* the radio has written the message */
+    __LORA_RAW_LAT_TX_IRQ,      /* the tx-done dio interrupt */
+    __LORA_RAW_LAT_TX_CALLBACK, /* the application is notified */
+    __LORA_RAW_LAT_TX_POINTS
+} lora_raw_latency_tx_point_t;
+
+typedef enum {
+    __LORA_RAW_LAT_RX_IRQ,      /* the rx-done dio interrupt */
+    __LORA_RAW_LAT_RX_IRQ_DISPATCH, /* the process takes the irq order */
+    __LORA_RAW_LAT_RX_QUEUE,    /* the radio has read the message */
+    __LORA_RAW_LAT_RX_DISPATCH, /* the process takes the rx-done order */
+    __LORA_RAW_LAT_RX_SM,       /* the state machine handles the rx-done */
+    __LORA_RAW_LAT_RX_CALLBACK, /* the application is notified */
+    __LORA_RAW_LAT_RX_POINTS
+} lora_raw_latency_rx_point_t;
+
+/** -------------------------------------------------------------------------- *
+ * APIs
+ * --------------------------------------------------------------------------- *
+ */
+
+void lora_raw_latency_ctor(void);
+
+/**
+ * @brief   starts the trace of a message dispatched by the process
+ * @param   api_ts      usec timestamp of the api call, zero if the message
+ *                      did not come through lora_raw_tx()
+ * @param   queue_ts    usec timestamp of the order request
+ */
+void lora_raw_latency_tx_start(uint32_t api_ts, uint32_t queue_ts);
+
+/**
+ * @brief   stamps a point of the present message, the irq point takes the
+ *          dio interrupt timestamp
+ */
+void lora_raw_latency_tx_mark(lora_raw_latency_tx_point_t point);
+
+/**
+ * @brief   stamps the callback point and accounts the complete trace
+ */
+void lora_raw_latency_tx_end(void);
+
+/**
+ * @brief   stamps the dispatch of a radio irq order, the received message
+ *          trace starts from the last one
+ */
+void lora_raw_latency_irq_dispatch(void);
+
+void lora_raw_latency_rx_start(uint32_t queue_ts);
+
+void lora_raw_latency_rx_mark(lora_raw_latency_rx_point_t point);
+
+void lora_raw_latency_rx_end(void);
+
+/**
+ * @brief   displays the stages latency tables
+ */
+void lora_raw_latency_stats(void);
+
+/* --- end of file ---------------------------------------------------------- */
+#ifdef __cplusplus
+}
+#endif
+#endif /* __LORA_RAW_LATENCY_H__ */
@@ -39,7 +39,13 @@
 
 #include "lora.h"
 #include "lora_raw_process.h"
+#include "lora_raw_xfer.h"
+#include "lora_raw_airtime.h"
+#include "lora_raw_adapt.h"
+#include "lora_raw_hop.h"
+#include "lora_raw_latency.h"
 #include "lora_raw_radio_if.h"
+#include "stub_system.h"
 #include "lora_mode.h"
 
 /** -------------------------------------------------------------------------- *
@@ -53,6 +59,10 @@ static lora_error_t lora_raw_ctor(void)
     __log_info("lora raw ctor()");
     lora_raw_radio_ctor();
     lora_raw_process_ctor();
+    lora_raw_airtime_ctor();
+    lora_raw_adapt_ctor();
+    lora_raw_hop_ctor();
+    lora_raw_latency_ctor();
 
     return ret;
 }
@@ -74,6 +84,11 @@ static lora_error_t lora_raw_stats(void)
 
     __log_info("lora raw stats()");
     lora_raw_radio_stats();
+    lora_raw_process_stats();
+    lora_raw_airtime_stats();
+    lora_raw_adapt_stats();
+    lora_raw_hop_stats();
+    lora_raw_latency_stats();
 
     return ret;
 }
@@ -81,16 +96,28 @@ static lora_error_t lora_raw_stats(void)
 static lora_error_t lora_raw_tx(lora_tx_params_t * p_tx_params)
 {
     lora_error_t ret = __LORA_OK;
+    uint32_t api_ts = lora_stub_get_timestamp_us();
 
     __log_info("lora raw send()");
 
-    if(p_tx_params->len && p_tx_params->buf) {
+    /* the airtime is charged before the message is queued or sent, with the
+     * queue policy the caller waits here for the budget */
+    if(p_tx_params->len && p_tx_params->buf &&
+        ! lora_raw_airtime_admit(p_tx_params->len)) {
+        ret = __LORA_DUTY_CYCLE_EXCEEDED;
+    } else if(p_tx_params->len && p_tx_params->buf &&
+        lora_raw_process_burst_is_active() && ! lora_raw_hop_is_enabled()) {
+        /* the hopping sends a message per slot, the burst frames can not be
+         * chained and go one by one below */
+        lora_raw_process_burst_send(p_tx_params->buf, p_tx_params->len);
+    } else if(p_tx_params->len && p_tx_params->buf) {
         lora_raw_process_event_payload_t tx_msg = {
             .type = __PROCESS_MSG_PAYLOAD_TX_REQ,
             .tx_payload = {
                 .buf = p_tx_params->buf,
                 .len = p_tx_params->len,
-                .timeout = p_tx_params->timeout
+                .timeout = p_tx_params->timeout,
+                .api_ts = api_ts
             },
         };
         lora_raw_process_event(__LORA_RAW_PROCESS_TX_REQUEST, &tx_msg,
@@ -173,6 +200,88 @@ static lora_error_t lora_raw_ioctl(uint32_t ioctl, void* arg)
         lora_raw_process_event(__LORA_RAW_PROCESS_RADIO_TX_CONT_WAVE_END, NULL,
             false);
     }
+    else if( ioctl == __LORA_IOCTL_TX_BURST_START )
+    {
+        __log_info("ioctl -> tx-burst-start");
+        lora_raw_process_burst_start();
+    }
+    else if( ioctl == __LORA_IOCTL_TX_BURST_STOP )
+    {
+        __log_info("ioctl -> tx-burst-stop");
+        lora_raw_process_burst_stop();
+    }
+    else if( ioctl == __LORA_IOCTL_RX_RING_SET )
+    {
+        __log_info("ioctl -> rx-ring-set");
+        lora_raw_process_rx_ring_set(arg);
+    }
+    else if( ioctl == __LORA_IOCTL_RX_RING_READ )
+    {
+        if( ! lora_raw_process_rx_ring_read(arg) )
+            ret = __LORA_ERROR;
+    }
+    else if( ioctl == __LORA_IOCTL_RX_RING_STATUS )
+    {
+        lora_raw_process_rx_ring_status(arg);
+    }
+    else if( ioctl == __LORA_IOCTL_CAD_SCAN )
+    {
+        __log_info("ioctl -> cad-scan");
+        if( ! lora_raw_process_cad_scan(arg) )
+            ret = __LORA_ERROR;
+    }
+    else if( ioctl == __LORA_IOCTL_LBT_STATS )
+    {
+        lora_raw_process_lbt_stats(arg);
+    }
+    else if( ioctl == __LORA_IOCTL_XFER_SEND )
+    {
+        __log_info("ioctl -> xfer-send");
+        if( ! lora_raw_xfer_send(arg) )
+            ret = __LORA_ERROR;
+    }
+    else if( ioctl == __LORA_IOCTL_XFER_RECV )
+    {
+        __log_info("ioctl -> xfer-recv");
+        if( ! lora_raw_xfer_recv(arg) )
+            ret = __LORA_ERROR;
+    }
+    else if( ioctl == __LORA_IOCTL_AIRTIME_STATUS )
+    {
+        lora_raw_airtime_status(arg);
+    }
+    else if( ioctl == __LORA_IOCTL_ADAPT_CONFIG )
+    {
+        __log_info("ioctl -> adapt-config");
+        lora_raw_adapt_config(arg);
+    }
+    else if( ioctl == __LORA_IOCTL_ADAPT_SEND )
+    {
+        if( ! lora_raw_adapt_send(arg) )
+            ret = __LORA_ERROR;
+    }
+    else if( ioctl == __LORA_IOCTL_ADAPT_RECV )
+    {
+        if( ! lora_raw_adapt_recv(arg) )
+            ret = __LORA_ERROR;
+    }
+    else if( ioctl == __LORA_IOCTL_ADAPT_STATUS )
+    {
+        lora_raw_adapt_status(arg);
+    }
+    else if( ioctl == __LORA_IOCTL_HOP_CONFIG )
+    {
+        __log_info("ioctl -> hop-config");
+        if( ! lora_raw_hop_config(arg) )
+            ret = __LORA_ERROR;
+        else
+            /* a running reception moves to the new channel right away */
+            lora_raw_process_event(__LORA_RAW_PROCESS_HOP_EXPIRE, NULL, false);
+    }
+    else if( ioctl == __LORA_IOCTL_HOP_STATUS )
+    {
+        lora_raw_hop_status(arg);
+    }
     else if( ioctl == __LORA_IOCTL_SET_PARAM )
     {
         __log_info("ioctl -> set-radio-param");
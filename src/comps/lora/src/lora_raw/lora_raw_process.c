@@ -44,8 +44,11 @@
 #include "system/timer.h"
 #include "lora_raw_process.h"
 #include "lora_raw_radio_if.h"
+#include "lora_raw_hop.h"
+#include "lora_raw_latency.h"
 #include "lora_raw_state_machine.h"
 #include "adt_list.h"
+#include "utilities.h"
 
 /** -------------------------------------------------------------------------- *
  * process orders management
@@ -58,6 +61,7 @@ typedef struct _order_s {
     lora_raw_process_event_t            req_type;
     bool                                sync;
     sync_obj_t                          sync_obj;
+    uint32_t                            queue_ts;   /* usec */
 
     enum {
         __FREE,
@@ -113,6 +117,7 @@ static order_t* order_request(
             p_order->req_type = req_type;
             p_order->sync = sync;
             p_order->sync_obj = sync_obj;
+            p_order->queue_ts = lora_stub_get_timestamp_us();
             if(req_payload)
                 p_order->request_payload = *req_payload;
             __order_access_unlock();
@@ -224,6 +229,256 @@ static void rx_buffer_copy_to(uint8_t * buf, uint8_t buf_len, uint8_t* p_len)
     *p_len = copy_len;
 }
 
+/** -------------------------------------------------------------------------- *
+ * rx ring, it keeps the received frames until the application drains them
+ * --------------------------------------------------------------------------- *
+ */
+#ifdef CONFIG_LORA_RAW_RX_RING_SLOTS
+    #define __rx_ring_slots     CONFIG_LORA_RAW_RX_RING_SLOTS
+#else
+    #define __rx_ring_slots     (8u)
+#endif
+
+static struct {
+    volatile bool               enabled;
+    uint8_t                     batch;
+    bool                        batch_raised;   /* waits for the re-arm */
+    lora_raw_rx_ring_frame_t    slots[__rx_ring_slots];
+    uint32_t                    head;
+    volatile uint32_t           count;
+    uint32_t                    pending_overruns; /* since the last stored */
+    void*                       mutex;
+    void*                       sem;            /* signaled on a stored frame */
+
+    /* totals since the process construction */
+    uint32_t                    stored;
+    uint32_t                    overruns;
+} s_rx_ring;
+
+#define __rx_ring_lock()    lora_stub_mutex_lock(s_rx_ring.mutex)
+#define __rx_ring_unlock()  lora_stub_mutex_unlock(s_rx_ring.mutex)
+
+static void rx_ring_ctor(void)
+{
+    if(s_rx_ring.mutex == NULL)
+        s_rx_ring.mutex = lora_stub_mutex_new();
+    if(s_rx_ring.sem == NULL)
+        s_rx_ring.sem = lora_stub_sem_new();
+}
+
+/**
+ * stores a received frame, if the ring is full the frame is dropped and
+ * counted against the next stored frame. It returns true when the frames
+ * count reaches the configured batch size.
+ */
+static bool rx_ring_push(
+    uint8_t* buf, uint8_t len, int8_t rssi, int8_t snr, uint32_t timestamp)
+{
+    bool batch_ready = false;
+    bool stored = false;
+    __rx_ring_lock();
+    if(s_rx_ring.count < __rx_ring_slots) {
+        lora_raw_rx_ring_frame_t* p_slot = & s_rx_ring.slots[
+            (s_rx_ring.head + s_rx_ring.count) % __rx_ring_slots];
+        memcpy(p_slot->buf, buf, len);
+        p_slot->len = len;
+        p_slot->rssi = rssi;
+        p_slot->snr = snr;
+        p_slot->timestamp = timestamp;
+        p_slot->overruns = s_rx_ring.pending_overruns;
+        s_rx_ring.pending_overruns = 0;
+        ++ s_rx_ring.count;
+        ++ s_rx_ring.stored;
+        stored = true;
+    } else {
+        ++ s_rx_ring.pending_overruns;
+        ++ s_rx_ring.overruns;
+    }
+    if(s_rx_ring.batch && ! s_rx_ring.batch_raised &&
+        s_rx_ring.count >= s_rx_ring.batch) {
+        s_rx_ring.batch_raised = true;
+        batch_ready = true;
+    }
+    __rx_ring_unlock();
+
+    /* wakes up a reader blocked on the ring */
+    if(stored)
+        lora_stub_sem_signal(s_rx_ring.sem);
+    return batch_ready;
+}
+
+static bool rx_ring_pop(lora_raw_rx_ring_frame_t* p_frame)
+{
+    bool ret = false;
+    __rx_ring_lock();
+    if(s_rx_ring.count) {
+        lora_raw_rx_ring_frame_t* p_slot = & s_rx_ring.slots[s_rx_ring.head];
+        memcpy(p_frame->buf, p_slot->buf, p_slot->len);
+        p_frame->len = p_slot->len;
+        p_frame->rssi = p_slot->rssi;
+        p_frame->snr = p_slot->snr;
+        p_frame->timestamp = p_slot->timestamp;
+        p_frame->overruns = p_slot->overruns;
+        s_rx_ring.head = (s_rx_ring.head + 1) % __rx_ring_slots;
+        -- s_rx_ring.count;
+        ret = true;
+    }
+    /* re-arm the batch event once the application catches up */
+    if(s_rx_ring.count < s_rx_ring.batch)
+        s_rx_ring.batch_raised = false;
+    __rx_ring_unlock();
+    return ret;
+}
+
+static void rx_ring_flush(void)
+{
+    __rx_ring_lock();
+    s_rx_ring.head = 0;
+    s_rx_ring.count = 0;
+    s_rx_ring.pending_overruns = 0;
+    s_rx_ring.batch_raised = false;
+    __rx_ring_unlock();
+}
+
+/** -------------------------------------------------------------------------- *
+ * back-to-back tx (burst) queue and statistics
+ * --------------------------------------------------------------------------- *
+ */
+#define __tx_burst_queue_size       (4u)
+#define __tx_burst_stop_margin      (1000u) /* msec, over the tx timeout */
+
+typedef struct {
+    uint8_t     buf[255];
+    uint8_t     len;
+} tx_burst_frame_t;
+
+static struct {
+    volatile bool       active;
+    tx_burst_frame_t    queue[__tx_burst_queue_size];
+    uint32_t            head;
+    volatile uint32_t   count;
+    volatile bool       on_air;     /* a burst frame is under transmission */
+    uint8_t             on_air_len;
+    void*               mutex;
+    void*               sem;        /* signalled on every freed queue slot */
+
+    /* running burst */
+    uint32_t            start_ts;
+    uint32_t            packets;
+    uint32_t            bytes;
+    uint32_t            gap_sum;
+    uint32_t            gap_max;
+
+    /* last completed burst */
+    struct {
+        uint32_t        packets;
+        uint32_t        bytes;
+        uint32_t        duration;
+        uint32_t        gap_sum;
+        uint32_t        gap_max;
+    } last;
+
+    /* totals since the process construction */
+    uint32_t            bursts;
+    uint32_t            total_packets;
+    uint32_t            timeouts;
+    uint32_t            dropped;
+} s_tx_burst;
+
+#define __tx_burst_lock()   lora_stub_mutex_lock(s_tx_burst.mutex)
+#define __tx_burst_unlock() lora_stub_mutex_unlock(s_tx_burst.mutex)
+
+static void tx_burst_ctor(void)
+{
+    if(s_tx_burst.mutex == NULL)
+        s_tx_burst.mutex = lora_stub_mutex_new();
+    if(s_tx_burst.sem == NULL)
+        s_tx_burst.sem = lora_stub_sem_new();
+}
+
+static bool tx_burst_enqueue(uint8_t* buf, uint8_t len)
+{
+    bool ret = false;
+    __tx_burst_lock();
+    if(s_tx_burst.count < __tx_burst_queue_size) {
+        tx_burst_frame_t* p_frame = & s_tx_burst.queue[
+            (s_tx_burst.head + s_tx_burst.count) % __tx_burst_queue_size];
+        memcpy(p_frame->buf, buf, len);
+        p_frame->len = len;
+        ++ s_tx_burst.count;
+        ret = true;
+    }
+    __tx_burst_unlock();
+    return ret;
+}
+
+/* the frame stays in the queue head until it is loaded into the radio */
+static tx_burst_frame_t* tx_burst_peek(void)
+{
+    tx_burst_frame_t* p_frame = NULL;
+    __tx_burst_lock();
+    if(s_tx_burst.count)
+        p_frame = & s_tx_burst.queue[s_tx_burst.head];
+    __tx_burst_unlock();
+    return p_frame;
+}
+
+static void tx_burst_release(void)
+{
+    __tx_burst_lock();
+    if(s_tx_burst.count) {
+        s_tx_burst.head = (s_tx_burst.head + 1) % __tx_burst_queue_size;
+        -- s_tx_burst.count;
+    }
+    __tx_burst_unlock();
+    lora_stub_sem_signal(s_tx_burst.sem);
+}
+
+static void tx_burst_flush(void)
+{
+    __tx_burst_lock();
+    s_tx_burst.dropped += s_tx_burst.count;
+    s_tx_burst.head = 0;
+    s_tx_burst.count = 0;
+    s_tx_burst.on_air = false;
+    __tx_burst_unlock();
+    if(s_tx_burst.sem)
+        lora_stub_sem_signal(s_tx_burst.sem);
+}
+
+static void tx_burst_stats_start(void)
+{
+    s_tx_burst.start_ts = lora_stub_get_timestamp_ms();
+    s_tx_burst.packets = 0;
+    s_tx_burst.bytes = 0;
+    s_tx_burst.gap_sum = 0;
+    s_tx_burst.gap_max = 0;
+}
+
+static void tx_burst_stats_frame_done(uint8_t len)
+{
+    ++ s_tx_burst.packets;
+    ++ s_tx_burst.total_packets;
+    s_tx_burst.bytes += len;
+}
+
+static void tx_burst_stats_gap(uint32_t gap)
+{
+    s_tx_burst.gap_sum += gap;
+    if(gap > s_tx_burst.gap_max)
+        s_tx_burst.gap_max = gap;
+}
+
+static void tx_burst_stats_end(uint32_t end_ts)
+{
+    ++ s_tx_burst.bursts;
+    s_tx_burst.last.packets = s_tx_burst.packets;
+    s_tx_burst.last.bytes = s_tx_burst.bytes;
+    s_tx_burst.last.duration = end_ts - s_tx_burst.start_ts;
+    s_tx_burst.last.gap_sum = s_tx_burst.gap_sum;
+    s_tx_burst.last.gap_max = s_tx_burst.gap_max;
+}
+
 /** -------------------------------------------------------------------------- *
  * time on air timer
  * --------------------------------------------------------------------------- *
@@ -296,6 +551,156 @@ static void operation_deadline_timer_stop(void)
     TimerStop(&s_operation_deadline_timer);
 }
 
+/** -------------------------------------------------------------------------- *
+ * listen before talk (lbt) and channel activity detection (cad) scan
+ * --------------------------------------------------------------------------- *
+ */
+static TimerEvent_t s_lbt_backoff_timer;
+
+static struct {
+    order_t*    p_order;    /* the tx order waiting for a clear channel */
+    uint8_t     attempts;   /* cad attempts spent on the waiting order */
+
+    lora_raw_lbt_stats_t stats;
+} s_lbt;
+
+static struct {
+    order_t*                p_order;
+    lora_raw_cad_scan_t*    p_scan;
+    uint8_t                 channel;
+    uint8_t                 round;
+    uint32_t                start_ts;
+    bool                    completed;
+} s_cad_scan;
+
+static void lbt_backoff_timer_callback(void* data);
+
+static void lbt_backoff_timer_ctor(void)
+{
+    __log_info("ctor() -> lbt backoff timer");
+    TimerInit(&s_lbt_backoff_timer, lbt_backoff_timer_callback);
+}
+static void lbt_backoff_timer_dtor(void)
+{
+    __log_info("~dtor() -> lbt backoff timer");
+    TimerStop(&s_lbt_backoff_timer);
+}
+
+static void lbt_backoff_timer_callback(void* data)
+{
+    __log_info("expire -> lbt backoff timer");
+    lora_raw_process_event(__LORA_RAW_PROCESS_LBT_BACKOFF_EXPIRE, NULL, false);
+}
+static void lbt_backoff_timer_start(uint32_t ms)
+{
+    __log_info("start  -> lbt backoff timer (%d msec)", ms);
+    TimerSetValue(&s_lbt_backoff_timer, ms);
+    TimerStart(&s_lbt_backoff_timer);
+}
+static void lbt_backoff_timer_stop(void)
+{
+    __log_info("stop   -> lbt backoff timer");
+    TimerStop(&s_lbt_backoff_timer);
+}
+
+static bool lbt_is_enabled(void)
+{
+    lora_raw_param_t param = {.type = __LORA_RAW_PARAM_LBT};
+    lora_raw_radio_get_param( & param );
+    return param.param.lbt;
+}
+
+static void lbt_cad_start(void)
+{
+    ++ s_lbt.attempts;
+    ++ s_lbt.stats.cad_count;
+    lora_raw_radio_cad();
+}
+
+static void lbt_stats_message_end(void)
+{
+    s_lbt.stats.last_attempts = s_lbt.attempts;
+    if( s_lbt.attempts > s_lbt.stats.max_attempts )
+        s_lbt.stats.max_attempts = s_lbt.attempts;
+}
+
+/** -------------------------------------------------------------------------- *
+ * frequency hopping
+ * --------------------------------------------------------------------------- *
+ */
+static TimerEvent_t s_hop_timer;
+static bool s_hop_tuned;    /* the radio is left on a hopping channel */
+
+/* a message being received when the slot ends keeps the channel until its
+ * time on air expires, the hop is retried after this delay */
+#define __hop_defer_ms  (10)
+
+static void hop_timer_callback(void* data);
+
+static void hop_timer_ctor(void)
+{
+    __log_info("ctor() -> hop timer");
+    TimerInit(&s_hop_timer, hop_timer_callback);
+}
+static void hop_timer_dtor(void)
+{
+    __log_info("~dtor() -> hop timer");
+    TimerStop(&s_hop_timer);
+}
+
+static void hop_timer_callback(void* data)
+{
+    __log_info("expire -> hop timer");
+    lora_raw_process_event(__LORA_RAW_PROCESS_HOP_EXPIRE, NULL, false);
+}
+static void hop_timer_start(uint32_t ms)
+{
+    __log_info("start  -> hop timer (%d msec)", ms);
+    TimerSetValue(&s_hop_timer, ms);
+    TimerStart(&s_hop_timer);
+}
+static void hop_timer_stop(void)
+{
+    __log_info("stop   -> hop timer");
+    TimerStop(&s_hop_timer);
+}
+
+/* puts the radio in reception on the channel of the present slot, or on the
+ * configured channel if the hopping is disabled */
+static void radio_recv(void)
+{
+    uint32_t hop_in = 0;
+
+    hop_timer_stop();
+    if( lora_raw_hop_is_enabled() )
+    {
+        lora_raw_radio_retune(lora_raw_hop_rx_channel(&hop_in));
+        s_hop_tuned = true;
+        if( hop_in )
+            hop_timer_start(hop_in);
+    }
+    else if( s_hop_tuned )
+    {
+        lora_raw_radio_retune(0);
+        s_hop_tuned = false;
+    }
+    lora_raw_radio_recv();
+}
+
+static void radio_tune_tx(void)
+{
+    if( lora_raw_hop_is_enabled() )
+    {
+        lora_raw_radio_retune(lora_raw_hop_tx_channel());
+        s_hop_tuned = true;
+    }
+    else if( s_hop_tuned )
+    {
+        lora_raw_radio_retune(0);
+        s_hop_tuned = false;
+    }
+}
+
 /** -------------------------------------------------------------------------- *
  * process state machine
  * --------------------------------------------------------------------------- *
@@ -321,7 +726,12 @@ static const char* lora_raw_get_cmd_str(lora_raw_process_event_t cmd) {
         [__LORA_RAW_PROCESS_RADIO_TOA_EXPIRE] = "ToA-expired",
         [__LORA_RAW_PROCESS_OPERATION_TIMEOUT] = "opr-timeout",
         [__LORA_RAW_PROCESS_RADIO_TX_CONT_WAVE] = "start-tx_cont-wave",
-        [__LORA_RAW_PROCESS_RADIO_TX_CONT_WAVE_END] = "end-tx_cont-wave"
+        [__LORA_RAW_PROCESS_RADIO_TX_CONT_WAVE_END] = "end-tx_cont-wave",
+        [__LORA_RAW_PROCESS_TX_BURST_REQUEST] = "tx-burst-req",
+        [__LORA_RAW_PROCESS_CAD_SCAN_REQUEST] = "cad-scan-req",
+        [__LORA_RAW_PROCESS_LBT_BACKOFF_EXPIRE] = "lbt-backoff",
+        [__LORA_RAW_PROCESS_RADIO_RATE] = "radio-rate",
+        [__LORA_RAW_PROCESS_HOP_EXPIRE] = "hop-expire"
     };
     return names[cmd];
 }
@@ -334,6 +744,9 @@ static order_t* p_tx_order = NULL;
 static void reset_process_states_saved_orders(void)
 {
     p_rx_order = p_tx_order = NULL;
+    s_lbt.p_order = s_cad_scan.p_order = NULL;
+    lbt_backoff_timer_stop();
+    tx_burst_flush();
 }
 
 /* ############################# IDLE State ################################# */
@@ -353,21 +766,25 @@ __sm_trans(lora_raw, rx,        rx_timeout,     handle_rx_timeout,  idle       )
 __sm_trans(lora_raw, rx,        opr_timeout,    handle_rx_timeout,  idle       )
 __sm_trans(lora_raw, rx,        rx_fail,        handle_rx_fail,     idle       )
 __sm_trans(lora_raw, rx,        req_tx,         start_tx,           tx         )
+__sm_trans(lora_raw, rx,        hop_expire,     hop_rx,             rx         )
 /* ########################## Time_on_Air  State ############################ */
 __sm_trans(lora_raw, toa,       toa_expire,     back_to_rx,         rx         )
 __sm_trans(lora_raw, toa,       opr_timeout,    handle_rx_timeout,  idle       )
 __sm_trans(lora_raw, toa,       radio_irq,      postpone,           toa        )
 __sm_trans(lora_raw, toa,       req_tx,         start_tx,           tx         )
+__sm_trans(lora_raw, toa,       hop_expire,     hop_defer,          toa        )
 /* ############################# RX_Cont  State ############################# */
 __sm_trans(lora_raw, rx_cont,   end_rx_cont,    stop_rx_cont,       idle       )
 __sm_trans(lora_raw, rx_cont,   radio_irq,      process_irq,        rx_cont    )
 __sm_trans(lora_raw, rx_cont,   rx_done,        handle_rx_done,     rx_cont    )
 __sm_trans(lora_raw, rx_cont,   req_tx,         start_tx,           tx_temp    )
+__sm_trans(lora_raw, rx_cont,   hop_expire,     hop_rx,             rx_cont    )
 
 __sm_trans(lora_raw, toa_temp,  end_rx_cont,    stop_rx_cont,       idle       )
 __sm_trans(lora_raw, toa_temp,  toa_expire,     back_to_rx,         rx_cont    )
 __sm_trans(lora_raw, toa_temp,  radio_irq,      postpone,           toa_temp   )
 __sm_trans(lora_raw, toa_temp,  req_tx,         start_tx,           tx_temp    )
+__sm_trans(lora_raw, toa_temp,  hop_expire,     hop_defer,          toa_temp   )
 
 __sm_trans(lora_raw, tx_temp,   end_rx_cont,    do_nothing,         tx         )
 __sm_trans(lora_raw, tx_temp,   tx_done,        handle_tx_done,     rx_cont    )
@@ -377,6 +794,28 @@ __sm_trans(lora_raw, tx_temp,   radio_irq,      process_irq,        tx_temp    )
 /* ############################# TX_Cont  State ############################# */
 __sm_trans(lora_raw, tx_cont,   tx_timeout,     radio_sleep,        idle       )
 __sm_trans(lora_raw, tx_cont,   end_tx_cont,    radio_sleep,        idle       )
+/* ############################# TX_Burst State ############################ */
+__sm_trans(lora_raw, idle,      req_tx_burst,   start_burst,        tx_burst   )
+__sm_trans(lora_raw, tx_burst,  tx_done,        burst_next,         tx_burst   )
+__sm_trans(lora_raw, tx_burst,  tx_timeout,     burst_abort,        idle       )
+__sm_trans(lora_raw, tx_burst,  opr_timeout,    burst_abort,        idle       )
+__sm_trans(lora_raw, tx_burst,  radio_irq,      process_irq,        tx_burst   )
+/* ######################## Listen_Before_Talk State ####################### */
+__sm_trans(lora_raw, lbt,       cad_done,       lbt_check,          lbt        )
+__sm_trans(lora_raw, lbt,       backoff_expire, lbt_retry,          lbt        )
+__sm_trans(lora_raw, lbt,       radio_irq,      process_irq,        lbt        )
+__sm_trans(lora_raw, lbt,       opr_timeout,    lbt_abort,          idle       )
+
+__sm_trans(lora_raw, lbt_temp,  cad_done,       lbt_check,          lbt_temp   )
+__sm_trans(lora_raw, lbt_temp,  backoff_expire, lbt_retry,          lbt_temp   )
+__sm_trans(lora_raw, lbt_temp,  radio_irq,      process_irq,        lbt_temp   )
+__sm_trans(lora_raw, lbt_temp,  opr_timeout,    lbt_abort,          rx_cont    )
+__sm_trans(lora_raw, lbt_temp,  end_rx_cont,    do_nothing,         lbt        )
+/* ############################# CAD_Scan State ############################ */
+__sm_trans(lora_raw, idle,      req_cad_scan,   start_cad_scan,     cad_scan   )
+__sm_trans(lora_raw, cad_scan,  cad_done,       cad_scan_next,      cad_scan   )
+__sm_trans(lora_raw, cad_scan,  radio_irq,      process_irq,        cad_scan   )
+__sm_trans(lora_raw, cad_scan,  opr_timeout,    cad_scan_abort,     idle       )
 
 /** -------------------------------------------------------------------------- *
  * actions definitions
@@ -400,6 +839,12 @@ static void start_tx_timer(void* data)
 __sm_state_enter(lora_raw, idle)(void* data)
 {
     operation_deadline_timer_stop();
+    hop_timer_stop();
+
+    /* frames queued in burst mode while another operation was running */
+    if(s_tx_burst.count)
+        lora_raw_process_event(__LORA_RAW_PROCESS_TX_BURST_REQUEST, NULL,
+            false);
 }
 __sm_state_enter(lora_raw, tx)(void* data)
 {
@@ -475,6 +920,26 @@ __sm_state_default_action(lora_raw, tx_cont)(void* data)
     order_t* p_order = data;
     order_respond(p_order, __no_callback, NULL, 0);
 }
+__sm_state_default_action(lora_raw, tx_burst)(void* data)
+{
+    order_t* p_order = data;
+    order_respond(p_order, __no_callback, NULL, 0);
+}
+__sm_state_default_action(lora_raw, lbt)(void* data)
+{
+    order_t* p_order = data;
+    order_respond(p_order, __no_callback, NULL, 0);
+}
+__sm_state_default_action(lora_raw, lbt_temp)(void* data)
+{
+    order_t* p_order = data;
+    order_respond(p_order, __no_callback, NULL, 0);
+}
+__sm_state_default_action(lora_raw, cad_scan)(void* data)
+{
+    order_t* p_order = data;
+    order_respond(p_order, __no_callback, NULL, 0);
+}
 
 __sm_action(lora_raw, radio_sleep)(void* data)/* ---------------- radio_sleep */
 {
@@ -482,29 +947,61 @@ __sm_action(lora_raw, radio_sleep)(void* data)/* ---------------- radio_sleep */
     lora_raw_radio_sleep();
     order_respond(p_order, __no_callback, NULL, 0);
 }
+static void tx_send(order_t* p_order)
+{
+    lora_raw_latency_tx_mark(__LORA_RAW_LAT_TX_RADIO);
+    lora_raw_radio_send(
+        p_order->request_payload.tx_payload.buf,
+        p_order->request_payload.tx_payload.len );
+    lora_raw_latency_tx_mark(__LORA_RAW_LAT_TX_SENT);
+    if(p_order->sync)
+        p_tx_order = p_order;
+    else
+        order_respond(p_order, __no_callback, NULL, 0);
+}
+
 __sm_action(lora_raw, start_tx)(void* data)/* ---------------------- start_tx */
 {
     order_t* p_order = data;
 
+    lora_raw_latency_tx_mark(__LORA_RAW_LAT_TX_SM);
+
     if( p_rx_order )
     {
         order_respond(p_rx_order, __no_callback, NULL, 0);
         p_rx_order = NULL;
     }
 
-    lora_raw_radio_send(
-        p_order->request_payload.tx_payload.buf,
-        p_order->request_payload.tx_payload.len );
-    if(p_order->sync)
-        p_tx_order = p_order;
-    else
-        order_respond(p_order, __no_callback, NULL, 0);
+    /* the channel is assessed and the message is sent on the slot channel */
+    hop_timer_stop();
+    radio_tune_tx();
+
+    if( lbt_is_enabled() )
+    {
+        /* the message waits in the lbt states for a clear channel, the
+         * deadline timer started by the tx states enter hooks covers both
+         * the channel assessment and the transmission */
+        s_lbt.p_order = p_order;
+        s_lbt.attempts = 0;
+        lbt_cad_start();
+
+        if( __sm_present_state_id(lora_raw) ==
+                __sm_state_id(lora_raw, rx_cont) ||
+            __sm_present_state_id(lora_raw) ==
+                __sm_state_id(lora_raw, toa_temp) )
+            __sm_ch_state(lora_raw, lbt_temp);
+        else
+            __sm_ch_state(lora_raw, lbt);
+        return;
+    }
+
+    tx_send(p_order);
 }
 
 __sm_action(lora_raw, start_rx)(void* data)/* ---------------------- start_rx */
 {
     order_t* p_order = data;
-    lora_raw_radio_recv();
+    radio_recv();
     if(p_order->sync)
         p_rx_order = p_order;
     else
@@ -542,11 +1039,12 @@ __sm_action(lora_raw, handle_tx_done)(void* data)/* ---------- handle_tx_done */
 {
     order_t* p_order = data;
 
+    lora_raw_latency_tx_mark(__LORA_RAW_LAT_TX_IRQ);
     lora_raw_radio_sleep();
 
     if(__sm_present_state_id(lora_raw) == __sm_state_id(lora_raw, tx_temp))
     {
-        lora_raw_radio_recv();
+        radio_recv();
     }
 
     if(p_tx_order) {
@@ -565,7 +1063,7 @@ __sm_action(lora_raw, handle_tx_timeout)(void* data)/* ---- handle_tx_timeout */
     lora_raw_radio_sleep();
     if(__sm_present_state_id(lora_raw) == __sm_state_id(lora_raw, tx_temp))
     {
-        lora_raw_radio_recv();
+        radio_recv();
     }
 
     if(p_tx_order)
@@ -585,6 +1083,7 @@ __sm_action(lora_raw, handle_rx_done)(void* data)/* ---------- handle_rx_done */
 {
     order_t* p_order = data;
 
+    lora_raw_latency_rx_mark(__LORA_RAW_LAT_RX_SM);
     if(__sm_present_state_id(lora_raw) != __sm_state_id(lora_raw, rx_cont))
         lora_raw_radio_sleep();
 
@@ -592,6 +1091,17 @@ __sm_action(lora_raw, handle_rx_done)(void* data)/* ---------- handle_rx_done */
         p_order->request_payload.rx_done_payload.buf,
         p_order->request_payload.rx_done_payload.len);
 
+    /* the slots are aligned to the message, then the continuous reception
+     * moves on with the new timing */
+    if( lora_raw_hop_is_enabled() )
+    {
+        extern uint32_t radio_get_irq_timestamp(void);
+        lora_raw_hop_rx_sync(radio_get_irq_timestamp(),
+            p_order->request_payload.rx_done_payload.len);
+        if(__sm_present_state_id(lora_raw) == __sm_state_id(lora_raw, rx_cont))
+            radio_recv();
+    }
+
     __log_debug("[radio:: buf=%p, len=%d] ==> [process:: buf=%p, len=%d]",
             p_order->request_payload.rx_done_payload.buf,
             p_order->request_payload.rx_done_payload.len,
@@ -621,6 +1131,19 @@ __sm_action(lora_raw, handle_rx_done)(void* data)/* ---------- handle_rx_done */
         p_rx_order = NULL;
         order_respond(p_order, __no_callback, NULL, 0);
     }
+    else if( s_rx_ring.enabled )
+    {
+        extern uint32_t radio_get_irq_timestamp(void);
+        bool batch_ready = rx_ring_push(__rx_buffer_ptr(), __rx_buffer_len(),
+            evt_data.rssi, evt_data.snr, radio_get_irq_timestamp());
+
+        if(p_rx_order) {
+            order_respond(p_rx_order, __no_callback, NULL, 0);
+            p_rx_order = NULL;
+        }
+        order_respond(p_order,
+            batch_ready ? __LORA_EVENT_RX_BATCH : __no_callback, NULL, 0);
+    }
     else
     {
         if(p_rx_order) {
@@ -658,7 +1181,7 @@ __sm_action(lora_raw, handle_rx_fail)(void* data)/* ---------- handle_rx_fail */
 
     lora_raw_radio_sleep();
     if(__sm_present_state_id(lora_raw) == __sm_state_id(lora_raw, rx_cont))
-        lora_raw_radio_recv();
+        radio_recv();
 
     if( p_rx_order )
     {
@@ -682,6 +1205,24 @@ __sm_action(lora_raw, back_to_rx)(void* data)/* ------------------ back_to_rx */
     order_respond(p_order, __no_callback, NULL, 0);
 }
 
+__sm_action(lora_raw, hop_rx)(void* data)/* -------------------------- hop_rx */
+{
+    order_t* p_order = data;
+
+    radio_recv();
+
+    order_respond(p_order, __no_callback, NULL, 0);
+}
+
+__sm_action(lora_raw, hop_defer)(void* data)/* -------------------- hop_defer */
+{
+    order_t* p_order = data;
+
+    hop_timer_start(__hop_defer_ms);
+
+    order_respond(p_order, __no_callback, NULL, 0);
+}
+
 __sm_action(lora_raw, stop_rx_cont)(void* data)/* -------------- stop_rx_cont */
 {
     order_t* p_order = data;
@@ -691,6 +1232,264 @@ __sm_action(lora_raw, stop_rx_cont)(void* data)/* -------------- stop_rx_cont */
     order_respond(p_order, __no_callback, NULL, 0);
 }
 
+static void burst_deadline_timer_start(void)
+{
+    lora_raw_param_t param = {.type = __LORA_RAW_PARAM_TX_TIMEOUT};
+    lora_raw_radio_get_param( & param );
+    operation_deadline_timer_start(param.param.tx_timeout);
+}
+
+__sm_action(lora_raw, start_burst)(void* data)/* ---------------- start_burst */
+{
+    order_t* p_order = data;
+    tx_burst_frame_t* p_frame = tx_burst_peek();
+
+    if( p_frame == NULL )
+    {
+        /* the queued frames were already served by the previous burst */
+        __sm_ch_state(lora_raw, idle);
+        order_respond(p_order, __no_callback, NULL, 0);
+        return;
+    }
+
+    tx_burst_stats_start();
+
+    /* the first frame wakes up and configures the radio once */
+    lora_raw_radio_send(p_frame->buf, p_frame->len);
+    s_tx_burst.on_air = true;
+    s_tx_burst.on_air_len = p_frame->len;
+    burst_deadline_timer_start();
+    tx_burst_release();
+
+    order_respond(p_order, __no_callback, NULL, 0);
+}
+
+__sm_action(lora_raw, burst_next)(void* data)/* ------------------ burst_next */
+{
+    order_t* p_order = data;
+    extern uint32_t radio_get_irq_timestamp(void);
+    uint32_t tx_done_ts = radio_get_irq_timestamp();
+    tx_burst_frame_t* p_frame = tx_burst_peek();
+
+    operation_deadline_timer_stop();
+    tx_burst_stats_frame_done(s_tx_burst.on_air_len);
+
+    if( p_frame )
+    {
+        /* the radio stays in standby, the next payload is loaded and the tx
+         * is issued in the same processing cycle of the tx-done */
+        lora_raw_radio_send_next(p_frame->buf, p_frame->len);
+        tx_burst_stats_gap(lora_stub_get_timestamp_ms() - tx_done_ts);
+        s_tx_burst.on_air_len = p_frame->len;
+        burst_deadline_timer_start();
+        tx_burst_release();
+    }
+    else
+    {
+        /* queue under-run, the burst is over */
+        tx_burst_stats_end(tx_done_ts);
+        s_tx_burst.on_air = false;
+        lora_raw_radio_sleep();
+        __sm_ch_state(lora_raw, idle);
+        lora_stub_sem_signal(s_tx_burst.sem);
+    }
+
+    order_respond(p_order, __LORA_EVENT_TX_DONE, NULL, 0);
+}
+
+__sm_action(lora_raw, burst_abort)(void* data)/* ---------------- burst_abort */
+{
+    order_t* p_order = data;
+
+    operation_deadline_timer_stop();
+    lora_raw_radio_sleep();
+
+    ++ s_tx_burst.timeouts;
+    tx_burst_stats_end(lora_stub_get_timestamp_ms());
+    tx_burst_flush();
+
+    order_respond(p_order, __LORA_EVENT_TX_TIMEOUT, NULL, 0);
+}
+
+__sm_action(lora_raw, lbt_check)(void* data)/* -------------------- lbt_check */
+{
+    order_t* p_order = data;
+    bool temp = __sm_present_state_id(lora_raw) ==
+        __sm_state_id(lora_raw, lbt_temp);
+    lora_raw_param_t param = {.type = __LORA_RAW_PARAM_LBT_ATTEMPTS};
+
+    if( ! p_order->request_payload.cad_done_payload.detected )
+    {
+        /* clear channel, the radio is in standby after the cad and the
+         * message goes out immediately */
+        order_t* p_tx = s_lbt.p_order;
+        s_lbt.p_order = NULL;
+        ++ s_lbt.stats.packets;
+        lbt_stats_message_end();
+
+        tx_send(p_tx);
+        if( temp )
+            __sm_ch_state(lora_raw, tx_temp);
+        else
+            __sm_ch_state(lora_raw, tx);
+    }
+    else
+    {
+        ++ s_lbt.stats.busy_count;
+        lora_raw_radio_get_param( & param );
+
+        if( s_lbt.attempts < param.param.lbt_attempts )
+        {
+            /* a random backoff de-synchronizes the nodes waiting for the
+             * same channel */
+            param.type = __LORA_RAW_PARAM_LBT_BACKOFF;
+            lora_raw_radio_get_param( & param );
+            lbt_backoff_timer_start(randr(1, param.param.lbt_backoff));
+        }
+        else
+        {
+            /* the channel stayed busy, the message is dropped */
+            ++ s_lbt.stats.failed;
+            lbt_stats_message_end();
+            operation_deadline_timer_stop();
+
+            if( temp )
+            {
+                radio_recv();
+                __sm_ch_state(lora_raw, rx_cont);
+            }
+            else
+            {
+                lora_raw_radio_sleep();
+                __sm_ch_state(lora_raw, idle);
+            }
+
+            order_respond(s_lbt.p_order, __LORA_EVENT_TX_FAIL, NULL, 0);
+            s_lbt.p_order = NULL;
+        }
+    }
+
+    order_respond(p_order, __no_callback, NULL, 0);
+}
+
+__sm_action(lora_raw, lbt_retry)(void* data)/* -------------------- lbt_retry */
+{
+    order_t* p_order = data;
+
+    lbt_cad_start();
+
+    order_respond(p_order, __no_callback, NULL, 0);
+}
+
+__sm_action(lora_raw, lbt_abort)(void* data)/* -------------------- lbt_abort */
+{
+    order_t* p_order = data;
+
+    lbt_backoff_timer_stop();
+    operation_deadline_timer_stop();
+
+    if( __sm_present_state_id(lora_raw) == __sm_state_id(lora_raw, lbt_temp) )
+        radio_recv();
+    else
+        lora_raw_radio_sleep();
+
+    if( s_lbt.p_order )
+    {
+        ++ s_lbt.stats.failed;
+        lbt_stats_message_end();
+        order_respond(s_lbt.p_order, __LORA_EVENT_TX_TIMEOUT, NULL, 0);
+        s_lbt.p_order = NULL;
+    }
+
+    order_respond(p_order, __no_callback, NULL, 0);
+}
+
+static void cad_scan_cad_start(void)
+{
+    /* every cad is guarded individually, a scan over many channels and
+     * rounds may last longer than any single operation timeout */
+    lora_raw_param_t param = {.type = __LORA_RAW_PARAM_TX_TIMEOUT};
+    lora_raw_radio_get_param( & param );
+    operation_deadline_timer_stop();
+    operation_deadline_timer_start(param.param.tx_timeout);
+
+    lora_raw_radio_cad();
+}
+
+static void cad_scan_end(bool completed)
+{
+    operation_deadline_timer_stop();
+    lora_raw_radio_set_channel(0);
+    lora_raw_radio_sleep();
+
+    s_cad_scan.p_scan->duration =
+        lora_stub_get_timestamp_ms() - s_cad_scan.start_ts;
+    s_cad_scan.completed = completed;
+
+    if( s_cad_scan.p_order )
+    {
+        order_respond(s_cad_scan.p_order, __no_callback, NULL, 0);
+        s_cad_scan.p_order = NULL;
+    }
+}
+
+__sm_action(lora_raw, start_cad_scan)(void* data)/* ---------- start_cad_scan */
+{
+    order_t* p_order = data;
+    lora_raw_cad_scan_t* p_scan = p_order->request_payload.cad_scan.p_scan;
+
+    memset(p_scan->busy, 0, p_scan->count);
+    s_cad_scan.p_order = p_order;
+    s_cad_scan.p_scan = p_scan;
+    s_cad_scan.channel = 0;
+    s_cad_scan.round = 0;
+    s_cad_scan.completed = false;
+    s_cad_scan.start_ts = lora_stub_get_timestamp_ms();
+
+    lora_raw_radio_set_channel(p_scan->freqs[0]);
+    cad_scan_cad_start();
+
+    /* the order is kept and responded at the end of the scan */
+}
+
+__sm_action(lora_raw, cad_scan_next)(void* data)/* ------------ cad_scan_next */
+{
+    order_t* p_order = data;
+    lora_raw_cad_scan_t* p_scan = s_cad_scan.p_scan;
+
+    if( p_order->request_payload.cad_done_payload.detected )
+        ++ p_scan->busy[s_cad_scan.channel];
+
+    if( ++ s_cad_scan.channel == p_scan->count )
+    {
+        s_cad_scan.channel = 0;
+        ++ s_cad_scan.round;
+    }
+
+    if( s_cad_scan.round < p_scan->rounds )
+    {
+        if( p_scan->count > 1 )
+            lora_raw_radio_set_channel(p_scan->freqs[s_cad_scan.channel]);
+        cad_scan_cad_start();
+    }
+    else
+    {
+        cad_scan_end(true);
+        __sm_ch_state(lora_raw, idle);
+    }
+
+    order_respond(p_order, __no_callback, NULL, 0);
+}
+
+__sm_action(lora_raw, cad_scan_abort)(void* data)/* ---------- cad_scan_abort */
+{
+    order_t* p_order = data;
+
+    cad_scan_end(false);
+
+    order_respond(p_order, __no_callback, NULL, 0);
+}
+
 /** -------------------------------------------------------------------------- *
  * process handler
  * --------------------------------------------------------------------------- *
@@ -722,12 +1521,22 @@ static input_id_t lora_raw_sm_get_input_id(lora_raw_process_event_t proc_evt)
         return __sm_input_id(lora_raw, toa_expire);
     case __LORA_RAW_PROCESS_OPERATION_TIMEOUT:
         return __sm_input_id(lora_raw, opr_timeout);
-    case __LORA_RAW_PROCESS_CAD_DONE:
     case __LORA_RAW_PROCESS_RADIO_CONFIG:
     case __LORA_RAW_PROCESS_RADIO_TX_CONT_WAVE:
+    case __LORA_RAW_PROCESS_RADIO_RATE:
         return 0;
     case __LORA_RAW_PROCESS_RADIO_TX_CONT_WAVE_END:
         return __sm_input_id(lora_raw, end_tx_cont);
+    case __LORA_RAW_PROCESS_TX_BURST_REQUEST:
+        return __sm_input_id(lora_raw, req_tx_burst);
+    case __LORA_RAW_PROCESS_CAD_DONE:
+        return __sm_input_id(lora_raw, cad_done);
+    case __LORA_RAW_PROCESS_CAD_SCAN_REQUEST:
+        return __sm_input_id(lora_raw, req_cad_scan);
+    case __LORA_RAW_PROCESS_LBT_BACKOFF_EXPIRE:
+        return __sm_input_id(lora_raw, backoff_expire);
+    case __LORA_RAW_PROCESS_HOP_EXPIRE:
+        return __sm_input_id(lora_raw, hop_expire);
     }
     return 0;
 }
@@ -736,8 +1545,8 @@ static void handle_radio_config(order_t* p_order)
 {
     __log_info("process radio config apply");
     lora_stub_timers_stop_all();
-    lora_raw_radio_dtor();
-    lora_raw_radio_ctor();
+    lora_raw_radio_reconfig();
+    s_hop_tuned = false;
     __sm_ch_state(lora_raw, idle);
 
     order_cancel_all();
@@ -757,12 +1566,45 @@ static void handle_radio_tx_cont_wave(order_t* p_order)
     order_cancel_all();
 }
 
+static void handle_radio_rate(order_t* p_order)
+{
+    bool rx_cont = __sm_present_state_id(lora_raw) ==
+        __sm_state_id(lora_raw, rx_cont);
+
+    /* the rate is switched between the operations only, a running rx or tx
+     * keeps the rate it has started with */
+    if( __sm_present_state_id(lora_raw) == __sm_state_id(lora_raw, idle) ||
+        rx_cont )
+    {
+        lora_raw_radio_set_rate(p_order->request_payload.radio_rate.sf,
+            p_order->request_payload.radio_rate.bw,
+            p_order->request_payload.radio_rate.power_cut);
+        if( rx_cont )
+            radio_recv();
+    }
+    else
+    {
+        __log_warn("radio rate change refused in a busy state");
+    }
+
+    order_respond(p_order, __no_callback, NULL, 0);
+}
+
 static void lora_raw_process_handler(void* data)
 {
     __log_info(__purple__"-- new processing cycle --");
 
     order_t* p_order = *(order_t**)data;
 
+    /* the latency traces start when the process takes the order */
+    if( p_order->req_type == __LORA_RAW_PROCESS_TX_REQUEST )
+        lora_raw_latency_tx_start(p_order->request_payload.tx_payload.api_ts,
+            p_order->queue_ts);
+    else if( p_order->req_type == __LORA_RAW_PROCESS_RADIO_IRQ )
+        lora_raw_latency_irq_dispatch();
+    else if( p_order->req_type == __LORA_RAW_PROCESS_RX_DONE )
+        lora_raw_latency_rx_start(p_order->queue_ts);
+
     if( p_order->req_type == __LORA_RAW_PROCESS_RADIO_CONFIG )
     {
         __log_info("process radio config apply");
@@ -772,6 +1614,10 @@ static void lora_raw_process_handler(void* data)
     {
         handle_radio_tx_cont_wave(p_order);
     }
+    else if(p_order->req_type == __LORA_RAW_PROCESS_RADIO_RATE)
+    {
+        handle_radio_rate(p_order);
+    }
     else
     {
         __sm_run(lora_raw, lora_raw_sm_get_input_id(p_order->req_type),
@@ -791,6 +1637,12 @@ static void lora_raw_process_handler(void* data)
             s_registered_callback(p_order->respond_payload.event,
                 & p_order->respond_payload.event_data);
         }
+
+        if( p_order->respond_payload.event == __LORA_EVENT_TX_DONE )
+            lora_raw_latency_tx_end();
+        else if( p_order->respond_payload.event == __LORA_EVENT_RX_DONE ||
+                 p_order->respond_payload.event == __LORA_EVENT_RX_BATCH )
+            lora_raw_latency_rx_end();
         order_free( p_order );
     }
 }
@@ -820,7 +1672,11 @@ void lora_raw_process_ctor(void)
 
     time_on_air_ctor();
     operation_deadline_timer_ctor();
+    lbt_backoff_timer_ctor();
+    hop_timer_ctor();
     __order_access_ctor();
+    tx_burst_ctor();
+    rx_ring_ctor();
 }
 
 void lora_raw_process_dtor(void)
@@ -828,6 +1684,8 @@ void lora_raw_process_dtor(void)
     __log_info("~dtor() -> lora raw process");
     time_on_air_dtor();
     operation_deadline_timer_dtor();
+    lbt_backoff_timer_dtor();
+    hop_timer_dtor();
     lora_event_handler_deregister(__lora_evt_raw_process_cmd);
     order_cancel_all();
     lora_raw_radio_sleep();
@@ -847,6 +1705,11 @@ void lora_raw_process_event(
     order_t *   p_order;
     sync_obj_t  sync_obj = 0;
 
+    /* with the hopping, a message starts at a slot start, the caller waits
+     * here for it */
+    if( event == __LORA_RAW_PROCESS_TX_REQUEST && lora_raw_hop_is_enabled() )
+        lora_raw_hop_tx_align();
+
     do{
         p_order = order_request(event, sync, sync_obj, event_data);
     } while( ! p_order);
@@ -871,4 +1734,185 @@ void lora_raw_sm_print(void)
     __sm_disp(lora_raw);
 }
 
+void lora_raw_process_burst_start(void)
+{
+    __log_info("tx burst mode -> start");
+    s_tx_burst.active = true;
+}
+
+void lora_raw_process_burst_stop(void)
+{
+    lora_raw_param_t param = {.type = __LORA_RAW_PARAM_TX_TIMEOUT};
+
+    __log_info("tx burst mode -> stop");
+    s_tx_burst.active = false;
+
+    /* drain the queued frames, burst_next() keeps serving them. Every frame
+     * is sent or aborted within the tx timeout, a drain without progress
+     * means the frames were queued while the machine stays in another state
+     * (e.g. rx_cont), so they are dropped instead of waiting for ever */
+    lora_raw_radio_get_param( & param );
+    while( s_tx_burst.count || s_tx_burst.on_air )
+    {
+        if( ! lora_stub_sem_wait_timeout(s_tx_burst.sem,
+                param.param.tx_timeout + __tx_burst_stop_margin) &&
+            ( s_tx_burst.count || s_tx_burst.on_air ) )
+        {
+            __log_warn("tx burst mode -> stop, drop %d frames not sent",
+                s_tx_burst.count);
+            tx_burst_flush();
+            break;
+        }
+    }
+}
+
+bool lora_raw_process_burst_is_active(void)
+{
+    return s_tx_burst.active;
+}
+
+void lora_raw_process_burst_send(uint8_t* buf, uint8_t len)
+{
+    while( ! tx_burst_enqueue(buf, len) )
+        lora_stub_sem_wait(s_tx_burst.sem);
+
+    lora_raw_process_event(__LORA_RAW_PROCESS_TX_BURST_REQUEST, NULL, false);
+}
+
+void lora_raw_process_rx_ring_set(lora_raw_rx_ring_cfg_t* p_cfg)
+{
+    __log_info("rx ring -> %s, batch: %d",
+        p_cfg->enable ? "enable" : "disable", p_cfg->batch);
+
+    __rx_ring_lock();
+    s_rx_ring.batch = p_cfg->batch > __rx_ring_slots ?
+        __rx_ring_slots : p_cfg->batch;
+    s_rx_ring.batch_raised = false;
+    __rx_ring_unlock();
+
+    /* the frames left in the ring stay readable after disabling it */
+    if(p_cfg->enable && ! s_rx_ring.enabled)
+        rx_ring_flush();
+    s_rx_ring.enabled = p_cfg->enable;
+}
+
+bool lora_raw_process_rx_ring_read(lora_raw_rx_ring_frame_t* p_frame)
+{
+    return rx_ring_pop(p_frame);
+}
+
+bool lora_raw_process_rx_ring_wait(
+    lora_raw_rx_ring_frame_t* p_frame, uint32_t timeout)
+{
+    uint32_t start_ts = lora_stub_get_timestamp_ms();
+    uint32_t elapsed;
+
+    /* the semaphore may hold the signal of an already popped frame, so the
+     * ring is checked again after every wake up */
+    while( ! rx_ring_pop(p_frame) )
+    {
+        elapsed = lora_stub_get_timestamp_ms() - start_ts;
+        if( elapsed >= timeout )
+            return false;
+        lora_stub_sem_wait_timeout(s_rx_ring.sem, timeout - elapsed);
+    }
+    return true;
+}
+
+void lora_raw_process_rx_ring_status(lora_raw_rx_ring_status_t* p_status)
+{
+    __rx_ring_lock();
+    p_status->enabled = s_rx_ring.enabled;
+    p_status->batch = s_rx_ring.batch;
+    p_status->count = s_rx_ring.count;
+    p_status->slots = __rx_ring_slots;
+    p_status->stored = s_rx_ring.stored;
+    p_status->overruns = s_rx_ring.overruns;
+    __rx_ring_unlock();
+}
+
+bool lora_raw_process_cad_scan(lora_raw_cad_scan_t* p_scan)
+{
+    if( p_scan->count == 0 ||
+        p_scan->count > __LORA_RAW_CAD_SCAN_MAX_CHANNELS ||
+        p_scan->rounds == 0 )
+        return false;
+
+    lora_raw_process_event_payload_t payload = {
+        .type = __PROCESS_MSG_PAYLOAD_CAD_SCAN,
+        .cad_scan = { .p_scan = p_scan }
+    };
+
+    /* the request is dropped by any state other than idle */
+    s_cad_scan.completed = false;
+    lora_raw_process_event(__LORA_RAW_PROCESS_CAD_SCAN_REQUEST, &payload, true);
+
+    return s_cad_scan.completed;
+}
+
+void lora_raw_process_lbt_stats(lora_raw_lbt_stats_t* p_stats)
+{
+    *p_stats = s_lbt.stats;
+}
+
+void lora_raw_process_stats(void)
+{
+    #define __temp(item, val_fmt, args...) \
+        log_list_item("%-15s: " val_fmt __default__, item, args)
+
+    uint32_t packets = s_tx_burst.last.packets;
+    uint32_t duration = s_tx_burst.last.duration;
+
+    log_list_start(4);
+
+    log_list_indent();
+    log_list_item(__blue__"tx burst");
+    log_list_indent();
+        __temp("mode", "%s", s_tx_burst.active ?
+            __green__"active" : __red__"inactive");
+        __temp("bursts", __yellow__"%d", s_tx_burst.bursts);
+        __temp("packets", __yellow__"%d", s_tx_burst.total_packets);
+        __temp("timeouts", __yellow__"%d", s_tx_burst.timeouts);
+        __temp("dropped", __yellow__"%d", s_tx_burst.dropped);
+    log_list_outdent();
+    log_list_item(__blue__"last burst");
+    log_list_indent();
+        __temp("packets", __yellow__"%d", packets);
+        __temp("bytes", __yellow__"%d", s_tx_burst.last.bytes);
+        __temp("duration", __yellow__"%d"__default__" msec", duration);
+        __temp("rate", __yellow__"%.2f"__default__" packets/sec",
+            duration ? packets * 1000.0f / duration : 0.0f);
+        __temp("idle_gap_avg", __yellow__"%.2f"__default__" msec",
+            packets > 1 ? (float)s_tx_burst.last.gap_sum / (packets - 1) :
+            0.0f);
+        __temp("idle_gap_max", __yellow__"%d"__default__" msec",
+            s_tx_burst.last.gap_max);
+    log_list_outdent();
+    log_list_item(__blue__"rx ring");
+    log_list_indent();
+        __temp("mode", "%s", s_rx_ring.enabled ?
+            __green__"enabled" : __red__"disabled");
+        __temp("slots", __yellow__"%d"__default__" (ready: %d)",
+            __rx_ring_slots, s_rx_ring.count);
+        __temp("batch", __yellow__"%d", s_rx_ring.batch);
+        __temp("stored", __yellow__"%d", s_rx_ring.stored);
+        __temp("overruns", __yellow__"%d", s_rx_ring.overruns);
+    log_list_outdent();
+    log_list_item(__blue__"lbt");
+    log_list_indent();
+        __temp("packets", __yellow__"%d", s_lbt.stats.packets);
+        __temp("failed", __yellow__"%d", s_lbt.stats.failed);
+        __temp("cad_count", __yellow__"%d", s_lbt.stats.cad_count);
+        __temp("busy_count", __yellow__"%d", s_lbt.stats.busy_count);
+        __temp("attempts_avg", __yellow__"%.2f",
+            s_lbt.stats.packets + s_lbt.stats.failed ?
+            (float)s_lbt.stats.cad_count /
+            (s_lbt.stats.packets + s_lbt.stats.failed) : 0.0f);
+        __temp("attempts_last", __yellow__"%d", s_lbt.stats.last_attempts);
+        __temp("attempts_max", __yellow__"%d", s_lbt.stats.max_attempts);
+    log_list_end();
+
+    #undef __temp
+}
+
 /* --- end of file ---------------------------------------------------------- */
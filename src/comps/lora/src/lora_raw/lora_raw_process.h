@@ -60,6 +60,11 @@ typedef enum {
     __LORA_RAW_PROCESS_OPERATION_TIMEOUT,
     __LORA_RAW_PROCESS_RADIO_TX_CONT_WAVE,
     __LORA_RAW_PROCESS_RADIO_TX_CONT_WAVE_END,
+    __LORA_RAW_PROCESS_TX_BURST_REQUEST,
+    __LORA_RAW_PROCESS_CAD_SCAN_REQUEST,
+    __LORA_RAW_PROCESS_LBT_BACKOFF_EXPIRE,
+    __LORA_RAW_PROCESS_RADIO_RATE,
+    __LORA_RAW_PROCESS_HOP_EXPIRE,
 } lora_raw_process_event_t;
 
 typedef struct {
@@ -80,6 +85,9 @@ typedef struct {
         __PROCESS_MSG_PAYLOAD_RX_REQ,
         __PROCESS_MSG_PAYLOAD_RX_DONE,
         __PROCESS_MSG_PAYLOAD_TX_CONT_WAVE,
+        __PROCESS_MSG_PAYLOAD_CAD_DONE,
+        __PROCESS_MSG_PAYLOAD_CAD_SCAN,
+        __PROCESS_MSG_PAYLOAD_RADIO_RATE,
     } type;
 
     union {
@@ -94,6 +102,7 @@ typedef struct {
             uint8_t*    buf;
             uint8_t     len;
             uint32_t    timeout;
+            uint32_t    api_ts;     /* usec, for the latency statistics */
         } tx_payload;
         struct {
             uint8_t*    buf;
@@ -106,6 +115,17 @@ typedef struct {
             int8_t      power;
             uint32_t    timeout;
         } tx_cont_wave;
+        struct {
+            bool        detected;
+        } cad_done_payload;
+        struct {
+            lora_raw_cad_scan_t* p_scan;
+        } cad_scan;
+        struct {
+            uint8_t     sf;     /* zero restores the configured rate */
+            uint8_t     bw;
+            uint8_t     power_cut;
+        } radio_rate;
     };
 } lora_raw_process_event_payload_t;
 
@@ -135,6 +155,71 @@ void lora_raw_process_event(
     bool                                sync
     );
 
+/**
+ * @details     back-to-back tx (burst) mode. While the burst mode is active,
+ *              the tx requests are copied into the burst queue and the process
+ *              sends them back to back, every next frame is issued directly
+ *              from the tx-done of the previous one without passing through the
+ *              idle state nor re-configuring the radio.
+ */
+void lora_raw_process_burst_start(void);
+
+/**
+ * @details     leaves the burst mode, the caller is blocked until all the
+ *              queued frames are sent
+ */
+void lora_raw_process_burst_stop(void);
+
+bool lora_raw_process_burst_is_active(void);
+
+/**
+ * @details     queues a frame for the back-to-back transmission, the caller is
+ *              blocked only if the burst queue is full
+ */
+void lora_raw_process_burst_send(uint8_t* buf, uint8_t len);
+
+/**
+ * @details     enables/disables the rx ring. While the ring is enabled, the
+ *              frames received without a pending sync rx request are stored in
+ *              the ring instead of being delivered with the rx-done event.
+ *              Enabling the ring drops any frames left in it.
+ */
+void lora_raw_process_rx_ring_set(lora_raw_rx_ring_cfg_t* p_cfg);
+
+/**
+ * @details     pops the oldest frame of the rx ring
+ * @return      false if the ring is empty
+ */
+bool lora_raw_process_rx_ring_read(lora_raw_rx_ring_frame_t* p_frame);
+
+/**
+ * @details     pops the oldest frame of the rx ring, the caller is blocked
+ *              until a frame is stored in the ring or the timeout expires
+ * @return      false if no frame is received within the timeout in msec
+ */
+bool lora_raw_process_rx_ring_wait(
+    lora_raw_rx_ring_frame_t* p_frame, uint32_t timeout);
+
+void lora_raw_process_rx_ring_status(lora_raw_rx_ring_status_t* p_status);
+
+/**
+ * @details     runs a channel activity detection over a list of channels, the
+ *              caller is blocked until the scan is over
+ * @return      false if the scan could not run because the radio is busy
+ */
+bool lora_raw_process_cad_scan(lora_raw_cad_scan_t* p_scan);
+
+/**
+ * @details     reads the listen-before-talk counters
+ */
+void lora_raw_process_lbt_stats(lora_raw_lbt_stats_t* p_stats);
+
+/**
+ * @details     displays the back-to-back tx, the rx ring and the
+ *              listen-before-talk statistics
+ */
+void lora_raw_process_stats(void);
+
 /* --- end of file ---------------------------------------------------------- */
 #ifdef __cplusplus
 }
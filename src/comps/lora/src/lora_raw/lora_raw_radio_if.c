@@ -31,6 +31,7 @@
  */
 #include <stdint.h>
 #include <stdlib.h>
+#include <stdio.h>
 #include <math.h>
 
 #define __log_subsystem  lora
@@ -42,6 +43,7 @@
 #include "stub_system.h"
 #include "lora_nvm.h"
 #include "radio_ext.h"
+#include "sx126x_port.h"
 #include "system/timer.h"
 #include "lora_raw_process.h"
 #include "lora_common_utils.h"
@@ -64,6 +66,10 @@
 #define __lora_raw_default_symb_timeout 5
 #define __lora_raw_default_tx_timeout   6000
 #define __lora_raw_default_rx_timeout   6000
+#define __lora_raw_default_lbt          false
+#define __lora_raw_default_lbt_attempts 5
+#define __lora_raw_default_lbt_backoff  100
+#define __lora_raw_default_duty_policy  __LORA_RAW_DUTY_WARN
 
 /** -------------------------------------------------------------------------- *
  * static declarations
@@ -94,6 +100,10 @@ static struct {
     uint8_t     symb_timeout;
     uint32_t    tx_timeout;
     uint32_t    rx_timeout;
+    bool        lbt;        // -- listen before talk
+    uint8_t     lbt_attempts;
+    uint16_t    lbt_backoff;
+    uint8_t     duty_policy; // -- duty-cycle enforcement policy
     uint32_t    time_on_air;
     lora_nvm_record_tail_t record_tail; // -- needed by the lora_nvm.h
 } s_radio_lora_params;
@@ -110,6 +120,10 @@ static void radio_if_nvm_load_defaults_callback(void* ptr, uint32_t size)
     s_radio_lora_params.symb_timeout = __lora_raw_default_symb_timeout;
     s_radio_lora_params.tx_timeout = __lora_raw_default_tx_timeout;
     s_radio_lora_params.rx_timeout = __lora_raw_default_rx_timeout;
+    s_radio_lora_params.lbt        = __lora_raw_default_lbt;
+    s_radio_lora_params.lbt_attempts = __lora_raw_default_lbt_attempts;
+    s_radio_lora_params.lbt_backoff = __lora_raw_default_lbt_backoff;
+    s_radio_lora_params.duty_policy = __lora_raw_default_duty_policy;
     s_radio_lora_params.bw         = __lora_raw_default_bw;
 
     s_radio_lora_params.time_on_air = Radio.TimeOnAir(MODEM_LORA,
@@ -159,6 +173,27 @@ static void lora_raw_handle_nvm_change(void)
 #define __tx_power_chip_min() (int8_t)floor(\
     (float)lora_radio_ext_get_min_tx_power() + s_radio_lora_params.antenna_gain)
 
+/** -------------------------------------------------------------------------- *
+ * rate override of the link adaptation, it is applied over the configured
+ * params without changing them nor their nvm record
+ * --------------------------------------------------------------------------- *
+ */
+static struct {
+    uint8_t     sf;         // -- zero: the configured sf and bw are used
+    uint8_t     bw;
+    uint8_t     power_cut;  // -- dB below the configured tx power
+} s_rate;
+
+#define __rate_sf() (s_rate.sf ? s_rate.sf : s_radio_lora_params.sf)
+#define __rate_bw() (s_rate.sf ? s_rate.bw : s_radio_lora_params.bw)
+
+static int8_t rate_tx_power(void)
+{
+    int8_t power = __tx_power_effective() - s_rate.power_cut;
+    int8_t min_power = lora_radio_ext_get_min_tx_power();
+    return power < min_power ? min_power : power;
+}
+
 static int8_t tx_power_index_to_dbm(int8_t index, float max_eirp)
 {
     float v = max_eirp - index * 2;
@@ -271,7 +306,13 @@ static void cb_on_rx_error( void )
 static void cb_on_cad_done( bool channelActivityDetected )
 {
     __log_callback("on cad done");
-    lora_raw_process_event(__LORA_RAW_PROCESS_CAD_DONE, NULL, false);
+    lora_raw_process_event_payload_t msg = {
+        .type = __PROCESS_MSG_PAYLOAD_CAD_DONE,
+        .cad_done_payload = {
+            .detected = channelActivityDetected
+        }
+    };
+    lora_raw_process_event(__LORA_RAW_PROCESS_CAD_DONE, &msg, false);
 }
 
 static RadioEvents_t RadioEvents = {
@@ -285,36 +326,157 @@ static RadioEvents_t RadioEvents = {
 
 static void loramac_radio_Setup(void)
 {
-    Radio.SetTxConfig(MODEM_LORA, __tx_power_effective(), 0,
-        s_radio_lora_params.bw, s_radio_lora_params.sf, s_radio_lora_params.cr,
+    Radio.SetTxConfig(MODEM_LORA, rate_tx_power(), 0,
+        __rate_bw(), __rate_sf(), s_radio_lora_params.cr,
         s_radio_lora_params.preamble, false, s_radio_lora_params.crc_on, false,
         0, s_radio_lora_params.tx_inv_iq, s_radio_lora_params.tx_timeout);
     
-    Radio.SetRxConfig(MODEM_LORA, s_radio_lora_params.bw,
-        s_radio_lora_params.sf, s_radio_lora_params.cr, 0,
+    Radio.SetRxConfig(MODEM_LORA, __rate_bw(),
+        __rate_sf(), s_radio_lora_params.cr, 0,
         s_radio_lora_params.preamble, s_radio_lora_params.symb_timeout, false,
         s_radio_lora_params.payload, s_radio_lora_params.crc_on, false, 0,
         s_radio_lora_params.rx_inv_iq, true);
 }
 
-static void loramac_radio_ctor(void)
+/** -------------------------------------------------------------------------- *
+ * applied radio settings, they shadow what is written to the radio so that a
+ * reconfiguration writes only the changed settings
+ * --------------------------------------------------------------------------- *
+ */
+typedef struct {
+    lora_region_t region;
+    uint32_t    freq;
+    int8_t      tx_power;
+    uint8_t     sf;
+    uint8_t     bw;
+    uint8_t     cr;
+    uint8_t     preamble;
+    uint8_t     payload;
+    bool        tx_inv_iq;
+    bool        rx_inv_iq;
+    bool        crc_on;
+    uint8_t     symb_timeout;
+    uint32_t    tx_timeout;
+} radio_settings_t;
+
+static struct {
+    bool                valid;  // -- false: the radio is initialized again
+    radio_settings_t    applied;
+
+    uint32_t    full;           // -- reconfigurations with a radio init
+    uint32_t    partial;        // -- reconfigurations of the changed settings
+    uint32_t    unchanged;      // -- reconfigurations with nothing to write
+    uint32_t    spi_last;       // -- spi transactions of the last one
+    uint32_t    spi_full;       // -- spi transactions of the last full one
+    uint32_t    spi_total;
+} s_shadow;
+
+static void settings_get(radio_settings_t* p_set)
+{
+    p_set->region       = s_radio_lora_params.region;
+    p_set->freq         = s_radio_lora_params.freq;
+    p_set->tx_power     = rate_tx_power();
+    p_set->sf           = __rate_sf();
+    p_set->bw           = __rate_bw();
+    p_set->cr           = s_radio_lora_params.cr;
+    p_set->preamble     = s_radio_lora_params.preamble;
+    p_set->payload      = s_radio_lora_params.payload;
+    p_set->tx_inv_iq    = s_radio_lora_params.tx_inv_iq;
+    p_set->rx_inv_iq    = s_radio_lora_params.rx_inv_iq;
+    p_set->crc_on       = s_radio_lora_params.crc_on;
+    p_set->symb_timeout = s_radio_lora_params.symb_timeout;
+    p_set->tx_timeout   = s_radio_lora_params.tx_timeout;
+}
+
+/* the modulation and packet params are written together by the tx and rx
+ * configs of the driver */
+static bool settings_modem_changed(radio_settings_t* p_set)
 {
-    Radio.Init( &RadioEvents );
+    radio_settings_t* p_app = &s_shadow.applied;
+
+    return p_set->sf != p_app->sf || p_set->bw != p_app->bw ||
+        p_set->cr != p_app->cr || p_set->preamble != p_app->preamble ||
+        p_set->payload != p_app->payload ||
+        p_set->tx_inv_iq != p_app->tx_inv_iq ||
+        p_set->rx_inv_iq != p_app->rx_inv_iq ||
+        p_set->crc_on != p_app->crc_on ||
+        p_set->symb_timeout != p_app->symb_timeout ||
+        p_set->tx_timeout != p_app->tx_timeout;
+}
+
+/* the region change re-initializes the radio as the new region band may need
+ * another calibration, the other changes write one command group each */
+static void radio_apply(void)
+{
+    extern uint32_t sx126x_port_get_spi_trx_count(void);
+    uint32_t spi_start = sx126x_port_get_spi_trx_count();
+    radio_settings_t set;
+    bool full;
 
-    Radio.SetChannel( s_radio_lora_params.freq );
+    settings_get(&set);
 
-    loramac_radio_Setup();
+    sx126x_port_batch_begin(__sx126x_port_op_config);
+    full = ! s_shadow.valid || set.region != s_shadow.applied.region;
+    if( full )
+    {
+        __log_info("radio apply -> full");
+        Radio.Init( &RadioEvents );
+        Radio.SetChannel( set.freq );
+        loramac_radio_Setup();
+        ++ s_shadow.full;
+    }
+    else
+    {
+        bool freq = set.freq != s_shadow.applied.freq;
+        bool modem = settings_modem_changed(&set);
+        bool power = set.tx_power != s_shadow.applied.tx_power;
+
+        __log_info("radio apply -> freq:%d modem:%d power:%d",
+            freq, modem, power);
+        if( freq )
+            Radio.SetChannel( set.freq );
+        if( modem )
+            loramac_radio_Setup();  /* it writes the tx power too */
+        else if( power )
+            lora_radio_ext_set_tx_power( set.tx_power );
+
+        if( freq || modem || power )
+            ++ s_shadow.partial;
+        else
+            ++ s_shadow.unchanged;
+    }
+    sx126x_port_batch_end();
+
+    s_shadow.applied = set;
+    s_shadow.valid = true;
+
+    s_shadow.spi_last = sx126x_port_get_spi_trx_count() - spi_start;
+    s_shadow.spi_total += s_shadow.spi_last;
+    if( full )
+        s_shadow.spi_full = s_shadow.spi_last;
+}
+
+static void loramac_radio_ctor(void)
+{
+    /* the radio may have been used by another mode, it is set from scratch */
+    s_shadow.valid = false;
+    radio_apply();
 }
 
 static void loramac_radio_dtor(void)
 {
     Radio.Sleep();
+    s_shadow.valid = false;
 }
 
 static void loramac_radio_process_irqs(void)
 {
     if( Radio.IrqProcess != NULL )
+    {
+        sx126x_port_batch_begin(__sx126x_port_op_irq);
         Radio.IrqProcess( );
+        sx126x_port_batch_end();
+    }
 }
 
 /** -------------------------------------------------------------------------- *
@@ -334,16 +496,82 @@ void lora_raw_radio_dtor(void)
     loramac_radio_dtor();
 }
 
+void lora_raw_radio_reconfig(void)
+{
+    lora_raw_handle_nvm_change();
+    sx126x_port_batch_begin(__sx126x_port_op_config);
+    Radio.Standby();
+    radio_apply();
+    sx126x_port_batch_end();
+}
+
 void lora_raw_radio_send(uint8_t* buf, uint8_t len)
 {
     __log_debug("transmitted data size: %d", len);
+    sx126x_port_batch_begin(__sx126x_port_op_tx);
     Radio.Send(buf, len);
+    sx126x_port_batch_end();
+}
+
+void lora_raw_radio_send_next(uint8_t* buf, uint8_t len)
+{
+    __log_debug("transmitted next data size: %d", len);
+    sx126x_port_batch_begin(__sx126x_port_op_tx);
+    lora_radio_ext_send_next(buf, len);
+    sx126x_port_batch_end();
 }
 
 void lora_raw_radio_recv(void)
 {
     __log_debug("send rx request");
+    sx126x_port_batch_begin(__sx126x_port_op_rx);
     Radio.Rx(0);
+    sx126x_port_batch_end();
+}
+
+void lora_raw_radio_cad(void)
+{
+    __log_debug("start cad");
+    sx126x_port_batch_begin(__sx126x_port_op_cad);
+    Radio.Standby();
+    lora_radio_ext_set_cad_params(__rate_sf());
+    Radio.StartCad();
+    sx126x_port_batch_end();
+}
+
+void lora_raw_radio_set_channel(uint32_t freq)
+{
+    s_shadow.applied.freq = freq ? freq : s_radio_lora_params.freq;
+    Radio.SetChannel(s_shadow.applied.freq);
+}
+
+void lora_raw_radio_retune(uint32_t freq)
+{
+    /* only the rf frequency is written, the modulation and the packet params
+     * stay as they are */
+    s_shadow.applied.freq = freq ? freq : s_radio_lora_params.freq;
+    sx126x_port_batch_begin(__sx126x_port_op_config);
+    Radio.Standby();
+    Radio.SetChannel(s_shadow.applied.freq);
+    sx126x_port_batch_end();
+}
+
+void lora_raw_radio_set_rate(uint8_t sf, uint8_t bw, uint8_t power_cut)
+{
+    __log_debug("set rate sf:%d bw:%d power cut:%d dB", sf, bw, power_cut);
+    s_rate.sf = sf;
+    s_rate.bw = bw;
+    s_rate.power_cut = sf ? power_cut : 0;
+    sx126x_port_batch_begin(__sx126x_port_op_config);
+    Radio.Standby();
+    radio_apply();
+    sx126x_port_batch_end();
+}
+
+void lora_raw_radio_get_rate(uint8_t* p_sf, uint8_t* p_bw)
+{
+    *p_sf = __rate_sf();
+    *p_bw = __rate_bw();
 }
 
 lora_error_t lora_raw_radio_reset_params(void)
@@ -415,6 +643,10 @@ static void reset_region_params(lora_region_t region)
     s_radio_lora_params.symb_timeout = __lora_raw_default_symb_timeout;
     s_radio_lora_params.tx_timeout = __lora_raw_default_tx_timeout;
     s_radio_lora_params.rx_timeout = __lora_raw_default_rx_timeout;
+    s_radio_lora_params.lbt        = __lora_raw_default_lbt;
+    s_radio_lora_params.lbt_attempts = __lora_raw_default_lbt_attempts;
+    s_radio_lora_params.lbt_backoff = __lora_raw_default_lbt_backoff;
+    s_radio_lora_params.duty_policy = __lora_raw_default_duty_policy;
 
     tx_power_correct();
 }
@@ -434,6 +666,10 @@ static const char* lora_raw_params_names[] = {
     [__LORA_RAW_PARAM_SYMB_TIMEOUT ] = "symbol_timeout", 
     [__LORA_RAW_PARAM_TX_TIMEOUT   ] = "tx_timeout",
     [__LORA_RAW_PARAM_RX_TIMEOUT   ] = "rx_timeout", 
+    [__LORA_RAW_PARAM_LBT          ] = "lbt",
+    [__LORA_RAW_PARAM_LBT_ATTEMPTS ] = "lbt_attempts",
+    [__LORA_RAW_PARAM_LBT_BACKOFF  ] = "lbt_backoff",
+    [__LORA_RAW_PARAM_DUTY_POLICY  ] = "duty_policy",
 };
 
 static const char* get_param_string(lora_raw_param_type_t type)
@@ -603,6 +839,29 @@ static bool verify_rx_timeout(lora_region_t region, void* param)
 {
     return true;
 }
+static bool verify_lbt(lora_region_t region, void* param)
+{
+    return true;
+}
+static bool verify_lbt_attempts(lora_region_t region, void* param)
+{
+    return *(uint8_t*)param > 0;
+}
+static bool verify_lbt_backoff(lora_region_t region, void* param)
+{
+    return *(uint16_t*)param > 0;
+}
+static bool verify_duty_policy(lora_region_t region, void* param)
+{
+    switch(*(uint8_t*)param)
+    {
+        case __LORA_RAW_DUTY_WARN:
+        case __LORA_RAW_DUTY_REJECT:
+        case __LORA_RAW_DUTY_QUEUE:
+            return true;
+    }
+    return false;
+}
 
 static bool (*lora_raw_param_verification_table [] )(lora_region_t, void*) = {
     [__LORA_RAW_PARAM_REGION       ] = verify_region,
@@ -620,6 +879,10 @@ static bool (*lora_raw_param_verification_table [] )(lora_region_t, void*) = {
     [__LORA_RAW_PARAM_SYMB_TIMEOUT ] = verify_symb_timeout,
     [__LORA_RAW_PARAM_TX_TIMEOUT   ] = verify_tx_timeout,
     [__LORA_RAW_PARAM_RX_TIMEOUT   ] = verify_rx_timeout,
+    [__LORA_RAW_PARAM_LBT          ] = verify_lbt,
+    [__LORA_RAW_PARAM_LBT_ATTEMPTS ] = verify_lbt_attempts,
+    [__LORA_RAW_PARAM_LBT_BACKOFF  ] = verify_lbt_backoff,
+    [__LORA_RAW_PARAM_DUTY_POLICY  ] = verify_duty_policy,
 };
 
 lora_error_t lora_raw_radio_verify_param(lora_raw_param_t* param)
@@ -680,6 +943,10 @@ lora_error_t lora_raw_radio_set_param(lora_raw_param_t* param)
         case __LORA_RAW_PARAM_SYMB_TIMEOUT: __set_param(symb_timeout);break;
         case __LORA_RAW_PARAM_TX_TIMEOUT:   __set_param(tx_timeout);break;
         case __LORA_RAW_PARAM_RX_TIMEOUT:   __set_param(rx_timeout);break;
+        case __LORA_RAW_PARAM_LBT:          __set_param(lbt);       break;
+        case __LORA_RAW_PARAM_LBT_ATTEMPTS: __set_param(lbt_attempts);break;
+        case __LORA_RAW_PARAM_LBT_BACKOFF:  __set_param(lbt_backoff);break;
+        case __LORA_RAW_PARAM_DUTY_POLICY:  __set_param(duty_policy);break;
         default:
             return __LORA_ERROR;
     }
@@ -708,6 +975,10 @@ lora_error_t lora_raw_radio_get_param(lora_raw_param_t* param)
         case __LORA_RAW_PARAM_SYMB_TIMEOUT: __get_param(symb_timeout);break;
         case __LORA_RAW_PARAM_TX_TIMEOUT:   __get_param(tx_timeout);break;
         case __LORA_RAW_PARAM_RX_TIMEOUT:   __get_param(rx_timeout);break;
+        case __LORA_RAW_PARAM_LBT:          __get_param(lbt);       break;
+        case __LORA_RAW_PARAM_LBT_ATTEMPTS: __get_param(lbt_attempts);break;
+        case __LORA_RAW_PARAM_LBT_BACKOFF:  __get_param(lbt_backoff);break;
+        case __LORA_RAW_PARAM_DUTY_POLICY:  __get_param(duty_policy);break;
         default:
             return __LORA_ERROR;
     }
@@ -809,12 +1080,78 @@ lora_error_t lora_raw_radio_get_default_region_param(lora_raw_param_t* param)
         case __LORA_RAW_PARAM_RX_TIMEOUT:
             param->param.rx_timeout = __lora_raw_default_rx_timeout;
             break;
+        case __LORA_RAW_PARAM_LBT:
+            param->param.lbt = __lora_raw_default_lbt;
+            break;
+        case __LORA_RAW_PARAM_LBT_ATTEMPTS:
+            param->param.lbt_attempts = __lora_raw_default_lbt_attempts;
+            break;
+        case __LORA_RAW_PARAM_LBT_BACKOFF:
+            param->param.lbt_backoff = __lora_raw_default_lbt_backoff;
+            break;
+        case __LORA_RAW_PARAM_DUTY_POLICY:
+            param->param.duty_policy = __lora_raw_default_duty_policy;
+            break;
         default:
             return __LORA_ERROR;
     }
     return __LORA_OK;
 }
 
+/**
+ * the hopping channel plans follow the channels of the LoRaWAN regional
+ * parameters, a channel is repeated every \a step Hz from \a first
+ */
+static const struct {
+    lora_region_t   region;
+    uint32_t        first;
+    uint32_t        step;
+    uint8_t         count;
+} s_region_channels[] = {
+    { __LORA_REGION_AS923, 922000000, 200000,  8 },
+    { __LORA_REGION_AU915, 915200000, 200000, 16 },
+    { __LORA_REGION_CN470, 470300000, 200000, 16 },
+    { __LORA_REGION_CN779, 779500000, 200000,  3 },
+    { __LORA_REGION_EU433, 433175000, 200000,  3 },
+    { __LORA_REGION_EU868, 867100000, 200000,  8 },
+    { __LORA_REGION_KR920, 922100000, 200000,  7 },
+    { __LORA_REGION_IN865, 865100000, 200000,  8 },
+    { __LORA_REGION_US915, 902300000, 200000, 16 },
+    { __LORA_REGION_RU864, 868900000, 200000,  2 },
+};
+
+uint8_t lora_raw_radio_get_region_channels(lora_region_t region,
+    uint32_t* freqs, uint8_t max)
+{
+    uint8_t count = 0;
+    uint32_t spacing;
+    uint32_t last;
+    uint32_t freq;
+    uint32_t n = sizeof(s_region_channels) / sizeof(s_region_channels[0]);
+    uint32_t i;
+
+    for(i = 0; i < n; ++i)
+        if( s_region_channels[i].region == region )
+            break;
+    if( i == n )
+        return 0;
+
+    /* the wider bandwidths skip the overlapping channels */
+    spacing = s_region_channels[i].step *
+        ( s_radio_lora_params.bw == __LORA_BW_500_KHZ ? 3 :
+          s_radio_lora_params.bw == __LORA_BW_250_KHZ ? 2 : 1 );
+    last = s_region_channels[i].first +
+        s_region_channels[i].step * (s_region_channels[i].count - 1);
+
+    for(freq = s_region_channels[i].first; freq <= last && count < max;
+        freq += spacing)
+    {
+        if( verify_freq(region, &freq) )
+            freqs[count ++] = freq;
+    }
+    return count;
+}
+
 void lora_raw_radio_process_irqs(void)
 {
     loramac_radio_process_irqs();
@@ -828,6 +1165,8 @@ void lora_raw_radio_sleep(void)
 void lora_raw_radio_tx_cont_wave(uint32_t freq, int8_t power,
     uint32_t time_msec)
 {
+    s_shadow.applied.freq = freq;
+    s_shadow.applied.tx_power = power;
     Radio.SetTxContinuousWave(freq, power, time_msec/1000);
 }
 
@@ -846,6 +1185,16 @@ void lora_raw_radio_stats(void)
     #define __temp(item, val_fmt, args...) \
         log_list_item("%-15s: " val_fmt __default__, item, args)
 
+    uint32_t reconfigs = s_shadow.full + s_shadow.partial + s_shadow.unchanged;
+    static const uint32_t bounds[] = __sx126x_port_busy_bounds_us;
+    sx126x_port_busy_stats_t busy;
+    uint32_t waits = 0;
+    uint8_t i;
+
+    sx126x_port_get_busy_stats(&busy);
+    for(i = 0; i < __sx126x_port_busy_kinds; ++i)
+        waits += busy.waits[i];
+
     log_list_start(4);
 
     log_list_indent();
@@ -901,6 +1250,43 @@ void lora_raw_radio_stats(void)
         __temp("rx_timeout", __yellow__"%d"__default__" msec",
             s_radio_lora_params.rx_timeout);
         __temp("rx_iq", "%s", s_on_off[ s_radio_lora_params.rx_inv_iq ]);
+    log_list_outdent();
+    log_list_item(__blue__"listen before talk");
+    log_list_indent();
+        __temp("lbt", "%s", s_on_off[ s_radio_lora_params.lbt ]);
+        __temp("lbt_attempts", __yellow__"%d",
+            s_radio_lora_params.lbt_attempts);
+        __temp("lbt_backoff", __yellow__"%d"__default__" msec",
+            s_radio_lora_params.lbt_backoff);
+    log_list_outdent();
+    log_list_item(__blue__"reconfiguration");
+    log_list_indent();
+        __temp("full", __yellow__"%u", s_shadow.full);
+        __temp("partial", __yellow__"%u", s_shadow.partial);
+        __temp("unchanged", __yellow__"%u", s_shadow.unchanged);
+        __temp("spi_trx_last", __yellow__"%u", s_shadow.spi_last);
+        __temp("spi_trx_full", __yellow__"%u", s_shadow.spi_full);
+        __temp("spi_trx_mean", __yellow__"%u", reconfigs ?
+            s_shadow.spi_total / reconfigs : 0);
+    log_list_outdent();
+    log_list_item(__blue__"busy wait");
+    log_list_indent();
+        __temp("free", __yellow__"%u", busy.waits[__sx126x_port_busy_free]);
+        __temp("notified", __yellow__"%u",
+            busy.waits[__sx126x_port_busy_event]);
+        __temp("polled", __yellow__"%u", busy.waits[__sx126x_port_busy_polled]);
+        __temp("mean", __yellow__"%u"__default__" usec", waits ?
+            (uint32_t)(busy.sum_us / waits) : 0);
+        __temp("max", __yellow__"%u"__default__" usec", busy.max_us);
+        for(i = 0; i < __sx126x_port_busy_buckets; ++i)
+        {
+            char label[16];
+            if( i < __sx126x_port_busy_buckets - 1 )
+                snprintf(label, sizeof(label), "<= %u us", bounds[i]);
+            else
+                snprintf(label, sizeof(label), "> %u us", bounds[i - 1]);
+            __temp(label, __yellow__"%u", busy.hist[i]);
+        }
     log_list_end();
 }
 
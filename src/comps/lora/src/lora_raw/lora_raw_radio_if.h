@@ -48,10 +48,51 @@ void lora_raw_radio_ctor(void);
 
 void lora_raw_radio_dtor(void);
 
+/**
+ * @brief   applies the present params to the radio, only the settings changed
+ *          since the last apply are written, the radio is left in standby
+ */
+void lora_raw_radio_reconfig(void);
+
 void lora_raw_radio_send(uint8_t* buf, uint8_t len);
 
+/**
+ * @brief   sends a payload directly after the tx-done of a previous frame
+ *          without re-configuring or waking up the radio (back-to-back tx)
+ */
+void lora_raw_radio_send_next(uint8_t* buf, uint8_t len);
+
 void lora_raw_radio_recv(void);
 
+/**
+ * @brief   starts a channel activity detection on the current channel, the
+ *          result comes with the cad-done event
+ */
+void lora_raw_radio_cad(void);
+
+/**
+ * @brief   switches the radio channel, zero restores the configured frequency
+ */
+void lora_raw_radio_set_channel(uint32_t freq);
+
+/**
+ * @brief   moves a listening or idle radio to another channel, zero restores
+ *          the configured one, the radio is left in standby
+ */
+void lora_raw_radio_retune(uint32_t freq);
+
+/**
+ * @brief   overrides the configured spreading factor and bandwidth and cuts
+ *          the tx power by \a power_cut dB without changing the configured
+ *          params, a zero \a sf restores the configured ones
+ */
+void lora_raw_radio_set_rate(uint8_t sf, uint8_t bw, uint8_t power_cut);
+
+/**
+ * @brief   the spreading factor and bandwidth in use, including the override
+ */
+void lora_raw_radio_get_rate(uint8_t* p_sf, uint8_t* p_bw);
+
 lora_error_t lora_raw_radio_reset_params(void);
 
 lora_error_t lora_raw_radio_set_param(lora_raw_param_t* param);
@@ -60,6 +101,14 @@ lora_error_t lora_raw_radio_get_param(lora_raw_param_t* param);
 
 lora_error_t lora_raw_radio_get_default_region_param(lora_raw_param_t* param);
 
+/**
+ * @brief   fills \a freqs with up to \a max channels of the region default
+ *          channel plan, spaced for the configured bandwidth
+ * @return  the channels count, zero for an unsupported region
+ */
+uint8_t lora_raw_radio_get_region_channels(lora_region_t region,
+    uint32_t* freqs, uint8_t max);
+
 lora_error_t lora_raw_radio_verify_param(lora_raw_param_t* param);
 
 lora_error_t lora_raw_radio_apply_params(void);
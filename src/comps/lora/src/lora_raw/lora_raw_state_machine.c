@@ -15,72 +15,110 @@ void __sm_action_fun(lora_raw, toa_temp_leave)(void* data);
 
 
 /* --- INPUTS --------------------------------------------------------------- */
-static input_table_t sm_lora_raw_inputs_table[] = {
-    [__sm_input_id(lora_raw, req_tx)] = { "req_tx" },
-    [__sm_input_id(lora_raw, req_rx)] = { "req_rx" },
-    [__sm_input_id(lora_raw, radio_irq)] = { "radio_irq" },
-    [__sm_input_id(lora_raw, req_rx_cont)] = { "req_rx_cont" },
-    [__sm_input_id(lora_raw, tx_done)] = { "tx_done" },
-    [__sm_input_id(lora_raw, tx_timeout)] = { "tx_timeout" },
-    [__sm_input_id(lora_raw, opr_timeout)] = { "opr_timeout" },
-    [__sm_input_id(lora_raw, rx_done)] = { "rx_done" },
-    [__sm_input_id(lora_raw, rx_timeout)] = { "rx_timeout" },
-    [__sm_input_id(lora_raw, rx_fail)] = { "rx_fail" },
-    [__sm_input_id(lora_raw, toa_expire)] = { "toa_expire" },
-    [__sm_input_id(lora_raw, end_rx_cont)] = { "end_rx_cont" },
-    [__sm_input_id(lora_raw, end_tx_cont)] = { "end_tx_cont" },
+static const input_table_t sm_lora_raw_inputs_table[] = {
+    [__sm_input_id(lora_raw, req_tx)] = { __sm_name("req_tx") },
+    [__sm_input_id(lora_raw, req_rx)] = { __sm_name("req_rx") },
+    [__sm_input_id(lora_raw, radio_irq)] = { __sm_name("radio_irq") },
+    [__sm_input_id(lora_raw, req_rx_cont)] = { __sm_name("req_rx_cont") },
+    [__sm_input_id(lora_raw, tx_done)] = { __sm_name("tx_done") },
+    [__sm_input_id(lora_raw, tx_timeout)] = { __sm_name("tx_timeout") },
+    [__sm_input_id(lora_raw, opr_timeout)] = { __sm_name("opr_timeout") },
+    [__sm_input_id(lora_raw, rx_done)] = { __sm_name("rx_done") },
+    [__sm_input_id(lora_raw, rx_timeout)] = { __sm_name("rx_timeout") },
+    [__sm_input_id(lora_raw, rx_fail)] = { __sm_name("rx_fail") },
+    [__sm_input_id(lora_raw, hop_expire)] = { __sm_name("hop_expire") },
+    [__sm_input_id(lora_raw, toa_expire)] = { __sm_name("toa_expire") },
+    [__sm_input_id(lora_raw, end_rx_cont)] = { __sm_name("end_rx_cont") },
+    [__sm_input_id(lora_raw, end_tx_cont)] = { __sm_name("end_tx_cont") },
+    [__sm_input_id(lora_raw, req_tx_burst)] = { __sm_name("req_tx_burst") },
+    [__sm_input_id(lora_raw, cad_done)] = { __sm_name("cad_done") },
+    [__sm_input_id(lora_raw, backoff_expire)] = { __sm_name("backoff_expire") },
+    [__sm_input_id(lora_raw, req_cad_scan)] = { __sm_name("req_cad_scan") },
 };
 #define sm_lora_raw_inputs_table_size \
     (sizeof(sm_lora_raw_inputs_table)/sizeof(input_table_t))
 
 /* --- ACTIONS -------------------------------------------------------------- */
-static action_table_t sm_lora_raw_actions_table[] = {
+static const action_table_t sm_lora_raw_actions_table[] = {
     [__sm_action_id(lora_raw, start_tx)] = {
-        "start_tx",
+        __sm_name("start_tx"),
         __sm_action_fun(lora_raw, start_tx)},
     [__sm_action_id(lora_raw, start_rx)] = {
-        "start_rx",
+        __sm_name("start_rx"),
         __sm_action_fun(lora_raw, start_rx)},
     [__sm_action_id(lora_raw, process_irq)] = {
-        "process_irq",
+        __sm_name("process_irq"),
         __sm_action_fun(lora_raw, process_irq)},
     [__sm_action_id(lora_raw, handle_tx_done)] = {
-        "handle_tx_done",
+        __sm_name("handle_tx_done"),
         __sm_action_fun(lora_raw, handle_tx_done)},
     [__sm_action_id(lora_raw, handle_tx_timeout)] = {
-        "handle_tx_timeout",
+        __sm_name("handle_tx_timeout"),
         __sm_action_fun(lora_raw, handle_tx_timeout)},
     [__sm_action_id(lora_raw, handle_rx_done)] = {
-        "handle_rx_done",
+        __sm_name("handle_rx_done"),
         __sm_action_fun(lora_raw, handle_rx_done)},
     [__sm_action_id(lora_raw, handle_rx_timeout)] = {
-        "handle_rx_timeout",
+        __sm_name("handle_rx_timeout"),
         __sm_action_fun(lora_raw, handle_rx_timeout)},
     [__sm_action_id(lora_raw, handle_rx_fail)] = {
-        "handle_rx_fail",
+        __sm_name("handle_rx_fail"),
         __sm_action_fun(lora_raw, handle_rx_fail)},
+    [__sm_action_id(lora_raw, hop_rx)] = {
+        __sm_name("hop_rx"),
+        __sm_action_fun(lora_raw, hop_rx)},
     [__sm_action_id(lora_raw, back_to_rx)] = {
-        "back_to_rx",
+        __sm_name("back_to_rx"),
         __sm_action_fun(lora_raw, back_to_rx)},
     [__sm_action_id(lora_raw, postpone)] = {
-        "postpone",
+        __sm_name("postpone"),
         0},
+    [__sm_action_id(lora_raw, hop_defer)] = {
+        __sm_name("hop_defer"),
+        __sm_action_fun(lora_raw, hop_defer)},
     [__sm_action_id(lora_raw, stop_rx_cont)] = {
-        "stop_rx_cont",
+        __sm_name("stop_rx_cont"),
         __sm_action_fun(lora_raw, stop_rx_cont)},
     [__sm_action_id(lora_raw, do_nothing)] = {
-        "do_nothing",
+        __sm_name("do_nothing"),
         0},
     [__sm_action_id(lora_raw, radio_sleep)] = {
-        "radio_sleep",
+        __sm_name("radio_sleep"),
         __sm_action_fun(lora_raw, radio_sleep)},
+    [__sm_action_id(lora_raw, start_burst)] = {
+        __sm_name("start_burst"),
+        __sm_action_fun(lora_raw, start_burst)},
+    [__sm_action_id(lora_raw, burst_next)] = {
+        __sm_name("burst_next"),
+        __sm_action_fun(lora_raw, burst_next)},
+    [__sm_action_id(lora_raw, burst_abort)] = {
+        __sm_name("burst_abort"),
+        __sm_action_fun(lora_raw, burst_abort)},
+    [__sm_action_id(lora_raw, lbt_check)] = {
+        __sm_name("lbt_check"),
+        __sm_action_fun(lora_raw, lbt_check)},
+    [__sm_action_id(lora_raw, lbt_retry)] = {
+        __sm_name("lbt_retry"),
+        __sm_action_fun(lora_raw, lbt_retry)},
+    [__sm_action_id(lora_raw, lbt_abort)] = {
+        __sm_name("lbt_abort"),
+        __sm_action_fun(lora_raw, lbt_abort)},
+    [__sm_action_id(lora_raw, start_cad_scan)] = {
+        __sm_name("start_cad_scan"),
+        __sm_action_fun(lora_raw, start_cad_scan)},
+    [__sm_action_id(lora_raw, cad_scan_next)] = {
+        __sm_name("cad_scan_next"),
+        __sm_action_fun(lora_raw, cad_scan_next)},
+    [__sm_action_id(lora_raw, cad_scan_abort)] = {
+        __sm_name("cad_scan_abort"),
+        __sm_action_fun(lora_raw, cad_scan_abort)},
 };
 #define sm_lora_raw_actions_table_size \
     (sizeof(sm_lora_raw_actions_table)/sizeof(action_table_t))
 
 /* --- STATES --------------------------------------------------------------- */
 /* --- state -> idle -------------------------------------------------------- */
-static state_trans_table_t sm_lora_raw_idle_trans_table [] = {
+static const state_trans_table_t sm_lora_raw_idle_trans_table [] = {
     {
         .input_id = __sm_input_id(lora_raw, req_tx),
         .action_id = __sm_action_id(lora_raw, start_tx),
@@ -101,12 +139,25 @@ static state_trans_table_t sm_lora_raw_idle_trans_table [] = {
         .action_id = __sm_action_id(lora_raw, start_rx),
         .next_state_id = __sm_state_id(lora_raw, rx_cont),
     },
+    {
+        .input_id = __sm_input_id(lora_raw, req_tx_burst),
+        .action_id = __sm_action_id(lora_raw, start_burst),
+        .next_state_id = __sm_state_id(lora_raw, tx_burst),
+    },
+    {
+        .input_id = __sm_input_id(lora_raw, req_cad_scan),
+        .action_id = __sm_action_id(lora_raw, start_cad_scan),
+        .next_state_id = __sm_state_id(lora_raw, cad_scan),
+    },
 };
 #define sm_lora_raw_idle_trans_table_size \
     (sizeof(sm_lora_raw_idle_trans_table)/sizeof(state_trans_table_t))
+#ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+static uint32_t sm_lora_raw_idle_trans_hits [sm_lora_raw_idle_trans_table_size];
+#endif
 
 /* --- state -> tx ---------------------------------------------------------- */
-static state_trans_table_t sm_lora_raw_tx_trans_table [] = {
+static const state_trans_table_t sm_lora_raw_tx_trans_table [] = {
     {
         .input_id = __sm_input_id(lora_raw, tx_done),
         .action_id = __sm_action_id(lora_raw, handle_tx_done),
@@ -130,9 +181,12 @@ static state_trans_table_t sm_lora_raw_tx_trans_table [] = {
 };
 #define sm_lora_raw_tx_trans_table_size \
     (sizeof(sm_lora_raw_tx_trans_table)/sizeof(state_trans_table_t))
+#ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+static uint32_t sm_lora_raw_tx_trans_hits [sm_lora_raw_tx_trans_table_size];
+#endif
 
 /* --- state -> rx ---------------------------------------------------------- */
-static state_trans_table_t sm_lora_raw_rx_trans_table [] = {
+static const state_trans_table_t sm_lora_raw_rx_trans_table [] = {
     {
         .input_id = __sm_input_id(lora_raw, radio_irq),
         .action_id = __sm_action_id(lora_raw, process_irq),
@@ -163,12 +217,20 @@ static state_trans_table_t sm_lora_raw_rx_trans_table [] = {
         .action_id = __sm_action_id(lora_raw, start_tx),
         .next_state_id = __sm_state_id(lora_raw, tx),
     },
+    {
+        .input_id = __sm_input_id(lora_raw, hop_expire),
+        .action_id = __sm_action_id(lora_raw, hop_rx),
+        .next_state_id = __sm_state_id(lora_raw, rx),
+    },
 };
 #define sm_lora_raw_rx_trans_table_size \
     (sizeof(sm_lora_raw_rx_trans_table)/sizeof(state_trans_table_t))
+#ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+static uint32_t sm_lora_raw_rx_trans_hits [sm_lora_raw_rx_trans_table_size];
+#endif
 
 /* --- state -> rx_cont ----------------------------------------------------- */
-static state_trans_table_t sm_lora_raw_rx_cont_trans_table [] = {
+static const state_trans_table_t sm_lora_raw_rx_cont_trans_table [] = {
     {
         .input_id = __sm_input_id(lora_raw, end_rx_cont),
         .action_id = __sm_action_id(lora_raw, stop_rx_cont),
@@ -189,12 +251,20 @@ static state_trans_table_t sm_lora_raw_rx_cont_trans_table [] = {
         .action_id = __sm_action_id(lora_raw, start_tx),
         .next_state_id = __sm_state_id(lora_raw, tx_temp),
     },
+    {
+        .input_id = __sm_input_id(lora_raw, hop_expire),
+        .action_id = __sm_action_id(lora_raw, hop_rx),
+        .next_state_id = __sm_state_id(lora_raw, rx_cont),
+    },
 };
 #define sm_lora_raw_rx_cont_trans_table_size \
     (sizeof(sm_lora_raw_rx_cont_trans_table)/sizeof(state_trans_table_t))
+#ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+static uint32_t sm_lora_raw_rx_cont_trans_hits [sm_lora_raw_rx_cont_trans_table_size];
+#endif
 
 /* --- state -> toa --------------------------------------------------------- */
-static state_trans_table_t sm_lora_raw_toa_trans_table [] = {
+static const state_trans_table_t sm_lora_raw_toa_trans_table [] = {
     {
         .input_id = __sm_input_id(lora_raw, toa_expire),
         .action_id = __sm_action_id(lora_raw, back_to_rx),
@@ -215,12 +285,20 @@ static state_trans_table_t sm_lora_raw_toa_trans_table [] = {
         .action_id = __sm_action_id(lora_raw, start_tx),
         .next_state_id = __sm_state_id(lora_raw, tx),
     },
+    {
+        .input_id = __sm_input_id(lora_raw, hop_expire),
+        .action_id = __sm_action_id(lora_raw, hop_defer),
+        .next_state_id = __sm_state_id(lora_raw, toa),
+    },
 };
 #define sm_lora_raw_toa_trans_table_size \
     (sizeof(sm_lora_raw_toa_trans_table)/sizeof(state_trans_table_t))
+#ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+static uint32_t sm_lora_raw_toa_trans_hits [sm_lora_raw_toa_trans_table_size];
+#endif
 
 /* --- state -> tx_temp ----------------------------------------------------- */
-static state_trans_table_t sm_lora_raw_tx_temp_trans_table [] = {
+static const state_trans_table_t sm_lora_raw_tx_temp_trans_table [] = {
     {
         .input_id = __sm_input_id(lora_raw, end_rx_cont),
         .action_id = __sm_action_id(lora_raw, do_nothing),
@@ -249,9 +327,12 @@ static state_trans_table_t sm_lora_raw_tx_temp_trans_table [] = {
 };
 #define sm_lora_raw_tx_temp_trans_table_size \
     (sizeof(sm_lora_raw_tx_temp_trans_table)/sizeof(state_trans_table_t))
+#ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+static uint32_t sm_lora_raw_tx_temp_trans_hits [sm_lora_raw_tx_temp_trans_table_size];
+#endif
 
 /* --- state -> toa_temp ---------------------------------------------------- */
-static state_trans_table_t sm_lora_raw_toa_temp_trans_table [] = {
+static const state_trans_table_t sm_lora_raw_toa_temp_trans_table [] = {
     {
         .input_id = __sm_input_id(lora_raw, end_rx_cont),
         .action_id = __sm_action_id(lora_raw, stop_rx_cont),
@@ -272,12 +353,20 @@ static state_trans_table_t sm_lora_raw_toa_temp_trans_table [] = {
         .action_id = __sm_action_id(lora_raw, start_tx),
         .next_state_id = __sm_state_id(lora_raw, tx_temp),
     },
+    {
+        .input_id = __sm_input_id(lora_raw, hop_expire),
+        .action_id = __sm_action_id(lora_raw, hop_defer),
+        .next_state_id = __sm_state_id(lora_raw, toa_temp),
+    },
 };
 #define sm_lora_raw_toa_temp_trans_table_size \
     (sizeof(sm_lora_raw_toa_temp_trans_table)/sizeof(state_trans_table_t))
+#ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+static uint32_t sm_lora_raw_toa_temp_trans_hits [sm_lora_raw_toa_temp_trans_table_size];
+#endif
 
 /* --- state -> tx_cont ----------------------------------------------------- */
-static state_trans_table_t sm_lora_raw_tx_cont_trans_table [] = {
+static const state_trans_table_t sm_lora_raw_tx_cont_trans_table [] = {
     {
         .input_id = __sm_input_id(lora_raw, tx_timeout),
         .action_id = __sm_action_id(lora_raw, radio_sleep),
@@ -291,73 +380,260 @@ static state_trans_table_t sm_lora_raw_tx_cont_trans_table [] = {
 };
 #define sm_lora_raw_tx_cont_trans_table_size \
     (sizeof(sm_lora_raw_tx_cont_trans_table)/sizeof(state_trans_table_t))
+#ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+static uint32_t sm_lora_raw_tx_cont_trans_hits [sm_lora_raw_tx_cont_trans_table_size];
+#endif
+
+/* --- state -> tx_burst ---------------------------------------------------- */
+static const state_trans_table_t sm_lora_raw_tx_burst_trans_table [] = {
+    {
+        .input_id = __sm_input_id(lora_raw, tx_done),
+        .action_id = __sm_action_id(lora_raw, burst_next),
+        .next_state_id = __sm_state_id(lora_raw, tx_burst),
+    },
+    {
+        .input_id = __sm_input_id(lora_raw, tx_timeout),
+        .action_id = __sm_action_id(lora_raw, burst_abort),
+        .next_state_id = __sm_state_id(lora_raw, idle),
+    },
+    {
+        .input_id = __sm_input_id(lora_raw, opr_timeout),
+        .action_id = __sm_action_id(lora_raw, burst_abort),
+        .next_state_id = __sm_state_id(lora_raw, idle),
+    },
+    {
+        .input_id = __sm_input_id(lora_raw, radio_irq),
+        .action_id = __sm_action_id(lora_raw, process_irq),
+        .next_state_id = __sm_state_id(lora_raw, tx_burst),
+    },
+};
+#define sm_lora_raw_tx_burst_trans_table_size \
+    (sizeof(sm_lora_raw_tx_burst_trans_table)/sizeof(state_trans_table_t))
+#ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+static uint32_t sm_lora_raw_tx_burst_trans_hits [sm_lora_raw_tx_burst_trans_table_size];
+#endif
+
+/* --- state -> lbt --------------------------------------------------------- */
+static const state_trans_table_t sm_lora_raw_lbt_trans_table [] = {
+    {
+        .input_id = __sm_input_id(lora_raw, cad_done),
+        .action_id = __sm_action_id(lora_raw, lbt_check),
+        .next_state_id = __sm_state_id(lora_raw, lbt),
+    },
+    {
+        .input_id = __sm_input_id(lora_raw, backoff_expire),
+        .action_id = __sm_action_id(lora_raw, lbt_retry),
+        .next_state_id = __sm_state_id(lora_raw, lbt),
+    },
+    {
+        .input_id = __sm_input_id(lora_raw, radio_irq),
+        .action_id = __sm_action_id(lora_raw, process_irq),
+        .next_state_id = __sm_state_id(lora_raw, lbt),
+    },
+    {
+        .input_id = __sm_input_id(lora_raw, opr_timeout),
+        .action_id = __sm_action_id(lora_raw, lbt_abort),
+        .next_state_id = __sm_state_id(lora_raw, idle),
+    },
+};
+#define sm_lora_raw_lbt_trans_table_size \
+    (sizeof(sm_lora_raw_lbt_trans_table)/sizeof(state_trans_table_t))
+#ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+static uint32_t sm_lora_raw_lbt_trans_hits [sm_lora_raw_lbt_trans_table_size];
+#endif
+
+/* --- state -> lbt_temp ---------------------------------------------------- */
+static const state_trans_table_t sm_lora_raw_lbt_temp_trans_table [] = {
+    {
+        .input_id = __sm_input_id(lora_raw, cad_done),
+        .action_id = __sm_action_id(lora_raw, lbt_check),
+        .next_state_id = __sm_state_id(lora_raw, lbt_temp),
+    },
+    {
+        .input_id = __sm_input_id(lora_raw, backoff_expire),
+        .action_id = __sm_action_id(lora_raw, lbt_retry),
+        .next_state_id = __sm_state_id(lora_raw, lbt_temp),
+    },
+    {
+        .input_id = __sm_input_id(lora_raw, radio_irq),
+        .action_id = __sm_action_id(lora_raw, process_irq),
+        .next_state_id = __sm_state_id(lora_raw, lbt_temp),
+    },
+    {
+        .input_id = __sm_input_id(lora_raw, opr_timeout),
+        .action_id = __sm_action_id(lora_raw, lbt_abort),
+        .next_state_id = __sm_state_id(lora_raw, rx_cont),
+    },
+    {
+        .input_id = __sm_input_id(lora_raw, end_rx_cont),
+        .action_id = __sm_action_id(lora_raw, do_nothing),
+        .next_state_id = __sm_state_id(lora_raw, lbt),
+    },
+};
+#define sm_lora_raw_lbt_temp_trans_table_size \
+    (sizeof(sm_lora_raw_lbt_temp_trans_table)/sizeof(state_trans_table_t))
+#ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+static uint32_t sm_lora_raw_lbt_temp_trans_hits [sm_lora_raw_lbt_temp_trans_table_size];
+#endif
+
+/* --- state -> cad_scan ---------------------------------------------------- */
+static const state_trans_table_t sm_lora_raw_cad_scan_trans_table [] = {
+    {
+        .input_id = __sm_input_id(lora_raw, cad_done),
+        .action_id = __sm_action_id(lora_raw, cad_scan_next),
+        .next_state_id = __sm_state_id(lora_raw, cad_scan),
+    },
+    {
+        .input_id = __sm_input_id(lora_raw, radio_irq),
+        .action_id = __sm_action_id(lora_raw, process_irq),
+        .next_state_id = __sm_state_id(lora_raw, cad_scan),
+    },
+    {
+        .input_id = __sm_input_id(lora_raw, opr_timeout),
+        .action_id = __sm_action_id(lora_raw, cad_scan_abort),
+        .next_state_id = __sm_state_id(lora_raw, idle),
+    },
+};
+#define sm_lora_raw_cad_scan_trans_table_size \
+    (sizeof(sm_lora_raw_cad_scan_trans_table)/sizeof(state_trans_table_t))
+#ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+static uint32_t sm_lora_raw_cad_scan_trans_hits [sm_lora_raw_cad_scan_trans_table_size];
+#endif
 
 /* --- states-table --------------------------------------------------------- */
-static state_table_t sm_lora_raw_states_table [] = {
+static const state_table_t sm_lora_raw_states_table [] = {
     [__sm_state_id(lora_raw, idle)] = {
-        .name = "idle",
+        .name = __sm_name("idle"),
         .trans_table = sm_lora_raw_idle_trans_table,
         .trans_table_size = sm_lora_raw_idle_trans_table_size,
+        #ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+        .trans_hits = sm_lora_raw_idle_trans_hits,
+        #endif
         .default_action = __sm_action_fun(lora_raw, idle_default),
         .enter = __sm_action_fun(lora_raw, idle_enter),
     },
     [__sm_state_id(lora_raw, tx)] = {
-        .name = "tx",
+        .name = __sm_name("tx"),
         .trans_table = sm_lora_raw_tx_trans_table,
         .trans_table_size = sm_lora_raw_tx_trans_table_size,
+        #ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+        .trans_hits = sm_lora_raw_tx_trans_hits,
+        #endif
         .default_action = __sm_action_fun(lora_raw, tx_default),
         .enter = __sm_action_fun(lora_raw, tx_enter),
     },
     [__sm_state_id(lora_raw, rx)] = {
-        .name = "rx",
+        .name = __sm_name("rx"),
         .trans_table = sm_lora_raw_rx_trans_table,
         .trans_table_size = sm_lora_raw_rx_trans_table_size,
+        #ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+        .trans_hits = sm_lora_raw_rx_trans_hits,
+        #endif
         .default_action = __sm_action_fun(lora_raw, rx_default),
         .enter = __sm_action_fun(lora_raw, rx_enter),
     },
     [__sm_state_id(lora_raw, rx_cont)] = {
-        .name = "rx_cont",
+        .name = __sm_name("rx_cont"),
         .trans_table = sm_lora_raw_rx_cont_trans_table,
         .trans_table_size = sm_lora_raw_rx_cont_trans_table_size,
+        #ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+        .trans_hits = sm_lora_raw_rx_cont_trans_hits,
+        #endif
         .default_action = __sm_action_fun(lora_raw, rx_cont_default),
         .enter = __sm_action_fun(lora_raw, rx_cont_enter),
     },
     [__sm_state_id(lora_raw, toa)] = {
-        .name = "toa",
+        .name = __sm_name("toa"),
         .trans_table = sm_lora_raw_toa_trans_table,
         .trans_table_size = sm_lora_raw_toa_trans_table_size,
+        #ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+        .trans_hits = sm_lora_raw_toa_trans_hits,
+        #endif
         .default_action = __sm_action_fun(lora_raw, toa_default),
         .leave = __sm_action_fun(lora_raw, toa_leave),
     },
     [__sm_state_id(lora_raw, tx_temp)] = {
-        .name = "tx_temp",
+        .name = __sm_name("tx_temp"),
         .trans_table = sm_lora_raw_tx_temp_trans_table,
         .trans_table_size = sm_lora_raw_tx_temp_trans_table_size,
+        #ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+        .trans_hits = sm_lora_raw_tx_temp_trans_hits,
+        #endif
         .default_action = __sm_action_fun(lora_raw, tx_temp_default),
         .enter = __sm_action_fun(lora_raw, tx_temp_enter),
     },
     [__sm_state_id(lora_raw, toa_temp)] = {
-        .name = "toa_temp",
+        .name = __sm_name("toa_temp"),
         .trans_table = sm_lora_raw_toa_temp_trans_table,
         .trans_table_size = sm_lora_raw_toa_temp_trans_table_size,
+        #ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+        .trans_hits = sm_lora_raw_toa_temp_trans_hits,
+        #endif
         .default_action = __sm_action_fun(lora_raw, toa_temp_default),
         .leave = __sm_action_fun(lora_raw, toa_temp_leave),
     },
     [__sm_state_id(lora_raw, tx_cont)] = {
-        .name = "tx_cont",
+        .name = __sm_name("tx_cont"),
         .trans_table = sm_lora_raw_tx_cont_trans_table,
         .trans_table_size = sm_lora_raw_tx_cont_trans_table_size,
+        #ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+        .trans_hits = sm_lora_raw_tx_cont_trans_hits,
+        #endif
         .default_action = __sm_action_fun(lora_raw, tx_cont_default),
     },
+    [__sm_state_id(lora_raw, tx_burst)] = {
+        .name = __sm_name("tx_burst"),
+        .trans_table = sm_lora_raw_tx_burst_trans_table,
+        .trans_table_size = sm_lora_raw_tx_burst_trans_table_size,
+        #ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+        .trans_hits = sm_lora_raw_tx_burst_trans_hits,
+        #endif
+        .default_action = __sm_action_fun(lora_raw, tx_burst_default),
+    },
+    [__sm_state_id(lora_raw, lbt)] = {
+        .name = __sm_name("lbt"),
+        .trans_table = sm_lora_raw_lbt_trans_table,
+        .trans_table_size = sm_lora_raw_lbt_trans_table_size,
+        #ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+        .trans_hits = sm_lora_raw_lbt_trans_hits,
+        #endif
+        .default_action = __sm_action_fun(lora_raw, lbt_default),
+    },
+    [__sm_state_id(lora_raw, lbt_temp)] = {
+        .name = __sm_name("lbt_temp"),
+        .trans_table = sm_lora_raw_lbt_temp_trans_table,
+        .trans_table_size = sm_lora_raw_lbt_temp_trans_table_size,
+        #ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+        .trans_hits = sm_lora_raw_lbt_temp_trans_hits,
+        #endif
+        .default_action = __sm_action_fun(lora_raw, lbt_temp_default),
+    },
+    [__sm_state_id(lora_raw, cad_scan)] = {
+        .name = __sm_name("cad_scan"),
+        .trans_table = sm_lora_raw_cad_scan_trans_table,
+        .trans_table_size = sm_lora_raw_cad_scan_trans_table_size,
+        #ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+        .trans_hits = sm_lora_raw_cad_scan_trans_hits,
+        #endif
+        .default_action = __sm_action_fun(lora_raw, cad_scan_default),
+    },
 };
 #define sm_lora_raw_states_table_size \
     (sizeof(sm_lora_raw_states_table)/sizeof(state_table_t))
+#ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+static state_prof_t sm_lora_raw_states_prof [sm_lora_raw_states_table_size];
+#endif
 
 
 /* --- MACHINE -------------------------------------------------------------- */
 
-state_machine_t __sm_machine_id(lora_raw) = {
-    .name = "lora_raw",
+#define sm_lora_raw_ids_bits  8
+#if sm_lora_raw_ids_bits > __SM_TABLE_ID_BITS
+#error "state machine 'lora_raw' needs 8-bits ids, enable CONFIG_SDK_LIBS_STATE_MACHINE_16_BITS_IDS"
+#endif
+
+static const state_machine_desc_t sm_lora_raw_desc = {
+    .name = __sm_name("lora_raw"),
     .inputs_table = sm_lora_raw_inputs_table,
     .inputs_table_size = sm_lora_raw_inputs_table_size,
     .actions_table = sm_lora_raw_actions_table,
@@ -366,4 +642,13 @@ state_machine_t __sm_machine_id(lora_raw) = {
     .state_table_size = sm_lora_raw_states_table_size,
 };
 
+state_machine_t __sm_machine_id(lora_raw) = {
+    .desc = &sm_lora_raw_desc,
+    #ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+    .prof = {
+        .states = sm_lora_raw_states_prof,
+    },
+    #endif
+};
+
 /* --- end of file ---------------------------------------------------------- */
@@ -17,9 +17,20 @@ void __sm_action_fun(lora_raw, handle_tx_timeout)(void* data);
 void __sm_action_fun(lora_raw, handle_rx_done)(void* data);
 void __sm_action_fun(lora_raw, handle_rx_timeout)(void* data);
 void __sm_action_fun(lora_raw, handle_rx_fail)(void* data);
+void __sm_action_fun(lora_raw, hop_rx)(void* data);
 void __sm_action_fun(lora_raw, back_to_rx)(void* data);
+void __sm_action_fun(lora_raw, hop_defer)(void* data);
 void __sm_action_fun(lora_raw, stop_rx_cont)(void* data);
 void __sm_action_fun(lora_raw, radio_sleep)(void* data);
+void __sm_action_fun(lora_raw, start_burst)(void* data);
+void __sm_action_fun(lora_raw, burst_next)(void* data);
+void __sm_action_fun(lora_raw, burst_abort)(void* data);
+void __sm_action_fun(lora_raw, lbt_check)(void* data);
+void __sm_action_fun(lora_raw, lbt_retry)(void* data);
+void __sm_action_fun(lora_raw, lbt_abort)(void* data);
+void __sm_action_fun(lora_raw, start_cad_scan)(void* data);
+void __sm_action_fun(lora_raw, cad_scan_next)(void* data);
+void __sm_action_fun(lora_raw, cad_scan_abort)(void* data);
 
 void __sm_action_fun(lora_raw, idle_default)(void* data);
 void __sm_action_fun(lora_raw, tx_default)(void* data);
@@ -29,6 +40,10 @@ void __sm_action_fun(lora_raw, toa_default)(void* data);
 void __sm_action_fun(lora_raw, tx_temp_default)(void* data);
 void __sm_action_fun(lora_raw, toa_temp_default)(void* data);
 void __sm_action_fun(lora_raw, tx_cont_default)(void* data);
+void __sm_action_fun(lora_raw, tx_burst_default)(void* data);
+void __sm_action_fun(lora_raw, lbt_default)(void* data);
+void __sm_action_fun(lora_raw, lbt_temp_default)(void* data);
+void __sm_action_fun(lora_raw, cad_scan_default)(void* data);
 
 /* --- INPUTS --------------------------------------------------------------- */
 enum {
@@ -42,9 +57,14 @@ enum {
     __sm_input_id(lora_raw, rx_done),
     __sm_input_id(lora_raw, rx_timeout),
     __sm_input_id(lora_raw, rx_fail),
+    __sm_input_id(lora_raw, hop_expire),
     __sm_input_id(lora_raw, toa_expire),
     __sm_input_id(lora_raw, end_rx_cont),
     __sm_input_id(lora_raw, end_tx_cont),
+    __sm_input_id(lora_raw, req_tx_burst),
+    __sm_input_id(lora_raw, cad_done),
+    __sm_input_id(lora_raw, backoff_expire),
+    __sm_input_id(lora_raw, req_cad_scan),
 };
 
 /* --- ACTIONS -------------------------------------------------------------- */
@@ -57,11 +77,22 @@ enum {
     __sm_action_id(lora_raw, handle_rx_done),
     __sm_action_id(lora_raw, handle_rx_timeout),
     __sm_action_id(lora_raw, handle_rx_fail),
+    __sm_action_id(lora_raw, hop_rx),
     __sm_action_id(lora_raw, back_to_rx),
     __sm_action_id(lora_raw, postpone),
+    __sm_action_id(lora_raw, hop_defer),
     __sm_action_id(lora_raw, stop_rx_cont),
     __sm_action_id(lora_raw, do_nothing),
     __sm_action_id(lora_raw, radio_sleep),
+    __sm_action_id(lora_raw, start_burst),
+    __sm_action_id(lora_raw, burst_next),
+    __sm_action_id(lora_raw, burst_abort),
+    __sm_action_id(lora_raw, lbt_check),
+    __sm_action_id(lora_raw, lbt_retry),
+    __sm_action_id(lora_raw, lbt_abort),
+    __sm_action_id(lora_raw, start_cad_scan),
+    __sm_action_id(lora_raw, cad_scan_next),
+    __sm_action_id(lora_raw, cad_scan_abort),
 };
 
 /* --- STATES --------------------------------------------------------------- */
@@ -74,6 +105,10 @@ enum {
     __sm_state_id(lora_raw, tx_temp),
     __sm_state_id(lora_raw, toa_temp),
     __sm_state_id(lora_raw, tx_cont),
+    __sm_state_id(lora_raw, tx_burst),
+    __sm_state_id(lora_raw, lbt),
+    __sm_state_id(lora_raw, lbt_temp),
+    __sm_state_id(lora_raw, cad_scan),
 };
 
 /* --- MACHINE -------------------------------------------------------------- */
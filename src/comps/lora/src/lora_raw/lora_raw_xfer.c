@@ -0,0 +1,819 @@
+/** -------------------------------------------------------------------------- *
+ * Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @author  Ahmed Sabry (SG Wireless)
+ *
+ * @brief   lora-raw mode reliable transfer (xfer) sub-component.
+ *
+ *          The object is cut into chunks of a segment, every chunk is carried
+ *          by one data frame indexed by its sequence number in the segment.
+ *          The sender transmits a window of data frames back-to-back in the
+ *          tx burst mode, the last frame of the window requests an ack. The
+ *          receiver answers by its first missing sequence number (the base)
+ *          and a bitmap of the frames received after it, and the sender
+ *          repeats only the missing ones in the next window.
+ *
+ *          Optionally, every group of `fec` data frames is followed by an xor
+ *          parity frame, so the receiver rebuilds a single lost frame of the
+ *          group without a retransmission.
+ *
+ *          The chunk size starts at the maximum allowed by the radio payload
+ *          parameter, it is reduced on lossy windows and grown back on clean
+ *          ones. A new chunk size starts a new segment at the first byte not
+ *          yet acknowledged, so the sequence numbers and the bitmaps are
+ *          always in units of one chunk size.
+ *
+ *          frames layout (multi-bytes fields are little endian):
+ *            common  : [0] type, [1] session id, [2] segment
+ *            segment : [3..6] object size, [7..10] segment offset,
+ *                      [11] chunk size, [12] fec group size
+ *            data    : [3..4] seq, [5] flags, [6..] chunk
+ *            parity  : [3..4] group, [5] flags, [6..] xor of the group
+ *            ack     : [3..4] base, [5] flags, [6..13] bitmap
+ *            poll    : common header only
+ * --------------------------------------------------------------------------- *
+ */
+
+/** -------------------------------------------------------------------------- *
+ * includes
+ * --------------------------------------------------------------------------- *
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#define __log_subsystem  lora
+#define __log_component  raw_xfer
+#include "log_lib.h"
+
+#include "lora.h"
+#include "stub_system.h"
+#include "utilities.h"
+#include "lora_raw_process.h"
+#include "lora_raw_radio_if.h"
+#include "lora_raw_xfer.h"
+#include "lora_raw_airtime.h"
+
+/** -------------------------------------------------------------------------- *
+ * frames definitions
+ * --------------------------------------------------------------------------- *
+ */
+enum {
+    __XFER_FRAME_SEGMENT = 0xA1,
+    __XFER_FRAME_DATA,
+    __XFER_FRAME_PARITY,
+    __XFER_FRAME_ACK,
+    __XFER_FRAME_POLL,
+};
+
+#define __xfer_flag_ack_req     (1 << 0)    /* data/parity: answer by an ack */
+#define __xfer_flag_complete    (1 << 0)    /* ack: the object is received */
+
+#define __xfer_hdr_size         (3)
+#define __xfer_data_hdr_size    (6)
+#define __xfer_segment_size     (13)
+#define __xfer_ack_size         (14)
+
+#define __xfer_min_chunk        (16)
+#define __xfer_fec_groups       (8)     /* receiver parity groups in flight */
+#define __xfer_rx_linger        (1500)  /* msec, answering the late polls */
+
+static void put_le16(uint8_t* p, uint16_t v)
+{
+    p[0] = v; p[1] = v >> 8;
+}
+static void put_le32(uint8_t* p, uint32_t v)
+{
+    put_le16(p, v); put_le16(p + 2, v >> 16);
+}
+static void put_le64(uint8_t* p, uint64_t v)
+{
+    put_le32(p, v); put_le32(p + 4, v >> 32);
+}
+static uint16_t get_le16(const uint8_t* p)
+{
+    return p[0] | (p[1] << 8);
+}
+static uint32_t get_le32(const uint8_t* p)
+{
+    return get_le16(p) | ((uint32_t)get_le16(p + 2) << 16);
+}
+static uint64_t get_le64(const uint8_t* p)
+{
+    return get_le32(p) | ((uint64_t)get_le32(p + 4) << 32);
+}
+
+static void xor_into(uint8_t* dst, const uint8_t* src, uint8_t len)
+{
+    while( len -- )
+        *dst++ ^= *src++;
+}
+
+/** -------------------------------------------------------------------------- *
+ * radio access through the raw process
+ * --------------------------------------------------------------------------- *
+ */
+static void xfer_send_frame(uint8_t* buf, uint8_t len)
+{
+    /* a frame rejected by the duty-cycle budget is recovered as a lost one */
+    if( ! lora_raw_airtime_admit(len) )
+        return;
+
+    if( lora_raw_process_burst_is_active() )
+    {
+        lora_raw_process_burst_send(buf, len);
+        return;
+    }
+
+    lora_raw_process_event_payload_t tx_msg = {
+        .type = __PROCESS_MSG_PAYLOAD_TX_REQ,
+        .tx_payload = { .buf = buf, .len = len, .timeout = 0 }
+    };
+    lora_raw_process_event(__LORA_RAW_PROCESS_TX_REQUEST, &tx_msg, true);
+}
+
+static uint8_t xfer_recv_frame(uint8_t* buf, uint32_t timeout)
+{
+    uint8_t len = 0;
+    lora_raw_process_event_payload_t rx_msg = {
+        .type = __PROCESS_MSG_PAYLOAD_RX_REQ,
+        .rx_payload = {
+            .buf = buf,
+            .buf_len = 255,
+            .p_len = &len,
+            .timeout = timeout
+        }
+    };
+    lora_raw_process_event(__LORA_RAW_PROCESS_RX_REQUEST, &rx_msg, true);
+    return len;
+}
+
+static uint8_t xfer_max_chunk(void)
+{
+    lora_raw_param_t param = {.type = __LORA_RAW_PARAM_PAYLOAD};
+    lora_raw_radio_get_param( & param );
+    if( param.param.payload <= __xfer_data_hdr_size )
+        return 0;
+    return param.param.payload - __xfer_data_hdr_size;
+}
+
+static void xfer_stats_end(lora_raw_xfer_t* p_xfer, uint32_t start_ts,
+    uint32_t end_ts)
+{
+    p_xfer->stats.duration = end_ts - start_ts;
+    p_xfer->stats.goodput = p_xfer->stats.duration ?
+        (uint64_t)p_xfer->size * 1000 / p_xfer->stats.duration : 0;
+}
+
+/** -------------------------------------------------------------------------- *
+ * sender side
+ * --------------------------------------------------------------------------- *
+ */
+static struct {
+    lora_raw_xfer_t*    p_xfer;
+    uint8_t     sid;
+    uint8_t     seg;
+    uint32_t    seg_offset;
+    uint16_t    seg_chunks;
+    uint8_t     chunk;
+    uint8_t     max_chunk;
+    uint8_t     next_chunk;     /* chunk size of the next segment */
+    uint8_t     clean_rounds;
+
+    uint16_t    base;           /* first sequence not acknowledged */
+    uint64_t    acked;          /* acknowledged sequences after the base */
+    uint16_t    next;           /* first sequence never sent */
+    bool        complete;
+
+    uint64_t    round_sent;     /* sequences sent in the round (from base) */
+    uint16_t    round_base;
+
+    uint8_t     parity[255];    /* xor of the present group chunks */
+
+    /* the frames are sent one step late, so that the last frame of the round
+     * is flagged with the ack request before it is sent */
+    uint8_t     pending[255];
+    uint8_t     pending_len;
+    uint8_t     frame[255];
+} s_tx;
+
+static uint8_t tx_chunk_len(uint16_t seq)
+{
+    uint32_t offset = s_tx.seg_offset + (uint32_t)seq * s_tx.chunk;
+    uint32_t left = s_tx.p_xfer->size - offset;
+    return left < s_tx.chunk ? left : s_tx.chunk;
+}
+
+static void tx_header(uint8_t* buf, uint8_t type)
+{
+    buf[0] = type;
+    buf[1] = s_tx.sid;
+    buf[2] = s_tx.seg;
+}
+
+static void tx_queue(uint8_t* buf, uint8_t len)
+{
+    if( s_tx.pending_len )
+        xfer_send_frame(s_tx.pending, s_tx.pending_len);
+    memcpy(s_tx.pending, buf, len);
+    s_tx.pending_len = len;
+}
+
+static void tx_flush(void)
+{
+    if( s_tx.pending_len )
+    {
+        s_tx.pending[5] |= __xfer_flag_ack_req;
+        xfer_send_frame(s_tx.pending, s_tx.pending_len);
+        s_tx.pending_len = 0;
+    }
+}
+
+static void tx_ack_apply(const uint8_t* buf)
+{
+    uint16_t base = get_le16(&buf[3]);
+
+    ++ s_tx.p_xfer->stats.acks;
+
+    /* a late ack of an older round never moves the window backward */
+    if( base < s_tx.base || base > s_tx.seg_chunks )
+        return;
+
+    s_tx.base = base;
+    s_tx.acked = get_le64(&buf[6]);
+    s_tx.complete = (buf[5] & __xfer_flag_complete) != 0;
+}
+
+/**
+ * waits for an ack of the present segment, the ack request is repeated by
+ * poll frames, or by the given segment frame, if it is not answered within
+ * the timeout
+ */
+static bool tx_wait_ack(uint8_t* p_segment)
+{
+    lora_raw_xfer_t* p_xfer = s_tx.p_xfer;
+    uint8_t attempt;
+
+    for( attempt = 0; attempt <= p_xfer->retries; ++ attempt )
+    {
+        if( attempt )
+        {
+            ++ p_xfer->stats.polls;
+            if( p_segment )
+            {
+                xfer_send_frame(p_segment, __xfer_segment_size);
+            }
+            else
+            {
+                tx_header(s_tx.frame, __XFER_FRAME_POLL);
+                xfer_send_frame(s_tx.frame, __xfer_hdr_size);
+            }
+        }
+
+        uint32_t start_ts = lora_stub_get_timestamp_ms();
+        uint32_t elapsed;
+        while( ( elapsed = lora_stub_get_timestamp_ms() - start_ts )
+                < p_xfer->timeout )
+        {
+            uint8_t len = xfer_recv_frame(s_tx.frame,
+                p_xfer->timeout - elapsed);
+            if( len == 0 )
+                break;
+            if( len == __xfer_ack_size &&
+                s_tx.frame[0] == __XFER_FRAME_ACK &&
+                s_tx.frame[1] == s_tx.sid &&
+                s_tx.frame[2] == s_tx.seg )
+            {
+                tx_ack_apply(s_tx.frame);
+                return true;
+            }
+        }
+        __log_info("ack wait -> timeout (attempt %d)", attempt + 1);
+    }
+    return false;
+}
+
+static bool tx_segment_start(void)
+{
+    lora_raw_xfer_t* p_xfer = s_tx.p_xfer;
+    uint32_t left = p_xfer->size - s_tx.seg_offset;
+    uint8_t frame[__xfer_segment_size];
+
+    s_tx.chunk = s_tx.next_chunk;
+    s_tx.seg_chunks = (left + s_tx.chunk - 1) / s_tx.chunk;
+    s_tx.base = s_tx.next = 0;
+    s_tx.acked = 0;
+    s_tx.complete = false;
+    p_xfer->stats.chunk = s_tx.chunk;
+
+    __log_info("segment %d -> offset: %d, chunk: %d, chunks: %d",
+        s_tx.seg, s_tx.seg_offset, s_tx.chunk, s_tx.seg_chunks);
+
+    tx_header(frame, __XFER_FRAME_SEGMENT);
+    put_le32(&frame[3], p_xfer->size);
+    put_le32(&frame[7], s_tx.seg_offset);
+    frame[11] = s_tx.chunk;
+    frame[12] = p_xfer->fec;
+    xfer_send_frame(frame, __xfer_segment_size);
+
+    return tx_wait_ack(frame);
+}
+
+static bool tx_send_data(uint16_t seq)
+{
+    lora_raw_xfer_t* p_xfer = s_tx.p_xfer;
+    uint8_t len = tx_chunk_len(seq);
+    uint8_t* chunk = &s_tx.frame[__xfer_data_hdr_size];
+
+    if( ! p_xfer->io(p_xfer->ctx,
+            s_tx.seg_offset + (uint32_t)seq * s_tx.chunk, chunk, len) )
+        return false;
+
+    tx_header(s_tx.frame, __XFER_FRAME_DATA);
+    put_le16(&s_tx.frame[3], seq);
+    s_tx.frame[5] = 0;
+    tx_queue(s_tx.frame, __xfer_data_hdr_size + len);
+
+    s_tx.round_sent |= 1ULL << (seq - s_tx.round_base);
+
+    if( seq < s_tx.next )
+    {
+        ++ p_xfer->stats.retransmissions;
+        return true;
+    }
+
+    ++ p_xfer->stats.data_frames;
+
+    /* the parity goes out only with the first transmission of a group */
+    if( p_xfer->fec )
+    {
+        uint16_t group = seq / p_xfer->fec;
+
+        if( seq % p_xfer->fec == 0 )
+            memset(s_tx.parity, 0, s_tx.chunk);
+        xor_into(s_tx.parity, chunk, len);
+
+        if( seq % p_xfer->fec == p_xfer->fec - 1 ||
+            seq == s_tx.seg_chunks - 1 )
+        {
+            tx_header(s_tx.frame, __XFER_FRAME_PARITY);
+            put_le16(&s_tx.frame[3], group);
+            s_tx.frame[5] = 0;
+            memcpy(&s_tx.frame[__xfer_data_hdr_size], s_tx.parity,
+                s_tx.chunk);
+            tx_queue(s_tx.frame, __xfer_data_hdr_size + s_tx.chunk);
+            ++ p_xfer->stats.parity_frames;
+        }
+    }
+    return true;
+}
+
+/**
+ * sends the missing data frames of the window back-to-back
+ * @return the number of the sent data frames, or -1 on i/o error
+ */
+static int tx_round(void)
+{
+    lora_raw_xfer_t* p_xfer = s_tx.p_xfer;
+    uint16_t end = s_tx.base + p_xfer->window;
+    uint16_t seq;
+    int sent = 0;
+
+    if( end > s_tx.seg_chunks )
+        end = s_tx.seg_chunks;
+
+    s_tx.round_sent = 0;
+    s_tx.round_base = s_tx.base;
+
+    lora_raw_process_burst_start();
+    for( seq = s_tx.base; seq < end; ++ seq )
+    {
+        if( s_tx.acked & ( 1ULL << (seq - s_tx.base) ) )
+            continue;
+        if( ! tx_send_data(seq) )
+        {
+            s_tx.pending_len = 0;
+            lora_raw_process_burst_stop();
+            return -1;
+        }
+        ++ sent;
+    }
+    tx_flush();
+    lora_raw_process_burst_stop();
+
+    if( end > s_tx.next )
+        s_tx.next = end;
+    return sent;
+}
+
+/**
+ * the chunk size follows the link quality, long frames are more exposed to
+ * interference and bit errors on a lossy link
+ */
+static void tx_adapt(int sent)
+{
+    uint8_t min_chunk = s_tx.max_chunk / 4 < __xfer_min_chunk ?
+        __xfer_min_chunk : s_tx.max_chunk / 4;
+    uint16_t i;
+    int lost = 0;
+
+    for( i = 0; i < 64; ++ i )
+    {
+        uint16_t seq = s_tx.round_base + i;
+        if( ! ( s_tx.round_sent & (1ULL << i) ) || seq < s_tx.base )
+            continue;
+        if( seq - s_tx.base >= 64 ||
+            ! ( s_tx.acked & ( 1ULL << (seq - s_tx.base) ) ) )
+            ++ lost;
+    }
+
+    if( lost * 4 > sent )
+    {
+        s_tx.clean_rounds = 0;
+        s_tx.next_chunk = s_tx.chunk / 2 < min_chunk ?
+            min_chunk : s_tx.chunk / 2;
+    }
+    else if( lost * 8 <= sent && ++ s_tx.clean_rounds >= 2 )
+    {
+        uint16_t chunk = s_tx.chunk + s_tx.chunk / 2;
+        s_tx.clean_rounds = 0;
+        s_tx.next_chunk = chunk > s_tx.max_chunk ? s_tx.max_chunk : chunk;
+    }
+}
+
+bool lora_raw_xfer_send(lora_raw_xfer_t* p_xfer)
+{
+    uint32_t start_ts = lora_stub_get_timestamp_ms();
+    bool ret = false;
+
+    if( p_xfer->io == NULL || p_xfer->size == 0 ||
+        p_xfer->window == 0 ||
+        p_xfer->window > __LORA_RAW_XFER_MAX_WINDOW ||
+        p_xfer->fec > p_xfer->window || p_xfer->timeout == 0 )
+        return false;
+
+    memset(&p_xfer->stats, 0, sizeof(p_xfer->stats));
+    memset(&s_tx, 0, sizeof(s_tx));
+    s_tx.p_xfer = p_xfer;
+    s_tx.sid = randr(1, 0xFF);
+    s_tx.max_chunk = s_tx.next_chunk = xfer_max_chunk();
+
+    if( s_tx.max_chunk < __xfer_min_chunk )
+        return false;
+
+    __log_info("xfer send -> size: %d, window: %d, fec: %d",
+        p_xfer->size, p_xfer->window, p_xfer->fec);
+
+    if( ! tx_segment_start() )
+        goto end;
+
+    while( ! s_tx.complete )
+    {
+        int sent = tx_round();
+        if( sent < 0 || ! tx_wait_ack(NULL) )
+            goto end;
+        if( s_tx.complete )
+            break;
+
+        tx_adapt(sent);
+
+        /* a new chunk size is applied only when the whole segment sent so
+         * far is acknowledged */
+        if( s_tx.next_chunk != s_tx.chunk && s_tx.base == s_tx.next )
+        {
+            s_tx.seg_offset += (uint32_t)s_tx.base * s_tx.chunk;
+            ++ s_tx.seg;
+            if( ! tx_segment_start() )
+                goto end;
+        }
+    }
+    ret = true;
+
+end:
+    xfer_stats_end(p_xfer, start_ts, lora_stub_get_timestamp_ms());
+    __log_info("xfer send -> %s, %d msec", ret ? "done" : "failed",
+        p_xfer->stats.duration);
+    return ret;
+}
+
+/** -------------------------------------------------------------------------- *
+ * receiver side
+ * --------------------------------------------------------------------------- *
+ */
+typedef struct {
+    bool        valid;
+    bool        parity;
+    uint16_t    group;
+    uint8_t     count;      /* received data chunks */
+    uint8_t     buf[255];   /* xor of the received chunks and parity */
+} xfer_rx_group_t;
+
+static struct {
+    lora_raw_xfer_t*    p_xfer;
+    bool        active;
+    bool        complete;
+    bool        io_error;
+    uint8_t     sid;
+    uint8_t     seg;
+    uint32_t    seg_offset;
+    uint16_t    seg_chunks;
+    uint8_t     chunk;
+    uint8_t     fec;
+
+    uint16_t    base;           /* first missing sequence */
+    uint64_t    received;       /* received sequences after the base */
+
+    xfer_rx_group_t groups[__xfer_fec_groups];
+    uint32_t    start_ts;
+    uint32_t    end_ts;
+
+    uint8_t     frame[__xfer_ack_size];
+} s_rx;
+
+static uint8_t rx_chunk_len(uint16_t seq)
+{
+    uint32_t offset = s_rx.seg_offset + (uint32_t)seq * s_rx.chunk;
+    uint32_t left = s_rx.p_xfer->size - offset;
+    return left < s_rx.chunk ? left : s_rx.chunk;
+}
+
+static bool rx_is_received(uint16_t seq)
+{
+    return seq < s_rx.base ||
+        ( seq - s_rx.base < 64 && (s_rx.received >> (seq - s_rx.base)) & 1 );
+}
+
+static void rx_send_ack(void)
+{
+    s_rx.frame[0] = __XFER_FRAME_ACK;
+    s_rx.frame[1] = s_rx.sid;
+    s_rx.frame[2] = s_rx.seg;
+    put_le16(&s_rx.frame[3], s_rx.base);
+    s_rx.frame[5] = s_rx.complete ? __xfer_flag_complete : 0;
+    put_le64(&s_rx.frame[6], s_rx.received);
+
+    ++ s_rx.p_xfer->stats.acks;
+    xfer_send_frame(s_rx.frame, __xfer_ack_size);
+}
+
+static void rx_segment_start(const uint8_t* buf)
+{
+    s_rx.seg = buf[2];
+    s_rx.seg_offset = get_le32(&buf[7]);
+    s_rx.chunk = buf[11];
+    s_rx.fec = buf[12];
+    s_rx.seg_chunks =
+        (s_rx.p_xfer->size - s_rx.seg_offset + s_rx.chunk - 1) / s_rx.chunk;
+    s_rx.base = 0;
+    s_rx.received = 0;
+    memset(s_rx.groups, 0, sizeof(s_rx.groups));
+    s_rx.p_xfer->stats.chunk = s_rx.chunk;
+
+    __log_info("segment %d -> offset: %d, chunk: %d, chunks: %d",
+        s_rx.seg, s_rx.seg_offset, s_rx.chunk, s_rx.seg_chunks);
+}
+
+static void rx_handle_segment(const uint8_t* buf, uint8_t len)
+{
+    if( len != __xfer_segment_size || buf[11] == 0 )
+        return;
+
+    if( ! s_rx.active || ( buf[1] != s_rx.sid && s_rx.complete ) )
+    {
+        /* a new session starts only by its first segment */
+        if( buf[2] != 0 || get_le32(&buf[7]) != 0 )
+            return;
+        s_rx.active = true;
+        s_rx.complete = false;
+        s_rx.sid = buf[1];
+        s_rx.start_ts = lora_stub_get_timestamp_ms();
+        s_rx.p_xfer->size = get_le32(&buf[3]);
+        memset(&s_rx.p_xfer->stats, 0, sizeof(s_rx.p_xfer->stats));
+        __log_info("xfer recv -> new session, size: %d",
+            s_rx.p_xfer->size);
+        rx_segment_start(buf);
+    }
+    else if( buf[1] != s_rx.sid )
+    {
+        return;
+    }
+    else if( buf[2] == (uint8_t)(s_rx.seg + 1) &&
+        get_le32(&buf[7]) == s_rx.seg_offset +
+            (uint32_t)s_rx.base * s_rx.chunk )
+    {
+        rx_segment_start(buf);
+    }
+
+    /* a repeated segment frame is answered again, its ack was lost */
+    rx_send_ack();
+}
+
+static void rx_store(uint16_t seq, const uint8_t* chunk, uint8_t len)
+{
+    lora_raw_xfer_t* p_xfer = s_rx.p_xfer;
+
+    if( ! p_xfer->io(p_xfer->ctx,
+            s_rx.seg_offset + (uint32_t)seq * s_rx.chunk, (uint8_t*)chunk,
+            len) )
+    {
+        s_rx.io_error = true;
+        return;
+    }
+
+    s_rx.received |= 1ULL << (seq - s_rx.base);
+    while( s_rx.received & 1 )
+    {
+        s_rx.received >>= 1;
+        ++ s_rx.base;
+    }
+
+    if( s_rx.base == s_rx.seg_chunks )
+    {
+        __log_info("xfer recv -> complete");
+        s_rx.complete = true;
+        s_rx.end_ts = lora_stub_get_timestamp_ms();
+        rx_send_ack();
+    }
+}
+
+/**
+ * accumulates a chunk or a parity into its group, and rebuilds the missing
+ * chunk once the parity and all the other chunks of the group are there
+ */
+static void rx_fec_update(uint16_t group, const uint8_t* buf, uint8_t len,
+    bool parity)
+{
+    xfer_rx_group_t* p_group = &s_rx.groups[group % __xfer_fec_groups];
+    uint16_t first = group * s_rx.fec;
+    uint16_t count = s_rx.seg_chunks - first < s_rx.fec ?
+        s_rx.seg_chunks - first : s_rx.fec;
+    uint16_t seq;
+
+    if( ! p_group->valid || p_group->group < group )
+    {
+        memset(p_group, 0, sizeof(*p_group));
+        p_group->valid = true;
+        p_group->group = group;
+    }
+    else if( p_group->group != group )
+    {
+        return;
+    }
+
+    xor_into(p_group->buf, buf, len);
+    if( parity )
+        p_group->parity = true;
+    else
+        ++ p_group->count;
+
+    if( ! p_group->parity || p_group->count + 1 != count )
+        return;
+
+    for( seq = first; seq < first + count; ++ seq )
+    {
+        if( ! rx_is_received(seq) )
+        {
+            __log_info("fec -> seq %d rebuilt", seq);
+            ++ s_rx.p_xfer->stats.recovered;
+            ++ p_group->count;
+            rx_store(seq, p_group->buf, rx_chunk_len(seq));
+            break;
+        }
+    }
+}
+
+static void rx_handle_data(const uint8_t* buf, uint8_t len)
+{
+    uint16_t seq = get_le16(&buf[3]);
+    const uint8_t* chunk = &buf[__xfer_data_hdr_size];
+    uint8_t chunk_len = len - __xfer_data_hdr_size;
+
+    if( buf[2] != s_rx.seg || s_rx.complete )
+        goto ack;
+
+    if( buf[0] == __XFER_FRAME_PARITY )
+    {
+        ++ s_rx.p_xfer->stats.parity_frames;
+        if( s_rx.fec && chunk_len == s_rx.chunk &&
+            seq * s_rx.fec < s_rx.seg_chunks )
+            rx_fec_update(seq, chunk, chunk_len, true);
+        goto ack;
+    }
+
+    if( seq >= s_rx.seg_chunks || rx_is_received(seq) ||
+        seq - s_rx.base >= 64 || chunk_len != rx_chunk_len(seq) )
+        goto ack;
+
+    ++ s_rx.p_xfer->stats.data_frames;
+    rx_store(seq, chunk, chunk_len);
+    if( s_rx.fec && ! s_rx.io_error )
+        rx_fec_update(seq / s_rx.fec, chunk, chunk_len, false);
+
+ack:
+    if( buf[5] & __xfer_flag_ack_req )
+        rx_send_ack();
+}
+
+static bool rx_handle_frame(const uint8_t* buf, uint8_t len)
+{
+    if( len < __xfer_hdr_size )
+        return false;
+
+    if( buf[0] == __XFER_FRAME_SEGMENT )
+    {
+        rx_handle_segment(buf, len);
+        return s_rx.active && buf[1] == s_rx.sid;
+    }
+
+    if( ! s_rx.active || buf[1] != s_rx.sid )
+        return false;
+
+    switch( buf[0] )
+    {
+    case __XFER_FRAME_DATA:
+    case __XFER_FRAME_PARITY:
+        if( len > __xfer_data_hdr_size )
+            rx_handle_data(buf, len);
+        return true;
+    case __XFER_FRAME_POLL:
+        ++ s_rx.p_xfer->stats.polls;
+        rx_send_ack();
+        return true;
+    }
+    return false;
+}
+
+bool lora_raw_xfer_recv(lora_raw_xfer_t* p_xfer)
+{
+    static lora_raw_rx_ring_frame_t frame;
+    lora_raw_rx_ring_status_t ring_status;
+    lora_raw_rx_ring_cfg_t ring_cfg = { .enable = true, .batch = 0 };
+    uint32_t last_ts;
+    uint32_t idle;
+    uint32_t limit;
+
+    if( p_xfer->io == NULL || p_xfer->timeout == 0 )
+        return false;
+
+    memset(&s_rx, 0, sizeof(s_rx));
+    memset(&p_xfer->stats, 0, sizeof(p_xfer->stats));
+    s_rx.p_xfer = p_xfer;
+    p_xfer->size = 0;
+
+    __log_info("xfer recv -> waiting");
+
+    /* the frames are collected by the rx ring, so no frame is missed while
+     * an ack is being built and sent */
+    lora_raw_process_rx_ring_status(&ring_status);
+    lora_raw_process_rx_ring_set(&ring_cfg);
+    lora_raw_process_event(__LORA_RAW_PROCESS_RX_CONT_START, NULL, false);
+
+    last_ts = lora_stub_get_timestamp_ms();
+    while( ! s_rx.io_error )
+    {
+        /* after the completion, the receiver stays for the polls of a
+         * sender that missed the last ack */
+        limit = p_xfer->timeout;
+        if( s_rx.complete && limit > __xfer_rx_linger )
+            limit = __xfer_rx_linger;
+
+        idle = lora_stub_get_timestamp_ms() - last_ts;
+        if( idle >= limit )
+            break;
+        if( ! lora_raw_process_rx_ring_wait(&frame, limit - idle) )
+            continue;
+
+        if( rx_handle_frame(frame.buf, frame.len) )
+            last_ts = lora_stub_get_timestamp_ms();
+    }
+
+    lora_raw_process_event(__LORA_RAW_PROCESS_RX_CONT_STOP, NULL, true);
+    ring_cfg.enable = ring_status.enabled;
+    ring_cfg.batch = ring_status.batch;
+    lora_raw_process_rx_ring_set(&ring_cfg);
+
+    if( s_rx.complete )
+        xfer_stats_end(p_xfer, s_rx.start_ts, s_rx.end_ts);
+    __log_info("xfer recv -> %s", s_rx.complete ? "done" : "failed");
+    return s_rx.complete && ! s_rx.io_error;
+}
+
+/* --- end of file ---------------------------------------------------------- */
@@ -0,0 +1,68 @@
+/** -------------------------------------------------------------------------- *
+ * Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @author  Ahmed Sabry (SG Wireless)
+ *
+ * @brief   lora-raw mode reliable transfer (xfer) sub-component interface.
+ *          It sends an object over a raw link in windows of back-to-back
+ *          data frames acknowledged by bitmaps (selective repeat ARQ).
+ * --------------------------------------------------------------------------- *
+ */
+#ifndef __LORA_RAW_XFER_H__
+#define __LORA_RAW_XFER_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** -------------------------------------------------------------------------- *
+ * includes
+ * --------------------------------------------------------------------------- *
+ */
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "lora.h"
+
+/** -------------------------------------------------------------------------- *
+ * APIs
+ * --------------------------------------------------------------------------- *
+ */
+
+/**
+ * @brief   sends the object described by \a p_xfer, the caller is blocked
+ *          until the whole object is acknowledged by the receiver
+ * @return  false on invalid parameters, i/o error or a lost receiver
+ */
+bool lora_raw_xfer_send(lora_raw_xfer_t* p_xfer);
+
+/**
+ * @brief   receives an object sent by lora_raw_xfer_send(), the caller is
+ *          blocked until the object is received
+ * @return  false on i/o error or if no frame arrives within the timeout
+ */
+bool lora_raw_xfer_recv(lora_raw_xfer_t* p_xfer);
+
+/* --- end of file ---------------------------------------------------------- */
+#ifdef __cplusplus
+}
+#endif
+#endif /* __LORA_RAW_XFER_H__ */
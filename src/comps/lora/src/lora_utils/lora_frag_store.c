@@ -0,0 +1,299 @@
+/** -------------------------------------------------------------------------- *
+ * Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @author  Ahmed Sabry (SG Wireless)
+ *
+ * @brief   flash store of the fragmented data block transport (FUOTA).
+ * --------------------------------------------------------------------------- *
+ */
+
+/** -------------------------------------------------------------------------- *
+ * include
+ * --------------------------------------------------------------------------- *
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define __log_subsystem lora
+#define __log_component util_frag_store
+#include "log_lib.h"
+
+#include "utils_bitarray.h"
+#include "stub_frag_store.h"
+#include "stub_system.h"
+#include "lora_frag_store.h"
+
+/** -------------------------------------------------------------------------- *
+ * store state
+ * --------------------------------------------------------------------------- *
+ */
+static struct {
+    bool        is_open;
+    uint32_t    size;           // -- the partition area size
+    uint32_t    sector_size;
+    bitarray_t  erased_sectors;
+    lora_frag_store_stats_t stats;
+} s_store;
+
+#define __chunk_size    ( 64 )
+
+/** -------------------------------------------------------------------------- *
+ * helpers
+ * --------------------------------------------------------------------------- *
+ */
+static bool store_open(void)
+{
+    uint32_t words;
+
+    memset(&s_store, 0, sizeof(s_store));
+
+    if( lora_stub_frag_store_open(&s_store.size, &s_store.sector_size) != 0 ||
+        s_store.size == 0 || s_store.sector_size == 0 )
+    {
+        __log_error("no fragments store partition");
+        return false;
+    }
+
+    words = __div_ceiling(__div_ceiling(s_store.size, s_store.sector_size),
+        32) + 1;
+    s_store.erased_sectors = calloc(words, sizeof(uint32_t));
+    if( s_store.erased_sectors == NULL ) {
+        __log_error("no memory for the sectors bitmap");
+        lora_stub_frag_store_close(false, 0);
+        return false;
+    }
+    s_store.erased_sectors[0] = words;
+    s_store.stats.ram_bytes = words * sizeof(uint32_t);
+    s_store.is_open = true;
+
+    __log_info("open store: %d bytes, sector %d bytes, ram %d bytes",
+        s_store.size, s_store.sector_size, s_store.stats.ram_bytes);
+    return true;
+}
+
+static bool is_erased_data(uint8_t* data, uint32_t size)
+{
+    while( size -- ) {
+        if( *data ++ != 0xFF )
+            return false;
+    }
+    return true;
+}
+
+static int flash_program(uint32_t addr, uint8_t* data, uint32_t size)
+{
+    if( lora_stub_frag_store_write(addr, data, size) != 0 )
+        return -1;
+    ++ s_store.stats.writes;
+    s_store.stats.bytes_written += size;
+    return 0;
+}
+
+static int sector_erase(uint32_t sector)
+{
+    if( lora_stub_frag_store_erase(sector * s_store.sector_size,
+            s_store.sector_size) != 0 )
+        return -1;
+    bitarray_write(s_store.erased_sectors, sector, true);
+    ++ s_store.stats.sector_erases;
+    return 0;
+}
+
+/* checks if the flash programming, which only clears bits, gives the data */
+static bool is_programmable(uint32_t addr, uint8_t* data, uint32_t size)
+{
+    uint8_t current[__chunk_size];
+    uint32_t len;
+    uint32_t i;
+
+    while( size ) {
+        len = size < sizeof(current) ? size : sizeof(current);
+        if( lora_stub_frag_store_read(addr, current, len) != 0 )
+            return false;
+        for( i = 0; i < len; ++i ) {
+            if( (current[i] & data[i]) != data[i] )
+                return false;
+        }
+        addr += len;
+        data += len;
+        size -= len;
+    }
+    return true;
+}
+
+/* the write is within one erased sector */
+static int sector_rewrite(uint32_t sector, uint32_t addr, uint8_t* data,
+    uint32_t size)
+{
+    uint32_t sector_addr = sector * s_store.sector_size;
+    uint8_t* sector_buf;
+    int ret = -1;
+
+    sector_buf = malloc(s_store.sector_size);
+    if( sector_buf == NULL ) {
+        __log_error("no memory for a sector rewrite");
+        return -1;
+    }
+
+    if( lora_stub_frag_store_read(sector_addr, sector_buf,
+            s_store.sector_size) == 0 &&
+        sector_erase(sector) == 0 )
+    {
+        memcpy(sector_buf + addr - sector_addr, data, size);
+        ret = flash_program(sector_addr, sector_buf, s_store.sector_size);
+    }
+    ++ s_store.stats.rewrites;
+
+    free(sector_buf);
+    return ret;
+}
+
+/** -------------------------------------------------------------------------- *
+ * APIs
+ * --------------------------------------------------------------------------- *
+ */
+int8_t lora_frag_store_write(uint32_t addr, uint8_t* data, uint32_t size)
+{
+    uint32_t sector;
+    uint32_t len;
+
+    if( addr == 0 && size == 1 && data[0] == 0xFF && s_store.is_open ) {
+        // -- a new block initialization by the decoder
+        __log_info("restart store");
+        bitarray_write_all(s_store.erased_sectors, false);
+    }
+
+    if( ! s_store.is_open && ! store_open() )
+        return -1;
+
+    if( addr + size > s_store.size ) {
+        __log_error("write at %d of %d bytes is out of the store", addr, size);
+        return -1;
+    }
+
+    // -- the write is split on the sectors
+    while( size )
+    {
+        sector = addr / s_store.sector_size;
+        len = s_store.sector_size - addr % s_store.sector_size;
+        len = len < size ? len : size;
+
+        if( ! bitarray_read(s_store.erased_sectors, sector) ) {
+            if( ! is_erased_data(data, len) &&
+                ( sector_erase(sector) != 0 ||
+                  flash_program(addr, data, len) != 0 ) )
+                return -1;
+        } else if( is_programmable(addr, data, len) ) {
+            if( flash_program(addr, data, len) != 0 )
+                return -1;
+        } else if( sector_rewrite(sector, addr, data, len) != 0 ) {
+            return -1;
+        }
+
+        addr += len;
+        data += len;
+        size -= len;
+    }
+    return 0;
+}
+
+int8_t lora_frag_store_read(uint32_t addr, uint8_t* data, uint32_t size)
+{
+    uint32_t sector;
+    uint32_t len;
+
+    if( ! s_store.is_open && ! store_open() )
+        return -1;
+
+    if( addr + size > s_store.size )
+        return -1;
+
+    while( size )
+    {
+        sector = addr / s_store.sector_size;
+        len = s_store.sector_size - addr % s_store.sector_size;
+        len = len < size ? len : size;
+
+        if( ! bitarray_read(s_store.erased_sectors, sector) ) {
+            memset(data, 0xFF, len);
+        } else if( lora_stub_frag_store_read(addr, data, len) != 0 ) {
+            return -1;
+        }
+
+        addr += len;
+        data += len;
+        size -= len;
+    }
+    return 0;
+}
+
+bool lora_frag_store_close(bool is_complete, uint32_t size)
+{
+    uint8_t chunk[__chunk_size];
+    uint32_t crc = 0;
+    uint32_t offset;
+    uint32_t len;
+    bool is_accepted;
+
+    if( ! s_store.is_open )
+        return false;
+
+    if( is_complete && size > s_store.size ) {
+        __log_error("data block of %d bytes is out of the store", size);
+        is_complete = false;
+    }
+
+    if( is_complete ) {
+        for( offset = 0; offset < size; offset += len ) {
+            len = size - offset < sizeof(chunk) ?
+                size - offset : sizeof(chunk);
+            if( lora_frag_store_read(offset, chunk, len) != 0 ) {
+                is_complete = false;
+                break;
+            }
+            crc = lora_stub_crc32(crc, chunk, len);
+        }
+        s_store.stats.image_crc = crc;
+        __log_info("data block of %d bytes, crc32 %08x", size, crc);
+    }
+
+    is_accepted = lora_stub_frag_store_close(is_complete, size) == 0 &&
+        is_complete;
+
+    __log_info("close store: %s, writes %d, rewrites %d, erases %d",
+        is_accepted ? __green__"accepted"__default__ : __red__"dropped",
+        s_store.stats.writes, s_store.stats.rewrites,
+        s_store.stats.sector_erases);
+
+    free(s_store.erased_sectors);
+    s_store.erased_sectors = NULL;
+    s_store.is_open = false;
+    return is_accepted;
+}
+
+void lora_frag_store_get_stats(lora_frag_store_stats_t* p_stats)
+{
+    *p_stats = s_store.stats;
+}
+
+/* --- end of file ---------------------------------------------------------- */
@@ -0,0 +1,95 @@
+/** -------------------------------------------------------------------------- *
+ * Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @author  Ahmed Sabry (SG Wireless)
+ *
+ * @brief   flash store of the fragmented data block transport (FUOTA).
+ *
+ *          The fragments decoder writes and reads its data block rows
+ *          directly at their offset in a flash partition area given by the
+ *          frag_store ports. The ram holds only one bit per flash sector
+ *          telling if the sector is erased for the current block, so a
+ *          multi-hundred KB block costs a few tens of bytes of ram:
+ *          - a sector is erased lazily before its first write, the reads of
+ *            a sector not erased yet return 0xFF as an erased flash, so the
+ *            0xFF writes into such a sector are dropped.
+ *          - a row rewritten by the FEC recovery is programmed in place when
+ *            it only clears bits, otherwise its sector is read, erased and
+ *            written back through a transient sector buffer.
+ *          - the decoder initializes a new block with 0xFF single bytes
+ *            writes from address 0, the first of them restarts the store.
+ * --------------------------------------------------------------------------- *
+ */
+#ifndef __LORA_FRAG_STORE_H__
+#define __LORA_FRAG_STORE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** -------------------------------------------------------------------------- *
+ * include
+ * --------------------------------------------------------------------------- *
+ */
+#include <stdbool.h>
+#include <stdint.h>
+
+/** -------------------------------------------------------------------------- *
+ * typedefs
+ * --------------------------------------------------------------------------- *
+ */
+typedef struct {
+    uint32_t    writes;         /**< decoder writes programmed in the flash */
+    uint32_t    rewrites;       /**< writes that needed a sector rewrite */
+    uint32_t    sector_erases;  /**< erased sectors, lazy and rewrites ones */
+    uint32_t    bytes_written;  /**< bytes programmed in the flash */
+    uint32_t    ram_bytes;      /**< ram of the sectors bitmap */
+    uint32_t    image_crc;      /**< crc32 of the last completed data block */
+} lora_frag_store_stats_t;
+
+/** -------------------------------------------------------------------------- *
+ * APIs
+ * --------------------------------------------------------------------------- *
+ */
+
+/**
+ * @brief   the decoder write and read callbacks, \a addr is the offset in
+ *          the data block. The store is opened by the first access.
+ * @return  0 on success, -1 on failure
+ */
+int8_t lora_frag_store_write(uint32_t addr, uint8_t* data, uint32_t size);
+int8_t lora_frag_store_read(uint32_t addr, uint8_t* data, uint32_t size);
+
+/**
+ * @brief   closes the current block, a completed block of \a size bytes is
+ *          handed to the port which validates it (the ota image on the
+ *          device), otherwise it is dropped
+ * @return  true if the block is accepted by the port
+ */
+bool lora_frag_store_close(bool is_complete, uint32_t size);
+
+void lora_frag_store_get_stats(lora_frag_store_stats_t* p_stats);
+
+/* --- end of file ---------------------------------------------------------- */
+#ifdef __cplusplus
+}
+#endif
+#endif /* __LORA_FRAG_STORE_H__ */
@@ -0,0 +1,410 @@
+/** -------------------------------------------------------------------------- *
+ * Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @author  Ahmed Sabry (SG Wireless)
+ *
+ * @brief   journaled nvm storage of a memory image.
+ * --------------------------------------------------------------------------- *
+ */
+
+/** -------------------------------------------------------------------------- *
+ * include
+ * --------------------------------------------------------------------------- *
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+
+#define __log_subsystem lora
+#define __log_component util_nvm_journal
+#include "log_lib.h"
+
+#include "stub_nvm.h"
+#include "stub_system.h"
+#include "lora_nvm_journal.h"
+
+/** -------------------------------------------------------------------------- *
+ * records format
+ * --------------------------------------------------------------------------- *
+ * snapshot record:  | image (size) | info | crc32 |
+ * journal record:   | crc32 | info | deltas ... | zero padding up to slot_size
+ * delta:            | offset (16-bit LE) | len (8-bit) | len bytes of data |
+ *
+ * the crc32 covers all the record bytes before or after it up to the end of
+ * the deltas, the padding is not covered.
+ */
+typedef struct {
+    uint32_t    magic;
+    uint32_t    seq;        // -- the commit sequence number
+    uint16_t    length;     // -- image size or deltas length
+    uint16_t    reserved;
+} journal_record_info_t;
+
+#define __snapshot_magic        ( 0x4A534E50u )
+#define __journal_magic         ( 0x4A444C54u )
+
+#define __journal_head_size     ( 4 + sizeof(journal_record_info_t) )
+#define __delta_head_size       ( 3 )
+#define __delta_max_len         ( 0xFF )
+
+#define __log_journal(_act, _seq, _len, _cmt)           \
+    __log_info(                                         \
+        " key: "__yellow__"%-12s"__default__            \
+        " act: "__green__"%-15s"__default__             \
+        " seq: "__blue__"%-6d"__default__               \
+        " len: "__blue__"%-4d"__default__               \
+        " cmt: "__cyan__"%s"__default__,                \
+        p_journal->name, _act, _seq, _len, _cmt         \
+    )
+
+/** -------------------------------------------------------------------------- *
+ * helpers
+ * --------------------------------------------------------------------------- *
+ */
+static void snapshot_key(lora_nvm_journal_t* p_journal, uint8_t idx, char* key)
+{
+    snprintf(key, __lora_nvm_journal_key_len, "%s-s%d", p_journal->name, idx);
+}
+
+static void journal_key(lora_nvm_journal_t* p_journal, uint32_t seq, char* key)
+{
+    snprintf(key, __lora_nvm_journal_key_len, "%s-j%02d", p_journal->name,
+        (int)(seq % p_journal->slots));
+}
+
+static void nvm_write(lora_nvm_journal_t* p_journal, const char* key,
+    void* buf, uint32_t len)
+{
+    lora_stub_nvm_store(key, buf, len);
+    lora_stub_nvm_sync();
+    p_journal->stats.bytes_written += len;
+}
+
+/* the snapshot is loaded in the shadow buffer which has room for its tail */
+static bool snapshot_load(lora_nvm_journal_t* p_journal, uint8_t idx,
+    uint32_t* p_seq)
+{
+    char key[__lora_nvm_journal_key_len];
+    journal_record_info_t info;
+    uint32_t crc;
+    uint32_t len = p_journal->size + sizeof(info);
+
+    snapshot_key(p_journal, idx, key);
+    if( ! lora_stub_nvm_check(key) )
+        return false;
+
+    lora_stub_nvm_load(key, p_journal->shadow, len + 4);
+    memcpy(&info, p_journal->shadow + p_journal->size, sizeof(info));
+    memcpy(&crc, p_journal->shadow + len, 4);
+
+    if( info.magic != __snapshot_magic || info.length != p_journal->size ||
+        crc != lora_stub_crc32(0, p_journal->shadow, len) )
+    {
+        __log_journal("load-snapshot", info.seq, len, __red__"corrupted");
+        return false;
+    }
+    *p_seq = info.seq;
+    return true;
+}
+
+/* encodes the changed ranges of the image into the journal slot buffer */
+static bool deltas_encode(lora_nvm_journal_t* p_journal, uint16_t* p_len)
+{
+    uint8_t* image = p_journal->image;
+    uint8_t* shadow = p_journal->shadow;
+    uint8_t* out = p_journal->slot_buf + __journal_head_size;
+    uint32_t cap = p_journal->slot_size - __journal_head_size;
+    uint32_t pos = 0;
+    uint32_t i = 0;
+    uint32_t j;
+    uint32_t start;
+    uint32_t last;
+    uint32_t len;
+
+    while( i < p_journal->size )
+    {
+        if( image[i] == shadow[i] ) {
+            ++ i;
+            continue;
+        }
+
+        /* extend the range over the next changes, unchanged gaps shorter than
+           a delta head are cheaper inside the range than a new delta */
+        start = last = i;
+        for(j = i + 1; j < p_journal->size && j - start < __delta_max_len; ++j)
+        {
+            if( image[j] != shadow[j] )
+                last = j;
+            else if( j - last > __delta_head_size )
+                break;
+        }
+        len = last - start + 1;
+
+        if( pos + __delta_head_size + len > cap )
+            return false;
+
+        out[pos ++] = start & 0xFF;
+        out[pos ++] = start >> 8;
+        out[pos ++] = len;
+        memcpy(out + pos, image + start, len);
+        pos += len;
+        i = last + 1;
+    }
+
+    *p_len = pos;
+    return true;
+}
+
+/* checks all the deltas bounds before applying any of them */
+static bool deltas_apply(lora_nvm_journal_t* p_journal, uint8_t* in,
+    uint16_t length, bool apply)
+{
+    uint32_t pos = 0;
+    uint32_t offset;
+    uint32_t len;
+
+    while( pos < length )
+    {
+        if( pos + __delta_head_size > length )
+            return false;
+        offset = in[pos] | (in[pos + 1] << 8);
+        len = in[pos + 2];
+        pos += __delta_head_size;
+        if( len == 0 || pos + len > length ||
+            offset + len > p_journal->size )
+            return false;
+        if( apply )
+            memcpy(p_journal->image + offset, in + pos, len);
+        pos += len;
+    }
+    return true;
+}
+
+static bool journal_load(lora_nvm_journal_t* p_journal, uint32_t seq)
+{
+    char key[__lora_nvm_journal_key_len];
+    journal_record_info_t info;
+    uint8_t* buf = p_journal->slot_buf;
+    uint32_t crc;
+
+    journal_key(p_journal, seq, key);
+    if( ! lora_stub_nvm_check(key) )
+        return false;
+
+    lora_stub_nvm_load(key, buf, p_journal->slot_size);
+    memcpy(&crc, buf, 4);
+    memcpy(&info, buf + 4, sizeof(info));
+
+    if( info.magic != __journal_magic || info.seq != seq ||
+        info.length > p_journal->slot_size - __journal_head_size )
+        return false;
+
+    if( crc != lora_stub_crc32(0, buf + 4, sizeof(info) + info.length) )
+    {
+        __log_journal("load-journal", seq, info.length, __red__"corrupted");
+        return false;
+    }
+
+    if( ! deltas_apply(p_journal, buf + __journal_head_size, info.length,
+            false) )
+    {
+        __log_journal("load-journal", seq, info.length, __red__"bad delta");
+        return false;
+    }
+    deltas_apply(p_journal, buf + __journal_head_size, info.length, true);
+    return true;
+}
+
+/** -------------------------------------------------------------------------- *
+ * APIs
+ * --------------------------------------------------------------------------- *
+ */
+void lora_nvm_journal_init(lora_nvm_journal_t* p_journal)
+{
+    __log_assert(sizeof(journal_record_info_t) + 4 ==
+        __lora_nvm_journal_tail_size, "invalid snapshot tail size");
+    __log_assert(p_journal->slots && p_journal->slots <=
+        __lora_nvm_journal_max_slots, "invalid journal slots count %d",
+        p_journal->slots);
+    __log_assert(p_journal->slot_size > __journal_head_size +
+        __delta_head_size, "too small journal slot size %d",
+        p_journal->slot_size);
+
+    p_journal->seq = 0;
+    p_journal->snapshot_seq = 0;
+    p_journal->snapshot_idx = 1; /* the first snapshot goes to record 0 */
+    memset(&p_journal->stats, 0, sizeof(p_journal->stats));
+}
+
+bool lora_nvm_journal_restore(lora_nvm_journal_t* p_journal)
+{
+    uint32_t seq[2];
+    bool valid[2];
+    uint8_t idx;
+
+    valid[0] = snapshot_load(p_journal, 0, &seq[0]);
+    valid[1] = snapshot_load(p_journal, 1, &seq[1]);
+
+    if( ! valid[0] && ! valid[1] )
+    {
+        __log_journal("restore", 0, 0, "no valid snapshot");
+        return false;
+    }
+
+    idx = valid[1] && ( ! valid[0] || seq[1] > seq[0] ) ? 1 : 0;
+    if( idx == 0 )
+    {
+        /* the shadow holds the last loaded snapshot */
+        snapshot_load(p_journal, 0, &seq[0]);
+    }
+
+    memcpy(p_journal->image, p_journal->shadow, p_journal->size);
+    p_journal->snapshot_idx = idx;
+    p_journal->snapshot_seq = seq[idx];
+    p_journal->seq = seq[idx];
+
+    __log_journal("load-snapshot", seq[idx], p_journal->size, "--");
+
+    /* the journal can not hold more commits than its slots after a snapshot */
+    while( p_journal->seq - p_journal->snapshot_seq < p_journal->slots &&
+           journal_load(p_journal, p_journal->seq + 1) )
+    {
+        ++ p_journal->seq;
+        ++ p_journal->stats.replayed;
+    }
+
+    memcpy(p_journal->shadow, p_journal->image, p_journal->size);
+
+    __log_journal("restore", p_journal->seq, p_journal->stats.replayed,
+        "replayed journal records");
+    return true;
+}
+
+void lora_nvm_journal_compact(lora_nvm_journal_t* p_journal)
+{
+    char key[__lora_nvm_journal_key_len];
+    journal_record_info_t info = {
+        .magic = __snapshot_magic,
+        .seq = p_journal->seq + 1,
+        .length = p_journal->size
+    };
+    uint32_t len = p_journal->size + sizeof(info);
+    uint32_t crc;
+    uint8_t idx = p_journal->snapshot_idx ^ 1;
+
+    memcpy(p_journal->shadow, p_journal->image, p_journal->size);
+    memcpy(p_journal->shadow + p_journal->size, &info, sizeof(info));
+    crc = lora_stub_crc32(0, p_journal->shadow, len);
+    memcpy(p_journal->shadow + len, &crc, 4);
+
+    snapshot_key(p_journal, idx, key);
+    __log_journal("store-snapshot", info.seq, len + 4, key);
+    nvm_write(p_journal, key, p_journal->shadow, len + 4);
+
+    p_journal->snapshot_idx = idx;
+    p_journal->snapshot_seq = info.seq;
+    p_journal->seq = info.seq;
+    ++ p_journal->stats.snapshots;
+}
+
+bool lora_nvm_journal_is_dirty(lora_nvm_journal_t* p_journal)
+{
+    return memcmp(p_journal->image, p_journal->shadow, p_journal->size) != 0;
+}
+
+bool lora_nvm_journal_commit(lora_nvm_journal_t* p_journal)
+{
+    char key[__lora_nvm_journal_key_len];
+    journal_record_info_t info = {
+        .magic = __journal_magic,
+        .seq = p_journal->seq + 1,
+    };
+    uint8_t* buf = p_journal->slot_buf;
+    uint32_t crc;
+
+    if( ! lora_nvm_journal_is_dirty(p_journal) )
+        return false;
+
+    ++ p_journal->stats.commits;
+
+    /* the slot to write still holds a commit after the newest snapshot */
+    if( info.seq - p_journal->snapshot_seq > p_journal->slots )
+    {
+        __log_journal("commit", info.seq, 0, "journal full, compact");
+        lora_nvm_journal_compact(p_journal);
+        return true;
+    }
+
+    if( ! deltas_encode(p_journal, &info.length) )
+    {
+        __log_journal("commit", info.seq, 0, "large change, compact");
+        lora_nvm_journal_compact(p_journal);
+        return true;
+    }
+
+    memcpy(buf + 4, &info, sizeof(info));
+    crc = lora_stub_crc32(0, buf + 4, sizeof(info) + info.length);
+    memcpy(buf, &crc, 4);
+    memset(buf + __journal_head_size + info.length, 0,
+        p_journal->slot_size - __journal_head_size - info.length);
+
+    journal_key(p_journal, info.seq, key);
+    __log_journal("store-journal", info.seq, info.length, key);
+    nvm_write(p_journal, key, buf, p_journal->slot_size);
+
+    memcpy(p_journal->shadow, p_journal->image, p_journal->size);
+    p_journal->seq = info.seq;
+    ++ p_journal->stats.slot_writes;
+    return true;
+}
+
+void lora_nvm_journal_clear(lora_nvm_journal_t* p_journal)
+{
+    char key[__lora_nvm_journal_key_len];
+    uint32_t i;
+
+    for(i = 0; i < 2; ++i)
+    {
+        snapshot_key(p_journal, i, key);
+        if( lora_stub_nvm_check(key) )
+            lora_stub_nvm_clear(key);
+    }
+    for(i = 0; i < p_journal->slots; ++i)
+    {
+        journal_key(p_journal, i, key);
+        if( lora_stub_nvm_check(key) )
+            lora_stub_nvm_clear(key);
+    }
+    lora_stub_nvm_sync();
+
+    __log_journal("clear", p_journal->seq, 0, "--");
+    lora_nvm_journal_init(p_journal);
+}
+
+uint32_t lora_nvm_journal_counter_resume(uint32_t counter, uint32_t gap)
+{
+    if( counter > UINT32_MAX - gap )
+        return UINT32_MAX;
+    return counter + gap;
+}
+
+/* --- end of file ---------------------------------------------------------- */
@@ -0,0 +1,153 @@
+/** -------------------------------------------------------------------------- *
+ * Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @author  Ahmed Sabry (SG Wireless)
+ *
+ * @brief   journaled nvm storage of a memory image.
+ *
+ *          The image is kept in the nvm as a full snapshot followed by a
+ *          journal of the changes committed after it:
+ *          - a commit compares the image with a shadow copy of the last
+ *            committed image and writes only the changed byte ranges as one
+ *            small delta record into the next journal slot.
+ *          - the journal slots are nvm records used in a round-robin manner,
+ *            so the writes are spread over all of them.
+ *          - when the journal is full, or a commit does not fit in one slot,
+ *            the image is compacted into a full snapshot. Two snapshot
+ *            records are written alternately, the older one is kept valid
+ *            until the newer one is completely written.
+ *
+ *          Every record carries the commit sequence number and a crc32, the
+ *          restore takes the newest valid snapshot and replays the following
+ *          journal slots in sequence until the first missing or corrupted
+ *          one. So an interrupted write loses at most the commit in progress
+ *          and the image is always restored to a committed state.
+ * --------------------------------------------------------------------------- *
+ */
+#ifndef __LORA_NVM_JOURNAL_H__
+#define __LORA_NVM_JOURNAL_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** -------------------------------------------------------------------------- *
+ * include
+ * --------------------------------------------------------------------------- *
+ */
+#include <stdbool.h>
+#include <stdint.h>
+
+/** -------------------------------------------------------------------------- *
+ * typedefs
+ * --------------------------------------------------------------------------- *
+ */
+#define __lora_nvm_journal_max_slots    (100)
+#define __lora_nvm_journal_key_len      (16)    /* nvs keys are 15 chars max */
+
+/* the snapshot record is the image followed by its info and crc */
+#define __lora_nvm_journal_tail_size    (16)
+#define __lora_nvm_journal_shadow_size(__image_size)    \
+    ( (__image_size) + __lora_nvm_journal_tail_size )
+
+typedef struct {
+    uint32_t    commits;        /**< commits with changes */
+    uint32_t    slot_writes;    /**< delta records written in the journal */
+    uint32_t    snapshots;      /**< full snapshots written */
+    uint32_t    bytes_written;  /**< all bytes stored in the nvm */
+    uint32_t    replayed;       /**< delta records applied by the restore */
+} lora_nvm_journal_stats_t;
+
+typedef struct {
+    // -- description, set by the user before the init
+    const char* name;           /**< records keys prefix, up to 8 chars */
+    uint8_t*    image;          /**< the working image changed by the user */
+    uint8_t*    shadow;         /**< the last committed image, used only by the
+                                     journal, its size is given by
+                                     __lora_nvm_journal_shadow_size() */
+    uint16_t    size;           /**< the image size */
+    uint8_t*    slot_buf;       /**< a buffer of \a slot_size bytes */
+    uint16_t    slot_size;      /**< the journal slot record size */
+    uint8_t     slots;          /**< the journal slots count */
+
+    // -- state
+    uint32_t    seq;            /**< sequence number of the last commit */
+    uint32_t    snapshot_seq;   /**< the commit of the newest snapshot */
+    uint8_t     snapshot_idx;   /**< which snapshot record is the newest */
+    lora_nvm_journal_stats_t stats;
+} lora_nvm_journal_t;
+
+/** -------------------------------------------------------------------------- *
+ * APIs
+ * --------------------------------------------------------------------------- *
+ */
+
+/**
+ * @brief   resets the journal state of a described journal, no nvm access
+ */
+void lora_nvm_journal_init(lora_nvm_journal_t* p_journal);
+
+/**
+ * @brief   restores the image from the newest valid snapshot and the journal
+ *          slots that follow it
+ * @return  false if no valid snapshot is found, the image is left untouched
+ */
+bool lora_nvm_journal_restore(lora_nvm_journal_t* p_journal);
+
+/**
+ * @brief   writes the image changes since the last commit, as a delta record
+ *          or as a full snapshot if the delta does not fit or the journal is
+ *          full
+ * @return  false if there is no change to commit
+ */
+bool lora_nvm_journal_commit(lora_nvm_journal_t* p_journal);
+
+/**
+ * @brief   writes the image as a full snapshot, the journal slots written
+ *          before it become obsolete
+ */
+void lora_nvm_journal_compact(lora_nvm_journal_t* p_journal);
+
+/**
+ * @brief   checks if the image has changes not committed yet
+ */
+bool lora_nvm_journal_is_dirty(lora_nvm_journal_t* p_journal);
+
+/**
+ * @brief   clears all the snapshot and journal records from the nvm
+ */
+void lora_nvm_journal_clear(lora_nvm_journal_t* p_journal);
+
+/**
+ * @brief   gives the value to resume a restored counter from, when the counter
+ *          is committed behind its use, e.g. a frame counter committed by a
+ *          write-behind timer. The values used after its last durable commit
+ *          are lost by a power cut, so the counter is advanced by \a gap, the
+ *          most increments that can happen before a pending commit is done.
+ * @return  the counter advanced by the gap, saturated at UINT32_MAX
+ */
+uint32_t lora_nvm_journal_counter_resume(uint32_t counter, uint32_t gap);
+
+/* --- end of file ---------------------------------------------------------- */
+#ifdef __cplusplus
+}
+#endif
+#endif /* __LORA_NVM_JOURNAL_H__ */
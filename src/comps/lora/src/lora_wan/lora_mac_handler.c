@@ -204,6 +204,7 @@ void lmh_init( void )
 
 void lmh_reset(bool purge_nvm)
 {
+    lora_nvm_flush();
     lora_stub_timers_stop_all();
 
     if( LoRaMacDeInitialization() != LORAMAC_STATUS_OK ) {
@@ -542,6 +543,12 @@ static void cb_OnTxData( LmHandlerTxParams_t *params )
     }
     __log_printf_fill(80, '-', true);
 
+    if(params->MsgType) {
+        /* a confirmed uplink without ack is a missed downlink window */
+        void lw_rxwin_auto_calibration_on_confirm(bool ack_received);
+        lw_rxwin_auto_calibration_on_confirm(params->AckReceived);
+    }
+
     if(on_mac_tx)
     {
         lmh_tx_status_params_t tx_info = {
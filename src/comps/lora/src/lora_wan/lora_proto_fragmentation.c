@@ -41,6 +41,7 @@
 #include "LmHandlerTypes.h"
 #include "LmhPackage.h"
 #include "LmhpFragmentation.h"
+#include "lora_frag_store.h"
 
 
 /** -------------------------------------------------------------------------- *
@@ -71,27 +72,30 @@ static LmhpFragmentationParams_t s_lmh_fragmentation_params =
 
 static int8_t cb_FragDecoderWrite(uint32_t addr, uint8_t *data, uint32_t size)
 {
-    // __log_callback("frag decoder write");
-
-    __log_dump(data, size, 16, __log_dump_flag_hide_address, __word_len_8);
-
-    return 0;
+    return lora_frag_store_write(addr, data, size);
 }
 static int8_t cb_FragDecoderRead(uint32_t addr, uint8_t *data, uint32_t size)
 {
-    __log_callback("frag decoder read");
-
-    return 0;
+    return lora_frag_store_read(addr, data, size);
 }
 static void cb_OnProgress(
     uint16_t fragCounter, uint16_t fragNb,
     uint8_t fragSize, uint16_t fragNbLost )
 {
-    __log_callback("frag on progress");
+    __log_info("fragment %d of %d ( %d bytes ), lost %d",
+        fragCounter, fragNb, fragSize, fragNbLost);
 }
 static void cb_OnDone( int32_t status, uint32_t size )
 {
     __log_callback("frag on done");
+
+    // -- a non negative status is the count of the recovered lost fragments
+    if( lora_frag_store_close( status >= 0, size ) ) {
+        __log_info("data block of %d bytes "__green__"accepted", size);
+    } else {
+        __log_error("data block of %d bytes dropped, status %d",
+            size, status);
+    }
 }
 
 void lora_proto_fragmentation_init(void)
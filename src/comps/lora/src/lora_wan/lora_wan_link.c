@@ -0,0 +1,357 @@
+/** -------------------------------------------------------------------------- *
+ * Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ * @author  Ahmed Sabry (SG Wireless)
+ * 
+ * @brief   lora-wan uplinks link quality telemetry sub-component. Every uplink
+ *          transaction of the lora-wan process, from the first transmission
+ *          of a message until its confirmation, its last retry or its
+ *          timeout, is summarized in one link record kept in a fixed size
+ *          ring, with the downlink received in its rx windows if any.
+ *          The records are accounted as well in statistics per data-rate and
+ *          in moving averages of the downlinks quality.
+ *
+ *          The frame airtime and the reception spreading factor are taken
+ *          from the radio configuration by the mac radio events, as they are
+ *          not reported by the mac tx and rx status.
+ * --------------------------------------------------------------------------- *
+ */
+
+/* --- includes ------------------------------------------------------------- */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define __log_subsystem     lora
+#define __log_component     wan_link
+#include "log_lib.h"
+
+#include "LoRaMac.h"
+#include "lora_mac_handler.h"
+#include "lora_wan_link.h"
+#include "radio_ext.h"
+#include "stub_system.h"
+
+/** -------------------------------------------------------------------------- *
+ * link ring state
+ * --------------------------------------------------------------------------- *
+ */
+#ifdef CONFIG_LORA_WAN_LINK_RING_SLOTS
+    #define __link_ring_slots       CONFIG_LORA_WAN_LINK_RING_SLOTS
+#else
+    #define __link_ring_slots       (32)
+#endif
+
+/* the moving averages are kept in 1/16 units with a weight of 1/8 */
+#define __link_avg_scale            (16)
+#define __link_avg_weight           (8)
+
+/* the mac indicates the downlink of an uplink right after its confirmation,
+   a downlink received later is not attributed to the last record */
+#define __link_dl_pending_ms        (1000)
+
+static struct {
+    lora_wan_link_record_t  ring[__link_ring_slots];
+    uint32_t                next_seq;
+    lora_wan_link_stats_t   stats;
+
+    /* the transaction in progress */
+    lora_wan_link_record_t  cur;
+    bool                    is_open;
+    bool                    confirm;
+    bool                    transmitted;
+    uint8_t                 attempts;
+
+    /* the last recorded transaction still waits for its downlink */
+    bool                    is_dl_pending;
+} s_link;
+
+static void* s_link_mutex;
+
+/* written by the mac radio events and read by the mac tx and rx status */
+static volatile uint32_t s_radio_airtime_us;
+static volatile uint8_t s_radio_rx_sf;
+
+/** -------------------------------------------------------------------------- *
+ * helpers
+ * --------------------------------------------------------------------------- *
+ */
+static void link_avg_update(int16_t* p_avg, int32_t value, bool is_first)
+{
+    value *= __link_avg_scale;
+    if( is_first )
+        *p_avg = value;
+    else
+        *p_avg += ( value - *p_avg ) / __link_avg_weight;
+}
+
+static lora_wan_link_dr_stats_t* link_dr_stats(int8_t data_rate)
+{
+    if( data_rate < 0 || data_rate >= __LORA_WAN_LINK_DR_COUNT )
+        return NULL;
+    return &s_link.stats.dr[data_rate];
+}
+
+static void link_set_downlink(lora_wan_link_record_t* p_record,
+    lmh_rx_status_params_t* p_rx_info)
+{
+    uint8_t sf = s_radio_rx_sf;
+    bool is_first = s_link.stats.downlinks == 0;
+
+    p_record->has_dl = true;
+    p_record->dl_rssi = p_rx_info->rssi;
+    p_record->dl_snr = p_rx_info->snr;
+
+    /* the lora demodulation floor is -7.5 dB at SF7 and 2.5 dB lower for
+       every higher spreading factor, it is the floor used by the link
+       check margin as well */
+    if( sf >= 5 && sf <= 12 ) {
+        p_record->has_margin = true;
+        p_record->dl_snr_margin = ( 2 * p_rx_info->snr + 5 * ( sf - 4 ) ) / 2;
+        link_avg_update(&s_link.stats.snr_margin_avg,
+            p_record->dl_snr_margin, is_first);
+    }
+    link_avg_update(&s_link.stats.rssi_avg, p_rx_info->rssi, is_first);
+    ++ s_link.stats.downlinks;
+}
+
+/** -------------------------------------------------------------------------- *
+ * APIs
+ * --------------------------------------------------------------------------- *
+ */
+void lora_wan_link_ctor(void)
+{
+    if( s_link_mutex == NULL )
+        s_link_mutex = lora_stub_mutex_new();
+
+    memset(&s_link, 0, sizeof(s_link));
+    s_radio_airtime_us = 0;
+    s_radio_rx_sf = 0;
+}
+
+void lora_wan_link_dtor(void)
+{
+    s_link.is_open = false;
+    s_link.is_dl_pending = false;
+}
+
+void lora_wan_link_tx_begin(uint8_t port, bool confirm)
+{
+    lora_stub_mutex_lock(s_link_mutex);
+    memset(&s_link.cur, 0, sizeof(s_link.cur));
+    s_link.cur.port = port;
+    s_link.confirm = confirm;
+    s_link.transmitted = false;
+    s_link.attempts = 0;
+    s_link.is_open = true;
+    s_link.is_dl_pending = false;
+    s_radio_airtime_us = 0;
+    lora_stub_mutex_unlock(s_link_mutex);
+}
+
+void lora_wan_link_on_tx(lmh_tx_status_params_t* p_tx_info)
+{
+    lora_wan_link_dr_stats_t* p_dr;
+    uint32_t airtime;
+
+    if( ! s_link.is_open )
+        return;
+
+    airtime = s_radio_airtime_us;
+    s_radio_airtime_us = 0;
+
+    lora_stub_mutex_lock(s_link_mutex);
+    if( s_link.attempts < UINT8_MAX )
+        ++ s_link.attempts;
+    s_link.cur.data_rate = p_tx_info->data_rate;
+    s_link.cur.tx_power = p_tx_info->tx_power;
+    s_link.cur.ul_counter = p_tx_info->ul_counter;
+    s_link.cur.airtime += airtime;
+
+    p_dr = link_dr_stats(p_tx_info->data_rate);
+    if( p_tx_info->status == LORAMAC_EVENT_INFO_STATUS_OK && p_dr ) {
+        s_link.transmitted = true;
+        ++ p_dr->transmissions;
+        p_dr->airtime += ( airtime + 500 ) / 1000;
+        if( s_link.confirm ) {
+            ++ p_dr->confirmed;
+            if( p_tx_info->ack_received )
+                ++ p_dr->acked;
+        }
+    }
+    lora_stub_mutex_unlock(s_link_mutex);
+}
+
+void lora_wan_link_on_rx(lmh_rx_status_params_t* p_rx_info)
+{
+    lora_wan_link_record_t* p_last;
+
+    if( p_rx_info->status != LORAMAC_EVENT_INFO_STATUS_OK ||
+        ( p_rx_info->rx_slot != RX_SLOT_WIN_1 &&
+          p_rx_info->rx_slot != RX_SLOT_WIN_2 ) )
+        return;
+
+    lora_stub_mutex_lock(s_link_mutex);
+    if( s_link.is_open ) {
+        if( ! s_link.cur.has_dl )
+            link_set_downlink(&s_link.cur, p_rx_info);
+    } else if( s_link.is_dl_pending ) {
+        s_link.is_dl_pending = false;
+        p_last = &s_link.ring[(s_link.next_seq - 1) % __link_ring_slots];
+        if( lora_stub_get_timestamp_ms() - p_last->timestamp <=
+                __link_dl_pending_ms )
+            link_set_downlink(p_last, p_rx_info);
+    }
+    lora_stub_mutex_unlock(s_link_mutex);
+}
+
+void lora_wan_link_tx_end(lora_wan_link_result_t result)
+{
+    lora_wan_link_dr_stats_t* p_dr;
+    lora_wan_link_record_t* p_record;
+
+    if( ! s_link.is_open )
+        return;
+
+    lora_stub_mutex_lock(s_link_mutex);
+    s_link.is_open = false;
+
+    /* a message dropped before any transmission is not a link transaction */
+    if( s_link.attempts == 0 ) {
+        lora_stub_mutex_unlock(s_link_mutex);
+        return;
+    }
+
+    if( result == __LORA_WAN_LINK_FAILED && s_link.confirm &&
+        s_link.transmitted )
+        result = __LORA_WAN_LINK_NOT_ACKED;
+
+    p_record = &s_link.ring[s_link.next_seq % __link_ring_slots];
+    *p_record = s_link.cur;
+    p_record->seq = s_link.next_seq ++;
+    p_record->timestamp = lora_stub_get_timestamp_ms();
+    p_record->retries = s_link.attempts - 1;
+    p_record->result = result;
+
+    ++ s_link.stats.transactions;
+    if( result != __LORA_WAN_LINK_SENT && result != __LORA_WAN_LINK_ACKED )
+        ++ s_link.stats.failures;
+    p_dr = link_dr_stats(p_record->data_rate);
+    if( p_dr )
+        ++ p_dr->transactions;
+
+    s_link.is_dl_pending = ! p_record->has_dl;
+    lora_stub_mutex_unlock(s_link_mutex);
+
+    __log_info("link record %d: port %d, DR%d, retries %d, result %d, "
+        "airtime %d us", p_record->seq, p_record->port, p_record->data_rate,
+        p_record->retries, p_record->result, p_record->airtime);
+}
+
+void lw_link_on_radio_tx_done(void)
+{
+    s_radio_airtime_us += lora_radio_ext_get_frame_time_us(
+        lora_radio_ext_get_payload_length());
+}
+
+void lw_link_on_radio_rx_done(void)
+{
+    s_radio_rx_sf = lora_radio_ext_get_spreading_factor();
+}
+
+void lora_wan_link_get_stats(lora_wan_link_stats_t* p_stats)
+{
+    lora_stub_mutex_lock(s_link_mutex);
+    *p_stats = s_link.stats;
+    lora_stub_mutex_unlock(s_link_mutex);
+}
+
+void lora_wan_link_read(lora_wan_link_read_t* p_read)
+{
+    uint32_t seq;
+    uint32_t oldest;
+
+    lora_stub_mutex_lock(s_link_mutex);
+    oldest = s_link.next_seq > __link_ring_slots ?
+        s_link.next_seq - __link_ring_slots : 0;
+
+    seq = p_read->since;
+    p_read->dropped = 0;
+    if( seq < oldest ) {
+        p_read->dropped = oldest - seq;
+        seq = oldest;
+    }
+
+    p_read->count = 0;
+    while( seq < s_link.next_seq && p_read->count < p_read->max ) {
+        p_read->p_records[p_read->count ++] =
+            s_link.ring[seq % __link_ring_slots];
+        ++ seq;
+    }
+    p_read->next = seq > s_link.next_seq ? s_link.next_seq : seq;
+    lora_stub_mutex_unlock(s_link_mutex);
+}
+
+void lora_wan_link_reset(void)
+{
+    /* the sequence numbers go on, so the readers can keep on reading */
+    lora_stub_mutex_lock(s_link_mutex);
+    s_link.is_dl_pending = false;
+    memset(s_link.ring, 0, sizeof(s_link.ring));
+    memset(&s_link.stats, 0, sizeof(s_link.stats));
+    lora_stub_mutex_unlock(s_link_mutex);
+}
+
+void lora_wan_link_stats(void)
+{
+    lora_wan_link_stats_t stats;
+    lora_wan_link_dr_stats_t* p_dr;
+    uint32_t per;
+    int32_t margin;
+    int i;
+
+    lora_wan_link_get_stats(&stats);
+    if( stats.transactions == 0 )
+        return;
+
+    margin = stats.snr_margin_avg * 10 / __link_avg_scale;
+    __log_output("link: %d transactions, %d failures, %d downlinks, "
+        "avg snr margin %s%d.%d dB, avg rssi %d dBm\n",
+        stats.transactions, stats.failures, stats.downlinks,
+        margin < 0 ? "-" : "", abs(margin) / 10, abs(margin) % 10,
+        stats.rssi_avg / __link_avg_scale);
+
+    for( i = 0; i < __LORA_WAN_LINK_DR_COUNT; ++i ) {
+        p_dr = &stats.dr[i];
+        if( ! p_dr->transmissions )
+            continue;
+        per = p_dr->confirmed ?
+            ( p_dr->confirmed - p_dr->acked ) * 1000 / p_dr->confirmed : 0;
+        __log_output("link DR%-2d: %d transactions, %d transmissions, "
+            "%d/%d acked, PER %d.%d %%, airtime %d ms\n", i,
+            p_dr->transactions, p_dr->transmissions, p_dr->acked,
+            p_dr->confirmed, per / 10, per % 10, p_dr->airtime);
+    }
+}
+
+/* --- end of file ---------------------------------------------------------- */
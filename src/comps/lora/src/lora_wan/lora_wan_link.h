@@ -0,0 +1,94 @@
+/** -------------------------------------------------------------------------- *
+ * Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ * @author  Ahmed Sabry (SG Wireless)
+ * 
+ * @brief   lora-wan uplinks link quality telemetry sub-component header
+ * --------------------------------------------------------------------------- *
+ */
+#ifndef __LORA_WAN_LINK_H__
+#define __LORA_WAN_LINK_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --- includes ------------------------------------------------------------- */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "lora.h"
+#include "lora_mac_handler.h"
+
+/** -------------------------------------------------------------------------- *
+ * APIs
+ * --------------------------------------------------------------------------- *
+ */
+
+void lora_wan_link_ctor(void);
+
+void lora_wan_link_dtor(void);
+
+/**
+ * @brief   starts the record of a new uplink transaction, called by the
+ *          lora-wan process when it picks up a new message
+ */
+void lora_wan_link_tx_begin(uint8_t port, bool confirm);
+
+/**
+ * @brief   accounts a mac tx status of the transaction in progress, every one
+ *          is a transmission or a retry of the transaction
+ */
+void lora_wan_link_on_tx(lmh_tx_status_params_t* p_tx_info);
+
+/**
+ * @brief   accounts a downlink to the transaction in progress or to the last
+ *          recorded one if it was received in its rx windows
+ */
+void lora_wan_link_on_rx(lmh_rx_status_params_t* p_rx_info);
+
+/**
+ * @brief   ends the transaction in progress and stores its record in the ring
+ */
+void lora_wan_link_tx_end(lora_wan_link_result_t result);
+
+/**
+ * @brief   called by the mac radio handling on every tx-done and rx-done to
+ *          take the frame airtime and the reception spreading factor from the
+ *          radio configuration
+ */
+void lw_link_on_radio_tx_done(void);
+void lw_link_on_radio_rx_done(void);
+
+void lora_wan_link_get_stats(lora_wan_link_stats_t* p_stats);
+
+void lora_wan_link_read(lora_wan_link_read_t* p_read);
+
+void lora_wan_link_reset(void);
+
+void lora_wan_link_stats(void);
+
+/* --- end of file ---------------------------------------------------------- */
+#ifdef __cplusplus
+}
+#endif
+#endif /* __LORA_WAN_LINK_H__ */
@@ -54,6 +54,8 @@
 #include "utils_bitarray.h"
 #include "lora_proto_compliance.h"
 #include "lora_wan_radio_process.h"
+#include "lora_wan_mcast.h"
+#include "lora_wan_link.h"
 
 /** -------------------------------------------------------------------------- *
  * applications ports alloc/free
@@ -224,6 +226,8 @@ static lora_error_t lora_wan_ctor(void)
     #endif /* CONFIG_LORA_LCT_MODE */
 
     lora_wan_duty_ctor();
+    lora_wan_mcast_ctor();
+    lora_wan_link_ctor();
     lora_wan_process_ctor();
 
     return ret;
@@ -234,8 +238,11 @@ static lora_error_t lora_wan_dtor(void)
 
     __log_info("lora wan ~dtor()");
 
+    lora_nvm_flush();
     lora_wan_duty_dtor();
     lora_stub_timers_stop_all();
+    lora_wan_mcast_dtor();
+    lora_wan_link_dtor();
     lora_wan_process_dtor();
 
     LoRaMacStop();
@@ -244,7 +251,7 @@ static lora_error_t lora_wan_dtor(void)
         __log_error("lora mac deinit failed");
     }
 
-    lora_port_close_all();
+    lora_wan_port_dtor();
     port_free_all();
 
     /** TODO: reset radio and put it into sleep */
@@ -262,6 +269,11 @@ static lora_error_t lora_wan_stats(void)
     __log_info("lora wan stats()");
 
     lora_utils_stats();
+    lora_wan_port_sched_stats();
+    lora_wan_mcast_stats();
+    lora_wan_link_stats();
+    lw_rxwin_auto_calibration_stats();
+    lora_nvm_stats();
 
     return ret;
 }
@@ -466,6 +478,73 @@ static lora_error_t lora_wan_ioctl(uint32_t ioctl, void* arg)
             port_free(p_port);
         }
     }
+    else if( ioctl == __LORA_IOCTL_PORT_AGGREGATION )
+    {
+        lora_wan_port_aggr_t * p_aggr = arg;
+        __log_info("ioctl -> port %d aggregation: %s", p_aggr->port,
+            g_on_off[p_aggr->enable]);
+
+        lora_wan_port_t* p_port = port_get(p_aggr->port);
+
+        if( p_port == NULL ||
+            lora_wan_port_set_aggregation(p_port, p_aggr->enable) != __PORT_OK )
+        {
+            __log_error("port %d is not opened", p_aggr->port);
+            ret = __LORA_ERROR;
+        }
+    }
+    else if( ioctl == __LORA_IOCTL_PORT_SCHED )
+    {
+        lora_wan_port_sched_t * p_sched = arg;
+        __log_info("ioctl -> port %d scheduling: priority %d, weight %d",
+            p_sched->port, p_sched->priority, p_sched->weight);
+
+        lora_wan_port_t* p_port = port_get(p_sched->port);
+
+        if( p_port == NULL ||
+            lora_wan_port_set_sched(p_port, p_sched->priority,
+                p_sched->weight) != __PORT_OK )
+        {
+            __log_error("port %d is not opened", p_sched->port);
+            ret = __LORA_ERROR;
+        }
+    }
+    else if( ioctl == __LORA_IOCTL_NVM_FLUSH )
+    {
+        __log_info("ioctl -> nvm flush");
+        lora_nvm_flush();
+    }
+    else if( ioctl == __LORA_IOCTL_MCAST_SETUP )
+    {
+        lora_wan_mcast_setup_t * p_setup = arg;
+        __log_info("ioctl -> mcast group %d setup", p_setup->group);
+        ret = lora_wan_mcast_setup(p_setup);
+    }
+    else if( ioctl == __LORA_IOCTL_MCAST_DELETE )
+    {
+        __log_info("ioctl -> mcast group %d delete", *(uint8_t*)arg);
+        ret = lora_wan_mcast_delete(*(uint8_t*)arg);
+    }
+    else if( ioctl == __LORA_IOCTL_MCAST_STATUS )
+    {
+        __log_info("ioctl -> mcast group status");
+        ret = lora_wan_mcast_get_status(arg);
+    }
+    else if( ioctl == __LORA_IOCTL_LINK_STATS )
+    {
+        __log_info("ioctl -> link stats");
+        lora_wan_link_get_stats(arg);
+    }
+    else if( ioctl == __LORA_IOCTL_LINK_READ )
+    {
+        __log_info("ioctl -> link records read");
+        lora_wan_link_read(arg);
+    }
+    else if( ioctl == __LORA_IOCTL_LINK_RESET )
+    {
+        __log_info("ioctl -> link records reset");
+        lora_wan_link_reset();
+    }
     else if( ioctl == __LORA_IOCTL_PORT_GET_IND_PARAM )
     {
         __log_info("ioctl -> get available indication");
@@ -491,6 +570,12 @@ static lora_error_t lora_wan_ioctl(uint32_t ioctl, void* arg)
         } else if (p_param->type == __LORA_WAN_PARAM_CAL_RXWIN_EXTENSION) {
             p_param->param.cal_time_extension =
                 lw_rxwin_calibration_get_time_extension();
+        } else if (p_param->type == __LORA_WAN_PARAM_CAL_AUTO) {
+            p_param->param.cal_auto =
+                lw_rxwin_auto_calibration_get_enablement();
+        } else if (p_param->type == __LORA_WAN_PARAM_CAL_AUTO_TARGET) {
+            p_param->param.cal_auto_target =
+                lw_rxwin_auto_calibration_get_target();
         } else {
             __log_error("unknown lorawan parameter : %d", p_param->type);
         }
@@ -518,6 +603,11 @@ static lora_error_t lora_wan_ioctl(uint32_t ioctl, void* arg)
         } else if (p_param->type == __LORA_WAN_PARAM_CAL_RXWIN_EXTENSION) {
             lw_rxwin_calibration_set_time_extension(
                 p_param->param.cal_time_extension);
+        } else if (p_param->type == __LORA_WAN_PARAM_CAL_AUTO) {
+            lw_rxwin_auto_calibration_set_enablement(p_param->param.cal_auto);
+        } else if (p_param->type == __LORA_WAN_PARAM_CAL_AUTO_TARGET) {
+            lw_rxwin_auto_calibration_set_target(
+                p_param->param.cal_auto_target);
         } else {
             __log_error("unknown lorawan parameter : %d", p_param->type);
         }
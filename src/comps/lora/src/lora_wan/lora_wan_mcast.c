@@ -0,0 +1,390 @@
+/** -------------------------------------------------------------------------- *
+ * Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ * @author  Ahmed Sabry (SG Wireless)
+ * 
+ * @brief   lora-wan multicast groups management sub-component. The groups are
+ *          set up locally in the mac multicast contexts, the ones shared with
+ *          the remote multicast setup package. Every accepted downlink is
+ *          attributed to its group by the device address of the last received
+ *          radio frame, so the groups set up remotely are accounted as well.
+ * --------------------------------------------------------------------------- *
+ */
+
+/* --- includes ------------------------------------------------------------- */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#define __log_subsystem     lora
+#define __log_component     wan_mc_group
+#include "log_lib.h"
+
+#include "LoRaMac.h"
+#include "lora_wan_process.h"
+#include "lora_mac_handler.h"
+#include "lora_mac_utils.h"
+#include "lora_wan_mcast.h"
+#include "stub_timers.h"
+#include "stub_system.h"
+
+/** -------------------------------------------------------------------------- *
+ * multicast groups state
+ * --------------------------------------------------------------------------- *
+ */
+#define __mhdr_mtype_mask               ( 0xE0 )
+#define __mhdr_unconfirmed_down         ( 0x60 )
+#define __mhdr_confirmed_down           ( 0xA0 )
+
+typedef struct {
+    lora_wan_mcast_status_t status;
+    uint32_t    session_start;
+    uint32_t    session_time;
+    bool        is_session_pending;
+    void*       session_timer;
+} mcast_group_t;
+
+static mcast_group_t s_groups[__LORA_WAN_MCAST_GROUPS];
+static void* s_mcast_mutex;
+
+/* written by the mac rx done handling and read by the rx indication */
+static volatile uint32_t s_last_rx_addr;
+
+static const char* s_timer_names[__LORA_WAN_MCAST_GROUPS] = {
+    "mcast-session-0", "mcast-session-1", "mcast-session-2", "mcast-session-3"
+};
+
+/** -------------------------------------------------------------------------- *
+ * sessions
+ * --------------------------------------------------------------------------- *
+ */
+static bool is_class_c_session_running(void)
+{
+    int i;
+    for( i = 0; i < __LORA_WAN_MCAST_GROUPS; ++i ) {
+        if( s_groups[i].status.is_session &&
+            s_groups[i].status.class == __LORA_WAN_CLASS_C )
+            return true;
+    }
+    return false;
+}
+
+static void session_start(mcast_group_t* p_group)
+{
+    __log_info("group %d session start", p_group->status.group);
+
+    if( p_group->status.class == __LORA_WAN_CLASS_C ) {
+        if( ! is_class_c_session_running() )
+            lmh_start_class_c_temp_session();
+    } else if( lmh_get_class() != __LORA_WAN_CLASS_B ) {
+        __log_warn("group %d class B session needs the device in class B",
+            p_group->status.group);
+    }
+    p_group->status.is_session = true;
+    p_group->is_session_pending = false;
+
+    if( p_group->session_time ) {
+        __log_timer_start(s_timer_names[p_group->status.group],
+            p_group->session_time * 1000);
+        lora_stub_timer_start(p_group->session_timer,
+            p_group->session_time * 1000);
+    }
+}
+
+static void session_stop(mcast_group_t* p_group)
+{
+    lora_stub_timer_stop(p_group->session_timer);
+    p_group->is_session_pending = false;
+
+    if( ! p_group->status.is_session )
+        return;
+
+    __log_info("group %d session end", p_group->status.group);
+    p_group->status.is_session = false;
+    if( p_group->status.class == __LORA_WAN_CLASS_C &&
+        ! is_class_c_session_running() )
+        lmh_stop_class_c_temp_session();
+}
+
+static void session_timer_cb(void* arg)
+{
+    mcast_group_t* p_group = arg;
+
+    lora_stub_mutex_lock(s_mcast_mutex);
+    if( p_group->is_session_pending )
+        session_start(p_group);
+    else
+        session_stop(p_group);
+    lora_stub_mutex_unlock(s_mcast_mutex);
+}
+
+/** -------------------------------------------------------------------------- *
+ * mac groups setup, in the lora-wan process context
+ * --------------------------------------------------------------------------- *
+ */
+static lora_error_t mcast_setup(lora_wan_mcast_setup_t* p_setup)
+{
+    mcast_group_t* p_group = &s_groups[p_setup->group];
+    McChannelParams_t channel = {
+        .IsRemotelySetup = false,
+        .Class = (DeviceClass_t)p_setup->class,
+        .IsEnabled = true,
+        .GroupID = (AddressIdentifier_t)(MULTICAST_0_ADDR + p_setup->group),
+        .Address = p_setup->addr,
+        .McKeys.Session.McAppSKey = p_setup->app_s_key,
+        .McKeys.Session.McNwkSKey = p_setup->nwk_s_key,
+        .FCountMin = p_setup->f_cnt_min,
+        .FCountMax = p_setup->f_cnt_max,
+    };
+    LoRaMacStatus_t status;
+    uint8_t rx_status = 0;
+
+    if( p_setup->class == __LORA_WAN_CLASS_B ) {
+        channel.RxParams.ClassB.Frequency = p_setup->frequency;
+        channel.RxParams.ClassB.Datarate = p_setup->data_rate;
+        channel.RxParams.ClassB.Periodicity = p_setup->periodicity;
+    } else {
+        channel.RxParams.ClassC.Frequency = p_setup->frequency;
+        channel.RxParams.ClassC.Datarate = p_setup->data_rate;
+    }
+
+    // -- a group set up again replaces the previous one
+    session_stop(p_group);
+    LoRaMacMcChannelDelete(channel.GroupID);
+
+    status = LoRaMacMcChannelSetup(&channel);
+    if( status == LORAMAC_STATUS_OK )
+        status = LoRaMacMcChannelSetupRxParams(channel.GroupID,
+            &channel.RxParams, &rx_status);
+    // -- the rx params status has the group, data-rate and frequency error
+    //    bits 4, 2 and 3
+    if( status != LORAMAC_STATUS_OK || ( rx_status & 0x1C ) ) {
+        __log_error("group %d setup failed: %s, rx params status 0x%02x",
+            p_setup->group, lora_utils_get_mac_return_status_str(status),
+            rx_status);
+        LoRaMacMcChannelDelete(channel.GroupID);
+        memset(&p_group->status, 0, sizeof(p_group->status));
+        return __LORA_ERROR;
+    }
+
+    memset(&p_group->status, 0, sizeof(p_group->status));
+    p_group->status.group = p_setup->group;
+    p_group->status.is_setup = true;
+    p_group->status.addr = p_setup->addr;
+    p_group->status.class = p_setup->class;
+    p_group->status.frequency = p_setup->frequency;
+    p_group->status.data_rate = p_setup->data_rate;
+    p_group->session_start = p_setup->session_start;
+    p_group->session_time = p_setup->session_time;
+
+    __log_info("group %d setup: addr %08x, class %c, freq %d, dr %d",
+        p_setup->group, p_setup->addr, 'A' + p_setup->class,
+        p_setup->frequency, p_setup->data_rate);
+
+    if( p_setup->session_start ) {
+        p_group->is_session_pending = true;
+        __log_timer_start(s_timer_names[p_setup->group],
+            p_setup->session_start * 1000);
+        lora_stub_timer_start(p_group->session_timer,
+            p_setup->session_start * 1000);
+    } else {
+        session_start(p_group);
+    }
+    return __LORA_OK;
+}
+
+static lora_error_t mcast_delete(uint8_t group)
+{
+    mcast_group_t* p_group = &s_groups[group];
+
+    session_stop(p_group);
+    memset(&p_group->status, 0, sizeof(p_group->status));
+    p_group->status.group = group;
+
+    if( LoRaMacMcChannelDelete((AddressIdentifier_t)(MULTICAST_0_ADDR + group))
+            != LORAMAC_STATUS_OK ) {
+        __log_error("group %d delete failed", group);
+        return __LORA_ERROR;
+    }
+    __log_info("group %d deleted", group);
+    return __LORA_OK;
+}
+
+void lora_wan_mcast_process_request(lora_wan_mcast_req_t* p_req)
+{
+    lora_stub_mutex_lock(s_mcast_mutex);
+    if( p_req->type == __MCAST_REQ_SETUP )
+        p_req->ret = mcast_setup(p_req->p_setup);
+    else
+        p_req->ret = mcast_delete(p_req->group);
+    lora_stub_mutex_unlock(s_mcast_mutex);
+
+    sync_obj_signal(p_req->sync_obj);
+}
+
+/** -------------------------------------------------------------------------- *
+ * APIs
+ * --------------------------------------------------------------------------- *
+ */
+void lora_wan_mcast_ctor(void)
+{
+    int i;
+
+    if( s_mcast_mutex == NULL )
+        s_mcast_mutex = lora_stub_mutex_new();
+
+    for( i = 0; i < __LORA_WAN_MCAST_GROUPS; ++i ) {
+        memset(&s_groups[i], 0, sizeof(s_groups[i]));
+        s_groups[i].status.group = i;
+        __log_timer_ctor(s_timer_names[i]);
+        s_groups[i].session_timer = lora_stub_timer_init(s_timer_names[i],
+            session_timer_cb, &s_groups[i]);
+    }
+    s_last_rx_addr = 0;
+}
+
+void lora_wan_mcast_dtor(void)
+{
+    int i;
+
+    for( i = 0; i < __LORA_WAN_MCAST_GROUPS; ++i ) {
+        __log_timer_dtor(s_timer_names[i]);
+        lora_stub_timer_delete(s_groups[i].session_timer);
+        s_groups[i].session_timer = NULL;
+    }
+}
+
+static lora_error_t mcast_request(lora_wan_mcast_req_t* p_req)
+{
+    p_req->sync_obj = sync_obj_acquire("mcast-req");
+    lora_wan_process_request(__LORA_WAN_PROCESS_MCAST_REQ, p_req);
+    sync_obj_wait(p_req->sync_obj);
+    sync_obj_release(p_req->sync_obj);
+    return p_req->ret;
+}
+
+lora_error_t lora_wan_mcast_setup(lora_wan_mcast_setup_t* p_setup)
+{
+    lora_wan_mcast_req_t req = {
+        .type = __MCAST_REQ_SETUP,
+        .p_setup = p_setup
+    };
+
+    if( p_setup->group >= __LORA_WAN_MCAST_GROUPS ||
+        p_setup->nwk_s_key == NULL || p_setup->app_s_key == NULL ||
+        ( p_setup->class != __LORA_WAN_CLASS_B &&
+          p_setup->class != __LORA_WAN_CLASS_C ) )
+    {
+        __log_error("invalid multicast group setup");
+        return __LORA_ERROR;
+    }
+    return mcast_request(&req);
+}
+
+lora_error_t lora_wan_mcast_delete(uint8_t group)
+{
+    lora_wan_mcast_req_t req = {
+        .type = __MCAST_REQ_DELETE,
+        .group = group
+    };
+
+    if( group >= __LORA_WAN_MCAST_GROUPS ) {
+        __log_error("invalid multicast group %d", group);
+        return __LORA_ERROR;
+    }
+    return mcast_request(&req);
+}
+
+lora_error_t lora_wan_mcast_get_status(lora_wan_mcast_status_t* p_status)
+{
+    uint8_t group = p_status->group;
+
+    if( group >= __LORA_WAN_MCAST_GROUPS )
+        return __LORA_ERROR;
+
+    lora_stub_mutex_lock(s_mcast_mutex);
+    *p_status = s_groups[group].status;
+    lora_stub_mutex_unlock(s_mcast_mutex);
+    return __LORA_OK;
+}
+
+void lw_mcast_on_radio_rx(uint8_t* payload, uint16_t size)
+{
+    uint8_t mtype;
+
+    s_last_rx_addr = 0;
+    if( size < 5 )
+        return;
+
+    mtype = payload[0] & __mhdr_mtype_mask;
+    if( mtype == __mhdr_unconfirmed_down || mtype == __mhdr_confirmed_down )
+        s_last_rx_addr = payload[1] | (payload[2] << 8) |
+            (payload[3] << 16) | ((uint32_t)payload[4] << 24);
+}
+
+int8_t lora_wan_mcast_on_rx(lmh_rx_status_params_t* p_rx_info)
+{
+    lora_wan_mcast_status_t* p_status;
+    uint8_t group;
+
+    if( s_last_rx_addr == 0 ||
+        p_rx_info->status != LORAMAC_EVENT_INFO_STATUS_OK )
+        return -1;
+
+    group = LoRaMacMcChannelGetGroupId(s_last_rx_addr);
+    if( group >= __LORA_WAN_MCAST_GROUPS )
+        return -1;
+
+    lora_stub_mutex_lock(s_mcast_mutex);
+    p_status = &s_groups[group].status;
+    p_status->addr = s_last_rx_addr;
+    ++ p_status->rx_frames;
+    p_status->rx_bytes += p_rx_info->len;
+    p_status->last_f_cnt = p_rx_info->dl_counter;
+    p_status->last_rssi = p_rx_info->rssi;
+    p_status->last_snr = p_rx_info->snr;
+    lora_stub_mutex_unlock(s_mcast_mutex);
+
+    __log_info("group %d rx: fcnt %d, len %d", group, p_rx_info->dl_counter,
+        p_rx_info->len);
+    return group;
+}
+
+void lora_wan_mcast_stats(void)
+{
+    lora_wan_mcast_status_t* p_status;
+    int i;
+
+    for( i = 0; i < __LORA_WAN_MCAST_GROUPS; ++i ) {
+        p_status = &s_groups[i].status;
+        if( ! p_status->is_setup && ! p_status->rx_frames )
+            continue;
+        __log_output("mcast group %d: addr %08x, class %c, session %s, "
+            "rx %d frames %d bytes, last fcnt %d rssi %d snr %d\n", i,
+            p_status->addr, 'A' + p_status->class,
+            p_status->is_session ? "on" : "off",
+            p_status->rx_frames, p_status->rx_bytes, p_status->last_f_cnt,
+            p_status->last_rssi, p_status->last_snr);
+    }
+}
+
+/* --- end of file ---------------------------------------------------------- */
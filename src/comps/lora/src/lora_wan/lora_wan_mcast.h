@@ -0,0 +1,103 @@
+/** -------------------------------------------------------------------------- *
+ * Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ * @author  Ahmed Sabry (SG Wireless)
+ * 
+ * @brief   lora-wan multicast groups management sub-component header
+ * --------------------------------------------------------------------------- *
+ */
+#ifndef __LORA_WAN_MCAST_H__
+#define __LORA_WAN_MCAST_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --- includes ------------------------------------------------------------- */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "lora.h"
+#include "lora_sync_obj.h"
+#include "lora_mac_handler.h"
+
+/** -------------------------------------------------------------------------- *
+ * typedefs
+ * --------------------------------------------------------------------------- *
+ */
+
+/* the groups setup is executed by the lora-wan process as any mac request */
+typedef struct {
+    enum {
+        __MCAST_REQ_SETUP,
+        __MCAST_REQ_DELETE,
+    } type;
+    union {
+        lora_wan_mcast_setup_t* p_setup;
+        uint8_t group;
+    };
+    lora_error_t ret;
+    sync_obj_t sync_obj;
+} lora_wan_mcast_req_t;
+
+/** -------------------------------------------------------------------------- *
+ * APIs
+ * --------------------------------------------------------------------------- *
+ */
+
+void lora_wan_mcast_ctor(void);
+
+void lora_wan_mcast_dtor(void);
+
+/**
+ * @brief   the ioctl side of the setup and delete requests, they wait for
+ *          their execution by the lora-wan process
+ */
+lora_error_t lora_wan_mcast_setup(lora_wan_mcast_setup_t* p_setup);
+lora_error_t lora_wan_mcast_delete(uint8_t group);
+
+/**
+ * @brief   executes a setup or delete request in the lora-wan process context
+ */
+void lora_wan_mcast_process_request(lora_wan_mcast_req_t* p_req);
+
+lora_error_t lora_wan_mcast_get_status(lora_wan_mcast_status_t* p_status);
+
+/**
+ * @brief   called by the mac on every radio reception to keep the device
+ *          address of the last received frame
+ */
+void lw_mcast_on_radio_rx(uint8_t* payload, uint16_t size);
+
+/**
+ * @brief   accounts an accepted downlink to its multicast group
+ * @return  the multicast group of the downlink or -1 for a unicast one
+ */
+int8_t lora_wan_mcast_on_rx(lmh_rx_status_params_t* p_rx_info);
+
+void lora_wan_mcast_stats(void);
+
+/* --- end of file ---------------------------------------------------------- */
+#ifdef __cplusplus
+}
+#endif
+#endif /* __LORA_WAN_MCAST_H__ */
@@ -30,20 +30,74 @@
  * --------------------------------------------------------------------------- *
  */
 #include <stdint.h>
+#include <stddef.h>
+#include <string.h>
 #define __log_subsystem     lora
 #define __log_component     wan_nvm
 #include "log_lib.h"
 
 #include "LoRaMac.h"
+#include "utilities.h"
 #include "stub_nvm.h"
+#include "stub_system.h"
+#include "stub_timers.h"
 #include "lora_commission.h"
+#include "lora_nvm_journal.h"
 #include "lora_wan_nvm.h"
 
 /** -------------------------------------------------------------------------- *
  * Implementation
  * --------------------------------------------------------------------------- *
+ * The MAC contexts are stored as one journaled image (lora_nvm_journal.h), a
+ * change writes only the changed bytes as a small journal record instead of
+ * rewriting the whole changed groups.
+ *
+ * The groups changing on every uplink (the uplink frame counter of the crypto
+ * group, the mac group1 and region group1) are written behind by the commit
+ * timer, so a burst of frames costs one journal record and a change is not
+ * kept in ram for more than CONFIG_LORA_WAN_NVM_COMMIT_PERIOD_MS.
+ * Any other group change (join, keys, channels, ...) and any downlink frame
+ * counter change are committed immediately together with the pending ones.
+ * lora_nvm_flush() commits the pending changes before a power down.
+ *
+ * The uplinks of the last write-behind period are lost by a power cut, so the
+ * restore resumes the uplink frame counter CONFIG_LORA_WAN_NVM_FCNT_UP_GAP
+ * after the committed one and a frame counter is never sent twice.
+ * lora_nvm_flush() stores a clean marker with the flushed commit sequence, the
+ * restore of that same commit keeps the uplink frame counter as it is. The
+ * marker is cleared by the restore and by any context change after the flush.
  */
 static LoRaMacNvmData_t s_nvm;
+static uint8_t s_nvm_shadow[__lora_nvm_journal_shadow_size(sizeof(s_nvm))];
+static uint8_t s_nvm_slot_buf[CONFIG_LORA_WAN_NVM_JOURNAL_SLOT_SIZE];
+
+static lora_nvm_journal_t s_nvm_journal = {
+    .name       = "lw-mac",
+    .image      = (void*)&s_nvm,
+    .shadow     = s_nvm_shadow,
+    .size       = sizeof(s_nvm),
+    .slot_buf   = s_nvm_slot_buf,
+    .slot_size  = sizeof(s_nvm_slot_buf),
+    .slots      = CONFIG_LORA_WAN_NVM_JOURNAL_SLOTS
+};
+
+static void* s_nvm_mutex;
+static void* s_nvm_commit_timer;
+static bool  s_nvm_commit_pending;
+static bool  s_nvm_clean_marked;
+
+#define __nvm_clean_key     "lw-mac-clean"
+
+#define __nvm_write_behind_flags            \
+    ( LORAMAC_NVM_NOTIFY_FLAG_CRYPTO      | \
+      LORAMAC_NVM_NOTIFY_FLAG_MAC_GROUP1  | \
+      LORAMAC_NVM_NOTIFY_FLAG_REGION_GROUP1 )
+
+/* the downlink counters follow the uplink one in the frame counters list */
+#define __nvm_fcnt_down_offset                                          \
+    offsetof(LoRaMacNvmData_t, Crypto.FCntList.NFCntDown)
+#define __nvm_fcnt_down_length                                          \
+    ( sizeof(FCntList_t) - offsetof(FCntList_t, NFCntDown) )
 
 static bool s_is_initialized = false;
 
@@ -114,25 +168,153 @@ static lora_nvm_record_meta_info_t s_nvm_records_info[] = {
 #define __lora_records_number  \
     (sizeof(s_nvm_records_info)/sizeof(s_nvm_records_info[0]))
 
-bool lora_nvm_restore(void)
+static void nvm_commit(void)
 {
-    s_is_initialized = true;
-    bool is_restored = false;
+    lora_stub_mutex_lock(s_nvm_mutex);
+    lora_stub_timer_stop(s_nvm_commit_timer);
+    s_nvm_commit_pending = false;
+    lora_nvm_journal_commit(&s_nvm_journal);
+    lora_stub_mutex_unlock(s_nvm_mutex);
+}
+
+static void nvm_clean_mark_set(void)
+{
+    uint32_t seq = s_nvm_journal.seq;
+
+    if( s_nvm_clean_marked )
+        return;
+    lora_stub_nvm_store(__nvm_clean_key, &seq, sizeof(seq));
+    lora_stub_nvm_sync();
+    s_nvm_clean_marked = true;
+}
+
+static void nvm_clean_mark_clear(void)
+{
+    if( ! s_nvm_clean_marked )
+        return;
+    lora_stub_nvm_clear(__nvm_clean_key);
+    lora_stub_nvm_sync();
+    s_nvm_clean_marked = false;
+}
+
+/* checks if the restored commit is the one of the last flush */
+static bool nvm_clean_mark_check(void)
+{
+    uint32_t seq;
+
+    s_nvm_clean_marked = lora_stub_nvm_check(__nvm_clean_key);
+    if( ! s_nvm_clean_marked )
+        return false;
+    lora_stub_nvm_load(__nvm_clean_key, &seq, sizeof(seq));
+    return seq == s_nvm_journal.seq;
+}
+
+/* resumes the uplink frame counter after the ones lost by a power cut */
+static void nvm_fcnt_up_resume(void)
+{
+    LoRaMacCryptoNvmData_t* p_crypto = &s_nvm.Crypto;
+    uint16_t crc_len = sizeof(*p_crypto) - sizeof(p_crypto->Crc32);
+
+    // -- a crypto group with a wrong crc is rejected by the mac, keep it so
+    if( Crc32((void*)p_crypto, crc_len) != p_crypto->Crc32 ) {
+        return;
+    }
+
+    p_crypto->FCntList.FCntUp = lora_nvm_journal_counter_resume(
+        p_crypto->FCntList.FCntUp, CONFIG_LORA_WAN_NVM_FCNT_UP_GAP);
+    p_crypto->Crc32 = Crc32((void*)p_crypto, crc_len);
+
+    __log_info("lora nvm resume fcnt-up at %d", p_crypto->FCntList.FCntUp);
+
+    // -- committed before any uplink, a next cut does not go back before it
+    lora_nvm_journal_commit(&s_nvm_journal);
+}
+
+static void nvm_commit_timer_cb(void* arg)
+{
+    (void) arg;
+    nvm_commit();
+}
 
+/* loads the records of the per-group layout used before the journal */
+static bool nvm_legacy_load(void)
+{
     lora_nvm_record_meta_info_t * ptr = s_nvm_records_info;
     uint32_t records = __lora_records_number;
-    uint32_t found_records = 0;
     uint8_t* base = (void*)&s_nvm;
+
+    while( records -- ) {
+        if( ! lora_stub_nvm_check(ptr->nvm_key) ) {
+            return false;
+        }
+        ++ ptr;
+    }
+
+    ptr = s_nvm_records_info;
+    records = __lora_records_number;
+    while( records -- ) {
+        __log_info("-- load %s", ptr->nvm_key);
+        lora_stub_nvm_load(ptr->nvm_key, base + ptr->offset, ptr->length);
+        ++ ptr;
+    }
+    return true;
+}
+
+static void nvm_legacy_clear(void)
+{
+    lora_nvm_record_meta_info_t * ptr = s_nvm_records_info;
+    uint32_t records = __lora_records_number;
     while( records -- ) {
         if( lora_stub_nvm_check(ptr->nvm_key) ) {
-            __log_info("-- load %s", ptr->nvm_key);
-            ++ found_records;
-            lora_stub_nvm_load(ptr->nvm_key, base + ptr->offset, ptr->length);
+            __log_info("-- clear %s", ptr->nvm_key);
+            lora_stub_nvm_clear(ptr->nvm_key);
         }
         ++ ptr;
     }
+    lora_stub_nvm_sync();
+}
+
+bool lora_nvm_restore(void)
+{
+    bool is_restored = false;
+    bool is_found;
+    bool is_clean;
+    uint8_t* base = (void*)&s_nvm;
+
+    if( s_nvm_mutex == NULL ) {
+        s_nvm_mutex = lora_stub_mutex_new();
+    }
+    if( s_nvm_commit_timer == NULL ) {
+        s_nvm_commit_timer = lora_stub_timer_init("lw-nvm-commit",
+            nvm_commit_timer_cb, NULL);
+    }
+
+    lora_stub_mutex_lock(s_nvm_mutex);
+
+    s_is_initialized = true;
+    lora_nvm_journal_init(&s_nvm_journal);
+
+    is_found = lora_nvm_journal_restore(&s_nvm_journal);
+    if( ! is_found && nvm_legacy_load() ) {
+        // -- migrate the old per-group records into the journal
+        __log_info("lora nvm migrate to journal");
+        lora_nvm_journal_compact(&s_nvm_journal);
+        nvm_legacy_clear();
+        is_found = true;
+    }
+
+    // -- the marker is valid for this restore only, the uplinks sent after
+    //    it are covered by a later flush
+    is_clean = nvm_clean_mark_check() && is_found;
+    nvm_clean_mark_clear();
+
+    if( is_found ) {
+        if( is_clean ) {
+            __log_info("lora nvm clean shutdown, fcnt-up kept");
+        } else {
+            nvm_fcnt_up_resume();
+        }
 
-    if(found_records == __lora_records_number) {
         MibRequestConfirm_t mib;
         mib.Type = MIB_NVM_CTXS;
         mib.Param.Contexts = (void*)base;
@@ -144,32 +326,60 @@ bool lora_nvm_restore(void)
         }
     } else {
         memset(base, 0, sizeof(s_nvm));
-        ptr = s_nvm_records_info;
-        records = __lora_records_number;
-        while( records -- ) {
-            lora_stub_nvm_store(ptr->nvm_key, base + ptr->offset, ptr->length);
-            ++ ptr;
-        }
-
-        lora_stub_nvm_sync();
+        lora_nvm_journal_compact(&s_nvm_journal);
 
         __log_info("lora nvm init");
     }
+
+    lora_stub_mutex_unlock(s_nvm_mutex);
     return is_restored;
 }
 
 void lora_nvm_clear_all(void)
 {
-    lora_nvm_record_meta_info_t * ptr = s_nvm_records_info;
-    uint32_t records = __lora_records_number;
-    while( records -- ) {
-        __log_info("-- clear %s", ptr->nvm_key);
-        lora_stub_nvm_clear(ptr->nvm_key);
-        ++ ptr;
+    if( s_nvm_mutex ) {
+        lora_stub_mutex_lock(s_nvm_mutex);
+        lora_stub_timer_stop(s_nvm_commit_timer);
+        s_nvm_commit_pending = false;
     }
+
+    lora_nvm_journal_clear(&s_nvm_journal);
+    nvm_legacy_clear();
+    s_nvm_clean_marked = lora_stub_nvm_check(__nvm_clean_key);
+    nvm_clean_mark_clear();
     memset(&s_nvm, 0, sizeof(s_nvm));
     s_is_initialized = false;
-    lora_stub_nvm_sync();
+
+    if( s_nvm_mutex ) {
+        lora_stub_mutex_unlock(s_nvm_mutex);
+    }
+}
+
+void lora_nvm_flush(void)
+{
+    // -- nothing is restored yet, so nothing to commit
+    if( ! s_is_initialized )
+        return;
+
+    lora_stub_mutex_lock(s_nvm_mutex);
+    lora_stub_timer_stop(s_nvm_commit_timer);
+    s_nvm_commit_pending = false;
+    lora_nvm_journal_commit(&s_nvm_journal);
+    nvm_clean_mark_set();
+    lora_stub_mutex_unlock(s_nvm_mutex);
+}
+
+void lora_nvm_stats(void)
+{
+    lora_nvm_journal_stats_t * p = &s_nvm_journal.stats;
+
+    __log_output("nvm journal: commits "__yellow__"%d"__default__
+        ", records "__yellow__"%d"__default__
+        ", snapshots "__yellow__"%d"__default__
+        ", bytes "__yellow__"%d"__default__
+        ", replayed "__yellow__"%d"__default__"\n",
+        p->commits, p->slot_writes, p->snapshots, p->bytes_written,
+        p->replayed);
 }
 
 void lora_nvm_handle_data_change(uint16_t flags)
@@ -178,10 +388,6 @@ void lora_nvm_handle_data_change(uint16_t flags)
 
     __check_init();
 
-    if(flags == LORAMAC_NVM_NOTIFY_FLAG_CRYPTO) {
-        return;
-    }
-
     MibRequestConfirm_t mib;
 
     mib.Type = MIB_NVM_CTXS;
@@ -194,17 +400,42 @@ void lora_nvm_handle_data_change(uint16_t flags)
     uint32_t records = __lora_records_number;
     uint16_t offset;
     uint16_t length;
+    bool is_fcnt_down_change = false;
+
+    lora_stub_mutex_lock(s_nvm_mutex);
+
+    // -- the context is no more the flushed one
+    nvm_clean_mark_clear();
+
+    // -- an accepted downlink counter is never written behind, a replayed
+    //    downlink frame must not be accepted again after a power cut
+    if( flags & LORAMAC_NVM_NOTIFY_FLAG_CRYPTO ) {
+        is_fcnt_down_change = memcmp(p_dst_base + __nvm_fcnt_down_offset,
+            p_src_base + __nvm_fcnt_down_offset, __nvm_fcnt_down_length) != 0;
+    }
+
     while( records -- ) {
         if(ptr->flag & flags) {
             __log_debug("change in %s", ptr->nvm_key);
             offset = ptr->offset;
             length = ptr->length;
             memcpy(p_dst_base + offset, p_src_base + offset, length);
-            lora_stub_nvm_store(ptr->nvm_key, p_dst_base + offset, length);
         }
         ++ ptr;
     }
-    lora_stub_nvm_sync();
+
+    if( (flags & ~__nvm_write_behind_flags) || is_fcnt_down_change ) {
+        lora_stub_timer_stop(s_nvm_commit_timer);
+        s_nvm_commit_pending = false;
+        lora_nvm_journal_commit(&s_nvm_journal);
+    } else if( ! s_nvm_commit_pending &&
+               lora_nvm_journal_is_dirty(&s_nvm_journal) ) {
+        // -- a running timer is not restarted to bound the write-behind
+        s_nvm_commit_pending = true;
+        lora_stub_timer_start(s_nvm_commit_timer,
+            CONFIG_LORA_WAN_NVM_COMMIT_PERIOD_MS);
+    }
+    lora_stub_mutex_unlock(s_nvm_mutex);
 }
 
 LoRaMacNvmData_t* lora_nvm_get_ref(void)
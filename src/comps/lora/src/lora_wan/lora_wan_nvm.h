@@ -54,6 +54,14 @@ LoRaMacNvmData_t* lora_nvm_get_ref(void);
 
 void lora_nvm_clear_all(void);
 
+/**
+ * @brief   commits the changes still pending in the write-behind window, to be
+ *          called before a power down or a deep sleep
+ */
+void lora_nvm_flush(void);
+
+void lora_nvm_stats(void);
+
 void lora_nvm_get_join_accept_delays(uint32_t * p_rx_1, uint32_t * p_rx_2);
 void lora_nvm_get_rx_delays(uint32_t * p_rx_1, uint32_t * p_rx_2);
 
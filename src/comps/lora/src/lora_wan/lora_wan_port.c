@@ -121,138 +121,120 @@ static void buf_chain_sync_signal(void* obj)
     lora_stub_sem_signal(obj);
 }
 
-static void port_restart_tx_timeout_timer(lora_wan_port_t* p_port);
+/** -------------------------------------------------------------------------- *
+ * tx messages expiry
+ * --------------------------------------------------------------------------- *
+ * one timer serves the deadlines of all the ports. It is armed on the earliest
+ * deadline of the queued messages, which is kept up to date on every queued
+ * message with a timeout. When it expires, the expired messages of all ports
+ * are dropped at once, so their buffers space is freed even if the stack is
+ * not picking up messages, and the timer is re-armed on the next deadline.
+ * The timer is created with the first opened port and lives until the
+ * lora_wan_port_dtor(), so a late expiry never finds it deleted.
+ */
+static struct {
+    void*       timer;
+    bool        is_armed;
+    uint32_t    next_expiry;    // -- the deadline the timer is armed on
+} s_expiry;
 
-static void port_tx_timeout_timer_callback(void* data)
+static void port_expiry_process(void)
 {
-    lora_wan_port_t * p_port = data;
-    __log_timer_expire("tx-timeout-timer");
-    __log_debug("port:%p , num:%d", p_port, p_port->port_num);
-
-    uint32_t ts = lora_stub_get_timestamp_ms();
-
+    uint32_t ts;
+    uint32_t next_expiry;
+    bool is_found;
+    lora_wan_port_t* p_port;
     buf_header_t * p_buf_header;
     lora_wan_port_tx_msg_t * p_tx_msg;
+    lora_wan_port_tx_msg_t tx_msg;
 
-    bool is_broken;
     do {
         lora_buf_mem_mgr_lock();
-        is_broken = false;
-        __adt_list_foreach(p_port->tx_buf_chain.list, p_buf_header)
+        ts = lora_stub_get_timestamp_ms();
+        is_found = false;
+        next_expiry = (uint32_t)-1;
         {
-            p_tx_msg = (lora_wan_port_tx_msg_t*) p_buf_header->buf;
-
-            __log_debug("-- compare curr_ts:%d , msg-ts:%d", ts,
-                p_tx_msg->expire_timestamp);
-            if(p_tx_msg->has_timeout && p_tx_msg->expire_timestamp <= ts) {
-                // -- clear this message from the chained buffer
-                bool is_sync = p_tx_msg->sync;
-                sync_obj_t sync_obj = p_tx_msg->sync_obj;
-
-                __log_info("found expired message -- clear it");
-                lora_wan_port_ind_msg_t ind_msg = {
-                    .type = __IND_TX_TIMEOUT,
-                    .ind_params.tx = {
-                        .msg_app_id = p_tx_msg->msg_app_id,
-                        .msg_seq_num = p_tx_msg->msg_seq_num,
+            __adt_list_foreach(ports_list, p_port) {
+                __adt_list_foreach(p_port->tx_buf_chain.list, p_buf_header) {
+                    p_tx_msg = (lora_wan_port_tx_msg_t*) p_buf_header->buf;
+                    if( ! p_tx_msg->has_timeout )
+                        continue;
+                    if( p_tx_msg->expire_timestamp <= ts ) {
+                        is_found = true;
+                        break;
                     }
-                };
-
-                __log_info("PORT-QUEUE::expire() msg_id: %d, expire_at: %d",
-                    p_tx_msg->msg_app_id,
-                    p_tx_msg->expire_timestamp);
-
-                buf_mem_chain_clear_buf(&p_port->tx_buf_chain, p_buf_header);
-
-                lora_buf_mem_mgr_unlock();
-
-                lora_wan_port_indication(p_port->port_num, &ind_msg);
-                if(is_sync) {
-                    sync_obj_release(sync_obj);
+                    if( p_tx_msg->expire_timestamp < next_expiry )
+                        next_expiry = p_tx_msg->expire_timestamp;
                 }
-
-                is_broken = true;
-                break;
+                if( is_found )
+                    break;
             }
         }
-    } while ( is_broken );
-
-    if( ! is_broken ) {
-        lora_buf_mem_mgr_unlock();
-    }
-
-    port_restart_tx_timeout_timer(p_port);
-}
-static void port_restart_tx_timeout_timer(lora_wan_port_t* p_port)
-{
-    uint32_t ts = lora_stub_get_timestamp_ms();
-    uint32_t min_period = (uint32_t)-1;
-    uint32_t period;
 
-    __log_info("stop tx timeout timer");
-    lora_stub_timer_stop(p_port->tx_timeout_timer);
-
-    buf_header_t * p_buf_header;
-    lora_wan_port_tx_msg_t * p_tx_msg;
-
-    __log_info("search for earliest deadline msg");
-    bool is_broken;
-    do {
-        lora_buf_mem_mgr_lock();
-        is_broken = false;
-        __adt_list_foreach(p_port->tx_buf_chain.list, p_buf_header)
-        {
-            p_tx_msg = (lora_wan_port_tx_msg_t*) p_buf_header->buf;
-
-            if(p_tx_msg->has_timeout) {
-                if(p_tx_msg->expire_timestamp > ts)
-                {
-                    period = p_tx_msg->expire_timestamp - ts;
-                    if( period < min_period ) {
-                        min_period = period;
-                    }
-                }
-                else
-                {
-                    bool is_sync = p_tx_msg->sync;
-                    sync_obj_t sync_obj = p_tx_msg->sync_obj;
-
-                    // -- clear this message from the chained buffer
-                    __log_info("found expired message -- clear it");
-                    lora_wan_port_ind_msg_t ind_msg = {
-                        .type = __IND_TX_TIMEOUT,
-                        .ind_params.tx = {
-                            .msg_app_id = p_tx_msg->msg_app_id,
-                            .msg_seq_num = p_tx_msg->msg_seq_num
-                        }
-                    };
-                    buf_mem_chain_clear_buf(&p_port->tx_buf_chain,
-                        p_buf_header);
-                    lora_buf_mem_mgr_unlock();
-
-                    lora_wan_port_indication(p_port->port_num, &ind_msg);
-                    if(is_sync) {
-                        sync_obj_release(sync_obj);
-                    }
-                    is_broken = true;
-                    break;
+        if( is_found ) {
+            // -- clear this message from the chained buffer
+            tx_msg = *p_tx_msg;
+            buf_mem_chain_clear_buf(&p_port->tx_buf_chain, p_buf_header);
+            ++ p_port->tx_stats.expired;
+            lora_buf_mem_mgr_unlock();
+
+            __log_info("PORT-QUEUE::expire() port: %d, msg_id: %d, "
+                "expire_at: %d", tx_msg.port_num, tx_msg.msg_app_id,
+                tx_msg.expire_timestamp);
+
+            lora_wan_port_ind_msg_t ind_msg = {
+                .type = __IND_TX_TIMEOUT,
+                .ind_params.tx = {
+                    .msg_app_id = tx_msg.msg_app_id,
+                    .msg_seq_num = tx_msg.msg_seq_num,
                 }
+            };
+            lora_wan_port_indication(tx_msg.port_num, &ind_msg);
+            if(tx_msg.sync) {
+                sync_obj_release(tx_msg.sync_obj);
             }
         }
-    } while (is_broken);
+    } while( is_found );
 
-    if( ! is_broken)  {
+    if( s_expiry.timer == NULL ) {
+        // -- the ports layer is destructed
         lora_buf_mem_mgr_unlock();
+        return;
     }
-
-    if( min_period < (uint32_t)-1 ) {
-        __log_info("restarting the tx timeout timer period: %d", min_period);
-        lora_stub_timer_start(p_port->tx_timeout_timer, min_period);
+    s_expiry.is_armed = next_expiry != (uint32_t)-1;
+    s_expiry.next_expiry = next_expiry;
+    lora_buf_mem_mgr_unlock();
+
+    lora_stub_timer_stop(s_expiry.timer);
+    if( next_expiry != (uint32_t)-1 ) {
+        __log_info("restarting the tx expiry timer period: %d",
+            next_expiry - ts);
+        lora_stub_timer_start(s_expiry.timer, next_expiry - ts);
     } else {
         __log_info("no message with timeout");
     }
 }
 
+static void port_expiry_timer_callback(void* data)
+{
+    __log_timer_expire("tx-expiry-timer");
+    port_expiry_process();
+}
+
+/* to be called after queuing a message with a timeout */
+static void port_expiry_update(uint32_t expire_timestamp)
+{
+    bool is_earlier;
+
+    lora_buf_mem_mgr_lock();
+    is_earlier = ! s_expiry.is_armed ||
+        expire_timestamp < s_expiry.next_expiry;
+    lora_buf_mem_mgr_unlock();
+
+    if( is_earlier ) {
+        port_expiry_process();
+    }
+}
 
 static void port_rx_timeout_timer_callback(void* data)
 {
@@ -303,8 +285,12 @@ lora_port_error_t lora_wan_port_open(lora_wan_port_t* p_port, int num)
     buf_mem_chain_connect(&__buf_chain_mgr_id(_lora_wan_buf_mem_rx),
         &p_port->ind_buf_chain);
 
-    p_port->tx_timeout_timer = lora_stub_timer_init("port-tx-timeout",
-        port_tx_timeout_timer_callback, p_port);
+    p_port->tx_weight = 1;
+
+    if( s_expiry.timer == NULL ) {
+        s_expiry.timer = lora_stub_timer_init("port-tx-expiry",
+            port_expiry_timer_callback, NULL);
+    }
     p_port->rx_timeout_timer = lora_stub_timer_init("port-rx-timeout",
         port_rx_timeout_timer_callback, p_port);
 
@@ -322,7 +308,6 @@ lora_port_error_t lora_wan_port_close(lora_wan_port_t* p_port)
         __bitarray_clr(open_ports, idx);
     }
     __log_info("~dtor() --> port %d", p_port->port_num);
-    lora_stub_timer_delete(p_port->tx_timeout_timer);
     lora_stub_timer_delete(p_port->rx_timeout_timer);
     buf_mem_chain_disconnect(&__buf_chain_mgr_id(_lora_wan_buf_mem_rx),
         &p_port->rx_buf_chain);
@@ -358,6 +343,24 @@ lora_port_error_t lora_port_close_all(void)
     return __PORT_OK;
 }
 
+void lora_wan_port_dtor(void)
+{
+    void* timer;
+
+    lora_port_close_all();
+
+    lora_buf_mem_mgr_lock();
+    timer = s_expiry.timer;
+    s_expiry.timer = NULL;
+    s_expiry.is_armed = false;
+    lora_buf_mem_mgr_unlock();
+
+    if( timer ) {
+        lora_stub_timer_stop(timer);
+        lora_stub_timer_delete(timer);
+    }
+}
+
 lora_port_error_t lora_wan_port_tx(
     lora_wan_port_t*    p_port,
     lora_tx_params_t*   p_tx_params
@@ -388,6 +391,7 @@ lora_port_error_t lora_wan_port_tx(
     msg_header.len = p_tx_params->len;
     msg_header.port_num = p_port->port_num;
     msg_header.retries = p_tx_params->retries;
+    msg_header.queue_timestamp = lora_stub_get_timestamp_ms();
 
     if(p_tx_params->sync) {
         msg_header.sync = 1;
@@ -420,7 +424,7 @@ lora_port_error_t lora_wan_port_tx(
 
     if(err == __BUF_CHAIN_OK) {
         if(p_tx_params->timeout) {
-            port_restart_tx_timeout_timer(p_port);
+            port_expiry_update(msg_header.expire_timestamp);
         }
         if(p_tx_params->sync) {
             sync_obj_wait(msg_header.sync_obj);
@@ -488,24 +492,230 @@ bool lora_wan_is_pending_tx(void)
     return false;
 }
 
+/* must be called in the buffers memory critical section */
+static void port_take_tx_msg(
+    lora_wan_port_t*    p_port,
+    buf_header_t*       p_buf_header,
+    lora_wan_port_tx_msg_t * p_msg_header,
+    uint8_t*            payload,
+    uint32_t            ts
+    )
+{
+    lora_wan_port_tx_msg_t * p_tx_msg =
+        (lora_wan_port_tx_msg_t*) p_buf_header->buf;
+    uint32_t delay = ts - p_tx_msg->queue_timestamp;
+
+    *p_msg_header = *p_tx_msg;
+    memcpy(payload, p_buf_header->buf + sizeof(*p_tx_msg), p_tx_msg->len);
+    buf_mem_chain_clear_buf(&p_port->tx_buf_chain, p_buf_header);
+
+    ++ p_port->tx_stats.sent;
+    p_port->tx_stats.queue_delay_sum += delay;
+    if( delay > p_port->tx_stats.queue_delay_max )
+        p_port->tx_stats.queue_delay_max = delay;
+}
+
 lora_port_error_t lora_wan_get_tx_data(
     uint8_t*    buf,
     uint8_t*    p_len
     )
 {
     lora_wan_port_t* p_port;
-    buf_chain_error_t err;
-    uint32_t len;
+    lora_wan_port_t* p_sel_port = NULL;
+    buf_header_t * p_buf_header;
+    buf_header_t * p_sel_buf = NULL;
+    lora_wan_port_tx_msg_t * p_tx_msg;
+    uint32_t sel_expiry = (uint32_t)-1;
+    int32_t total_weight = 0;
+    int top_priority = -1;
+    uint32_t ts;
+
+    lora_buf_mem_mgr_lock();
+    ts = lora_stub_get_timestamp_ms();
+
+    // -- only the ports of the highest priority with queued msgs are served
+    {
+        __adt_list_foreach(ports_list, p_port) {
+            if( p_port->tx_buf_chain.list &&
+                p_port->tx_priority > top_priority )
+                top_priority = p_port->tx_priority;
+        }
+    }
+    if( top_priority < 0 ) {
+        lora_buf_mem_mgr_unlock();
+        return __PORT_NO_TX_DATA;
+    }
+
+    // -- earliest deadline first among their msgs with timeout
+    {
+        __adt_list_foreach(ports_list, p_port) {
+            if( p_port->tx_priority != top_priority )
+                continue;
+            __adt_list_foreach(p_port->tx_buf_chain.list, p_buf_header) {
+                p_tx_msg = (lora_wan_port_tx_msg_t*) p_buf_header->buf;
+                if( p_tx_msg->has_timeout &&
+                    p_tx_msg->expire_timestamp < sel_expiry ) {
+                    sel_expiry = p_tx_msg->expire_timestamp;
+                    p_sel_port = p_port;
+                    p_sel_buf = p_buf_header;
+                }
+            }
+        }
+    }
+
+    // -- otherwise, smooth weighted round-robin over their head msgs
+    if( p_sel_port == NULL ) {
+        __adt_list_foreach(ports_list, p_port) {
+            if( p_port->tx_priority != top_priority ||
+                p_port->tx_buf_chain.list == NULL )
+                continue;
+            p_port->tx_credit += p_port->tx_weight;
+            total_weight += p_port->tx_weight;
+            if( p_sel_port == NULL ||
+                p_port->tx_credit > p_sel_port->tx_credit )
+                p_sel_port = p_port;
+        }
+        p_sel_port->tx_credit -= total_weight;
+        p_sel_buf = p_sel_port->tx_buf_chain.list;
+    }
+
+    p_tx_msg = (lora_wan_port_tx_msg_t*) buf;
+    port_take_tx_msg(p_sel_port, p_sel_buf, p_tx_msg, buf + sizeof(*p_tx_msg),
+        ts);
+    lora_buf_mem_mgr_unlock();
+
+    *p_len = sizeof(*p_tx_msg) + p_tx_msg->len;
+
+    __log_info("PORT-TX::schedule() port: %d, priority: %d, msg_id: %d, "
+        "by: %s", p_tx_msg->port_num, top_priority, p_tx_msg->msg_app_id,
+        sel_expiry != (uint32_t)-1 ? "deadline" : "weight");
+    return __PORT_OK;
+}
+
+lora_port_error_t lora_wan_get_tx_aggr_data(
+    int         port_num,
+    bool        confirm,
+    uint8_t     max_len,
+    lora_wan_port_tx_msg_t * p_msg_header,
+    uint8_t*    payload
+    )
+{
+    lora_wan_port_t* p_port;
+    buf_header_t * p_buf_header;
+    lora_wan_port_tx_msg_t * p_tx_msg;
+
     __adt_list_foreach(ports_list, p_port) {
-        err = buf_mem_chain_read(&p_port->tx_buf_chain, buf, &len, false);
-        if( err == __BUF_CHAIN_OK ) {
-            *p_len = len;
-            return __PORT_OK;
+        if( p_port->port_num != port_num )
+            continue;
+        if( ! p_port->tx_aggregate )
+            return __PORT_NO_TX_DATA;
+
+        /* the head message is checked and taken in the same critical section
+           so that the tx timeout timer can not clear it in between */
+        lora_buf_mem_mgr_lock();
+        p_buf_header = p_port->tx_buf_chain.list;
+        if( p_buf_header == NULL ) {
+            lora_buf_mem_mgr_unlock();
+            return __PORT_NO_TX_DATA;
+        }
+        p_tx_msg = (lora_wan_port_tx_msg_t*) p_buf_header->buf;
+        if( p_tx_msg->confirm != confirm || p_tx_msg->len > max_len ) {
+            lora_buf_mem_mgr_unlock();
+            return __PORT_NO_TX_DATA;
         }
+        port_take_tx_msg(p_port, p_buf_header, p_msg_header, payload,
+            lora_stub_get_timestamp_ms());
+        lora_buf_mem_mgr_unlock();
+
+        __log_info("PORT-TX::aggregate() msg_id: %d, len: %d",
+            p_msg_header->msg_app_id, p_msg_header->len);
+        return __PORT_OK;
     }
     return __PORT_NO_TX_DATA;
 }
 
+lora_port_error_t lora_wan_port_set_aggregation(
+    lora_wan_port_t*    p_port,
+    bool                enable
+    )
+{
+    int idx = p_port->port_num - __min_port;
+    __access_lock();
+    if( __bitarray_get(open_ports, idx) == 0 )
+    {
+        __log_error("aggregation set on closed port : %d", p_port->port_num);
+        __access_unlock();
+        return __PORT_NOT_OPENED;
+    }
+    __log_info("port %d tx aggregation -> %s", p_port->port_num,
+        g_on_off[enable]);
+    p_port->tx_aggregate = enable;
+    __access_unlock();
+    return __PORT_OK;
+}
+
+bool lora_wan_port_is_aggregated(int port_num)
+{
+    lora_wan_port_t* p_port;
+
+    __adt_list_foreach(ports_list, p_port) {
+        if( p_port->port_num == port_num )
+            return p_port->tx_aggregate;
+    }
+    return false;
+}
+
+lora_port_error_t lora_wan_port_set_sched(
+    lora_wan_port_t*    p_port,
+    uint8_t             priority,
+    uint8_t             weight
+    )
+{
+    int idx = p_port->port_num - __min_port;
+    __access_lock();
+    if( __bitarray_get(open_ports, idx) == 0 )
+    {
+        __log_error("scheduling set on closed port : %d", p_port->port_num);
+        __access_unlock();
+        return __PORT_NOT_OPENED;
+    }
+    __log_info("port %d tx scheduling -> priority: %d, weight: %d",
+        p_port->port_num, priority, weight);
+    lora_buf_mem_mgr_lock();
+    p_port->tx_priority = priority;
+    p_port->tx_weight = weight ? weight : 1;
+    p_port->tx_credit = 0;
+    lora_buf_mem_mgr_unlock();
+    __access_unlock();
+    return __PORT_OK;
+}
+
+void lora_wan_port_sched_stats(void)
+{
+    lora_wan_port_t* p_port;
+    lora_wan_port_tx_stats_t stats;
+
+    __access_lock();
+    if( ports_list == NULL ) {
+        __access_unlock();
+        return;
+    }
+
+    __log_output("%-6s %4s %6s %8s %10s %10s %8s %8s\n", "port", "prio",
+        "weight", "sent", "avg delay", "max delay", "expired", "missed");
+    __adt_list_foreach(ports_list, p_port) {
+        lora_buf_mem_mgr_lock();
+        stats = p_port->tx_stats;
+        lora_buf_mem_mgr_unlock();
+        __log_output("%-6d %4d %6d %8d %10d %10d %8d %8d\n",
+            p_port->port_num, p_port->tx_priority, p_port->tx_weight,
+            stats.sent, stats.sent ? stats.queue_delay_sum / stats.sent : 0,
+            stats.queue_delay_max, stats.expired, stats.deadline_miss);
+    }
+    __access_unlock();
+    __log_output("\n");
+}
+
 lora_port_error_t lora_wan_port_rx_indication(
     int         port_num,
     lora_wan_port_ind_msg_t * p_ind_msg,
@@ -567,6 +777,8 @@ lora_port_error_t lora_wan_port_indication(
     buf_chain_error_t err;
     __adt_list_foreach(ports_list, p_port) {
         if( p_port->port_num == port_num ) {
+            if( p_ind_msg->type == __IND_TX_TIMEOUT )
+                ++ p_port->tx_stats.deadline_miss;
             __access_unlock();
             err = buf_mem_chain_write(&p_port->ind_buf_chain, 
                 (void*)p_ind_msg, sizeof(lora_wan_port_ind_msg_t), true);
@@ -641,6 +853,8 @@ lora_port_error_t lora_wan_port_get_ind_params(
                 p_ind_param->rx.rssi = ind_msg.ind_params.rx.rssi;
                 p_ind_param->rx.snr = ind_msg.ind_params.rx.snr;
                 p_ind_param->rx.data_rate = ind_msg.ind_params.rx.data_rate;
+                p_ind_param->rx.mcast_group =
+                    ind_msg.ind_params.rx.mcast_group;
                 return __PORT_OK;
             }
         }
@@ -50,6 +50,14 @@ extern "C" {
  * --------------------------------------------------------------------------- *
  */
 
+typedef struct {
+    uint32_t    sent;           // -- msgs picked up for uplink
+    uint32_t    queue_delay_sum;// -- msec spent in the queue by the sent msgs
+    uint32_t    queue_delay_max;// -- msec
+    uint32_t    expired;        // -- msgs dropped from the queue on expiry
+    uint32_t    deadline_miss;  // -- msgs indicated with tx timeout
+} lora_wan_port_tx_stats_t;
+
 typedef struct {
     adt_list_t  list_links;
 
@@ -61,7 +69,13 @@ typedef struct {
 
     // -- tx controls
     buf_chain_t tx_buf_chain;
-    void*       tx_timeout_timer;
+    bool        tx_aggregate;   // -- coalesce the queued messages in a frame
+
+    // -- tx scheduling
+    uint8_t     tx_priority;    // -- the higher priority ports served first
+    uint8_t     tx_weight;      // -- share among the same priority ports
+    int32_t     tx_credit;      // -- weighted round-robin credit
+    lora_wan_port_tx_stats_t tx_stats;
 
     // -- rx controls
     buf_chain_t rx_buf_chain;
@@ -83,6 +97,7 @@ typedef struct {
     uint32_t    sync        : 1;
     uint32_t    confirm     : 1;
     uint32_t    expire_timestamp;
+    uint32_t    queue_timestamp;
     sync_obj_t  sync_obj;
     uint32_t    msg_seq_num;
     uint32_t    msg_app_id;
@@ -112,6 +127,7 @@ typedef struct {
             int8_t      rssi;
             int8_t      snr;
             int8_t      data_rate;
+            int8_t      mcast_group;
         } rx;
     } ind_params;
 } lora_wan_port_ind_msg_t;
@@ -146,6 +162,9 @@ lora_port_error_t lora_wan_port_close(lora_wan_port_t* p_port);
 
 lora_port_error_t lora_port_close_all(void);
 
+/* closes all the ports and deletes the tx expiry timer */
+void lora_wan_port_dtor(void);
+
 lora_port_error_t lora_wan_port_tx(
     lora_wan_port_t*    p_port,
     lora_tx_params_t*   p_tx_params
@@ -156,11 +175,51 @@ lora_port_error_t lora_wan_port_rx(
     lora_rx_params_t*   p_rx_params
     );
 
+/**
+ * @brief   takes the next message to send out of the ports queues. The ports
+ *          of the highest priority that have queued messages are served first,
+ *          among them the message of the earliest deadline is taken. If none
+ *          of them has a deadline, the head message of one of these ports is
+ *          taken in a weighted round-robin manner
+ */
 lora_port_error_t lora_wan_get_tx_data(
     uint8_t*    buf,
     uint8_t*    p_len
     );
 
+/**
+ * @brief   fetches the next queued message of the given port to be coalesced
+ *          into the uplink frame in processing. The message is fetched only if
+ *          the port is in aggregation mode, and the message has the same
+ *          confirm type and its length does not exceed \a max_len
+ * @return  __PORT_NO_TX_DATA if no message can be coalesced
+ */
+lora_port_error_t lora_wan_get_tx_aggr_data(
+    int         port_num,
+    bool        confirm,
+    uint8_t     max_len,
+    lora_wan_port_tx_msg_t * p_msg_header,
+    uint8_t*    payload
+    );
+
+lora_port_error_t lora_wan_port_set_aggregation(
+    lora_wan_port_t*    p_port,
+    bool                enable
+    );
+
+bool lora_wan_port_is_aggregated(int port_num);
+
+lora_port_error_t lora_wan_port_set_sched(
+    lora_wan_port_t*    p_port,
+    uint8_t             priority,
+    uint8_t             weight
+    );
+
+/**
+ * @brief   displays the scheduling statistics of the opened ports
+ */
+void lora_wan_port_sched_stats(void);
+
 bool lora_wan_is_pending_tx(void);
 
 lora_port_error_t lora_wan_port_rx_indication(
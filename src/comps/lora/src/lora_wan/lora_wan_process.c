@@ -30,6 +30,7 @@
  * --------------------------------------------------------------------------- *
  */
 #include <stdint.h>
+#include <string.h>
 
 #define __log_subsystem     lora
 #define __log_component     wan_process
@@ -49,6 +50,8 @@
 #include "lora_wan_state_machine.h"
 #include "lora_proto_compliance.h"
 #include "lora_commission.h"
+#include "lora_wan_mcast.h"
+#include "lora_wan_link.h"
 
 /** -------------------------------------------------------------------------- *
  * all declarations
@@ -73,6 +76,8 @@ static void trx_process_timeout(void);
 static void trx_cancel_ongoing_processing(void);
 
 static void trx_post_msg_ind(int ind);
+static void trx_post_ind(int ind, lora_wan_port_tx_msg_t * p_header);
+static void trx_aggregate_tx_msgs(void);
 
 /** -------------------------------------------------------------------------- *
  * state-machine definition
@@ -656,6 +661,16 @@ static volatile bool is_msg_retry = false;
 static lora_wan_port_tx_msg_t * p_msg_header = (void*)&tx_msg;
 static uint8_t tx_msg_payload_len;
 
+/* the headers of the messages coalesced in the frame in processing, the first
+   one is the picked up message itself. Without aggregation it is the only one */
+#ifdef CONFIG_LORA_WAN_TX_AGGREGATION_MAX_MSGS
+#define __tx_aggr_max_msgs  CONFIG_LORA_WAN_TX_AGGREGATION_MAX_MSGS
+#else
+#define __tx_aggr_max_msgs  (16)
+#endif
+static lora_wan_port_tx_msg_t tx_aggr_msgs[__tx_aggr_max_msgs];
+static uint8_t tx_aggr_count;
+
 #define __log_tx_msg()                                                      \
     __log_info("ul-msg[port:%d seq:%d , app_id:%d, len:%d] "                \
         "sync: %s, confirm:%s, timeout:%s", p_msg_header->port_num,         \
@@ -697,8 +712,13 @@ static void trx_start_processing(void)
 
             tx_msg_payload_len = tx_msg.msg_header.len;
 
+            trx_aggregate_tx_msgs();
+
             __log_tx_msg();
 
+            lora_wan_link_tx_begin(p_msg_header->port_num,
+                p_msg_header->confirm);
+
             if(tx_msg.msg_header.has_timeout)
             {
                 uint32_t ts = lora_stub_get_timestamp_ms();
@@ -745,6 +765,79 @@ static void trx_start_processing(void)
     }
 }
 
+static void trx_aggregate_tx_msgs(void)
+{
+    lora_wan_port_tx_msg_t * p_header;
+    uint8_t max_len;
+    uint32_t ts;
+
+    tx_aggr_msgs[0] = tx_msg.msg_header;
+    tx_aggr_count = 1;
+
+    if( ! lora_wan_port_is_aggregated(p_msg_header->port_num) )
+        return;
+
+    ts = lora_stub_get_timestamp_ms();
+    if( p_msg_header->has_timeout && p_msg_header->expire_timestamp <= ts )
+        return; /* it will be dropped by the caller */
+
+    max_len = lmh_get_tx_payload_size();
+
+    /* a message filling the max payload has no room for the length byte, it
+       is sent alone as it is */
+    if( tx_msg_payload_len + 1 > max_len )
+    {
+        __log_info("-- msg fills the max payload (%d), not aggregated",
+            max_len);
+        return;
+    }
+
+    /* the frame is a container of length prefixed messages, even if no more
+       messages are coalesced, so that the network application can always
+       split it the same way */
+    memmove(tx_msg.msg_payload + 1, tx_msg.msg_payload, tx_msg_payload_len);
+    tx_msg.msg_payload[0] = tx_msg_payload_len;
+    tx_msg_payload_len += 1;
+
+    while( tx_aggr_count < __tx_aggr_max_msgs &&
+           tx_msg_payload_len + 1 < max_len )
+    {
+        p_header = &tx_aggr_msgs[tx_aggr_count];
+        if( lora_wan_get_tx_aggr_data(p_msg_header->port_num,
+                p_msg_header->confirm, max_len - tx_msg_payload_len - 1,
+                p_header, tx_msg.msg_payload + tx_msg_payload_len + 1)
+            != __PORT_OK )
+        {
+            break;
+        }
+
+        if( p_header->has_timeout && p_header->expire_timestamp <= ts )
+        {
+            __log_info("-- aggregated msg already timedout, drop it ..");
+            trx_post_ind(__IND_TX_TIMEOUT, p_header);
+            continue;
+        }
+
+        tx_msg.msg_payload[tx_msg_payload_len] = p_header->len;
+        tx_msg_payload_len += 1 + p_header->len;
+        ++ tx_aggr_count;
+
+        /* the frame lives until the earliest deadline of its messages and is
+           retried as much as the most demanding one of them */
+        if( p_header->has_timeout && ( ! p_msg_header->has_timeout ||
+            p_header->expire_timestamp < p_msg_header->expire_timestamp ) )
+        {
+            p_msg_header->has_timeout = 1;
+            p_msg_header->expire_timestamp = p_header->expire_timestamp;
+        }
+        if( p_header->retries > p_msg_header->retries )
+            p_msg_header->retries = p_header->retries;
+    }
+
+    __log_info("-- aggregated %d msgs in %d bytes (max payload: %d)",
+        tx_aggr_count, tx_msg_payload_len, max_len);
+}
+
 static void trx_after_processing(void)
 {
     if( s_is_req_class_pending )
@@ -773,13 +866,13 @@ static void trx_cancel_ongoing_processing(void)
     }
 }
 
-static void trx_post_msg_ind(int ind)
+static void trx_post_ind(int ind, lora_wan_port_tx_msg_t * p_header)
 {
     lora_wan_port_ind_msg_t ind_msg = {
         .type = ind,
         .ind_params.tx = {
-            .msg_app_id = tx_msg.msg_header.msg_app_id,
-            .msg_seq_num = tx_msg.msg_header.msg_seq_num,
+            .msg_app_id = p_header->msg_app_id,
+            .msg_seq_num = p_header->msg_seq_num,
         }
     };
     if(ind == __IND_TX_CONFIRM || ind == __IND_TX_DONE)
@@ -788,11 +881,28 @@ static void trx_post_msg_ind(int ind)
         ind_msg.ind_params.tx.ul_frame_counter = tx_status_params.ul_counter;
         ind_msg.ind_params.tx.data_rate = tx_status_params.data_rate;
     }
-    lora_wan_port_indication(tx_msg.msg_header.port_num, &ind_msg);
+    lora_wan_port_indication(p_header->port_num, &ind_msg);
 
-    if(tx_msg.msg_header.sync)
+    if(p_header->sync)
     {
-        sync_obj_release(tx_msg.msg_header.sync_obj);
+        sync_obj_release(p_header->sync_obj);
+    }
+}
+
+static void trx_post_msg_ind(int ind)
+{
+    uint8_t i;
+
+    lora_wan_link_tx_end(
+        ind == __IND_TX_CONFIRM ? __LORA_WAN_LINK_ACKED :
+        ind == __IND_TX_DONE    ? __LORA_WAN_LINK_SENT :
+        ind == __IND_TX_TIMEOUT ? __LORA_WAN_LINK_TIMEOUT :
+                                  __LORA_WAN_LINK_FAILED );
+
+    /* every message coalesced in the frame gets its own indication */
+    for(i = 0; i < tx_aggr_count; ++i)
+    {
+        trx_post_ind(ind, &tx_aggr_msgs[i]);
     }
 }
 
@@ -841,6 +951,7 @@ static void lmh_cb_on_mac_tx(lmh_tx_status_params_t* p_tx_info)
     if( is_msg_processing )
     {
         __log_info("-- handle msg in processing ..");
+        lora_wan_link_on_tx(p_tx_info);
         if(p_tx_info->status == LORAMAC_EVENT_INFO_STATUS_OK)
         {
             __log_info("-- tx mac status ok ..");
@@ -916,6 +1027,7 @@ static void lmh_cb_on_mac_rx(lmh_rx_status_params_t* p_rx_info)
 
     __log_info("callback() -> mac-rx-event:"__cyan__"%s"__default__,
         lora_utils_get_mac_event_info_status_str(p_rx_info->status));
+    lora_wan_link_on_rx(p_rx_info);
     if(p_rx_info->port)
     {
         __log_info("-- rx on port %d", p_rx_info->port);
@@ -928,7 +1040,8 @@ static void lmh_cb_on_mac_rx(lmh_rx_status_params_t* p_rx_info)
                     .dl_frame_counter = p_rx_info->dl_counter,
                     .rssi = p_rx_info->rssi,
                     .snr = p_rx_info->snr,
-                    .data_rate = p_rx_info->data_rate
+                    .data_rate = p_rx_info->data_rate,
+                    .mcast_group = lora_wan_mcast_on_rx(p_rx_info)
                 }
             };
             __log_info("-- rx data len: %d, transfer it to the dedicated port",
@@ -1029,6 +1142,7 @@ static const char* lora_wan_get_req_str(lora_wan_process_request_t req)
     case __LORA_WAN_PROCESS_CLASS_CHANGED:  return "ind-class";
     case __LORA_WAN_PROCESS_LCT_MODE_ENTER: return "lct-on";
     case __LORA_WAN_PROCESS_LCT_MODE_EXIT:  return "lct-off";
+    case __LORA_WAN_PROCESS_MCAST_REQ:      return "mcast-req";
     }
     return __red__"unknown-process-request"__default__;
 }
@@ -1048,6 +1162,10 @@ static void lora_wan_process_handler(void* data)
         __log_info("-- is_joined : %d", status_req->is_joined);
         sync_obj_signal(status_req->sync_obj);
     }
+    else if(req->request_type == __LORA_WAN_PROCESS_MCAST_REQ)
+    {
+        lora_wan_mcast_process_request(req->trigger_data);
+    }
     else
     {
         __sm_run(lora_wan, get_state_machine_input(req->request_type),
@@ -60,6 +60,8 @@ typedef enum {
 
     __LORA_WAN_PROCESS_LCT_MODE_ENTER,
     __LORA_WAN_PROCESS_LCT_MODE_EXIT,
+
+    __LORA_WAN_PROCESS_MCAST_REQ,
 } lora_wan_process_request_t;
 
 typedef struct {
@@ -30,6 +30,7 @@
  * --------------------------------------------------------------------------- *
  */
 #include <stdint.h>
+#include <string.h>
 #include "FreeRTOS.h"
 #include "semphr.h"
 
@@ -39,6 +40,8 @@
 #include "stub_system.h"
 #include "lora_nvm.h"
 #include "lora_wan_radio_process.h"
+#include "radio_ext.h"
+#include "lora_wan_link.h"
 
 #define __log_subsystem     lora
 #define __log_component     wan_process
@@ -60,6 +63,24 @@
     #define __rxwin_default_calibration_enabled false
 #endif
 
+#ifdef CONFIG_LORA_WAN_DEFAULT_RX_WIN_AUTO_CAL_ENABLE
+    #define __rxwin_default_auto_calibration    true
+#else
+    #define __rxwin_default_auto_calibration    false
+#endif
+#ifdef CONFIG_LORA_WAN_RX_WIN_AUTO_CAL_TARGET
+    #define __rxwin_default_auto_cal_target     \
+        CONFIG_LORA_WAN_RX_WIN_AUTO_CAL_TARGET
+#else
+    #define __rxwin_default_auto_cal_target     95
+#endif
+#ifdef CONFIG_LORA_WAN_RX_WIN_AUTO_CAL_MARGIN_MS
+    #define __rxwin_auto_cal_margin             \
+        CONFIG_LORA_WAN_RX_WIN_AUTO_CAL_MARGIN_MS
+#else
+    #define __rxwin_auto_cal_margin             2
+#endif
+
 /* --------------------------------------------------------------------------- *
  * nvm settings
  * --------------------------------------------------------------------------- *
@@ -69,6 +90,8 @@ typedef struct {
     int32_t     time_shift;
     int32_t     time_extension;
     bool        calibration_enabled;
+    bool        auto_calibration;
+    uint8_t     auto_cal_target;
 
     lora_nvm_record_tail_t  nvm_record_tail;
 } local_nvm_data_t;
@@ -83,6 +106,8 @@ static void load_local_nvm_data_defaults( void* p_record_mem, uint32_t size )
     s_local_nvm_data.time_shift = __rxwin_default_time_shift;
     s_local_nvm_data.time_extension = __rxwin_default_time_extension;
     s_local_nvm_data.calibration_enabled = __rxwin_default_calibration_enabled;
+    s_local_nvm_data.auto_calibration = __rxwin_default_auto_calibration;
+    s_local_nvm_data.auto_cal_target = __rxwin_default_auto_cal_target;
 }
 
 static void handle_local_nvm_data_change(void)
@@ -479,8 +504,31 @@ void lm_radio_process_assert(void)
  *  x1, x2 :: possible timer expiration ticks. it should be very close to the
  *       ( <rx-act-time> - S ) value. but in case it is not aligned, an extra
  *       delay will be applied to ensure it is maintained.
+ *
+ *  auto-calibration
+ *  ----------------
+ *  every frame received in an rx-window gives the margin by which the window
+ *  was opened before the frame preamble. The preamble start is taken back
+ *  from the rx-done irq time by the frame time on air. The margin mean and
+ *  deviation are smoothed as the tcp rtt estimator does, and S is moved so
+ *  that the mean margin meets the configured margin plus a guard and twice
+ *  the deviation, E follows the same allowance on the window tail.
+ *  The downlinks outcome, the windows rx-done and rx-error and the confirmed
+ *  uplinks not acknowledged, are kept in a history of the last 32 ones. When
+ *  their success rate falls below the target, the guard is raised and the
+ *  window is opened earlier right away, the guard is lowered again slowly
+ *  while the rate holds.
  * --------------------------------------------------------------------------- *
  */
+#define __auto_cal_min_samples          (4)
+#define __auto_cal_min_history          (4)
+#define __auto_cal_max_step             (8)
+#define __auto_cal_guard_step           (4)
+#define __auto_cal_max_guard            (64)
+#define __auto_cal_guard_decay_count    (16)
+#define __auto_cal_max_shift            (200)
+#define __auto_cal_max_extension        (200)
+#define __auto_cal_persist_delta        (4)
 struct {
     int32_t     time_shift;
     int32_t     time_extension;
@@ -509,6 +557,23 @@ struct {
 
     bool debug_verbose;
 
+    struct {
+        bool        enabled;
+        uint8_t     target;         /* downlinks success rate in percent */
+        uint16_t    rx_size;        /* size of the last received frame */
+        uint32_t    rx_open_ts;     /* the radio rx start of the window */
+        int32_t     margin_avg;     /* scaled by 8 */
+        int32_t     margin_dev;     /* scaled by 4 */
+        int32_t     last_margin;
+        int32_t     guard;
+        uint32_t    history;        /* a bit per downlink, set on success */
+        uint8_t     history_len;
+        uint16_t    successes;      /* since the last guard change */
+        uint32_t    samples;
+        uint32_t    misses;
+        uint32_t    backoffs;
+    } auto_cal;
+
 } s_rxwin_ctrl_ctx = {
     .rx1_state = __rx_state_idle,
     .rx2_state = __rx_state_idle,
@@ -521,6 +586,8 @@ static void lw_rxwin_timing_ctrl_ctor(void)
     s_rxwin_ctrl_ctx.time_shift = s_local_nvm_data.time_shift;
     s_rxwin_ctrl_ctx.time_extension = s_local_nvm_data.time_extension;
     s_rxwin_ctrl_ctx.calibration_enabled = s_local_nvm_data.calibration_enabled;
+    s_rxwin_ctrl_ctx.auto_cal.enabled = s_local_nvm_data.auto_calibration;
+    s_rxwin_ctrl_ctx.auto_cal.target = s_local_nvm_data.auto_cal_target;
 }
 
 void lw_rxwin_set_sys_time_err(uint32_t sys_time_err)
@@ -558,9 +625,214 @@ void lw_rxwin_calibration_set_enablement(bool enable)
     __update_nvm_data(calibration_enabled, enable);
 }
 
+/* --- auto-calibration ---------------------------------------------------- */
+
+static void auto_cal_reset(void)
+{
+    s_rxwin_ctrl_ctx.auto_cal.margin_avg = 0;
+    s_rxwin_ctrl_ctx.auto_cal.margin_dev = 0;
+    s_rxwin_ctrl_ctx.auto_cal.last_margin = 0;
+    s_rxwin_ctrl_ctx.auto_cal.guard = 0;
+    s_rxwin_ctrl_ctx.auto_cal.history = 0;
+    s_rxwin_ctrl_ctx.auto_cal.history_len = 0;
+    s_rxwin_ctrl_ctx.auto_cal.successes = 0;
+    s_rxwin_ctrl_ctx.auto_cal.samples = 0;
+    s_rxwin_ctrl_ctx.auto_cal.misses = 0;
+    s_rxwin_ctrl_ctx.auto_cal.backoffs = 0;
+}
+
+static int32_t auto_cal_clamp(int32_t value, int32_t min, int32_t max)
+{
+    return value < min ? min : value > max ? max : value;
+}
+
+/* the auto-calibrated values are stored only when they moved enough, not to
+   write the nvm on every downlink */
+static void auto_cal_persist(void)
+{
+    int32_t shift_diff =
+        s_rxwin_ctrl_ctx.time_shift - s_local_nvm_data.time_shift;
+    int32_t ext_diff =
+        s_rxwin_ctrl_ctx.time_extension - s_local_nvm_data.time_extension;
+
+    if( shift_diff >= __auto_cal_persist_delta ||
+        shift_diff <= -__auto_cal_persist_delta ||
+        ext_diff >= __auto_cal_persist_delta ||
+        ext_diff <= -__auto_cal_persist_delta )
+    {
+        s_local_nvm_data.time_shift = s_rxwin_ctrl_ctx.time_shift;
+        s_local_nvm_data.time_extension = s_rxwin_ctrl_ctx.time_extension;
+        handle_local_nvm_data_change();
+    }
+}
+
+/* moves the window start by the given ms, positive opens it earlier */
+static void auto_cal_move(int32_t step)
+{
+    int32_t shift = auto_cal_clamp(s_rxwin_ctrl_ctx.time_shift + step,
+        - (int32_t)s_rxwin_ctrl_ctx.rxwin_sys_err, __auto_cal_max_shift);
+
+    /* the estimated margin follows the window start */
+    s_rxwin_ctrl_ctx.auto_cal.margin_avg +=
+        ( shift - s_rxwin_ctrl_ctx.time_shift ) << 3;
+    s_rxwin_ctrl_ctx.time_shift = shift;
+}
+
+static int32_t auto_cal_allowance(void)
+{
+    return __rxwin_auto_cal_margin + s_rxwin_ctrl_ctx.auto_cal.guard
+        + 2 * ( s_rxwin_ctrl_ctx.auto_cal.margin_dev >> 2 );
+}
+
+static uint8_t auto_cal_success_rate(void)
+{
+    uint8_t len = s_rxwin_ctrl_ctx.auto_cal.history_len;
+    uint32_t mask = len < 32 ? ( 1u << len ) - 1 : 0xFFFFFFFFu;
+
+    if( len == 0 )
+        return 100;
+    return __builtin_popcount(s_rxwin_ctrl_ctx.auto_cal.history & mask)
+        * 100 / len;
+}
+
+static void auto_cal_history_push(bool success)
+{
+    s_rxwin_ctrl_ctx.auto_cal.history =
+        ( s_rxwin_ctrl_ctx.auto_cal.history << 1 ) | ( success ? 1 : 0 );
+    if( s_rxwin_ctrl_ctx.auto_cal.history_len < 32 )
+        ++ s_rxwin_ctrl_ctx.auto_cal.history_len;
+}
+
+static void auto_cal_on_miss(void)
+{
+    ++ s_rxwin_ctrl_ctx.auto_cal.misses;
+    auto_cal_history_push(false);
+    s_rxwin_ctrl_ctx.auto_cal.successes = 0;
+
+    if( s_rxwin_ctrl_ctx.auto_cal.history_len < __auto_cal_min_history ||
+        auto_cal_success_rate() >= s_rxwin_ctrl_ctx.auto_cal.target )
+        return;
+
+    /* below the target, widen the guard and open the window earlier now */
+    ++ s_rxwin_ctrl_ctx.auto_cal.backoffs;
+    s_rxwin_ctrl_ctx.auto_cal.guard = auto_cal_clamp(
+        s_rxwin_ctrl_ctx.auto_cal.guard + __auto_cal_guard_step,
+        0, __auto_cal_max_guard);
+    auto_cal_move(__auto_cal_guard_step);
+    s_rxwin_ctrl_ctx.time_extension = auto_cal_clamp(
+        s_rxwin_ctrl_ctx.time_extension + __auto_cal_guard_step,
+        0, __auto_cal_max_extension);
+    auto_cal_persist();
+
+    __log_info("rxwin auto-cal: success rate %d%% below %d%%, guard %d",
+        auto_cal_success_rate(), s_rxwin_ctrl_ctx.auto_cal.target,
+        s_rxwin_ctrl_ctx.auto_cal.guard);
+}
+
+static void auto_cal_on_rx_done(void)
+{
+    extern uint32_t radio_get_irq_timestamp(void);
+    uint32_t frame_time =
+        ( lora_radio_ext_get_frame_time_us(s_rxwin_ctrl_ctx.auto_cal.rx_size)
+            + 500 ) / 1000;
+    uint32_t preamble_ts = radio_get_irq_timestamp() - frame_time;
+    int32_t margin = preamble_ts - s_rxwin_ctrl_ctx.auto_cal.rx_open_ts;
+    int32_t err;
+
+    ++ s_rxwin_ctrl_ctx.auto_cal.samples;
+    s_rxwin_ctrl_ctx.auto_cal.last_margin = margin;
+    auto_cal_history_push(true);
+
+    if( s_rxwin_ctrl_ctx.auto_cal.samples == 1 ) {
+        s_rxwin_ctrl_ctx.auto_cal.margin_avg = margin << 3;
+        s_rxwin_ctrl_ctx.auto_cal.margin_dev = 2 << 2;
+    } else {
+        err = margin - ( s_rxwin_ctrl_ctx.auto_cal.margin_avg >> 3 );
+        s_rxwin_ctrl_ctx.auto_cal.margin_avg += err;
+        s_rxwin_ctrl_ctx.auto_cal.margin_dev +=
+            ( err < 0 ? -err : err )
+            - ( s_rxwin_ctrl_ctx.auto_cal.margin_dev >> 2 );
+    }
+
+    /* the guard is lowered while the success rate holds */
+    if( ++ s_rxwin_ctrl_ctx.auto_cal.successes
+            >= __auto_cal_guard_decay_count ) {
+        s_rxwin_ctrl_ctx.auto_cal.successes = 0;
+        if( s_rxwin_ctrl_ctx.auto_cal.guard > 0 &&
+            auto_cal_success_rate() >= s_rxwin_ctrl_ctx.auto_cal.target )
+            -- s_rxwin_ctrl_ctx.auto_cal.guard;
+    }
+
+    if( s_rxwin_ctrl_ctx.auto_cal.samples < __auto_cal_min_samples )
+        return;
+
+    /* half of the excess margin per step, so a single late or early frame
+       moves the window only a little */
+    int32_t excess = ( s_rxwin_ctrl_ctx.auto_cal.margin_avg >> 3 )
+        - auto_cal_allowance();
+    int32_t step = auto_cal_clamp(excess / 2,
+        - __auto_cal_max_step, __auto_cal_max_step);
+    if( step == 0 && excess != 0 )
+        step = excess > 0 ? 1 : -1;
+    auto_cal_move(- step);
+    s_rxwin_ctrl_ctx.time_extension = auto_cal_clamp(auto_cal_allowance(),
+        0, __auto_cal_max_extension);
+    auto_cal_persist();
+}
+
+bool lw_rxwin_auto_calibration_get_enablement(void)
+{
+    return s_rxwin_ctrl_ctx.auto_cal.enabled;
+}
+void lw_rxwin_auto_calibration_set_enablement(bool enable)
+{
+    if( enable && ! s_rxwin_ctrl_ctx.calibration_enabled )
+        lw_rxwin_calibration_set_enablement(true);
+    auto_cal_reset();
+    s_rxwin_ctrl_ctx.auto_cal.enabled = enable;
+    __update_nvm_data(auto_calibration, enable);
+}
+
+uint8_t lw_rxwin_auto_calibration_get_target(void)
+{
+    return s_rxwin_ctrl_ctx.auto_cal.target;
+}
+void lw_rxwin_auto_calibration_set_target(uint8_t target)
+{
+    target = auto_cal_clamp(target, 1, 100);
+    s_rxwin_ctrl_ctx.auto_cal.target = target;
+    __update_nvm_data(auto_cal_target, target);
+}
+
+void lw_rxwin_auto_calibration_on_confirm(bool ack_received)
+{
+    if( s_rxwin_ctrl_ctx.auto_cal.enabled && ! ack_received )
+        auto_cal_on_miss();
+}
+
+void lw_rxwin_auto_calibration_stats(void)
+{
+    if( ! s_rxwin_ctrl_ctx.auto_cal.enabled )
+        return;
+    __log_output("rxwin auto-cal: shift %d, extension %d, margin avg %d "
+        "dev %d last %d, guard %d, success %d%% target %d%%, "
+        "frames %d misses %d backoffs %d\n",
+        s_rxwin_ctrl_ctx.time_shift, s_rxwin_ctrl_ctx.time_extension,
+        s_rxwin_ctrl_ctx.auto_cal.margin_avg >> 3,
+        s_rxwin_ctrl_ctx.auto_cal.margin_dev >> 2,
+        s_rxwin_ctrl_ctx.auto_cal.last_margin,
+        s_rxwin_ctrl_ctx.auto_cal.guard,
+        auto_cal_success_rate(), s_rxwin_ctrl_ctx.auto_cal.target,
+        s_rxwin_ctrl_ctx.auto_cal.samples, s_rxwin_ctrl_ctx.auto_cal.misses,
+        s_rxwin_ctrl_ctx.auto_cal.backoffs);
+}
+
+/* --- rx-windows timing ---------------------------------------------------- */
+
 void lw_rxwin_set_last_tx_done_timestamp(uint32_t timestamp)
 {
     s_rxwin_ctrl_ctx.last_tx_done_ts = timestamp;
+    lw_link_on_radio_tx_done();
     s_rxwin_ctrl_ctx.curr_handled_rxwin = __rx_win_none;
     s_rxwin_ctrl_ctx.rx1_state = __rx_state_idle;
     s_rxwin_ctrl_ctx.rx2_state = __rx_state_idle;
@@ -582,18 +854,27 @@ uint32_t lm_rxwin_get_delay(uint32_t win_act_delay)
     }
 }
 
-static void lm_rxwin_rx_conclude(void);
+void lm_rxwin_set_rx_size(uint16_t size)
+{
+    s_rxwin_ctrl_ctx.auto_cal.rx_size = size;
+    lw_link_on_radio_rx_done();
+}
+
+static void lm_rxwin_rx_conclude(int prev_state);
 void lm_rxwin_set_rx_state(int state)
 {
+    int prev_state;
     if(s_rxwin_ctrl_ctx.curr_handled_rxwin == __rx_win_1)
     {
+        prev_state = s_rxwin_ctrl_ctx.rx1_state;
         s_rxwin_ctrl_ctx.rx1_state = state;
-        lm_rxwin_rx_conclude();
+        lm_rxwin_rx_conclude(prev_state);
     }
     else if(s_rxwin_ctrl_ctx.curr_handled_rxwin == __rx_win_2)
     {
+        prev_state = s_rxwin_ctrl_ctx.rx2_state;
         s_rxwin_ctrl_ctx.rx2_state = state;
-        lm_rxwin_rx_conclude();
+        lm_rxwin_rx_conclude(prev_state);
     }
 }
 
@@ -629,8 +910,22 @@ static void lm_rxwin_verbose(void)
     }
 }
 
-static void lm_rxwin_rx_conclude(void)
+static void lm_rxwin_rx_conclude(int prev_state)
 {
+    int rx_state = s_rxwin_ctrl_ctx.curr_handled_rxwin == __rx_win_1 ?
+        s_rxwin_ctrl_ctx.rx1_state : s_rxwin_ctrl_ctx.rx2_state;
+
+    /* only the first conclusion of a class-A window is a calibration sample,
+       the continuous class-C reception after rx2 is not timed */
+    if( s_rxwin_ctrl_ctx.auto_cal.enabled &&
+        s_rxwin_ctrl_ctx.calibration_enabled &&
+        prev_state == __rx_state_idle )
+    {
+        if( rx_state == __rx_state_done )
+            auto_cal_on_rx_done();
+        else if( rx_state == __rx_state_error )
+            auto_cal_on_miss();
+    }
     lm_rxwin_verbose();
 }
 
@@ -650,6 +945,7 @@ void lm_rxwin_time_ctrl_align(void)
             lora_stub_delay_msec(alignment_delay);
         }
     }
+    s_rxwin_ctrl_ctx.auto_cal.rx_open_ts = lora_stub_get_timestamp_ms();
 }
 
 static void lw_rxwin_timer_expire_handler(void* args)
@@ -75,9 +75,35 @@ void    lw_rxwin_calibration_set_time_extension(int32_t time_extension);
 bool    lw_rxwin_calibration_get_enablement(void);
 void    lw_rxwin_calibration_set_enablement(bool enable);
 
+/**
+ * @fn lw_rxwin_auto_calibration_get_enablement
+ * @fn lw_rxwin_auto_calibration_set_enablement
+ * @fn lw_rxwin_auto_calibration_get_target
+ * @fn lw_rxwin_auto_calibration_set_target
+ *
+ * @brief responsible for setting/getting the rx window auto-calibration
+ *      enablement and its downlinks success rate target in percent. When it
+ *      is enabled, the time-shift and time-extension are adapted online from
+ *      the timing of the frames received in the rx windows, enabling it
+ *      enables the calibration as well
+ */
+bool    lw_rxwin_auto_calibration_get_enablement(void);
+void    lw_rxwin_auto_calibration_set_enablement(bool enable);
+uint8_t lw_rxwin_auto_calibration_get_target(void);
+void    lw_rxwin_auto_calibration_set_target(uint8_t target);
+
+/**
+ * @brief accounts the outcome of a confirmed uplink, a missing ack is a
+ *      missed downlink for the auto-calibration success rate
+ */
+void    lw_rxwin_auto_calibration_on_confirm(bool ack_received);
+
+void    lw_rxwin_auto_calibration_stats(void);
+
 /**
  * @fn lw_rxwin_set_last_tx_done_timestamp
  * @fn lm_rxwin_get_delay
+ * @fn lm_rxwin_set_rx_size
  * @fn lm_rxwin_set_rx_state
  * @fn lm_rxwin_toggle_debug_verbosity
  * @fn lm_rxwin_time_ctrl_align
@@ -88,6 +114,7 @@ void    lw_rxwin_calibration_set_enablement(bool enable);
  */
 void lw_rxwin_set_last_tx_done_timestamp(uint32_t timestamp);
 uint32_t lm_rxwin_get_delay(uint32_t win_act_delay);
+void lm_rxwin_set_rx_size(uint16_t size);
 void lm_rxwin_set_rx_state(int state);
 void lm_rxwin_time_ctrl_align(void);
 void lw_radio_process_rxwin_timer_expire(
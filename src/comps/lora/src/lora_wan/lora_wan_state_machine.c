@@ -9,69 +9,69 @@ void __sm_action_fun(lora_wan, joined_enter)(void* data);
 
 
 /* --- INPUTS --------------------------------------------------------------- */
-static input_table_t sm_lora_wan_inputs_table[] = {
-    [__sm_input_id(lora_wan, join_req)] = { "join_req" },
-    [__sm_input_id(lora_wan, mac_req)] = { "mac_req" },
-    [__sm_input_id(lora_wan, join_done)] = { "join_done" },
-    [__sm_input_id(lora_wan, join_fail)] = { "join_fail" },
-    [__sm_input_id(lora_wan, commission)] = { "commission" },
-    [__sm_input_id(lora_wan, lct_on)] = { "lct_on" },
-    [__sm_input_id(lora_wan, duty_cycle)] = { "duty_cycle" },
-    [__sm_input_id(lora_wan, req_class)] = { "req_class" },
-    [__sm_input_id(lora_wan, timeout)] = { "timeout" },
-    [__sm_input_id(lora_wan, class_chg)] = { "class_chg" },
-    [__sm_input_id(lora_wan, lct_off)] = { "lct_off" },
-    [__sm_input_id(lora_wan, rejoin_req)] = { "rejoin_req" },
+static const input_table_t sm_lora_wan_inputs_table[] = {
+    [__sm_input_id(lora_wan, join_req)] = { __sm_name("join_req") },
+    [__sm_input_id(lora_wan, mac_req)] = { __sm_name("mac_req") },
+    [__sm_input_id(lora_wan, join_done)] = { __sm_name("join_done") },
+    [__sm_input_id(lora_wan, join_fail)] = { __sm_name("join_fail") },
+    [__sm_input_id(lora_wan, commission)] = { __sm_name("commission") },
+    [__sm_input_id(lora_wan, lct_on)] = { __sm_name("lct_on") },
+    [__sm_input_id(lora_wan, duty_cycle)] = { __sm_name("duty_cycle") },
+    [__sm_input_id(lora_wan, req_class)] = { __sm_name("req_class") },
+    [__sm_input_id(lora_wan, timeout)] = { __sm_name("timeout") },
+    [__sm_input_id(lora_wan, class_chg)] = { __sm_name("class_chg") },
+    [__sm_input_id(lora_wan, lct_off)] = { __sm_name("lct_off") },
+    [__sm_input_id(lora_wan, rejoin_req)] = { __sm_name("rejoin_req") },
 };
 #define sm_lora_wan_inputs_table_size \
     (sizeof(sm_lora_wan_inputs_table)/sizeof(input_table_t))
 
 /* --- ACTIONS -------------------------------------------------------------- */
-static action_table_t sm_lora_wan_actions_table[] = {
+static const action_table_t sm_lora_wan_actions_table[] = {
     [__sm_action_id(lora_wan, start_join)] = {
-        "start_join",
+        __sm_name("start_join"),
         __sm_action_fun(lora_wan, start_join)},
     [__sm_action_id(lora_wan, process_mac)] = {
-        "process_mac",
+        __sm_name("process_mac"),
         __sm_action_fun(lora_wan, process_mac)},
     [__sm_action_id(lora_wan, switch_slass)] = {
-        "switch_slass",
+        __sm_name("switch_slass"),
         __sm_action_fun(lora_wan, switch_slass)},
     [__sm_action_id(lora_wan, restart_join)] = {
-        "restart_join",
+        __sm_name("restart_join"),
         __sm_action_fun(lora_wan, restart_join)},
     [__sm_action_id(lora_wan, commission)] = {
-        "commission",
+        __sm_name("commission"),
         __sm_action_fun(lora_wan, commission)},
     [__sm_action_id(lora_wan, lct_enter)] = {
-        "lct_enter",
+        __sm_name("lct_enter"),
         __sm_action_fun(lora_wan, lct_enter)},
     [__sm_action_id(lora_wan, start_trx)] = {
-        "start_trx",
+        __sm_name("start_trx"),
         __sm_action_fun(lora_wan, start_trx)},
     [__sm_action_id(lora_wan, trx_timeout)] = {
-        "trx_timeout",
+        __sm_name("trx_timeout"),
         __sm_action_fun(lora_wan, trx_timeout)},
     [__sm_action_id(lora_wan, ind_class)] = {
-        "ind_class",
+        __sm_name("ind_class"),
         __sm_action_fun(lora_wan, ind_class)},
     [__sm_action_id(lora_wan, do_nothing)] = {
-        "do_nothing",
+        __sm_name("do_nothing"),
         0},
     [__sm_action_id(lora_wan, lct_commission)] = {
-        "lct_commission",
+        __sm_name("lct_commission"),
         __sm_action_fun(lora_wan, lct_commission)},
     [__sm_action_id(lora_wan, lct_join)] = {
-        "lct_join",
+        __sm_name("lct_join"),
         __sm_action_fun(lora_wan, lct_join)},
     [__sm_action_id(lora_wan, lct_exit)] = {
-        "lct_exit",
+        __sm_name("lct_exit"),
         __sm_action_fun(lora_wan, lct_exit)},
     [__sm_action_id(lora_wan, lct_handle)] = {
-        "lct_handle",
+        __sm_name("lct_handle"),
         __sm_action_fun(lora_wan, lct_handle)},
     [__sm_action_id(lora_wan, lct_joined)] = {
-        "lct_joined",
+        __sm_name("lct_joined"),
         __sm_action_fun(lora_wan, lct_joined)},
 };
 #define sm_lora_wan_actions_table_size \
@@ -79,7 +79,7 @@ static action_table_t sm_lora_wan_actions_table[] = {
 
 /* --- STATES --------------------------------------------------------------- */
 /* --- state -> not_joined -------------------------------------------------- */
-static state_trans_table_t sm_lora_wan_not_joined_trans_table [] = {
+static const state_trans_table_t sm_lora_wan_not_joined_trans_table [] = {
     {
         .input_id = __sm_input_id(lora_wan, join_req),
         .action_id = __sm_action_id(lora_wan, start_join),
@@ -113,9 +113,12 @@ static state_trans_table_t sm_lora_wan_not_joined_trans_table [] = {
 };
 #define sm_lora_wan_not_joined_trans_table_size \
     (sizeof(sm_lora_wan_not_joined_trans_table)/sizeof(state_trans_table_t))
+#ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+static uint32_t sm_lora_wan_not_joined_trans_hits [sm_lora_wan_not_joined_trans_table_size];
+#endif
 
 /* --- state -> chg_class --------------------------------------------------- */
-static state_trans_table_t sm_lora_wan_chg_class_trans_table [] = {
+static const state_trans_table_t sm_lora_wan_chg_class_trans_table [] = {
     {
         .input_id = __sm_input_id(lora_wan, req_class),
         .action_id = __sm_action_id(lora_wan, switch_slass),
@@ -159,9 +162,12 @@ static state_trans_table_t sm_lora_wan_chg_class_trans_table [] = {
 };
 #define sm_lora_wan_chg_class_trans_table_size \
     (sizeof(sm_lora_wan_chg_class_trans_table)/sizeof(state_trans_table_t))
+#ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+static uint32_t sm_lora_wan_chg_class_trans_hits [sm_lora_wan_chg_class_trans_table_size];
+#endif
 
 /* --- state -> lct --------------------------------------------------------- */
-static state_trans_table_t sm_lora_wan_lct_trans_table [] = {
+static const state_trans_table_t sm_lora_wan_lct_trans_table [] = {
     {
         .input_id = __sm_input_id(lora_wan, duty_cycle),
         .action_id = __sm_action_id(lora_wan, lct_handle),
@@ -190,9 +196,12 @@ static state_trans_table_t sm_lora_wan_lct_trans_table [] = {
 };
 #define sm_lora_wan_lct_trans_table_size \
     (sizeof(sm_lora_wan_lct_trans_table)/sizeof(state_trans_table_t))
+#ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+static uint32_t sm_lora_wan_lct_trans_hits [sm_lora_wan_lct_trans_table_size];
+#endif
 
 /* --- state -> joined ------------------------------------------------------ */
-static state_trans_table_t sm_lora_wan_joined_trans_table [] = {
+static const state_trans_table_t sm_lora_wan_joined_trans_table [] = {
     {
         .input_id = __sm_input_id(lora_wan, duty_cycle),
         .action_id = __sm_action_id(lora_wan, start_trx),
@@ -226,9 +235,12 @@ static state_trans_table_t sm_lora_wan_joined_trans_table [] = {
 };
 #define sm_lora_wan_joined_trans_table_size \
     (sizeof(sm_lora_wan_joined_trans_table)/sizeof(state_trans_table_t))
+#ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+static uint32_t sm_lora_wan_joined_trans_hits [sm_lora_wan_joined_trans_table_size];
+#endif
 
 /* --- state -> trx --------------------------------------------------------- */
-static state_trans_table_t sm_lora_wan_trx_trans_table [] = {
+static const state_trans_table_t sm_lora_wan_trx_trans_table [] = {
     {
         .input_id = __sm_input_id(lora_wan, duty_cycle),
         .action_id = __sm_action_id(lora_wan, start_trx),
@@ -267,9 +279,12 @@ static state_trans_table_t sm_lora_wan_trx_trans_table [] = {
 };
 #define sm_lora_wan_trx_trans_table_size \
     (sizeof(sm_lora_wan_trx_trans_table)/sizeof(state_trans_table_t))
+#ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+static uint32_t sm_lora_wan_trx_trans_hits [sm_lora_wan_trx_trans_table_size];
+#endif
 
 /* --- state -> lct_idle ---------------------------------------------------- */
-static state_trans_table_t sm_lora_wan_lct_idle_trans_table [] = {
+static const state_trans_table_t sm_lora_wan_lct_idle_trans_table [] = {
     {
         .input_id = __sm_input_id(lora_wan, commission),
         .action_id = __sm_action_id(lora_wan, lct_commission),
@@ -288,9 +303,12 @@ static state_trans_table_t sm_lora_wan_lct_idle_trans_table [] = {
 };
 #define sm_lora_wan_lct_idle_trans_table_size \
     (sizeof(sm_lora_wan_lct_idle_trans_table)/sizeof(state_trans_table_t))
+#ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+static uint32_t sm_lora_wan_lct_idle_trans_hits [sm_lora_wan_lct_idle_trans_table_size];
+#endif
 
 /* --- state -> lct_join ---------------------------------------------------- */
-static state_trans_table_t sm_lora_wan_lct_join_trans_table [] = {
+static const state_trans_table_t sm_lora_wan_lct_join_trans_table [] = {
     {
         .input_id = __sm_input_id(lora_wan, mac_req),
         .action_id = __sm_action_id(lora_wan, process_mac),
@@ -314,54 +332,86 @@ static state_trans_table_t sm_lora_wan_lct_join_trans_table [] = {
 };
 #define sm_lora_wan_lct_join_trans_table_size \
     (sizeof(sm_lora_wan_lct_join_trans_table)/sizeof(state_trans_table_t))
+#ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+static uint32_t sm_lora_wan_lct_join_trans_hits [sm_lora_wan_lct_join_trans_table_size];
+#endif
 
 /* --- states-table --------------------------------------------------------- */
-static state_table_t sm_lora_wan_states_table [] = {
+static const state_table_t sm_lora_wan_states_table [] = {
     [__sm_state_id(lora_wan, not_joined)] = {
-        .name = "not_joined",
+        .name = __sm_name("not_joined"),
         .trans_table = sm_lora_wan_not_joined_trans_table,
         .trans_table_size = sm_lora_wan_not_joined_trans_table_size,
+        #ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+        .trans_hits = sm_lora_wan_not_joined_trans_hits,
+        #endif
     },
     [__sm_state_id(lora_wan, chg_class)] = {
-        .name = "chg_class",
+        .name = __sm_name("chg_class"),
         .trans_table = sm_lora_wan_chg_class_trans_table,
         .trans_table_size = sm_lora_wan_chg_class_trans_table_size,
+        #ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+        .trans_hits = sm_lora_wan_chg_class_trans_hits,
+        #endif
     },
     [__sm_state_id(lora_wan, lct)] = {
-        .name = "lct",
+        .name = __sm_name("lct"),
         .trans_table = sm_lora_wan_lct_trans_table,
         .trans_table_size = sm_lora_wan_lct_trans_table_size,
+        #ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+        .trans_hits = sm_lora_wan_lct_trans_hits,
+        #endif
     },
     [__sm_state_id(lora_wan, joined)] = {
-        .name = "joined",
+        .name = __sm_name("joined"),
         .trans_table = sm_lora_wan_joined_trans_table,
         .trans_table_size = sm_lora_wan_joined_trans_table_size,
+        #ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+        .trans_hits = sm_lora_wan_joined_trans_hits,
+        #endif
         .enter = __sm_action_fun(lora_wan, joined_enter),
     },
     [__sm_state_id(lora_wan, trx)] = {
-        .name = "trx",
+        .name = __sm_name("trx"),
         .trans_table = sm_lora_wan_trx_trans_table,
         .trans_table_size = sm_lora_wan_trx_trans_table_size,
+        #ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+        .trans_hits = sm_lora_wan_trx_trans_hits,
+        #endif
     },
     [__sm_state_id(lora_wan, lct_idle)] = {
-        .name = "lct_idle",
+        .name = __sm_name("lct_idle"),
         .trans_table = sm_lora_wan_lct_idle_trans_table,
         .trans_table_size = sm_lora_wan_lct_idle_trans_table_size,
+        #ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+        .trans_hits = sm_lora_wan_lct_idle_trans_hits,
+        #endif
     },
     [__sm_state_id(lora_wan, lct_join)] = {
-        .name = "lct_join",
+        .name = __sm_name("lct_join"),
         .trans_table = sm_lora_wan_lct_join_trans_table,
         .trans_table_size = sm_lora_wan_lct_join_trans_table_size,
+        #ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+        .trans_hits = sm_lora_wan_lct_join_trans_hits,
+        #endif
     },
 };
 #define sm_lora_wan_states_table_size \
     (sizeof(sm_lora_wan_states_table)/sizeof(state_table_t))
+#ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+static state_prof_t sm_lora_wan_states_prof [sm_lora_wan_states_table_size];
+#endif
 
 
 /* --- MACHINE -------------------------------------------------------------- */
 
-state_machine_t __sm_machine_id(lora_wan) = {
-    .name = "lora_wan",
+#define sm_lora_wan_ids_bits  8
+#if sm_lora_wan_ids_bits > __SM_TABLE_ID_BITS
+#error "state machine 'lora_wan' needs 8-bits ids, enable CONFIG_SDK_LIBS_STATE_MACHINE_16_BITS_IDS"
+#endif
+
+static const state_machine_desc_t sm_lora_wan_desc = {
+    .name = __sm_name("lora_wan"),
     .inputs_table = sm_lora_wan_inputs_table,
     .inputs_table_size = sm_lora_wan_inputs_table_size,
     .actions_table = sm_lora_wan_actions_table,
@@ -370,4 +420,13 @@ state_machine_t __sm_machine_id(lora_wan) = {
     .state_table_size = sm_lora_wan_states_table_size,
 };
 
+state_machine_t __sm_machine_id(lora_wan) = {
+    .desc = &sm_lora_wan_desc,
+    #ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+    .prof = {
+        .states = sm_lora_wan_states_prof,
+    },
+    #endif
+};
+
 /* --- end of file ---------------------------------------------------------- */
@@ -67,6 +67,47 @@ int8_t lora_radio_ext_get_min_tx_power( void );
 
 const char* lora_radio_ext_get_chip_name( void );
 
+/**
+ * @brief   starts the transmission of a new payload with the modem and packet
+ *          params of the previous transmission. It is a lightweight version of
+ *          Radio.Send() for the back-to-back transmissions, it neither wakes up
+ *          nor re-configures the radio, it only loads the payload and issues
+ *          the tx command right after the tx-done of the previous frame.
+ */
+void lora_radio_ext_send_next( uint8_t * buf, uint8_t len );
+
+/**
+ * @brief   sets the channel activity detection parameters recommended for the
+ *          given spreading factor, it shall be called before Radio.StartCad()
+ */
+void lora_radio_ext_set_cad_params( uint8_t sf );
+
+/**
+ * @brief   writes the tx power alone, without the modem and packet params
+ *          written by Radio.SetTxConfig()
+ */
+void lora_radio_ext_set_tx_power( int8_t power );
+
+/**
+ * @brief   computes the time on air in usec of a frame of the given length
+ *          with the modem and packet params of the last radio configuration,
+ *          it is used to get back the preamble start of a received frame from
+ *          its rx-done time
+ */
+uint32_t lora_radio_ext_get_frame_time_us( uint8_t len );
+
+/**
+ * @brief   gets the payload length of the last radio configuration, after a
+ *          tx-done it is the length of the transmitted frame
+ */
+uint8_t lora_radio_ext_get_payload_length( void );
+
+/**
+ * @brief   gets the spreading factor of the last radio configuration, or zero
+ *          if the radio is not configured for the lora modem
+ */
+uint8_t lora_radio_ext_get_spreading_factor( void );
+
 /* --- end of file ---------------------------------------------------------- */
 #ifdef __cplusplus
 }
@@ -40,6 +40,8 @@
 
 #include "sx126x-board.h"
 
+extern SX126x_t SX126x;
+
 
 /** -------------------------------------------------------------------------- *
  * API implementation
@@ -68,4 +70,97 @@ const char* lora_radio_ext_get_chip_name( void )
     return "SX1262";
 }
 
+void lora_radio_ext_send_next( uint8_t * buf, uint8_t len )
+{
+    __log_debug("send next -> len: %d", len);
+
+    /* the packet params are re-written only if the payload length changed,
+     * the modulation params and the irq params are kept from Radio.Send() */
+    if( SX126x.PacketParams.Params.LoRa.PayloadLength != len )
+    {
+        SX126x.PacketParams.Params.LoRa.PayloadLength = len;
+        SX126xSetPacketParams( &SX126x.PacketParams );
+    }
+    SX126xWriteBuffer( 0x00, buf, len );
+    SX126xSetTx( 0 );
+}
+
+void lora_radio_ext_set_cad_params( uint8_t sf )
+{
+    /* the detection peak per spreading factor as recommended by Semtech for
+     * the 125 KHz bandwidth, the detection minimum is fixed to 10 */
+    static const struct {
+        RadioLoRaCadSymbols_t   symbols;
+        uint8_t                 det_peak;
+    } cad_params[] = {
+        { LORA_CAD_02_SYMBOL, 22 },     /* SF6  */
+        { LORA_CAD_02_SYMBOL, 22 },     /* SF7  */
+        { LORA_CAD_02_SYMBOL, 22 },     /* SF8  */
+        { LORA_CAD_04_SYMBOL, 23 },     /* SF9  */
+        { LORA_CAD_04_SYMBOL, 24 },     /* SF10 */
+        { LORA_CAD_04_SYMBOL, 25 },     /* SF11 */
+        { LORA_CAD_04_SYMBOL, 28 },     /* SF12 */
+    };
+    uint8_t idx = ( sf >= 6 && sf <= 12 ) ? sf - 6 : 1;
+
+    __log_debug("cad params -> sf: %d, det-peak: %d", sf,
+        cad_params[idx].det_peak);
+    SX126xSetCadParams( cad_params[idx].symbols, cad_params[idx].det_peak, 10,
+        LORA_CAD_ONLY, 0 );
+}
+
+void lora_radio_ext_set_tx_power( int8_t power )
+{
+    __log_debug("tx power -> %d dBm", power);
+    SX126xSetRfTxPower( power );
+}
+
+uint32_t lora_radio_ext_get_frame_time_us( uint8_t len )
+{
+    uint32_t bw_hz;
+    switch( SX126x.ModulationParams.Params.LoRa.Bandwidth )
+    {
+        case LORA_BW_500: bw_hz = 500000; break;
+        case LORA_BW_250: bw_hz = 250000; break;
+        case LORA_BW_062: bw_hz = 62500;  break;
+        case LORA_BW_041: bw_hz = 41670;  break;
+        case LORA_BW_031: bw_hz = 31250;  break;
+        case LORA_BW_020: bw_hz = 20830;  break;
+        case LORA_BW_015: bw_hz = 15630;  break;
+        case LORA_BW_010: bw_hz = 10420;  break;
+        case LORA_BW_007: bw_hz = 7810;   break;
+        default:          bw_hz = 125000; break;
+    }
+    int32_t sf = SX126x.ModulationParams.Params.LoRa.SpreadingFactor;
+    int32_t cr = SX126x.ModulationParams.Params.LoRa.CodingRate;
+    int32_t de = SX126x.ModulationParams.Params.LoRa.LowDatarateOptimize;
+    int32_t preamble = SX126x.PacketParams.Params.LoRa.PreambleLength;
+    int32_t ih = SX126x.PacketParams.Params.LoRa.HeaderType ==
+        LORA_PACKET_FIXED_LENGTH;
+    int32_t crc = SX126x.PacketParams.Params.LoRa.CrcMode == LORA_CRC_ON;
+
+    /* the semtech time on air formula in quarters of symbols */
+    int32_t num = 8 * len - 4 * sf + 28 + 16 * crc - 20 * ih;
+    int32_t den = 4 * ( sf - 2 * de );
+    int32_t payload_symbols = 8;
+    if( num > 0 )
+        payload_symbols += ( ( num + den - 1 ) / den ) * ( cr + 4 );
+    uint32_t quarter_symbols = ( preamble + payload_symbols ) * 4 + 17;
+
+    return (uint32_t)( ( (uint64_t)quarter_symbols * 1000000u << sf )
+        / ( 4u * bw_hz ) );
+}
+
+uint8_t lora_radio_ext_get_payload_length( void )
+{
+    return SX126x.PacketParams.Params.LoRa.PayloadLength;
+}
+
+uint8_t lora_radio_ext_get_spreading_factor( void )
+{
+    if( SX126x.ModulationParams.PacketType != PACKET_TYPE_LORA )
+        return 0;
+    return SX126x.ModulationParams.Params.LoRa.SpreadingFactor;
+}
+
 /* --- end of file ---------------------------------------------------------- */
@@ -37,11 +37,13 @@
 
 #include "sx126x_defs.h"
 #include "driver_inspector.h"
+#include "sx126x_trace.h"
 
 #include "FreeRTOS.h"
 #include "semphr.h"
 
 #include "system/systime.h"
+#include "stub_system.h"
 // #include "rx_win.h"
 
 /** -------------------------------------------------------------------------- *
@@ -53,6 +55,21 @@ static sx126x_port_spi_trx_t *              p_spi_trx;
 static sx126x_port_wait_on_busy_signal_t *  p_wait_on_busy_signal;
 static sx126x_port_send_reset_pulse_t *     p_send_reset_pulse;
 static sx126x_port_int_pin_state_t *        p_get_int_pin_state;
+static sx126x_port_spi_batch_begin_t *      p_spi_batch_begin;
+static sx126x_port_spi_batch_end_t *        p_spi_batch_end;
+static uint32_t                             s_spi_trx_count;
+static uint32_t                             s_spi_batch_depth;
+static sx126x_port_busy_stats_t             s_busy_stats;
+
+/* all the spi transactions pass here to be counted and traced */
+static void spi_trx( sx126x_spi_trx_t * p_trx )
+{
+    uint32_t start = lora_stub_get_timestamp_us();
+
+    ++ s_spi_trx_count;
+    p_spi_trx( p_trx );
+    sx126x_trace_trx( p_trx, start );
+}
 
 void sx126x_port_init( sx126x_port_t * p_port_params )
 {
@@ -62,16 +79,42 @@ void sx126x_port_init( sx126x_port_t * p_port_params )
     p_wait_on_busy_signal = p_port_params->p_wait_on_busy_signal;
     p_send_reset_pulse = p_port_params->p_send_reset_pulse;
     p_get_int_pin_state = p_port_params->p_get_int_pin_state;
+    p_spi_batch_begin = p_port_params->p_spi_batch_begin;
+    p_spi_batch_end = p_port_params->p_spi_batch_end;
+    s_spi_batch_depth = 0;
+}
+
+/* the radio operations are issued from the lora process context only, so the
+ * nesting depth needs no protection */
+void sx126x_port_batch_begin( sx126x_port_op_t op )
+{
+    if( s_spi_batch_depth ++ == 0 && p_spi_batch_begin )
+        p_spi_batch_begin( op );
+}
+
+void sx126x_port_batch_end( void )
+{
+    if( s_spi_batch_depth == 0 )
+        return;
+    if( -- s_spi_batch_depth == 0 && p_spi_batch_end )
+        p_spi_batch_end();
 }
 
 static DioIrqHandler* p_sx126x_drv_irq_handler;
 static void(*p_service_level_irq_handler)(void) = NULL;
+static uint32_t s_irq_timestamp_us;
 
 void sx126x_port_irq( uint32_t timestamp )
 {
     // -- register a timestamp here
     // lora_rxwin_stamp_event(__stamp_event_irq);
 
+    /* the dio edge time on the usec clock, the msec timestamp of the edge
+     * accounts for the delay until this handler runs */
+    uint32_t now_us = lora_stub_get_timestamp_us();
+    uint32_t delay_ms = lora_stub_get_timestamp_ms() - timestamp;
+    s_irq_timestamp_us = delay_ms < 1000 ? now_us - delay_ms * 1000 : now_us;
+
     // __log_enforce("- lora port");
     __log_info("lora interrupt ...");
 
@@ -88,6 +131,16 @@ void lora_port_set_service_level_irq_handler(void(*p_handler)(void))
     p_service_level_irq_handler = p_handler;
 }
 
+uint32_t sx126x_port_get_irq_timestamp_us(void)
+{
+    return s_irq_timestamp_us;
+}
+
+uint32_t sx126x_port_get_spi_trx_count(void)
+{
+    return s_spi_trx_count;
+}
+
 /** -------------------------------------------------------------------------- *
  * semtech driver ports implementation
  * --------------------------------------------------------------------------- *
@@ -108,7 +161,7 @@ void SX126xWriteRegisters( uint16_t address, uint8_t *buffer, uint16_t size )
         .size = size,
         .flags = __sx126x_spi_trx_has_address
     };
-    p_spi_trx( &trx );
+    spi_trx( &trx );
 
     SX126xWaitOnBusy( );
 }
@@ -129,7 +182,7 @@ void SX126xReadRegisters( uint16_t address, uint8_t *buffer, uint16_t size )
         .flags = __sx126x_spi_trx_has_address |
                 __sx126x_spi_trx_has_dummy_rx_byte1
     };
-    p_spi_trx( &trx );
+    spi_trx( &trx );
     lora_log_trx(true, __sx126x_cmd_read_register, address, buffer, size);
 }
 
@@ -147,7 +200,7 @@ void SX126xWriteCommand(
         .tx_buffer = buffer,
         .size = size
     };
-    p_spi_trx( &trx );
+    spi_trx( &trx );
 
     // if( opcode == __sx126x_cmd_set_rx ) {
     //     lora_rxwin_stamp_event(__stamp_event_rx_req);
@@ -174,7 +227,7 @@ uint8_t SX126xReadCommand(
         .size = size,
         .flags = __sx126x_spi_trx_has_rx_byte1
     };
-    p_spi_trx( &trx );
+    spi_trx( &trx );
 
     // if(opcode == __sx126x_cmd_get_irq_status && (buffer[1] & 1u)) {
     //     lora_rxwin_stamp_event(__stamp_event_tx_done);
@@ -212,7 +265,7 @@ void SX126xWriteBuffer( uint8_t offset, uint8_t *buffer, uint8_t size )
         .size = size,
         .flags = __sx126x_spi_trx_has_address
     };
-    p_spi_trx( &trx );
+    spi_trx( &trx );
     SX126xWaitOnBusy( );
 }
 
@@ -232,7 +285,7 @@ void SX126xReadBuffer( uint8_t offset, uint8_t *buffer, uint8_t size )
         .flags = __sx126x_spi_trx_has_address |
                 __sx126x_spi_trx_has_dummy_rx_byte1
     };
-    p_spi_trx( &trx );
+    spi_trx( &trx );
     lora_log_trx(true, __sx126x_cmd_read_buffer, offset, buffer, size);
 }
 
@@ -278,7 +331,28 @@ void SX126xReset( void )
 
 void SX126xWaitOnBusy( void )
 {
-    p_wait_on_busy_signal();
+    static const uint32_t bounds[] = __sx126x_port_busy_bounds_us;
+    uint32_t start = lora_stub_get_timestamp_us();
+    sx126x_port_busy_wait_t kind;
+    uint32_t elapsed;
+    uint8_t i;
+
+    kind = p_wait_on_busy_signal();
+    elapsed = lora_stub_get_timestamp_us() - start;
+    sx126x_trace_busy( elapsed );
+
+    for(i = 0; i < __sx126x_port_busy_buckets - 1 && elapsed > bounds[i]; ++i);
+    ++ s_busy_stats.hist[i];
+    if( kind < __sx126x_port_busy_kinds )
+        ++ s_busy_stats.waits[kind];
+    if( elapsed > s_busy_stats.max_us )
+        s_busy_stats.max_us = elapsed;
+    s_busy_stats.sum_us += elapsed;
+}
+
+void sx126x_port_get_busy_stats( sx126x_port_busy_stats_t * p_stats )
+{
+    *p_stats = s_busy_stats;
 }
 
 void SX126xWakeup( void )
@@ -294,7 +368,7 @@ void SX126xWakeup( void )
         .cs_enable_pretrans_ms = 5,
         .flags = __sx126x_spi_trx_has_cs_pretrans_ms
     };
-    p_spi_trx( &trx );
+    spi_trx( &trx );
 
     SX126xWaitOnBusy();
 
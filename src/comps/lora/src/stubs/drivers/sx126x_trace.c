@@ -0,0 +1,280 @@
+/** -------------------------------------------------------------------------- *
+ * Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @author  Ahmed Sabry (SG Wireless)
+ *
+ * @brief   binary trace recorder of the spi transactions with the sx126x radio.
+ *          The transactions are copied into a ring of fixed size records, the
+ *          names of the commands and registers are resolved only when the
+ *          trace is displayed, so the recording does not disturb the timing
+ *          of the radio operations as the logs do.
+ * --------------------------------------------------------------------------- *
+ */
+
+/** -------------------------------------------------------------------------- *
+ * includes
+ * --------------------------------------------------------------------------- *
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#define __log_subsystem  lora
+#define __log_component  stub_spi_trace
+#include "log_lib.h"
+
+#include "sx126x-board.h"
+#include "sx126x_defs.h"
+#include "driver_inspector.h"
+#include "stub_system.h"
+#include "sx126x_trace.h"
+
+/** -------------------------------------------------------------------------- *
+ * trace ring
+ * --------------------------------------------------------------------------- *
+ */
+#ifdef CONFIG_LORA_SPI_TRACE_RECORDS
+    #define __trace_records     CONFIG_LORA_SPI_TRACE_RECORDS
+#else
+    #define __trace_records     (128)
+#endif
+
+#if __trace_records > 0
+
+static struct {
+    void*                   mutex;
+    bool                    enabled;
+    bool                    last_valid; /* the busy wait goes to the last */
+    uint32_t                head;       /* next record to write */
+    uint32_t                count;
+    uint32_t                dropped;
+    sx126x_trace_record_t   ring[__trace_records];
+} s_trace;
+
+#define __trace_lock()      lora_stub_mutex_lock(s_trace.mutex)
+#define __trace_unlock()    lora_stub_mutex_unlock(s_trace.mutex)
+
+#define __trace_last()      \
+    (&s_trace.ring[(s_trace.head + __trace_records - 1) % __trace_records])
+#define __trace_oldest()    \
+    ((s_trace.head + __trace_records - s_trace.count) % __trace_records)
+
+/** -------------------------------------------------------------------------- *
+ * APIs implementations
+ * --------------------------------------------------------------------------- *
+ */
+void sx126x_trace_trx(sx126x_spi_trx_t* p_trx, uint32_t start)
+{
+    sx126x_trace_record_t* p_rec;
+    uint8_t* data;
+
+    if( ! s_trace.enabled )
+        return;
+
+    data = p_trx->rx_buffer ? p_trx->rx_buffer : p_trx->tx_buffer;
+
+    __trace_lock();
+    p_rec = &s_trace.ring[s_trace.head];
+    p_rec->timestamp = start;
+    p_rec->busy = 0;
+    p_rec->address = p_trx->address;
+    p_rec->command = p_trx->command;
+    p_rec->flags = (p_trx->rx_buffer ? __sx126x_trace_flag_read : 0) |
+        (p_trx->flags & __sx126x_spi_trx_has_address ?
+            __sx126x_trace_flag_address : 0) |
+        (p_trx->size > 0xFF ? __sx126x_trace_flag_truncated : 0);
+    p_rec->len = p_trx->size > 0xFF ? 0xFF : p_trx->size;
+    memset(p_rec->data, 0, __sx126x_trace_data_bytes);
+    if( data )
+        memcpy(p_rec->data, data, p_rec->len < __sx126x_trace_data_bytes ?
+            p_rec->len : __sx126x_trace_data_bytes);
+
+    s_trace.head = (s_trace.head + 1) % __trace_records;
+    if( s_trace.count < __trace_records )
+        ++ s_trace.count;
+    else
+        ++ s_trace.dropped;
+    s_trace.last_valid = true;
+    __trace_unlock();
+}
+
+void sx126x_trace_busy(uint32_t usec)
+{
+    sx126x_trace_record_t* p_rec;
+
+    if( ! s_trace.enabled || ! s_trace.last_valid )
+        return;
+
+    __trace_lock();
+    p_rec = __trace_last();
+    usec += p_rec->busy;
+    p_rec->busy = usec > 0xFFFF ? 0xFFFF : usec;
+    __trace_unlock();
+}
+
+void sx126x_trace_set(bool enable, bool clear)
+{
+    if( s_trace.mutex == NULL )
+        s_trace.mutex = lora_stub_mutex_new();
+
+    __log_info("spi trace -> %s%s", enable ? "start" : "stop",
+        clear ? ", clear" : "");
+
+    __trace_lock();
+    if( clear )
+    {
+        s_trace.head = 0;
+        s_trace.count = 0;
+        s_trace.dropped = 0;
+        s_trace.last_valid = false;
+    }
+    s_trace.enabled = enable;
+    __trace_unlock();
+}
+
+uint32_t sx126x_trace_read(uint8_t* buf, uint32_t size, uint32_t* p_count,
+    uint32_t* p_dropped)
+{
+    uint32_t n = 0;
+    uint32_t idx;
+
+    *p_count = 0;
+    *p_dropped = 0;
+    if( size < __sx126x_trace_header_size || s_trace.mutex == NULL )
+        return 0;
+
+    __trace_lock();
+    n = (size - __sx126x_trace_header_size) / sizeof(sx126x_trace_record_t);
+    if( n > s_trace.count )
+        n = s_trace.count;
+    if( n > 0xFFFF )
+        n = 0xFFFF;
+
+    for(idx = 0; idx < n; ++idx)
+        memcpy(buf + __sx126x_trace_header_size +
+            idx * sizeof(sx126x_trace_record_t),
+            &s_trace.ring[(__trace_oldest() + idx) % __trace_records],
+            sizeof(sx126x_trace_record_t));
+
+    s_trace.count -= n;
+    if( s_trace.count == 0 )
+        s_trace.last_valid = false;
+    *p_dropped = s_trace.dropped;
+    s_trace.dropped = 0;
+    __trace_unlock();
+
+    memcpy(buf, __sx126x_trace_magic, 3);
+    buf[3] = __sx126x_trace_version;
+    buf[4] = sizeof(sx126x_trace_record_t);
+    buf[5] = 0;
+    buf[6] = n & 0xFF;
+    buf[7] = n >> 8;
+
+    *p_count = n;
+    return __sx126x_trace_header_size + n * sizeof(sx126x_trace_record_t);
+}
+
+void sx126x_trace_print(void)
+{
+    sx126x_trace_record_t rec;
+    uint32_t first_ts = 0;
+    uint32_t count;
+    uint32_t idx;
+
+    if( s_trace.mutex == NULL )
+        return;
+
+    __trace_lock();
+    count = s_trace.count;
+    __trace_unlock();
+
+    log_list_start(4);
+    log_list_indent();
+    log_list_item(__blue__"spi trace"__default__" (%u records, %u dropped)",
+        count, s_trace.dropped);
+    log_list_indent();
+    log_list_item("%10s %6s %s %-40s %4s %4s %s", "usec", "busy", "d",
+        "command", "addr", "len", "data");
+
+    for(idx = 0; idx < count; ++idx)
+    {
+        /* the ring may move on while the records are displayed */
+        __trace_lock();
+        if( idx >= s_trace.count )
+        {
+            __trace_unlock();
+            break;
+        }
+        rec = s_trace.ring[(__trace_oldest() + idx) % __trace_records];
+        __trace_unlock();
+
+        if( idx == 0 )
+            first_ts = rec.timestamp;
+
+        log_list_item("%10u %6u %s %-40s %04x %4u "
+            "%02x %02x %02x %02x %02x "__cyan__"%s",
+            rec.timestamp - first_ts, rec.busy,
+            rec.flags & __sx126x_trace_flag_read ? __blue__"R"__default__ :
+                __red__"W"__default__,
+            lora_port_get_cmd_name(rec.command), rec.address, rec.len,
+            rec.data[0], rec.data[1], rec.data[2], rec.data[3], rec.data[4],
+            rec.command == __sx126x_cmd_write_register ||
+            rec.command == __sx126x_cmd_read_register ?
+                lora_port_get_reg_name(rec.address) : "");
+    }
+    log_list_outdent();
+    log_list_outdent();
+    log_list_end();
+}
+
+#else /* __trace_records == 0 */
+
+void sx126x_trace_trx(sx126x_spi_trx_t* p_trx, uint32_t start)
+{
+    (void) p_trx; (void) start;
+}
+
+void sx126x_trace_busy(uint32_t usec)
+{
+    (void) usec;
+}
+
+void sx126x_trace_set(bool enable, bool clear)
+{
+    (void) enable; (void) clear;
+}
+
+uint32_t sx126x_trace_read(uint8_t* buf, uint32_t size, uint32_t* p_count,
+    uint32_t* p_dropped)
+{
+    (void) buf; (void) size;
+    *p_count = 0;
+    *p_dropped = 0;
+    return 0;
+}
+
+void sx126x_trace_print(void)
+{
+}
+
+#endif /* __trace_records */
+
+/* --- end of file ---------------------------------------------------------- */
@@ -0,0 +1,114 @@
+/** -------------------------------------------------------------------------- *
+ * Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @author  Ahmed Sabry (SG Wireless)
+ *
+ * @brief   binary trace recorder of the spi transactions with the sx126x radio.
+ *
+ *          The trace is read in this format, all fields are little endian:
+ *          - a header of 8 bytes: "SXT", the format version, the record size,
+ *            a reserved byte and the 16-bit count of the following records
+ *          - the records of sx126x_trace_record_t, the oldest first
+ *
+ *          The records are decoded on the host by
+ *          src/comps/lora/tools/sx126x_trace_decode.py
+ * --------------------------------------------------------------------------- *
+ */
+
+#ifndef __SX126X_TRACE_H__
+#define __SX126X_TRACE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** -------------------------------------------------------------------------- *
+ * includes
+ * --------------------------------------------------------------------------- *
+ */
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sx126x_port.h"
+
+/** -------------------------------------------------------------------------- *
+ * types
+ * --------------------------------------------------------------------------- *
+ */
+#define __sx126x_trace_magic            "SXT"
+#define __sx126x_trace_version          1
+#define __sx126x_trace_header_size      8
+#define __sx126x_trace_data_bytes       5
+
+#define __sx126x_trace_flag_read        (1u << 0)
+#define __sx126x_trace_flag_address     (1u << 1)
+#define __sx126x_trace_flag_truncated   (1u << 2) /* len is above 255 */
+
+typedef struct {
+    uint32_t    timestamp;  /* usec at the transaction start */
+    uint16_t    busy;       /* usec waited on the busy line after it */
+    uint16_t    address;    /* register address or buffer offset */
+    uint8_t     command;    /* the sx126x opcode */
+    uint8_t     flags;
+    uint8_t     len;        /* data length */
+    uint8_t     data[__sx126x_trace_data_bytes]; /* the first data bytes */
+} sx126x_trace_record_t;
+
+/** -------------------------------------------------------------------------- *
+ * APIs
+ * --------------------------------------------------------------------------- *
+ */
+
+/**
+ * @brief   records a completed spi transaction if the trace is started
+ * @param   start   usec timestamp of the transaction start
+ */
+void sx126x_trace_trx(sx126x_spi_trx_t* p_trx, uint32_t start);
+
+/**
+ * @brief   adds a busy wait to the last recorded transaction
+ */
+void sx126x_trace_busy(uint32_t usec);
+
+void sx126x_trace_set(bool enable, bool clear);
+
+/**
+ * @brief   moves the oldest records out of the ring into \a buf with the trace
+ *          header
+ * @param   p_count     the moved records count
+ * @param   p_dropped   the records overwritten before being read since the
+ *                      previous read
+ * @return  the written bytes count, zero if \a size can not hold the header
+ */
+uint32_t sx126x_trace_read(uint8_t* buf, uint32_t size, uint32_t* p_count,
+    uint32_t* p_dropped);
+
+/**
+ * @brief   displays the records in the ring with the commands and registers
+ *          names, without removing them
+ */
+void sx126x_trace_print(void);
+
+/* --- end of file ---------------------------------------------------------- */
+#ifdef __cplusplus
+}
+#endif
+#endif /* __SX126X_TRACE_H__ */
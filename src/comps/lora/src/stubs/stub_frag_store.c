@@ -0,0 +1,102 @@
+/** -------------------------------------------------------------------------- *
+ * Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ * @author  Ahmed Sabry (SG Wireless)
+ * 
+ * @brief   This file defines the stub of the fragmented data block store
+ *          ports, the ports are optional and a disconnected port fails.
+ * --------------------------------------------------------------------------- *
+ */
+
+/* --- includes ------------------------------------------------------------- */
+
+#include <stdlib.h>
+
+#define __log_subsystem     lora
+#define __log_component     stub_frag_store
+#include "log_lib.h"
+
+#include "lora_port.h"
+#include "stub_frag_store.h"
+
+/** -------------------------------------------------------------------------- *
+ * fragmented data block store stub definitions
+ * --------------------------------------------------------------------------- *
+ */
+
+static lora_port_frag_store_open_t  * p_frag_store_open;
+static lora_port_frag_store_erase_t * p_frag_store_erase;
+static lora_port_frag_store_write_t * p_frag_store_write;
+static lora_port_frag_store_read_t  * p_frag_store_read;
+static lora_port_frag_store_close_t * p_frag_store_close;
+
+void lora_stub_frag_store_init(void * p_init_params)
+{
+    __log_info("ctor() -> intialize lora frag store stub");
+    lora_port_params_t * ptr = p_init_params;
+    p_frag_store_open  = ptr->frag_store_open;
+    p_frag_store_erase = ptr->frag_store_erase;
+    p_frag_store_write = ptr->frag_store_write;
+    p_frag_store_read  = ptr->frag_store_read;
+    p_frag_store_close = ptr->frag_store_close;
+}
+
+int lora_stub_frag_store_open(uint32_t* p_size, uint32_t* p_sector_size)
+{
+    if(p_frag_store_open)
+        return p_frag_store_open(p_size, p_sector_size);
+    __log_warn("port "__red__"frag_store_open"__default__" disconnected");
+    return -1;
+}
+
+int lora_stub_frag_store_erase(uint32_t offset, uint32_t size)
+{
+    if(p_frag_store_erase)
+        return p_frag_store_erase(offset, size);
+    __log_warn("port "__red__"frag_store_erase"__default__" disconnected");
+    return -1;
+}
+
+int lora_stub_frag_store_write(uint32_t offset, uint8_t* buf, uint32_t size)
+{
+    if(p_frag_store_write)
+        return p_frag_store_write(offset, buf, size);
+    __log_warn("port "__red__"frag_store_write"__default__" disconnected");
+    return -1;
+}
+
+int lora_stub_frag_store_read(uint32_t offset, uint8_t* buf, uint32_t size)
+{
+    if(p_frag_store_read)
+        return p_frag_store_read(offset, buf, size);
+    __log_warn("port "__red__"frag_store_read"__default__" disconnected");
+    return -1;
+}
+
+int lora_stub_frag_store_close(bool is_complete, uint32_t size)
+{
+    if(p_frag_store_close)
+        return p_frag_store_close(is_complete, size);
+    __log_warn("port "__red__"frag_store_close"__default__" disconnected");
+    return -1;
+}
+
+/* --- end of file ---------------------------------------------------------- */
@@ -0,0 +1,52 @@
+/** -------------------------------------------------------------------------- *
+ * Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ * @author  Ahmed Sabry (SG Wireless)
+ * 
+ * @brief   This file declares the stub of the fragmented data block store
+ *          ports.
+ * --------------------------------------------------------------------------- *
+ */
+
+#ifndef __STUB_FRAG_STORE_H__
+#define __STUB_FRAG_STORE_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --- includes ------------------------------------------------------------- */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+void lora_stub_frag_store_init(void* p_init_params);
+
+int lora_stub_frag_store_open(uint32_t* p_size, uint32_t* p_sector_size);
+int lora_stub_frag_store_erase(uint32_t offset, uint32_t size);
+int lora_stub_frag_store_write(uint32_t offset, uint8_t* buf, uint32_t size);
+int lora_stub_frag_store_read(uint32_t offset, uint8_t* buf, uint32_t size);
+int lora_stub_frag_store_close(bool is_complete, uint32_t size);
+
+/* --- end of file ---------------------------------------------------------- */
+#ifdef __cplusplus
+}
+#endif
+#endif /* __STUB_FRAG_STORE_H__ */
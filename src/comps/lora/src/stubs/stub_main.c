@@ -36,6 +36,7 @@
 #include "stub_nvm.h"
 #include "stub_timers.h"
 #include "stub_system.h"
+#include "stub_frag_store.h"
 
 /** -------------------------------------------------------------------------- *
  * lora stack port init
@@ -47,6 +48,7 @@ void lora_port_init(lora_port_params_t * p_init_params)
     lora_stub_nvm_init(p_init_params);
     lora_stub_timers_init(p_init_params);
     lora_stub_system_init(p_init_params);
+    lora_stub_frag_store_init(p_init_params);
 }
 
 /* --- end of file ---------------------------------------------------------- */
@@ -54,7 +54,9 @@ static lora_port_mutex_unlock_t     * p_mutex_unlock;
 static lora_port_sem_new_t          * p_sem_new;
 static lora_port_sem_wait_t         * p_sem_wait;
 static lora_port_sem_signal_t       * p_sem_signal;
+static lora_port_sem_wait_timeout_t * p_sem_wait_timeout;
 static lora_port_crc32_calc_t       * p_crc32_calc;
+static lora_port_get_timestamp_us_t * p_get_timestamp_usec;
 
 void lora_stub_system_init(void* p_init_params)
 {
@@ -69,7 +71,9 @@ void lora_stub_system_init(void* p_init_params)
     p_sem_new               = ptr->sem_new;
     p_sem_wait              = ptr->sem_wait;
     p_sem_signal            = ptr->sem_signal;
+    p_sem_wait_timeout      = ptr->sem_wait_timeout;
     p_crc32_calc            = ptr->crc32_calc;
+    p_get_timestamp_usec    = ptr->get_timestamp_usec;
 }
 
 TimerTime_t TimerGetCurrentTime( void )
@@ -283,9 +287,27 @@ void lora_stub_sem_signal(void* handle)
         p_sem_signal(handle);
 }
 
+bool lora_stub_sem_wait_timeout(void* handle, uint32_t ms)
+{
+    if(p_sem_wait_timeout)
+        return p_sem_wait_timeout(handle, ms);
+
+    /* without a timed wait port, the caller re-checks after a short delay */
+    DelayMs( ms < 10 ? ms : 10 );
+    return false;
+}
+
 uint32_t lora_stub_get_timestamp_ms(void)
 {
     return TimerGetCurrentTime();
 }
 
+uint32_t lora_stub_get_timestamp_us(void)
+{
+    if(p_get_timestamp_usec)
+        return p_get_timestamp_usec();
+    else
+        return TimerGetCurrentTime() * 1000U;
+}
+
 /* --- end of file ---------------------------------------------------------- */
@@ -35,6 +35,7 @@ extern "C" {
 /* --- includes ------------------------------------------------------------- */
 
 #include <stdint.h>
+#include <stdbool.h>
 
 void lora_stub_system_init(void* p_init_params);
 
@@ -48,10 +49,16 @@ void* lora_stub_sem_new(void);
 void lora_stub_sem_wait(void* handle);
 void lora_stub_sem_signal(void* handle);
 
+/* it returns false if the semaphore is not signaled within the timeout */
+bool lora_stub_sem_wait_timeout(void* handle, uint32_t ms);
+
 uint32_t lora_stub_crc32(uint32_t initial, void* buf, uint32_t len);
 
 uint32_t lora_stub_get_timestamp_ms(void);
 
+/* it falls back to the msec timestamp if the port has no usec clock */
+uint32_t lora_stub_get_timestamp_us(void);
+
 /* --- end of file ---------------------------------------------------------- */
 #ifdef __cplusplus
 }
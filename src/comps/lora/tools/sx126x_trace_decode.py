@@ -0,0 +1,142 @@
+# ---------------------------------------------------------------------------- #
+# Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files(the “Software”), to deal
+# in the Software without restriction, including without limitation the rights
+# to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+# copies  of  the  Software,  and  to  permit  persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+# IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+# AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+# Author    Ahmed Sabry (SG Wireless)
+#
+# Details   This script decodes the binary radio spi trace returned by
+#           lora.spi_trace_dump(). The commands and registers names are taken
+#           from the same tables the driver inspector uses, so the decoded
+#           trace reads as the driver logs.
+# ---------------------------------------------------------------------------- #
+
+# --- imports ---------------------------------------------------------------- #
+
+import sys
+import re
+import struct
+from pathlib import Path
+
+# --- trace format (sx126x_trace.h) ------------------------------------------ #
+
+trace_magic       = b'SXT'
+trace_version     = 1
+trace_header      = struct.Struct('<3sBBBH')
+trace_record      = struct.Struct('<IHHBBB5s')
+
+flag_read         = 1 << 0
+flag_address      = 1 << 1
+flag_truncated    = 1 << 2
+
+drivers_dir = Path(__file__).resolve().parent.parent / 'src' / 'stubs' / 'drivers'
+
+# --- commands and registers names ------------------------------------------- #
+# the names are the ones listed in the driver inspector tables, their values
+# are read from the sx126x definitions header
+
+def load_names():
+    defs = (drivers_dir / 'sx126x_defs.h').read_text()
+    inspector = (drivers_dir / 'driver_inspector.c').read_text()
+
+    values = {}
+    for m in re.finditer(r'#define\s+(__sx126x_\w+)\s+(0x[0-9a-fA-F]+|\d+)\s',
+            defs):
+        values[m.group(1)] = int(m.group(2), 0)
+
+    cmds = {}
+    for name in re.findall(r'__init_lora_cmd_desc\(\s*(__sx126x_cmd_\w+)',
+            inspector):
+        if name in values:
+            cmds[values[name]] = name
+
+    regs = {}
+    for name in re.findall(r'__init_lora_reg_desc\(\s*(__sx126x_reg_\w+)',
+            inspector):
+        if name in values:
+            regs[values[name]] = name
+
+    return cmds, regs
+
+# the hopping table registers are 16 blocks of 6 registers each
+hop_table_base = 0x0388
+hop_table_regs = ['nb_symbols_r0', 'nb_symbols_r1',
+                  'freq_r0', 'freq_r1', 'freq_r2', 'freq_r3']
+
+def reg_name(regs, addr):
+    if hop_table_base <= addr < hop_table_base + 16 * 6:
+        idx, rank = divmod(addr - hop_table_base, 6)
+        return '__sx126x_reg_{}({})'.format(hop_table_regs[rank], idx)
+    return regs.get(addr, 'unknown lora reg')
+
+# --- decoding --------------------------------------------------------------- #
+
+def decode(data):
+    cmds, regs = load_names()
+    offset = 0
+    first_ts = None
+
+    print('{:>10} {:>6} {} {:<40} {:>4} {:>4} {}'.format(
+        'usec', 'busy', 'd', 'command', 'addr', 'len', 'data'))
+
+    # a file may hold several dumps appended one after the other
+    while offset + trace_header.size <= len(data):
+        magic, version, rec_size, _, count = \
+            trace_header.unpack_from(data, offset)
+        if magic != trace_magic or version != trace_version or \
+                rec_size != trace_record.size:
+            print('error: invalid trace header at offset {}'.format(offset))
+            return 1
+        offset += trace_header.size
+
+        for _ in range(count):
+            if offset + trace_record.size > len(data):
+                print('error: truncated trace at offset {}'.format(offset))
+                return 1
+            ts, busy, addr, cmd, flags, length, payload = \
+                trace_record.unpack_from(data, offset)
+            offset += trace_record.size
+
+            if first_ts is None:
+                first_ts = ts
+            name = cmds.get(cmd, 'unknown lora cmd')
+            shown = payload[:min(length, len(payload))]
+            reg = ''
+            if name in ('__sx126x_cmd_write_register',
+                        '__sx126x_cmd_read_register'):
+                reg = ' ' + reg_name(regs, addr)
+
+            print('{:>10} {:>6} {} {:<40} {:04x} {:>4}{} {}{}'.format(
+                (ts - first_ts) & 0xFFFFFFFF, busy,
+                'R' if flags & flag_read else 'W', name,
+                addr if flags & flag_address else 0, length,
+                '+' if flags & flag_truncated else ' ',
+                ' '.join('{:02x}'.format(b) for b in shown), reg))
+
+    return 0
+
+# --- main ------------------------------------------------------------------- #
+
+if __name__ == '__main__':
+    if len(sys.argv) != 2:
+        print('   ---> python {} <trace-file>'.format(Path(sys.argv[0]).name))
+        exit(1)
+    exit(decode(Path(sys.argv[1]).read_bytes()))
+
+# --- end of file ------------------------------------------------------------ #
@@ -0,0 +1,318 @@
+/** -------------------------------------------------------------------------- *
+ * Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @author  Ahmed Sabry (SG Wireless)
+ *
+ * @brief   host test of the lora fragments store on a file backed flash
+ *          partition. A data block is encoded as the LoRaWAN fragmentation
+ *          data fragments and the parity fragments of the spec matrix, a
+ *          part of them is lost and the others are decoded by a decoder
+ *          working as the stack one: all its data rows are written and read
+ *          through the store callbacks, only the parity coefficients are in
+ *          ram. The test checks the recovered partition content, the block
+ *          crc and that the flash is never programmed without an erase.
+ * --------------------------------------------------------------------------- *
+ */
+
+/* --- includes ------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "log_lib.h"
+#include "utils_hosttest.h"
+#include "utils_math.h"
+#include "stub_system.h"
+#include "lora_frag_store.h"
+#include "lora_frag_store_mock.h"
+
+/* --- test helpers --------------------------------------------------------- */
+
+static uint32_t s_prng;
+
+static uint32_t prng(void)
+{
+    s_prng = s_prng * 1103515245u + 12345u;
+    return s_prng >> 8;
+}
+
+/* --- fragmentation matrix (LoRaWAN fragmented data block transport) ------- */
+
+#define __partition_file    "build/lora_frag_store/frag-store.bin"
+#define __partition_size    (128 * 1024)
+#define __sector_size       (4096)
+#define __frag_size         (200)
+#define __max_frags         (__partition_size / __frag_size)
+
+static uint32_t prbs23(uint32_t x)
+{
+    uint32_t b0 = x & 1;
+    uint32_t b1 = (x & 32) >> 5;
+    return (x >> 1) + ((b0 ^ b1) << 22);
+}
+
+/* the parity fragment \a n (from 1) coefficients line over \a m fragments */
+static void matrix_line(uint32_t n, uint32_t m, uint8_t* line)
+{
+    uint32_t mod = m + ((m & (m - 1)) == 0 ? 1 : 0);
+    uint32_t x = 1 + 1001 * n;
+    uint32_t coefs = 0;
+    uint32_t r;
+
+    memset(line, 0, __div_ceiling(m, 8));
+    while(coefs < (m >> 1)) {
+        r = 1 << 16;
+        while(r >= m) {
+            x = prbs23(x);
+            r = x % mod;
+        }
+        line[r / 8] |= 1 << (r % 8);
+        ++ coefs;
+    }
+}
+
+#define __bit(line, i)      ( ( (line)[(i) / 8] >> ((i) % 8) ) & 1 )
+
+static void xor_buf(uint8_t* dst, const uint8_t* src, uint32_t size)
+{
+    while(size --)
+        *dst ++ ^= *src ++;
+}
+
+/* --- decoder on the store callbacks --------------------------------------- */
+
+static struct {
+    uint32_t    frags;
+    uint8_t     received[__div_ceiling(__max_frags, 8)];
+    uint32_t    missing;
+    uint32_t    pivots;
+    uint8_t*    lines[__max_frags]; /**< reduced parity lines by pivot */
+    bool        is_done;
+} s_dec;
+
+static void decoder_init(uint32_t frags)
+{
+    uint8_t erased = 0xFF;
+    uint32_t i;
+
+    memset(&s_dec, 0, sizeof(s_dec));
+    s_dec.frags = frags;
+
+    // -- as the stack decoder, the block is initialized byte by byte
+    for(i = 0; i < frags * __frag_size; ++i)
+        lora_frag_store_write(i, &erased, 1);
+}
+
+static void decoder_free(void)
+{
+    uint32_t i;
+    for(i = 0; i < s_dec.frags; ++i)
+        free(s_dec.lines[i]);
+}
+
+static void row_read(uint32_t idx, uint8_t* row)
+{
+    __check(lora_frag_store_read(idx * __frag_size, row, __frag_size) == 0,
+        "read row %u", idx);
+}
+
+static void row_write(uint32_t idx, uint8_t* row)
+{
+    __check(lora_frag_store_write(idx * __frag_size, row, __frag_size) == 0,
+        "write row %u", idx);
+}
+
+static void decoder_solve(void)
+{
+    uint8_t row[__frag_size];
+    uint8_t other[__frag_size];
+    uint32_t i;
+    uint32_t j;
+
+    // -- back substitution from the last pivot, the rows are rewritten
+    for(i = s_dec.frags; i -- > 0; ) {
+        if(s_dec.lines[i] == NULL)
+            continue;
+        row_read(i, row);
+        for(j = i + 1; j < s_dec.frags; ++j) {
+            if(__bit(s_dec.lines[i], j)) {
+                row_read(j, other);
+                xor_buf(row, other, __frag_size);
+            }
+        }
+        row_write(i, row);
+    }
+    s_dec.is_done = true;
+}
+
+static void decoder_data(uint32_t idx, uint8_t* data)
+{
+    row_write(idx, data);
+    s_dec.received[idx / 8] |= 1 << (idx % 8);
+}
+
+static void decoder_parity(uint32_t n, uint8_t* data)
+{
+    uint8_t line[__div_ceiling(__max_frags, 8)];
+    uint8_t row[__frag_size];
+    uint8_t other[__frag_size];
+    uint32_t i;
+
+    if(s_dec.is_done)
+        return;
+    if(s_dec.pivots == 0) {
+        for(i = 0; i < s_dec.frags; ++i)
+            s_dec.missing += ! __bit(s_dec.received, i);
+    }
+
+    matrix_line(n, s_dec.frags, line);
+    memcpy(row, data, __frag_size);
+
+    // -- the received fragments are removed first
+    for(i = 0; i < s_dec.frags; ++i) {
+        if(__bit(line, i) && __bit(s_dec.received, i)) {
+            row_read(i, other);
+            xor_buf(row, other, __frag_size);
+            line[i / 8] &= ~(1 << (i % 8));
+        }
+    }
+
+    // -- then the missing ones by the pivots, which have only missing ones
+    for(i = 0; i < s_dec.frags; ++i) {
+        if( ! __bit(line, i) )
+            continue;
+        if(s_dec.lines[i] == NULL) {
+            // -- a new pivot, its line has no lower missing fragment
+            s_dec.lines[i] = malloc(sizeof(line));
+            memcpy(s_dec.lines[i], line, sizeof(line));
+            row_write(i, row);
+            if(++ s_dec.pivots == s_dec.missing)
+                decoder_solve();
+            return;
+        }
+        xor_buf(line, s_dec.lines[i], sizeof(line));
+        row_read(i, other);
+        xor_buf(row, other, __frag_size);
+    }
+}
+
+/* --- test cases ----------------------------------------------------------- */
+
+/* sends a block with the given losses and redundancy, returns if accepted */
+static bool run_block(uint32_t size, uint32_t loss_pct, uint32_t redundancy_pct,
+    uint8_t stale_fill, uint32_t seed)
+{
+    uint32_t frags = __div_ceiling(size, __frag_size);
+    uint32_t parities = frags * redundancy_pct / 100;
+    uint8_t* image = calloc(frags, __frag_size);
+    uint8_t* flash = malloc(size);
+    uint8_t line[__div_ceiling(__max_frags, 8)];
+    uint8_t parity[__frag_size];
+    lora_frag_store_stats_t stats;
+    lora_frag_store_mock_stats_t mock_stats;
+    uint32_t lost = 0;
+    uint32_t i;
+    uint32_t j;
+    bool is_accepted;
+
+    printf("-- block of %u bytes, %u fragments, %u%% lost, %u parities\n",
+        size, frags, loss_pct, parities);
+
+    s_prng = seed;
+    for(i = 0; i < size; ++i)
+        image[i] = prng();
+
+    lora_frag_store_mock_reset(__partition_file, __partition_size,
+        __sector_size, stale_fill);
+
+    decoder_init(frags);
+    for(i = 0; i < frags; ++i) {
+        if(prng() % 100 < loss_pct) {
+            ++ lost;
+            continue;
+        }
+        decoder_data(i, image + i * __frag_size);
+    }
+    for(i = 1; i <= parities && ! s_dec.is_done; ++i) {
+        if(prng() % 100 < loss_pct)
+            continue;
+        matrix_line(i, frags, line);
+        memset(parity, 0, sizeof(parity));
+        for(j = 0; j < frags; ++j) {
+            if(__bit(line, j))
+                xor_buf(parity, image + j * __frag_size, __frag_size);
+        }
+        decoder_parity(i, parity);
+    }
+    if(lost == 0)
+        s_dec.is_done = true;
+
+    is_accepted = lora_frag_store_close(s_dec.is_done, size);
+    lora_frag_store_get_stats(&stats);
+    lora_frag_store_mock_get_stats(&mock_stats);
+
+    printf("  %-34s: %5u of %u\n", "lost data fragments", lost, frags);
+    printf("  %-34s: %5u pivots\n", "recovered", s_dec.pivots);
+    printf("  %-34s: %5u writes %5u rewrites %4u erases\n", "store",
+        stats.writes, stats.rewrites, stats.sector_erases);
+    printf("  %-34s: %5u bytes\n", "ram of the store", stats.ram_bytes);
+
+    __check(mock_stats.violations == 0, "%u writes without erase",
+        mock_stats.violations);
+    __check(mock_stats.closes == 1, "closes %u", mock_stats.closes);
+    __check(mock_stats.is_complete == is_accepted, "port close state");
+    __check(stats.ram_bytes <= 16, "ram %u bytes", stats.ram_bytes);
+
+    if(is_accepted) {
+        lora_frag_store_mock_dump(0, flash, size);
+        __check(memcmp(flash, image, size) == 0, "partition content");
+        __check(stats.image_crc == lora_stub_crc32(0, image, size),
+            "block crc %08x", stats.image_crc);
+        __check(stats.sector_erases <=
+            __div_ceiling(frags * __frag_size, __sector_size) + stats.rewrites,
+            "erases %u", stats.sector_erases);
+    }
+
+    decoder_free();
+    free(image);
+    free(flash);
+    return is_accepted;
+}
+
+int main(int argc, char** argv)
+{
+    (void) argc; (void) argv;
+
+    log_init(NULL);
+    log_filter_subsystem("lora", false);
+
+    __check(run_block(64 * 1024, 0, 0, 0x00, 1), "lossless block");
+    __check(run_block(96 * 1024 + 123, 10, 25, 0x5A, 2), "lossy block");
+    __check(run_block(__frag_size * __max_frags, 5, 15, 0xFF, 3), "full block");
+    __check( ! run_block(32 * 1024, 40, 20, 0x00, 4), "too lossy block");
+
+    return hosttest_result();
+}
+
+/* --- end of file ---------------------------------------------------------- */
@@ -0,0 +1,184 @@
+/** -------------------------------------------------------------------------- *
+ * Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @author  Ahmed Sabry (SG Wireless)
+ *
+ * @brief   mock file backed flash partition behind the lora fragments store
+ *          stub functions.
+ * --------------------------------------------------------------------------- *
+ */
+
+/* --- includes ------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "stub_frag_store.h"
+#include "stub_system.h"
+#include "lora_frag_store_mock.h"
+
+/* --- mock partition state ------------------------------------------------- */
+
+static struct {
+    FILE*       file;
+    uint32_t    size;
+    uint32_t    sector_size;
+    lora_frag_store_mock_stats_t stats;
+} s_mock;
+
+static void file_io(uint32_t offset, uint8_t* buf, uint32_t size, bool is_write)
+{
+    size_t done;
+
+    fseek(s_mock.file, offset, SEEK_SET);
+    done = is_write ? fwrite(buf, 1, size, s_mock.file) :
+                      fread(buf, 1, size, s_mock.file);
+    if(done != size) {
+        printf("  mock partition: i/o error at %u\n", offset);
+        exit(2);
+    }
+}
+
+/* --- lora fragments store stub -------------------------------------------- */
+
+void lora_stub_frag_store_init(void* p_init_params)
+{
+    (void) p_init_params;
+}
+
+int lora_stub_frag_store_open(uint32_t* p_size, uint32_t* p_sector_size)
+{
+    if(s_mock.file == NULL)
+        return -1;
+    *p_size = s_mock.size;
+    *p_sector_size = s_mock.sector_size;
+    return 0;
+}
+
+int lora_stub_frag_store_erase(uint32_t offset, uint32_t size)
+{
+    uint8_t* buf;
+
+    if(offset % s_mock.sector_size || size % s_mock.sector_size ||
+        offset + size > s_mock.size)
+        return -1;
+
+    buf = malloc(size);
+    memset(buf, 0xFF, size);
+    file_io(offset, buf, size, true);
+    free(buf);
+    s_mock.stats.erases += size / s_mock.sector_size;
+    return 0;
+}
+
+int lora_stub_frag_store_write(uint32_t offset, uint8_t* buf, uint32_t size)
+{
+    uint8_t* current;
+    uint32_t i;
+
+    if(offset + size > s_mock.size)
+        return -1;
+
+    current = malloc(size);
+    file_io(offset, current, size, false);
+    for(i = 0; i < size; ++i) {
+        if(buf[i] & ~current[i]) {
+            ++ s_mock.stats.violations;
+            break;
+        }
+    }
+    for(i = 0; i < size; ++i)
+        current[i] &= buf[i];
+    file_io(offset, current, size, true);
+    free(current);
+    ++ s_mock.stats.writes;
+    return 0;
+}
+
+int lora_stub_frag_store_read(uint32_t offset, uint8_t* buf, uint32_t size)
+{
+    if(offset + size > s_mock.size)
+        return -1;
+    file_io(offset, buf, size, false);
+    return 0;
+}
+
+int lora_stub_frag_store_close(bool is_complete, uint32_t size)
+{
+    ++ s_mock.stats.closes;
+    s_mock.stats.is_complete = is_complete;
+    s_mock.stats.block_size = size;
+    fflush(s_mock.file);
+    return 0;
+}
+
+uint32_t lora_stub_crc32(uint32_t initial, void* buf, uint32_t len)
+{
+    uint8_t* p = buf;
+    uint32_t crc = ~initial;
+    int k;
+
+    while(len --) {
+        crc ^= *p ++;
+        for(k = 0; k < 8; ++k)
+            crc = (crc >> 1) ^ (0xEDB88320u & (0 - (crc & 1)));
+    }
+    return ~crc;
+}
+
+/* --- APIs ----------------------------------------------------------------- */
+
+void lora_frag_store_mock_reset(const char* path, uint32_t size,
+    uint32_t sector_size, uint8_t fill)
+{
+    uint8_t* buf;
+
+    if(s_mock.file)
+        fclose(s_mock.file);
+    memset(&s_mock, 0, sizeof(s_mock));
+
+    s_mock.file = fopen(path, "w+b");
+    if(s_mock.file == NULL) {
+        printf("  mock partition: can not create %s\n", path);
+        exit(2);
+    }
+    s_mock.size = size;
+    s_mock.sector_size = sector_size;
+
+    buf = malloc(size);
+    memset(buf, fill, size);
+    file_io(0, buf, size, true);
+    free(buf);
+}
+
+void lora_frag_store_mock_dump(uint32_t offset, uint8_t* buf, uint32_t size)
+{
+    fflush(s_mock.file);
+    file_io(offset, buf, size, false);
+}
+
+void lora_frag_store_mock_get_stats(lora_frag_store_mock_stats_t* p_stats)
+{
+    *p_stats = s_mock.stats;
+}
+
+/* --- end of file ---------------------------------------------------------- */
@@ -0,0 +1,73 @@
+/** -------------------------------------------------------------------------- *
+ * Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @author  Ahmed Sabry (SG Wireless)
+ *
+ * @brief   mock flash partition behind the lora fragments store stub
+ *          functions. It is a file backed NOR flash: an erase sets the
+ *          sectors bytes to 0xFF and a write can only clear bits, a write
+ *          that would set a bit is accounted as a violation.
+ * --------------------------------------------------------------------------- *
+ */
+#ifndef __LORA_FRAG_STORE_MOCK_H__
+#define __LORA_FRAG_STORE_MOCK_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --- includes ------------------------------------------------------------- */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* --- typedefs ------------------------------------------------------------- */
+
+typedef struct {
+    uint32_t    erases;         /**< erased sectors */
+    uint32_t    writes;         /**< write operations */
+    uint32_t    violations;     /**< writes setting bits of a programmed byte */
+    uint32_t    closes;         /**< closed blocks */
+    bool        is_complete;    /**< the last closed block state */
+    uint32_t    block_size;     /**< the last closed block size */
+} lora_frag_store_mock_stats_t;
+
+/* --- api declarations ----------------------------------------------------- */
+
+/**
+ * @brief   creates the partition file of \a size bytes filled with \a fill
+ *          as a flash with a stale content, and clears the stats
+ */
+void lora_frag_store_mock_reset(const char* path, uint32_t size,
+    uint32_t sector_size, uint8_t fill);
+
+/**
+ * @brief   reads back the partition file content
+ */
+void lora_frag_store_mock_dump(uint32_t offset, uint8_t* buf, uint32_t size);
+
+void lora_frag_store_mock_get_stats(lora_frag_store_mock_stats_t* p_stats);
+
+/* --- end of file ---------------------------------------------------------- */
+#ifdef __cplusplus
+}
+#endif
+#endif /* __LORA_FRAG_STORE_MOCK_H__ */
@@ -0,0 +1,351 @@
+/** -------------------------------------------------------------------------- *
+ * Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @author  Ahmed Sabry (SG Wireless)
+ *
+ * @brief   host test of the lora nvm journal on a mock nvm storage. It
+ *          commits a sequence of MAC context like changes and cuts the power
+ *          at every nvm write of the sequence, then checks that the restored
+ *          image is always one of the committed images and that the journal
+ *          keeps working after the restore. It also runs the frame counters
+ *          commit policy of the MAC context under power cuts and checks that
+ *          no frame counter is reused after the restore.
+ * --------------------------------------------------------------------------- *
+ */
+
+/* --- includes ------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "log_lib.h"
+#include "utils_hosttest.h"
+#include "lora_nvm_journal.h"
+#include "lora_nvm_mock.h"
+
+/* --- test helpers --------------------------------------------------------- */
+
+static uint32_t s_prng;
+
+static uint32_t prng(void)
+{
+    s_prng = s_prng * 1103515245u + 12345u;
+    return s_prng >> 8;
+}
+
+/* --- journal under test --------------------------------------------------- */
+
+#define __image_size        (600)
+#define __slot_size         (64)
+#define __slots             (4)
+#define __commits           (40)
+
+static uint8_t s_image[__image_size];
+static uint8_t s_shadow[__lora_nvm_journal_shadow_size(__image_size)];
+static uint8_t s_slot_buf[__slot_size];
+static lora_nvm_journal_t s_journal;
+
+/* the committed images sequence, the image 0 is the initial snapshot */
+static uint8_t s_states[__commits + 1][__image_size];
+
+static void journal_boot(void)
+{
+    memset(&s_journal, 0, sizeof(s_journal));
+    memset(s_image, 0, sizeof(s_image));
+    s_journal.name = "tst";
+    s_journal.image = s_image;
+    s_journal.shadow = s_shadow;
+    s_journal.size = __image_size;
+    s_journal.slot_buf = s_slot_buf;
+    s_journal.slot_size = __slot_size;
+    s_journal.slots = __slots;
+    lora_nvm_journal_init(&s_journal);
+}
+
+/* a frame counter change mostly, with some larger changes on the way */
+static void change_apply(uint8_t* image, uint32_t idx)
+{
+    uint32_t i;
+    uint32_t n;
+
+    s_prng = idx;
+    ++ *(uint32_t*)image;
+    if( idx % 7 == 0 ) {
+        n = 1 + prng() % 6;
+        for(i = 0; i < n; ++i)
+            image[prng() % __image_size] = prng();
+    }
+    if( idx % 13 == 0 ) {
+        // -- does not fit in one journal slot
+        for(i = 0; i < 200; ++i)
+            image[100 + i] = prng();
+    }
+}
+
+static void states_generate(void)
+{
+    uint32_t k;
+
+    memset(s_states[0], 0, __image_size);
+    for(k = 1; k <= __commits; ++k) {
+        memcpy(s_states[k], s_states[k - 1], __image_size);
+        change_apply(s_states[k], k);
+    }
+}
+
+/* runs the commits sequence, returns the last commit fully stored */
+static int commits_run(uint32_t from, uint32_t to)
+{
+    int durable = lora_nvm_mock_is_cut() ? -1 : from - 1;
+    uint32_t k;
+
+    for(k = from; k <= to; ++k) {
+        change_apply(s_image, k);
+        lora_nvm_journal_commit(&s_journal);
+        if( ! lora_nvm_mock_is_cut() )
+            durable = k;
+    }
+    return durable;
+}
+
+static int state_of_image(void)
+{
+    int k;
+    for(k = __commits; k >= 0; --k) {
+        if( memcmp(s_image, s_states[k], __image_size) == 0 )
+            return k;
+    }
+    return -1;
+}
+
+/* --- tests ---------------------------------------------------------------- */
+
+static uint32_t test_no_cut(void)
+{
+    lora_nvm_mock_stats_t stats;
+    uint32_t full_bytes;
+
+    printf("-- commits without power cut\n");
+
+    lora_nvm_mock_reset();
+    journal_boot();
+    __check(lora_nvm_journal_restore(&s_journal) == false,
+        "restore of an empty nvm");
+    lora_nvm_journal_compact(&s_journal);
+    commits_run(1, __commits);
+    __check(state_of_image() == __commits, "working image");
+    __check(lora_nvm_journal_commit(&s_journal) == false,
+        "commit without changes");
+
+    lora_nvm_mock_get_stats(&stats);
+    full_bytes = (__commits + 1) * __image_size;
+    printf("  %-34s: %5u writes %6u bytes\n", "journaled commits",
+        stats.writes, stats.bytes);
+    printf("  %-34s: %5u writes %6u bytes\n", "full image commits",
+        __commits + 1, full_bytes);
+    printf("  %-34s: %5u records %4u snapshots\n", "journal",
+        s_journal.stats.slot_writes, s_journal.stats.snapshots);
+    __check(stats.bytes * 2 < full_bytes, "written bytes %u", stats.bytes);
+
+    journal_boot();
+    __check(lora_nvm_journal_restore(&s_journal), "restore");
+    __check(state_of_image() == __commits, "restored image");
+    __check(lora_nvm_journal_is_dirty(&s_journal) == false, "dirty restore");
+
+    return stats.writes;
+}
+
+static void test_power_cuts(uint32_t writes)
+{
+    uint32_t cut;
+    uint32_t torn;
+    int durable;
+    int restored;
+    bool is_restored;
+    uint32_t replayed = 0;
+
+    printf("-- power cut at every write of %u writes\n", writes);
+
+    for(cut = 0; cut < writes; ++cut)
+    {
+        s_prng = 0x5eed + cut;
+        torn = prng() % (__image_size + __lora_nvm_journal_tail_size);
+
+        lora_nvm_mock_reset();
+        lora_nvm_mock_set_power_cut(cut, torn);
+
+        journal_boot();
+        lora_nvm_journal_restore(&s_journal);
+        lora_nvm_journal_compact(&s_journal);
+        durable = commits_run(1, __commits);
+
+        // -- reboot, the commit in progress at the cut may be lost or not
+        lora_nvm_mock_reboot();
+        journal_boot();
+        is_restored = lora_nvm_journal_restore(&s_journal);
+        restored = is_restored ? state_of_image() : -1;
+        replayed += s_journal.stats.replayed;
+
+        __check(restored == durable || restored == durable + 1,
+            "cut at write %u (torn %u): restored %d, durable %d",
+            cut, torn, restored, durable);
+        if( restored < 0 ) {
+            lora_nvm_journal_compact(&s_journal);
+            restored = 0;
+        }
+
+        // -- the journal continues after the restored commit
+        if( restored < __commits ) {
+            commits_run(restored + 1, __commits);
+            journal_boot();
+            __check(lora_nvm_journal_restore(&s_journal) &&
+                state_of_image() == __commits,
+                "cut at write %u: commits after the restore", cut);
+        }
+    }
+    printf("  %-34s: %5u\n", "replayed records", replayed);
+}
+
+/* the uplink counter is written behind, committed after at most __fcnt_gap
+ * uplinks, and the downlink counter is committed on every accepted downlink,
+ * as the lora-wan mac context does */
+#define __fcnt_gap          (4)
+#define __fcnt_events       (60)
+
+static void test_fcnt_power_cuts(void)
+{
+    uint32_t* p_fcnt_up = (uint32_t*)&s_image[0];
+    uint32_t* p_fcnt_down = (uint32_t*)&s_image[4];
+    uint32_t cut;
+    uint32_t torn;
+    uint32_t k;
+    uint32_t pending;
+    uint32_t up_used;
+    uint32_t down_durable;
+    uint32_t resumed;
+    uint32_t lost_uplinks = 0;
+    bool is_restored;
+
+    printf("-- frame counters at every power cut\n");
+
+    for(cut = 0; ; ++cut)
+    {
+        s_prng = 0xfc47 + cut;
+        torn = prng() % (__image_size + __lora_nvm_journal_tail_size);
+
+        lora_nvm_mock_reset();
+        lora_nvm_mock_set_power_cut(cut, torn);
+
+        journal_boot();
+        lora_nvm_journal_restore(&s_journal);
+        lora_nvm_journal_compact(&s_journal);
+
+        up_used = 0;
+        down_durable = 0;
+        pending = 0;
+        for(k = 0; k < __fcnt_events && ! lora_nvm_mock_is_cut(); ++k)
+        {
+            if( prng() % 4 ) {
+                up_used = ++ *p_fcnt_up;
+                if( ++ pending == __fcnt_gap ) {
+                    lora_nvm_journal_commit(&s_journal);
+                    pending = 0;
+                }
+            } else {
+                *p_fcnt_down += 1 + prng() % 3;
+                lora_nvm_journal_commit(&s_journal);
+                pending = 0;
+                if( ! lora_nvm_mock_is_cut() )
+                    down_durable = *p_fcnt_down;
+            }
+        }
+        if( ! lora_nvm_mock_is_cut() ) {
+            // -- the cut is after the last write of the sequence
+            break;
+        }
+
+        lora_nvm_mock_reboot();
+        journal_boot();
+        is_restored = lora_nvm_journal_restore(&s_journal);
+        if( *p_fcnt_up < up_used )
+            lost_uplinks += up_used - *p_fcnt_up;
+
+        // -- the next uplink is sent with the resumed counter plus one
+        resumed = lora_nvm_journal_counter_resume(*p_fcnt_up, __fcnt_gap);
+        __check(resumed >= up_used,
+            "cut at write %u: fcnt-up resumed at %u, used up to %u",
+            cut, resumed, up_used);
+        __check(*p_fcnt_down >= down_durable,
+            "cut at write %u: fcnt-down restored %u, accepted %u",
+            cut, *p_fcnt_down, down_durable);
+        __check(is_restored || up_used == 0,
+            "cut at write %u: no restore", cut);
+    }
+    printf("  %-34s: %5u\n", "power cuts", cut);
+    printf("  %-34s: %5u\n", "uplinks lost by the cuts", lost_uplinks);
+
+    // -- the cuts must hit the write-behind, or the test checks nothing
+    __check(lost_uplinks > 0, "no uplink lost by the cuts");
+    __check(lora_nvm_journal_counter_resume(UINT32_MAX - 1, __fcnt_gap) ==
+        UINT32_MAX, "fcnt-up resume saturation");
+}
+
+static void test_clear(void)
+{
+    lora_nvm_mock_stats_t stats;
+
+    printf("-- clear\n");
+
+    lora_nvm_mock_reset();
+    journal_boot();
+    lora_nvm_journal_compact(&s_journal);
+    commits_run(1, 10);
+    lora_nvm_journal_clear(&s_journal);
+
+    journal_boot();
+    __check(lora_nvm_journal_restore(&s_journal) == false, "restore");
+    lora_nvm_mock_get_stats(&stats);
+    __check(stats.clears > 0, "no cleared records");
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t writes;
+
+    (void) argc; (void) argv;
+
+    log_init(NULL);
+    log_filter_subsystem("lora", false);
+
+    states_generate();
+
+    writes = test_no_cut();
+    test_power_cuts(writes);
+    test_fcnt_power_cuts();
+    test_clear();
+
+    return hosttest_result();
+}
+
+/* --- end of file ---------------------------------------------------------- */
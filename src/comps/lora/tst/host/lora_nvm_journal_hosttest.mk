@@ -0,0 +1,50 @@
+# ---------------------------------------------------------------------------- #
+# Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files(the “Software”), to deal
+# in the Software without restriction, including without limitation the rights
+# to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+# copies  of  the  Software,  and  to  permit  persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+# IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+# AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+# Author    Ahmed Sabry (SG Wireless)
+#
+# Desc      This file contains the host build of the lora nvm journal test on
+#           a mock nvm storage with power cuts injection.
+#
+# usage     make -f lora_nvm_journal_hosttest.mk [clean|build|test]
+# ---------------------------------------------------------------------------- #
+
+# --- test description ------------------------------------------------------ #
+hosttest_name := lora_nvm_journal
+
+lora_dir := ../..
+libs_dir := ../../../../libs
+drv_dir  := ../../../../drivers
+
+hosttest_srcs := lora_nvm_journal_host_main.c lora_nvm_mock.c \
+                 lora_nvm_journal.c
+hosttest_vpath := ${lora_dir}/src/lora_utils
+hosttest_incs :=                \
+    ${lora_dir}/src/lora_utils  \
+    ${lora_dir}/src/stubs
+hosttest_logs :=                                \
+    ${drv_dir}/common/logs_defs.h               \
+    ${lora_dir}/inc/logs_defs.h                 \
+    ${lora_dir}/src/lora_utils/lora_nvm_journal.c
+
+include ${libs_dir}/utils/utils_hosttest.mk
+
+# --- end of file ------------------------------------------------------------ #
@@ -0,0 +1,212 @@
+/** -------------------------------------------------------------------------- *
+ * Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @author  Ahmed Sabry (SG Wireless)
+ *
+ * @brief   mock key-value nvm storage behind the lora nvm stub functions.
+ *          As the esp nvs, a load succeeds only with the stored record size.
+ * --------------------------------------------------------------------------- *
+ */
+
+/* --- includes ------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "stub_nvm.h"
+#include "stub_system.h"
+#include "lora_nvm_mock.h"
+
+/* --- mock storage state --------------------------------------------------- */
+
+#define __mock_max_records      (128)
+#define __mock_key_len          (16)
+
+typedef struct {
+    char        key[__mock_key_len];
+    uint8_t*    data;
+    uint32_t    len;
+} mock_record_t;
+
+static struct {
+    mock_record_t           records[__mock_max_records];
+    bool                    cut_armed;
+    bool                    is_cut;
+    uint32_t                cut_write;
+    uint32_t                torn_bytes;
+    uint32_t                write_idx;
+    lora_nvm_mock_stats_t   stats;
+} s_mock;
+
+static mock_record_t* record_find(const char* key)
+{
+    int i;
+    for(i = 0; i < __mock_max_records; ++i) {
+        if(s_mock.records[i].data && strcmp(s_mock.records[i].key, key) == 0)
+            return &s_mock.records[i];
+    }
+    return NULL;
+}
+
+static mock_record_t* record_new(const char* key, uint32_t len)
+{
+    int i;
+    for(i = 0; i < __mock_max_records; ++i) {
+        if(s_mock.records[i].data == NULL) {
+            snprintf(s_mock.records[i].key, __mock_key_len, "%s", key);
+            s_mock.records[i].data = calloc(1, len);
+            s_mock.records[i].len = len;
+            return &s_mock.records[i];
+        }
+    }
+    printf("  mock nvm: no free records\n");
+    exit(2);
+}
+
+static void record_free(mock_record_t* p_rec)
+{
+    free(p_rec->data);
+    p_rec->data = NULL;
+    p_rec->len = 0;
+}
+
+/* --- lora nvm stub -------------------------------------------------------- */
+
+void lora_stub_nvm_init(void* p_init_params)
+{
+    (void) p_init_params;
+}
+
+bool lora_stub_nvm_check(const char* key)
+{
+    return record_find(key) != NULL;
+}
+
+void lora_stub_nvm_load(const char* key, void* buf, uint32_t length)
+{
+    mock_record_t* p_rec = record_find(key);
+    if(p_rec && p_rec->len == length)
+        memcpy(buf, p_rec->data, length);
+}
+
+void lora_stub_nvm_store(const char* key, void* buf, uint32_t length)
+{
+    mock_record_t* p_rec;
+    uint32_t written = length;
+
+    if(s_mock.is_cut)
+        return;
+
+    if(s_mock.cut_armed && s_mock.write_idx == s_mock.cut_write) {
+        s_mock.is_cut = true;
+        written = s_mock.torn_bytes < length ? s_mock.torn_bytes : length;
+    }
+    ++ s_mock.write_idx;
+    ++ s_mock.stats.writes;
+    s_mock.stats.bytes += length;
+
+    p_rec = record_find(key);
+    if(p_rec && p_rec->len != length) {
+        record_free(p_rec);
+        p_rec = NULL;
+    }
+    if(p_rec == NULL) {
+        // -- a torn new record is left erased after the written part
+        p_rec = record_new(key, length);
+        memset(p_rec->data, 0xFF, length);
+    }
+    memcpy(p_rec->data, buf, written);
+}
+
+void lora_stub_nvm_clear(const char* key)
+{
+    mock_record_t* p_rec;
+
+    if(s_mock.is_cut)
+        return;
+
+    p_rec = record_find(key);
+    if(p_rec) {
+        record_free(p_rec);
+        ++ s_mock.stats.clears;
+    }
+}
+
+void lora_stub_nvm_sync(void)
+{
+}
+
+uint32_t lora_stub_crc32(uint32_t initial, void* buf, uint32_t len)
+{
+    uint8_t* p = buf;
+    uint32_t crc = ~initial;
+    int k;
+
+    while(len --) {
+        crc ^= *p ++;
+        for(k = 0; k < 8; ++k)
+            crc = (crc >> 1) ^ (0xEDB88320u & (0 - (crc & 1)));
+    }
+    return ~crc;
+}
+
+/* --- APIs ----------------------------------------------------------------- */
+
+void lora_nvm_mock_reset(void)
+{
+    int i;
+    for(i = 0; i < __mock_max_records; ++i) {
+        if(s_mock.records[i].data)
+            record_free(&s_mock.records[i]);
+    }
+    s_mock.cut_armed = false;
+    s_mock.is_cut = false;
+    s_mock.write_idx = 0;
+    memset(&s_mock.stats, 0, sizeof(s_mock.stats));
+}
+
+void lora_nvm_mock_set_power_cut(uint32_t write, uint32_t torn_bytes)
+{
+    s_mock.cut_armed = true;
+    s_mock.is_cut = false;
+    s_mock.cut_write = write;
+    s_mock.torn_bytes = torn_bytes;
+    s_mock.write_idx = 0;
+}
+
+bool lora_nvm_mock_is_cut(void)
+{
+    return s_mock.is_cut;
+}
+
+void lora_nvm_mock_reboot(void)
+{
+    s_mock.cut_armed = false;
+    s_mock.is_cut = false;
+}
+
+void lora_nvm_mock_get_stats(lora_nvm_mock_stats_t* p_stats)
+{
+    *p_stats = s_mock.stats;
+}
+
+/* --- end of file ---------------------------------------------------------- */
@@ -0,0 +1,76 @@
+/** -------------------------------------------------------------------------- *
+ * Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @author  Ahmed Sabry (SG Wireless)
+ *
+ * @brief   mock key-value nvm storage behind the lora nvm stub functions. It
+ *          keeps the records in ram across the simulated reboots and injects
+ *          a power cut at a given write: that write is torn and all the later
+ *          writes are lost.
+ * --------------------------------------------------------------------------- *
+ */
+#ifndef __LORA_NVM_MOCK_H__
+#define __LORA_NVM_MOCK_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --- includes ------------------------------------------------------------- */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* --- typedefs ------------------------------------------------------------- */
+
+typedef struct {
+    uint32_t    writes;     /**< records stores */
+    uint32_t    bytes;      /**< bytes of the records stores */
+    uint32_t    clears;     /**< records clears */
+} lora_nvm_mock_stats_t;
+
+/* --- api declarations ----------------------------------------------------- */
+
+/**
+ * @brief   erases all the records, disarms the power cut and clears the stats
+ */
+void lora_nvm_mock_reset(void);
+
+/**
+ * @brief   arms a power cut at the write number \a write (counted from 0 after
+ *          this call), only the first \a torn_bytes of it reach the storage
+ */
+void lora_nvm_mock_set_power_cut(uint32_t write, uint32_t torn_bytes);
+
+/**
+ * @brief   checks if the armed power cut happened, the reboot disarms it and
+ *          the storage accepts the writes again
+ */
+bool lora_nvm_mock_is_cut(void);
+void lora_nvm_mock_reboot(void);
+
+void lora_nvm_mock_get_stats(lora_nvm_mock_stats_t* p_stats);
+
+/* --- end of file ---------------------------------------------------------- */
+#ifdef __cplusplus
+}
+#endif
+#endif /* __LORA_NVM_MOCK_H__ */
@@ -31,6 +31,7 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 #include "pcal6408a.h"
 
 #define __log_subsystem     drivers
@@ -141,6 +142,8 @@ static struct _ioexp_port_pin_config_s {
 
     uint32_t is_active      : 1;    // to mark this pin is in active mode
 
+    uint32_t is_priority    : 1;    // its handler is called before the others
+
     pcal6408a_pin_interrupt_handler_t  p_interrupt_handler;
 
     const char*  name;              // user name for debugging purposes
@@ -155,10 +158,36 @@ static bool s_is_output_open_drain_enabled = false;
 
 static pcal6408a_i2c_read_port_t s_p_i2c_read;
 static pcal6408a_i2c_write_port_t s_p_i2c_write;
+static pcal6408a_i2c_write_read_port_t s_p_i2c_write_read;
+static pcal6408a_time_us_port_t s_p_get_time_us;
 
 static uint8_t s_addr_pin_logic_level = 0;
 #define __ioexp_address     (uint8_t)( 0x20u | (s_addr_pin_logic_level) )
 
+/**
+ * § the device keeps the last command byte as the register pointer, the
+ *   following reads without a new command return the same register. The
+ *   pointer is tracked to not resend the command byte on repeated reads such
+ *   as polling the input port.
+ */
+#define __ioexp_reg_pointer_unknown     (0xffu)
+static uint8_t s_reg_pointer = __ioexp_reg_pointer_unknown;
+
+// -- the input port value of its last read, refreshed by the interrupts
+static uint8_t s_input_snapshot;
+static bool s_input_snapshot_valid;
+
+// -- the open batches depth, a batch is not owned by a caller so the callers
+//    keep the driver access serialized from its begin to its end
+static uint8_t s_batch_depth;
+
+static pcal6408a_i2c_stats_t s_i2c_stats;
+
+// -- the pins whose interrupt handlers are called first
+static uint8_t s_priority_pins;
+
+static pcal6408a_latency_stats_t s_latency_stats[__ioexp_port_pins_counts];
+
 /* --------------------------------------------------------------------------- *
  * local functions declarations
  * --------------------------------------------------------------------------- *
@@ -167,6 +196,7 @@ static struct _ioexp_port_pin_config_s* get_pin_config_from_handle(
                 pcal6408a_port_pin_handle handle );
 static uint8_t ioexp_read_reg(ioexp_reg_addr_et reg);
 static void ioexp_write_reg(ioexp_reg_addr_et reg, uint8_t value);
+static uint8_t ioexp_bus_read(uint8_t reg);
 static bool ioexp_read_pin_val(ioexp_reg_addr_et reg, uint8_t pin);
 static void ioexp_write_pin_val(ioexp_reg_addr_et reg, uint8_t pin, bool value);
 static uint8_t drive_strength_read(uint8_t pin_num);
@@ -188,10 +218,15 @@ pcal6408a_error_t pcal6408a_init(pcal6408a_init_config_t * p_init_struct)
     // store the i2c r/w methods
     s_p_i2c_read = p_init_struct->i2c_read;
     s_p_i2c_write = p_init_struct->i2c_write;
+    s_p_i2c_write_read = p_init_struct->i2c_write_read;
+    s_p_get_time_us = p_init_struct->get_time_us;
 
     // set the logic level of the addr pin
     s_addr_pin_logic_level = p_init_struct->is_addr_pin_connected_to_vdd;
 
+    // nothing is known yet about the device registers
+    pcal6408a_sync();
+
     // load the current values from the PCAL6408A registers
     #define __read_reg(_r) \
         uint8_t _r =  ioexp_read_reg(__concat(__ioexp_reg_, _r))
@@ -205,10 +240,15 @@ pcal6408a_error_t pcal6408a_init(pcal6408a_init_config_t * p_init_struct)
     __read_reg(interrupt_mask);
     #undef __read_reg
 
+    // the output port is loaded too to have the output writes not preceded
+    // by their register read
+    (void) ioexp_read_reg(__ioexp_reg_output_port);
+
     uint16_t drv_strength = ((uint16_t)output_drive_strength_1 << 8) |
         (uint16_t)output_drive_strength_0;
 
     int i;
+    s_priority_pins = 0;
     p_cfg = s_ioexp_port_pins_config;
     for(i = 0; i < __ioexp_port_pins_counts; ++i)
     {
@@ -221,6 +261,7 @@ pcal6408a_error_t pcal6408a_init(pcal6408a_init_config_t * p_init_struct)
         p_cfg->pull_selection = __bitwise_bit_get(8, pull_up_down_selection, i);
 
         p_cfg->is_active     = 0;
+        p_cfg->is_priority   = 0;
         p_cfg->p_interrupt_handler = NULL;
         ++ p_cfg;
     }
@@ -260,15 +301,29 @@ void pcal6408a_reset(void)
     #undef __reset_reg
 }
 
-void pcal6408a_interrupt_trigger_port(void)
+static void interrupt_latency_account(uint8_t pin, uint32_t isr_time_us)
 {
-    __log_debug("interrupt triggered");
-    // -- read the interrupt status register
-    uint8_t int_status = ioexp_read_reg( __ioexp_reg_interrupt_status );
+    static const uint32_t bounds[] = __pcal6408a_latency_bounds_us;
+    pcal6408a_latency_stats_t * p_stats = &s_latency_stats[pin];
+    uint32_t latency;
+    int i;
 
-    // -- read the input register
-    uint8_t input_values = ioexp_read_reg( __ioexp_reg_input_port );
+    if( s_p_get_time_us == NULL )
+        return;
 
+    latency = s_p_get_time_us() - isr_time_us;
+
+    for(i = 0; i < __pcal6408a_latency_buckets - 1 && latency > bounds[i]; ++i);
+    ++ p_stats->hist[i];
+    ++ p_stats->count;
+    p_stats->sum_us += latency;
+    if( latency > p_stats->max_us )
+        p_stats->max_us = latency;
+}
+
+static void interrupt_dispatch_pins(uint8_t pins, uint8_t input_values,
+    uint32_t isr_time_us)
+{
     // -- § loop for all initialized port pins pin
     //    § call the configured handler to the responsible compoent
     int pins_count = __ioexp_port_pins_counts;
@@ -276,7 +331,7 @@ void pcal6408a_interrupt_trigger_port(void)
     struct _ioexp_port_pin_config_s *p_pin_config = s_ioexp_port_pins_config;
     while( pins_count -- )
     {
-        if(mask & int_status)
+        if(mask & pins)
         {
             __log_assert(p_pin_config->is_configured,
                 "non-configured ioexp pin interrupt");
@@ -290,16 +345,83 @@ void pcal6408a_interrupt_trigger_port(void)
 
             if( p_pin_config->p_interrupt_handler )
             {
-                // __log_enforce("- h irq");
+                interrupt_latency_account(
+                    p_pin_config - s_ioexp_port_pins_config, isr_time_us);
                 p_pin_config->p_interrupt_handler( (input_values & mask) != 0 );
             }
         }
         mask <<= 1u;
         ++ p_pin_config;
     }
+}
+
+void pcal6408a_interrupt_trigger_port(void)
+{
+    pcal6408a_interrupt_dispatch(s_p_get_time_us ? s_p_get_time_us() : 0);
+}
+
+void pcal6408a_interrupt_dispatch(uint32_t isr_time_us)
+{
+    __log_debug("interrupt triggered");
+    // -- read the interrupt status register
+    uint8_t int_status = ioexp_read_reg( __ioexp_reg_interrupt_status );
+    if( int_status == 0 )
+    {
+        // -- the input returned to its initial state before being read and
+        //    the interrupt is already cleared
+        __log_debug("interrupt triggered -- no source");
+        return;
+    }
+
+    // -- read the input register, it clears the interrupt and refreshes the
+    //    input snapshot
+    uint8_t input_values = ioexp_read_reg( __ioexp_reg_input_port );
+
+    // -- the priority pins handlers go first
+    interrupt_dispatch_pins(int_status & s_priority_pins, input_values,
+        isr_time_us);
+    interrupt_dispatch_pins(int_status & ~s_priority_pins, input_values,
+        isr_time_us);
+
     __log_debug("interrupt triggered -- DONE!!");
 }
 
+pcal6408a_error_t pcal6408a_set_pin_priority(
+    pcal6408a_port_pin_handle   handle,
+    bool is_priority
+    )
+{
+    struct _ioexp_port_pin_config_s * p_pin_config = 
+        get_pin_config_from_handle(handle);
+    if( ! p_pin_config )
+        return __pcal6408a_bad_handle;
+    if( ! p_pin_config->is_configured )
+        return __pcal6408a_non_initialized_handle;
+
+    uint8_t pin_num = p_pin_config - s_ioexp_port_pins_config;
+
+    p_pin_config->is_priority = is_priority;
+    if( is_priority )
+        __bitwise_bit_set(8, s_priority_pins, pin_num);
+    else
+        __bitwise_bit_clr(8, s_priority_pins, pin_num);
+
+    return __pcal6408a_ok;
+}
+
+void pcal6408a_get_latency_stats(
+    pcal6408a_port_pin_t        pin_num,
+    pcal6408a_latency_stats_t * p_stats
+    )
+{
+    if( pin_num >= __ioexp_port_pins_counts )
+    {
+        memset(p_stats, 0, sizeof(*p_stats));
+        return;
+    }
+    *p_stats = s_latency_stats[pin_num];
+}
+
 static pcal6408a_port_pin_handle pcal6408a_configure_io_pin(
     bool                        is_input,
     pcal6408a_port_pin_t        pin_num,  // 0 ~ 7
@@ -584,6 +706,31 @@ pcal6408a_error_t pcal6408a_write(
     return __pcal6408a_ok;
 }
 
+pcal6408a_error_t pcal6408a_read_snapshot(
+    pcal6408a_port_pin_handle   handle,
+    bool * p_read_logic_level
+    )
+{
+    struct _ioexp_port_pin_config_s * p_pin_config = 
+        get_pin_config_from_handle(handle);
+    if( ! p_pin_config )
+        return __pcal6408a_bad_handle;
+    if( ! p_pin_config->is_configured )
+        return __pcal6408a_non_initialized_handle;
+    if( ! p_pin_config->is_active )
+        return __pcal6408a_pin_inactive;
+
+    // -- the output pins and the inputs without a snapshot are read as usual
+    if( ! p_pin_config->io_selection || ! s_input_snapshot_valid )
+        return pcal6408a_read(handle, p_read_logic_level);
+
+    uint8_t pin_num = p_pin_config - s_ioexp_port_pins_config;
+
+    *p_read_logic_level = __bitwise_bit_get(8, s_input_snapshot, pin_num);
+
+    return __pcal6408a_ok;
+}
+
 void pcal6408a_config_open_drain_output(bool enable)
 {
     s_is_output_open_drain_enabled = enable;
@@ -633,30 +780,89 @@ static void drive_strength_write(uint8_t pin_num, uint8_t val)
  */
 #if __enable_pcal6408a_cache
 /**
- * § This array represents a cache for the ioexpander registers to save i2c
- *   read and write cycle for configuration registers
+ * § This array represents a write-through shadow of the ioexpander registers
+ *   to save i2c read and write cycle for configuration registers
  * § the register __ioexp_reg_input_port and __ioexp_reg_interrupt_status
  *   are excluded from the cache and always read when requested.
+ * § while a batch is open, the writes are kept as pending values and are
+ *   written to the device at the batch end, one write per changed register
+ *   in the order of their first update.
  */
 static struct _reg_cache_s {
     const char* reg_name;
     uint8_t addr;
     uint8_t valid;
     uint8_t cache_value;
+    uint8_t pending;
+    uint8_t pending_value;
 } s_reg_cache[] = {
-    {"output_port",             __ioexp_reg_output_port,             false, 0},
-    {"polarity_inversion",      __ioexp_reg_polarity_inversion,      false, 0},
-    {"configuration",           __ioexp_reg_configuration,           false, 0},
-    {"output_drive_strength_0", __ioexp_reg_output_drive_strength_0, false, 0},
-    {"output_drive_strength_1", __ioexp_reg_output_drive_strength_1, false, 0},
-    {"input_latch",             __ioexp_reg_input_latch,             false, 0},
-    {"pull_up_down_enable",     __ioexp_reg_pull_up_down_enable,     false, 0},
-    {"pull_up_down_selection",  __ioexp_reg_pull_up_down_selection,  false, 0},
-    {"interrupt_mask",          __ioexp_reg_interrupt_mask,          false, 0},
-    {"output_port_config",      __ioexp_reg_output_port_config,      false, 0},
+    {"output_port",             __ioexp_reg_output_port,             0,0,0,0},
+    {"polarity_inversion",      __ioexp_reg_polarity_inversion,      0,0,0,0},
+    {"configuration",           __ioexp_reg_configuration,           0,0,0,0},
+    {"output_drive_strength_0", __ioexp_reg_output_drive_strength_0, 0,0,0,0},
+    {"output_drive_strength_1", __ioexp_reg_output_drive_strength_1, 0,0,0,0},
+    {"input_latch",             __ioexp_reg_input_latch,             0,0,0,0},
+    {"pull_up_down_enable",     __ioexp_reg_pull_up_down_enable,     0,0,0,0},
+    {"pull_up_down_selection",  __ioexp_reg_pull_up_down_selection,  0,0,0,0},
+    {"interrupt_mask",          __ioexp_reg_interrupt_mask,          0,0,0,0},
+    {"output_port_config",      __ioexp_reg_output_port_config,      0,0,0,0},
 };
+#define __reg_cache_size    (sizeof(s_reg_cache)/sizeof(s_reg_cache[0]))
+
+static uint8_t s_batch_order[__reg_cache_size];
+static uint8_t s_batch_count;
 #endif
 
+static uint8_t ioexp_bus_read(uint8_t reg)
+{
+    uint8_t value = reg;
+
+    if( s_reg_pointer != reg && s_p_i2c_write_read )
+    {
+        // -- the command byte and the read in one bus transaction
+        uint8_t cmd = reg;
+        s_p_i2c_write_read(__ioexp_address, &cmd, 1, &value, 1);
+        s_reg_pointer = reg;
+        ++ s_i2c_stats.reads;
+        goto read_done;
+    }
+
+    if( s_reg_pointer != reg )
+    {
+        /* perform a write cycle on the i2c bus to identify on the device
+         * which register is to be read in the next cycle */
+        s_p_i2c_write(__ioexp_address, &value, 1);
+        s_reg_pointer = reg;
+        ++ s_i2c_stats.writes;
+    }
+    else
+    {
+        ++ s_i2c_stats.skipped_cmds;
+    }
+
+    /* perform a read cycle on the i2c bus to get the required reg value */
+    value = 0;
+    s_p_i2c_read(__ioexp_address, &value, 1);
+    ++ s_i2c_stats.reads;
+
+    read_done:
+    if( reg == __ioexp_reg_input_port )
+    {
+        s_input_snapshot = value;
+        s_input_snapshot_valid = true;
+    }
+    return value;
+}
+
+static void ioexp_bus_write(uint8_t reg, uint8_t value)
+{
+    uint8_t buff [] = { reg, value };
+
+    s_p_i2c_write(__ioexp_address, buff, 2);
+    s_reg_pointer = reg;
+    ++ s_i2c_stats.writes;
+}
+
 static bool ioexp_read_pin_val(ioexp_reg_addr_et reg, uint8_t pin)
 {
     uint8_t reg_val = ioexp_read_reg(reg);
@@ -677,80 +883,95 @@ static void ioexp_write_pin_val(ioexp_reg_addr_et reg, uint8_t pin, bool value)
 
         ioexp_write_reg(reg, reg_value);
     }
+    else
+    {
+        ++ s_i2c_stats.skipped_writes;
+    }
 }
 
-#define __ioexp_read_reg(_reg, u8_var)                                  \
-    do {                                                                \
-        /* perform a write cycle on the i2c bus to identify on the */   \
-        /* device which register is to be read in the next cycle */     \
-        u8_var = _reg;                                                  \
-        s_p_i2c_write(__ioexp_address, &u8_var, 1);                     \
-        /* perform a read cycle on the i2c bus to get the required */   \
-        /* device reg value */                                          \
-        u8_var = 0;                                                     \
-        s_p_i2c_read(__ioexp_address, &u8_var, 1);                      \
-    } while(0)
+#if __enable_pcal6408a_cache
+static struct _reg_cache_s* reg_cache_get(uint8_t reg)
+{
+    struct _reg_cache_s* p_cache = s_reg_cache;
+    int i;
+    for(i = 0; i < __reg_cache_size; ++i, ++p_cache)
+    {
+        if(p_cache->addr == reg)
+            return p_cache;
+    }
+    return NULL;
+}
 
-static uint8_t ioexp_read_reg(ioexp_reg_addr_et reg)
+static void reg_cache_write(struct _reg_cache_s* p_cache, uint8_t value)
 {
-    #if __enable_pcal6408a_cache
+    if( p_cache->valid && p_cache->cache_value == value )
+    {
+        // the current reg value equals the required value
+        // hence no need to update the reg value
+        ++ s_i2c_stats.skipped_writes;
+        return;
+    }
+
+    __log_debug("-->i2c write[addr:%02x, val:%02x] "__yellow__"%s",
+        p_cache->addr, value, p_cache->reg_name);
+
+    ioexp_bus_write(p_cache->addr, value);
+
+    p_cache->cache_value = value;
+    p_cache->valid = true;
+}
+#endif
 
+static uint8_t ioexp_read_reg(ioexp_reg_addr_et reg)
+{
     uint8_t reg_value;
 
+    #if __enable_pcal6408a_cache
+
     if(reg == __ioexp_reg_input_port || reg == __ioexp_reg_interrupt_status)
     {
-        __ioexp_read_reg(reg, reg_value);
+        reg_value = ioexp_bus_read(reg);
         __log_debug("-->i2c read [addr:%02x, val:%02x] "__yellow__"%s",
             reg, reg_value,
             reg == __ioexp_reg_input_port ? "input port" : "interrupt status");
         return reg_value;
     }
 
-    struct _reg_cache_s* p_cache = s_reg_cache;
-    int i;
-    for(i = 0; i < sizeof(s_reg_cache)/sizeof(s_reg_cache[0]); ++i, ++p_cache)
+    struct _reg_cache_s* p_cache = reg_cache_get(reg);
+    if( p_cache == NULL )
     {
-        if(p_cache->addr == reg)
-        {
-            // -- input port and interrupt are always invalid,
-            //    shall be read every time
-            if(!p_cache->valid || reg == __ioexp_reg_input_port ||
-                reg == __ioexp_reg_interrupt_status)
-            {
-                __ioexp_read_reg(reg, reg_value);
+        __log_error("invalid ioexp reg address: %02x", reg);
+        return 0;
+    }
 
-                // update cache valid bit and value
-                p_cache->valid = true;
-                p_cache->cache_value = reg_value;
+    // -- a value waiting for the batch end is the latest one
+    if( p_cache->pending )
+        return p_cache->pending_value;
 
-                __log_debug("-->i2c read [addr:%02x, val:%02x] "__yellow__"%s",
-                    reg, reg_value, p_cache->reg_name);
-            }
-            else if(p_cache->valid)
-            {
-                reg_value = p_cache->cache_value;
-            }
+    if( ! p_cache->valid )
+    {
+        reg_value = ioexp_bus_read(reg);
 
-            return reg_value;
-        }
+        // update cache valid bit and value
+        p_cache->valid = true;
+        p_cache->cache_value = reg_value;
+
+        __log_debug("-->i2c read [addr:%02x, val:%02x] "__yellow__"%s",
+            reg, reg_value, p_cache->reg_name);
     }
 
-    __log_error("invalid ioexp reg address: %02x", reg);
-    return 0;
+    return p_cache->cache_value;
 
     #else
 
-    uint8_t reg_val;
-    __ioexp_read_reg(reg, reg_val);
-    return reg_val;
+    reg_value = ioexp_bus_read(reg);
+    return reg_value;
 
     #endif
 }
 
 static void ioexp_write_reg(ioexp_reg_addr_et reg, uint8_t value)
 {
-    uint8_t buff [] = { reg, value };
-
     #if __enable_pcal6408a_cache
 
     if(reg == __ioexp_reg_input_port || reg == __ioexp_reg_interrupt_status)
@@ -758,44 +979,83 @@ static void ioexp_write_reg(ioexp_reg_addr_et reg, uint8_t value)
         __log_debug("-->i2c write[addr:%02x, val:%02x] "__yellow__"%s",
             reg, value,
             reg == __ioexp_reg_input_port ? "input port" : "interrupt status");
-        s_p_i2c_write(__ioexp_address, buff, 2);
+        ioexp_bus_write(reg, value);
         return;
     }
 
     // locate the cache reference of this register
-    struct _reg_cache_s* p_cache = s_reg_cache;
-    int i;
-    for(i = 0; i < sizeof(s_reg_cache)/sizeof(s_reg_cache[0]); ++i, ++p_cache)
+    struct _reg_cache_s* p_cache = reg_cache_get(reg);
+    if( p_cache == NULL )
     {
-        if(p_cache->addr == reg)
+        __log_error("invalid ioexp reg address: %02x", reg);
+        return;
+    }
+
+    if( s_batch_depth )
+    {
+        if( p_cache->pending )
         {
-            if( p_cache->valid && p_cache->cache_value == value )
-            {
-                // the current reg value equals the required value
-                // hence no need to update the reg value
-                return;
-            }
-            goto start_write;
+            ++ s_i2c_stats.merged_writes;
+        }
+        else
+        {
+            p_cache->pending = true;
+            s_batch_order[s_batch_count ++] = p_cache - s_reg_cache;
         }
+        p_cache->pending_value = value;
+        return;
     }
-    __log_error("invalid ioexp reg address: %02x", reg);
-    return;
 
-    start_write:
+    reg_cache_write(p_cache, value);
 
-    __log_debug("-->i2c write[addr:%02x, val:%02x] "__yellow__"%s",
-        reg, value, p_cache->reg_name);
+    #else
+
+    ioexp_bus_write(reg, value);
 
     #endif
+}
 
-    s_p_i2c_write(__ioexp_address, buff, 2);
+void pcal6408a_batch_begin(void)
+{
+    ++ s_batch_depth;
+}
+
+void pcal6408a_batch_end(void)
+{
+    if( s_batch_depth == 0 || -- s_batch_depth )
+        return;
 
     #if __enable_pcal6408a_cache
-    p_cache->cache_value = value;
-    p_cache->valid = true;
+    int i;
+    for(i = 0; i < s_batch_count; ++i)
+    {
+        struct _reg_cache_s* p_cache = &s_reg_cache[s_batch_order[i]];
+        p_cache->pending = false;
+        reg_cache_write(p_cache, p_cache->pending_value);
+    }
+    s_batch_count = 0;
     #endif
 }
 
+void pcal6408a_sync(void)
+{
+    __log_info("drop the registers shadow and pointer");
+
+    s_reg_pointer = __ioexp_reg_pointer_unknown;
+    s_input_snapshot_valid = false;
+
+    #if __enable_pcal6408a_cache
+    int i;
+    for(i = 0; i < __reg_cache_size; ++i)
+        s_reg_cache[i].valid = false;
+    #endif
+}
+
+void pcal6408a_get_i2c_stats(pcal6408a_i2c_stats_t * p_stats)
+{
+    *p_stats = s_i2c_stats;
+}
+
 /* --------------------------------------------------------------------------- *
  * debug and stats methods
  * --------------------------------------------------------------------------- *
@@ -826,7 +1086,7 @@ static void pcal6408a_cache_validate(void)
     __log_output("\n");
 
     int i;
-    for(i = 0; i < sizeof(s_reg_cache)/sizeof(s_reg_cache[0]); ++i, ++p_cache)
+    for(i = 0; i < __reg_cache_size; ++i, ++p_cache)
     {
         if(p_cache->addr == __ioexp_reg_input_port ||
             p_cache->addr == __ioexp_reg_interrupt_status)
@@ -834,8 +1094,7 @@ static void pcal6408a_cache_validate(void)
             /* cache values for those two registers are ignored */
             continue;
         }
-        uint8_t read_value;
-        __ioexp_read_reg(p_cache->addr, read_value);
+        uint8_t read_value = ioexp_bus_read(p_cache->addr);
 
         __log_output(__blue__"%-"__stringify(__w_reg_name)"s"__default__,
             p_cache->reg_name);
@@ -894,6 +1153,31 @@ void pcal6408a_stats(void)
     __log_output("output ports configuration: "__yellow__"%s\n",
         s_is_output_open_drain_enabled ? "open-drain" : "push-pull");
 
+    __log_output_header("i2c transactions", __cap_w, '=');
+    __log_output("reads: %u, writes: %u\n",
+        s_i2c_stats.reads, s_i2c_stats.writes);
+    __log_output("skipped writes: %u, merged writes: %u, skipped commands: %u\n",
+        s_i2c_stats.skipped_writes, s_i2c_stats.merged_writes,
+        s_i2c_stats.skipped_cmds);
+
+    __log_output_header("interrupts latency (usec)", __cap_w, '=');
+    __log_output("pin count  mean   max    "
+        "<100 <250 <500 <1ms <2.5 <5ms <10 >10ms\n");
+    const pcal6408a_latency_stats_t* p_lat = s_latency_stats;
+    for(i = 0; i < __ioexp_port_pins_counts; ++i, ++p_lat)
+    {
+        if( p_lat->count == 0 )
+            continue;
+        __log_output("(%d) %-6u %-6u %-6u", i, p_lat->count,
+            (uint32_t)(p_lat->sum_us / p_lat->count), p_lat->max_us);
+        int j;
+        for(j = 0; j < __pcal6408a_latency_buckets; ++j)
+            __log_output(" %-4u", p_lat->hist[j]);
+        __log_output(" "__cyan__"%s"__default__"\n",
+            s_ioexp_port_pins_config[i].name ?
+            s_ioexp_port_pins_config[i].name : "");
+    }
+
     #if __enable_pcal6408a_cache
     __log_output_header("current ioexp cache contents", __cap_w, '=');
     pcal6408a_cache_validate();
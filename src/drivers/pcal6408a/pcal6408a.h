@@ -35,6 +35,7 @@ extern "C" {
 /* --- includes ------------------------------------------------------------- */
 
 #include <stdint.h>
+#include <stdbool.h>
 
 /* --- typedefs ------------------------------------------------------------- */
 
@@ -76,6 +77,24 @@ typedef void (* pcal6408a_i2c_read_port_t )
 typedef void (* pcal6408a_i2c_write_port_t )
     (uint8_t dev_addr, uint8_t* buff, uint32_t cbytes);
 
+/**
+ * @typedef pcal6408a_i2c_write_read_port_t
+ * @brief   optional driver i2c combined port, it writes \a wbuff then reads
+ *          \a rbuff in one bus transaction with a repeated start. If it is
+ *          not provided, the registers reads are a write then a read
+ *          transactions.
+ */
+typedef void (* pcal6408a_i2c_write_read_port_t )
+    (uint8_t dev_addr, uint8_t* wbuff, uint32_t wbytes,
+     uint8_t* rbuff, uint32_t rbytes);
+
+/**
+ * @typedef pcal6408a_time_us_port_t
+ * @brief   optional free running microseconds clock port, it is used to
+ *          measure the interrupts dispatch latency
+ */
+typedef uint32_t (* pcal6408a_time_us_port_t )(void);
+
 /**
  * @typedef pcal6408a_pin_interrupt_handler_t
  * @brief   the callback function prototype that will be called if an interrupt
@@ -96,9 +115,44 @@ typedef struct {
     // plugins
     pcal6408a_i2c_read_port_t   i2c_read;   /**< i2c read port */
     pcal6408a_i2c_write_port_t  i2c_write;  /**< i2c write port */
+    pcal6408a_i2c_write_read_port_t i2c_write_read; /**< optional i2c
+                                                         combined port */
+    pcal6408a_time_us_port_t    get_time_us;    /**< optional clock port */
 
 } pcal6408a_init_config_t;
 
+/**
+ * @struct  pcal6408a_i2c_stats_t
+ * @brief   the i2c bus transactions accounting of the driver
+ */
+typedef struct {
+    uint32_t    reads;          /**< read transactions */
+    uint32_t    writes;         /**< write transactions, including the command
+                                     bytes preceding the reads */
+    uint32_t    skipped_writes; /**< writes of values already in the device */
+    uint32_t    merged_writes;  /**< writes merged into a pending batch write */
+    uint32_t    skipped_cmds;   /**< reads on the already pointed register */
+} pcal6408a_i2c_stats_t;
+
+/**
+ * the interrupt dispatch latency histogram buckets upper bounds in usec,
+ * the last bucket counts the latencies above the last bound
+ */
+#define __pcal6408a_latency_bounds_us   {100, 250, 500, 1000, 2500, 5000, 10000}
+#define __pcal6408a_latency_buckets     (8)
+
+/**
+ * @struct  pcal6408a_latency_stats_t
+ * @brief   the latency of a pin interrupt from its interrupt line capture to
+ *          the call of its handler
+ */
+typedef struct {
+    uint32_t    count;
+    uint32_t    max_us;
+    uint64_t    sum_us;
+    uint32_t    hist[__pcal6408a_latency_buckets];
+} pcal6408a_latency_stats_t;
+
 /**
  * @typedef pcal6408a_port_pin_handle
  * @brief   the handle type of the configured pin
@@ -154,6 +208,38 @@ void pcal6408a_reset(void);
  */
 void pcal6408a_interrupt_trigger_port(void);
 
+/**
+ * @brief   the same as pcal6408a_interrupt_trigger_port() with the capture
+ *          time of the interrupt line to account the pins interrupts latency.
+ *          The handlers of the priority pins are called first.
+ * 
+ * @param   isr_time_us the interrupt line capture time on the clock port
+ */
+void pcal6408a_interrupt_dispatch(uint32_t isr_time_us);
+
+/**
+ * @brief   sets the pin interrupt handler to be called before the other pins
+ *          handlers of the same interrupt
+ * 
+ * @param   handle a handle to the preconfigured input port pin
+ * @param   is_priority the pin priority
+ * @return  __pcal6408a_ok          write successful
+ *          __pcal6408a_bad_handle  wrong handle passed
+ *          __pcal6408a_non_initialized_handle
+ */
+pcal6408a_error_t pcal6408a_set_pin_priority(
+    pcal6408a_port_pin_handle   handle,
+    bool is_priority
+    );
+
+/**
+ * @brief   gets the interrupt latency stats of a port pin
+ */
+void pcal6408a_get_latency_stats(
+    pcal6408a_port_pin_t        pin_num,
+    pcal6408a_latency_stats_t * p_stats
+    );
+
 /**
  * @brief   configures an IO expander pin as input pin
  * 
@@ -248,6 +334,53 @@ pcal6408a_error_t pcal6408a_write(
     bool logic_level
     );
 
+/**
+ * @brief   reads the logic value of the port pin without any bus access if
+ *          possible. The input pins return the input port value of its last
+ *          read which is refreshed by every interrupt, so it is the present
+ *          level only for the interrupt enabled pins once their interrupts
+ *          are handled. The output pins and the inputs never read before are
+ *          read as by pcal6408a_read()
+ * 
+ * @param   handle a handle to the preconfigured port pin
+ * @param   p_read_logic_level a pointer to which the read logic level will be
+ *          written
+ * @return  the same as pcal6408a_read()
+ */
+pcal6408a_error_t pcal6408a_read_snapshot(
+    pcal6408a_port_pin_handle   handle,
+    bool * p_read_logic_level
+    );
+
+/**
+ * @brief   opens a batch of pins updates. The registers writes are held until
+ *          the outermost batch end where every changed register is written
+ *          once in the order of its first update. Batches can be nested.
+ *          They have no effect if the registers cache is disabled.
+ *          The batch is not owned by the caller, any pin update done before
+ *          its end joins it, so the caller serializes the driver access for
+ *          the whole batch.
+ */
+void pcal6408a_batch_begin(void);
+
+/**
+ * @brief   closes a batch and writes its changed registers when it is the
+ *          outermost one
+ */
+void pcal6408a_batch_end(void);
+
+/**
+ * @brief   drops the registers shadow and the register pointer of the device,
+ *          they will be read again on their next use. It shall be called
+ *          if the device was accessed by another i2c master
+ */
+void pcal6408a_sync(void);
+
+/**
+ * @brief   gets the accounting of the i2c bus transactions
+ */
+void pcal6408a_get_i2c_stats(pcal6408a_i2c_stats_t * p_stats);
+
 /**
  * @brief   reconfigure the output pins to open-drain configuration or not
  * 
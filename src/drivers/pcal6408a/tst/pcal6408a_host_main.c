@@ -0,0 +1,343 @@
+/** -------------------------------------------------------------------------- *
+ * @copyright Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ * 
+ * @author  Ahmed Sabry (SG Wireless)
+ * 
+ * @brief   host test of the PCAL6408A driver registers shadow and i2c
+ *          transactions on the mock device. It configures the pins as the F1
+ *          board io-expander does and checks the device registers and the
+ *          transactions count of every step.
+ * --------------------------------------------------------------------------- *
+ */
+
+/* --- includes ------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "log_lib.h"
+#include "utils_hosttest.h"
+#include "pcal6408a.h"
+#include "pcal6408a_mock.h"
+
+/* --- test helpers --------------------------------------------------------- */
+
+static uint32_t bus_transactions(void)
+{
+    pcal6408a_mock_stats_t stats;
+    pcal6408a_mock_get_stats(&stats);
+    return stats.reads + stats.writes + stats.write_reads;
+}
+
+static void step(const char* name, uint32_t trx)
+{
+    printf("  %-34s: %3u i2c transactions\n", name, trx);
+}
+
+/* --- board pins ----------------------------------------------------------- */
+
+static pcal6408a_port_pin_handle s_power;
+static pcal6408a_port_pin_handle s_reset_n;
+static pcal6408a_port_pin_handle s_int;
+static pcal6408a_port_pin_handle s_free;
+
+static uint32_t s_int_calls;
+static uint32_t s_free_calls;
+static bool     s_free_value;
+
+// -- the dispatch order of the handlers and the time spent in each
+static char     s_calls_order[8];
+static uint32_t s_calls_count;
+static uint32_t s_handler_time_us;
+
+static void record_call(char sig)
+{
+    if( s_calls_count < sizeof(s_calls_order) - 1 )
+        s_calls_order[s_calls_count ++] = sig;
+    pcal6408a_mock_advance_time(s_handler_time_us);
+}
+
+static void int_handler(bool pin_value)
+{
+    (void) pin_value;
+    ++ s_int_calls;
+    record_call('i');
+}
+
+static void free_handler(bool pin_value)
+{
+    ++ s_free_calls;
+    s_free_value = pin_value;
+    record_call('f');
+}
+
+static void board_init_with(bool combined_i2c)
+{
+    pcal6408a_init_config_t cfg = {
+        .is_addr_pin_connected_to_vdd = true,
+        .is_open_drain_output = false,
+        .i2c_read = pcal6408a_mock_i2c_read,
+        .i2c_write = pcal6408a_mock_i2c_write,
+        .i2c_write_read = combined_i2c ? pcal6408a_mock_i2c_write_read : NULL,
+        .get_time_us = pcal6408a_mock_time_us
+    };
+
+    pcal6408a_mock_reset();
+    __check(pcal6408a_init(&cfg) == __pcal6408a_ok, "init");
+
+    s_power = pcal6408a_configure_output_port_pin(pcal6408a_port_pin_0,
+        pcal6408a_pull_resistor_none, pcal6408a_drive_capability_level_0,
+        "lora_power");
+    s_reset_n = pcal6408a_configure_output_port_pin(pcal6408a_port_pin_2,
+        pcal6408a_pull_resistor_none, pcal6408a_drive_capability_level_0,
+        "lora_reset_n");
+    s_int = pcal6408a_configure_input_port_pin(pcal6408a_port_pin_5,
+        pcal6408a_pull_resistor_down, false, true, int_handler, "lora_int");
+    s_free = pcal6408a_configure_input_port_pin(pcal6408a_port_pin_6,
+        pcal6408a_pull_resistor_down, true, true, free_handler, "lora_free");
+}
+
+static void board_init(void)
+{
+    board_init_with(false);
+}
+
+static void board_activate(void)
+{
+    pcal6408a_activate_pin(s_power);
+    pcal6408a_activate_pin(s_reset_n);
+    pcal6408a_activate_pin(s_int);
+    pcal6408a_activate_pin(s_free);
+}
+
+static void board_deactivate(void)
+{
+    pcal6408a_deactivate_pin(s_int);
+    pcal6408a_deactivate_pin(s_free);
+    pcal6408a_deactivate_pin(s_reset_n);
+    pcal6408a_deactivate_pin(s_power);
+}
+
+/* --- test cases ----------------------------------------------------------- */
+
+static const uint8_t s_regs[] = {
+    0x01, 0x02, 0x03, 0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x4f };
+static const uint8_t s_reset_regs[] = {
+    0xff, 0x00, 0xff, 0xff, 0xff, 0x00, 0x00, 0xff, 0xff, 0x00 };
+#define __regs_count    (sizeof(s_regs)/sizeof(s_regs[0]))
+
+static void read_device_regs(uint8_t* values)
+{
+    uint32_t i;
+    for(i = 0; i < __regs_count; ++i)
+        values[i] = pcal6408a_mock_get_reg(s_regs[i]);
+}
+
+static void test_batched_activation(void)
+{
+    uint8_t single_regs[__regs_count];
+    uint8_t batch_regs[__regs_count];
+    uint32_t single_trx;
+    uint32_t batch_trx;
+    uint32_t i;
+
+    printf("-- pins activation\n");
+
+    board_init();
+    pcal6408a_mock_clear_stats();
+    board_activate();
+    single_trx = bus_transactions();
+    read_device_regs(single_regs);
+    step("activation pin by pin", single_trx);
+
+    board_init();
+    pcal6408a_mock_clear_stats();
+    pcal6408a_batch_begin();
+    board_activate();
+    __check(bus_transactions() == 0, "no transactions inside the batch");
+    pcal6408a_batch_end();
+    batch_trx = bus_transactions();
+    read_device_regs(batch_regs);
+    step("batched activation", batch_trx);
+
+    __check(batch_trx < single_trx, "batch %u >= single %u",
+        batch_trx, single_trx);
+    for(i = 0; i < __regs_count; ++i)
+        __check(single_regs[i] == batch_regs[i], "reg %02x: %02x != %02x",
+            s_regs[i], single_regs[i], batch_regs[i]);
+
+    pcal6408a_mock_clear_stats();
+    pcal6408a_batch_begin();
+    board_deactivate();
+    pcal6408a_batch_end();
+    step("batched deactivation", bus_transactions());
+    for(i = 0; i < __regs_count; ++i)
+        __check(pcal6408a_mock_get_reg(s_regs[i]) == s_reset_regs[i],
+            "reg %02x: %02x is not restored to %02x", s_regs[i],
+            pcal6408a_mock_get_reg(s_regs[i]), s_reset_regs[i]);
+}
+
+static void test_redundant_writes(void)
+{
+    printf("-- output writes\n");
+
+    board_init();
+    board_activate();
+    pcal6408a_mock_clear_stats();
+
+    pcal6408a_write(s_power, false);
+    step("write a new level", bus_transactions());
+    __check(bus_transactions() == 1, "one write");
+    __check((pcal6408a_mock_get_reg(0x01) & 0x01) == 0, "power pin is low");
+
+    pcal6408a_mock_clear_stats();
+    pcal6408a_write(s_power, false);
+    step("write the same level", bus_transactions());
+    __check(bus_transactions() == 0, "write skipped");
+}
+
+static void test_input_reads(void)
+{
+    bool value;
+
+    printf("-- input reads\n");
+
+    board_init();
+    board_activate();
+    pcal6408a_mock_set_inputs(0x00);
+    pcal6408a_interrupt_trigger_port();
+    pcal6408a_mock_clear_stats();
+
+    pcal6408a_read(s_free, &value);
+    step("first input read", bus_transactions());
+    pcal6408a_mock_clear_stats();
+    pcal6408a_read(s_free, &value);
+    step("repeated input read", bus_transactions());
+    __check(bus_transactions() == 1, "command byte not resent");
+    __check(value == true, "inverted low input reads high");
+
+    // -- the chip gets busy, the interrupt refreshes the snapshot
+    s_free_calls = 0;
+    __check(pcal6408a_mock_set_inputs(0x40), "interrupt asserted");
+    pcal6408a_mock_clear_stats();
+    pcal6408a_interrupt_trigger_port();
+    step("interrupt handling", bus_transactions());
+    __check(s_free_calls == 1 && s_free_value == false, "busy edge signalled");
+
+    pcal6408a_mock_clear_stats();
+    pcal6408a_read_snapshot(s_free, &value);
+    step("snapshot read", bus_transactions());
+    __check(bus_transactions() == 0, "snapshot read without bus access");
+    __check(value == false, "snapshot holds the busy level");
+
+    // -- an interrupt without a source reads only the status
+    pcal6408a_mock_clear_stats();
+    pcal6408a_interrupt_trigger_port();
+    step("interrupt without source", bus_transactions());
+    __check(bus_transactions() == 2, "status read only");
+}
+
+static void test_interrupt_dispatch(void)
+{
+    static const uint32_t bounds[] = __pcal6408a_latency_bounds_us;
+    pcal6408a_latency_stats_t lat_int;
+    pcal6408a_latency_stats_t lat_free;
+    uint32_t isr_time;
+    int i;
+
+    printf("-- interrupt dispatch\n");
+
+    board_init_with(true);
+    board_activate();
+    pcal6408a_mock_set_inputs(0x00);
+    pcal6408a_interrupt_trigger_port();
+
+    // -- the free signal goes first whatever its pin order
+    pcal6408a_set_pin_priority(s_free, true);
+    pcal6408a_mock_set_bus_time(100);
+    s_handler_time_us = 300;
+    s_calls_count = 0;
+    memset(s_calls_order, 0, sizeof(s_calls_order));
+
+    // -- both signals change together, as captured by the gpio isr
+    __check(pcal6408a_mock_set_inputs(0x60), "interrupt asserted");
+    isr_time = pcal6408a_mock_time_us();
+    pcal6408a_mock_clear_stats();
+    pcal6408a_interrupt_dispatch(isr_time);
+    step("combined i2c interrupt handling", bus_transactions());
+
+    __check(bus_transactions() == 2, "status and input in one transaction each");
+    __check(strcmp(s_calls_order, "fi") == 0, "calls order '%s'",
+        s_calls_order);
+
+    pcal6408a_get_latency_stats(pcal6408a_port_pin_5, &lat_int);
+    pcal6408a_get_latency_stats(pcal6408a_port_pin_6, &lat_free);
+    printf("  %-34s: %u usec\n", "priority signal latency", lat_free.max_us);
+    printf("  %-34s: %u usec\n", "other signal latency", lat_int.max_us);
+    __check(lat_free.max_us == 200, "priority latency %u", lat_free.max_us);
+    __check(lat_int.max_us == 500, "other latency %u", lat_int.max_us);
+    for(i = 0; i < __pcal6408a_latency_buckets - 1 && 200 > bounds[i]; ++i);
+    __check(lat_free.hist[i] == 1, "priority latency bucket %d", i);
+    for(i = 0; i < __pcal6408a_latency_buckets - 1 && 500 > bounds[i]; ++i);
+    __check(lat_int.hist[i] == 1, "other latency bucket %d", i);
+
+    pcal6408a_mock_set_bus_time(0);
+    s_handler_time_us = 0;
+}
+
+static void test_stats_accounting(void)
+{
+    pcal6408a_i2c_stats_t drv;
+    pcal6408a_mock_stats_t dev;
+
+    printf("-- accounting\n");
+
+    pcal6408a_get_i2c_stats(&drv);
+    pcal6408a_mock_get_stats(&dev);
+    printf("  driver: %u reads, %u writes, %u skipped writes, "
+        "%u merged writes, %u skipped commands\n", drv.reads, drv.writes,
+        drv.skipped_writes, drv.merged_writes, drv.skipped_cmds);
+    __check(drv.skipped_writes > 0 && drv.merged_writes > 0 &&
+        drv.skipped_cmds > 0, "savings accounted");
+}
+
+/* --- main ----------------------------------------------------------------- */
+
+int main(int argc, char** argv)
+{
+    (void) argc; (void) argv;
+
+    log_init(NULL);
+
+    test_batched_activation();
+    test_redundant_writes();
+    test_input_reads();
+    test_interrupt_dispatch();
+    test_stats_accounting();
+
+    return hosttest_result();
+}
+
+/* --- end of file ---------------------------------------------------------- */
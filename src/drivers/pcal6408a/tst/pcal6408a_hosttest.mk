@@ -0,0 +1,46 @@
+# ---------------------------------------------------------------------------- #
+# Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files(the “Software”), to deal
+# in the Software without restriction, including without limitation the rights
+# to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+# copies  of  the  Software,  and  to  permit  persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+# IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+# AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+# Author    Ahmed Sabry (SG Wireless)
+#
+# Desc      This file contains the host build of the PCAL6408A driver test on
+#           a mock device counting the i2c transactions.
+#
+# usage     make -f pcal6408a_hosttest.mk [clean|build|test]
+# ---------------------------------------------------------------------------- #
+
+# --- test description ------------------------------------------------------ #
+hosttest_name := pcal6408a
+
+drv_dir  := ..
+libs_dir := ../../../libs
+
+hosttest_srcs := $(notdir $(wildcard ./*.c)) pcal6408a.c
+hosttest_vpath := ${drv_dir}
+hosttest_incs := ${drv_dir}
+hosttest_defs := CONFIG_PCAL6408A_REGISTERS_CACHE_ENABLE
+hosttest_logs :=                        \
+    ${drv_dir}/../common/logs_defs.h    \
+    ${drv_dir}/pcal6408a.c
+
+include ${libs_dir}/utils/utils_hosttest.mk
+
+# --- end of file ------------------------------------------------------------ #
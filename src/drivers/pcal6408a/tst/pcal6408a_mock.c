@@ -0,0 +1,202 @@
+/** -------------------------------------------------------------------------- *
+ * @copyright Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ * 
+ * @author  Ahmed Sabry (SG Wireless)
+ * 
+ * @brief   mock PCAL6408A device behind the host i2c ports of the driver.
+ *          As the 8-bit device, a write sets the register pointer with its
+ *          command byte and the reads return the pointed register until the
+ *          next command.
+ * --------------------------------------------------------------------------- *
+ */
+
+/* --- includes ------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pcal6408a_mock.h"
+
+/* --- mock device state ---------------------------------------------------- */
+
+#define __mock_dev_addr     (0x21u)
+#define __mock_regs_count   (0x50u)
+
+static struct {
+    uint8_t                 regs[__mock_regs_count];
+    uint8_t                 pointer;
+    uint8_t                 pins;       /* the external input levels */
+    uint8_t                 int_status;
+    pcal6408a_mock_stats_t  stats;
+} s_mock;
+
+static uint32_t s_time_us;
+static uint32_t s_bus_time_us;
+
+static const struct {
+    uint8_t reg;
+    uint8_t value;
+} s_reset_values[] = {
+    {0x01, 0xff}, {0x02, 0x00}, {0x03, 0xff}, {0x40, 0xff}, {0x41, 0xff},
+    {0x42, 0x00}, {0x43, 0x00}, {0x44, 0xff}, {0x45, 0xff}, {0x46, 0x00},
+    {0x4f, 0x00}
+};
+
+static bool mock_is_writable(uint8_t reg)
+{
+    return reg != 0x00 && reg != 0x46 &&
+        (reg <= 0x03 || (reg >= 0x40 && reg <= 0x45) || reg == 0x4f);
+}
+
+static uint8_t mock_input_port(void)
+{
+    return s_mock.pins ^ s_mock.regs[0x02];
+}
+
+/* --- apis ----------------------------------------------------------------- */
+
+void pcal6408a_mock_reset(void)
+{
+    size_t i;
+
+    memset(&s_mock, 0, sizeof(s_mock));
+    for(i = 0; i < sizeof(s_reset_values)/sizeof(s_reset_values[0]); ++i)
+        s_mock.regs[s_reset_values[i].reg] = s_reset_values[i].value;
+    s_mock.regs[0x00] = mock_input_port();
+}
+
+void pcal6408a_mock_i2c_read(uint8_t dev_addr, uint8_t* buff, uint32_t cbytes)
+{
+    if(dev_addr != __mock_dev_addr)
+    {
+        printf("mock: read from unknown device %02x\n", dev_addr);
+        exit(1);
+    }
+    ++ s_mock.stats.reads;
+    s_time_us += s_bus_time_us;
+
+    while(cbytes --)
+    {
+        if(s_mock.pointer == 0x00)
+        {
+            /* reading the input port clears the interrupt */
+            *buff++ = s_mock.regs[0x00];
+            s_mock.regs[0x00] = mock_input_port();
+            s_mock.int_status = 0;
+        }
+        else if(s_mock.pointer == 0x46)
+        {
+            *buff++ = s_mock.int_status;
+        }
+        else
+        {
+            *buff++ = s_mock.regs[s_mock.pointer];
+        }
+    }
+}
+
+void pcal6408a_mock_i2c_write(uint8_t dev_addr, uint8_t* buff, uint32_t cbytes)
+{
+    if(dev_addr != __mock_dev_addr || cbytes == 0 ||
+        buff[0] >= __mock_regs_count)
+    {
+        printf("mock: bad write to device %02x\n", dev_addr);
+        exit(1);
+    }
+    ++ s_mock.stats.writes;
+    s_time_us += s_bus_time_us;
+
+    s_mock.pointer = buff[0];
+    if(cbytes == 1)
+        ++ s_mock.stats.cmds;
+
+    /* the following data bytes go to the same register */
+    while(-- cbytes)
+    {
+        ++ buff;
+        if(mock_is_writable(s_mock.pointer))
+        {
+            s_mock.regs[s_mock.pointer] = *buff;
+            ++ s_mock.stats.reg_writes;
+        }
+    }
+}
+
+void pcal6408a_mock_i2c_write_read(uint8_t dev_addr, uint8_t* wbuff,
+    uint32_t wbytes, uint8_t* rbuff, uint32_t rbytes)
+{
+    pcal6408a_mock_stats_t stats = s_mock.stats;
+
+    /* one transaction with a repeated start between its two phases */
+    pcal6408a_mock_i2c_write(dev_addr, wbuff, wbytes);
+    pcal6408a_mock_i2c_read(dev_addr, rbuff, rbytes);
+    s_time_us -= s_bus_time_us;
+
+    ++ stats.write_reads;
+    s_mock.stats = stats;
+}
+
+uint32_t pcal6408a_mock_time_us(void)
+{
+    return s_time_us;
+}
+
+void pcal6408a_mock_advance_time(uint32_t usec)
+{
+    s_time_us += usec;
+}
+
+void pcal6408a_mock_set_bus_time(uint32_t usec_per_transaction)
+{
+    s_bus_time_us = usec_per_transaction;
+}
+
+bool pcal6408a_mock_set_inputs(uint8_t levels)
+{
+    uint8_t changed = (levels ^ s_mock.pins) & s_mock.regs[0x03];
+    /* the latched inputs keep the value that initiated their interrupt */
+    uint8_t hold = s_mock.regs[0x42] & s_mock.int_status;
+
+    s_mock.pins = levels;
+    s_mock.int_status |= changed & ~s_mock.regs[0x45];
+    s_mock.regs[0x00] = (s_mock.regs[0x00] & hold) |
+        (mock_input_port() & ~hold);
+
+    return s_mock.int_status != 0;
+}
+
+uint8_t pcal6408a_mock_get_reg(uint8_t reg)
+{
+    return reg < __mock_regs_count ? s_mock.regs[reg] : 0;
+}
+
+void pcal6408a_mock_get_stats(pcal6408a_mock_stats_t * p_stats)
+{
+    *p_stats = s_mock.stats;
+}
+
+void pcal6408a_mock_clear_stats(void)
+{
+    memset(&s_mock.stats, 0, sizeof(s_mock.stats));
+}
+
+/* --- end of file ---------------------------------------------------------- */
@@ -0,0 +1,91 @@
+/** -------------------------------------------------------------------------- *
+ * @copyright Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ * 
+ * @author  Ahmed Sabry (SG Wireless)
+ * 
+ * @brief   mock PCAL6408A device behind the host i2c ports of the driver. It
+ *          models the device registers and its register pointer, and counts
+ *          the i2c transactions.
+ * --------------------------------------------------------------------------- *
+ */
+#ifndef __PCAL6408A_MOCK_H__
+#define __PCAL6408A_MOCK_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --- includes ------------------------------------------------------------- */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* --- typedefs ------------------------------------------------------------- */
+
+typedef struct {
+    uint32_t    reads;      /**< read transactions */
+    uint32_t    writes;     /**< write transactions */
+    uint32_t    write_reads;/**< combined write and read transactions */
+    uint32_t    cmds;       /**< writes of the command byte only */
+    uint32_t    reg_writes; /**< registers written */
+} pcal6408a_mock_stats_t;
+
+/* --- api declarations ----------------------------------------------------- */
+
+/**
+ * @brief   puts the registers to their power-up defaults and clears the stats
+ */
+void pcal6408a_mock_reset(void);
+
+/**
+ * @brief   the i2c ports to plug into pcal6408a_init_config_t
+ */
+void pcal6408a_mock_i2c_read(uint8_t dev_addr, uint8_t* buff, uint32_t cbytes);
+void pcal6408a_mock_i2c_write(uint8_t dev_addr, uint8_t* buff, uint32_t cbytes);
+void pcal6408a_mock_i2c_write_read(uint8_t dev_addr, uint8_t* wbuff,
+    uint32_t wbytes, uint8_t* rbuff, uint32_t rbytes);
+
+/**
+ * @brief   the mock microseconds clock, every i2c transaction advances it by
+ *          the bus time set by pcal6408a_mock_set_bus_time()
+ */
+uint32_t pcal6408a_mock_time_us(void);
+void pcal6408a_mock_advance_time(uint32_t usec);
+void pcal6408a_mock_set_bus_time(uint32_t usec_per_transaction);
+
+/**
+ * @brief   drives the input pins levels, an interrupt is raised on the changes
+ *          of the non masked pins
+ * @return  true if the interrupt line is asserted
+ */
+bool pcal6408a_mock_set_inputs(uint8_t levels);
+
+uint8_t pcal6408a_mock_get_reg(uint8_t reg);
+
+void pcal6408a_mock_get_stats(pcal6408a_mock_stats_t * p_stats);
+void pcal6408a_mock_clear_stats(void);
+
+/* -- end of file ----------------------------------------------------------- */
+#ifdef __cplusplus
+}
+#endif
+#endif /* __PCAL6408A_MOCK_H__ */
@@ -215,6 +215,18 @@ def get_sm_ifdefs(sm):
             ifdefs.append(it[1])
     return ifdefs
 
+def get_sm_ids_bits(sm):
+    # the tables sizes are stored in the same type as the ids, so the count
+    # itself shall fit in the ids type
+    count = max(len(get_sm_states(sm)), len(get_sm_inputs(sm)),
+                len(get_sm_actions(sm)))
+    for bits in [8, 16]:
+        if count < (1 << bits):
+            return bits
+    logl('error: state machine {} has {} ids, max supported is {}'\
+         .format(sm, count, (1 << 16) - 1), 'red')
+    sys.exit(1)
+
 def check_sm_state_trans(sm):
     states = get_sm_states(sm)
     state_trans = []
@@ -230,8 +242,12 @@ def check_sm_state_trans(sm):
                         logl('--> {}'.format(it))
                         error = True
                 state_trans.append( it )
+        if len(get_sm_state_trans(sm, st)) > 255:
+            logl('error: state {} has more than 255 transitions'.format(st),
+                 'red')
+            error = True
     if error:
-        exit(0)
+        sys.exit(1)
 
 # --- generation helper functions -------------------------------------------- #
 
@@ -309,11 +325,11 @@ def write_inputs_declarations(sm, fc, fh):
         fh.write('    __sm_input_id({}, {}),\n'.format(sm, it))
     fh.write('};\n')
     fh.write('\n')
-    fc.write('static input_table_t sm_{}_inputs_table[] = '.format(sm))
+    fc.write('static const input_table_t sm_{}_inputs_table[] = '.format(sm))
     fc.write('{\n')
     for it in inputs:
-        fc.write('    [__sm_input_id({}, {})] = {} "'.format(sm, it, '{'))
-        fc.write('{}"'.format(it))
+        fc.write('    [__sm_input_id({}, {})] = {} '.format(sm, it, '{'))
+        fc.write('__sm_name("{}")'.format(it))
         fc.write(' },\n')
     fc.write('};\n')
     fc.write('#define sm_{}_inputs_table_size \\\n'.format(sm))
@@ -331,12 +347,12 @@ def write_actions_declarations(sm, fc, fh):
     fh.write('};\n')
     fh.write('\n')
 
-    fc.write('static action_table_t sm_{}_actions_table[] = '.format(sm))
+    fc.write('static const action_table_t sm_{}_actions_table[] = '.format(sm))
     fc.write('{\n')
     for it in actions:
         found = False
         fc.write('    [__sm_action_id({}, {})] = {}\n'.format(sm, it, '{'))
-        fc.write('        "{}",\n'.format(it))
+        fc.write('        __sm_name("{}"),\n'.format(it))
         for it2 in def_actions:
             if it == it2:
                  fc.write('        __sm_action_fun({}, {}){},\n'\
@@ -391,8 +407,8 @@ def write_states_declarations(sm, fc, fh):
         write_header(fc, 'state -> {}'.format(st), '-')
         trans = get_sm_state_trans(sm, st)
 
-        fc.write('static state_trans_table_t sm_{}_{}_trans_table [] = {}\n'\
-                 .format(sm,st,'{'))
+        fc.write('static const state_trans_table_t ' + \
+                 'sm_{}_{}_trans_table [] = {}\n'.format(sm,st,'{'))
         for tr in trans:
             fc.write('    {\n')
             fc.write('        .input_id = __sm_input_id({}, {}),\n'\
@@ -406,19 +422,26 @@ def write_states_declarations(sm, fc, fh):
         fc.write('#define sm_{}_{}_trans_table_size \\\n'.format(sm, st))
         fc.write('    (sizeof(sm_{}_{}_trans_table)/'.format(sm, st) + \
                  'sizeof(state_trans_table_t))\n')
+        fc.write('#ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING\n')
+        fc.write('static uint32_t sm_{}_{}_trans_hits '.format(sm, st) + \
+                 '[sm_{}_{}_trans_table_size];\n'.format(sm, st))
+        fc.write('#endif\n')
         fc.write('\n')
     
     write_header(fc, 'states-table', '-')
     
-    fc.write('static state_table_t sm_{}_states_table [] = {}\n'\
+    fc.write('static const state_table_t sm_{}_states_table [] = {}\n'\
              .format(sm, '{'))
     for st in states:
         fc.write('    [__sm_state_id({}, {})] = {}\n'.format(sm, st, '{'))
-        fc.write('        .name = "{}",\n'.format(st))
+        fc.write('        .name = __sm_name("{}"),\n'.format(st))
         fc.write('        .trans_table = sm_{}_{}_trans_table,\n'\
                  .format(sm, st))
         fc.write('        .trans_table_size = sm_{}_{}_trans_table_size,\n'\
                  .format(sm, st))
+        fc.write('        #ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING\n')
+        fc.write('        .trans_hits = sm_{}_{}_trans_hits,\n'.format(sm, st))
+        fc.write('        #endif\n')
         if has_default_action(sm, st):
             fc.write('        .default_action = ' + \
                      '__sm_action_fun({}, {}_default),\n'.format(sm, st))
@@ -433,6 +456,10 @@ def write_states_declarations(sm, fc, fh):
     fc.write('#define sm_{}_states_table_size \\\n'.format(sm))
     fc.write('    (sizeof(sm_{}_states_table)/sizeof(state_table_t))\n'\
             .format(sm))
+    fc.write('#ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING\n')
+    fc.write('static state_prof_t sm_{}_states_prof '.format(sm) + \
+             '[sm_{}_states_table_size];\n'.format(sm))
+    fc.write('#endif\n')
     
     fc.write('\n')
 
@@ -442,8 +469,17 @@ def write_machine_declaration(sm, fc, fh):
     fh.write('\n')
     write_header(fc, 'MACHINE', '-')
     fc.write('\n')
-    fc.write('state_machine_t __sm_machine_id({}) = {}\n'.format(sm, '{'))
-    fc.write('    .name = "{}",\n'.format(sm))
+    ids_bits = get_sm_ids_bits(sm)
+    fc.write('#define sm_{}_ids_bits  {}\n'.format(sm, ids_bits))
+    fc.write('#if sm_{}_ids_bits > __SM_TABLE_ID_BITS\n'.format(sm))
+    fc.write('#error "state machine \'{}\' needs {}-bits ids, '\
+             .format(sm, ids_bits) + \
+             'enable CONFIG_SDK_LIBS_STATE_MACHINE_16_BITS_IDS"\n')
+    fc.write('#endif\n')
+    fc.write('\n')
+    fc.write('static const state_machine_desc_t sm_{}_desc = {}\n'\
+             .format(sm, '{'))
+    fc.write('    .name = __sm_name("{}"),\n'.format(sm))
     fc.write('    .inputs_table = sm_{}_inputs_table,\n'.format(sm))
     fc.write('    .inputs_table_size = sm_{}_inputs_table_size,\n'.format(sm))
     fc.write('    .actions_table = sm_{}_actions_table,\n'.format(sm))
@@ -451,6 +487,15 @@ def write_machine_declaration(sm, fc, fh):
     fc.write('    .state_table = sm_{}_states_table,\n'.format(sm))
     fc.write('    .state_table_size = sm_{}_states_table_size,\n'.format(sm))
     fc.write('};\n')
+    fc.write('\n')
+    fc.write('state_machine_t __sm_machine_id({}) = {}\n'.format(sm, '{'))
+    fc.write('    .desc = &sm_{}_desc,\n'.format(sm))
+    fc.write('    #ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING\n')
+    fc.write('    .prof = {\n')
+    fc.write('        .states = sm_{}_states_prof,\n'.format(sm))
+    fc.write('    },\n')
+    fc.write('    #endif\n')
+    fc.write('};\n')
 
 def gen_sm_file(sm):
     h_filename = get_gen_dir() + "/{}_state_machine.h".format(sm)
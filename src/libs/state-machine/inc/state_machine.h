@@ -37,6 +37,7 @@ extern "C" {
  */
 #include <stdbool.h>
 #include <stdint.h>
+#include <stddef.h>
 
 /** -------------------------------------------------------------------------- *
  * state-machine macro interface
@@ -116,7 +117,34 @@ extern "C" {
  *   then, it is mandatory to include the header file in the state-machine
  *   definition source file
  *      #include "<state-machine-name>_state_machine.h"
- * 
+ *
+ * § State-machine profiling:
+ *   when CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING is enabled, every generated
+ *   machine carries a set of counters that are updated while running:
+ *      * hit count of every state transition entry
+ *      * per state: entries count, default-action/un-handled hits,
+ *        cumulative and maximum time spent in the state
+ *      * time spent in executing actions (leave + enter + transition action)
+ *   the time is measured in the units of the timestamp getter registered by
+ *   state_machine_prof_set_timestamp_getter(), if no getter is registered,
+ *   only the counters are maintained.
+ *   The profile is displayed with __sm_disp() and can be fetched using
+ *   __sm_prof_get() and cleared using __sm_prof_reset().
+ *   When the config is disabled, all profiling code and data compile out.
+ *
+ * § State-machine memory layout:
+ *   the generated tables (inputs, actions, states and transitions) and the
+ *   machine descriptor are all 'const' and reside in the read-only memory,
+ *   only the machine object (present state, flags and profiling counters)
+ *   resides in RAM.
+ *      * the ids inside the tables are stored in state_machine_table_id_t
+ *        which is 8-bits by default, the generator computes the ids width
+ *        needed by every machine and emits a compile time check against it.
+ *        CONFIG_SDK_LIBS_STATE_MACHINE_16_BITS_IDS widens it for machines
+ *        with more than 255 states/inputs/actions.
+ *      * the names strings are used only for debugging and printing, they
+ *        can be dropped by disabling CONFIG_SDK_LIBS_STATE_MACHINE_NAMES
+ *
  * --------------------------------------------------------------------------- *
  */
 /**
@@ -202,11 +230,42 @@ extern "C" {
  */
 #define __sm_present_state_id(_sm) (__sm_machine_id(_sm).present_state)
 
+/**
+ * used by the generator to wrap the debug names strings, so that they can be
+ * dropped from the final image
+ */
+#ifdef CONFIG_SDK_LIBS_STATE_MACHINE_NAMES
+#define __sm_name(_str)     _str
+#else
+#define __sm_name(_str)     NULL
+#endif
+
 /**
  * a demonstrative macro for displaying the whole state-machine visually
  */
 #define __sm_disp(_sm)  state_machine_print(&__sm_machine_id(_sm))
 
+/**
+ * profiling macros, they compile out when the profiling is disabled
+ *
+ * @def __sm_prof_get       fills a state_machine_prof_summary_t struct
+ * @def __sm_prof_get_state fills a state_prof_t struct of a given state
+ * @def __sm_prof_reset     clears all the profiling counters of the machine
+ */
+#ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+#define __sm_prof_get(_sm, _p_summary)                          \
+    state_machine_prof_get(&__sm_machine_id(_sm), _p_summary)
+#define __sm_prof_get_state(_sm, _st, _p_state_prof)            \
+    state_machine_prof_get_state(&__sm_machine_id(_sm),         \
+        __sm_state_id(_sm, _st), _p_state_prof)
+#define __sm_prof_reset(_sm)                                    \
+    state_machine_prof_reset(&__sm_machine_id(_sm))
+#else
+#define __sm_prof_get(_sm, _p_summary)              do{}while(0)
+#define __sm_prof_get_state(_sm, _st, _p_state_prof) do{}while(0)
+#define __sm_prof_reset(_sm)                        do{}while(0)
+#endif /* CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING */
+
 /** -------------------------------------------------------------------------- *
  * typedefs
  * --------------------------------------------------------------------------- *
@@ -216,6 +275,60 @@ typedef uint32_t input_id_t;
 typedef uint32_t action_id_t;
 typedef void state_action_t( void* data );
 
+/**
+ * the ids type used inside the generated tables
+ */
+#ifdef CONFIG_SDK_LIBS_STATE_MACHINE_16_BITS_IDS
+typedef uint16_t state_machine_table_id_t;
+#define __SM_TABLE_ID_BITS  16
+#else
+typedef uint8_t  state_machine_table_id_t;
+#define __SM_TABLE_ID_BITS  8
+#endif
+
+#ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+/**
+ * per state profiling record
+ */
+typedef struct {
+    uint32_t    enter_count;    /**< how many times the state is entered */
+    uint32_t    default_count;  /**< inputs without a transition entry */
+    uint32_t    time_total;     /**< cumulative time spent in the state */
+    uint32_t    time_max;       /**< longest single stay in the state */
+} state_prof_t;
+
+/**
+ * per machine profiling record, it resides in RAM and it is attached to the
+ * generated machine object
+ */
+typedef struct {
+    state_prof_t*   states;         /**< indexed by the state id */
+    uint32_t        runs;           /**< total processed inputs */
+    uint32_t        unhandled;      /**< inputs without a default action */
+    uint32_t        errors;         /**< invalid ids reported */
+    uint32_t        action_time_total;  /**< time spent in actions */
+    uint32_t        action_time_max;    /**< longest actions execution */
+    uint32_t        state_enter_timestamp; /**< present state entry time */
+} state_machine_prof_t;
+
+/**
+ * a compact machine profiling summary returned by state_machine_prof_get()
+ */
+typedef struct {
+    uint32_t    runs;               /**< total processed inputs */
+    uint32_t    trans_hits;         /**< inputs matched a transition entry */
+    uint32_t    default_hits;       /**< inputs handled by default actions */
+    uint32_t    unhandled;          /**< inputs dropped without any action */
+    uint32_t    errors;             /**< invalid ids reported */
+    uint32_t    state_changes;      /**< total states entries */
+    uint32_t    action_time_total;  /**< time spent in actions */
+    uint32_t    action_time_max;    /**< longest actions execution */
+    state_id_t  busiest_state;      /**< state with max cumulative time */
+} state_machine_prof_summary_t;
+
+typedef uint32_t state_machine_prof_get_timestamp_t(void);
+#endif /* CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING */
+
 typedef struct {
     const char * name;
 } input_table_t;
@@ -226,30 +339,43 @@ typedef struct {
 } action_table_t;
 
 typedef struct {
-    input_id_t      input_id;
-    state_id_t      next_state_id;
-    action_id_t     action_id;
+    state_machine_table_id_t    input_id;
+    state_machine_table_id_t    next_state_id;
+    state_machine_table_id_t    action_id;
 } state_trans_table_t;
 
 typedef struct {
-    const char*             name;
-    state_trans_table_t *   trans_table;
-    uint8_t                 trans_table_size;
-    state_action_t*         default_action;
-    state_action_t*         enter;
-    state_action_t*         leave;
+    const char*                 name;
+    const state_trans_table_t*  trans_table;
+    state_action_t*             default_action;
+    state_action_t*             enter;
+    state_action_t*             leave;
+    #ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+    uint32_t *                  trans_hits;
+    #endif
+    uint8_t                     trans_table_size;
 } state_table_t;
 
+/**
+ * the constant part of the state machine, it is generated in read-only memory
+ */
 typedef struct {
-    const char*     name;
-    input_table_t*  inputs_table;
-    uint32_t        inputs_table_size;
-    action_table_t* actions_table;
-    uint32_t        actions_table_size;
-    state_table_t*  state_table;
-    uint32_t        state_table_size;
-    state_id_t      present_state;
-    bool            state_changed_manually;
+    const char*                 name;
+    const input_table_t*        inputs_table;
+    const action_table_t*       actions_table;
+    const state_table_t*        state_table;
+    state_machine_table_id_t    inputs_table_size;
+    state_machine_table_id_t    actions_table_size;
+    state_machine_table_id_t    state_table_size;
+} state_machine_desc_t;
+
+typedef struct {
+    const state_machine_desc_t* desc;
+    state_machine_table_id_t    present_state;
+    bool                        state_changed_manually;
+    #ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+    state_machine_prof_t prof;
+    #endif
 } state_machine_t;
 
 /** -------------------------------------------------------------------------- *
@@ -271,6 +397,36 @@ void state_machine_change_state_manually(
     state_id_t id
     );
 
+#ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+/**
+ * @brief   registers the timestamp source used to measure the time spent in
+ *          states and actions. it is common for all state machines.
+ */
+void state_machine_prof_set_timestamp_getter(
+    state_machine_prof_get_timestamp_t* p_getter
+    );
+
+void state_machine_prof_get(
+    state_machine_t*                p_sm,
+    state_machine_prof_summary_t*   p_summary
+    );
+
+/**
+ * @brief   fetches the profile of a certain state, if the state is the present
+ *          state, the time of the current stay is included.
+ * @return  false if the state id is invalid
+ */
+bool state_machine_prof_get_state(
+    state_machine_t*    p_sm,
+    state_id_t          state_id,
+    state_prof_t*       p_state_prof
+    );
+
+void state_machine_prof_reset(
+    state_machine_t*    p_sm
+    );
+#endif /* CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING */
+
 /* --- end of file ---------------------------------------------------------- */
 #ifdef __cplusplus
 }
@@ -32,6 +32,8 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stddef.h>
+#include <string.h>
+#include <stdio.h>
 
 #define __log_subsystem     libs
 #define __log_component     state_machine
@@ -40,6 +42,157 @@ __log_component_def(libs, state_machine, default, 1, 0)
 
 #include "state_machine.h"
 
+/** -------------------------------------------------------------------------- *
+ * profiling
+ * --------------------------------------------------------------------------- *
+ */
+#ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+
+static state_machine_prof_get_timestamp_t* s_prof_get_timestamp = NULL;
+
+#define __prof_now()    (s_prof_get_timestamp ? s_prof_get_timestamp() : 0)
+
+static void state_machine_prof_state_change(state_machine_t* p_sm,
+    state_id_t from_id, state_id_t to_id)
+{
+    uint32_t now = __prof_now();
+
+    if(from_id == to_id)
+        return;
+
+    if(from_id < p_sm->desc->state_table_size)
+    {
+        state_prof_t* p_from = & p_sm->prof.states[from_id];
+        uint32_t stay = now - p_sm->prof.state_enter_timestamp;
+        p_from->time_total += stay;
+        if(stay > p_from->time_max)
+            p_from->time_max = stay;
+    }
+
+    if(to_id < p_sm->desc->state_table_size)
+    {
+        ++ p_sm->prof.states[to_id].enter_count;
+    }
+
+    p_sm->prof.state_enter_timestamp = now;
+}
+
+static void state_machine_prof_action_time(state_machine_t* p_sm,
+    uint32_t start)
+{
+    uint32_t elapsed = __prof_now() - start;
+
+    p_sm->prof.action_time_total += elapsed;
+    if(elapsed > p_sm->prof.action_time_max)
+        p_sm->prof.action_time_max = elapsed;
+}
+
+#define __prof_run(_p_sm)           ++ (_p_sm)->prof.runs
+#define __prof_error(_p_sm)         ++ (_p_sm)->prof.errors
+#define __prof_unhandled(_p_sm)     ++ (_p_sm)->prof.unhandled
+#define __prof_default(_p_sm, _st)  ++ (_p_sm)->prof.states[_st].default_count
+#define __prof_trans_hit(_p_st, _i) ++ (_p_st)->trans_hits[_i]
+#define __prof_state_change(_p_sm, _from, _to) \
+    state_machine_prof_state_change(_p_sm, _from, _to)
+#define __prof_action_start(_var)   uint32_t _var = __prof_now()
+#define __prof_action_end(_p_sm, _var) \
+    state_machine_prof_action_time(_p_sm, _var)
+
+void state_machine_prof_set_timestamp_getter(
+    state_machine_prof_get_timestamp_t* p_getter)
+{
+    s_prof_get_timestamp = p_getter;
+}
+
+void state_machine_prof_get(state_machine_t* p_sm,
+    state_machine_prof_summary_t* p_summary)
+{
+    __log_assert(p_sm && p_summary, "invalid profiling args");
+
+    memset(p_summary, 0, sizeof(state_machine_prof_summary_t));
+
+    p_summary->runs = p_sm->prof.runs;
+    p_summary->unhandled = p_sm->prof.unhandled;
+    p_summary->errors = p_sm->prof.errors;
+    p_summary->action_time_total = p_sm->prof.action_time_total;
+    p_summary->action_time_max = p_sm->prof.action_time_max;
+
+    uint32_t busiest_time = 0;
+    state_id_t i;
+    for(i = 0; i < p_sm->desc->state_table_size; ++i)
+    {
+        state_prof_t st_prof;
+        state_machine_prof_get_state(p_sm, i, &st_prof);
+
+        p_summary->default_hits += st_prof.default_count;
+        p_summary->state_changes += st_prof.enter_count;
+
+        if(st_prof.time_total >= busiest_time)
+        {
+            busiest_time = st_prof.time_total;
+            p_summary->busiest_state = i;
+        }
+
+        uint32_t j;
+        for(j = 0; j < p_sm->desc->state_table[i].trans_table_size; ++j)
+            p_summary->trans_hits += p_sm->desc->state_table[i].trans_hits[j];
+    }
+}
+
+bool state_machine_prof_get_state(state_machine_t* p_sm, state_id_t state_id,
+    state_prof_t* p_state_prof)
+{
+    __log_assert(p_sm && p_state_prof, "invalid profiling args");
+
+    if(state_id >= p_sm->desc->state_table_size)
+        return false;
+
+    *p_state_prof = p_sm->prof.states[state_id];
+
+    if(state_id == p_sm->present_state)
+    {
+        uint32_t stay = __prof_now() - p_sm->prof.state_enter_timestamp;
+        p_state_prof->time_total += stay;
+        if(stay > p_state_prof->time_max)
+            p_state_prof->time_max = stay;
+    }
+
+    return true;
+}
+
+void state_machine_prof_reset(state_machine_t* p_sm)
+{
+    __log_assert(p_sm, "invalid profiling args");
+
+    state_id_t i;
+    for(i = 0; i < p_sm->desc->state_table_size; ++i)
+    {
+        memset(& p_sm->prof.states[i], 0, sizeof(state_prof_t));
+        memset(p_sm->desc->state_table[i].trans_hits, 0,
+            p_sm->desc->state_table[i].trans_table_size * sizeof(uint32_t));
+    }
+
+    p_sm->prof.runs = 0;
+    p_sm->prof.unhandled = 0;
+    p_sm->prof.errors = 0;
+    p_sm->prof.action_time_total = 0;
+    p_sm->prof.action_time_max = 0;
+    p_sm->prof.state_enter_timestamp = __prof_now();
+}
+
+#else
+
+#define __prof_run(_p_sm)
+#define __prof_error(_p_sm)
+#define __prof_unhandled(_p_sm)
+#define __prof_default(_p_sm, _st)
+#define __prof_trans_hit(_p_st, _i)
+#define __prof_state_change(_p_sm, _from, _to)
+#define __prof_action_start(_var)
+#define __prof_action_end(_p_sm, _var)
+
+#endif /* CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING */
+
 /** -------------------------------------------------------------------------- *
  * printing functions
  * --------------------------------------------------------------------------- *
@@ -48,11 +201,13 @@ __log_component_def(libs, state_machine, default, 1, 0)
 
 static const char* null_str = "-- null --";
 
+#define __name_str(_name)   ((_name) ? (_name) : null_str)
+
 static void state_machine_log_state_trans(state_machine_t* p_sm,
-    state_id_t ps_id, state_table_t * p_ps,
-    input_id_t in_id, input_table_t * p_in,
-    action_id_t act_id, action_table_t * p_act,
-    state_id_t ns_id, state_table_t * p_ns,
+    state_id_t ps_id, const state_table_t * p_ps,
+    input_id_t in_id, const input_table_t * p_in,
+    action_id_t act_id, const action_table_t * p_act,
+    state_id_t ns_id, const state_table_t * p_ns,
     bool err, bool warn, bool exec, const char * msg
     )
 {
@@ -60,7 +215,8 @@ static void state_machine_log_state_trans(state_machine_t* p_sm,
     __log_printf("+%"__stringify(__width)"c+\n", '-');
 
     // -- log state machine name
-    __log_printf("|%+-"__stringify(__width)"s|\n", p_sm->name);
+    __log_printf("|%+-"__stringify(__width)"s|\n",
+        __name_str(p_sm->desc->name));
 
     // -- draw a middle cap
     __log_printf("+");
@@ -104,7 +260,7 @@ static void state_machine_log_state_trans(state_machine_t* p_sm,
     } else {
         __log_printf(__yellow__"%2d: ", ps_id);
     }
-    __log_printf_field(p_ps ? p_ps->name : null_str,
+    __log_printf_field(p_ps ? __name_str(p_ps->name) : null_str,
         __col_w(1, 4, __width, 1) - 4, ' ', __left__, false);
     __log_printf(__default__"|");
     if(! p_in ){
@@ -112,7 +268,7 @@ static void state_machine_log_state_trans(state_machine_t* p_sm,
     } else {
         __log_printf(__blue__"%2d: ", in_id);
     }
-    __log_printf_field(p_in ? p_in->name : null_str,
+    __log_printf_field(p_in ? __name_str(p_in->name) : null_str,
         __col_w(2, 4, __width, 1) - 4, ' ', __left__, false);
     __log_printf(__default__"/");
     if(! p_act ){
@@ -120,7 +276,7 @@ static void state_machine_log_state_trans(state_machine_t* p_sm,
     } else {
         __log_printf(__cyan__"%2d: ", act_id);
     }
-    __log_printf_field(p_act ? p_act->name : null_str,
+    __log_printf_field(p_act ? __name_str(p_act->name) : null_str,
         __col_w(3, 4, __width, 1) - 4, ' ', __left__, false);
     __log_printf(__default__"|");
     if(! p_ns ){
@@ -128,7 +284,7 @@ static void state_machine_log_state_trans(state_machine_t* p_sm,
     } else {
         __log_printf(__yellow__"%2d: ", ns_id);
     }
-    __log_printf_field(p_ns ? p_ns->name : null_str,
+    __log_printf_field(p_ns ? __name_str(p_ns->name) : null_str,
         __col_w(4, 4, __width, 1) - 4, ' ', __left__, false);
     __log_printf(__default__"|\n");
 
@@ -153,12 +309,105 @@ static void state_machine_log_state_trans(state_machine_t* p_sm,
     __log_endl();
 }
 
+#ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+static void state_machine_print_prof(state_machine_t* p_sm)
+{
+    state_machine_prof_summary_t summary;
+    state_machine_prof_get(p_sm, &summary);
+
+    __log_printf("\n|%+-"__stringify(__width)"s|\n", "profiling");
+    __log_printf("+%"__stringify(__width)"c+\n", '-');
+
+    char line[__width + 1];
+    snprintf(line, sizeof(line),
+        " runs: %u, hits: %u, defaults: %u, un-handled: %u, errors: %u",
+        summary.runs, summary.trans_hits, summary.default_hits,
+        summary.unhandled, summary.errors);
+    __log_printf("|");
+    __log_printf_field(line, __width, ' ', __left__, false);
+    __log_printf("|\n");
+    snprintf(line, sizeof(line),
+        " state-changes: %u, action-time: total %u, max %u",
+        summary.state_changes, summary.action_time_total,
+        summary.action_time_max);
+    __log_printf("|");
+    __log_printf_field(line, __width, ' ', __left__, false);
+    __log_printf("|\n");
+
+    __log_printf("+%"__stringify(__width)"c+\n", '-');
+
+    __log_printf("|");
+    __log_printf_field("id: state", __col_w(1, 5, __width, 1), ' ',
+        __left__, false);
+    __log_printf(" ");
+    __log_printf_field("enters", __col_w(2, 5, __width, 1), ' ',
+        __right__, false);
+    __log_printf(" ");
+    __log_printf_field("defaults", __col_w(3, 5, __width, 1), ' ',
+        __right__, false);
+    __log_printf(" ");
+    __log_printf_field("time-total", __col_w(4, 5, __width, 1), ' ',
+        __right__, false);
+    __log_printf(" ");
+    __log_printf_field("time-max", __col_w(5, 5, __width, 1), ' ',
+        __right__, false);
+    __log_printf("|\n");
+
+    __log_printf("+%"__stringify(__width)"c+", '-');
+
+    state_id_t i;
+    for(i = 0; i < p_sm->desc->state_table_size; ++i)
+    {
+        const state_table_t* p_st = & p_sm->desc->state_table[i];
+        state_prof_t st_prof;
+        state_machine_prof_get_state(p_sm, i, &st_prof);
+
+        uint32_t values[] = {st_prof.enter_count, st_prof.default_count,
+            st_prof.time_total, st_prof.time_max};
+        char num_str[12];
+        int col;
+
+        __log_printf("\n|"__yellow__"%2d: ", i);
+        __log_printf_field(p_st->name ? p_st->name : null_str,
+            __col_w(1, 5, __width, 1) - 4, ' ', __left__, false);
+        __log_printf(__default__);
+        for(col = 0; col < 4; ++col)
+        {
+            snprintf(num_str, sizeof(num_str), "%u", values[col]);
+            __log_printf(" ");
+            __log_printf_field(num_str, __col_w(col + 2, 5, __width, 1), ' ',
+                __right__, false);
+        }
+        __log_printf("|\n");
+
+        uint32_t j;
+        for(j = 0; j < p_st->trans_table_size; ++j)
+        {
+            input_id_t in_id = p_st->trans_table[j].input_id;
+            const char* in_str = in_id < p_sm->desc->inputs_table_size &&
+                p_sm->desc->inputs_table[in_id].name ?
+                    p_sm->desc->inputs_table[in_id].name : null_str;
+
+            snprintf(line, sizeof(line), "    %2d: %s", in_id, in_str);
+            snprintf(num_str, sizeof(num_str), "%u", p_st->trans_hits[j]);
+            __log_printf("|"__blue__);
+            __log_printf_field(line, __width - 12, ' ', __left__, false);
+            __log_printf(__default__);
+            __log_printf_field(num_str, 12, ' ', __right__, false);
+            __log_printf("|\n");
+        }
+        __log_printf("+%"__stringify(__width)"c+", '-');
+    }
+}
+#endif /* CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING */
+
 void state_machine_print(state_machine_t* p_sm)
 {
     // -- state machine name
     __log_printf("+%"__stringify(__width)"c+\n", '-');
 
-    __log_printf("|%+-"__stringify(__width)"s|\n", p_sm->name);
+    __log_printf("|%+-"__stringify(__width)"s|\n",
+        __name_str(p_sm->desc->name));
 
     // -- inputs, actions, states
     __log_printf("+");
@@ -177,14 +426,14 @@ void state_machine_print(state_machine_t* p_sm)
     __log_printf_field("actions", __col_w(3, 3,__width, 1), ' ',__left__,false);
     __log_printf("|\n");
 
-    int count_inputs  = p_sm->inputs_table_size;
-    int count_actions = p_sm->actions_table_size;
-    int count_states  = p_sm->state_table_size;
+    int count_inputs  = p_sm->desc->inputs_table_size;
+    int count_actions = p_sm->desc->actions_table_size;
+    int count_states  = p_sm->desc->state_table_size;
     int i = 0, j = 0, k = 0;
 
-    input_table_t*  p_inputs  = p_sm->inputs_table;
-    action_table_t* p_actions = p_sm->actions_table;
-    state_table_t*  p_states  = p_sm->state_table;
+    const input_table_t*  p_inputs  = p_sm->desc->inputs_table;
+    const action_table_t* p_actions = p_sm->desc->actions_table;
+    const state_table_t*  p_states  = p_sm->desc->state_table;
 
     while( count_actions || count_inputs || count_states )
     {
@@ -257,7 +506,7 @@ void state_machine_print(state_machine_t* p_sm)
     __log_printf("+%"__stringify(__width)"c+", '-');
 
     const char* tr_table_str = " transition table of ";
-    count_states  = p_sm->state_table_size;
+    count_states  = p_sm->desc->state_table_size;
     for(i = 0; i < count_states; ++i)
     {
         const char* state_name = p_states[i].name ? p_states[i].name : null_str;
@@ -273,7 +522,7 @@ void state_machine_print(state_machine_t* p_sm)
         __log_printf("|\n");
 
         int tr_count = p_states[i].trans_table_size;
-        state_trans_table_t* p_tr = p_states[i].trans_table;
+        const state_trans_table_t* p_tr = p_states[i].trans_table;
 
         for(j = 0; j < tr_count; ++j)
         {
@@ -306,6 +555,10 @@ void state_machine_print(state_machine_t* p_sm)
         __log_printf("+%"__stringify(__width)"c+", '-');
     }
 
+    #ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+    state_machine_print_prof(p_sm);
+    #endif
+
     __log_endl();
 }
 
@@ -320,20 +573,23 @@ void state_machine_run(state_machine_t* p_sm, input_id_t input_id, void* data)
     if( !p_sm )
         return;
 
+    __prof_run(p_sm);
+
     state_id_t      present_state_id = p_sm->present_state;
-    state_table_t*  p_state = present_state_id < p_sm->state_table_size ?
-        & p_sm->state_table[present_state_id] : NULL;
+    const state_table_t* p_state =
+        present_state_id < p_sm->desc->state_table_size ?
+        & p_sm->desc->state_table[present_state_id] : NULL;
 
-    input_table_t* p_input = input_id < p_sm->inputs_table_size ?
-        & p_sm->inputs_table[input_id] : NULL;
+    const input_table_t* p_input = input_id < p_sm->desc->inputs_table_size ?
+        & p_sm->desc->inputs_table[input_id] : NULL;
 
-    state_trans_table_t* p_trans = p_state ? p_state->trans_table : NULL;
+    const state_trans_table_t* p_trans = p_state ? p_state->trans_table : NULL;
     uint32_t entries = p_state ? p_state->trans_table_size : 0;
 
-    action_table_t* p_action = NULL;
+    const action_table_t* p_action = NULL;
     action_id_t     action_id = 0;
 
-    state_table_t*  p_next_state = NULL;
+    const state_table_t*  p_next_state = NULL;
     state_id_t      next_state_id = 0;
 
     const char * err_msg = NULL;
@@ -353,12 +609,12 @@ void state_machine_run(state_machine_t* p_sm, input_id_t input_id, void* data)
         if( input_id == p_trans->input_id )
         {
             action_id = p_trans->action_id;
-            p_action = action_id < p_sm->actions_table_size ?
-                & p_sm->actions_table[action_id] : NULL;
+            p_action = action_id < p_sm->desc->actions_table_size ?
+                & p_sm->desc->actions_table[action_id] : NULL;
 
             next_state_id = p_trans->next_state_id;
-            p_next_state = next_state_id < p_sm->state_table_size ?
-                & p_sm->state_table[next_state_id] : NULL;
+            p_next_state = next_state_id < p_sm->desc->state_table_size ?
+                & p_sm->desc->state_table[next_state_id] : NULL;
 
             err_msg = NULL;
             if( ! p_action && ! p_next_state )
@@ -371,6 +627,8 @@ void state_machine_run(state_machine_t* p_sm, input_id_t input_id, void* data)
             if( err_msg )
                 goto report_error_and_exit;
 
+            __prof_trans_hit(p_state, p_trans - p_state->trans_table);
+
             const char* msg = NULL;
             if( present_state_id != next_state_id )
             {
@@ -385,6 +643,8 @@ void state_machine_run(state_machine_t* p_sm, input_id_t input_id, void* data)
                 input_id, p_input, action_id, p_action, next_state_id,
                 p_next_state, false, false, msg != NULL, msg);
 
+            __prof_action_start(action_start);
+
             if( present_state_id != next_state_id )
             {
                 if(p_state->leave)
@@ -398,10 +658,12 @@ void state_machine_run(state_machine_t* p_sm, input_id_t input_id, void* data)
                 p_action->fun(data);
             }
 
+            __prof_action_end(p_sm, action_start);
+
             if(p_sm->state_changed_manually)
             {
                 next_state_id = p_sm->present_state;
-                p_next_state = & p_sm->state_table[next_state_id];
+                p_next_state = & p_sm->desc->state_table[next_state_id];
 
                 state_machine_log_state_trans(p_sm, present_state_id, p_state,
                     input_id, p_input, action_id, p_action, next_state_id,
@@ -409,6 +671,7 @@ void state_machine_run(state_machine_t* p_sm, input_id_t input_id, void* data)
             }
             else
             {
+                __prof_state_change(p_sm, present_state_id, next_state_id);
                 p_sm->present_state = next_state_id;
             }
 
@@ -423,6 +686,7 @@ void state_machine_run(state_machine_t* p_sm, input_id_t input_id, void* data)
             input_id, p_input, action_id, p_action, next_state_id,
             p_next_state, false, true, false, "running default state action");
 
+        __prof_default(p_sm, present_state_id);
         p_state->default_action(data);
     }
     else
@@ -430,12 +694,16 @@ void state_machine_run(state_machine_t* p_sm, input_id_t input_id, void* data)
         state_machine_log_state_trans(p_sm, present_state_id, p_state,
             input_id, p_input, action_id, p_action, next_state_id,
             p_next_state, false, true, false, "un-handled input");
+
+        __prof_unhandled(p_sm);
     }
 
     return;
 
     report_error_and_exit:
 
+    __prof_error(p_sm);
+
     state_machine_log_state_trans(p_sm, present_state_id, p_state,
         input_id, p_input, action_id, p_action, next_state_id,
         p_next_state, true, false, false, err_msg);
@@ -446,8 +714,10 @@ void state_machine_change_state_manually(state_machine_t* p_sm,
 {
     __log_assert(p_sm, "invalid state machine pointer");
 
-    __log_assert(ns_id < p_sm->inputs_table_size,
-        "invalid state machine input id");
+    __log_assert(ns_id < p_sm->desc->state_table_size,
+        "invalid state machine state id");
+
+    __prof_state_change(p_sm, p_sm->present_state, ns_id);
 
     p_sm->present_state = ns_id;
     p_sm->state_changed_manually = true;
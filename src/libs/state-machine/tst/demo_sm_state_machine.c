@@ -18,46 +18,46 @@ void __sm_action_fun(demo_sm, D_leave)(void* data);
 
 
 /* --- INPUTS --------------------------------------------------------------- */
-static input_table_t sm_demo_sm_inputs_table[] = {
-    [__sm_input_id(demo_sm, x)] = { "x" },
-    [__sm_input_id(demo_sm, y)] = { "y" },
-    [__sm_input_id(demo_sm, z)] = { "z" },
-    [__sm_input_id(demo_sm, w)] = { "w" },
+static const input_table_t sm_demo_sm_inputs_table[] = {
+    [__sm_input_id(demo_sm, x)] = { __sm_name("x") },
+    [__sm_input_id(demo_sm, y)] = { __sm_name("y") },
+    [__sm_input_id(demo_sm, z)] = { __sm_name("z") },
+    [__sm_input_id(demo_sm, w)] = { __sm_name("w") },
 };
 #define sm_demo_sm_inputs_table_size \
     (sizeof(sm_demo_sm_inputs_table)/sizeof(input_table_t))
 
 /* --- ACTIONS -------------------------------------------------------------- */
-static action_table_t sm_demo_sm_actions_table[] = {
+static const action_table_t sm_demo_sm_actions_table[] = {
     [__sm_action_id(demo_sm, action_a_b)] = {
-        "action_a_b",
+        __sm_name("action_a_b"),
         __sm_action_fun(demo_sm, action_a_b)},
     [__sm_action_id(demo_sm, action_a_c)] = {
-        "action_a_c",
+        __sm_name("action_a_c"),
         __sm_action_fun(demo_sm, action_a_c)},
     [__sm_action_id(demo_sm, action_a_d)] = {
-        "action_a_d",
+        __sm_name("action_a_d"),
         __sm_action_fun(demo_sm, action_a_d)},
     [__sm_action_id(demo_sm, do_nothing)] = {
-        "do_nothing",
+        __sm_name("do_nothing"),
         0},
     [__sm_action_id(demo_sm, action_b_a)] = {
-        "action_b_a",
+        __sm_name("action_b_a"),
         __sm_action_fun(demo_sm, action_b_a)},
     [__sm_action_id(demo_sm, action_b_c)] = {
-        "action_b_c",
+        __sm_name("action_b_c"),
         __sm_action_fun(demo_sm, action_b_c)},
     [__sm_action_id(demo_sm, action_b_d)] = {
-        "action_b_d",
+        __sm_name("action_b_d"),
         __sm_action_fun(demo_sm, action_b_d)},
     [__sm_action_id(demo_sm, action_c_a)] = {
-        "action_c_a",
+        __sm_name("action_c_a"),
         __sm_action_fun(demo_sm, action_c_a)},
     [__sm_action_id(demo_sm, action_c_d)] = {
-        "action_c_d",
+        __sm_name("action_c_d"),
         __sm_action_fun(demo_sm, action_c_d)},
     [__sm_action_id(demo_sm, action_d_a)] = {
-        "action_d_a",
+        __sm_name("action_d_a"),
         __sm_action_fun(demo_sm, action_d_a)},
 };
 #define sm_demo_sm_actions_table_size \
@@ -65,7 +65,7 @@ static action_table_t sm_demo_sm_actions_table[] = {
 
 /* --- STATES --------------------------------------------------------------- */
 /* --- state -> A ----------------------------------------------------------- */
-static state_trans_table_t sm_demo_sm_A_trans_table [] = {
+static const state_trans_table_t sm_demo_sm_A_trans_table [] = {
     {
         .input_id = __sm_input_id(demo_sm, x),
         .action_id = __sm_action_id(demo_sm, action_a_b),
@@ -89,9 +89,12 @@ static state_trans_table_t sm_demo_sm_A_trans_table [] = {
 };
 #define sm_demo_sm_A_trans_table_size \
     (sizeof(sm_demo_sm_A_trans_table)/sizeof(state_trans_table_t))
+#ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+static uint32_t sm_demo_sm_A_trans_hits [sm_demo_sm_A_trans_table_size];
+#endif
 
 /* --- state -> B ----------------------------------------------------------- */
-static state_trans_table_t sm_demo_sm_B_trans_table [] = {
+static const state_trans_table_t sm_demo_sm_B_trans_table [] = {
     {
         .input_id = __sm_input_id(demo_sm, x),
         .action_id = __sm_action_id(demo_sm, action_b_a),
@@ -110,9 +113,12 @@ static state_trans_table_t sm_demo_sm_B_trans_table [] = {
 };
 #define sm_demo_sm_B_trans_table_size \
     (sizeof(sm_demo_sm_B_trans_table)/sizeof(state_trans_table_t))
+#ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+static uint32_t sm_demo_sm_B_trans_hits [sm_demo_sm_B_trans_table_size];
+#endif
 
 /* --- state -> C ----------------------------------------------------------- */
-static state_trans_table_t sm_demo_sm_C_trans_table [] = {
+static const state_trans_table_t sm_demo_sm_C_trans_table [] = {
     {
         .input_id = __sm_input_id(demo_sm, x),
         .action_id = __sm_action_id(demo_sm, do_nothing),
@@ -131,9 +137,12 @@ static state_trans_table_t sm_demo_sm_C_trans_table [] = {
 };
 #define sm_demo_sm_C_trans_table_size \
     (sizeof(sm_demo_sm_C_trans_table)/sizeof(state_trans_table_t))
+#ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+static uint32_t sm_demo_sm_C_trans_hits [sm_demo_sm_C_trans_table_size];
+#endif
 
 /* --- state -> D ----------------------------------------------------------- */
-static state_trans_table_t sm_demo_sm_D_trans_table [] = {
+static const state_trans_table_t sm_demo_sm_D_trans_table [] = {
     {
         .input_id = __sm_input_id(demo_sm, x),
         .action_id = __sm_action_id(demo_sm, do_nothing),
@@ -152,37 +161,52 @@ static state_trans_table_t sm_demo_sm_D_trans_table [] = {
 };
 #define sm_demo_sm_D_trans_table_size \
     (sizeof(sm_demo_sm_D_trans_table)/sizeof(state_trans_table_t))
+#ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+static uint32_t sm_demo_sm_D_trans_hits [sm_demo_sm_D_trans_table_size];
+#endif
 
 /* --- states-table --------------------------------------------------------- */
-static state_table_t sm_demo_sm_states_table [] = {
+static const state_table_t sm_demo_sm_states_table [] = {
     [__sm_state_id(demo_sm, A)] = {
-        .name = "A",
+        .name = __sm_name("A"),
         .trans_table = sm_demo_sm_A_trans_table,
         .trans_table_size = sm_demo_sm_A_trans_table_size,
+        #ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+        .trans_hits = sm_demo_sm_A_trans_hits,
+        #endif
         .default_action = __sm_action_fun(demo_sm, A_default),
         .enter = __sm_action_fun(demo_sm, A_enter),
         .leave = __sm_action_fun(demo_sm, A_leave),
     },
     [__sm_state_id(demo_sm, B)] = {
-        .name = "B",
+        .name = __sm_name("B"),
         .trans_table = sm_demo_sm_B_trans_table,
         .trans_table_size = sm_demo_sm_B_trans_table_size,
+        #ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+        .trans_hits = sm_demo_sm_B_trans_hits,
+        #endif
         .default_action = __sm_action_fun(demo_sm, B_default),
         .enter = __sm_action_fun(demo_sm, B_enter),
         .leave = __sm_action_fun(demo_sm, B_leave),
     },
     [__sm_state_id(demo_sm, C)] = {
-        .name = "C",
+        .name = __sm_name("C"),
         .trans_table = sm_demo_sm_C_trans_table,
         .trans_table_size = sm_demo_sm_C_trans_table_size,
+        #ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+        .trans_hits = sm_demo_sm_C_trans_hits,
+        #endif
         .default_action = __sm_action_fun(demo_sm, C_default),
         .enter = __sm_action_fun(demo_sm, C_enter),
         .leave = __sm_action_fun(demo_sm, C_leave),
     },
     [__sm_state_id(demo_sm, D)] = {
-        .name = "D",
+        .name = __sm_name("D"),
         .trans_table = sm_demo_sm_D_trans_table,
         .trans_table_size = sm_demo_sm_D_trans_table_size,
+        #ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+        .trans_hits = sm_demo_sm_D_trans_hits,
+        #endif
         .default_action = __sm_action_fun(demo_sm, D_default),
         .enter = __sm_action_fun(demo_sm, D_enter),
         .leave = __sm_action_fun(demo_sm, D_leave),
@@ -190,12 +214,20 @@ static state_table_t sm_demo_sm_states_table [] = {
 };
 #define sm_demo_sm_states_table_size \
     (sizeof(sm_demo_sm_states_table)/sizeof(state_table_t))
+#ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+static state_prof_t sm_demo_sm_states_prof [sm_demo_sm_states_table_size];
+#endif
 
 
 /* --- MACHINE -------------------------------------------------------------- */
 
-state_machine_t __sm_machine_id(demo_sm) = {
-    .name = "demo_sm",
+#define sm_demo_sm_ids_bits  8
+#if sm_demo_sm_ids_bits > __SM_TABLE_ID_BITS
+#error "state machine 'demo_sm' needs 8-bits ids, enable CONFIG_SDK_LIBS_STATE_MACHINE_16_BITS_IDS"
+#endif
+
+static const state_machine_desc_t sm_demo_sm_desc = {
+    .name = __sm_name("demo_sm"),
     .inputs_table = sm_demo_sm_inputs_table,
     .inputs_table_size = sm_demo_sm_inputs_table_size,
     .actions_table = sm_demo_sm_actions_table,
@@ -204,6 +236,15 @@ state_machine_t __sm_machine_id(demo_sm) = {
     .state_table_size = sm_demo_sm_states_table_size,
 };
 
+state_machine_t __sm_machine_id(demo_sm) = {
+    .desc = &sm_demo_sm_desc,
+    #ifdef CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING
+    .prof = {
+        .states = sm_demo_sm_states_prof,
+    },
+    #endif
+};
+
 /* --- end of file ---------------------------------------------------------- */
 
 #endif /* CONFIG_SDK_LIBS_EXAMPLE_STATE_MACHINE */
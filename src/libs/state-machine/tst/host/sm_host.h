@@ -0,0 +1,67 @@
+/** -------------------------------------------------------------------------- *
+ * @copyright Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ * @author  Ahmed Sabry (SG Wireless)
+ * 
+ * @brief   host test harness interface for the generated state machines.
+ * --------------------------------------------------------------------------- *
+ */
+#ifndef __SM_HOST_H__
+#define __SM_HOST_H__
+
+/** -------------------------------------------------------------------------- *
+ * includes
+ * --------------------------------------------------------------------------- *
+ */
+#include <stdint.h>
+#include "state_machine.h"
+
+/** -------------------------------------------------------------------------- *
+ * typedefs
+ * --------------------------------------------------------------------------- *
+ */
+typedef struct {
+    const char*         name;
+    state_machine_t*    p_sm;
+    const state_id_t*   ch_states;      /**< targets of __sm_ch_state() */
+    uint32_t            ch_states_count;
+} sm_host_machine_t;
+
+/** -------------------------------------------------------------------------- *
+ * generated by sm_host_stubs_gen.py
+ * --------------------------------------------------------------------------- *
+ */
+extern sm_host_machine_t g_sm_host_machines[];
+extern uint32_t g_sm_host_machines_count;
+
+/** -------------------------------------------------------------------------- *
+ * APIs
+ * --------------------------------------------------------------------------- *
+ */
+
+/**
+ * @brief   called by every stubbed action, it may emulate a manual state
+ *          change according to the harness options.
+ */
+void sm_host_action_hook(state_machine_t* p_sm, void* data);
+
+#endif /* __SM_HOST_H__ */
+/* --- end of file ---------------------------------------------------------- */
@@ -0,0 +1,580 @@
+/** -------------------------------------------------------------------------- *
+ * @copyright Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ * @author  Ahmed Sabry (SG Wireless)
+ * 
+ * @brief   host test harness for the generated state machines. It runs the
+ *          generated tables with stubbed actions in two modes:
+ *          - replay: feeds a recorded events trace and verifies the states
+ *          - fuzz:   feeds a randomized inputs stream
+ *          then it reports the dispatch throughput and the machines coverage
+ *          (hit/never-hit transitions, unreachable and never visited states,
+ *          inputs that hit missing transitions).
+ * --------------------------------------------------------------------------- *
+ */
+
+/** -------------------------------------------------------------------------- *
+ * includes
+ * --------------------------------------------------------------------------- *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "log_lib.h"
+#include "state_machine.h"
+#include "sm_host.h"
+
+/** -------------------------------------------------------------------------- *
+ * trace file format
+ * =================
+ *  - one event per line:   <machine> <input> [<expected-next-state>]
+ *  - forcing a state:      <machine> =<state>
+ *  - '#' starts a comment, empty lines are ignored
+ *  - inputs and states are given by name or by numeric id
+ * --------------------------------------------------------------------------- *
+ */
+
+/** -------------------------------------------------------------------------- *
+ * harness context
+ * --------------------------------------------------------------------------- *
+ */
+typedef struct {
+    uint32_t*   unhandled;      /**< [state][input] missing transitions hits */
+    uint8_t*    visited;        /**< [state] visited flags */
+    uint64_t    dispatches;
+    uint64_t    time_ns;
+} sm_host_cov_t;
+
+static struct {
+    uint32_t        seed;
+    uint32_t        manual_change_pct;
+    sm_host_cov_t*  cov;
+} s_host = {
+    .seed = 0x5eed1234,
+    .manual_change_pct = 5,
+};
+
+static uint32_t sm_host_rand(void)
+{
+    // -- xorshift32
+    uint32_t x = s_host.seed;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    s_host.seed = x;
+    return x;
+}
+
+static uint64_t sm_host_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static sm_host_machine_t* sm_host_find_machine(const char* name)
+{
+    uint32_t i;
+    for(i = 0; i < g_sm_host_machines_count; ++i)
+        if(strcmp(g_sm_host_machines[i].name, name) == 0)
+            return &g_sm_host_machines[i];
+    return NULL;
+}
+
+static uint32_t sm_host_machine_index(state_machine_t* p_sm)
+{
+    uint32_t i;
+    for(i = 0; i < g_sm_host_machines_count; ++i)
+        if(g_sm_host_machines[i].p_sm == p_sm)
+            break;
+    return i;
+}
+
+static bool sm_host_find_id(const char* token, uint32_t count,
+    const char* (*get_name)(const state_machine_desc_t*, uint32_t),
+    const state_machine_desc_t* p_desc, uint32_t* p_id)
+{
+    char* end;
+    unsigned long id = strtoul(token, &end, 0);
+    if(*token && *end == '\0')
+    {
+        *p_id = id;
+        return id < count;
+    }
+
+    uint32_t i;
+    for(i = 0; i < count; ++i)
+    {
+        const char* name = get_name(p_desc, i);
+        if(name && strcmp(name, token) == 0)
+        {
+            *p_id = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+static const char* get_input_name(const state_machine_desc_t* p_desc,
+    uint32_t id)
+{
+    return p_desc->inputs_table[id].name;
+}
+
+static const char* get_state_name(const state_machine_desc_t* p_desc,
+    uint32_t id)
+{
+    return p_desc->state_table[id].name;
+}
+
+static const char* get_action_name(const state_machine_desc_t* p_desc,
+    uint32_t id)
+{
+    return p_desc->actions_table[id].name;
+}
+
+#define __name_or_id(_get, _desc, _id, _buf)                            \
+    ( _get(_desc, _id) ? _get(_desc, _id) :                             \
+        (snprintf(_buf, sizeof(_buf), "#%u", (unsigned)(_id)), _buf) )
+
+/** -------------------------------------------------------------------------- *
+ * machines handling
+ * --------------------------------------------------------------------------- *
+ */
+void sm_host_action_hook(state_machine_t* p_sm, void* data)
+{
+    (void)data;
+
+    if(s_host.manual_change_pct == 0)
+        return;
+
+    sm_host_machine_t* p_m =
+        &g_sm_host_machines[sm_host_machine_index(p_sm)];
+
+    if(p_m->ch_states_count &&
+        sm_host_rand() % 100 < s_host.manual_change_pct)
+    {
+        state_machine_change_state_manually(p_sm,
+            p_m->ch_states[sm_host_rand() % p_m->ch_states_count]);
+    }
+}
+
+static void sm_host_reset_machine(uint32_t idx)
+{
+    state_machine_t* p_sm = g_sm_host_machines[idx].p_sm;
+    p_sm->present_state = 0;
+    p_sm->state_changed_manually = false;
+    s_host.cov[idx].visited[0] = 1;
+}
+
+static void sm_host_init(void)
+{
+    uint32_t i;
+    s_host.cov = calloc(g_sm_host_machines_count, sizeof(sm_host_cov_t));
+    for(i = 0; i < g_sm_host_machines_count; ++i)
+    {
+        const state_machine_desc_t* p_desc = g_sm_host_machines[i].p_sm->desc;
+        s_host.cov[i].unhandled = calloc(
+            p_desc->state_table_size * p_desc->inputs_table_size,
+            sizeof(uint32_t));
+        s_host.cov[i].visited = calloc(p_desc->state_table_size, 1);
+        state_machine_prof_reset(g_sm_host_machines[i].p_sm);
+        sm_host_reset_machine(i);
+    }
+}
+
+/**
+ * runs one input and records the coverage information, it returns false if
+ * the input hit a missing transition
+ */
+static inline bool sm_host_dispatch(uint32_t idx, uint32_t input_id)
+{
+    state_machine_t* p_sm = g_sm_host_machines[idx].p_sm;
+    sm_host_cov_t* p_cov = &s_host.cov[idx];
+    state_id_t ps = p_sm->present_state;
+    uint32_t unhandled = p_sm->prof.unhandled;
+
+    state_machine_run(p_sm, input_id, NULL);
+
+    p_cov->visited[p_sm->present_state] = 1;
+    if(unhandled != p_sm->prof.unhandled)
+    {
+        ++ p_cov->unhandled[ps * p_sm->desc->inputs_table_size + input_id];
+        return false;
+    }
+    return true;
+}
+
+/** -------------------------------------------------------------------------- *
+ * reporting
+ * --------------------------------------------------------------------------- *
+ */
+static void sm_host_report(uint32_t idx)
+{
+    sm_host_machine_t* p_m = &g_sm_host_machines[idx];
+    const state_machine_desc_t* p_desc = p_m->p_sm->desc;
+    sm_host_cov_t* p_cov = &s_host.cov[idx];
+    uint32_t st_count = p_desc->state_table_size;
+    uint32_t in_count = p_desc->inputs_table_size;
+    char b1[16], b2[16], b3[16];
+    uint32_t i, j;
+
+    if(p_cov->dispatches == 0)
+        return;
+
+    printf("=== %s: %llu inputs", p_m->name,
+        (unsigned long long)p_cov->dispatches);
+    if(p_cov->time_ns)
+        printf(", %.1f ns/input, %.2f M inputs/sec",
+            (double)p_cov->time_ns / p_cov->dispatches,
+            (double)p_cov->dispatches * 1000.0 / p_cov->time_ns);
+    printf("\n");
+
+    // -- transitions coverage
+    uint32_t trans_total = 0, trans_hit = 0;
+    for(i = 0; i < st_count; ++i)
+    {
+        const state_table_t* p_st = &p_desc->state_table[i];
+        for(j = 0; j < p_st->trans_table_size; ++j)
+        {
+            ++ trans_total;
+            if(p_st->trans_hits[j])
+                ++ trans_hit;
+        }
+    }
+    printf("  transitions hit       : %u/%u (%.1f%%)\n", trans_hit,
+        trans_total, trans_total ? 100.0 * trans_hit / trans_total : 0.0);
+
+    // -- static reachability from the initial state and the manual targets
+    uint8_t* reachable = calloc(st_count, 1);
+    state_id_t* queue = calloc(st_count, sizeof(state_id_t));
+    uint32_t head = 0, tail = 0;
+    reachable[0] = 1;
+    queue[tail++] = 0;
+    for(i = 0; i < p_m->ch_states_count; ++i)
+        if(! reachable[p_m->ch_states[i]])
+        {
+            reachable[p_m->ch_states[i]] = 1;
+            queue[tail++] = p_m->ch_states[i];
+        }
+    while(head < tail)
+    {
+        const state_table_t* p_st = &p_desc->state_table[queue[head++]];
+        for(j = 0; j < p_st->trans_table_size; ++j)
+        {
+            state_id_t ns = p_st->trans_table[j].next_state_id;
+            if(! reachable[ns])
+            {
+                reachable[ns] = 1;
+                queue[tail++] = ns;
+            }
+        }
+    }
+
+    uint32_t visited = 0;
+    for(i = 0; i < st_count; ++i)
+        visited += p_cov->visited[i];
+    printf("  states visited        : %u/%u\n", visited, st_count);
+
+    printf("  unreachable states    :");
+    for(i = 0, j = 0; i < st_count; ++i)
+        if(! reachable[i])
+            printf(" %s", __name_or_id(get_state_name, p_desc, i, b1)), ++j;
+    printf(j ? "\n" : " none\n");
+
+    printf("  never visited states  :");
+    for(i = 0, j = 0; i < st_count; ++i)
+        if(! p_cov->visited[i])
+            printf(" %s", __name_or_id(get_state_name, p_desc, i, b1)), ++j;
+    printf(j ? "\n" : " none\n");
+
+    free(queue);
+    free(reachable);
+
+    if(trans_hit != trans_total)
+    {
+        printf("  never hit transitions :\n");
+        for(i = 0; i < st_count; ++i)
+        {
+            const state_table_t* p_st = &p_desc->state_table[i];
+            for(j = 0; j < p_st->trans_table_size; ++j)
+            {
+                const state_trans_table_t* p_tr = &p_st->trans_table[j];
+                if(p_st->trans_hits[j])
+                    continue;
+                printf("      %s --%s/%s--> %s\n",
+                    __name_or_id(get_state_name, p_desc, i, b1),
+                    __name_or_id(get_input_name, p_desc, p_tr->input_id, b2),
+                    __name_or_id(get_action_name, p_desc, p_tr->action_id,b3),
+                    __name_or_id(get_state_name, p_desc,
+                        p_tr->next_state_id, b1));
+            }
+        }
+    }
+
+    bool header = false;
+    for(i = 0; i < st_count; ++i)
+        for(j = 0; j < in_count; ++j)
+        {
+            uint32_t count = p_cov->unhandled[i * in_count + j];
+            if(! count)
+                continue;
+            if(! header)
+            {
+                printf("  missing transitions hit (state / input : count):\n");
+                header = true;
+            }
+            printf("      %s / %s : %u\n",
+                __name_or_id(get_state_name, p_desc, i, b1),
+                __name_or_id(get_input_name, p_desc, j, b2), count);
+        }
+    if(! header)
+        printf("  missing transitions hit: none\n");
+}
+
+/** -------------------------------------------------------------------------- *
+ * replay mode
+ * --------------------------------------------------------------------------- *
+ */
+static int sm_host_replay(const char* filename)
+{
+    FILE* f = fopen(filename, "r");
+    if(! f)
+    {
+        printf("error: can not open trace file '%s'\n", filename);
+        return 1;
+    }
+
+    char line[256];
+    uint32_t line_num = 0;
+    uint32_t errors = 0;
+
+    while(fgets(line, sizeof(line), f))
+    {
+        ++ line_num;
+        char* comment = strchr(line, '#');
+        if(comment)
+            *comment = '\0';
+
+        char* sm_name = strtok(line, " \t\r\n");
+        char* input = strtok(NULL, " \t\r\n");
+        char* expected = strtok(NULL, " \t\r\n");
+        if(! sm_name)
+            continue;
+
+        sm_host_machine_t* p_m = sm_host_find_machine(sm_name);
+        if(! p_m || ! input)
+        {
+            printf("%s:%u: error: bad event line\n", filename, line_num);
+            ++ errors;
+            continue;
+        }
+
+        uint32_t idx = sm_host_machine_index(p_m->p_sm);
+        const state_machine_desc_t* p_desc = p_m->p_sm->desc;
+        uint32_t id;
+
+        if(input[0] == '=')
+        {
+            if(! sm_host_find_id(input + 1, p_desc->state_table_size,
+                    get_state_name, p_desc, &id))
+            {
+                printf("%s:%u: error: unknown state '%s'\n",
+                    filename, line_num, input + 1);
+                ++ errors;
+                continue;
+            }
+            state_machine_change_state_manually(p_m->p_sm, id);
+            p_m->p_sm->state_changed_manually = false;
+            s_host.cov[idx].visited[id] = 1;
+            continue;
+        }
+
+        if(! sm_host_find_id(input, p_desc->inputs_table_size,
+                get_input_name, p_desc, &id))
+        {
+            printf("%s:%u: error: unknown input '%s'\n",
+                filename, line_num, input);
+            ++ errors;
+            continue;
+        }
+
+        char b1[16], b2[16];
+        state_id_t ps = p_m->p_sm->present_state;
+        uint64_t start = sm_host_now_ns();
+        bool handled = sm_host_dispatch(idx, id);
+        s_host.cov[idx].time_ns += sm_host_now_ns() - start;
+        ++ s_host.cov[idx].dispatches;
+
+        if(! handled)
+            printf("%s:%u: warn: missing transition %s / %s\n", filename,
+                line_num, __name_or_id(get_state_name, p_desc, ps, b1),
+                __name_or_id(get_input_name, p_desc, id, b2));
+
+        if(expected)
+        {
+            uint32_t exp_id;
+            if(! sm_host_find_id(expected, p_desc->state_table_size,
+                    get_state_name, p_desc, &exp_id))
+            {
+                printf("%s:%u: error: unknown state '%s'\n",
+                    filename, line_num, expected);
+                ++ errors;
+            }
+            else if(exp_id != p_m->p_sm->present_state)
+            {
+                printf("%s:%u: error: expected state '%s', got '%s'\n",
+                    filename, line_num, expected,
+                    __name_or_id(get_state_name, p_desc,
+                        p_m->p_sm->present_state, b1));
+                ++ errors;
+            }
+        }
+    }
+
+    fclose(f);
+    printf("--- replayed '%s': %u lines, %u errors\n",
+        filename, line_num, errors);
+    return errors ? 1 : 0;
+}
+
+/** -------------------------------------------------------------------------- *
+ * fuzz mode
+ * --------------------------------------------------------------------------- *
+ */
+static void sm_host_fuzz(uint32_t idx, uint32_t count, uint32_t reset_period)
+{
+    state_machine_t* p_sm = g_sm_host_machines[idx].p_sm;
+    uint32_t in_count = p_sm->desc->inputs_table_size;
+    uint32_t i;
+
+    uint64_t start = sm_host_now_ns();
+    for(i = 0; i < count; ++i)
+    {
+        if(reset_period && i % reset_period == 0)
+            sm_host_reset_machine(idx);
+        sm_host_dispatch(idx, sm_host_rand() % in_count);
+    }
+    s_host.cov[idx].time_ns += sm_host_now_ns() - start;
+    s_host.cov[idx].dispatches += count;
+}
+
+/** -------------------------------------------------------------------------- *
+ * main
+ * --------------------------------------------------------------------------- *
+ */
+static void sm_host_usage(const char* prog)
+{
+    printf("usage:\n");
+    printf("  %s list\n", prog);
+    printf("  %s replay <trace-file>+\n", prog);
+    printf("  %s fuzz [-n <inputs>] [-s <seed>] [-m <manual-change-%%>]\n"
+           "        [-r <reset-period>] [<machine>]\n", prog);
+}
+
+int main(int argc, char** argv)
+{
+    log_init(NULL);
+
+    if(argc < 2)
+    {
+        sm_host_usage(argv[0]);
+        return 1;
+    }
+
+    sm_host_init();
+
+    uint32_t i;
+    int ret = 0;
+
+    if(strcmp(argv[1], "list") == 0)
+    {
+        for(i = 0; i < g_sm_host_machines_count; ++i)
+        {
+            const state_machine_desc_t* p_desc =
+                g_sm_host_machines[i].p_sm->desc;
+            printf("%s: %u states, %u inputs, %u actions\n",
+                g_sm_host_machines[i].name, p_desc->state_table_size,
+                p_desc->inputs_table_size, p_desc->actions_table_size);
+        }
+        return 0;
+    }
+    else if(strcmp(argv[1], "replay") == 0 && argc > 2)
+    {
+        // -- no emulated manual changes, the traces carry them explicitly
+        s_host.manual_change_pct = 0;
+        for(i = 2; i < (uint32_t)argc; ++i)
+            ret |= sm_host_replay(argv[i]);
+    }
+    else if(strcmp(argv[1], "fuzz") == 0)
+    {
+        uint32_t count = 1000000;
+        uint32_t reset_period = 0;
+        const char* machine = NULL;
+
+        for(i = 2; i < (uint32_t)argc; ++i)
+        {
+            if(argv[i][0] == '-' && i + 1 < (uint32_t)argc)
+            {
+                uint32_t val = strtoul(argv[i + 1], NULL, 0);
+                switch(argv[i][1])
+                {
+                    case 'n': count = val; break;
+                    case 's': s_host.seed = val ? val : 1; break;
+                    case 'm': s_host.manual_change_pct = val; break;
+                    case 'r': reset_period = val; break;
+                    default:
+                        sm_host_usage(argv[0]);
+                        return 1;
+                }
+                ++ i;
+            }
+            else
+            {
+                machine = argv[i];
+            }
+        }
+
+        printf("--- fuzzing: %u inputs/machine, seed 0x%08x, "
+            "manual changes %u%%\n", count, s_host.seed,
+            s_host.manual_change_pct);
+
+        for(i = 0; i < g_sm_host_machines_count; ++i)
+            if(! machine || strcmp(machine, g_sm_host_machines[i].name) == 0)
+                sm_host_fuzz(i, count, reset_period);
+    }
+    else
+    {
+        sm_host_usage(argv[0]);
+        return 1;
+    }
+
+    for(i = 0; i < g_sm_host_machines_count; ++i)
+        sm_host_report(i);
+
+    return ret;
+}
+
+/* --- end of file ---------------------------------------------------------- */
@@ -0,0 +1,141 @@
+# ---------------------------------------------------------------------------- #
+# Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files(the “Software”), to deal
+# in the Software without restriction, including without limitation the rights
+# to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+# copies  of  the  Software,  and  to  permit  persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+# IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+# AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+# Author    Ahmed Sabry (SG Wireless)
+#
+# Desc      This file generates the stubbed actions of the host test harness
+# ---------------------------------------------------------------------------- #
+
+# --- imports ---------------------------------------------------------------- #
+
+import sys
+import re
+import os
+
+# --- command lines arguments ------------------------------------------------ #
+# syntax:
+#   python <script-name> <gen-dir> <c-module-filename>+
+#
+# the state machines definition files are parsed for the same macros parsed
+# by the state_machine_gen.py, the generated file 'sm_host_stubs.c' contains:
+#   * an empty stub for every action/enter/leave/default function referenced
+#     by the generated tables, the stub calls sm_host_action_hook()
+#   * the list of the states targeted by __sm_ch_state() in every machine, so
+#     that the harness can emulate the manual state changes
+#   * the machines registry 'g_sm_host_machines[]'
+
+def user_cmd_check():
+    if len(sys.argv) < 3:
+        print("error in calling script!")
+        print("   ---> python {} <gen-dir> <c-module-filename> +"\
+              .format(os.path.basename(sys.argv[0])))
+        exit(1)
+    for file in sys.argv[2:]:
+        if not os.path.isfile(file):
+            print("error: passing non exist sm file '{}'".format(file))
+            exit(1)
+
+# --- regex filteration ------------------------------------------------------ #
+
+__W = r"\s*(\w+)\s*"
+__Wc = __W + ","
+
+regex_sm_trans  = r"\__sm_trans\s*\(" + __Wc + __Wc + __Wc + __Wc + __W + r"\)"
+regex_sm_action = r"\__sm_action\s*\(" + __Wc + __W + r"\)"
+regex_sm_default_action = r"\__sm_state_default_action\s*\(" + __Wc +__W + r"\)"
+regex_sm_state_enter = r"\__sm_state_enter\s*\(" + __Wc +__W + r"\)"
+regex_sm_state_leave = r"\__sm_state_leave\s*\(" + __Wc +__W + r"\)"
+regex_sm_ch_state = r"\__sm_ch_state\s*\(" + __Wc +__W + r"\)"
+
+def strip_comments(text):
+    text = re.sub(r"/\*.*?\*/", "", text, flags=re.S)
+    return re.sub(r"//[^\n]*", "", text)
+
+# --- main subroutine -------------------------------------------------------- #
+
+def main():
+    user_cmd_check()
+
+    machines = []
+    funs = {}
+    ch_states = {}
+
+    def add_unique(d, sm, it):
+        d.setdefault(sm, [])
+        if it not in d[sm]:
+            d[sm].append(it)
+
+    for filename in sys.argv[2:]:
+        with open(filename, 'r') as reader:
+            text = strip_comments(reader.read())
+        for it in re.findall(regex_sm_trans, text):
+            if it[0] not in machines:
+                machines.append(it[0])
+        for it in re.findall(regex_sm_action, text):
+            add_unique(funs, it[0], it[1])
+        for it in re.findall(regex_sm_default_action, text):
+            add_unique(funs, it[0], it[1] + '_default')
+        for it in re.findall(regex_sm_state_enter, text):
+            add_unique(funs, it[0], it[1] + '_enter')
+        for it in re.findall(regex_sm_state_leave, text):
+            add_unique(funs, it[0], it[1] + '_leave')
+        for it in re.findall(regex_sm_ch_state, text):
+            add_unique(ch_states, it[0], it[1])
+
+    f = open(os.path.join(sys.argv[1], 'sm_host_stubs.c'), 'w')
+    f.write('/* --- auto-generated host test stubs ' + '-' * 40 + ' */\n')
+    f.write('#include "state_machine.h"\n')
+    f.write('#include "sm_host.h"\n')
+    for sm in machines:
+        f.write('#include "{}_state_machine.h"\n'.format(sm))
+    f.write('\n')
+
+    for sm in machines:
+        f.write('/* --- {} '.format(sm) + '-' * (69 - len(sm)) + ' */\n')
+        for fun in funs.get(sm, []):
+            f.write('void __sm_action_fun({}, {})(void* data)\n'\
+                    .format(sm, fun))
+            f.write('{\n')
+            f.write('    sm_host_action_hook(&__sm_machine_id({}), data);\n'\
+                    .format(sm))
+            f.write('}\n')
+        f.write('static const state_id_t sm_{}_ch_states[] = {}\n'\
+                .format(sm, '{'))
+        for st in ch_states.get(sm, []):
+            f.write('    __sm_state_id({}, {}),\n'.format(sm, st))
+        f.write('};\n\n')
+
+    f.write('sm_host_machine_t g_sm_host_machines[] = {\n')
+    for sm in machines:
+        f.write('    {\n')
+        f.write('        .name = "{}",\n'.format(sm))
+        f.write('        .p_sm = &__sm_machine_id({}),\n'.format(sm))
+        f.write('        .ch_states = sm_{}_ch_states,\n'.format(sm))
+        f.write('        .ch_states_count = ' + \
+                'sizeof(sm_{0}_ch_states)/sizeof(state_id_t),\n'.format(sm))
+        f.write('    },\n')
+    f.write('};\n')
+    f.write('uint32_t g_sm_host_machines_count = {};\n'.format(len(machines)))
+    f.close()
+
+main()
+
+# --- end of file ------------------------------------------------------------ #
@@ -0,0 +1,132 @@
+# ---------------------------------------------------------------------------- #
+# Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files(the “Software”), to deal
+# in the Software without restriction, including without limitation the rights
+# to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+# copies  of  the  Software,  and  to  permit  persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+# IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+# AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+# Author    Ahmed Sabry (SG Wireless)
+#
+# Desc      This file contains the host build of the state-machines trace
+#           replay and fuzzing harness. It generates the LoRa raw and WAN
+#           state machines, stubs their actions and runs them on the host.
+#
+# usage     make -f sm_hosttest.mk [clean|build|test|fuzz|replay]
+#           make -f sm_hosttest.mk fuzz FUZZ_ARGS="-n 10000000 -s 7"
+#           make -f sm_hosttest.mk replay TRACES="my_trace.trace"
+# ---------------------------------------------------------------------------- #
+
+# --- targets ---------------------------------------------------------------- #
+input_targets   := clean build generate test fuzz replay
+default_targets := build test
+
+build_dir := build
+gen_dir   := ${build_dir}/gen
+
+sm_dir     := ../..
+libs_dir   := ../../..
+lora_dir   := ${libs_dir}/../comps/lora/src
+
+# state machines definition files
+sm_srcs := ${lora_dir}/lora_raw/lora_raw_process.c \
+           ${lora_dir}/lora_wan/lora_wan_process.c
+sm_names := lora_raw lora_wan
+
+srcs := $(notdir $(wildcard ./*.c))                             \
+        state_machine.c                                         \
+        $(notdir $(wildcard ${libs_dir}/logs/src/*.c))          \
+        utils_fs_path.c utils_bitarray.c                        \
+        $(addsuffix _state_machine.c,${sm_names})               \
+        sm_host_stubs.c
+
+sm_gens  := $(addprefix ${gen_dir}/,$(addsuffix _state_machine.c,${sm_names}))
+gens := ${gen_dir}/logs_gen_comp_ids.hh \
+        ${gen_dir}/logs_gen_structs.cc  \
+        ${sm_gens}                      \
+        ${gen_dir}/sm_host_stubs.c
+logs_gen_srcs := $(wildcard ${libs_dir}/logs/src/*.c)           \
+                 ${libs_dir}/logs/inc/log_lib.h                 \
+                 ${libs_dir}/utils/logs_defs.h                  \
+                 ${sm_dir}/src/state_machine.c
+
+objs := $(addprefix ${build_dir}/obj/,$(srcs:.c=.o))
+deps := $(objs:.o=.d)
+bin  := ${build_dir}/sm_host
+
+TRACES    ?= $(wildcard ./traces/*.trace)
+FUZZ_ARGS ?= -n 1000000
+
+incs :=                         \
+    ./                          \
+    ${sm_dir}/inc               \
+    ${libs_dir}/logs/src        \
+    ${libs_dir}/logs/inc        \
+    ${libs_dir}/utils           \
+    ${gen_dir}
+
+defs :=                                         \
+    CONFIG_SDK_LIBS_STATE_MACHINE_PROFILING     \
+    CONFIG_SDK_LIBS_STATE_MACHINE_NAMES
+
+cflags := -O2 -Wall $(addprefix -I,${incs}) $(addprefix -D,${defs})
+
+vpath %.c ./ ${sm_dir}/src ${libs_dir}/logs/src ${libs_dir}/utils ${gen_dir}
+
+.PHONY: default createdirs ${input_targets}
+
+default: ${default_targets}
+
+clean:
+	@echo "-- cleaning ..."
+	rm -rf ${build_dir}
+build: createdirs ${gens} ${bin}
+generate: createdirs ${gens}
+test: build
+	./${bin} replay ${TRACES}
+	./${bin} fuzz -n 100000
+fuzz: build
+	./${bin} fuzz ${FUZZ_ARGS}
+replay: build
+	./${bin} replay ${TRACES}
+
+createdirs:
+	@mkdir -p ${build_dir}/obj
+	@mkdir -p ${gen_dir}
+
+${bin}: ${objs}
+	gcc -o $@ $^ -lm
+
+${build_dir}/obj/%.o: %.c ${gens}
+	gcc -c $< -o $@ -MD ${cflags}
+
+${gen_dir}/logs_gen_comp_ids.hh ${gen_dir}/logs_gen_structs.cc: \
+        ${logs_gen_srcs}
+	python3 ${libs_dir}/logs/gen/gen_logs_structs.py ${gen_dir} \
+        ${logs_gen_srcs}
+
+# the generator expects to run from within the generation directory
+${sm_gens}: ${sm_srcs} ${sm_dir}/gen/state_machine_gen.py
+	cd ${gen_dir} && python3 $(abspath ${sm_dir}/gen/state_machine_gen.py) \
+        . $(abspath ${sm_srcs})
+
+${gen_dir}/sm_host_stubs.c: ${sm_srcs} ./sm_host_stubs_gen.py
+	python3 ./sm_host_stubs_gen.py ${gen_dir} ${sm_srcs}
+
+# --- dependencies inclusion ------------------------------------------------- #
+-include ${deps}
+
+# --- end of file ------------------------------------------------------------ #
@@ -0,0 +1,69 @@
+/** -------------------------------------------------------------------------- *
+ * @copyright Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @author  Ahmed Sabry (SG Wireless)
+ *
+ * @brief   common checks of the host tests built by utils_hosttest.mk. It is
+ *          included once by the test main file, the failed checks are
+ *          printed and counted, and the test exits with the result:
+ *
+ *              __check(value == 3, "value %d", value);
+ *              ...
+ *              return hosttest_result();
+ * --------------------------------------------------------------------------- *
+ */
+#ifndef __UTILS_HOSTTEST_H__
+#define __UTILS_HOSTTEST_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --- includes ------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <stdint.h>
+
+/* --- checks --------------------------------------------------------------- */
+
+static uint32_t s_hosttest_failures;
+
+#define __check(cond, fmt, args...)                                     \
+    do {                                                                \
+        if( ! (cond) ) {                                                \
+            printf("  FAIL %s:%d: " fmt "\n", __FILE__, __LINE__, ##args); \
+            ++ s_hosttest_failures;                                     \
+        }                                                               \
+    } while(0)
+
+/* prints the test result, it returns the process exit code */
+static inline int hosttest_result(void)
+{
+    printf("%s (%u failures)\n", s_hosttest_failures ? "FAILED" : "PASSED",
+        s_hosttest_failures);
+    return s_hosttest_failures ? 1 : 0;
+}
+
+/* --- end of file ---------------------------------------------------------- */
+#ifdef __cplusplus
+}
+#endif
+#endif /* __UTILS_HOSTTEST_H__ */
@@ -0,0 +1,102 @@
+# ---------------------------------------------------------------------------- #
+# Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files(the “Software”), to deal
+# in the Software without restriction, including without limitation the rights
+# to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+# copies  of  the  Software,  and  to  permit  persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+# IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+# AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+# Author    Ahmed Sabry (SG Wireless)
+#
+# Desc      This file contains the common host build of the unit host tests,
+#           a test makefile sets its description then includes this file:
+#             hosttest_name     the test name, it names the build dir and bin
+#             libs_dir          the path of the libs directory
+#             hosttest_srcs     the test main, mocks and sources under test
+#             hosttest_vpath    the directories of the sources under test
+#             hosttest_incs     the include directories of the test
+#             hosttest_defs     the preprocessor definitions of the test
+#             hosttest_logs     the extra files scanned for the log components
+#           The logs library and the utils are always built with the test.
+#
+# usage     make -f <test>_hosttest.mk [clean|build|test]
+# ---------------------------------------------------------------------------- #
+
+# --- targets ---------------------------------------------------------------- #
+input_targets   := clean build generate test
+default_targets := build test
+
+build_dir := build/${hosttest_name}
+gen_dir   := ${build_dir}/gen
+
+srcs := ${hosttest_srcs}                                        \
+        $(notdir $(wildcard ${libs_dir}/logs/src/*.c))          \
+        utils_fs_path.c utils_bitarray.c
+
+gens := ${gen_dir}/logs_gen_comp_ids.hh \
+        ${gen_dir}/logs_gen_structs.cc
+logs_gen_srcs := $(wildcard ${libs_dir}/logs/src/*.c)           \
+                 ${libs_dir}/logs/inc/log_lib.h                 \
+                 ${libs_dir}/utils/logs_defs.h                  \
+                 ${hosttest_logs}
+
+objs := $(addprefix ${build_dir}/obj/,$(srcs:.c=.o))
+deps := $(objs:.o=.d)
+bin  := ${build_dir}/${hosttest_name}_host
+
+incs :=                         \
+    ./                          \
+    ${hosttest_incs}            \
+    ${libs_dir}/logs/src        \
+    ${libs_dir}/logs/inc        \
+    ${libs_dir}/utils           \
+    ${gen_dir}
+
+cflags := -O2 -Wall $(addprefix -I,${incs}) $(addprefix -D,${hosttest_defs})
+
+vpath %.c ./ ${hosttest_vpath} ${libs_dir}/logs/src ${libs_dir}/utils
+
+.PHONY: default createdirs ${input_targets}
+
+default: ${default_targets}
+
+clean:
+	@echo "-- cleaning ..."
+	rm -rf ${build_dir}
+build: createdirs ${gens} ${bin}
+generate: createdirs ${gens}
+test: build
+	./${bin}
+
+createdirs:
+	@mkdir -p ${build_dir}/obj
+	@mkdir -p ${gen_dir}
+
+${bin}: ${objs}
+	gcc -o $@ $^ -lm
+
+${build_dir}/obj/%.o: %.c ${gens}
+	gcc -c $< -o $@ -MD ${cflags}
+
+${gen_dir}/logs_gen_comp_ids.hh ${gen_dir}/logs_gen_structs.cc: \
+        ${logs_gen_srcs}
+	python3 ${libs_dir}/logs/gen/gen_logs_structs.py ${gen_dir} \
+        ${logs_gen_srcs}
+
+# --- dependencies inclusion ------------------------------------------------- #
+-include ${deps}
+
+# --- end of file ------------------------------------------------------------ #
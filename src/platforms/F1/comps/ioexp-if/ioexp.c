@@ -58,6 +58,7 @@ __log_component_def(F1, ioexp, purple, 1, 0)
 #define config_get_lte_modem_enable_on_boot() false
 #endif
 #include "esp_event.h"
+#include "esp_timer.h"
 
 /* --------------------------------------------------------------------------- *
  * Configuration
@@ -104,21 +105,23 @@ enum {
  * access guard
  * --------------------------------------------------------------------------- *
  */
+/* the mutex is recursive, a signals batch holds it from its begin to its end
+ * while every signal update inside the batch takes it again */
 static bool s_is_access_initialized = false;
 static SemaphoreHandle_t s_ioexp_access_mutex = NULL;
-#define __ioexp_access_guard_init()                         \
-    do {                                                    \
-        s_ioexp_access_mutex = xSemaphoreCreateMutex();     \
-        __log_assert(s_ioexp_access_mutex != NULL,          \
-            "failed to create ioexp access guard mutex");   \
-        s_is_access_initialized = true;                     \
+#define __ioexp_access_guard_init()                                 \
+    do {                                                            \
+        s_ioexp_access_mutex = xSemaphoreCreateRecursiveMutex();    \
+        __log_assert(s_ioexp_access_mutex != NULL,                  \
+            "failed to create ioexp access guard mutex");           \
+        s_is_access_initialized = true;                             \
     } while(0)
 #define __ioexp_access_lock()       \
     if(s_is_access_initialized)     \
-        xSemaphoreTake(s_ioexp_access_mutex, portMAX_DELAY)
+        xSemaphoreTakeRecursive(s_ioexp_access_mutex, portMAX_DELAY)
 #define __ioexp_access_unlock()     \
     if(s_is_access_initialized)     \
-        xSemaphoreGive(s_ioexp_access_mutex)
+        xSemaphoreGiveRecursive(s_ioexp_access_mutex)
 
 /* --------------------------------------------------------------------------- *
  * Pins definitions
@@ -196,14 +199,17 @@ __opt_paste(__lte__, y,
 
 static volatile uint32_t s_callback_timestamp;
 static volatile uint32_t s_wakeup_timestamp;
+static volatile uint32_t s_wakeup_time_us;  /* wraps, for the latency stats */
 
 #if __opt_test(__lora__, y)
 static void __ioexp_sig_int_handler(lora_int)(bool pin_value) {
     if( __ioexp_sig_int_callback(lora_int) )
         __ioexp_sig_int_callback(lora_int)(s_callback_timestamp);
 }
+/* the lora_free input is inverted, it reads high when the chip is free, only
+ * the busy release edges are signalled */
 static void __ioexp_sig_int_handler(lora_free)(bool pin_value) {
-    if( __ioexp_sig_int_callback(lora_free) )
+    if( pin_value && __ioexp_sig_int_callback(lora_free) )
         __ioexp_sig_int_callback(lora_free)(s_callback_timestamp);
 }
 #endif
@@ -252,6 +258,22 @@ static void __ioexp_sig_int_handler(lte_ring)(bool pin_value) {
             err);                                                   \
     } while(0)
 
+/* the signals updates between the batch begin and end are written to the
+ * io-expander at the end, each changed register once. The access lock is held
+ * for the whole batch, as the driver batch is not owned by a task, so the
+ * updates of another task are not deferred into it and merged */
+#define __signals_batch_begin()                                     \
+    do{                                                             \
+        __ioexp_access_lock();                                      \
+        pcal6408a_batch_begin();                                    \
+    } while(0)
+
+#define __signals_batch_end()                                       \
+    do{                                                             \
+        pcal6408a_batch_end();                                      \
+        __ioexp_access_unlock();                                    \
+    } while(0)
+
 #define __get_signal_value(sig, value)                              \
     do{                                                             \
         __ioexp_access_lock();                                      \
@@ -296,6 +318,22 @@ static void pcal6408a_i2c_write_port
         dev_addr, buff, cbytes, portMAX_DELAY), "i2c master write error", );
 }
 
+static void pcal6408a_i2c_write_read_port(uint8_t dev_addr,
+    uint8_t* wbuff, uint32_t wbytes, uint8_t* rbuff, uint32_t rbytes)
+{
+    __log_debug("i2c [wr] [addr: %02x] [len: %d/%d] [byte1: %02x]",
+        dev_addr, wbytes, rbytes, wbuff[0]);
+
+    __esp_api_call( i2c_master_write_read_device(__esp32_ioexp_i2c_port,
+        dev_addr, wbuff, wbytes, rbuff, rbytes, portMAX_DELAY),
+        "i2c master write-read error", );
+}
+
+static uint32_t pcal6408a_time_us_port(void)
+{
+    return (uint32_t)esp_timer_get_time();
+}
+
 static void esp32_ioexp_i2c_ctor(void)
 {
     i2c_config_t i2c_cfg = {
@@ -350,18 +388,24 @@ static void esp32_ioexp_i2c_dtor(void)
     } while (0)
 
 #if __opt_test(__int__, y)
-static SemaphoreHandle_t s_ioexp_sync_sem_handle = NULL;
+/**
+ * the interrupt line capture time is taken in the isr, the isr notifies the
+ * ioexp task directly and yields to it, so the interrupt status and the input
+ * port are read and the signals handlers are called without waiting for the
+ * next scheduler tick.
+ */
 static TaskHandle_t s_ioexp_task_handle = NULL;
 static void esp32_ioexp_task(void * arg)
 {
     while(1)
     {
-        if(xSemaphoreTake(s_ioexp_sync_sem_handle, portMAX_DELAY)== pdTRUE)
+        if(ulTaskNotifyTake(pdTRUE, portMAX_DELAY) != 0)
         {
+            uint32_t isr_time_us = s_wakeup_time_us;
             __ioexp_access_lock();
             s_callback_timestamp = s_wakeup_timestamp;
             __log_debug("interrupt event");
-            pcal6408a_interrupt_trigger_port();
+            pcal6408a_interrupt_dispatch(isr_time_us);
             __ioexp_access_unlock();
         }
     }
@@ -369,16 +413,12 @@ static void esp32_ioexp_task(void * arg)
 
 static void esp32_ioexp_task_init(void)
 {
-    s_ioexp_sync_sem_handle = xSemaphoreCreateBinary();
-    __log_assert(s_ioexp_sync_sem_handle != NULL,
-        "failed to create ioexp sync sem");
-
     xTaskCreate(
         esp32_ioexp_task,       // task function
         "ioexp-task",           // task name
         4 * 1024,               // stack size
         NULL,                   // parameter to task function
-        configMAX_PRIORITIES,   // priority
+        configMAX_PRIORITIES - 1,   // priority
         &s_ioexp_task_handle    // handle to the task
         );
     configASSERT( s_ioexp_task_handle );
@@ -387,13 +427,14 @@ static void esp32_ioexp_task_init(void)
 static void esp32_ioexp_int_handler(void * args)
 {
     (void)args;
-    static BaseType_t xHigherPriorityTaskWoken;
-    s_wakeup_timestamp = esp_timer_get_time() / 1000U;
-    if(xSemaphoreGiveFromISR(s_ioexp_sync_sem_handle,
-        &xHigherPriorityTaskWoken) != pdTRUE)
-    {
-        __log_error("ioexp: failed to give sem from isr");
-    }
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    int64_t time_us = esp_timer_get_time();
+    // -- the msec timestamp is taken from the full time as the radio irq
+    //    timestamp is compared with the system msec time
+    s_wakeup_timestamp = time_us / 1000U;
+    s_wakeup_time_us = (uint32_t)time_us;
+    vTaskNotifyGiveFromISR(s_ioexp_task_handle, &xHigherPriorityTaskWoken);
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
 }
 
 static void esp32_ioexp_gpio_ctor(void)
@@ -579,7 +620,9 @@ static void ioexp_driver_ctor(void)
         .is_addr_pin_connected_to_vdd = true,
         .is_open_drain_output = false,
         .i2c_read = pcal6408a_i2c_read_port,
-        .i2c_write = pcal6408a_i2c_write_port
+        .i2c_write = pcal6408a_i2c_write_port,
+        .i2c_write_read = pcal6408a_i2c_write_read_port,
+        .get_time_us = pcal6408a_time_us_port
     };
 
     __log_assert( pcal6408a_init( & cfg ) == __pcal6408a_ok,
@@ -626,6 +669,9 @@ static void ioexp_driver_ctor(void)
     __opt_paste(__lora__, y,
         __config_ioexp_input_pin(lora_int,  down,         false,  true);
         __config_ioexp_input_pin(lora_free, down,         true,   true);
+
+        // the radio irq shrinks the rx windows margin, it goes first
+        pcal6408a_set_pin_priority(__ioexp_drv_handle( lora_int ), true);
     )
     __opt_paste(__lte__, y,
         __config_ioexp_input_pin(lte_ring,  down,         false,  true);
@@ -687,6 +733,11 @@ bool ioexp_micropython_req_i2c_init(int port, int scl, int sda,
 
 void ioexp_micropython_req_i2c_deinit(void)
 {
+    // -- the micropython application may have accessed the io-expander
+    __ioexp_access_lock();
+    pcal6408a_sync();
+    __ioexp_access_unlock();
+
     ioexp_manage_power(__IOEXP_MPY_I2C_OFF);
 }
 
@@ -705,10 +756,12 @@ void ioexp_lora_chip_power_on(void)
     ioexp_manage_power(__IOEXP_LORA_POWER_ON);
 
     // -- activate the associated lora chip signals
+    __signals_batch_begin();
     __activate_signal( lora_power );
     __activate_signal( lora_reset_n );
     __activate_signal( lora_int );
     __activate_signal( lora_free );
+    __signals_batch_end();
 
     // -- init the reset signal
     __set_signal_value( lora_reset_n, high );
@@ -722,9 +775,11 @@ void ioexp_lora_chip_power_off(void)
 
     // -- deactivate interrupts signals before lora powering down, to prevent
     //    spontanuous interrupts during chip power off
+    __signals_batch_begin();
     __deactivate_signal( lora_int );
     __deactivate_signal( lora_free );
     __deactivate_signal( lora_reset_n );
+    __signals_batch_end();
 
     // -- power off the chip
     __set_signal_value( lora_power, low );
@@ -799,9 +854,11 @@ void ioexp_lte_chip_power_on(void)
     ioexp_manage_power(__IOEXP_LTE_POWER_ON);
 
     // -- activate associated lte signals
+    __signals_batch_begin();
     __activate_signal( lte_ring );
     __activate_signal( lte_reset_n );
     __activate_signal( lte_power );
+    __signals_batch_end();
 
     // -- init the reset signal
     __set_signal_value( lte_reset_n, high );
@@ -818,9 +875,11 @@ void ioexp_lte_chip_power_off(void)
     __set_signal_value( lte_power, low );
 
     // -- deactivate associated lte signals
+    __signals_batch_begin();
     __deactivate_signal( lte_power );
     __deactivate_signal( lte_reset_n );
     __deactivate_signal( lte_ring );
+    __signals_batch_end();
 
     ioexp_manage_power(__IOEXP_LTE_POWER_OFF);
 }
@@ -106,6 +106,7 @@ void ioexp_lora_chip_reset(void);       /**< send reset pulse on lora_reset_n */
 void ioexp_lora_chip_set_int_signal_callback( ioexp_callback_t cb );
 bool ioexp_lora_chip_read_int_pin( void );
 void ioexp_lora_chip_set_busy_signal_callback( ioexp_callback_t cb );
+                                        /**< called when the chip gets free */
 bool ioexp_lora_chip_is_busy(void);
 
 /**
@@ -42,6 +42,8 @@
 #include "nvs.h"
 #include "esp_random.h"
 #include "esp_crc.h"
+#include "esp_partition.h"
+#include "esp_ota_ops.h"
 #include "ioexp.h"
 #include "lora_port.h"
 
@@ -75,6 +77,7 @@ static void timer_set_period(void* handle, uint32_t msec);
 
 // -- system time
 static uint32_t get_timestamp_msec(void);
+static uint32_t get_timestamp_usec(void);
 static void delay_msec(uint32_t msec);
 
 // -- access mutex
@@ -86,10 +89,18 @@ static void mutex_unlock(void* handle);
 static void* sem_new(void);
 static void sem_wait(void* handle);
 static void sem_signal(void* handle);
+static bool sem_wait_timeout(void* handle, uint32_t msec);
 
 // -- optional utilities ( optional )
 static uint32_t crc32_calc(uint32_t initial_crc, uint8_t * buf, uint32_t len);
 
+// -- fragmented data block store ( optional )
+static int frag_store_open(uint32_t* p_size, uint32_t* p_sector_size);
+static int frag_store_erase(uint32_t offset, uint32_t size);
+static int frag_store_write(uint32_t offset, uint8_t* buf, uint32_t size);
+static int frag_store_read(uint32_t offset, uint8_t* buf, uint32_t size);
+static int frag_store_close(bool is_complete, uint32_t size);
+
 void lora_board_ctor(void)
 {
     __log_info("ctor() -> lora board");
@@ -120,7 +131,14 @@ void lora_board_ctor(void)
         .sem_new = sem_new,
         .sem_wait = sem_wait,
         .sem_signal = sem_signal,
-        .crc32_calc = crc32_calc
+        .sem_wait_timeout = sem_wait_timeout,
+        .crc32_calc = crc32_calc,
+        .get_timestamp_usec = get_timestamp_usec,
+        .frag_store_open = frag_store_open,
+        .frag_store_erase = frag_store_erase,
+        .frag_store_write = frag_store_write,
+        .frag_store_read = frag_store_read,
+        .frag_store_close = frag_store_close
     };
     lora_port_init( &init_params );
 
@@ -293,6 +311,10 @@ static uint32_t get_timestamp_msec(void)
 {
     return esp_timer_get_time() / 1000U;
 }
+static uint32_t get_timestamp_usec(void)
+{
+    return (uint32_t)esp_timer_get_time();
+}
 static void delay_msec(uint32_t msec)
 {
     vTaskDelay(msec / portTICK_PERIOD_MS);
@@ -367,6 +389,16 @@ static void sem_signal(void* handle)
     ret = xSemaphoreGive(handle);
     __log_assert(ret == pdTRUE, "-- failed --");
 }
+static bool sem_wait_timeout(void* handle, uint32_t msec)
+{
+    __log_debug("wait for semaphore with handle:%p, %d msec", handle, msec);
+    TickType_t ticks = pdMS_TO_TICKS(msec);
+
+    // -- a wait shorter than a tick blocks one tick instead of spinning
+    if( ticks == 0 && msec )
+        ticks = 1;
+    return xSemaphoreTake(handle, ticks) == pdTRUE;
+}
 
 /** -------------------------------------------------------------------------- *
  * crc32 port implementation
@@ -382,4 +414,78 @@ static uint32_t crc32_calc(uint32_t initial_crc, uint8_t * buf, uint32_t len)
     return crc;
 }
 
+/** -------------------------------------------------------------------------- *
+ * fragmented data block store ports implementation
+ * ------------------------------------------------
+ * the data block is stored in the next ota update partition, a complete block
+ * is set as the boot partition which verifies it as a valid firmware image.
+ * --------------------------------------------------------------------------- *
+ */
+#define __frag_store_sector_size    (4096)  // -- spi flash erase sector
+
+static const esp_partition_t* s_frag_partition;
+
+static int frag_store_open(uint32_t* p_size, uint32_t* p_sector_size)
+{
+    s_frag_partition = esp_ota_get_next_update_partition(NULL);
+    if(s_frag_partition == NULL) {
+        __log_error("-- failed -- no ota update partition");
+        return -1;
+    }
+    __log_info("frag store on partition '%s' of %d bytes",
+        s_frag_partition->label, s_frag_partition->size);
+    *p_size = s_frag_partition->size;
+    *p_sector_size = __frag_store_sector_size;
+    return 0;
+}
+
+static int frag_store_erase(uint32_t offset, uint32_t size)
+{
+    __log_debug("erase offset:%d, size:%d", offset, size);
+    if(esp_partition_erase_range(s_frag_partition, offset, size) != ESP_OK) {
+        __log_error("-- failed --");
+        return -1;
+    }
+    return 0;
+}
+
+static int frag_store_write(uint32_t offset, uint8_t* buf, uint32_t size)
+{
+    __log_debug("write offset:%d, size:%d", offset, size);
+    if(esp_partition_write(s_frag_partition, offset, buf, size) != ESP_OK) {
+        __log_error("-- failed --");
+        return -1;
+    }
+    return 0;
+}
+
+static int frag_store_read(uint32_t offset, uint8_t* buf, uint32_t size)
+{
+    __log_debug("read offset:%d, size:%d", offset, size);
+    if(esp_partition_read(s_frag_partition, offset, buf, size) != ESP_OK) {
+        __log_error("-- failed --");
+        return -1;
+    }
+    return 0;
+}
+
+static int frag_store_close(bool is_complete, uint32_t size)
+{
+    esp_err_t ret;
+
+    if( ! is_complete ) {
+        s_frag_partition = NULL;
+        return 0;
+    }
+
+    ret = esp_ota_set_boot_partition(s_frag_partition);
+    s_frag_partition = NULL;
+    if(ret != ESP_OK) {
+        __log_error("-- failed -- invalid firmware image, err: %d", ret);
+        return -1;
+    }
+    __log_info("new firmware image of %d bytes boots on the next reset", size);
+    return 0;
+}
+
 /* --- end of file ---------------------------------------------------------- */
@@ -32,6 +32,7 @@
 #include "driver/gpio.h"
 #include "driver/periph_ctrl.h"
 #include "soc/soc_caps.h"
+#include "esp_heap_caps.h"
 #include "FreeRTOS.h"
 #include "semphr.h"
 
@@ -45,6 +46,8 @@
 /* --- configs -------------------------------------------------------------- */
 
 #define __enable_spi_single_byte_trx_impl   (0)
+#define __enable_spi_trx_logs               (0) /* the driver inspector logs
+                                                   the same transactions */
 
 /* spi signal timing params */
 #define __sx1262_esp32_spi_clk              (SPI_MASTER_FREQ_8M) /* upto 16M */
@@ -88,7 +91,9 @@ static void sx1262_spi_bus_dtor( void );
 static void sx1262_gpios_ctor( void );
 static void sx1262_gpios_dtor( void );
 static int  sx1262_spi_trx( sx126x_spi_trx_t* p_trx );
-static void sx1262_wait_on_busy( void );
+static void sx1262_spi_batch_begin( sx126x_port_op_t op );
+static void sx1262_spi_batch_end( void );
+static sx126x_port_busy_wait_t sx1262_wait_on_busy( void );
 static void sx1262_send_reset_pulse( void );
 static bool sx126x_port_int_pin_state ( void );
 
@@ -103,7 +108,9 @@ void sgw3501_lora_sx1262_ctor(void)
         .p_spi_trx = sx1262_spi_trx,
         .p_wait_on_busy_signal = sx1262_wait_on_busy,
         .p_send_reset_pulse = sx1262_send_reset_pulse,
-        .p_get_int_pin_state = sx126x_port_int_pin_state
+        .p_get_int_pin_state = sx126x_port_int_pin_state,
+        .p_spi_batch_begin = sx1262_spi_batch_begin,
+        .p_spi_batch_end = sx1262_spi_batch_end
     };
     sx126x_port_init( & port_params );
 }
@@ -135,9 +142,23 @@ do {                                                    \
     }                                                   \
 } while (0)
 
+/** -------------------------------------------------------------------------- *
+ * Every sx126x transaction is one bus transaction with the command, address
+ * and dummy phases. The data phase of the short ones (up to 4 bytes with the
+ * rx byte-1) is carried in the transaction descriptor itself and the
+ * completion is polled, the longer ones go through the dma from a bounce
+ * buffer and the task sleeps until their completion.
+ * The bus is acquired for every transaction, unless the stack brackets the
+ * transactions of a radio operation as a batch, then it is acquired once for
+ * the whole batch.
+ * --------------------------------------------------------------------------- *
+ */
 static spi_device_handle_t s_spi_dev_handle;
+static uint8_t* s_dma_buf;
+static bool s_spi_batch;
 
-#define __spi_max_buf_size  SOC_SPI_MAXIMUM_BUFFER_SIZE
+#define __spi_short_trx_size    (4)
+#define __spi_dma_buf_size      (256 + 4)   /* max data + rx byte-1, aligned */
 
 static void sx1262_spi_bus_ctor( void )
 {
@@ -148,8 +169,12 @@ static void sx1262_spi_bus_ctor( void )
         .sclk_io_num = __esp32_spi_pin_sclk,
         .quadwp_io_num = -1,
         .quadhd_io_num = -1,
+        .max_transfer_sz = __spi_dma_buf_size
     };
 
+    s_dma_buf = heap_caps_malloc(__spi_dma_buf_size, MALLOC_CAP_DMA);
+    __log_assert(s_dma_buf != NULL, "spi dma buffer allocation failed");
+
     __esp_api_call(
         spi_bus_initialize(SPI2_HOST, &bus_cfg, SPI_DMA_CH_AUTO),
         "esp32 spi bus init failed", __no_ret_value);
@@ -173,6 +198,8 @@ static void sx1262_spi_bus_dtor( void )
 {
     __log_info("dtor() -> spi bus");
 
+    sx1262_spi_batch_end();
+
     __esp_api_call(
         spi_bus_remove_device(s_spi_dev_handle),
         "error: sx1262 port: esp32 spi device remove", __no_ret_value);
@@ -180,25 +207,39 @@ static void sx1262_spi_bus_dtor( void )
     
     __esp_api_call(spi_bus_free(SPI2_HOST),
         "esp32 spi bus free failed", __no_ret_value);
+
+    heap_caps_free(s_dma_buf);
+    s_dma_buf = NULL;
 }
 
-static int sx1262_spi_trx( sx126x_spi_trx_t* p_trx )
+static void sx1262_spi_batch_begin( sx126x_port_op_t op )
+{
+    __log_debug("spi batch begin -> op: %d", op);
+    __esp_api_call( spi_device_acquire_bus(s_spi_dev_handle, portMAX_DELAY),
+        "spi bus acquire", __no_ret_value);
+    s_spi_batch = true;
+}
+
+static void sx1262_spi_batch_end( void )
+{
+    if( ! s_spi_batch )
+        return;
+    s_spi_batch = false;
+    spi_device_release_bus(s_spi_dev_handle);
+}
+
+#if __enable_spi_trx_logs
+static void sx1262_spi_trx_log( sx126x_spi_trx_t* p_trx )
 {
     bool has_address  = p_trx->flags & __sx126x_spi_trx_has_address;
     bool has_rx_byte1 = p_trx->flags & __sx126x_spi_trx_has_rx_byte1;
-    bool has_rx_dummy = p_trx->flags & __sx126x_spi_trx_has_dummy_rx_byte1;
-    bool has_pretrans = p_trx->flags & __sx126x_spi_trx_has_cs_pretrans_ms;
-    uint8_t *tx_buf = p_trx->tx_buffer;
-    uint8_t *rx_buf = p_trx->rx_buffer;
-
-    __log_assert( !(tx_buf && rx_buf),
-        "sx1262 spi transaction should be half duplex");
 
     __log_printf("spi trx "
                 "["__red__"%c"__default__"] "
                 "[cmd: "__yellow__"%02x"__default__"] "
                 "[addr: "__green__,
-        rx_buf || has_rx_byte1 ? 'R' : tx_buf ? 'W' : '-', p_trx->command);
+        p_trx->rx_buffer || has_rx_byte1 ? 'R' : p_trx->tx_buffer ? 'W' : '-',
+        p_trx->command);
     if(has_address) {
         if(p_trx->address_bits == 16)
             __log_printf("%04X", p_trx->address);
@@ -208,31 +249,40 @@ static int sx1262_spi_trx( sx126x_spi_trx_t* p_trx )
         __log_printf("----");
     __log_printf(__default__"] [size: "__green__"%3d"__default__"]",
         p_trx->size);
-    if(tx_buf)
-        __log_dump(tx_buf, p_trx->size, 16, __log_dump_flag_hide_address,
-            __word_len_8);
+    if(p_trx->tx_buffer)
+        __log_dump(p_trx->tx_buffer, p_trx->size, 16,
+            __log_dump_flag_hide_address, __word_len_8);
+    if(p_trx->rx_buffer)
+        __log_dump(p_trx->rx_buffer, p_trx->size, 16,
+            __log_dump_flag_hide_address, __word_len_8);
+}
+#endif /* __enable_spi_trx_logs */
 
-    __esp_api_call( spi_device_acquire_bus(s_spi_dev_handle, portMAX_DELAY),
-        "spi bus acquire", !0);
+static int sx1262_spi_trx( sx126x_spi_trx_t* p_trx )
+{
+    bool has_address  = p_trx->flags & __sx126x_spi_trx_has_address;
+    bool has_rx_byte1 = p_trx->flags & __sx126x_spi_trx_has_rx_byte1;
+    bool has_rx_dummy = p_trx->flags & __sx126x_spi_trx_has_dummy_rx_byte1;
+    bool has_pretrans = p_trx->flags & __sx126x_spi_trx_has_cs_pretrans_ms;
+    uint8_t *tx_buf = p_trx->tx_buffer;
+    uint8_t *rx_buf = p_trx->rx_buffer;
+    uint32_t data_len = p_trx->size + (has_rx_byte1 == true);
+    bool is_short = data_len <= __spi_short_trx_size;
+    esp_err_t err;
+
+    __log_assert( !(tx_buf && rx_buf),
+        "sx1262 spi transaction should be half duplex");
+    __log_assert( data_len <= __spi_dma_buf_size,
+        "sx1262 spi transaction is too long");
 
     spi_transaction_ext_t trx_desc = {
         .base = {
             .cmd = p_trx->command,  /* command byte */
-            .rx_buffer = rx_buf,    /* rx buffer if any */
-            .tx_buffer = tx_buf,    /* tx buffer if any */
+            .length = data_len << 3,
             .flags = 0
         }
     };
     spi_transaction_t * p_base = & trx_desc.base;
-    uint32_t rem_size = p_trx->size;
-    uint32_t offset = 0;
-    uint32_t first_trx_bytes = 0;
-
-    // -- prepare first bus transaction
-    if( has_pretrans ) {
-        gpio_set_level(__esp32_spi_pin_ss, 0);
-        vTaskDelay(p_trx->cs_enable_pretrans_ms / portTICK_PERIOD_MS);
-    }
 
     if( has_address ) {
         p_base->flags |= SPI_TRANS_VARIABLE_ADDR;
@@ -245,114 +295,53 @@ static int sx1262_spi_trx( sx126x_spi_trx_t* p_trx )
         trx_desc.dummy_bits = 8;
     }
 
-    if( has_rx_byte1 ) {
-        p_base->flags |= SPI_TRANS_USE_RXDATA;
-        p_base->length = 8;
-    }
-
-    if( rem_size ) {
-        if( rx_buf ) {
+    if( is_short ) {
+        if( rx_buf || has_rx_byte1 )
             p_base->flags |= SPI_TRANS_USE_RXDATA;
-            uint8_t rx_window = 4 - (has_rx_byte1 == true);
-            first_trx_bytes = rem_size < rx_window ? rem_size : rx_window;
-        }else if(tx_buf) {
+        if( tx_buf ) {
             p_base->flags |= SPI_TRANS_USE_TXDATA;
-            first_trx_bytes = rem_size < 4 ? rem_size : 4;
-            memcpy( p_base->tx_data, tx_buf, first_trx_bytes );
+            memcpy( p_base->tx_data, tx_buf, p_trx->size );
         }
-        p_base->length += first_trx_bytes << 3;
-        rem_size -= first_trx_bytes;
-        offset += first_trx_bytes;
+    } else if( tx_buf ) {
+        memcpy( s_dma_buf, tx_buf, p_trx->size );
+        p_base->tx_buffer = s_dma_buf;
+    } else {
+        p_base->rx_buffer = s_dma_buf;
     }
 
-    if( rem_size ) {
-        p_base->flags |= SPI_TRANS_CS_KEEP_ACTIVE;
-    }
+    if( ! s_spi_batch )
+        __esp_api_call(
+            spi_device_acquire_bus(s_spi_dev_handle, portMAX_DELAY),
+            "spi bus acquire", !0);
 
-    __log_debug("1st cycle => len: %d , rem_size: %d, has_rx_byte1: %d, "
-        "has_dummy: %d", first_trx_bytes, rem_size,
-        has_rx_byte1 == true, has_rx_dummy == true);
+    if( has_pretrans ) {
+        gpio_set_level(__esp32_spi_pin_ss, 0);
+        vTaskDelay(p_trx->cs_enable_pretrans_ms / portTICK_PERIOD_MS);
+    }
 
-    __esp_api_call(
-        spi_device_polling_transmit(s_spi_dev_handle, &trx_desc.base),
-        "spi trx polling", !0);
+    err = is_short
+        ? spi_device_polling_transmit(s_spi_dev_handle, p_base)
+        : spi_device_transmit(s_spi_dev_handle, p_base);
 
-    if( has_rx_byte1 ) {
-        p_trx->rx_byte1 = p_base->rx_data[0];
-    }
+    if( ! s_spi_batch )
+        spi_device_release_bus(s_spi_dev_handle);
 
-    if( rx_buf && first_trx_bytes ) {
-        memcpy( rx_buf, &p_base->rx_data[ has_rx_byte1 == true ],
-            first_trx_bytes );
+    if( err != ESP_OK ) {
+        __log_error("(err_code:%d) spi trx", err);
+        return !0;
     }
 
-    if(rem_size) {
-        trx_desc.command_bits = 0;
-        trx_desc.address_bits = 0;
-        trx_desc.dummy_bits = 0;
-        p_base->flags |= SPI_TRANS_VARIABLE_CMD;
-
-        uint32_t len;
-        do {
-            p_base->rxlength = 0;
-            len = 0;
-
-            if(rem_size >= __spi_max_buf_size) {
-                len = __spi_max_buf_size;
-            } else if(rem_size < 4) {
-                len = rem_size;
-            } else {
-                // len = (rem_size >> 2) << 2;
-                len = rem_size & ~(uint32_t)3u;
-            }
-            rem_size -= len;
-
-            __log_debug("trx cycle => len: %d , rem_size: %d", len, rem_size);
-
-            if( rem_size )
-                p_base->flags |= SPI_TRANS_CS_KEEP_ACTIVE;
-            else
-                p_base->flags &= ~SPI_TRANS_CS_KEEP_ACTIVE;
-
-            p_base->length = len << 3;
-
-            p_base->tx_buffer = NULL;
-            p_base->rx_buffer = NULL;
-            p_base->flags &= ~(SPI_TRANS_USE_RXDATA | SPI_TRANS_USE_TXDATA);
-            if(len < 4) {
-                if(tx_buf) {
-                    p_base->flags |= SPI_TRANS_USE_TXDATA;
-                    memcpy(p_base->tx_data, tx_buf + offset, len);
-                } else if(rx_buf) {
-                    p_base->flags |= SPI_TRANS_USE_RXDATA;
-                }
-            } else {
-                if(tx_buf)
-                    p_base->tx_buffer = tx_buf + offset;
-                else if(rx_buf)
-                    p_base->rx_buffer = rx_buf + offset;
-            }
-
-            // -- perform the trx
-            __esp_api_call(
-                spi_device_polling_transmit(s_spi_dev_handle, &trx_desc.base),
-                    "spi trx polling", !0);
-
-            if(len < 4 && rx_buf) {
-                memcpy(rx_buf + offset, p_base->rx_data, len);
-            }
-
-            offset += len;
-
-        } while(rem_size);
+    if( rx_buf || has_rx_byte1 ) {
+        uint8_t * p_data = is_short ? p_base->rx_data : s_dma_buf;
+        if( has_rx_byte1 )
+            p_trx->rx_byte1 = p_data[0];
+        if( rx_buf )
+            memcpy( rx_buf, &p_data[ has_rx_byte1 == true ], p_trx->size );
     }
 
-
-    spi_device_release_bus(s_spi_dev_handle);
-
-    if(rx_buf)
-        __log_dump(rx_buf, p_trx->size, 16, __log_dump_flag_hide_address,
-            __word_len_8);
+    #if __enable_spi_trx_logs
+    sx1262_spi_trx_log( p_trx );
+    #endif
 
     return 0;
 }
@@ -367,9 +356,21 @@ static int sx1262_spi_trx( sx126x_spi_trx_t* p_trx )
  * --------------------------------------------------------------------------- *
  */
 
+/** -------------------------------------------------------------------------- *
+ * The busy release edge comes through the io-expander interrupt task, so the
+ * radio task sleeps on it instead of polling the busy pin over the i2c. If
+ * the release is not notified in time, the pin is polled as before.
+ * --------------------------------------------------------------------------- *
+ */
+#define __sx1262_busy_wait_timeout_ms   (10)
+
+static SemaphoreHandle_t s_busy_free_sem;
+
 static void sx126x_chip_free_signal(uint32_t timestamp)
 {
     __log_debug("int signal --> sx126x free");
+    if( s_busy_free_sem )
+        xSemaphoreGive(s_busy_free_sem);
 }
 
 static void sx126x_irq_signal(uint32_t timestamp)
@@ -381,6 +382,8 @@ static void sx126x_irq_signal(uint32_t timestamp)
 static void sx1262_gpios_ctor( void )
 {
     __log_info("ctor() -> sx126x 'busy' and 'irq' callbacks");
+    s_busy_free_sem = xSemaphoreCreateBinary();
+    __log_assert(s_busy_free_sem != NULL, "failed to create busy free sem");
     ioexp_lora_chip_set_busy_signal_callback(sx126x_chip_free_signal);
     ioexp_lora_chip_set_int_signal_callback(sx126x_irq_signal);
 }
@@ -390,14 +393,30 @@ static void sx1262_gpios_dtor( void )
     __log_info("~dtor() -> sx126x 'busy' and 'irq' callbacks");
     ioexp_lora_chip_set_busy_signal_callback(NULL);
     ioexp_lora_chip_set_int_signal_callback(NULL);
+    vSemaphoreDelete(s_busy_free_sem);
+    s_busy_free_sem = NULL;
 }
 
-static void sx1262_wait_on_busy( void )
+static sx126x_port_busy_wait_t sx1262_wait_on_busy( void )
 {
     bool busy;
+
+    /* a release left by an earlier wait is dropped before checking the pin,
+     * a release after this point belongs to the present busy period */
+    xSemaphoreTake(s_busy_free_sem, 0);
+
+    if( ! ioexp_lora_chip_is_busy() )
+        return __sx126x_port_busy_free;
+
+    if( xSemaphoreTake(s_busy_free_sem,
+            pdMS_TO_TICKS(__sx1262_busy_wait_timeout_ms) + 1) == pdTRUE )
+        return __sx126x_port_busy_event;
+
+    __log_warn("busy release is not notified, polling");
     do {
         busy = ioexp_lora_chip_is_busy();
     } while (busy);
+    return __sx126x_port_busy_polled;
 }
 
 static void sx1262_send_reset_pulse( void )
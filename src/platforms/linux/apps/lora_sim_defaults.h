@@ -0,0 +1,73 @@
+/** -------------------------------------------------------------------------- *
+ * @copyright Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ * @author  Ahmed Sabry (SG Wireless)
+ * 
+ * @brief   common defaults of the Linux host simulation applications (the
+ *          node and the stand-in network server must agree on them)
+ * --------------------------------------------------------------------------- *
+ */
+#ifndef __LORA_SIM_DEFAULTS_H__
+#define __LORA_SIM_DEFAULTS_H__
+
+/* --- ABP commissioning of the simulated LoRaWAN device -------------------- */
+
+#define __sim_default_dev_addr      (0x26011f2au)
+#define __sim_default_dev_eui       { 0x70, 0xb3, 0xd5, 0x7e, \
+                                      0xd0, 0x05, 0x00, 0x01 }
+#define __sim_default_nwk_s_key     { 0x2b, 0x7e, 0x15, 0x16, \
+                                      0x28, 0xae, 0xd2, 0xa6, \
+                                      0xab, 0xf7, 0x15, 0x88, \
+                                      0x09, 0xcf, 0x4f, 0x3c }
+#define __sim_default_app_s_key     { 0x3c, 0x4f, 0xcf, 0x09, \
+                                      0x88, 0x15, 0xf7, 0xab, \
+                                      0xa6, 0xd2, 0xae, 0x28, \
+                                      0x16, 0x15, 0x7e, 0x2b }
+
+/* --- multicast group sent by the stand-in network server ----------------- */
+
+#define __sim_default_mc_addr       (0x01ff0001u)
+#define __sim_default_mc_nwk_s_key  { 0x4a, 0x5f, 0x21, 0x93, \
+                                      0x0c, 0x67, 0xd8, 0x1e, \
+                                      0xb2, 0x36, 0x7d, 0x05, \
+                                      0xe1, 0x8c, 0x44, 0xf0 }
+#define __sim_default_mc_app_s_key  { 0x91, 0x2d, 0x6e, 0xc4, \
+                                      0x58, 0x0b, 0xa7, 0x33, \
+                                      0xfe, 0x12, 0x89, 0x6a, \
+                                      0xd0, 0x47, 0x3b, 0xc5 }
+#define __sim_default_mc_freq       (869525000u)
+#define __sim_default_mc_sf         (9)         /* EU868 DR3 */
+#define __sim_default_mc_dr         (3)
+#define __sim_default_mc_port       (10)
+#define __sim_default_mc_len        (24)
+
+/* --- EU868 class-A timing used by the stand-in network server ------------- */
+
+#define __sim_default_rx1_delay_ms  (1000)
+#define __sim_default_sync_word     (0x3444)    /* lorawan public network */
+
+/* --- raw mode benchmark defaults ------------------------------------------ */
+
+#define __sim_default_raw_freq      (868100000u)
+#define __sim_default_raw_sf        (7)
+#define __sim_default_raw_len       (32)
+
+#endif /* __LORA_SIM_DEFAULTS_H__ */
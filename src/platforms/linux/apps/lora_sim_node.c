@@ -0,0 +1,1014 @@
+/** -------------------------------------------------------------------------- *
+ * @copyright Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ * @author  Ahmed Sabry (SG Wireless)
+ * 
+ * @brief   simulated lora node application of the Linux host platform. It runs
+ *          the lora stack over the simulated sx126x radio and performs the raw
+ *          and LoRaWAN throughput and latency benchmarks.
+ * --------------------------------------------------------------------------- *
+ */
+
+/** -------------------------------------------------------------------------- *
+ * usage: lora_sim_node <bench> [options]
+ *  benches:
+ *      raw-tx      sends back-to-back raw frames and reports the throughput
+ *      raw-rx      continuous reception, reports the received frames, the
+ *                  losses and the one-way latency (tx start -> rx callback)
+ *      raw-echo    continuous reception, echoes back every received frame
+ *      raw-ping    sends frames to a raw-echo node and reports the round-trip
+ *      xfer-tx     sends an object with the reliable transfer to a xfer-rx node
+ *                  and reports the goodput against the raw phy rate
+ *      xfer-rx     receives an object sent by a xfer-tx node and verifies it
+ *      adapt-tx    sends acknowledged messages to an adapt-rx node with the
+ *                  link adaptation and reports the rate steps evolution
+ *      adapt-rx    receives the messages of an adapt-tx node and answers the
+ *                  rate steps
+ *      wan         ABP activation then uplinks to the stand-in network server
+ *      wan-mcast   ABP activation then a class C session of the multicast group
+ *                  broadcast by the stand-in network server (lora_sim_ns -m),
+ *                  reports the group indications and counters
+ *  options:
+ *      -n <count>  number of frames                        (default 100)
+ *      -l <len>    payload length, max frame length (xfer) (default 32)
+ *      -s <sf>     spreading factor, base rate (adapt)     (default 7)
+ *      -f <freq>   frequency in Hz (raw modes)             (default 868.1MHz)
+ *      -g <msec>   gap between the frames                  (default 0)
+ *      -t <sec>    reception duration (raw-rx, raw-echo, adapt-rx, wan-mcast)
+ *                                                          (default 10)
+ *      -b          back-to-back tx burst mode (raw-tx)
+ *      -L          listen before talk before every frame (raw-tx)
+ *      -r <batch>  drain the frames from the rx ring in batches (raw-rx)
+ *      -H <seed>   frequency hopping over the region channels with the hop
+ *                  sequence seed (raw-tx, raw-rx, raw-echo, raw-ping)
+ *      -z <size>   object size in bytes (xfer-tx)          (default 16384)
+ *      -w <frames> frames per acknowledgement (xfer-tx)    (default 32)
+ *      -e <frames> frames per xor parity frame (xfer-tx)   (default 0)
+ *      -c          confirmed uplinks (wan)
+ *      -p <port>   uplink port (wan)                       (default 2)
+ *      -v          keep the stack logs enabled
+ *
+ * The first 12 bytes of every benchmark payload carry the frame sequence
+ * number and the transmission request timestamp on the host monotonic clock
+ * which is shared by all the simulated nodes, so the receiver can measure the
+ * end-to-end latency without any clock synchronization.
+ * --------------------------------------------------------------------------- *
+ */
+
+/* --- includes ------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <semaphore.h>
+
+#include "lora.h"
+#include "lora_port.h"
+#include "lora_sim_air.h"
+#include "lora_sim_defaults.h"
+#include "sx126x_spi_mock.h"
+
+#define __log_subsystem     host
+#define __log_component     sim_node
+#include "log_lib.h"
+
+/* --- bench options -------------------------------------------------------- */
+
+static struct {
+    uint32_t    count;
+    uint8_t     len;
+    uint8_t     sf;
+    uint32_t    freq;
+    uint32_t    gap_ms;
+    uint32_t    duration_s;
+    bool        burst;
+    bool        lbt;
+    uint8_t     ring_batch;
+    bool        hop;
+    uint16_t    hop_seed;
+    uint32_t    size;
+    uint8_t     window;
+    uint8_t     fec;
+    bool        confirmed;
+    uint8_t     port;
+    bool        verbose;
+} s_opt = {
+    .count = 100,
+    .len = __sim_default_raw_len,
+    .sf = __sim_default_raw_sf,
+    .freq = __sim_default_raw_freq,
+    .duration_s = 10,
+    .size = 16384,
+    .window = 32,
+    .port = 2,
+};
+
+/* --- latency statistics --------------------------------------------------- */
+
+typedef struct {
+    uint32_t*   samples;
+    uint32_t    count;
+    uint32_t    capacity;
+} latency_stats_t;
+
+static void stats_init(latency_stats_t* p_stats, uint32_t capacity)
+{
+    p_stats->samples = calloc(capacity ? capacity : 1, sizeof(uint32_t));
+    p_stats->count = 0;
+    p_stats->capacity = capacity;
+}
+
+static void stats_add(latency_stats_t* p_stats, uint32_t sample_us)
+{
+    if(p_stats->count < p_stats->capacity)
+        p_stats->samples[p_stats->count ++] = sample_us;
+}
+
+static int cmp_u32(const void* a, const void* b)
+{
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    return x < y ? -1 : x > y;
+}
+
+static void stats_print(const char* title, latency_stats_t* p_stats)
+{
+    uint64_t sum = 0;
+    uint32_t i, n = p_stats->count;
+
+    if(n == 0) {
+        printf("  %-22s: no samples\n", title);
+        return;
+    }
+    qsort(p_stats->samples, n, sizeof(uint32_t), cmp_u32);
+    for(i = 0; i < n; ++i)
+        sum += p_stats->samples[i];
+
+    printf("  %-22s: min %8.3f  avg %8.3f  p50 %8.3f  p99 %8.3f  "
+        "max %8.3f ms\n", title,
+        p_stats->samples[0] / 1000.0,
+        sum / 1000.0 / n,
+        p_stats->samples[n / 2] / 1000.0,
+        p_stats->samples[(uint32_t)(n * 0.99)] / 1000.0,
+        p_stats->samples[n - 1] / 1000.0);
+}
+
+/* --- benchmark payload ---------------------------------------------------- */
+
+static void payload_fill(uint8_t* buf, uint8_t len, uint32_t seq)
+{
+    uint64_t now = lora_sim_time_us();
+    uint8_t i;
+    for(i = 0; i < len; ++i)
+        buf[i] = (uint8_t)(seq + i);
+    if(len >= 12) {
+        memcpy(&buf[0], &seq, 4);
+        memcpy(&buf[4], &now, 8);
+    }
+}
+
+static bool payload_parse(const uint8_t* buf, uint8_t len,
+    uint32_t* p_seq, uint64_t* p_tx_us)
+{
+    if(len < 12)
+        return false;
+    memcpy(p_seq, &buf[0], 4);
+    memcpy(p_tx_us, &buf[4], 8);
+    return true;
+}
+
+/* --- raw mode ------------------------------------------------------------- */
+
+static void raw_configure(void)
+{
+    lora_raw_param_t param = { .region = __LORA_REGION_EU868 };
+
+    lora_change_mode(__LORA_MODE_RAW);
+
+    param.type = __LORA_RAW_PARAM_REGION;
+    lora_ioctl(__LORA_IOCTL_SET_PARAM, &param);
+    param.type = __LORA_RAW_PARAM_FREQ;
+    param.param.freq = s_opt.freq;
+    lora_ioctl(__LORA_IOCTL_SET_PARAM, &param);
+    param.type = __LORA_RAW_PARAM_SF;
+    param.param.sf = s_opt.sf;
+    lora_ioctl(__LORA_IOCTL_SET_PARAM, &param);
+    param.type = __LORA_RAW_PARAM_BW;
+    param.param.bw = __LORA_BW_125_KHZ;
+    lora_ioctl(__LORA_IOCTL_SET_PARAM, &param);
+    param.type = __LORA_RAW_PARAM_LBT;
+    param.param.lbt = s_opt.lbt;
+    lora_ioctl(__LORA_IOCTL_SET_PARAM, &param);
+
+    lora_ioctl(__LORA_IOCTL_RECONFIG_RADIO, NULL);
+}
+
+static uint32_t raw_frame_toa_us(void)
+{
+    /* sx126x bandwidth code 0x04 is 125 KHz */
+    return lora_sim_lora_toa_us(s_opt.sf, 0x04, 1, 8, false, true, s_opt.len);
+}
+
+static void raw_hop_configure(void)
+{
+    /* the slots fit the bench frames rather than the maximum payload */
+    lora_raw_hop_cfg_t cfg = {
+        .enable = true,
+        .seed = s_opt.hop_seed,
+        .dwell = raw_frame_toa_us() / 1000 + 20,
+    };
+
+    if(s_opt.hop && lora_ioctl(__LORA_IOCTL_HOP_CONFIG, &cfg) == __LORA_OK)
+        printf("== hopping: %u channels, seed %u, dwell %u ms\n",
+            cfg.count, cfg.seed, cfg.dwell);
+}
+
+static void raw_hop_report(void)
+{
+    lora_raw_hop_status_t status;
+
+    if( ! s_opt.hop )
+        return;
+    lora_ioctl(__LORA_IOCTL_HOP_STATUS, &status);
+    printf("  %-22s: %u tx, %u rx, %u delayed, %u hops, %u syncs, "
+        "%u adjusts\n", "hopping", status.tx_frames, status.rx_frames,
+        status.tx_delays, status.hops, status.syncs, status.adjusts);
+}
+
+static int bench_raw_tx(void)
+{
+    uint8_t buf[255];
+    latency_stats_t tx_latency;
+    uint64_t t_start, t0, t_end;
+    uint32_t i;
+
+    raw_configure();
+    raw_hop_configure();
+    stats_init(&tx_latency, s_opt.count);
+    if(s_opt.burst)
+        lora_ioctl(__LORA_IOCTL_TX_BURST_START, NULL);
+
+    t_start = lora_sim_time_us();
+    for(i = 0; i < s_opt.count; ++i)
+    {
+        lora_tx_params_t tx_params = {
+            .buf = buf,
+            .len = s_opt.len,
+            .sync = true,
+        };
+        payload_fill(buf, s_opt.len, i);
+        t0 = lora_sim_time_us();
+        lora_tx(&tx_params);
+        stats_add(&tx_latency, lora_sim_time_us() - t0);
+        if(s_opt.gap_ms)
+            usleep(s_opt.gap_ms * 1000);
+    }
+    if(s_opt.burst)
+        lora_ioctl(__LORA_IOCTL_TX_BURST_STOP, NULL);
+    t_end = lora_sim_time_us();
+
+    double secs = (t_end - t_start) / 1e6;
+    double airtime = (double)raw_frame_toa_us() * s_opt.count / 1e6;
+    printf("== raw-tx%s%s: %u frames x %u bytes @ SF%u\n",
+        s_opt.burst ? " (burst)" : "", s_opt.lbt ? " (lbt)" : "",
+        s_opt.count, s_opt.len, s_opt.sf);
+    printf("  %-22s: %.3f s\n", "elapsed", secs);
+    printf("  %-22s: %.2f frames/s, %.1f bytes/s\n", "throughput",
+        s_opt.count / secs, s_opt.count * s_opt.len / secs);
+    printf("  %-22s: %.1f %% (time-on-air %.3f ms/frame)\n",
+        "channel utilization", 100.0 * airtime / secs,
+        raw_frame_toa_us() / 1000.0);
+    stats_print(s_opt.burst ? "tx request -> queued" : "tx request -> done",
+        &tx_latency);
+    if(s_opt.lbt)
+    {
+        lora_raw_lbt_stats_t lbt;
+        lora_ioctl(__LORA_IOCTL_LBT_STATS, &lbt);
+        printf("  %-22s: %u sent, %u dropped, %u cad (%u busy)\n", "lbt",
+            lbt.packets, lbt.failed, lbt.cad_count, lbt.busy_count);
+    }
+    raw_hop_report();
+    sx126x_spi_mock_print();
+
+    lora_stats();
+    return 0;
+}
+
+static struct {
+    sem_t           rx_sem;
+    pthread_mutex_t mutex;
+    latency_stats_t one_way;
+    uint32_t        frames;
+    uint32_t        lost;
+    uint32_t        last_seq;
+    bool            has_seq;
+    int32_t         rssi_sum;
+    int32_t         snr_sum;
+    uint8_t         echo_buf[255];
+    uint8_t         echo_len;
+    bool            echo_pending;
+} s_rx;
+
+/* accounts a received frame, it returns true if the frame is taken for echo */
+static bool raw_rx_account(uint8_t* buf, uint8_t len, int8_t rssi, int8_t snr)
+{
+    uint64_t tx_us;
+    uint32_t seq;
+    bool ret = false;
+
+    pthread_mutex_lock(&s_rx.mutex);
+    ++ s_rx.frames;
+    s_rx.rssi_sum += rssi;
+    s_rx.snr_sum += snr;
+    if(payload_parse(buf, len, &seq, &tx_us)) {
+        stats_add(&s_rx.one_way, lora_sim_time_us() - tx_us);
+        if(s_rx.has_seq && seq > s_rx.last_seq + 1)
+            s_rx.lost += seq - s_rx.last_seq - 1;
+        s_rx.last_seq = seq;
+        s_rx.has_seq = true;
+    }
+    if( ! s_rx.echo_pending ) {
+        memcpy(s_rx.echo_buf, buf, len);
+        s_rx.echo_len = len;
+        s_rx.echo_pending = true;
+        ret = true;
+    }
+    pthread_mutex_unlock(&s_rx.mutex);
+    return ret;
+}
+
+static void raw_rx_callback(lora_event_t event, void* event_data)
+{
+    lora_raw_rx_event_data_t* p_rx = event_data;
+
+    if(event == __LORA_EVENT_RX_BATCH) {
+        sem_post(&s_rx.rx_sem);
+        return;
+    }
+
+    if(event != __LORA_EVENT_RX_DONE || p_rx == NULL)
+        return;
+
+    if(raw_rx_account(p_rx->buf, p_rx->len, p_rx->rssi, p_rx->snr))
+        sem_post(&s_rx.rx_sem);
+}
+
+static void raw_rx_ring_drain(void)
+{
+    static lora_raw_rx_ring_frame_t frame;
+
+    while(lora_ioctl(__LORA_IOCTL_RX_RING_READ, &frame) == __LORA_OK)
+        raw_rx_account(frame.buf, frame.len, frame.rssi, frame.snr);
+}
+
+static int bench_raw_rx(bool echo)
+{
+    uint64_t deadline;
+    struct timespec ts;
+    lora_callback_t cb = { .port = __port_any, .callback = raw_rx_callback };
+
+    raw_configure();
+    raw_hop_configure();
+    sem_init(&s_rx.rx_sem, 0, 0);
+    pthread_mutex_init(&s_rx.mutex, NULL);
+    stats_init(&s_rx.one_way, 1u << 20);
+
+    lora_ioctl(__LORA_IOCTL_SET_CALLBACK, &cb);
+    if(s_opt.ring_batch) {
+        lora_raw_rx_ring_cfg_t ring_cfg = {
+            .enable = true,
+            .batch = s_opt.ring_batch
+        };
+        lora_ioctl(__LORA_IOCTL_RX_RING_SET, &ring_cfg);
+    }
+    lora_ioctl(__LORA_IOCTL_RX_CONT_START, NULL);
+
+    printf("== raw-%s: listening for %u s @ SF%u\n", echo ? "echo" : "rx",
+        s_opt.duration_s, s_opt.sf);
+
+    deadline = lora_sim_time_us() + (uint64_t)s_opt.duration_s * 1000000u;
+    while(lora_sim_time_us() < deadline)
+    {
+        clock_gettime(CLOCK_REALTIME, &ts);
+        ts.tv_nsec += 100000000L;
+        if(ts.tv_nsec >= 1000000000L) { ts.tv_sec++; ts.tv_nsec -= 1000000000L; }
+        if(sem_timedwait(&s_rx.rx_sem, &ts) != 0)
+            continue;
+
+        if(s_opt.ring_batch)
+            raw_rx_ring_drain();
+
+        pthread_mutex_lock(&s_rx.mutex);
+        lora_tx_params_t tx_params = {
+            .buf = s_rx.echo_buf,
+            .len = s_rx.echo_len,
+            .sync = true,
+        };
+        pthread_mutex_unlock(&s_rx.mutex);
+
+        if(echo) {
+            lora_ioctl(__LORA_IOCTL_RX_CONT_STOP, NULL);
+            lora_tx(&tx_params);
+            lora_ioctl(__LORA_IOCTL_RX_CONT_START, NULL);
+        }
+
+        pthread_mutex_lock(&s_rx.mutex);
+        s_rx.echo_pending = false;
+        pthread_mutex_unlock(&s_rx.mutex);
+    }
+    lora_ioctl(__LORA_IOCTL_RX_CONT_STOP, NULL);
+    if(s_opt.ring_batch)
+        raw_rx_ring_drain();
+
+    pthread_mutex_lock(&s_rx.mutex);
+    printf("  %-22s: %u\n", "received frames", s_rx.frames);
+    printf("  %-22s: %u\n", "lost frames (seq gaps)", s_rx.lost);
+    if(s_rx.frames)
+        printf("  %-22s: rssi %.1f dBm, snr %.1f dB\n", "average link",
+            (double)s_rx.rssi_sum / s_rx.frames,
+            (double)s_rx.snr_sum / s_rx.frames);
+    stats_print(s_opt.ring_batch ? "one-way tx -> ring read" :
+        "one-way tx -> rx cb", &s_rx.one_way);
+    pthread_mutex_unlock(&s_rx.mutex);
+
+    if(s_opt.ring_batch) {
+        lora_raw_rx_ring_status_t ring;
+        lora_ioctl(__LORA_IOCTL_RX_RING_STATUS, &ring);
+        printf("  %-22s: %u stored, %u overruns (%u slots)\n", "rx ring",
+            ring.stored, ring.overruns, ring.slots);
+    }
+    raw_hop_report();
+    sx126x_spi_mock_print();
+
+    lora_stats();
+    return 0;
+}
+
+static int bench_raw_ping(void)
+{
+    uint8_t buf[255];
+    uint8_t rx_buf[255];
+    uint8_t rx_len;
+    latency_stats_t rtt;
+    uint32_t i, replies = 0;
+    uint64_t t0;
+
+    raw_configure();
+    raw_hop_configure();
+    stats_init(&rtt, s_opt.count);
+
+    for(i = 0; i < s_opt.count; ++i)
+    {
+        lora_tx_params_t tx_params = {
+            .buf = buf,
+            .len = s_opt.len,
+            .sync = true,
+        };
+        lora_rx_params_t rx_params = {
+            .buf = rx_buf,
+            .p_len = &rx_len,
+            .timeout = 3 * raw_frame_toa_us() / 1000 + 500,
+            .sync = true,
+        };
+
+        payload_fill(buf, s_opt.len, i);
+        t0 = lora_sim_time_us();
+        lora_tx(&tx_params);
+        rx_len = sizeof(rx_buf);
+        lora_rx(&rx_params);
+        if(rx_len == s_opt.len && memcmp(rx_buf, buf, rx_len) == 0) {
+            stats_add(&rtt, lora_sim_time_us() - t0);
+            ++ replies;
+        }
+        if(s_opt.gap_ms)
+            usleep(s_opt.gap_ms * 1000);
+    }
+
+    printf("== raw-ping: %u frames x %u bytes @ SF%u\n",
+        s_opt.count, s_opt.len, s_opt.sf);
+    printf("  %-22s: %u / %u\n", "replies", replies, s_opt.count);
+    stats_print("round trip", &rtt);
+    return 0;
+}
+
+/* --- raw reliable transfer ------------------------------------------------ */
+
+/* the object is an in-memory pattern the receiver can verify */
+static uint8_t xfer_pattern(uint32_t offset)
+{
+    return (offset * 31 + (offset >> 8)) & 0xFF;
+}
+
+static bool xfer_tx_io(void* ctx, uint32_t offset, uint8_t* buf, uint8_t len)
+{
+    (void)ctx;
+    for(uint8_t i = 0; i < len; ++i)
+        buf[i] = xfer_pattern(offset + i);
+    return true;
+}
+
+static bool xfer_rx_io(void* ctx, uint32_t offset, uint8_t* buf, uint8_t len)
+{
+    uint32_t* p_errors = ctx;
+    for(uint8_t i = 0; i < len; ++i)
+        if(buf[i] != xfer_pattern(offset + i))
+            ++ *p_errors;
+    return true;
+}
+
+static void xfer_configure(void)
+{
+    lora_raw_param_t param = {
+        .type = __LORA_RAW_PARAM_PAYLOAD,
+        .param.payload = s_opt.len
+    };
+
+    raw_configure();
+    lora_ioctl(__LORA_IOCTL_SET_PARAM, &param);
+}
+
+static void xfer_report(const char* bench, lora_raw_xfer_t* p_xfer)
+{
+    lora_raw_xfer_stats_t* p_stats = &p_xfer->stats;
+    /* the phy rate of back-to-back frames of the maximum length */
+    double phy_rate = s_opt.len * 1e6 / raw_frame_toa_us();
+
+    printf("== %s: %u bytes, frames of %u bytes @ SF%u\n", bench,
+        p_xfer->size, s_opt.len, s_opt.sf);
+    printf("  %-22s: %.3f s\n", "elapsed", p_stats->duration / 1e3);
+    printf("  %-22s: %u bytes/s (%.1f %% of phy rate %.1f bytes/s)\n",
+        "goodput", p_stats->goodput, 100.0 * p_stats->goodput / phy_rate,
+        phy_rate);
+    printf("  %-22s: %u data, %u repeated, %u parity, %u recovered\n",
+        "frames", p_stats->data_frames, p_stats->retransmissions,
+        p_stats->parity_frames, p_stats->recovered);
+    printf("  %-22s: %u acks, %u polls, last chunk %u bytes\n",
+        "acknowledgements", p_stats->acks, p_stats->polls, p_stats->chunk);
+}
+
+static int bench_xfer_tx(void)
+{
+    lora_raw_xfer_t xfer = {
+        .io = xfer_tx_io,
+        .size = s_opt.size,
+        .window = s_opt.window,
+        .fec = s_opt.fec,
+        .retries = 5,
+        .timeout = 3 * raw_frame_toa_us() / 1000 + 500,
+    };
+
+    xfer_configure();
+    if(lora_ioctl(__LORA_IOCTL_XFER_SEND, &xfer) != __LORA_OK) {
+        printf("== xfer-tx: failed\n");
+        return 1;
+    }
+    xfer_report("xfer-tx", &xfer);
+    return 0;
+}
+
+static int bench_xfer_rx(void)
+{
+    uint32_t errors = 0;
+    lora_raw_xfer_t xfer = {
+        .io = xfer_rx_io,
+        .ctx = &errors,
+        .timeout = s_opt.duration_s * 1000,
+    };
+
+    xfer_configure();
+    if(lora_ioctl(__LORA_IOCTL_XFER_RECV, &xfer) != __LORA_OK) {
+        printf("== xfer-rx: failed\n");
+        return 1;
+    }
+    xfer_report("xfer-rx", &xfer);
+    printf("  %-22s: %u\n", "corrupted bytes", errors);
+    return errors ? 1 : 0;
+}
+
+/* --- raw link adaptation ------------------------------------------------- */
+
+#define __adapt_tx_addr     (1)
+#define __adapt_rx_addr     (2)
+
+static void adapt_configure(uint8_t addr)
+{
+    lora_raw_param_t param = {
+        .type = __LORA_RAW_PARAM_PAYLOAD,
+        .param.payload = 255
+    };
+    lora_raw_adapt_cfg_t cfg = {
+        .addr = addr,
+        .margin = 5,
+        .max_bw = __LORA_BW_250_KHZ,
+        .max_power_cut = 10,
+        .retries = 3,
+        .idle = 10000,
+    };
+
+    raw_configure();
+    lora_ioctl(__LORA_IOCTL_SET_PARAM, &param);
+    lora_ioctl(__LORA_IOCTL_ADAPT_CONFIG, &cfg);
+}
+
+static void adapt_report(const char* bench, uint8_t peer)
+{
+    lora_raw_adapt_status_t status = { .peer = peer };
+
+    lora_ioctl(__LORA_IOCTL_ADAPT_STATUS, &status);
+    if( ! status.known ) {
+        printf("  %-22s: none\n", "peer link");
+        return;
+    }
+    printf("  %-22s: step %u/%u SF%u BW%u -%u dB (%s)\n", "tx rate",
+        status.tx_step, status.steps, status.tx_sf, 125 << status.tx_bw,
+        status.tx_power_cut, bench);
+    printf("  %-22s: step %u/%u SF%u BW%u -%u dB\n", "rx rate",
+        status.rx_step, status.steps, status.rx_sf, 125 << status.rx_bw,
+        status.rx_power_cut);
+    printf("  %-22s: last %+d dB, min normalized %+d dB\n", "rx snr",
+        status.rx_snr, status.snr_min);
+    printf("  %-22s: %u sent, %u acked, %u retries, %u received, "
+        "%u duplicates\n", "messages", status.sent, status.acked,
+        status.retries, status.received, status.duplicates);
+    printf("  %-22s: %u ups, %u downs, %u fallbacks\n", "rate changes",
+        status.ups, status.downs, status.fallbacks);
+}
+
+static int bench_adapt_tx(void)
+{
+    uint8_t buf[255];
+    lora_raw_adapt_status_t status = { .peer = __adapt_rx_addr };
+    uint32_t i, ok = 0;
+    uint64_t t_start;
+    uint8_t step = 0xFF, cut = 0xFF;
+
+    adapt_configure(__adapt_tx_addr);
+
+    t_start = lora_sim_time_us();
+    for(i = 0; i < s_opt.count; ++i)
+    {
+        lora_raw_adapt_msg_t msg = {
+            .peer = __adapt_rx_addr,
+            .buf = buf,
+            .len = s_opt.len
+        };
+        payload_fill(buf, s_opt.len, i);
+        if(lora_ioctl(__LORA_IOCTL_ADAPT_SEND, &msg) == __LORA_OK)
+            ++ ok;
+
+        /* trace every rate change the receiver answers */
+        lora_ioctl(__LORA_IOCTL_ADAPT_STATUS, &status);
+        if(status.tx_step != step || status.tx_power_cut != cut) {
+            step = status.tx_step;
+            cut = status.tx_power_cut;
+            printf("  msg %4u -> step %u SF%u BW%u -%u dB (peer snr %+d dB)\n",
+                i, step, status.tx_sf, 125 << status.tx_bw, cut,
+                status.tx_snr);
+        }
+        if(s_opt.gap_ms)
+            usleep(s_opt.gap_ms * 1000);
+    }
+
+    double secs = (lora_sim_time_us() - t_start) / 1e6;
+    printf("== adapt-tx: %u messages x %u bytes, base SF%u\n", s_opt.count,
+        s_opt.len, s_opt.sf);
+    printf("  %-22s: %u / %u\n", "acknowledged", ok, s_opt.count);
+    printf("  %-22s: %.1f bytes/s (base rate %.1f bytes/s)\n", "goodput",
+        ok * s_opt.len / secs, s_opt.len * 1e6 / raw_frame_toa_us());
+    adapt_report("adapt-tx", __adapt_rx_addr);
+    return ok ? 0 : 1;
+}
+
+static int bench_adapt_rx(void)
+{
+    uint8_t buf[255];
+    uint32_t received = 0, errors = 0;
+    uint32_t seq;
+    uint64_t ts;
+
+    adapt_configure(__adapt_rx_addr);
+
+    /* runs until the sender goes silent for the reception duration */
+    for(;;)
+    {
+        lora_raw_adapt_msg_t msg = {
+            .buf = buf,
+            .len = sizeof(buf),
+            .timeout = s_opt.duration_s * 1000
+        };
+        if(lora_ioctl(__LORA_IOCTL_ADAPT_RECV, &msg) != __LORA_OK)
+            break;
+        if( ! payload_parse(buf, msg.len, &seq, &ts) )
+            ++ errors;
+        ++ received;
+    }
+
+    printf("== adapt-rx: %u messages, %u corrupted\n", received, errors);
+    adapt_report("adapt-rx", __adapt_tx_addr);
+    return received && ! errors ? 0 : 1;
+}
+
+/* --- LoRaWAN mode --------------------------------------------------------- */
+
+static bool wan_activate(void)
+{
+    uint8_t dev_eui[] = __sim_default_dev_eui;
+    uint8_t nwk_s_key[] = __sim_default_nwk_s_key;
+    uint8_t app_s_key[] = __sim_default_app_s_key;
+    bool joined = false;
+    uint32_t i;
+
+    lora_change_mode(__LORA_MODE_WAN);
+
+    lora_wan_param_t param = {
+        .type = __LORA_WAN_PARAM_REGION,
+        .param.region = __LORA_REGION_EU868
+    };
+    lora_ioctl(__LORA_IOCTL_SET_PARAM, &param);
+
+    lora_commission_params_t commission = {
+        .type = __LORA_COMMISSION_ABP,
+        .version = __LORA_WAN_VERSION_1_0_X,
+        .abp = {
+            .dev_eui = dev_eui,
+            .dev_addr = __sim_default_dev_addr,
+            .app_s_key = app_s_key,
+            .nwk_s_key = nwk_s_key,
+        }
+    };
+    lora_ioctl(__LORA_IOCTL_SET_COMMISSION, &commission);
+    lora_ioctl(__LORA_IOCTL_JOIN, NULL);
+    for(i = 0; i < 50 && ! joined; ++i) {
+        usleep(100000);
+        lora_ioctl(__LORA_IOCTL_JOIN_STATUS, &joined);
+    }
+    return joined;
+}
+
+static int bench_wan(void)
+{
+    uint8_t buf[255];
+    latency_stats_t latency;
+    uint32_t i, ok = 0;
+    uint64_t t0, t_start;
+    lora_error_t ret;
+
+    if( ! wan_activate() ) {
+        printf("== wan: activation failed\n");
+        return -1;
+    }
+    lora_ioctl(__LORA_IOCTL_PORT_OPEN, &s_opt.port);
+
+    stats_init(&latency, s_opt.count);
+    t_start = lora_sim_time_us();
+    for(i = 0; i < s_opt.count; ++i)
+    {
+        lora_tx_params_t tx_params = {
+            .buf = buf,
+            .len = s_opt.len,
+            .port = s_opt.port,
+            .confirm = s_opt.confirmed,
+            .sync = true,
+            .retries = 1,
+            .msg_app_id = i,
+        };
+        payload_fill(buf, s_opt.len, i);
+        t0 = lora_sim_time_us();
+        ret = lora_tx(&tx_params);
+        if(ret == __LORA_OK) {
+            stats_add(&latency, lora_sim_time_us() - t0);
+            ++ ok;
+        }
+        if(s_opt.gap_ms)
+            usleep(s_opt.gap_ms * 1000);
+    }
+
+    double secs = (lora_sim_time_us() - t_start) / 1e6;
+    printf("== wan: %u %s uplinks x %u bytes\n", s_opt.count,
+        s_opt.confirmed ? "confirmed" : "unconfirmed", s_opt.len);
+    printf("  %-22s: %u / %u\n", s_opt.confirmed ? "acknowledged" : "sent",
+        ok, s_opt.count);
+    printf("  %-22s: %.2f uplinks/s\n", "throughput", s_opt.count / secs);
+    stats_print(s_opt.confirmed ? "tx request -> confirm" :
+        "tx request -> done", &latency);
+
+    lora_stats();
+    return 0;
+}
+
+static struct {
+    pthread_mutex_t mutex;
+    latency_stats_t latency;
+    uint32_t        received;
+    uint32_t        unicast;
+    uint32_t        errors;
+} s_mcast = {
+    .mutex = PTHREAD_MUTEX_INITIALIZER
+};
+
+static void wan_mcast_callback(lora_event_t event, void* event_data)
+{
+    uint8_t buf[255];
+    uint32_t seq;
+    uint64_t ts, now = lora_sim_time_us();
+
+    if(event != __LORA_EVENT_INDICATION)
+        return;
+
+    lora_wan_ind_params_t ind = { .buf = buf, .len = sizeof(buf) };
+    for(;;) {
+        ind.len = sizeof(buf);
+        lora_ioctl(__LORA_IOCTL_PORT_GET_IND_PARAM, &ind);
+        if(ind.event == __LORA_EVENT_NONE)
+            break;
+        if(ind.event != __LORA_EVENT_RX_DONE)
+            continue;
+
+        pthread_mutex_lock(&s_mcast.mutex);
+        if(ind.rx.mcast_group < 0) {
+            ++ s_mcast.unicast;
+        } else if( ind.port_num != __sim_default_mc_port ||
+                   ind.len != __sim_default_mc_len ||
+                   ! payload_parse(buf, ind.len, &seq, &ts) ||
+                   seq != ind.rx.dl_frame_counter ) {
+            ++ s_mcast.errors;
+        } else {
+            stats_add(&s_mcast.latency, now - ts);
+            ++ s_mcast.received;
+        }
+        pthread_mutex_unlock(&s_mcast.mutex);
+    }
+}
+
+static int bench_wan_mcast(void)
+{
+    uint8_t mc_nwk_s_key[] = __sim_default_mc_nwk_s_key;
+    uint8_t mc_app_s_key[] = __sim_default_mc_app_s_key;
+    uint8_t mc_port = __sim_default_mc_port;
+    uint8_t group = 0;
+
+    if( ! wan_activate() ) {
+        printf("== wan-mcast: activation failed\n");
+        return -1;
+    }
+
+    stats_init(&s_mcast.latency, 10000);
+    lora_callback_t callback = {
+        .port = __port_any,
+        .callback = wan_mcast_callback
+    };
+    lora_ioctl(__LORA_IOCTL_SET_CALLBACK, &callback);
+    lora_ioctl(__LORA_IOCTL_PORT_OPEN, &mc_port);
+
+    /* the session ends by itself after the reception duration */
+    lora_wan_mcast_setup_t setup = {
+        .group = group,
+        .addr = __sim_default_mc_addr,
+        .nwk_s_key = mc_nwk_s_key,
+        .app_s_key = mc_app_s_key,
+        .f_cnt_min = 0,
+        .f_cnt_max = 0xFFFFFFFF,
+        .class = __LORA_WAN_CLASS_C,
+        .frequency = __sim_default_mc_freq,
+        .data_rate = __sim_default_mc_dr,
+        .session_start = 0,
+        .session_time = s_opt.duration_s,
+    };
+    if(lora_ioctl(__LORA_IOCTL_MCAST_SETUP, &setup) != __LORA_OK) {
+        printf("== wan-mcast: group setup failed\n");
+        return -1;
+    }
+
+    sleep(s_opt.duration_s + 1);
+
+    lora_wan_mcast_status_t status = { .group = group };
+    lora_ioctl(__LORA_IOCTL_MCAST_STATUS, &status);
+    lora_ioctl(__LORA_IOCTL_MCAST_DELETE, &group);
+
+    pthread_mutex_lock(&s_mcast.mutex);
+    printf("== wan-mcast: group %u dev-addr %08x, %u seconds class C session\n",
+        group, status.addr, s_opt.duration_s);
+    printf("  %-22s: %u\n", "indicated", s_mcast.received);
+    printf("  %-22s: %u\n", "corrupted", s_mcast.errors);
+    printf("  %-22s: %u\n", "unicast", s_mcast.unicast);
+    printf("  %-22s: %u frames, %u bytes, last fcnt %u\n", "group counters",
+        status.rx_frames, status.rx_bytes, status.last_f_cnt);
+    printf("  %-22s: %d dBm, %d dB\n", "last rssi, snr",
+        status.last_rssi, status.last_snr);
+    stats_print("ns send -> indication", &s_mcast.latency);
+    pthread_mutex_unlock(&s_mcast.mutex);
+
+    lora_stats();
+    return s_mcast.received && ! s_mcast.errors &&
+        status.rx_frames == s_mcast.received ? 0 : 1;
+}
+
+/* --- main ----------------------------------------------------------------- */
+
+static void usage(void)
+{
+    printf("usage: lora_sim_node "
+        "<raw-tx|raw-rx|raw-echo|raw-ping|xfer-tx|xfer-rx|adapt-tx|adapt-rx|wan|"
+        "wan-mcast> "
+        "[-n count] [-l len] [-s sf] [-f freq] [-g gap-ms] [-t sec] [-b] [-L] "
+        "[-r batch] [-H seed] [-z size] [-w window] [-e fec] [-c] [-p port] [-v]\n");
+}
+
+int main(int argc, char** argv)
+{
+    const char* bench;
+    int opt;
+    int ret;
+
+    if(argc < 2) {
+        usage();
+        return 1;
+    }
+    bench = argv[1];
+    optind = 2;
+    while((opt = getopt(argc, argv, "n:l:s:f:g:t:bLr:H:z:w:e:cp:v")) != -1)
+    {
+        switch(opt)
+        {
+        case 'n': s_opt.count = strtoul(optarg, NULL, 0); break;
+        case 'l': s_opt.len = strtoul(optarg, NULL, 0); break;
+        case 's': s_opt.sf = strtoul(optarg, NULL, 0); break;
+        case 'f': s_opt.freq = strtoul(optarg, NULL, 0); break;
+        case 'g': s_opt.gap_ms = strtoul(optarg, NULL, 0); break;
+        case 't': s_opt.duration_s = strtoul(optarg, NULL, 0); break;
+        case 'b': s_opt.burst = true; break;
+        case 'L': s_opt.lbt = true; break;
+        case 'r': s_opt.ring_batch = strtoul(optarg, NULL, 0); break;
+        case 'H':
+            s_opt.hop = true;
+            s_opt.hop_seed = strtoul(optarg, NULL, 0);
+            break;
+        case 'z': s_opt.size = strtoul(optarg, NULL, 0); break;
+        case 'w': s_opt.window = strtoul(optarg, NULL, 0); break;
+        case 'e': s_opt.fec = strtoul(optarg, NULL, 0); break;
+        case 'c': s_opt.confirmed = true; break;
+        case 'p': s_opt.port = strtoul(optarg, NULL, 0); break;
+        case 'v': s_opt.verbose = true; break;
+        default: usage(); return 1;
+        }
+    }
+
+    void init_log_system(void);
+    init_log_system();
+    if( ! s_opt.verbose )
+        log_filter_subsystem("lora", false);
+
+    lora_board_ctor();
+    lora_ctor();
+
+    if(strcmp(bench, "raw-tx") == 0)
+        ret = bench_raw_tx();
+    else if(strcmp(bench, "raw-rx") == 0)
+        ret = bench_raw_rx(false);
+    else if(strcmp(bench, "raw-echo") == 0)
+        ret = bench_raw_rx(true);
+    else if(strcmp(bench, "raw-ping") == 0)
+        ret = bench_raw_ping();
+    else if(strcmp(bench, "xfer-tx") == 0)
+        ret = bench_xfer_tx();
+    else if(strcmp(bench, "xfer-rx") == 0)
+        ret = bench_xfer_rx();
+    else if(strcmp(bench, "adapt-tx") == 0)
+        ret = bench_adapt_tx();
+    else if(strcmp(bench, "adapt-rx") == 0)
+        ret = bench_adapt_rx();
+    else if(strcmp(bench, "wan") == 0)
+        ret = bench_wan();
+    else if(strcmp(bench, "wan-mcast") == 0)
+        ret = bench_wan_mcast();
+    else {
+        usage();
+        ret = 1;
+    }
+
+    fflush(stdout);
+    /* the stack tasks never return, leave without the destructors */
+    _exit(ret);
+}
+
+/* --- end of file ---------------------------------------------------------- */
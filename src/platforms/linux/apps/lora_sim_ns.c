@@ -0,0 +1,507 @@
+/** -------------------------------------------------------------------------- *
+ * @copyright Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ * @author  Ahmed Sabry (SG Wireless)
+ * 
+ * @brief   stand-in LoRaWAN network server and gateway of the Linux host
+ *          platform. It listens to the simulated air, validates the ABP
+ *          uplinks of the simulated nodes and acknowledges the confirmed ones
+ *          in RX1. It can also broadcast the downlinks of a multicast group.
+ * --------------------------------------------------------------------------- *
+ */
+
+/** -------------------------------------------------------------------------- *
+ * usage: lora_sim_ns [options]
+ *  options:
+ *      -t <sec>    run duration, 0 runs until interrupted  (default 0)
+ *      -m <msec>   sends a multicast downlink every period on the multicast
+ *                  group channel of lora_sim_defaults.h     (default off)
+ *      -v          prints every received uplink
+ *
+ * The server knows only the ABP session of lora_sim_defaults.h, it does not
+ * implement the MAC commands nor the join procedure. It is enough to close
+ * the class-A loop of the confirmed uplinks and to account for the uplink
+ * losses, the collisions and the frame counter gaps of the benchmarks.
+ * --------------------------------------------------------------------------- *
+ */
+
+/* --- includes ------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <signal.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "aes.h"
+#include "cmac.h"
+#include "lora_sim_air.h"
+#include "lora_sim_defaults.h"
+
+/* --- lorawan frame definitions -------------------------------------------- */
+
+#define __mhdr_unconfirmed_up       (0x40)
+#define __mhdr_unconfirmed_down     (0x60)
+#define __mhdr_confirmed_up         (0x80)
+#define __fctrl_ack                 (0x20)
+#define __fhdr_min_len              (1 + 4 + 1 + 2)     /* mhdr + fhdr */
+#define __mic_len                   (4)
+
+#define __dir_uplink                (0)
+#define __dir_downlink              (1)
+
+/* --- server state --------------------------------------------------------- */
+
+#define __pending_queue_size        (32)
+
+typedef struct {
+    lora_sim_frame_t    frame;
+    lora_sim_rx_info_t  info;
+    uint64_t            end_us;
+} pending_frame_t;
+
+static struct {
+    pthread_mutex_t     mutex;
+    pthread_cond_t      cond;
+    pthread_mutex_t     tx_mutex;   /* the acks and multicast senders */
+    pending_frame_t     queue[__pending_queue_size];
+    uint32_t            head;
+    uint32_t            count;
+
+    uint8_t             nwk_s_key[16];
+    uint32_t            dev_addr;
+    uint32_t            fcnt_up;
+    bool                fcnt_up_valid;
+    uint32_t            fcnt_down;
+    bool                verbose;
+
+    uint8_t             mc_nwk_s_key[16];
+    uint8_t             mc_app_s_key[16];
+    uint32_t            mc_addr;
+    uint32_t            mc_fcnt;
+    uint32_t            mc_period_ms;
+
+    struct {
+        uint32_t heard;         /* all frames heard on the air */
+        uint32_t lost;          /* below sensitivity or dropped by the PER */
+        uint32_t collided;
+        uint32_t overflow;      /* pending queue overflow */
+        uint32_t not_lorawan;
+        uint32_t foreign;       /* other device addresses */
+        uint32_t bad_mic;
+        uint32_t uplinks;       /* valid uplinks */
+        uint32_t confirmed;
+        uint32_t duplicates;
+        uint32_t fcnt_gaps;     /* missed frame counters */
+        uint32_t acks;
+        uint32_t mcasts;        /* multicast downlinks sent */
+    } stats;
+} s_ns = {
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+    .cond = PTHREAD_COND_INITIALIZER,
+    .tx_mutex = PTHREAD_MUTEX_INITIALIZER,
+    .nwk_s_key = __sim_default_nwk_s_key,
+    .dev_addr = __sim_default_dev_addr,
+    .mc_nwk_s_key = __sim_default_mc_nwk_s_key,
+    .mc_app_s_key = __sim_default_mc_app_s_key,
+    .mc_addr = __sim_default_mc_addr,
+};
+
+static volatile sig_atomic_t s_stop;
+
+/* --- helpers -------------------------------------------------------------- */
+
+static void sleep_until_us(uint64_t deadline_us)
+{
+    uint64_t now = lora_sim_time_us();
+    if(deadline_us > now) {
+        uint64_t diff = deadline_us - now;
+        struct timespec ts = {
+            .tv_sec = diff / 1000000u,
+            .tv_nsec = (diff % 1000000u) * 1000u
+        };
+        nanosleep(&ts, NULL);
+    }
+}
+
+static uint32_t get_u32_le(const uint8_t* p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void put_u32_le(uint8_t* p, uint32_t v)
+{
+    p[0] = v;
+    p[1] = v >> 8;
+    p[2] = v >> 16;
+    p[3] = v >> 24;
+}
+
+/**
+ * computes the LoRaWAN 1.0.x data frame MIC over the frame excluding the MIC
+ */
+static uint32_t compute_mic(const uint8_t* key, const uint8_t* msg,
+    uint8_t len, uint8_t dir, uint32_t dev_addr, uint32_t fcnt)
+{
+    uint8_t b0[16] = { 0x49 };
+    uint8_t digest[16];
+    AES_CMAC_CTX ctx;
+
+    b0[5] = dir;
+    put_u32_le(&b0[6], dev_addr);
+    put_u32_le(&b0[10], fcnt);
+    b0[15] = len;
+
+    AES_CMAC_Init(&ctx);
+    AES_CMAC_SetKey(&ctx, key);
+    AES_CMAC_Update(&ctx, b0, sizeof(b0));
+    AES_CMAC_Update(&ctx, msg, len);
+    AES_CMAC_Final(digest, &ctx);
+
+    return get_u32_le(digest);
+}
+
+/**
+ * encrypts the FRMPayload in place with the LoRaWAN 1.0.x A(i) key stream
+ */
+static void encrypt_payload(const uint8_t* key, uint8_t* buf, uint8_t len,
+    uint8_t dir, uint32_t dev_addr, uint32_t fcnt)
+{
+    uint8_t a[16] = { 0x01 };
+    uint8_t s[16];
+    aes_context ctx;
+    uint8_t i;
+
+    a[5] = dir;
+    put_u32_le(&a[6], dev_addr);
+    put_u32_le(&a[10], fcnt);
+    aes_set_key(key, 16, &ctx);
+
+    for(i = 0; i < len; ++i) {
+        if((i & 15) == 0) {
+            a[15] = (i >> 4) + 1;
+            aes_encrypt(a, s, &ctx);
+        }
+        buf[i] ^= s[i & 15];
+    }
+}
+
+/* --- downlinks ------------------------------------------------------------ */
+
+static void send_ack(const lora_sim_frame_t* p_uplink, uint64_t uplink_end_us)
+{
+    lora_sim_frame_t frame = {0};
+    uint8_t* p = frame.payload;
+    uint32_t fcnt = s_ns.fcnt_down ++;
+
+    /* unconfirmed downlink without port carrying the ACK bit */
+    p[0] = __mhdr_unconfirmed_down;
+    put_u32_le(&p[1], s_ns.dev_addr);
+    p[5] = __fctrl_ack;
+    p[6] = fcnt;
+    p[7] = fcnt >> 8;
+    put_u32_le(&p[8], compute_mic(s_ns.nwk_s_key, p, 8, __dir_downlink,
+        s_ns.dev_addr, fcnt));
+    frame.len = 8 + __mic_len;
+
+    /* RX1 with zero data-rate offset, same channel and spreading factor */
+    frame.modem = __lora_sim_modem_lora;
+    frame.freq = p_uplink->freq;
+    frame.sf = p_uplink->sf;
+    frame.bw = p_uplink->bw;
+    frame.cr = p_uplink->cr;
+    frame.preamble = 8;
+    frame.sync_word = __sim_default_sync_word;
+    frame.iq_inverted = true;
+    frame.crc_on = false;
+    frame.tx_power = 14;
+    frame.toa_us = lora_sim_lora_toa_us(frame.sf, frame.bw, frame.cr,
+        frame.preamble, false, frame.crc_on, frame.len);
+
+    sleep_until_us(uplink_end_us + __sim_default_rx1_delay_ms * 1000u);
+
+    pthread_mutex_lock(&s_ns.tx_mutex);
+    frame.start_us = lora_sim_time_us();
+    if(lora_sim_air_send(&frame) == 0)
+        ++ s_ns.stats.acks;
+    pthread_mutex_unlock(&s_ns.tx_mutex);
+}
+
+/* --- multicast ------------------------------------------------------------ */
+
+/* the payload carries the sequence number and the send timestamp as the
+   benchmark payloads of the nodes */
+static void send_mcast(void)
+{
+    lora_sim_frame_t frame = {0};
+    uint8_t* p = frame.payload;
+    uint32_t fcnt = s_ns.mc_fcnt ++;
+    uint64_t now = lora_sim_time_us();
+    uint8_t len = __sim_default_mc_len;
+    uint8_t i;
+
+    p[0] = __mhdr_unconfirmed_down;
+    put_u32_le(&p[1], s_ns.mc_addr);
+    p[5] = 0;
+    p[6] = fcnt;
+    p[7] = fcnt >> 8;
+    p[8] = __sim_default_mc_port;
+    for(i = 0; i < len; ++i)
+        p[9 + i] = (uint8_t)(fcnt + i);
+    memcpy(&p[9], &fcnt, 4);
+    memcpy(&p[13], &now, 8);
+    encrypt_payload(s_ns.mc_app_s_key, &p[9], len, __dir_downlink,
+        s_ns.mc_addr, fcnt);
+    put_u32_le(&p[9 + len], compute_mic(s_ns.mc_nwk_s_key, p, 9 + len,
+        __dir_downlink, s_ns.mc_addr, fcnt));
+    frame.len = 9 + len + __mic_len;
+
+    frame.modem = __lora_sim_modem_lora;
+    frame.freq = __sim_default_mc_freq;
+    frame.sf = __sim_default_mc_sf;
+    frame.bw = 0x04;            /* 125 kHz */
+    frame.cr = 1;
+    frame.preamble = 8;
+    frame.sync_word = __sim_default_sync_word;
+    frame.iq_inverted = true;
+    frame.crc_on = false;
+    frame.tx_power = 14;
+    frame.toa_us = lora_sim_lora_toa_us(frame.sf, frame.bw, frame.cr,
+        frame.preamble, false, frame.crc_on, frame.len);
+
+    pthread_mutex_lock(&s_ns.tx_mutex);
+    frame.start_us = lora_sim_time_us();
+    if(lora_sim_air_send(&frame) == 0)
+        ++ s_ns.stats.mcasts;
+    pthread_mutex_unlock(&s_ns.tx_mutex);
+
+    if(s_ns.verbose)
+        printf("[ns] multicast dev:%08x fcnt:%u len:%u\n",
+            s_ns.mc_addr, fcnt, len);
+}
+
+static void* ns_mcast_worker(void* arg)
+{
+    (void)arg;
+    uint64_t next_us = lora_sim_time_us();
+
+    for(;;) {
+        next_us += s_ns.mc_period_ms * 1000u;
+        sleep_until_us(next_us);
+        send_mcast();
+    }
+    return NULL;
+}
+
+/* --- uplinks -------------------------------------------------------------- */
+
+static void process_uplink(const pending_frame_t* p_pending)
+{
+    const lora_sim_frame_t* p_frame = &p_pending->frame;
+    const uint8_t* msg = p_frame->payload;
+    uint8_t len = p_frame->len;
+    uint8_t mhdr;
+    uint32_t dev_addr;
+    uint32_t fcnt;
+    uint32_t mic;
+
+    if( p_frame->modem != __lora_sim_modem_lora || p_frame->iq_inverted ||
+        p_frame->sync_word != __sim_default_sync_word ||
+        len < __fhdr_min_len + __mic_len )
+    {
+        ++ s_ns.stats.not_lorawan;
+        return;
+    }
+
+    mhdr = msg[0];
+    if( mhdr != __mhdr_unconfirmed_up && mhdr != __mhdr_confirmed_up ) {
+        ++ s_ns.stats.not_lorawan;
+        return;
+    }
+
+    dev_addr = get_u32_le(&msg[1]);
+    if(dev_addr != s_ns.dev_addr) {
+        ++ s_ns.stats.foreign;
+        return;
+    }
+
+    /* extend the 16-bit frame counter into the 32-bit session counter */
+    fcnt = msg[6] | (msg[7] << 8);
+    if(s_ns.fcnt_up_valid) {
+        fcnt |= s_ns.fcnt_up & 0xffff0000u;
+        if(fcnt < s_ns.fcnt_up && s_ns.fcnt_up - fcnt > 0x8000u)
+            fcnt += 0x10000u;
+    }
+
+    mic = get_u32_le(&msg[len - __mic_len]);
+    if(mic != compute_mic(s_ns.nwk_s_key, msg, len - __mic_len, __dir_uplink,
+            dev_addr, fcnt))
+    {
+        ++ s_ns.stats.bad_mic;
+        return;
+    }
+
+    if(s_ns.fcnt_up_valid && fcnt <= s_ns.fcnt_up) {
+        /* retransmission of a confirmed uplink or a replay */
+        ++ s_ns.stats.duplicates;
+    } else {
+        if(s_ns.fcnt_up_valid)
+            s_ns.stats.fcnt_gaps += fcnt - s_ns.fcnt_up - 1;
+        s_ns.fcnt_up = fcnt;
+        s_ns.fcnt_up_valid = true;
+        ++ s_ns.stats.uplinks;
+    }
+
+    if(s_ns.verbose)
+        printf("[ns] uplink %s dev:%08x fcnt:%u len:%u rssi:%d snr:%d\n",
+            mhdr == __mhdr_confirmed_up ? "C" : "U",
+            dev_addr, fcnt, len, p_pending->info.rssi, p_pending->info.snr);
+
+    if(mhdr == __mhdr_confirmed_up) {
+        ++ s_ns.stats.confirmed;
+        send_ack(p_frame, p_pending->end_us);
+    }
+}
+
+/* --- air interface -------------------------------------------------------- */
+
+/* called at the frame start, the frame is queued until its end on the air */
+static void air_rx_callback(const lora_sim_frame_t * p_frame,
+    const lora_sim_rx_info_t * p_info)
+{
+    pthread_mutex_lock(&s_ns.mutex);
+    ++ s_ns.stats.heard;
+    if(p_info->lost) {
+        ++ s_ns.stats.lost;
+    } else if(s_ns.count == __pending_queue_size) {
+        ++ s_ns.stats.overflow;
+    } else {
+        pending_frame_t* p = &s_ns.queue[
+            (s_ns.head + s_ns.count) % __pending_queue_size];
+        p->frame = *p_frame;
+        p->info = *p_info;
+        p->end_us = p_frame->start_us + p_frame->toa_us;
+        ++ s_ns.count;
+        pthread_cond_signal(&s_ns.cond);
+    }
+    pthread_mutex_unlock(&s_ns.mutex);
+}
+
+static void* ns_worker(void* arg)
+{
+    (void)arg;
+    pending_frame_t pending;
+
+    for(;;) {
+        pthread_mutex_lock(&s_ns.mutex);
+        while(s_ns.count == 0)
+            pthread_cond_wait(&s_ns.cond, &s_ns.mutex);
+        pending = s_ns.queue[s_ns.head];
+        s_ns.head = (s_ns.head + 1) % __pending_queue_size;
+        -- s_ns.count;
+        pthread_mutex_unlock(&s_ns.mutex);
+
+        sleep_until_us(pending.end_us);
+
+        if(lora_sim_air_is_collided(&pending.frame, pending.info.rssi)) {
+            ++ s_ns.stats.collided;
+            continue;
+        }
+        process_uplink(&pending);
+    }
+    return NULL;
+}
+
+/* --- main ----------------------------------------------------------------- */
+
+static void on_signal(int sig)
+{
+    (void)sig;
+    s_stop = 1;
+}
+
+static void print_stats(void)
+{
+    printf("[ns] heard:%u lost:%u collided:%u overflow:%u\n",
+        s_ns.stats.heard, s_ns.stats.lost, s_ns.stats.collided,
+        s_ns.stats.overflow);
+    printf("[ns] not-lorawan:%u foreign:%u bad-mic:%u\n",
+        s_ns.stats.not_lorawan, s_ns.stats.foreign, s_ns.stats.bad_mic);
+    printf("[ns] uplinks:%u confirmed:%u duplicates:%u fcnt-gaps:%u acks:%u\n",
+        s_ns.stats.uplinks, s_ns.stats.confirmed, s_ns.stats.duplicates,
+        s_ns.stats.fcnt_gaps, s_ns.stats.acks);
+    if(s_ns.mc_period_ms)
+        printf("[ns] multicast dev:%08x downlinks:%u\n",
+            s_ns.mc_addr, s_ns.stats.mcasts);
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t duration_s = 0;
+    pthread_t worker;
+    pthread_t mcast_worker;
+    int opt;
+
+    while((opt = getopt(argc, argv, "t:m:v")) != -1) {
+        switch(opt) {
+            case 't': duration_s = strtoul(optarg, NULL, 0); break;
+            case 'm': s_ns.mc_period_ms = strtoul(optarg, NULL, 0); break;
+            case 'v': s_ns.verbose = true; break;
+            default:
+                fprintf(stderr, "usage: %s [-t <sec>] [-m <msec>] [-v]\n",
+                    argv[0]);
+                return 1;
+        }
+    }
+
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+
+    if(lora_sim_air_open(air_rx_callback) != 0) {
+        fprintf(stderr, "[ns] no free air slot\n");
+        return 1;
+    }
+    printf("[ns] listening on air slot %u, dev-addr %08x\n",
+        lora_sim_air_node_id(), s_ns.dev_addr);
+
+    pthread_create(&worker, NULL, ns_worker, NULL);
+    if(s_ns.mc_period_ms)
+        pthread_create(&mcast_worker, NULL, ns_mcast_worker, NULL);
+
+    for(uint32_t elapsed = 0; !s_stop; ++ elapsed) {
+        if(duration_s && elapsed >= duration_s * 10)
+            break;
+        usleep(100000);
+    }
+
+    pthread_mutex_lock(&s_ns.mutex);
+    print_stats();
+    pthread_mutex_unlock(&s_ns.mutex);
+
+    lora_sim_air_close();
+    _exit(0);
+}
+
+/* --- end of file ---------------------------------------------------------- */
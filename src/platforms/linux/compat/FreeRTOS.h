@@ -0,0 +1,70 @@
+/** -------------------------------------------------------------------------- *
+ * @copyright Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ * @author  Ahmed Sabry (SG Wireless)
+ * 
+ * @brief   minimal FreeRTOS kernel API shim for the Linux host platform.
+ *          only the subset used by the lora stack is provided, it is
+ *          implemented over pthreads in esp_compat.c
+ * --------------------------------------------------------------------------- *
+ */
+#ifndef __COMPAT_FREERTOS_H__
+#define __COMPAT_FREERTOS_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --- includes ------------------------------------------------------------- */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <assert.h>
+
+/* --- kernel types and constants ------------------------------------------- */
+
+typedef long            BaseType_t;
+typedef unsigned long   UBaseType_t;
+typedef uint32_t        TickType_t;
+
+#define pdFALSE                 ( ( BaseType_t ) 0 )
+#define pdTRUE                  ( ( BaseType_t ) 1 )
+#define pdFAIL                  ( pdFALSE )
+#define pdPASS                  ( pdTRUE )
+
+/* the host tick is 1 msec */
+#define configTICK_RATE_HZ      ( 1000 )
+#define portTICK_PERIOD_MS      ( ( TickType_t ) 1000 / configTICK_RATE_HZ )
+#define portMAX_DELAY           ( ( TickType_t ) 0xffffffffUL )
+#define pdMS_TO_TICKS(ms)       ( ( TickType_t ) ( ms ) )
+
+#define configMAX_PRIORITIES    ( 25 )
+#define tskNO_AFFINITY          ( 0x7FFFFFFF )
+#define configASSERT(x)         assert( x )
+
+#include "task.h"
+
+/* --- end of file ---------------------------------------------------------- */
+#ifdef __cplusplus
+}
+#endif
+#endif /* __COMPAT_FREERTOS_H__ */
@@ -0,0 +1,459 @@
+/** -------------------------------------------------------------------------- *
+ * @copyright Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ * @author  Ahmed Sabry (SG Wireless)
+ * 
+ * @brief   implementation of the FreeRTOS and esp-idf shims needed by the lora
+ *          stack on the Linux host platform over pthreads and the libc
+ * --------------------------------------------------------------------------- *
+ */
+
+/** -------------------------------------------------------------------------- *
+ * includes
+ * --------------------------------------------------------------------------- *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/random.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "esp_event.h"
+#include "esp_random.h"
+#include "esp_crc.h"
+#include "esp_system.h"
+
+/** -------------------------------------------------------------------------- *
+ * helpers
+ * --------------------------------------------------------------------------- *
+ */
+static void abs_deadline(struct timespec * p_ts, TickType_t ticks)
+{
+    clock_gettime(CLOCK_MONOTONIC, p_ts);
+    p_ts->tv_sec  += ticks / 1000U;
+    p_ts->tv_nsec += (ticks % 1000U) * 1000000L;
+    if(p_ts->tv_nsec >= 1000000000L) {
+        p_ts->tv_sec ++;
+        p_ts->tv_nsec -= 1000000000L;
+    }
+}
+
+static void monotonic_cond_init(pthread_cond_t * p_cond)
+{
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(p_cond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+/** -------------------------------------------------------------------------- *
+ * tasks
+ * --------------------------------------------------------------------------- *
+ */
+typedef struct {
+    pthread_t       thread;
+    const char *    name;
+    UBaseType_t     priority;
+    TaskFunction_t* p_code;
+    void *          param;
+} host_task_t;
+
+static __thread host_task_t * s_current_task;
+
+static host_task_t * current_task(void)
+{
+    /* threads not created by xTaskCreate() (main, timers, ..) get a lazily
+     * allocated descriptor so that they own a unique task handle */
+    if(s_current_task == NULL) {
+        s_current_task = calloc(1, sizeof(host_task_t));
+        s_current_task->thread = pthread_self();
+        s_current_task->name = "host";
+        s_current_task->priority = 1;
+    }
+    return s_current_task;
+}
+
+static void* task_entry(void* arg)
+{
+    s_current_task = arg;
+    s_current_task->p_code(s_current_task->param);
+    return NULL;
+}
+
+BaseType_t xTaskCreate( TaskFunction_t * p_task_code, const char * name,
+    uint32_t stack_depth, void * param, UBaseType_t priority,
+    TaskHandle_t * p_created_task )
+{
+    (void)stack_depth;
+    host_task_t * p_task = calloc(1, sizeof(host_task_t));
+    if(p_task == NULL)
+        return pdFAIL;
+
+    p_task->name = name;
+    p_task->priority = priority;
+    p_task->p_code = p_task_code;
+    p_task->param = param;
+
+    if(pthread_create(&p_task->thread, NULL, task_entry, p_task) != 0) {
+        free(p_task);
+        return pdFAIL;
+    }
+    pthread_detach(p_task->thread);
+
+    if(p_created_task)
+        *p_created_task = p_task;
+    return pdPASS;
+}
+
+void vTaskDelete( TaskHandle_t task )
+{
+    host_task_t * p_task = task ? task : current_task();
+    if(p_task == current_task()) {
+        pthread_exit(NULL);
+    }
+    pthread_cancel(p_task->thread);
+}
+
+void vTaskDelay( TickType_t ticks )
+{
+    struct timespec ts = {
+        .tv_sec  = ticks / 1000U,
+        .tv_nsec = (ticks % 1000U) * 1000000L };
+    while(nanosleep(&ts, &ts) != 0 && errno == EINTR);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle( void )
+{
+    return current_task();
+}
+
+const char * pcTaskGetName( TaskHandle_t task )
+{
+    host_task_t * p_task = task ? task : current_task();
+    return p_task->name;
+}
+
+UBaseType_t uxTaskPriorityGet( TaskHandle_t task )
+{
+    host_task_t * p_task = task ? task : current_task();
+    return p_task->priority;
+}
+
+/** -------------------------------------------------------------------------- *
+ * semaphores
+ * --------------------------------------------------------------------------- *
+ */
+typedef struct {
+    pthread_mutex_t mutex;
+    pthread_cond_t  cond;
+    uint32_t        count;
+    uint32_t        max_count;
+} host_sem_t;
+
+static SemaphoreHandle_t host_sem_new(uint32_t initial, uint32_t max)
+{
+    host_sem_t * p_sem = calloc(1, sizeof(host_sem_t));
+    if(p_sem == NULL)
+        return NULL;
+    pthread_mutex_init(&p_sem->mutex, NULL);
+    monotonic_cond_init(&p_sem->cond);
+    p_sem->count = initial;
+    p_sem->max_count = max;
+    return p_sem;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex( void )
+{
+    return host_sem_new(1, 1);
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary( void )
+{
+    return host_sem_new(0, 1);
+}
+
+BaseType_t xSemaphoreTake( SemaphoreHandle_t sem, TickType_t ticks )
+{
+    host_sem_t * p_sem = sem;
+    BaseType_t ret = pdTRUE;
+    struct timespec deadline;
+
+    if(ticks != portMAX_DELAY)
+        abs_deadline(&deadline, ticks);
+
+    pthread_mutex_lock(&p_sem->mutex);
+    while(p_sem->count == 0) {
+        if(ticks == portMAX_DELAY) {
+            pthread_cond_wait(&p_sem->cond, &p_sem->mutex);
+        } else if(pthread_cond_timedwait(&p_sem->cond, &p_sem->mutex,
+                &deadline) == ETIMEDOUT) {
+            ret = pdFALSE;
+            break;
+        }
+    }
+    if(ret == pdTRUE)
+        -- p_sem->count;
+    pthread_mutex_unlock(&p_sem->mutex);
+    return ret;
+}
+
+BaseType_t xSemaphoreGive( SemaphoreHandle_t sem )
+{
+    host_sem_t * p_sem = sem;
+    BaseType_t ret = pdFALSE;
+
+    pthread_mutex_lock(&p_sem->mutex);
+    if(p_sem->count < p_sem->max_count) {
+        ++ p_sem->count;
+        pthread_cond_signal(&p_sem->cond);
+        ret = pdTRUE;
+    }
+    pthread_mutex_unlock(&p_sem->mutex);
+    return ret;
+}
+
+void vSemaphoreDelete( SemaphoreHandle_t sem )
+{
+    host_sem_t * p_sem = sem;
+    pthread_cond_destroy(&p_sem->cond);
+    pthread_mutex_destroy(&p_sem->mutex);
+    free(p_sem);
+}
+
+/** -------------------------------------------------------------------------- *
+ * event loops
+ * --------------------------------------------------------------------------- *
+ */
+#define __max_loop_handlers     (16)
+
+typedef struct {
+    esp_event_base_t    base;
+    int32_t             id;
+    void*               data;
+} host_event_t;
+
+typedef struct {
+    esp_event_base_t    base;
+    int32_t             id;
+    esp_event_handler_t handler;
+    void*               arg;
+    bool                active;
+} host_event_handler_t;
+
+typedef struct {
+    pthread_t       thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t  cond;
+    host_event_t*   queue;
+    uint32_t        queue_size;
+    uint32_t        head;
+    uint32_t        count;
+    host_event_handler_t handlers[__max_loop_handlers];
+} host_event_loop_t;
+
+static void* event_loop_task(void* arg)
+{
+    host_event_loop_t * p_loop = arg;
+    host_event_t evt;
+    int i;
+
+    while(1)
+    {
+        pthread_mutex_lock(&p_loop->mutex);
+        while(p_loop->count == 0)
+            pthread_cond_wait(&p_loop->cond, &p_loop->mutex);
+        evt = p_loop->queue[p_loop->head];
+        p_loop->head = (p_loop->head + 1) % p_loop->queue_size;
+        -- p_loop->count;
+        pthread_cond_broadcast(&p_loop->cond);
+        pthread_mutex_unlock(&p_loop->mutex);
+
+        /* handlers run without holding the loop lock so that they can post
+         * further events to the same loop */
+        for(i = 0; i < __max_loop_handlers; ++i) {
+            host_event_handler_t h = p_loop->handlers[i];
+            if(h.active && h.id == evt.id &&
+                (h.base == evt.base || strcmp(h.base, evt.base) == 0))
+                h.handler(h.arg, evt.base, evt.id, evt.data);
+        }
+        free(evt.data);
+    }
+    return NULL;
+}
+
+esp_err_t esp_event_loop_create(const esp_event_loop_args_t* event_loop_args,
+    esp_event_loop_handle_t* event_loop)
+{
+    host_event_loop_t * p_loop = calloc(1, sizeof(host_event_loop_t));
+    if(p_loop == NULL)
+        return ESP_ERR_NO_MEM;
+
+    p_loop->queue_size = event_loop_args->queue_size;
+    p_loop->queue = calloc(p_loop->queue_size, sizeof(host_event_t));
+    if(p_loop->queue == NULL) {
+        free(p_loop);
+        return ESP_ERR_NO_MEM;
+    }
+    pthread_mutex_init(&p_loop->mutex, NULL);
+    monotonic_cond_init(&p_loop->cond);
+
+    if(pthread_create(&p_loop->thread, NULL, event_loop_task, p_loop) != 0) {
+        free(p_loop->queue);
+        free(p_loop);
+        return ESP_FAIL;
+    }
+    *event_loop = p_loop;
+    return ESP_OK;
+}
+
+esp_err_t esp_event_loop_delete(esp_event_loop_handle_t event_loop)
+{
+    host_event_loop_t * p_loop = event_loop;
+    pthread_cancel(p_loop->thread);
+    pthread_join(p_loop->thread, NULL);
+    while(p_loop->count --) {
+        free(p_loop->queue[p_loop->head].data);
+        p_loop->head = (p_loop->head + 1) % p_loop->queue_size;
+    }
+    free(p_loop->queue);
+    free(p_loop);
+    return ESP_OK;
+}
+
+esp_err_t esp_event_post_to(esp_event_loop_handle_t event_loop,
+    esp_event_base_t event_base, int32_t event_id, const void* event_data,
+    size_t event_data_size, TickType_t ticks_to_wait)
+{
+    host_event_loop_t * p_loop = event_loop;
+    struct timespec deadline;
+    host_event_t evt = { .base = event_base, .id = event_id };
+
+    if(event_data && event_data_size) {
+        evt.data = malloc(event_data_size);
+        if(evt.data == NULL)
+            return ESP_ERR_NO_MEM;
+        memcpy(evt.data, event_data, event_data_size);
+    }
+
+    if(ticks_to_wait != portMAX_DELAY)
+        abs_deadline(&deadline, ticks_to_wait);
+
+    pthread_mutex_lock(&p_loop->mutex);
+    while(p_loop->count == p_loop->queue_size) {
+        if(ticks_to_wait == portMAX_DELAY) {
+            pthread_cond_wait(&p_loop->cond, &p_loop->mutex);
+        } else if(ticks_to_wait == 0 ||
+            pthread_cond_timedwait(&p_loop->cond, &p_loop->mutex,
+                &deadline) == ETIMEDOUT) {
+            pthread_mutex_unlock(&p_loop->mutex);
+            free(evt.data);
+            return ESP_ERR_TIMEOUT;
+        }
+    }
+    p_loop->queue[(p_loop->head + p_loop->count) % p_loop->queue_size] = evt;
+    ++ p_loop->count;
+    pthread_cond_broadcast(&p_loop->cond);
+    pthread_mutex_unlock(&p_loop->mutex);
+
+    return ESP_OK;
+}
+
+esp_err_t esp_event_handler_instance_register_with(
+    esp_event_loop_handle_t event_loop, esp_event_base_t event_base,
+    int32_t event_id, esp_event_handler_t event_handler,
+    void* event_handler_arg, esp_event_handler_instance_t* instance)
+{
+    host_event_loop_t * p_loop = event_loop;
+    int i;
+    for(i = 0; i < __max_loop_handlers; ++i) {
+        host_event_handler_t * p_h = &p_loop->handlers[i];
+        if( ! p_h->active ) {
+            p_h->base = event_base;
+            p_h->id = event_id;
+            p_h->handler = event_handler;
+            p_h->arg = event_handler_arg;
+            p_h->active = true;
+            if(instance)
+                *instance = p_h;
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_NO_MEM;
+}
+
+esp_err_t esp_event_handler_instance_unregister_with(
+    esp_event_loop_handle_t event_loop, esp_event_base_t event_base,
+    int32_t event_id, esp_event_handler_instance_t instance)
+{
+    host_event_handler_t * p_h = instance;
+    if(p_h == NULL)
+        return ESP_ERR_INVALID_ARG;
+    p_h->active = false;
+    return ESP_OK;
+}
+
+/** -------------------------------------------------------------------------- *
+ * random, crc and system
+ * --------------------------------------------------------------------------- *
+ */
+uint32_t esp_random(void)
+{
+    uint32_t rn;
+    if(getrandom(&rn, sizeof(rn), 0) != sizeof(rn))
+        rn = (uint32_t)random();
+    return rn;
+}
+
+uint32_t esp_crc32_le(uint32_t crc, uint8_t const * buf, uint32_t len)
+{
+    static uint32_t table[256];
+    static bool table_ready = false;
+    uint32_t i, j, c;
+
+    if( ! table_ready ) {
+        for(i = 0; i < 256; ++i) {
+            c = i;
+            for(j = 0; j < 8; ++j)
+                c = (c & 1) ? (c >> 1) ^ 0xEDB88320u : (c >> 1);
+            table[i] = c;
+        }
+        table_ready = true;
+    }
+
+    crc = ~crc;
+    for(i = 0; i < len; ++i)
+        crc = table[(crc ^ buf[i]) & 0xff] ^ (crc >> 8);
+    return ~crc;
+}
+
+void esp_restart(void)
+{
+    fprintf(stderr, "-- esp_restart() requested, terminating the process\n");
+    exit(EXIT_SUCCESS);
+}
+
+/* --- end of file ---------------------------------------------------------- */
@@ -0,0 +1,40 @@
+/** -------------------------------------------------------------------------- *
+ * @copyright Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ * @author  Ahmed Sabry (SG Wireless)
+ * 
+ * @brief   esp-idf error codes shim for the Linux host platform
+ * --------------------------------------------------------------------------- *
+ */
+#ifndef __COMPAT_ESP_ERR_H__
+#define __COMPAT_ESP_ERR_H__
+
+typedef int esp_err_t;
+
+#define ESP_OK                  ( 0 )
+#define ESP_FAIL                ( -1 )
+#define ESP_ERR_NO_MEM          ( 0x101 )
+#define ESP_ERR_INVALID_ARG     ( 0x102 )
+#define ESP_ERR_INVALID_STATE   ( 0x103 )
+#define ESP_ERR_NOT_FOUND       ( 0x105 )
+#define ESP_ERR_TIMEOUT         ( 0x107 )
+
+#endif /* __COMPAT_ESP_ERR_H__ */
@@ -0,0 +1,78 @@
+/** -------------------------------------------------------------------------- *
+ * @copyright Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ * @author  Ahmed Sabry (SG Wireless)
+ * 
+ * @brief   esp-idf user event loops shim for the Linux host platform.
+ *          each loop owns a dispatching thread and a bounded events queue
+ * --------------------------------------------------------------------------- *
+ */
+#ifndef __COMPAT_ESP_EVENT_H__
+#define __COMPAT_ESP_EVENT_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --- includes ------------------------------------------------------------- */
+
+#include "esp_err.h"
+#include "FreeRTOS.h"
+
+/* --- event loop API ------------------------------------------------------- */
+
+typedef const char* esp_event_base_t;
+typedef void*       esp_event_loop_handle_t;
+typedef void*       esp_event_handler_instance_t;
+typedef void (*esp_event_handler_t)(void* event_handler_arg,
+    esp_event_base_t event_base, int32_t event_id, void* event_data);
+
+typedef struct {
+    int32_t     queue_size;
+    const char* task_name;
+    UBaseType_t task_priority;
+    uint32_t    task_stack_size;
+    BaseType_t  task_core_id;
+} esp_event_loop_args_t;
+
+esp_err_t esp_event_loop_create(const esp_event_loop_args_t* event_loop_args,
+    esp_event_loop_handle_t* event_loop);
+
+esp_err_t esp_event_loop_delete(esp_event_loop_handle_t event_loop);
+
+esp_err_t esp_event_post_to(esp_event_loop_handle_t event_loop,
+    esp_event_base_t event_base, int32_t event_id, const void* event_data,
+    size_t event_data_size, TickType_t ticks_to_wait);
+
+esp_err_t esp_event_handler_instance_register_with(
+    esp_event_loop_handle_t event_loop, esp_event_base_t event_base,
+    int32_t event_id, esp_event_handler_t event_handler,
+    void* event_handler_arg, esp_event_handler_instance_t* instance);
+
+esp_err_t esp_event_handler_instance_unregister_with(
+    esp_event_loop_handle_t event_loop, esp_event_base_t event_base,
+    int32_t event_id, esp_event_handler_instance_t instance);
+
+/* --- end of file ---------------------------------------------------------- */
+#ifdef __cplusplus
+}
+#endif
+#endif /* __COMPAT_ESP_EVENT_H__ */
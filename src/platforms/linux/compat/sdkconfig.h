@@ -0,0 +1,62 @@
+/** -------------------------------------------------------------------------- *
+ * @copyright Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ * @author  Ahmed Sabry (SG Wireless)
+ * 
+ * @brief   host configurations of the Linux platform, they mirror the
+ *                   menuconfig defaults of the components built by lora_host.mk
+ * --------------------------------------------------------------------------- *
+ */
+#ifndef __HOST_SDKCONFIG_H__
+#define __HOST_SDKCONFIG_H__
+
+/* --- libs ----------------------------------------------------------------- */
+
+#define CONFIG_SDK_LOG_LIB_ENABLE                                   1
+#define CONFIG_SDK_ADT_IDLL_8_BITS_IMPLEMENTATION_ENABLE            1
+#define CONFIG_SDK_ADT_IDLL_16_BITS_IMPLEMENTATION_ENABLE           1
+#define CONFIG_SDK_ADT_IDLL_32_BITS_IMPLEMENTATION_ENABLE           1
+#define CONFIG_SDK_LIBS_STATE_MACHINE_NAMES                         1
+
+/* --- lora stack (comps/lora/cfg/lora.config) ------------------------------ */
+
+#define CONFIG_LORA_LCT_CONTROL_API                                 1
+#define CONFIG_LORA_DUTY_CYCLE_APP_DEFAULT_DURATION_MS              10000
+#define CONFIG_LORA_WAN_TX_BUFFERS_MEM_SPACE_SIZE                   6
+#define CONFIG_LORA_WAN_RX_BUFFERS_MEM_SPACE_SIZE                   2
+#define CONFIG_LORA_WAN_MAX_APP_LAYER_USED_PORTS                    10
+#define CONFIG_LORA_WAN_TX_AGGREGATION_MAX_MSGS                     16
+#define CONFIG_LORA_WAN_LINK_RING_SLOTS                             32
+#define CONFIG_LORA_WAN_NVM_JOURNAL_SLOT_SIZE                       128
+#define CONFIG_LORA_WAN_NVM_JOURNAL_SLOTS                           16
+#define CONFIG_LORA_WAN_NVM_COMMIT_PERIOD_MS                        5000
+#define CONFIG_LORA_WAN_NVM_FCNT_UP_GAP                             16
+#define CONFIG_LORA_WAN_DEFAULT_SYSTEM_MAX_RX_ERROR_MS              20
+#define CONFIG_LORA_WAN_DEFAULT_RX_WIN_CAL_FINE_TUNE_ENABLE         1
+#define CONFIG_LORA_WAN_DEFAULT_RX_WIN_CAL_CTRL_FINE_TUNE_TIME_SHIFT     20
+#define CONFIG_LORA_WAN_DEFAULT_RX_WIN_CAL_CTRL_FINE_TUNE_TIME_EXTENTION 30
+#define CONFIG_LORA_WAN_RX_WIN_AUTO_CAL_TARGET                      95
+#define CONFIG_LORA_WAN_RX_WIN_AUTO_CAL_MARGIN_MS                   2
+#define CONFIG_LORA_RAW_RX_RING_SLOTS                               8
+#define CONFIG_LORA_RAW_LATENCY_WINDOW                              64
+#define CONFIG_LORA_SPI_TRACE_RECORDS                               128
+
+#endif /* __HOST_SDKCONFIG_H__ */
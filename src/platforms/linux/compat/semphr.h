@@ -0,0 +1,64 @@
+/** -------------------------------------------------------------------------- *
+ * @copyright Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ * @author  Ahmed Sabry (SG Wireless)
+ * 
+ * @brief   FreeRTOS semaphores API shim for the Linux host platform
+ * --------------------------------------------------------------------------- *
+ */
+#ifndef __COMPAT_SEMPHR_H__
+#define __COMPAT_SEMPHR_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --- includes ------------------------------------------------------------- */
+
+#include "FreeRTOS.h"
+
+/* --- semaphores API ------------------------------------------------------- */
+
+typedef void* SemaphoreHandle_t;
+
+/**
+ * @brief   creates a non-recursive mutex, it is owned by the taking thread
+ *          as the FreeRTOS mutexes
+ */
+SemaphoreHandle_t xSemaphoreCreateMutex( void );
+
+/**
+ * @brief   creates a binary semaphore, it is created empty and can be given
+ *          from any thread
+ */
+SemaphoreHandle_t xSemaphoreCreateBinary( void );
+
+BaseType_t xSemaphoreTake( SemaphoreHandle_t sem, TickType_t ticks );
+
+BaseType_t xSemaphoreGive( SemaphoreHandle_t sem );
+
+void vSemaphoreDelete( SemaphoreHandle_t sem );
+
+/* --- end of file ---------------------------------------------------------- */
+#ifdef __cplusplus
+}
+#endif
+#endif /* __COMPAT_SEMPHR_H__ */
@@ -0,0 +1,62 @@
+/** -------------------------------------------------------------------------- *
+ * @copyright Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ * @author  Ahmed Sabry (SG Wireless)
+ * 
+ * @brief   FreeRTOS tasks API shim for the Linux host platform, tasks are
+ *          mapped to detached pthreads
+ * --------------------------------------------------------------------------- *
+ */
+#ifndef __COMPAT_TASK_H__
+#define __COMPAT_TASK_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --- includes ------------------------------------------------------------- */
+
+#include "FreeRTOS.h"
+
+/* --- tasks API ------------------------------------------------------------ */
+
+typedef void* TaskHandle_t;
+typedef void TaskFunction_t( void * );
+
+BaseType_t xTaskCreate( TaskFunction_t * p_task_code, const char * name,
+    uint32_t stack_depth, void * param, UBaseType_t priority,
+    TaskHandle_t * p_created_task );
+
+void vTaskDelete( TaskHandle_t task );
+
+void vTaskDelay( TickType_t ticks );
+
+TaskHandle_t xTaskGetCurrentTaskHandle( void );
+
+const char * pcTaskGetName( TaskHandle_t task );
+
+UBaseType_t uxTaskPriorityGet( TaskHandle_t task );
+
+/* --- end of file ---------------------------------------------------------- */
+#ifdef __cplusplus
+}
+#endif
+#endif /* __COMPAT_TASK_H__ */
@@ -0,0 +1,95 @@
+/** -------------------------------------------------------------------------- *
+ * @copyright Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ * @author  Ahmed Sabry (SG Wireless)
+ * 
+ * @brief   the log-lib port of the Linux host platform
+ * --------------------------------------------------------------------------- *
+ */
+
+/* -- includes -------------------------------------------------------------- */
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "log_lib.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+/** -------------------------------------------------------------------------- *
+ * port definition for the log-lib
+ * --------------------------------------------------------------------------- *
+ */
+static pthread_mutex_t s_log_access_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static uint32_t log_get_timestamp(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000U + ts.tv_nsec / 1000000U;
+}
+
+static void log_access_lock(void)
+{
+    pthread_mutex_lock(&s_log_access_mutex);
+}
+static void log_access_unlock(void)
+{
+    pthread_mutex_unlock(&s_log_access_mutex);
+}
+
+static void log_serial_output(uint8_t* str, uint32_t len)
+{
+    ssize_t ret;
+    while(len) {
+        ret = write(STDOUT_FILENO, str, len);
+        if(ret <= 0)
+            return;
+        str += ret;
+        len -= ret;
+    }
+}
+
+static const char* get_current_task_name(void)
+{
+    return pcTaskGetName(NULL);
+}
+static int get_current_core_id(void)
+{
+    return 0;
+}
+
+void init_log_system(void)
+{
+    log_init_params_t init_params = {
+        .get_timestamp = log_get_timestamp,
+        .mutex_lock = log_access_lock,
+        .mutex_unlock = log_access_unlock,
+        .serial_out = log_serial_output,
+        .get_core_id = get_current_core_id,
+        .get_task_name = get_current_task_name
+    };
+
+    log_init( & init_params );
+}
+
+/* --- end of file ---------------------------------------------------------- */
@@ -0,0 +1,682 @@
+/** -------------------------------------------------------------------------- *
+ * @copyright Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ * @author  Ahmed Sabry (SG Wireless)
+ * 
+ * @brief   This file represents the porting of the Pycom LoRa stack to the
+ *          Linux host environment (pthreads, timerfd and file based nvm).
+ * --------------------------------------------------------------------------- *
+ */
+
+/** -------------------------------------------------------------------------- *
+ * includes
+ * --------------------------------------------------------------------------- *
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+
+#include "esp_crc.h"
+#include "lora_port.h"
+
+#define __log_subsystem     lora
+#define __log_component     port_system
+#include "log_lib.h"
+
+/** -------------------------------------------------------------------------- *
+ * Pycom LoRa Stack System Port Definition
+ * --------------------------------------------------------------------------- *
+ */
+// -- init methods for ports that needs initialization
+static int linux_nvm_port_ctor(void);
+static int linux_nvm_port_dtor(void);
+static int linux_timers_port_ctor(void);
+static int linux_timers_port_dtor(void);
+
+// -- non-volatile memory (nvm)
+static bool nvm_check(const char* key);
+static int nvm_load(const char* key, uint8_t* buf, uint32_t size);
+static int nvm_store(const char* key, uint8_t* buf, uint32_t size);
+static int nvm_sync(void);
+static int nvm_clear(const char* key);
+
+// -- system timers
+static void* timer_init(const char* name, void* arg, void(*p_callback)(void*));
+static void timer_del(void* handle);
+static void timer_start(void* handle);
+static void timer_stop(void* handle);
+static void timer_set_period(void* handle, uint32_t msec);
+
+// -- system time
+static uint32_t get_timestamp_msec(void);
+static uint32_t get_timestamp_usec(void);
+static void delay_msec(uint32_t msec);
+
+// -- access mutex
+static void* mutex_new(void);
+static void mutex_lock(void* handle);
+static void mutex_unlock(void* handle);
+
+// -- sync semaphore
+static void* sem_new(void);
+static void sem_wait(void* handle);
+static void sem_signal(void* handle);
+static bool sem_wait_timeout(void* handle, uint32_t msec);
+
+// -- optional utilities ( optional )
+static uint32_t crc32_calc(uint32_t initial_crc, uint8_t * buf, uint32_t len);
+
+// -- fragmented data block store ( optional )
+static int frag_store_open(uint32_t* p_size, uint32_t* p_sector_size);
+static int frag_store_erase(uint32_t offset, uint32_t size);
+static int frag_store_write(uint32_t offset, uint8_t* buf, uint32_t size);
+static int frag_store_read(uint32_t offset, uint8_t* buf, uint32_t size);
+static int frag_store_close(bool is_complete, uint32_t size);
+
+void lora_board_ctor(void)
+{
+    __log_info("ctor() -> lora board (linux host)");
+
+    // -- init ports
+    linux_nvm_port_ctor();
+    linux_timers_port_ctor();
+
+    // -- init lora stack
+    lora_port_params_t init_params = {
+        .nvm_check = nvm_check,
+        .nvm_load = nvm_load,
+        .nvm_store = nvm_store,
+        .nvm_sync = nvm_sync,
+        .nvm_clear = nvm_clear,
+        .timer_init = timer_init,
+        .timer_delete = timer_del,
+        .timer_start = timer_start,
+        .timer_stop = timer_stop,
+        .timer_set_period = timer_set_period,
+        .get_timestamp_msec = get_timestamp_msec,
+        .delay_msec = delay_msec,
+        .mutex_new = mutex_new,
+        .mutex_lock = mutex_lock,
+        .mutex_unlock = mutex_unlock,
+        .sem_new = sem_new,
+        .sem_wait = sem_wait,
+        .sem_signal = sem_signal,
+        .sem_wait_timeout = sem_wait_timeout,
+        .crc32_calc = crc32_calc,
+        .get_timestamp_usec = get_timestamp_usec,
+        .frag_store_open = frag_store_open,
+        .frag_store_erase = frag_store_erase,
+        .frag_store_write = frag_store_write,
+        .frag_store_read = frag_store_read,
+        .frag_store_close = frag_store_close
+    };
+    lora_port_init( &init_params );
+
+    // -- simulated hardware initialization
+    void lora_sim_sx126x_ctor(void);
+    lora_sim_sx126x_ctor();
+}
+
+void lora_board_dtor(void)
+{
+    __log_info("dtor() -> lora board (linux host)");
+
+    void lora_sim_sx126x_dtor(void);
+    lora_sim_sx126x_dtor();
+
+    linux_timers_port_dtor();
+    linux_nvm_port_dtor();
+}
+
+/** -------------------------------------------------------------------------- *
+ * nvm ports implementation
+ * ------------------------
+ * every record is a file '<nvm-dir>/<key>' where the nvm-dir is taken from
+ * the environment variable LORA_SIM_NVM_DIR (default: ./lora-nvm). Records
+ * are written to a temporary file then renamed so that a killed process
+ * never leaves a partially written record.
+ * --------------------------------------------------------------------------- *
+ */
+static char s_nvm_dir[256];
+
+static void nvm_record_path(char* path, size_t size, const char* key)
+{
+    snprintf(path, size, "%s/%s", s_nvm_dir, key);
+}
+
+static int linux_nvm_port_ctor(void)
+{
+    const char* dir = getenv("LORA_SIM_NVM_DIR");
+    snprintf(s_nvm_dir, sizeof(s_nvm_dir), "%s", dir ? dir : "./lora-nvm");
+
+    __log_debug("nvm directory '%s'", s_nvm_dir);
+    if(mkdir(s_nvm_dir, 0755) != 0 && errno != EEXIST) {
+        __log_error("-- failed -- errno(%d)", errno);
+        return -1;
+    }
+    return 0;
+}
+
+static int linux_nvm_port_dtor(void)
+{
+    __log_debug("");
+    return 0;
+}
+
+static bool nvm_check(const char* key)
+{
+    char path[300];
+    __log_debug("check record '%s'", key);
+    nvm_record_path(path, sizeof(path), key);
+    return access(path, F_OK) == 0;
+}
+
+static int nvm_load(const char* key, uint8_t* buf, uint32_t size)
+{
+    char path[300];
+    ssize_t ret_size;
+    int fd;
+
+    __log_debug("load record '%s'", key);
+    nvm_record_path(path, sizeof(path), key);
+
+    fd = open(path, O_RDONLY);
+    if(fd < 0) {
+        __log_error("-- failed -- errno(%d)", errno);
+        return -1;
+    }
+    ret_size = read(fd, buf, size);
+    close(fd);
+
+    if(ret_size != size) {
+        __log_error("-- failed -- size: %d, ret_size: %d", size, ret_size);
+        return -1;
+    }
+    return 0;
+}
+
+static int nvm_store(const char* key, uint8_t* buf, uint32_t size)
+{
+    char path[300];
+    char tmp_path[310];
+    ssize_t ret_size;
+    int fd;
+
+    __log_debug("store record '%s'", key);
+    nvm_record_path(path, sizeof(path), key);
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+
+    fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if(fd < 0) {
+        __log_error("-- failed -- errno(%d)", errno);
+        return -1;
+    }
+    ret_size = write(fd, buf, size);
+    close(fd);
+
+    if(ret_size != size || rename(tmp_path, path) != 0) {
+        __log_error("-- failed --");
+        unlink(tmp_path);
+        return -1;
+    }
+    return 0;
+}
+
+static int nvm_clear(const char* key)
+{
+    char path[300];
+    __log_debug("clear record '%s'", key);
+    nvm_record_path(path, sizeof(path), key);
+    if(unlink(path) != 0 && errno != ENOENT) {
+        __log_error("-- failed -- errno(%d)", errno);
+        return -1;
+    }
+    return 0;
+}
+
+static int nvm_sync(void)
+{
+    __log_debug("sync lora nvm storage");
+    sync();
+    return 0;
+}
+
+/** -------------------------------------------------------------------------- *
+ * fragmented data block store ports implementation
+ * ------------------------------------------------
+ * the partition is the file '<nvm-dir>/frag-store' of LORA_SIM_FRAG_STORE_SIZE
+ * bytes (default 512 KB) with a flash behaviour: an erase sets the sector
+ * bytes to 0xFF and a write can only clear bits. A complete data block is
+ * copied to '<nvm-dir>/frag-image' as the image handed to the ota.
+ * --------------------------------------------------------------------------- *
+ */
+#define __frag_store_sector_size    (4096)
+
+static int s_frag_fd = -1;
+
+static int frag_store_open(uint32_t* p_size, uint32_t* p_sector_size)
+{
+    char path[300];
+    const char* size_env = getenv("LORA_SIM_FRAG_STORE_SIZE");
+    uint32_t size = size_env ? strtoul(size_env, NULL, 0) : 512 * 1024;
+
+    nvm_record_path(path, sizeof(path), "frag-store");
+    if(s_frag_fd < 0)
+        s_frag_fd = open(path, O_RDWR | O_CREAT, 0644);
+    if(s_frag_fd < 0 || ftruncate(s_frag_fd, size) != 0) {
+        __log_error("-- failed -- errno(%d)", errno);
+        return -1;
+    }
+    *p_size = size;
+    *p_sector_size = __frag_store_sector_size;
+    return 0;
+}
+
+static int frag_store_erase(uint32_t offset, uint32_t size)
+{
+    uint8_t sector[__frag_store_sector_size];
+    uint32_t len;
+
+    memset(sector, 0xFF, sizeof(sector));
+    for( ; size; offset += len, size -= len) {
+        len = size < sizeof(sector) ? size : sizeof(sector);
+        if(pwrite(s_frag_fd, sector, len, offset) != (ssize_t)len) {
+            __log_error("-- failed -- errno(%d)", errno);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int frag_store_write(uint32_t offset, uint8_t* buf, uint32_t size)
+{
+    uint8_t current[256];
+    uint32_t len;
+    uint32_t i;
+
+    for( ; size; offset += len, buf += len, size -= len) {
+        len = size < sizeof(current) ? size : sizeof(current);
+        if(pread(s_frag_fd, current, len, offset) != (ssize_t)len)
+            return -1;
+        for(i = 0; i < len; ++i)
+            current[i] &= buf[i];
+        if(pwrite(s_frag_fd, current, len, offset) != (ssize_t)len) {
+            __log_error("-- failed -- errno(%d)", errno);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int frag_store_read(uint32_t offset, uint8_t* buf, uint32_t size)
+{
+    if(pread(s_frag_fd, buf, size, offset) != (ssize_t)size) {
+        __log_error("-- failed -- errno(%d)", errno);
+        return -1;
+    }
+    return 0;
+}
+
+static int frag_store_close(bool is_complete, uint32_t size)
+{
+    char path[300];
+    uint8_t chunk[256];
+    uint32_t offset;
+    uint32_t len;
+    int fd;
+    int ret = 0;
+
+    if(is_complete) {
+        nvm_record_path(path, sizeof(path), "frag-image");
+        fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        for(offset = 0; fd >= 0 && offset < size; offset += len) {
+            len = size - offset < sizeof(chunk) ? size - offset : sizeof(chunk);
+            if(pread(s_frag_fd, chunk, len, offset) != (ssize_t)len ||
+               write(fd, chunk, len) != (ssize_t)len) {
+                ret = -1;
+                break;
+            }
+        }
+        if(fd < 0)
+            ret = -1;
+        else
+            close(fd);
+        __log_info("data block image of %d bytes in '%s'", size, path);
+    }
+
+    close(s_frag_fd);
+    s_frag_fd = -1;
+    return ret;
+}
+
+/** -------------------------------------------------------------------------- *
+ * timers ports implementation
+ * ---------------------------
+ * every timer is a one-shot timerfd, all of them are served by a single
+ * epoll thread, the same as the FreeRTOS timer service task serves the
+ * callbacks on the F1 platform.
+ *
+ * a timer reported ready by epoll may be stopped or re-armed by a callback
+ * of the same batch, which resets its expirations count, so the timerfds are
+ * non-blocking and such a stale event is skipped. A deleted timer may still
+ * be in the events batch of the timers thread, so it is only marked as
+ * deleted and it is freed by the timers thread after the batch.
+ * --------------------------------------------------------------------------- *
+ */
+typedef struct linux_timer_s {
+    int             fd;
+    const char*     name;
+    void*           arg;
+    void          (*p_callback)(void*);
+    uint32_t        period_ms;
+    bool            is_deleted;
+    struct linux_timer_s* p_next_deleted;
+} linux_timer_t;
+
+static int          s_epoll_fd = -1;
+static pthread_t    s_timers_thread;
+static pthread_mutex_t s_timers_mutex = PTHREAD_MUTEX_INITIALIZER;
+static linux_timer_t* s_deleted_timers;
+
+static void timers_free_deleted(void)
+{
+    linux_timer_t* p_timer;
+
+    pthread_mutex_lock(&s_timers_mutex);
+    p_timer = s_deleted_timers;
+    s_deleted_timers = NULL;
+    pthread_mutex_unlock(&s_timers_mutex);
+
+    while(p_timer) {
+        linux_timer_t* p_next = p_timer->p_next_deleted;
+        free(p_timer);
+        p_timer = p_next;
+    }
+}
+
+static void* timers_task(void* arg)
+{
+    struct epoll_event events[8];
+    uint64_t expirations;
+    ssize_t len;
+    int n, i;
+
+    while(1)
+    {
+        n = epoll_wait(s_epoll_fd, events, 8, -1);
+        if(n < 0) {
+            if(errno == EINTR)
+                continue;
+            break;
+        }
+
+        /* the batch is not cancelled while a timer lock or handle is held */
+        pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
+        for(i = 0; i < n; ++i) {
+            linux_timer_t* p_timer = events[i].data.ptr;
+
+            pthread_mutex_lock(&s_timers_mutex);
+            len = p_timer->is_deleted ? -1 :
+                read(p_timer->fd, &expirations, sizeof(expirations));
+            pthread_mutex_unlock(&s_timers_mutex);
+
+            /* deleted, or stopped or re-armed since epoll reported it */
+            if(len != sizeof(expirations))
+                continue;
+
+            /* same as FreeRTOS, the callback gets the timer handle */
+            p_timer->p_callback(p_timer);
+        }
+        timers_free_deleted();
+        pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, NULL);
+    }
+    return NULL;
+}
+
+static int linux_timers_port_ctor(void)
+{
+    s_epoll_fd = epoll_create1(0);
+    __log_assert(s_epoll_fd >= 0, "timers epoll create failed");
+    if(pthread_create(&s_timers_thread, NULL, timers_task, NULL) != 0) {
+        __log_error("-- failed to create timers thread --");
+        return -1;
+    }
+    return 0;
+}
+
+static int linux_timers_port_dtor(void)
+{
+    pthread_cancel(s_timers_thread);
+    pthread_join(s_timers_thread, NULL);
+    timers_free_deleted();
+    close(s_epoll_fd);
+    s_epoll_fd = -1;
+    return 0;
+}
+
+static void timer_arm(linux_timer_t* p_timer, uint32_t msec)
+{
+    struct itimerspec its = {0};
+    if(msec == 0)
+        its.it_value.tv_nsec = 1;   /* zero disarms the timerfd */
+    else {
+        its.it_value.tv_sec = msec / 1000U;
+        its.it_value.tv_nsec = (msec % 1000U) * 1000000L;
+    }
+    timerfd_settime(p_timer->fd, 0, &its, NULL);
+}
+
+static void* timer_init(const char* name, void* arg, void(*p_callback)(void*))
+{
+    linux_timer_t* p_timer = calloc(1, sizeof(linux_timer_t));
+    __log_assert(p_timer != NULL, "timer create failed");
+
+    p_timer->fd = timerfd_create(CLOCK_MONOTONIC,
+        TFD_CLOEXEC | TFD_NONBLOCK);
+    __log_assert(p_timer->fd >= 0, "timerfd create failed");
+    p_timer->name = name;
+    p_timer->arg = arg;
+    p_timer->p_callback = p_callback;
+
+    struct epoll_event ev = { .events = EPOLLIN, .data.ptr = p_timer };
+    epoll_ctl(s_epoll_fd, EPOLL_CTL_ADD, p_timer->fd, &ev);
+
+    __log_debug("ctor() -> new timer '%s' , handle:%p", name, p_timer);
+    return (void*)p_timer;
+}
+static void timer_del(void* handle)
+{
+    linux_timer_t* p_timer = handle;
+    __log_debug("~dtor() -> delete timer of handle:%p", handle);
+    pthread_mutex_lock(&s_timers_mutex);
+    epoll_ctl(s_epoll_fd, EPOLL_CTL_DEL, p_timer->fd, NULL);
+    close(p_timer->fd);
+    p_timer->fd = -1;
+    p_timer->is_deleted = true;
+    p_timer->p_next_deleted = s_deleted_timers;
+    s_deleted_timers = p_timer;
+    pthread_mutex_unlock(&s_timers_mutex);
+}
+static void timer_start(void* handle)
+{
+    linux_timer_t* p_timer = handle;
+    __log_debug("start timer of handle:%p", handle);
+    timer_arm(p_timer, p_timer->period_ms);
+}
+static void timer_stop(void* handle)
+{
+    linux_timer_t* p_timer = handle;
+    struct itimerspec its = {0};
+    __log_debug("stop timer of handle:%p", handle);
+    timerfd_settime(p_timer->fd, 0, &its, NULL);
+}
+static void timer_set_period(void* handle, uint32_t msec)
+{
+    linux_timer_t* p_timer = handle;
+    __log_debug("set period (%d msec) for timer of handle:%p", msec, handle);
+    /* as xTimerChangePeriod(), changing the period (re)starts the timer */
+    p_timer->period_ms = msec;
+    timer_arm(p_timer, msec);
+}
+
+/** -------------------------------------------------------------------------- *
+ * system time ports implementation
+ * --------------------------------------------------------------------------- *
+ */
+static uint32_t get_timestamp_msec(void)
+{
+    /* it is the same clock used by the simulated radio for the irq
+     * timestamps */
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000U + ts.tv_nsec / 1000000U;
+}
+static uint32_t get_timestamp_usec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000U + ts.tv_nsec / 1000U;
+}
+static void delay_msec(uint32_t msec)
+{
+    struct timespec ts = {
+        .tv_sec  = msec / 1000U,
+        .tv_nsec = (msec % 1000U) * 1000000L };
+    while(nanosleep(&ts, &ts) != 0 && errno == EINTR);
+}
+
+/** -------------------------------------------------------------------------- *
+ * mutex ports implementation
+ * --------------------------------------------------------------------------- *
+ */
+static void* mutex_new(void)
+{
+    pthread_mutex_t* mutex = malloc(sizeof(pthread_mutex_t));
+    __log_assert(mutex != NULL, "mutex create failed");
+    pthread_mutex_init(mutex, NULL);
+
+    __log_debug("ctor() -> new mutex with handle:%p", mutex);
+
+    return (void*)mutex;
+}
+static void mutex_lock(void* handle)
+{
+    __log_debug("lock mutex with handle:%p", handle);
+    int ret = pthread_mutex_lock(handle);
+    __log_assert(ret == 0, "-- failed --");
+}
+static void mutex_unlock(void* handle)
+{
+    __log_debug("unlock mutex with handle:%p", handle);
+    int ret = pthread_mutex_unlock(handle);
+    __log_assert(ret == 0, "-- failed --");
+}
+
+/** -------------------------------------------------------------------------- *
+ * binary semaphore ports implementation
+ * --------------------------------------------------------------------------- *
+ */
+typedef struct {
+    pthread_mutex_t mutex;
+    pthread_cond_t  cond;
+    bool            signaled;
+} linux_sem_t;
+
+static void* sem_new(void)
+{
+    linux_sem_t* sem = calloc(1, sizeof(linux_sem_t));
+    __log_assert(sem != NULL, "semaphore create failed");
+    pthread_mutex_init(&sem->mutex, NULL);
+    pthread_cond_init(&sem->cond, NULL);
+
+    __log_debug("ctor() -> new semaphore with handle:%p", sem);
+
+    return (void*)sem;
+}
+
+static void sem_wait(void* handle)
+{
+    linux_sem_t* sem = handle;
+    __log_debug("wait for semaphore with handle:%p", handle);
+    pthread_mutex_lock(&sem->mutex);
+    while( ! sem->signaled )
+        pthread_cond_wait(&sem->cond, &sem->mutex);
+    sem->signaled = false;
+    pthread_mutex_unlock(&sem->mutex);
+}
+static void sem_signal(void* handle)
+{
+    linux_sem_t* sem = handle;
+    __log_debug("signal the semaphore with handle:%p", handle);
+    pthread_mutex_lock(&sem->mutex);
+    sem->signaled = true;
+    pthread_cond_signal(&sem->cond);
+    pthread_mutex_unlock(&sem->mutex);
+}
+static bool sem_wait_timeout(void* handle, uint32_t msec)
+{
+    linux_sem_t* sem = handle;
+    struct timespec ts;
+    bool ret;
+
+    __log_debug("wait for semaphore with handle:%p, %d msec", handle, msec);
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_sec += msec / 1000U;
+    ts.tv_nsec += (msec % 1000U) * 1000000L;
+    if( ts.tv_nsec >= 1000000000L ) {
+        ++ ts.tv_sec;
+        ts.tv_nsec -= 1000000000L;
+    }
+
+    pthread_mutex_lock(&sem->mutex);
+    while( ! sem->signaled &&
+           pthread_cond_timedwait(&sem->cond, &sem->mutex, &ts) == 0 );
+    ret = sem->signaled;
+    sem->signaled = false;
+    pthread_mutex_unlock(&sem->mutex);
+    return ret;
+}
+
+/** -------------------------------------------------------------------------- *
+ * crc32 port implementation
+ * --------------------------------------------------------------------------- *
+ */
+static uint32_t crc32_calc(uint32_t initial_crc, uint8_t * buf, uint32_t len)
+{
+    uint32_t crc = esp_crc32_le(initial_crc, buf, len);
+
+    __log_debug("calc crc32 ,initial_val:%d ,buf: %p ,len: %4d --> crc: %08x",
+        initial_crc, buf, len, crc);
+
+    return crc;
+}
+
+/* --- end of file ---------------------------------------------------------- */
@@ -0,0 +1,375 @@
+/** -------------------------------------------------------------------------- *
+ * @copyright Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ * @author  Ahmed Sabry (SG Wireless)
+ * 
+ * @brief   simulated LoRa air channel implementation over loopback UDP ports
+ * --------------------------------------------------------------------------- *
+ */
+
+/** -------------------------------------------------------------------------- *
+ * includes
+ * --------------------------------------------------------------------------- *
+ */
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "lora_sim_air.h"
+
+#define __log_subsystem     host
+#define __log_component     sim_air
+#include "log_lib.h"
+
+/** -------------------------------------------------------------------------- *
+ * configurations
+ * --------------------------------------------------------------------------- *
+ */
+#define __sim_air_magic             (0x4c53494du)   /* 'LSIM' */
+#define __sim_air_default_port      (17600)
+#define __sim_air_default_slots     (8)
+#define __sim_air_max_slots         (64)
+#define __sim_air_history_size      (64)
+#define __sim_noise_figure_db       (6)
+
+static struct {
+    uint16_t    base_port;
+    uint32_t    slots;
+    float       path_loss;
+    float       fading;
+    float       per;
+    float       capture_db;
+} s_cfg;
+
+static float env_float(const char* name, float def)
+{
+    const char* str = getenv(name);
+    return str ? strtof(str, NULL) : def;
+}
+
+static void load_config(void)
+{
+    s_cfg.base_port = env_float("LORA_SIM_AIR_PORT", __sim_air_default_port);
+    s_cfg.slots = env_float("LORA_SIM_AIR_SLOTS", __sim_air_default_slots);
+    if(s_cfg.slots > __sim_air_max_slots)
+        s_cfg.slots = __sim_air_max_slots;
+    s_cfg.path_loss = env_float("LORA_SIM_PATH_LOSS", 90);
+    s_cfg.fading = env_float("LORA_SIM_FADING", 2);
+    s_cfg.per = env_float("LORA_SIM_PER", 0);
+    s_cfg.capture_db = env_float("LORA_SIM_CAPTURE_DB", 6);
+}
+
+/** -------------------------------------------------------------------------- *
+ * time and modulation helpers
+ * --------------------------------------------------------------------------- *
+ */
+uint64_t lora_sim_time_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + ts.tv_nsec / 1000u;
+}
+
+uint32_t lora_sim_bw_hz(uint8_t bw_code)
+{
+    switch(bw_code)
+    {
+        case 0x00: return 7810;
+        case 0x08: return 10420;
+        case 0x01: return 15630;
+        case 0x09: return 20830;
+        case 0x02: return 31250;
+        case 0x0a: return 41670;
+        case 0x03: return 62500;
+        case 0x04: return 125000;
+        case 0x05: return 250000;
+        case 0x06: return 500000;
+        default:   return 125000;
+    }
+}
+
+uint32_t lora_sim_lora_toa_us(uint8_t sf, uint8_t bw_code, uint8_t cr,
+    uint16_t preamble, bool implicit_header, bool crc_on, uint8_t len)
+{
+    double bw = lora_sim_bw_hz(bw_code);
+    double t_sym = (double)(1u << sf) / bw;
+    bool ldro = t_sym >= 0.01638;
+    double t_preamble;
+    double payload_symbols;
+    double num;
+
+    if(sf <= 6) {
+        /* SF5 and SF6 have 2 extra preamble symbols and no ldro */
+        t_preamble = (preamble + 6.25) * t_sym;
+        num = 8 * len + 16 * crc_on - 4 * sf + 20 * ( ! implicit_header );
+    } else {
+        t_preamble = (preamble + 4.25) * t_sym;
+        num = 8 * len + 16 * crc_on - 4 * sf + 8 + 20 * ( ! implicit_header );
+    }
+
+    payload_symbols = ceil(num / (4.0 * (sf - 2 * ldro)));
+    if(payload_symbols < 0)
+        payload_symbols = 0;
+    payload_symbols = 8 + payload_symbols * (cr + 4);
+
+    return (uint32_t)((t_preamble + payload_symbols * t_sym) * 1e6);
+}
+
+/* demodulation SNR limits per spreading factor (SF5 .. SF12) */
+static int8_t snr_limit(uint8_t sf)
+{
+    static const int8_t limits[] = { -3, -5, -8, -10, -13, -15, -18, -20 };
+    if(sf < 5 || sf > 12)
+        return -20;
+    return limits[sf - 5];
+}
+
+/** -------------------------------------------------------------------------- *
+ * heard frames history
+ * --------------------------------------------------------------------------- *
+ */
+typedef struct {
+    uint32_t    node_id;
+    uint32_t    seq;
+    uint32_t    freq;
+    uint8_t     sf;
+    uint8_t     bw;
+    uint64_t    start_us;
+    uint64_t    end_us;
+    int16_t     rssi;
+} heard_frame_t;
+
+static heard_frame_t    s_history[__sim_air_history_size];
+static uint32_t         s_history_idx;
+static pthread_mutex_t  s_history_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void history_push(const lora_sim_frame_t* p_frame, int16_t rssi)
+{
+    pthread_mutex_lock(&s_history_mutex);
+    heard_frame_t* p = &s_history[s_history_idx++ % __sim_air_history_size];
+    p->node_id  = p_frame->node_id;
+    p->seq      = p_frame->seq;
+    p->freq     = p_frame->freq;
+    p->sf       = p_frame->sf;
+    p->bw       = p_frame->bw;
+    p->start_us = p_frame->start_us;
+    p->end_us   = p_frame->start_us + p_frame->toa_us;
+    p->rssi     = rssi;
+    pthread_mutex_unlock(&s_history_mutex);
+}
+
+bool lora_sim_air_is_collided(const lora_sim_frame_t * p_frame, int16_t rssi)
+{
+    uint64_t start = p_frame->start_us;
+    uint64_t end = p_frame->start_us + p_frame->toa_us;
+    bool collided = false;
+    int i;
+
+    pthread_mutex_lock(&s_history_mutex);
+    for(i = 0; i < __sim_air_history_size && !collided; ++i)
+    {
+        heard_frame_t* p = &s_history[i];
+        if( p->end_us == 0 ||
+            (p->node_id == p_frame->node_id && p->seq == p_frame->seq) ||
+            p->freq != p_frame->freq || p->sf != p_frame->sf ||
+            p->start_us >= end || start >= p->end_us )
+            continue;
+
+        /* the stronger frame survives if it has enough power margin */
+        collided = (rssi - p->rssi) < s_cfg.capture_db;
+    }
+    pthread_mutex_unlock(&s_history_mutex);
+
+    return collided;
+}
+
+bool lora_sim_air_is_busy(uint32_t freq, uint8_t sf, uint8_t bw_code)
+{
+    uint64_t now = lora_sim_time_us();
+    bool busy = false;
+    int i;
+
+    pthread_mutex_lock(&s_history_mutex);
+    for(i = 0; i < __sim_air_history_size && !busy; ++i)
+    {
+        heard_frame_t* p = &s_history[i];
+        busy = p->freq == freq && p->sf == sf && p->bw == bw_code &&
+            p->start_us <= now && now < p->end_us;
+    }
+    pthread_mutex_unlock(&s_history_mutex);
+
+    return busy;
+}
+
+/** -------------------------------------------------------------------------- *
+ * air slots sockets
+ * --------------------------------------------------------------------------- *
+ */
+static int                    s_sock = -1;
+static uint32_t               s_node_id;
+static uint32_t               s_tx_seq;
+static pthread_t              s_rx_thread;
+static lora_sim_air_rx_cb_t * p_rx_cb;
+static unsigned int           s_rand_seed;
+
+static void slot_addr(struct sockaddr_in* p_addr, uint32_t slot)
+{
+    memset(p_addr, 0, sizeof(*p_addr));
+    p_addr->sin_family = AF_INET;
+    p_addr->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    p_addr->sin_port = htons(s_cfg.base_port + slot);
+}
+
+static void* air_rx_task(void* arg)
+{
+    lora_sim_frame_t frame;
+    lora_sim_rx_info_t info;
+    ssize_t len;
+
+    while(1)
+    {
+        len = recv(s_sock, &frame, sizeof(frame), 0);
+        if(len < 0) {
+            if(errno == EINTR)
+                continue;
+            break;
+        }
+        if( len < (ssize_t)offsetof(lora_sim_frame_t, payload) ||
+            frame.magic != __sim_air_magic ||
+            frame.node_id == s_node_id )
+            continue;
+
+        /* link budget: the fading is uniformly distributed around the
+         * configured path loss */
+        float fading = s_cfg.fading *
+            ((float)rand_r(&s_rand_seed) / RAND_MAX * 2.0f - 1.0f);
+        float noise_floor = -174.0f + 10.0f * log10f(lora_sim_bw_hz(frame.bw))
+            + __sim_noise_figure_db;
+        float rssi = frame.tx_power - s_cfg.path_loss + fading;
+
+        info.rssi = lroundf(rssi);
+        info.snr = lroundf(rssi - noise_floor);
+        info.lost = info.snr < snr_limit(frame.sf) ||
+            ((float)rand_r(&s_rand_seed) / RAND_MAX * 100.0f) < s_cfg.per;
+
+        history_push(&frame, info.rssi);
+
+        __log_debug("heard frame node:%d seq:%d freq:%d sf:%d len:%d "
+            "rssi:%d snr:%d%s", frame.node_id, frame.seq, frame.freq,
+            frame.sf, frame.len, info.rssi, info.snr,
+            info.lost ? " (lost)" : "");
+
+        if(p_rx_cb)
+            p_rx_cb(&frame, &info);
+    }
+    return NULL;
+}
+
+int lora_sim_air_open(lora_sim_air_rx_cb_t * p_rx_callback)
+{
+    struct sockaddr_in addr;
+    uint32_t slot;
+
+    load_config();
+
+    s_sock = socket(AF_INET, SOCK_DGRAM, 0);
+    if(s_sock < 0) {
+        __log_error("air socket create failed (errno:%d)", errno);
+        return -1;
+    }
+
+    /* the first free slot is the node id of this process */
+    for(slot = 0; slot < s_cfg.slots; ++slot) {
+        slot_addr(&addr, slot);
+        if(bind(s_sock, (struct sockaddr*)&addr, sizeof(addr)) == 0)
+            break;
+    }
+    if(slot == s_cfg.slots) {
+        __log_error("no free air slot within %d slots from port %d",
+            s_cfg.slots, s_cfg.base_port);
+        close(s_sock);
+        s_sock = -1;
+        return -1;
+    }
+
+    s_node_id = slot;
+    s_rand_seed = (unsigned int)(lora_sim_time_us() ^ (slot << 16));
+    p_rx_cb = p_rx_callback;
+
+    if(pthread_create(&s_rx_thread, NULL, air_rx_task, NULL) != 0) {
+        close(s_sock);
+        s_sock = -1;
+        return -1;
+    }
+
+    __log_info("joined the air channel as node %d (port %d)",
+        s_node_id, s_cfg.base_port + s_node_id);
+    return 0;
+}
+
+void lora_sim_air_close(void)
+{
+    if(s_sock < 0)
+        return;
+    pthread_cancel(s_rx_thread);
+    pthread_join(s_rx_thread, NULL);
+    close(s_sock);
+    s_sock = -1;
+    p_rx_cb = NULL;
+}
+
+uint32_t lora_sim_air_node_id(void)
+{
+    return s_node_id;
+}
+
+int lora_sim_air_send(lora_sim_frame_t * p_frame)
+{
+    struct sockaddr_in addr;
+    size_t size = offsetof(lora_sim_frame_t, payload) + p_frame->len;
+    uint32_t slot;
+
+    if(s_sock < 0)
+        return -1;
+
+    p_frame->magic = __sim_air_magic;
+    p_frame->node_id = s_node_id;
+    p_frame->seq = s_tx_seq ++;
+
+    for(slot = 0; slot < s_cfg.slots; ++slot) {
+        if(slot == s_node_id)
+            continue;
+        slot_addr(&addr, slot);
+        /* unbound slots silently drop the datagram */
+        sendto(s_sock, p_frame, size, 0, (struct sockaddr*)&addr, sizeof(addr));
+    }
+    return 0;
+}
+
+/* --- end of file ---------------------------------------------------------- */
@@ -0,0 +1,164 @@
+/** -------------------------------------------------------------------------- *
+ * @copyright Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ * @author  Ahmed Sabry (SG Wireless)
+ * 
+ * @brief   simulated LoRa air channel of the Linux host platform. It carries
+ *          the frames transmitted by the simulated radios of several host
+ *          processes and models the time-on-air, the link budget and the
+ *          collisions between the overlapping frames.
+ * --------------------------------------------------------------------------- *
+ */
+#ifndef __LORA_SIM_AIR_H__
+#define __LORA_SIM_AIR_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** -------------------------------------------------------------------------- *
+ * The air channel is a set of UDP ports on the loopback interface, one slot
+ * per process (node). A transmitting node sends the frame descriptor to all
+ * the other slots at the transmission start, every receiving node keeps the
+ * recently heard frames to decide later if a frame collided with another one.
+ *
+ * @code
+ *      +--------+   frame{freq,sf,bw,start,toa,payload}   +--------+
+ *      | node-0 | --------------------------------------> | node-1 |
+ *      |  slot  |                 127.0.0.1               |  slot  |
+ *      +--------+ <-------------------------------------- +--------+
+ * @endcode
+ *
+ * environment configurations:
+ *      LORA_SIM_AIR_PORT       first UDP port of the air slots     (17600)
+ *      LORA_SIM_AIR_SLOTS      number of the air slots (max nodes)     (8)
+ *      LORA_SIM_PATH_LOSS      path loss in dB between any two nodes  (90)
+ *      LORA_SIM_FADING         uniform fading spread in dB             (2)
+ *      LORA_SIM_PER            random packet error rate in percent     (0)
+ *      LORA_SIM_CAPTURE_DB     co-channel capture threshold in dB      (6)
+ * --------------------------------------------------------------------------- *
+ */
+
+/* --- includes ------------------------------------------------------------- */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* --- typedefs ------------------------------------------------------------- */
+
+#define __lora_sim_modem_lora   (1)
+#define __lora_sim_modem_fsk    (0)
+
+/**
+ * the frame descriptor exchanged over the air, the processes are on the same
+ * host so the fields are in the host byte order
+ */
+typedef struct __attribute__((packed)) {
+    uint32_t    magic;
+    uint32_t    node_id;    /**< the transmitting node */
+    uint32_t    seq;        /**< frame sequence number of the tx node */
+    uint64_t    start_us;   /**< tx start on the host monotonic clock */
+    uint32_t    toa_us;     /**< time on air */
+    uint32_t    freq;       /**< carrier frequency in Hz */
+    uint8_t     modem;      /**< __lora_sim_modem_xxx */
+    uint8_t     sf;         /**< spreading factor */
+    uint8_t     bw;         /**< sx126x bandwidth code */
+    uint8_t     cr;         /**< coding rate 1..4 (4/5 .. 4/8) */
+    uint16_t    preamble;   /**< preamble length in symbols */
+    uint16_t    sync_word;  /**< lora sync word registers value */
+    uint8_t     iq_inverted;
+    uint8_t     crc_on;
+    int8_t      tx_power;   /**< tx power in dBm */
+    uint8_t     len;
+    uint8_t     payload[255];
+} lora_sim_frame_t;
+
+/**
+ * the reception conditions of a heard frame at the receiving node
+ */
+typedef struct {
+    int16_t     rssi;       /**< received signal strength in dBm */
+    int8_t      snr;        /**< signal to noise ratio in dB */
+    bool        lost;       /**< below the sensitivity or dropped by the PER */
+} lora_sim_rx_info_t;
+
+typedef void lora_sim_air_rx_cb_t(const lora_sim_frame_t * p_frame,
+    const lora_sim_rx_info_t * p_info);
+
+/* --- APIs ----------------------------------------------------------------- */
+
+/**
+ * @brief   host monotonic time in micro-seconds, it is the time reference of
+ *          all the simulated nodes
+ */
+uint64_t lora_sim_time_us(void);
+
+/**
+ * @brief   converts the sx126x lora bandwidth code into Hz
+ */
+uint32_t lora_sim_bw_hz(uint8_t bw_code);
+
+/**
+ * @brief   computes the lora frame time on air as per the sx126x datasheet
+ */
+uint32_t lora_sim_lora_toa_us(uint8_t sf, uint8_t bw_code, uint8_t cr,
+    uint16_t preamble, bool implicit_header, bool crc_on, uint8_t len);
+
+/**
+ * @brief   joins the air channel, the callback is called from the air
+ *          receiving thread at the start of every frame sent by other nodes
+ * @return  0 on success, -1 if no free slot or socket failure
+ */
+int  lora_sim_air_open(lora_sim_air_rx_cb_t * p_rx_callback);
+
+void lora_sim_air_close(void);
+
+/**
+ * @brief   the air slot (node id) of this process
+ */
+uint32_t lora_sim_air_node_id(void);
+
+/**
+ * @brief   transmits a frame to all the other nodes, the magic, node_id and
+ *          seq fields are filled by the air channel
+ */
+int  lora_sim_air_send(lora_sim_frame_t * p_frame);
+
+/**
+ * @brief   checks if the heard frame was overlapped on the air by another
+ *          frame on the same channel and spreading factor without having
+ *          enough power margin to capture the receiver. It shall be called
+ *          at the frame end.
+ */
+bool lora_sim_air_is_collided(const lora_sim_frame_t * p_frame,
+    int16_t rssi);
+
+/**
+ * @brief   checks if there is a frame currently on the air on the given
+ *          channel and spreading factor (used by the simulated CAD)
+ */
+bool lora_sim_air_is_busy(uint32_t freq, uint8_t sf, uint8_t bw_code);
+
+/* --- end of file ---------------------------------------------------------- */
+#ifdef __cplusplus
+}
+#endif
+#endif /* __LORA_SIM_AIR_H__ */
@@ -0,0 +1,709 @@
+/** -------------------------------------------------------------------------- *
+ * @copyright Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ * @author  Ahmed Sabry (SG Wireless)
+ * 
+ * @brief   command level model of the sx126x lora transceiver for the Linux
+ *          host platform. It is connected to the lora stack through the
+ *          sx126x port (spi transactions, busy, reset and dio1 pin) and it
+ *          exchanges the frames with other simulated nodes through the air
+ *          channel of lora_sim_air.c
+ * --------------------------------------------------------------------------- *
+ */
+
+/** -------------------------------------------------------------------------- *
+ * The model executes every spi command synchronously, so the busy signal is
+ * never asserted. The asynchronous radio events (tx-done, rx-done, timeouts,
+ * cad-done) are scheduled as deadlines on the host monotonic clock and are
+ * served by a single timing thread which is also the only context raising
+ * the dio1 interrupt towards the stack through sx126x_port_irq(), the same
+ * as the F1 io-expander interrupt task does.
+ *
+ *      stack ---- spi trx ----> [ sx126x model ] ---- frames ----> air
+ *      stack <--- dio1 irq ---- [ timing thread] <--- frames ----- air
+ * --------------------------------------------------------------------------- *
+ */
+
+/* --- includes ------------------------------------------------------------- */
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+
+#include "sx126x_port.h"
+#include "sx126x_defs.h"
+#include "lora_sim_air.h"
+#include "sx126x_spi_mock.h"
+
+#define __log_subsystem     lora
+#define __log_component     port_sx126x
+#include "log_lib.h"
+
+/* --- model state ---------------------------------------------------------- */
+
+typedef enum {
+    __sim_mode_sleep,
+    __sim_mode_stdby,
+    __sim_mode_fs,
+    __sim_mode_tx,
+    __sim_mode_rx,
+    __sim_mode_cad,
+} sim_mode_t;
+
+/* chip modes as reported in the status byte */
+static const uint8_t s_status_chip_mode[] = {
+    [__sim_mode_sleep] = 0x2,
+    [__sim_mode_stdby] = 0x2,
+    [__sim_mode_fs]    = 0x4,
+    [__sim_mode_tx]    = 0x6,
+    [__sim_mode_rx]    = 0x5,
+    [__sim_mode_cad]   = 0x5,
+};
+
+#define __rx_timeout_continuous     (0xffffffu)
+#define __sim_noise_floor_dbm       (-120)
+
+static struct {
+    sim_mode_t  mode;
+    uint8_t     packet_type;
+    uint32_t    freq;
+    int8_t      tx_power;
+
+    // -- lora modulation and packet params
+    uint8_t     sf;
+    uint8_t     bw;
+    uint8_t     cr;
+    uint16_t    preamble;
+    bool        implicit_header;
+    uint8_t     payload_len;
+    bool        crc_on;
+    bool        iq_inverted;
+    uint8_t     symb_timeout;
+
+    // -- fsk params (time on air only)
+    uint32_t    fsk_bitrate;
+
+    // -- cad params
+    uint8_t     cad_symbols;
+    uint8_t     cad_exit_mode;
+    uint32_t    cad_timeout;
+
+    // -- memories
+    uint8_t     buffer[256];
+    uint8_t     tx_base;
+    uint8_t     rx_base;
+    uint8_t     rx_len;
+    uint8_t     regs[0x1000];
+
+    // -- irq
+    uint16_t    irq;
+    uint16_t    irq_mask;
+    uint16_t    dio1_mask;
+    bool        dio1_level;
+    bool        irq_edge_pending;
+    uint64_t    irq_timestamp_us;
+
+    // -- rx state
+    bool        rx_continuous;
+    bool        rx_frame_active;
+    lora_sim_frame_t    rx_frame;
+    lora_sim_rx_info_t  rx_info;
+    int16_t     pkt_rssi;
+    int8_t      pkt_snr;
+
+    // -- stats as of GetStats command
+    uint16_t    nb_pkt_received;
+    uint16_t    nb_pkt_crc_error;
+    uint16_t    nb_pkt_header_err;
+
+    // -- pending deadlines (0 => not scheduled)
+    uint64_t    tx_done_at;
+    bool        tx_is_timeout;
+    uint64_t    rx_done_at;
+    uint64_t    rx_timeout_at;
+    uint64_t    cad_done_at;
+} s_chip;
+
+static pthread_mutex_t  s_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t   s_cond;
+static pthread_t        s_timing_thread;
+static bool             s_running;
+
+/* --- model helpers -------------------------------------------------------- */
+
+static uint32_t symbol_time_us(void)
+{
+    return (uint32_t)(((uint64_t)1000000u << s_chip.sf) /
+        lora_sim_bw_hz(s_chip.bw));
+}
+
+static void chip_reset(void)
+{
+    memset(&s_chip, 0, sizeof(s_chip));
+    s_chip.mode = __sim_mode_stdby;
+    s_chip.packet_type = 1;
+    s_chip.sf = 7;
+    s_chip.bw = 0x04;
+    s_chip.cr = 1;
+    s_chip.preamble = 8;
+    s_chip.crc_on = true;
+    s_chip.regs[__sx126x_reg_lora_sync_word_msb] = 0x14;
+    s_chip.regs[__sx126x_reg_lora_sync_word_lsb] = 0x24;
+}
+
+static void raise_irq_locked(uint16_t irq, uint64_t timestamp_us)
+{
+    bool level;
+
+    s_chip.irq |= irq & s_chip.irq_mask;
+    level = (s_chip.irq & s_chip.dio1_mask) != 0;
+    if(level && ! s_chip.dio1_level) {
+        s_chip.irq_edge_pending = true;
+        s_chip.irq_timestamp_us = timestamp_us;
+        pthread_cond_signal(&s_cond);
+    }
+    s_chip.dio1_level = level;
+}
+
+static void cancel_events_locked(void)
+{
+    s_chip.tx_done_at = 0;
+    s_chip.rx_done_at = 0;
+    s_chip.rx_timeout_at = 0;
+    s_chip.cad_done_at = 0;
+    s_chip.rx_frame_active = false;
+}
+
+static void start_rx_locked(uint32_t timeout, uint64_t now)
+{
+    s_chip.mode = __sim_mode_rx;
+    s_chip.rx_frame_active = false;
+    s_chip.rx_continuous = timeout == __rx_timeout_continuous;
+    s_chip.rx_timeout_at = 0;
+
+    if( ! s_chip.rx_continuous ) {
+        if(timeout)
+            s_chip.rx_timeout_at = now + (uint64_t)timeout * 15625u / 1000u;
+        if(s_chip.symb_timeout && s_chip.packet_type == 1) {
+            uint64_t symb_at = now +
+                (uint64_t)s_chip.symb_timeout * symbol_time_us();
+            if(s_chip.rx_timeout_at == 0 || symb_at < s_chip.rx_timeout_at)
+                s_chip.rx_timeout_at = symb_at;
+        }
+    }
+    pthread_cond_signal(&s_cond);
+}
+
+static void start_tx_locked(uint32_t timeout, uint64_t now)
+{
+    lora_sim_frame_t frame;
+    uint32_t toa;
+    int i;
+
+    memset(&frame, 0, offsetof(lora_sim_frame_t, payload));
+    frame.modem = s_chip.packet_type == 1 ?
+        __lora_sim_modem_lora : __lora_sim_modem_fsk;
+    frame.freq = s_chip.freq;
+    frame.sf = s_chip.sf;
+    frame.bw = s_chip.bw;
+    frame.cr = s_chip.cr;
+    frame.preamble = s_chip.preamble;
+    frame.sync_word = (s_chip.regs[__sx126x_reg_lora_sync_word_msb] << 8) |
+        s_chip.regs[__sx126x_reg_lora_sync_word_lsb];
+    frame.iq_inverted = s_chip.iq_inverted;
+    frame.crc_on = s_chip.crc_on;
+    frame.tx_power = s_chip.tx_power;
+    frame.len = s_chip.payload_len;
+    for(i = 0; i < frame.len; ++i)
+        frame.payload[i] = s_chip.buffer[(uint8_t)(s_chip.tx_base + i)];
+
+    if(frame.modem == __lora_sim_modem_lora) {
+        toa = lora_sim_lora_toa_us(s_chip.sf, s_chip.bw, s_chip.cr,
+            s_chip.preamble, s_chip.implicit_header, s_chip.crc_on, frame.len);
+    } else {
+        /* preamble + 3 sync bytes + length + payload + 2 crc bytes */
+        uint32_t bits = s_chip.preamble + 8 * (3 + 1 + frame.len + 2);
+        toa = (uint64_t)bits * 1000000u /
+            (s_chip.fsk_bitrate ? s_chip.fsk_bitrate : 50000);
+    }
+    frame.start_us = now;
+    frame.toa_us = toa;
+
+    s_chip.mode = __sim_mode_tx;
+    s_chip.tx_is_timeout = false;
+    s_chip.tx_done_at = now + toa;
+    if(timeout) {
+        uint64_t timeout_us = (uint64_t)timeout * 15625u / 1000u;
+        if(timeout_us < toa) {
+            s_chip.tx_done_at = now + timeout_us;
+            s_chip.tx_is_timeout = true;
+        }
+    }
+
+    __log_debug("tx start freq:%d sf:%d bw:%d len:%d toa:%d us",
+        frame.freq, frame.sf, frame.bw, frame.len, toa);
+
+    lora_sim_air_send(&frame);
+    pthread_cond_signal(&s_cond);
+}
+
+static void start_cad_locked(uint64_t now)
+{
+    static const uint8_t symbols[] = {1, 2, 4, 8, 16};
+    uint8_t n = symbols[s_chip.cad_symbols < 5 ? s_chip.cad_symbols : 0];
+    s_chip.mode = __sim_mode_cad;
+    s_chip.cad_done_at = now + (uint64_t)n * symbol_time_us();
+    pthread_cond_signal(&s_cond);
+}
+
+/* --- air channel reception ------------------------------------------------ */
+
+static void air_rx_callback(const lora_sim_frame_t * p_frame,
+    const lora_sim_rx_info_t * p_info)
+{
+    uint64_t now = lora_sim_time_us();
+    uint16_t sync_word;
+    uint64_t preamble_end;
+
+    pthread_mutex_lock(&s_mutex);
+
+    sync_word = (s_chip.regs[__sx126x_reg_lora_sync_word_msb] << 8) |
+        s_chip.regs[__sx126x_reg_lora_sync_word_lsb];
+    preamble_end = p_frame->start_us +
+        (uint64_t)p_frame->preamble * symbol_time_us();
+
+    /* the radio locks on the frame only if it is listening on the same
+     * channel and modulation before the end of the frame preamble */
+    if( s_chip.mode == __sim_mode_rx && ! s_chip.rx_frame_active &&
+        ! p_info->lost &&
+        p_frame->freq == s_chip.freq &&
+        ( p_frame->modem == __lora_sim_modem_fsk ?
+            s_chip.packet_type == 0 :
+            ( s_chip.packet_type == 1 &&
+              p_frame->sf == s_chip.sf && p_frame->bw == s_chip.bw &&
+              p_frame->iq_inverted == s_chip.iq_inverted &&
+              p_frame->sync_word == sync_word ) ) &&
+        now <= preamble_end )
+    {
+        s_chip.rx_frame = *p_frame;
+        s_chip.rx_info = *p_info;
+        s_chip.rx_frame_active = true;
+        s_chip.rx_timeout_at = 0;
+        s_chip.rx_done_at = p_frame->start_us + p_frame->toa_us;
+        raise_irq_locked(__sx126x_irq_preamble_detected |
+            __sx126x_irq_header_valid, now);
+        pthread_cond_signal(&s_cond);
+    }
+
+    pthread_mutex_unlock(&s_mutex);
+}
+
+/* --- asynchronous events timing thread ------------------------------------ */
+
+static uint64_t next_deadline_locked(void)
+{
+    uint64_t deadlines[] = { s_chip.tx_done_at, s_chip.rx_done_at,
+        s_chip.rx_timeout_at, s_chip.cad_done_at };
+    uint64_t next = 0;
+    int i;
+    for(i = 0; i < sizeof(deadlines) / sizeof(deadlines[0]); ++i)
+        if(deadlines[i] && (next == 0 || deadlines[i] < next))
+            next = deadlines[i];
+    return next;
+}
+
+static void serve_events_locked(uint64_t now)
+{
+    if(s_chip.tx_done_at && s_chip.tx_done_at <= now)
+    {
+        uint64_t at = s_chip.tx_done_at;
+        s_chip.tx_done_at = 0;
+        s_chip.mode = __sim_mode_stdby;
+        raise_irq_locked( s_chip.tx_is_timeout ?
+            __sx126x_irq_timeout : __sx126x_irq_tx_done, at );
+    }
+
+    if(s_chip.rx_done_at && s_chip.rx_done_at <= now)
+    {
+        uint64_t at = s_chip.rx_done_at;
+        lora_sim_frame_t* p_frame = &s_chip.rx_frame;
+        bool collided = lora_sim_air_is_collided(p_frame, s_chip.rx_info.rssi);
+        uint16_t irq = __sx126x_irq_rx_done;
+        int i;
+
+        for(i = 0; i < p_frame->len; ++i)
+            s_chip.buffer[(uint8_t)(s_chip.rx_base + i)] = p_frame->payload[i];
+        if(collided) {
+            /* a collided frame is corrupted, it is only detected by the
+             * payload crc if it is enabled */
+            s_chip.buffer[s_chip.rx_base] ^= 0x5a;
+            if(p_frame->crc_on) {
+                irq |= __sx126x_irq_crc_err;
+                ++ s_chip.nb_pkt_crc_error;
+            }
+        }
+        ++ s_chip.nb_pkt_received;
+        s_chip.rx_len = p_frame->len;
+        s_chip.pkt_rssi = s_chip.rx_info.rssi;
+        s_chip.pkt_snr = s_chip.rx_info.snr;
+        s_chip.rx_done_at = 0;
+        s_chip.rx_frame_active = false;
+        if( ! s_chip.rx_continuous )
+            s_chip.mode = __sim_mode_stdby;
+
+        __log_debug("rx done len:%d rssi:%d snr:%d%s", p_frame->len,
+            s_chip.pkt_rssi, s_chip.pkt_snr, collided ? " (collided)" : "");
+
+        raise_irq_locked(irq, at);
+    }
+
+    if(s_chip.rx_timeout_at && s_chip.rx_timeout_at <= now)
+    {
+        uint64_t at = s_chip.rx_timeout_at;
+        s_chip.rx_timeout_at = 0;
+        s_chip.mode = __sim_mode_stdby;
+        raise_irq_locked(__sx126x_irq_timeout, at);
+    }
+
+    if(s_chip.cad_done_at && s_chip.cad_done_at <= now)
+    {
+        uint64_t at = s_chip.cad_done_at;
+        bool detected = lora_sim_air_is_busy(s_chip.freq, s_chip.sf,
+            s_chip.bw);
+        s_chip.cad_done_at = 0;
+        s_chip.mode = __sim_mode_stdby;
+        if(detected && s_chip.cad_exit_mode == 0x01)
+            start_rx_locked(s_chip.cad_timeout, at);
+        raise_irq_locked(__sx126x_irq_cad_done |
+            (detected ? __sx126x_irq_cad_detected : 0), at);
+    }
+}
+
+static void* timing_task(void* arg)
+{
+    struct timespec ts;
+    uint64_t next;
+    uint64_t now;
+
+    pthread_mutex_lock(&s_mutex);
+    while(s_running)
+    {
+        now = lora_sim_time_us();
+        serve_events_locked(now);
+
+        if(s_chip.irq_edge_pending)
+        {
+            uint32_t timestamp = s_chip.irq_timestamp_us / 1000u;
+            s_chip.irq_edge_pending = false;
+
+            /* the stack reads back the chip from the irq context */
+            pthread_mutex_unlock(&s_mutex);
+            sx126x_port_irq(timestamp);
+            pthread_mutex_lock(&s_mutex);
+            continue;
+        }
+
+        next = next_deadline_locked();
+        if(next == 0) {
+            pthread_cond_wait(&s_cond, &s_mutex);
+        } else if(next > now) {
+            ts.tv_sec = next / 1000000u;
+            ts.tv_nsec = (next % 1000000u) * 1000u;
+            pthread_cond_timedwait(&s_cond, &s_mutex, &ts);
+        }
+    }
+    pthread_mutex_unlock(&s_mutex);
+    return NULL;
+}
+
+/* --- sx126x port implementation ------------------------------------------- */
+
+static uint32_t be24(const uint8_t* p)
+{
+    return ((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | p[2];
+}
+
+static void exec_write_cmd_locked(uint8_t cmd, const uint8_t* tx, uint32_t size)
+{
+    uint64_t now = lora_sim_time_us();
+
+    switch(cmd)
+    {
+    case __sx126x_cmd_set_sleep:
+        cancel_events_locked();
+        s_chip.mode = __sim_mode_sleep;
+        break;
+    case __sx126x_cmd_set_standby:
+        cancel_events_locked();
+        s_chip.mode = __sim_mode_stdby;
+        break;
+    case __sx126x_cmd_set_fs:
+        s_chip.mode = __sim_mode_fs;
+        break;
+    case __sx126x_cmd_set_tx:
+        cancel_events_locked();
+        start_tx_locked(size >= 3 ? be24(tx) : 0, now);
+        break;
+    case __sx126x_cmd_set_rx:
+        cancel_events_locked();
+        start_rx_locked(size >= 3 ? be24(tx) : 0, now);
+        break;
+    case __sx126x_cmd_set_cad:
+        cancel_events_locked();
+        start_cad_locked(now);
+        break;
+    case __sx126x_cmd_set_tx_continuous_wave:
+    case __sx126x_cmd_set_tx_infinite_preamble:
+        cancel_events_locked();
+        s_chip.mode = __sim_mode_tx;
+        break;
+    case __sx126x_cmd_set_packet_type:
+        s_chip.packet_type = tx[0];
+        break;
+    case __sx126x_cmd_set_rf_frequency:
+        s_chip.freq = (uint32_t)(((uint64_t)(
+            ((uint32_t)tx[0] << 24) | ((uint32_t)tx[1] << 16) |
+            ((uint32_t)tx[2] << 8) | tx[3]) * 32000000u) >> 25);
+        break;
+    case __sx126x_cmd_set_tx_params:
+        s_chip.tx_power = (int8_t)tx[0];
+        break;
+    case __sx126x_cmd_set_modulation_params:
+        if(s_chip.packet_type == 1) {
+            s_chip.sf = tx[0];
+            s_chip.bw = tx[1];
+            s_chip.cr = tx[2];
+        } else if(be24(tx)) {
+            s_chip.fsk_bitrate = (uint32_t)(32ull * 32000000u / be24(tx));
+        }
+        break;
+    case __sx126x_cmd_set_packet_params:
+        if(s_chip.packet_type == 1) {
+            s_chip.preamble = ((uint16_t)tx[0] << 8) | tx[1];
+            s_chip.implicit_header = tx[2];
+            s_chip.payload_len = tx[3];
+            s_chip.crc_on = tx[4];
+            s_chip.iq_inverted = tx[5];
+        } else {
+            s_chip.preamble = ((uint16_t)tx[0] << 8) | tx[1];
+            s_chip.payload_len = tx[6];
+            s_chip.crc_on = tx[7] != 0x01;
+        }
+        break;
+    case __sx126x_cmd_set_buffer_base_address:
+        s_chip.tx_base = tx[0];
+        s_chip.rx_base = tx[1];
+        break;
+    case __sx126x_cmd_set_lora_symb_num_timeout:
+        s_chip.symb_timeout = tx[0];
+        break;
+    case __sx126x_cmd_set_cad_params:
+        s_chip.cad_symbols = tx[0];
+        s_chip.cad_exit_mode = tx[3];
+        s_chip.cad_timeout = size >= 7 ? be24(&tx[4]) : 0;
+        break;
+    case __sx126x_cmd_set_dio_irq_params:
+        s_chip.irq_mask = ((uint16_t)tx[0] << 8) | tx[1];
+        s_chip.dio1_mask = ((uint16_t)tx[2] << 8) | tx[3];
+        s_chip.dio1_level = (s_chip.irq & s_chip.dio1_mask) != 0;
+        break;
+    case __sx126x_cmd_clear_irq_status:
+        s_chip.irq &= ~(((uint16_t)tx[0] << 8) | tx[1]);
+        s_chip.dio1_level = (s_chip.irq & s_chip.dio1_mask) != 0;
+        break;
+    case __sx126x_cmd_reset_stats:
+        s_chip.nb_pkt_received = 0;
+        s_chip.nb_pkt_crc_error = 0;
+        s_chip.nb_pkt_header_err = 0;
+        break;
+    default:
+        /* calibration, regulator, pa, tcxo and rf switch settings have no
+         * effect on the simulated radio */
+        break;
+    }
+}
+
+static void exec_read_cmd_locked(uint8_t cmd, uint8_t* rx, uint32_t size)
+{
+    uint8_t out[8] = {0};
+    int16_t rssi;
+
+    switch(cmd)
+    {
+    case __sx126x_cmd_get_irq_status:
+        out[0] = s_chip.irq >> 8;
+        out[1] = s_chip.irq & 0xff;
+        break;
+    case __sx126x_cmd_get_rx_buffer_status:
+        out[0] = s_chip.rx_len;
+        out[1] = s_chip.rx_base;
+        break;
+    case __sx126x_cmd_get_packet_status:
+        out[0] = (uint8_t)(-s_chip.pkt_rssi * 2);
+        out[1] = (uint8_t)(int8_t)(s_chip.pkt_snr * 4);
+        out[2] = (uint8_t)(-s_chip.pkt_rssi * 2);
+        break;
+    case __sx126x_cmd_get_rssi_inst:
+        rssi = s_chip.rx_frame_active ?
+            s_chip.rx_info.rssi : __sim_noise_floor_dbm;
+        out[0] = (uint8_t)(-rssi * 2);
+        break;
+    case __sx126x_cmd_get_packet_type:
+        out[0] = s_chip.packet_type;
+        break;
+    case __sx126x_cmd_get_stats:
+        out[0] = s_chip.nb_pkt_received >> 8;
+        out[1] = s_chip.nb_pkt_received & 0xff;
+        out[2] = s_chip.nb_pkt_crc_error >> 8;
+        out[3] = s_chip.nb_pkt_crc_error & 0xff;
+        out[4] = s_chip.nb_pkt_header_err >> 8;
+        out[5] = s_chip.nb_pkt_header_err & 0xff;
+        break;
+    default:
+        /* get_status, get_device_errors: no errors */
+        break;
+    }
+    memcpy(rx, out, size < sizeof(out) ? size : sizeof(out));
+}
+
+static uint8_t status_byte_locked(void)
+{
+    /* chip mode at bits [6:4], command status 'data available' or
+     * 'command processed' at bits [3:1] */
+    return (s_status_chip_mode[s_chip.mode] << 4) |
+        ((s_chip.irq & __sx126x_irq_rx_done ? 0x2 : 0x1) << 1);
+}
+
+static int sim_spi_trx( sx126x_spi_trx_t* p_trx )
+{
+    uint32_t i;
+
+    pthread_mutex_lock(&s_mutex);
+
+    if(p_trx->flags & __sx126x_spi_trx_has_rx_byte1)
+        p_trx->rx_byte1 = status_byte_locked();
+
+    switch(p_trx->command)
+    {
+    case __sx126x_cmd_write_register:
+        for(i = 0; i < p_trx->size; ++i)
+            s_chip.regs[(p_trx->address + i) & 0xfff] = p_trx->tx_buffer[i];
+        break;
+    case __sx126x_cmd_read_register:
+        for(i = 0; i < p_trx->size; ++i) {
+            uint16_t addr = (p_trx->address + i) & 0xfff;
+            if( addr >= __sx126x_reg_random_num_gen_0 &&
+                addr <= __sx126x_reg_random_num_gen_3 )
+                s_chip.regs[addr] = rand();
+            p_trx->rx_buffer[i] = s_chip.regs[addr];
+        }
+        break;
+    case __sx126x_cmd_write_buffer:
+        for(i = 0; i < p_trx->size; ++i)
+            s_chip.buffer[(uint8_t)(p_trx->address + i)] = p_trx->tx_buffer[i];
+        break;
+    case __sx126x_cmd_read_buffer:
+        for(i = 0; i < p_trx->size; ++i)
+            p_trx->rx_buffer[i] = s_chip.buffer[(uint8_t)(p_trx->address + i)];
+        break;
+    default:
+        if(p_trx->rx_buffer)
+            exec_read_cmd_locked(p_trx->command, p_trx->rx_buffer,
+                p_trx->size);
+        else
+            exec_write_cmd_locked(p_trx->command, p_trx->tx_buffer,
+                p_trx->size);
+        break;
+    }
+
+    pthread_mutex_unlock(&s_mutex);
+    return 0;
+}
+
+static sx126x_port_busy_wait_t sim_wait_on_busy( void )
+{
+    /* all commands are executed synchronously within the spi transaction */
+    return __sx126x_port_busy_free;
+}
+
+static void sim_send_reset_pulse( void )
+{
+    pthread_mutex_lock(&s_mutex);
+    chip_reset();
+    pthread_mutex_unlock(&s_mutex);
+}
+
+static bool sim_int_pin_state( void )
+{
+    bool level;
+    pthread_mutex_lock(&s_mutex);
+    level = s_chip.dio1_level;
+    pthread_mutex_unlock(&s_mutex);
+    return level;
+}
+
+/* --- constructor / destructor --------------------------------------------- */
+
+void lora_sim_sx126x_ctor(void)
+{
+    pthread_condattr_t attr;
+
+    __log_info(__green__"ctor() -> simulated sx126x chip");
+
+    chip_reset();
+
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&s_cond, &attr);
+    pthread_condattr_destroy(&attr);
+
+    s_running = true;
+    pthread_create(&s_timing_thread, NULL, timing_task, NULL);
+
+    if(lora_sim_air_open(air_rx_callback) != 0)
+        __log_error("simulated radio is not connected to the air channel");
+
+    sx126x_port_t port_params = {
+        .p_spi_trx = sim_spi_trx,
+        .p_wait_on_busy_signal = sim_wait_on_busy,
+        .p_send_reset_pulse = sim_send_reset_pulse,
+        .p_get_int_pin_state = sim_int_pin_state
+    };
+    sx126x_spi_mock_attach( & port_params );
+    sx126x_port_init( & port_params );
+}
+
+void lora_sim_sx126x_dtor(void)
+{
+    __log_info(__green__"dtor() -> simulated sx126x chip");
+
+    lora_sim_air_close();
+
+    pthread_mutex_lock(&s_mutex);
+    s_running = false;
+    pthread_cond_signal(&s_cond);
+    pthread_mutex_unlock(&s_mutex);
+    pthread_join(s_timing_thread, NULL);
+}
+
+/* --- end of file ---------------------------------------------------------- */
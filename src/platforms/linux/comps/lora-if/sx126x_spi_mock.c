@@ -0,0 +1,192 @@
+/** -------------------------------------------------------------------------- *
+ * @copyright Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @author  Ahmed Sabry (SG Wireless)
+ *
+ * @brief   mock spi transport of the sx126x port for the Linux host platform.
+ * --------------------------------------------------------------------------- *
+ */
+
+/* --- includes ------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "sx126x_spi_mock.h"
+
+/* --- mock state ----------------------------------------------------------- */
+
+static const char * s_op_names[__sx126x_port_op_count + 1] = {
+    [__sx126x_port_op_config]       = "config",
+    [__sx126x_port_op_tx]           = "tx",
+    [__sx126x_port_op_rx]           = "rx",
+    [__sx126x_port_op_cad]          = "cad",
+    [__sx126x_port_op_irq]          = "irq",
+    [__sx126x_spi_mock_unbatched]   = "unbatched",
+};
+
+static struct {
+    pthread_mutex_t                 mutex;
+
+    /* the wrapped port hooks */
+    sx126x_port_spi_trx_t *         p_spi_trx;
+    sx126x_port_spi_batch_begin_t * p_batch_begin;
+    sx126x_port_spi_batch_end_t *   p_batch_end;
+
+    bool                            in_batch;
+    uint8_t                         op;
+    uint32_t                        batch_trx;
+    uint32_t                        batch_bytes;
+
+    sx126x_spi_mock_stats_t         stats[__sx126x_port_op_count + 1];
+} s_mock = {
+    .mutex = PTHREAD_MUTEX_INITIALIZER
+};
+
+/* --- spi hooks ------------------------------------------------------------ */
+
+static uint32_t trx_bus_bytes(sx126x_spi_trx_t * p_trx)
+{
+    uint32_t bytes = 1 + p_trx->size;
+
+    if(p_trx->flags & __sx126x_spi_trx_has_address)
+        bytes += p_trx->address_bits / 8;
+    if(p_trx->flags & (__sx126x_spi_trx_has_rx_byte1 |
+                       __sx126x_spi_trx_has_dummy_rx_byte1))
+        bytes += 1;
+    return bytes;
+}
+
+static int mock_spi_trx(sx126x_spi_trx_t * p_trx)
+{
+    uint32_t bytes = trx_bus_bytes(p_trx);
+
+    pthread_mutex_lock(&s_mock.mutex);
+    if(s_mock.in_batch) {
+        ++ s_mock.batch_trx;
+        s_mock.batch_bytes += bytes;
+    } else {
+        sx126x_spi_mock_stats_t * p_stats =
+            &s_mock.stats[__sx126x_spi_mock_unbatched];
+        ++ p_stats->trx;
+        p_stats->bytes += bytes;
+    }
+    pthread_mutex_unlock(&s_mock.mutex);
+
+    if(s_mock.p_spi_trx)
+        return s_mock.p_spi_trx(p_trx);
+
+    p_trx->rx_byte1 = 0;
+    if(p_trx->rx_buffer)
+        memset(p_trx->rx_buffer, 0, p_trx->size);
+    return 0;
+}
+
+static void mock_spi_batch_begin(sx126x_port_op_t op)
+{
+    pthread_mutex_lock(&s_mock.mutex);
+    s_mock.in_batch = true;
+    s_mock.op = op < __sx126x_port_op_count ? op : __sx126x_spi_mock_unbatched;
+    s_mock.batch_trx = 0;
+    s_mock.batch_bytes = 0;
+    pthread_mutex_unlock(&s_mock.mutex);
+
+    if(s_mock.p_batch_begin)
+        s_mock.p_batch_begin(op);
+}
+
+static void mock_spi_batch_end(void)
+{
+    sx126x_spi_mock_stats_t * p_stats;
+
+    if(s_mock.p_batch_end)
+        s_mock.p_batch_end();
+
+    pthread_mutex_lock(&s_mock.mutex);
+    p_stats = &s_mock.stats[s_mock.op];
+    ++ p_stats->batches;
+    p_stats->trx += s_mock.batch_trx;
+    p_stats->bytes += s_mock.batch_bytes;
+    if(s_mock.batch_trx > p_stats->max_trx)
+        p_stats->max_trx = s_mock.batch_trx;
+    if(s_mock.batch_bytes > p_stats->max_bytes)
+        p_stats->max_bytes = s_mock.batch_bytes;
+    s_mock.in_batch = false;
+    pthread_mutex_unlock(&s_mock.mutex);
+}
+
+/* --- APIs ----------------------------------------------------------------- */
+
+void sx126x_spi_mock_attach(sx126x_port_t * p_port)
+{
+    s_mock.p_spi_trx = p_port->p_spi_trx;
+    s_mock.p_batch_begin = p_port->p_spi_batch_begin;
+    s_mock.p_batch_end = p_port->p_spi_batch_end;
+
+    p_port->p_spi_trx = mock_spi_trx;
+    p_port->p_spi_batch_begin = mock_spi_batch_begin;
+    p_port->p_spi_batch_end = mock_spi_batch_end;
+
+    sx126x_spi_mock_reset();
+}
+
+void sx126x_spi_mock_get(uint8_t op, sx126x_spi_mock_stats_t * p_stats)
+{
+    if(op > __sx126x_spi_mock_unbatched) {
+        memset(p_stats, 0, sizeof(*p_stats));
+        return;
+    }
+    pthread_mutex_lock(&s_mock.mutex);
+    *p_stats = s_mock.stats[op];
+    pthread_mutex_unlock(&s_mock.mutex);
+}
+
+void sx126x_spi_mock_reset(void)
+{
+    pthread_mutex_lock(&s_mock.mutex);
+    memset(s_mock.stats, 0, sizeof(s_mock.stats));
+    pthread_mutex_unlock(&s_mock.mutex);
+}
+
+void sx126x_spi_mock_print(void)
+{
+    sx126x_spi_mock_stats_t stats;
+    uint8_t op;
+
+    printf("  %-22s: %10s %8s %10s %10s %10s\n", "spi per radio operation",
+        "operations", "trx", "bytes", "trx/op", "max trx");
+    for(op = 0; op <= __sx126x_spi_mock_unbatched; ++op) {
+        sx126x_spi_mock_get(op, &stats);
+        if(stats.trx == 0)
+            continue;
+        if(op == __sx126x_spi_mock_unbatched)
+            printf("  %22s: %10s %8u %10u\n", s_op_names[op], "-",
+                stats.trx, stats.bytes);
+        else
+            printf("  %22s: %10u %8u %10u %10.1f %10u\n", s_op_names[op],
+                stats.batches, stats.trx, stats.bytes,
+                stats.batches ? (double)stats.trx / stats.batches : 0.0,
+                stats.max_trx);
+    }
+}
+
+/* --- end of file ---------------------------------------------------------- */
@@ -0,0 +1,83 @@
+/** -------------------------------------------------------------------------- *
+ * @copyright Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the “Software”), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+ * copies  of  the  Software,  and  to  permit  persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @author  Ahmed Sabry (SG Wireless)
+ *
+ * @brief   mock spi transport of the sx126x port for the Linux host platform.
+ *          It sits in front of the spi hooks of a port and accounts the
+ *          transactions and the bus bytes of every radio operation batch.
+ * --------------------------------------------------------------------------- *
+ */
+#ifndef __SX126X_SPI_MOCK_H__
+#define __SX126X_SPI_MOCK_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --- includes ------------------------------------------------------------- */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "sx126x_port.h"
+
+/* --- typedefs ------------------------------------------------------------- */
+
+/* the transactions issued out of any batch are accounted under this index */
+#define __sx126x_spi_mock_unbatched     (__sx126x_port_op_count)
+
+typedef struct {
+    uint32_t    batches;    /**< the operation batches */
+    uint32_t    trx;        /**< spi transactions */
+    uint32_t    bytes;      /**< bus bytes with the command, address, dummy
+                                 and status phases */
+    uint32_t    max_trx;    /**< transactions of the largest batch */
+    uint32_t    max_bytes;  /**< bus bytes of the largest batch */
+} sx126x_spi_mock_stats_t;
+
+/* --- APIs ----------------------------------------------------------------- */
+
+/**
+ * @brief   puts the mock in front of the spi hooks of the given port params,
+ *          the port spi transactions are forwarded to the original hook. If
+ *          the port has no spi hook, the mock answers the reads with zeros.
+ */
+void sx126x_spi_mock_attach(sx126x_port_t * p_port);
+
+/**
+ * @brief   reads the accounting of one radio operation or of the unbatched
+ *          transactions \a __sx126x_spi_mock_unbatched
+ */
+void sx126x_spi_mock_get(uint8_t op, sx126x_spi_mock_stats_t * p_stats);
+
+void sx126x_spi_mock_reset(void);
+
+/**
+ * @brief   prints the accounting table of all the operations
+ */
+void sx126x_spi_mock_print(void);
+
+/* --- end of file ---------------------------------------------------------- */
+#ifdef __cplusplus
+}
+#endif
+#endif /* __SX126X_SPI_MOCK_H__ */
@@ -0,0 +1,255 @@
+# ---------------------------------------------------------------------------- #
+# Copyright (c) 2023-2024 SG Wireless - All Rights Reserved
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files(the “Software”), to deal
+# in the Software without restriction, including without limitation the rights
+# to use,  copy,  modify,  merge, publish, distribute, sublicense, and/or sell
+# copies  of  the  Software,  and  to  permit  persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED “AS IS”,  WITHOUT WARRANTY OF ANY KIND,  EXPRESS OR
+# IMPLIED,  INCLUDING BUT NOT LIMITED TO  THE  WARRANTIES  OF  MERCHANTABILITY
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+# AUTHORS  OR  COPYRIGHT  HOLDERS  BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN  CONNECTION WITH  THE SOFTWARE OR  THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+# Author    Ahmed Sabry (SG Wireless)
+#
+# Desc      This file contains the host build of the lora stack over the
+#           simulated sx126x radio of the Linux platform. It builds the
+#           simulated node and the stand-in network server applications.
+#
+# usage     make -f lora_host.mk [clean|build|test]
+#           make -f lora_host.mk test TEST_FRAMES=500
+# ---------------------------------------------------------------------------- #
+
+# --- targets ---------------------------------------------------------------- #
+input_targets   := clean build generate test
+default_targets := build
+
+build_dir   := build
+gen_dir     := ${build_dir}/gen
+patched_dir := ${build_dir}/patched
+
+src_dir   := ../..
+ext_dir   := ../../../ext
+lora_dir  := ${src_dir}/comps/lora
+lm_dir    := ${ext_dir}/LoRaMac-node/src
+lmapp_dir := ${lm_dir}/apps/LoRaMac/common
+
+# --- LoRaMac-node sources (patched as in comps/lora/src/lm|lmhandler) ------- #
+lm_patches  := $(wildcard ${lora_dir}/src/lm/patches/*.patch)
+lmh_patches := $(wildcard ${lora_dir}/src/lmhandler/patches/*.patch)
+
+lm_srcs :=                                                      \
+    $(wildcard ${lm_dir}/mac/*.c)                               \
+    $(wildcard ${lm_dir}/mac/region/*.c)                        \
+    ${lm_dir}/radio/sx126x/radio.c                              \
+    ${lm_dir}/radio/sx126x/sx126x.c                             \
+    $(wildcard ${lm_dir}/peripherals/soft-se/*.c)               \
+    $(wildcard ${lmapp_dir}/LmHandler/*.c)                      \
+    $(wildcard ${lmapp_dir}/LmHandler/packages/*.c)             \
+    ${lmapp_dir}/CayenneLpp.c
+
+patched_names := $(notdir $(basename ${lm_patches} ${lmh_patches}))
+patched_srcs  := $(addprefix ${patched_dir}/,${patched_names})
+lm_srcs := $(filter-out $(addprefix %/,${patched_names}),${lm_srcs})
+
+# --- lora stack, libs and platform sources ---------------------------------- #
+lora_srcs :=                                                    \
+    $(wildcard ${lora_dir}/src/lora_mgr/*.c)                    \
+    $(wildcard ${lora_dir}/src/lora_wan/*.c)                    \
+    $(wildcard ${lora_dir}/src/lora_raw/*.c)                    \
+    $(wildcard ${lora_dir}/src/lora_utils/*.c)                  \
+    $(wildcard ${lora_dir}/src/radio_ext/*.c)                   \
+    $(wildcard ${lora_dir}/src/stubs/*.c)                       \
+    $(wildcard ${lora_dir}/src/stubs/drivers/*.c)               \
+    $(wildcard ${lora_dir}/src/lmhandler/*.c)
+
+libs_srcs :=                                                    \
+    $(wildcard ${src_dir}/libs/logs/src/*.c)                    \
+    $(wildcard ${src_dir}/libs/adt/src/*.c)                     \
+    ${src_dir}/libs/utils/utils_fs_path.c                       \
+    ${src_dir}/libs/utils/utils_bitarray.c                      \
+    ${src_dir}/libs/utils/utils_time.c                          \
+    ${src_dir}/libs/state-machine/src/state_machine.c
+
+platform_srcs :=                                                \
+    $(wildcard ./compat/*.c)                                    \
+    $(wildcard ./comps/logs-if/*.c)                             \
+    $(wildcard ./comps/lora-if/*.c)
+
+stack_srcs := ${lm_srcs} ${patched_srcs} ${lora_srcs} ${libs_srcs}     \
+              ${platform_srcs}
+
+node_srcs := ./apps/lora_sim_node.c
+ns_srcs   := ./apps/lora_sim_ns.c                               \
+             ./comps/lora-if/lora_sim_air.c                     \
+             $(wildcard ${lm_dir}/peripherals/soft-se/aes.c)    \
+             $(wildcard ${lm_dir}/peripherals/soft-se/cmac.c)
+
+# --- objects ---------------------------------------------------------------- #
+obj_of = $(addprefix ${build_dir}/obj,$(abspath $(1:.c=.o)))
+
+stack_objs := $(call obj_of,${stack_srcs})
+node_objs  := $(call obj_of,${node_srcs})
+ns_objs    := $(call obj_of,${ns_srcs})
+deps := $(sort ${stack_objs} ${node_objs} ${ns_objs})
+deps := $(deps:.o=.d)
+
+node_bin := ${build_dir}/lora_sim_node
+ns_bin   := ${build_dir}/lora_sim_ns
+
+gens := ${gen_dir}/logs_gen_comp_ids.hh \
+        ${gen_dir}/logs_gen_structs.cc
+logs_gen_srcs :=                                                \
+    $(wildcard ${src_dir}/libs/logs/src/*.c)                    \
+    ${src_dir}/libs/logs/inc/log_lib.h                          \
+    ${src_dir}/libs/utils/logs_defs.h                           \
+    ${src_dir}/drivers/common/logs_defs.h                       \
+    ${lora_dir}/inc/logs_defs.h                                 \
+    ./logs_defs.h                                               \
+    $(filter-out $(wildcard ${src_dir}/libs/logs/src/*.c),      \
+        ${stack_srcs} ${node_srcs} ${ns_srcs})
+
+# --- includes and definitions ----------------------------------------------- #
+incs :=                                                         \
+    ./compat                                                    \
+    ./comps/lora-if                                             \
+    ./apps                                                      \
+    ${lora_dir}                                                 \
+    ${lora_dir}/src                                             \
+    ${lora_dir}/src/lora_mgr                                    \
+    ${lora_dir}/src/lora_wan                                    \
+    ${lora_dir}/src/lora_raw                                    \
+    ${lora_dir}/src/lora_utils                                  \
+    ${lora_dir}/src/radio_ext                                   \
+    ${lora_dir}/src/stubs                                       \
+    ${lora_dir}/src/stubs/drivers                               \
+    ${lora_dir}/src/lmhandler                                   \
+    ${lora_dir}/inc                                             \
+    ${lora_dir}/inc/drivers                                     \
+    ${lm_dir}                                                   \
+    ${lm_dir}/boards                                            \
+    ${lm_dir}/mac                                               \
+    ${lm_dir}/mac/region                                        \
+    ${lm_dir}/system                                            \
+    ${lm_dir}/radio                                             \
+    ${lm_dir}/radio/sx126x                                      \
+    ${lm_dir}/peripherals/soft-se                               \
+    ${lmapp_dir}                                                \
+    ${lmapp_dir}/LmHandler                                      \
+    ${lmapp_dir}/LmHandler/packages                             \
+    ${src_dir}/libs/adt/inc                                     \
+    ${src_dir}/libs/utils                                       \
+    ${src_dir}/libs/state-machine/inc                           \
+    ${src_dir}/libs/logs/src                                    \
+    ${src_dir}/libs/logs/inc                                    \
+    ${gen_dir}
+
+regions := EU868 US915 CN779 EU433 AU915 AS923 CN470 KR920 IN865 RU864
+defs :=                                                         \
+    SOFT_SE                                                     \
+    aes_encrypt=__aes_encrypt                                   \
+    $(foreach r,${regions},REGION_$r=REGION_$r)
+
+cflags := -O2 -g -Wall -include sdkconfig.h                     \
+          $(addprefix -I,${incs}) $(addprefix -D,${defs})
+ldlibs := -lpthread -lm
+
+# --- test parameters -------------------------------------------------------- #
+TEST_FRAMES ?= 50
+test_dir    := ${build_dir}/test
+
+.PHONY: default createdirs ${input_targets}
+
+default: ${default_targets}
+
+clean:
+	@echo "-- cleaning ..."
+	rm -rf ${build_dir}
+build: createdirs ${gens} ${node_bin} ${ns_bin}
+generate: createdirs ${patched_srcs} ${gens}
+
+# every process has its own nvm directory and takes the next free air slot
+test: build
+	@mkdir -p ${test_dir}/rx ${test_dir}/tx ${test_dir}/wan
+	cd ${test_dir}/rx && LORA_SIM_NVM_DIR=. ../../lora_sim_node raw-rx \
+        -t $$(( ${TEST_FRAMES} / 10 + 5 )) > rx.log 2>&1 &
+	sleep 1
+	cd ${test_dir}/tx && LORA_SIM_NVM_DIR=. ../../lora_sim_node raw-tx \
+        -n ${TEST_FRAMES}
+	wait
+	cat ${test_dir}/rx/rx.log
+	@mkdir -p ${test_dir}/adapt-rx ${test_dir}/adapt-tx
+	cd ${test_dir}/adapt-rx && LORA_SIM_NVM_DIR=. LORA_SIM_PATH_LOSS=135 \
+        ../../lora_sim_node adapt-rx -s 12 -t 20 > rx.log 2>&1 &
+	sleep 1
+	cd ${test_dir}/adapt-tx && LORA_SIM_NVM_DIR=. LORA_SIM_PATH_LOSS=135 \
+        ../../lora_sim_node adapt-tx -s 12 -l 32 -n ${TEST_FRAMES}
+	wait
+	cat ${test_dir}/adapt-rx/rx.log
+	@mkdir -p ${test_dir}/hop-rx ${test_dir}/hop-tx
+	cd ${test_dir}/hop-rx && LORA_SIM_NVM_DIR=. ../../lora_sim_node raw-rx \
+        -H 7 -t $$(( ${TEST_FRAMES} / 5 + 5 )) > rx.log 2>&1 &
+	sleep 1
+	cd ${test_dir}/hop-tx && LORA_SIM_NVM_DIR=. ../../lora_sim_node raw-tx \
+        -H 7 -n ${TEST_FRAMES}
+	wait
+	cat ${test_dir}/hop-rx/rx.log
+	cd ${test_dir}/wan && ../../lora_sim_ns \
+        -t $$(( ${TEST_FRAMES} * 3 + 5 )) > ns.log 2>&1 &
+	sleep 1
+	cd ${test_dir}/wan && LORA_SIM_NVM_DIR=. ../../lora_sim_node wan -c \
+        -n ${TEST_FRAMES}
+	wait
+	cat ${test_dir}/wan/ns.log
+	@mkdir -p ${test_dir}/wan-mcast
+	cd ${test_dir}/wan-mcast && ../../lora_sim_ns -m 2000 -t 30 \
+        > ns.log 2>&1 &
+	sleep 1
+	cd ${test_dir}/wan-mcast && LORA_SIM_NVM_DIR=. ../../lora_sim_node \
+        wan-mcast -t 20
+	wait
+	cat ${test_dir}/wan-mcast/ns.log
+
+createdirs:
+	@mkdir -p ${build_dir}/obj
+	@mkdir -p ${gen_dir}
+	@mkdir -p ${patched_dir}
+
+${node_bin}: ${node_objs} ${stack_objs}
+	gcc -o $@ $^ ${ldlibs}
+
+${ns_bin}: ${ns_objs}
+	gcc -o $@ $^ ${ldlibs}
+
+${build_dir}/obj/%.o: /%.c ${gens}
+	@mkdir -p $(dir $@)
+	gcc -c $< -o $@ -MD ${cflags}
+
+# the LoRaMac-node sources are patched out of the tree like the sdk build
+${patched_dir}/%.c: ${lora_dir}/src/lm/patches/%.c.patch
+	patch -s -o $@ $(firstword $(filter %/$*.c,$(wildcard  \
+        ${lm_dir}/mac/*.c ${lm_dir}/mac/region/*.c              \
+        ${lm_dir}/radio/sx126x/*.c))) $<
+${patched_dir}/%.c: ${lora_dir}/src/lmhandler/patches/%.c.patch
+	patch -s -o $@ $(firstword $(filter %/$*.c,$(wildcard  \
+        ${lmapp_dir}/LmHandler/*.c                              \
+        ${lmapp_dir}/LmHandler/packages/*.c))) $<
+
+${gen_dir}/logs_gen_comp_ids.hh ${gen_dir}/logs_gen_structs.cc: \
+        ${logs_gen_srcs}
+	python3 ${src_dir}/libs/logs/gen/gen_logs_structs.py ${gen_dir} \
+        ${logs_gen_srcs}
+
+# --- dependencies inclusion ------------------------------------------------- #
+-include ${deps}
+
+# --- end of file ------------------------------------------------------------ #